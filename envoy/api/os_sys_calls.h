@@ -87,6 +87,25 @@ public:
    */
   virtual SysCallSizeResult pread(os_fd_t fd, void* buffer, size_t length, off_t offset) const PURE;
 
+  /**
+   * @see man 2 sendfile
+   */
+  virtual SysCallSizeResult sendfile(os_fd_t out_fd, os_fd_t in_fd, off_t offset,
+                                     size_t count) PURE;
+
+  /**
+   * Moves up to length bytes between two file descriptors without copying them through user
+   * space. One of them must be a pipe, and operations on the pipe do not block.
+   * @see man 2 splice
+   */
+  virtual SysCallSizeResult splice(os_fd_t fd_in, os_fd_t fd_out, size_t length) PURE;
+
+  /**
+   * Creates a non-blocking, close-on-exec pipe.
+   * @see man 2 pipe
+   */
+  virtual SysCallIntResult pipe(os_fd_t fds[2]) PURE;
+
   /**
    * @see send (man 2 send)
    */
@@ -48,6 +48,15 @@ struct ConstRawSlice {
 
 using RawSliceVector = absl::InlinedVector<RawSlice, 16>;
 
+/**
+ * A range of an open file, which holds the data of a buffer fragment.
+ */
+struct FileRange {
+  os_fd_t fd_ = INVALID_SOCKET;
+  uint64_t offset_ = 0;
+  uint64_t len_ = 0;
+};
+
 /**
  * A wrapper class to facilitate passing in externally owned data to a buffer via addBufferFragment.
  * When the buffer no longer needs the data passed in through a fragment, it calls done() on it.
@@ -69,6 +78,13 @@ public:
    * Called by a buffer when the referenced data is no longer needed.
    */
   virtual void done() PURE;
+
+  /**
+   * @return the file range holding the referenced data, if the fragment references a file. Sockets
+   *         may then send the range straight from the file, and the buffer only calls data() once
+   *         the data is needed in memory.
+   */
+  virtual std::optional<FileRange> fileRange() const { return std::nullopt; }
 };
 
 /**
@@ -236,6 +252,22 @@ public:
    */
   virtual RawSliceVector getRawSlices(std::optional<uint64_t> max_slices = std::nullopt) const PURE;
 
+  /**
+   * Fetch the raw buffer slices that precede the first slice referencing a file range, without
+   * reading that range into memory.
+   * @param max_slices supplies an optional limit on the number of slices to fetch, for performance.
+   * @return RawSliceVector with non-empty slices in the buffer. It is empty when the buffer is
+   *         empty, or when its front slice references a file range, see frontFileRange().
+   */
+  virtual RawSliceVector
+  getRawSlicesBeforeFileRange(std::optional<uint64_t> max_slices = std::nullopt) const PURE;
+
+  /**
+   * @return the file range holding the data of the first non-zero-length slice in the buffer, if
+   *         that slice references a file-backed fragment.
+   */
+  virtual std::optional<FileRange> frontFileRange() const PURE;
+
   /**
    * Fetch the valid data pointer and valid data length of the first non-zero-length
    * slice in the buffer.
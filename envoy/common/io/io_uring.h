@@ -58,11 +58,22 @@ public:
   bool moreCompletions() const { return more_completions_; }
   void setMoreCompletions(bool more_completions) { more_completions_ = more_completions; }
 
+  /**
+   * Whether the completion is the notification of a zero-copy send, which signals that the kernel
+   * no longer references the memory that was sent. Populated by the io_uring implementation before
+   * the completion callback runs.
+   */
+  bool zeroCopyNotification() const { return zero_copy_notification_; }
+  void setZeroCopyNotification(bool zero_copy_notification) {
+    zero_copy_notification_ = zero_copy_notification;
+  }
+
 private:
   RequestType type_;
   IoUringSocket& socket_;
   int32_t buffer_id_{-1};
   bool more_completions_{false};
+  bool zero_copy_notification_{false};
 };
 
 /**
@@ -177,8 +188,8 @@ public:
   virtual bool isMultishotEnabled() const PURE;
 
   /**
-   * Returns the provided buffer pool used for `multishot` reads, or nullptr when `multishot` reads
-   * are not available.
+   * Returns the provided buffer pool that reads can draw buffers from, or nullptr when provided
+   * buffers are not available. The pool backs `multishot` reads and provided buffer reads.
    */
   virtual IoUringBufferPoolSharedPtr bufferPool() PURE;
 
@@ -190,6 +201,13 @@ public:
    */
   virtual IoUringResult prepareReadMultishot(os_fd_t fd, Request* user_data) PURE;
 
+  /**
+   * Prepares a single recv that draws a buffer from the provided buffer pool only once data
+   * arrives, so that a pending read holds no buffer of its own. Returns IoUringResult::Failed when
+   * the submission queue is full already and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareReadProvidedBuffer(os_fd_t fd, Request* user_data) PURE;
+
   /**
    * Prepares a writev system call and puts it into the submission queue.
    * Returns IoUringResult::Failed in case the submission queue is full already
@@ -198,6 +216,24 @@ public:
   virtual IoUringResult prepareWritev(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
                                       off_t offset, Request* user_data) PURE;
 
+  /**
+   * Returns true if zero-copy sends are available on this ring. When false the caller falls back
+   * to writev-based writes.
+   */
+  virtual bool isSendZeroCopySupported() const PURE;
+
+  /**
+   * Prepares a zero-copy sendmsg and puts it into the submission queue. A successful send delivers
+   * two completions for `user_data`: the send result, with moreCompletions() set, and later a
+   * notification, with zeroCopyNotification() set, after which the memory referenced by `msg` may
+   * be released. On kernel 6.2 or newer, the notification result has
+   * `IORING_NOTIF_USAGE_ZC_COPIED` set when the kernel copied the data instead. Returns
+   * IoUringResult::Failed in case the submission queue is full already and IoUringResult::Ok
+   * otherwise.
+   */
+  virtual IoUringResult prepareSendmsgZeroCopy(os_fd_t fd, const struct msghdr* msg,
+                                               Request* user_data) PURE;
+
   /**
    * Prepares a close system call and puts it into the submission queue.
    * Returns IoUringResult::Failed in case the submission queue is full already
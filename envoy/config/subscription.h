@@ -87,6 +87,22 @@ public:
    *         the route config name for a envoy.config.route.v3.RouteConfiguration message.
    */
   virtual std::string resourceName(const Protobuf::Message& resource) PURE;
+
+  /**
+   * Decodes the opaque resource like decodeResource(), without validating it, so that decoding
+   * can be moved off the main thread. This must be thread safe.
+   * @param resource some opaque resource (Protobuf::Any).
+   * @return ProtobufTypes::MessagePtr the protobuf message in the opaque resource, to be passed
+   *         to validateResource() on the main thread, or nullptr if the resource must be decoded
+   *         with decodeResource() instead.
+   */
+  virtual ProtobufTypes::MessagePtr parseResource(const Protobuf::Any&) { return nullptr; }
+
+  /**
+   * Validates a message returned by parseResource(), throwing an EnvoyException if it is invalid.
+   * @param resource some protobuf message returned by parseResource().
+   */
+  virtual void validateResource(const Protobuf::Message&) {}
 };
 
 using OpaqueResourceDecoderSharedPtr = std::shared_ptr<OpaqueResourceDecoder>;
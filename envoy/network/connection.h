@@ -444,6 +444,22 @@ public:
    * return value is cwnd(in packets) times the connection's MSS.
    */
   virtual std::optional<uint64_t> congestionWindowInBytes() const PURE;
+
+  /**
+   * @return whether the bytes of the connection may currently be moved directly between its socket
+   *         and another file descriptor, e.g. with splice(). This requires an open kernel socket
+   *         whose transport socket passes the bytes through unchanged, empty read and write
+   *         buffers, and a filter chain with at most one read filter and no write filters, so that
+   *         the only filter that would see the bytes is the caller.
+   */
+  virtual bool canSpliceSocket() const { return false; }
+
+  /**
+   * @return whether the file ranges of the buffers written to the connection, see
+   *         Buffer::Instance::frontFileRange(), are sent with sendfile() rather than read into
+   *         memory. Write filters may still read them.
+   */
+  virtual bool canSendFile() const { return false; }
 };
 
 using ConnectionPtr = std::unique_ptr<Connection>;
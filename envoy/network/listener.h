@@ -386,6 +386,9 @@ struct UdpRecvData {
   MonotonicTime receive_time_;
   uint8_t tos_ = 0;
   Buffer::OwnedImpl saved_cmsg_;
+  // If not zero, buffer_ holds the datagrams coalesced by GRO back to back, each of this size but
+  // the last one, which may be shorter.
+  uint64_t gso_size_ = 0;
 };
 
 /**
@@ -479,6 +482,12 @@ public:
    * Information about which cmsg to save to QuicReceivedPacket, if any.
    */
   virtual const IoHandle::UdpSaveCmsgConfig& udpSaveCmsgConfig() const PURE;
+
+  /**
+   * Whether onData() may be called once with all the datagrams read by a GRO receive, as
+   * described by UdpRecvData::gso_size_, rather than once per datagram.
+   */
+  virtual bool supportsCoalescedDatagrams() const { return false; }
 };
 
 using UdpListenerCallbacksOptRef = std::optional<std::reference_wrapper<UdpListenerCallbacks>>;
@@ -210,6 +210,18 @@ public:
    */
   virtual void configureInitialCongestionWindow(uint64_t bandwidth_bits_per_sec,
                                                 std::chrono::microseconds rtt) PURE;
+
+  /**
+   * @return whether the bytes on the wire are the bytes of the connection, so that they may be
+   *         moved to and from the socket without going through doRead() and doWrite().
+   */
+  virtual bool passesBytesThrough() const { return false; }
+
+  /**
+   * @return whether doWrite() hands the file ranges of the write buffer to IoHandle::write(),
+   *         which sends them with sendfile(), rather than reading their contents into memory.
+   */
+  virtual bool sendsFileRanges() const { return false; }
 };
 
 using TransportSocketPtr = std::unique_ptr<TransportSocket>;
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <ctime>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
@@ -114,6 +115,17 @@ public:
    */
   virtual ServerStatsFromParent mergeParentStatsIfAny(Stats::StoreRoot& stats_store) PURE;
 
+  using TlsSessionCb = std::function<void(absl::string_view key, absl::string_view session)>;
+
+  /**
+   * Retrieve the sessions of the process-wide TLS session cache of our parent process, if it
+   * persists them across hot restart.
+   * Does nothing if there is not currently a parent.
+   * @param cb supplies the callback called with the key and the serialized form of each session,
+   *        from the least to the most recently used one.
+   */
+  virtual void mergeParentTlsSessionsIfAny(const TlsSessionCb& cb) PURE;
+
   /**
    * Shutdown the half of our hot restarter that acts as a parent.
    */
@@ -113,6 +113,12 @@ public:
    */
   virtual const std::string& tlsKeyLogPath() const PURE;
 
+  /**
+   * @return true if the record layer of the connections should be offloaded to the kernel once
+   * the handshake completes.
+   */
+  virtual bool kernelTlsOffload() const PURE;
+
   /**
    * @return the access log manager object reference
    */
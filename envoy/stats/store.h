@@ -244,6 +244,14 @@ public:
    */
   virtual void setHistogramSettings(HistogramSettingsConstPtr&& histogram_settings) PURE;
 
+  /**
+   * Attach a StatsMatcher selecting the counters that are sharded across threads. Sharded counters
+   * trade memory and read cost for cheaper concurrent increments. Must be called before any of
+   * the selected counters are created.
+   * @param matcher counters not rejected by this matcher are sharded.
+   */
+  virtual void setShardedCounterMatcher(StatsMatcherPtr&& matcher) PURE;
+
   /**
    * Selects whether scopes created by this store use the explicit-tags logic, which propagates
    * scope-level tags onto every stat. Must be called during single-threaded startup, before
@@ -181,6 +181,12 @@ public:
    * @return the failure reason of the local close.
    */
   virtual absl::string_view localCloseReason() const { return ""; }
+
+  /**
+   * @return the upstream connection if the bytes are proxied over a TCP connection of their own,
+   *         as opposed to e.g. a stream tunneled over HTTP.
+   */
+  virtual OptRef<Network::Connection> connection() { return {}; }
 };
 
 using GenericConnPoolPtr = std::unique_ptr<GenericConnPool>;
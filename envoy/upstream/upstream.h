@@ -755,6 +755,8 @@ public:
   COUNTER(upstream_cx_none_healthy)                                                                \
   COUNTER(upstream_cx_overflow)                                                                    \
   COUNTER(upstream_cx_pool_overflow)                                                               \
+  COUNTER(upstream_cx_preconnect_hit)                                                              \
+  COUNTER(upstream_cx_preconnect_waste)                                                            \
   COUNTER(upstream_cx_protocol_error)                                                              \
   COUNTER(upstream_cx_rx_bytes_total)                                                              \
   COUNTER(upstream_cx_total)                                                                       \
@@ -784,6 +786,8 @@ public:
   COUNTER(upstream_rq_retry_success)                                                               \
   COUNTER(upstream_rq_rx_reset)                                                                    \
   COUNTER(upstream_rq_rx_reset_no_error)                                                           \
+  COUNTER(upstream_rq_shared_handoff)                                                              \
+  COUNTER(upstream_rq_shared_handoff_overflow)                                                     \
   COUNTER(upstream_rq_timeout)                                                                     \
   COUNTER(upstream_rq_total)                                                                       \
   COUNTER(upstream_rq_tx_reset)                                                                    \
@@ -795,7 +799,8 @@ public:
   GAUGE(upstream_rq_pending_active, Accumulate)                                                    \
   HISTOGRAM(upstream_cx_connect_ms, Milliseconds)                                                  \
   HISTOGRAM(upstream_cx_length_ms, Milliseconds)                                                   \
-  HISTOGRAM(upstream_rq_per_cx, Unspecified)
+  HISTOGRAM(upstream_rq_per_cx, Unspecified)                                                       \
+  HISTOGRAM(upstream_rq_shared_handoff_us, Microseconds)
 
 /**
  * All cluster load report stats. These are only use for EDS load reporting and not sent to the
@@ -1077,6 +1082,13 @@ public:
    */
   virtual float peekaheadRatio() const PURE;
 
+  /**
+   * @return the configuration of adaptive preconnecting for the connection pools of the cluster,
+   * or an empty OptRef if it is disabled.
+   */
+  virtual OptRef<const envoy::config::cluster::v3::Cluster::PreconnectPolicy::AdaptivePreconnect>
+  adaptivePreconnectConfig() const PURE;
+
   /**
    * @return soft limit on size of the cluster's connections read and write buffers.
    */
@@ -1287,6 +1299,18 @@ public:
    */
   virtual bool connectionPoolPerDownstreamConnection() const PURE;
 
+  /**
+   * @return the number of workers that hold the HTTP/2 and HTTP/3 connections to each host for
+   *         the other workers, or 0 if the workers do not share their connections.
+   */
+  virtual uint32_t sharedUpstreamConnectionOwners() const PURE;
+
+  /**
+   * @return the maximum number of streams of a worker that may wait for an owner worker when the
+   *         connections are shared.
+   */
+  virtual uint32_t maxPendingStreamHandoffs() const PURE;
+
   /**
    * @return true if this cluster is configured to ignore hosts for the purpose of load balancing
    * computations until they have been health checked for the first time.
@@ -11,6 +11,7 @@
 
 #if defined(__linux__)
 #include <linux/filter.h>
+#include <sys/sendfile.h>
 #endif
 
 #include "envoy/network/socket.h"
@@ -72,6 +73,54 @@ SysCallSizeResult OsSysCallsImpl::pread(os_fd_t fd, void* buffer, size_t length,
   return {rc, rc != -1 ? 0 : errno};
 }
 
+SysCallSizeResult OsSysCallsImpl::sendfile(os_fd_t out_fd, os_fd_t in_fd, off_t offset,
+                                           size_t count) {
+#if defined(__linux__)
+  const ssize_t rc = ::sendfile(out_fd, in_fd, &offset, count);
+  return {rc, rc != -1 ? 0 : errno};
+#else
+  UNREFERENCED_PARAMETER(out_fd);
+  UNREFERENCED_PARAMETER(in_fd);
+  UNREFERENCED_PARAMETER(offset);
+  UNREFERENCED_PARAMETER(count);
+  return {-1, SOCKET_ERROR_NOT_SUP};
+#endif
+}
+
+SysCallSizeResult OsSysCallsImpl::splice(os_fd_t fd_in, os_fd_t fd_out, size_t length) {
+#if defined(__linux__)
+  const ssize_t rc =
+      ::splice(fd_in, nullptr, fd_out, nullptr, length, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+  return {rc, rc != -1 ? 0 : errno};
+#else
+  UNREFERENCED_PARAMETER(fd_in);
+  UNREFERENCED_PARAMETER(fd_out);
+  UNREFERENCED_PARAMETER(length);
+  return {-1, SOCKET_ERROR_NOT_SUP};
+#endif
+}
+
+SysCallIntResult OsSysCallsImpl::pipe(os_fd_t fds[2]) {
+#if defined(__linux__)
+  const int rc = ::pipe2(fds, O_NONBLOCK | O_CLOEXEC);
+  return {rc, rc != -1 ? 0 : errno};
+#else
+  int rc = ::pipe(fds);
+  if (rc == -1) {
+    return {rc, errno};
+  }
+  for (int i = 0; i < 2; i++) {
+    if (::fcntl(fds[i], F_SETFL, O_NONBLOCK) == -1 || ::fcntl(fds[i], F_SETFD, FD_CLOEXEC) == -1) {
+      const int error = errno;
+      ::close(fds[0]);
+      ::close(fds[1]);
+      return {-1, error};
+    }
+  }
+  return {0, 0};
+#endif
+}
+
 SysCallSizeResult OsSysCallsImpl::send(os_fd_t socket, void* buffer, size_t length, int flags) {
   const ssize_t rc = ::send(socket, buffer, length, flags);
   return {rc, rc != -1 ? 0 : errno};
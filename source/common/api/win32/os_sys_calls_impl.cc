@@ -158,6 +158,21 @@ SysCallSizeResult OsSysCallsImpl::pread(os_fd_t fd, void* buffer, size_t length,
   PANIC("not implemented");
 }
 
+SysCallSizeResult OsSysCallsImpl::sendfile(os_fd_t, os_fd_t, off_t, size_t) {
+  // Windows doesn't support it.
+  return {-1, SOCKET_ERROR_NOT_SUP};
+}
+
+SysCallSizeResult OsSysCallsImpl::splice(os_fd_t, os_fd_t, size_t) {
+  // Windows doesn't support it.
+  return {-1, SOCKET_ERROR_NOT_SUP};
+}
+
+SysCallIntResult OsSysCallsImpl::pipe(os_fd_t[2]) {
+  // Windows doesn't support it.
+  return {-1, SOCKET_ERROR_NOT_SUP};
+}
+
 SysCallSizeResult OsSysCallsImpl::send(os_fd_t socket, void* buffer, size_t length, int flags) {
   const ssize_t rc = ::send(socket, static_cast<char*>(buffer), length, flags);
   return {rc, rc != -1 ? 0 : ::WSAGetLastError()};
@@ -24,6 +24,9 @@ public:
   SysCallSizeResult pwrite(os_fd_t fd, const void* buffer, size_t length,
                            off_t offset) const override;
   SysCallSizeResult pread(os_fd_t fd, void* buffer, size_t length, off_t offset) const override;
+  SysCallSizeResult sendfile(os_fd_t out_fd, os_fd_t in_fd, off_t offset, size_t count) override;
+  SysCallSizeResult splice(os_fd_t fd_in, os_fd_t fd_out, size_t length) override;
+  SysCallIntResult pipe(os_fd_t fds[2]) override;
   SysCallSizeResult send(os_fd_t socket, void* buffer, size_t length, int flags) override;
   SysCallSizeResult recv(os_fd_t socket, void* buffer, size_t length, int flags) override;
   SysCallSizeResult recvmsg(os_fd_t sockfd, msghdr* msg, int flags) override;
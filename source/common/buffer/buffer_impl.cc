@@ -17,6 +17,9 @@ namespace {
 // TODO(yanavlasov): This may not be optimal for all hardware configurations or traffic patterns and
 // may need to be configurable in the future.
 constexpr uint64_t CopyThreshold = 512;
+// Appends at least this large are copied into slice arena blocks, when arenas are enabled. Smaller
+// appends keep using right-sized heap slices so that small buffers do not pin a whole block.
+constexpr uint64_t ArenaAddThreshold = Slice::default_slice_size_ / 2;
 } // namespace
 
 thread_local absl::InlinedVector<Slice::StoragePtr,
@@ -25,6 +28,10 @@ thread_local absl::InlinedVector<Slice::StoragePtr,
 
 uint64_t Slice::prepend(const void* data, uint64_t size) {
   const uint8_t* src = static_cast<const uint8_t*>(data);
+  if (isFileBacked()) {
+    // The content must stay the file range.
+    return 0;
+  }
   uint64_t copy_size;
   if (dataSize() == 0) {
     // There is nothing in the slice, so put the data at the very end in case the caller
@@ -50,7 +57,15 @@ void OwnedImpl::addImpl(const void* data, uint64_t size) {
   bool new_slice_needed = slices_.empty();
   while (size != 0) {
     if (new_slice_needed) {
-      slices_.emplace_back(Slice(size, account_));
+      Slice::SizedStorage storage;
+      if (size >= ArenaAddThreshold) {
+        storage = Slice::newArenaStorage();
+      }
+      if (storage.mem_ != nullptr) {
+        slices_.emplace_back(Slice(std::move(storage), 0, account_));
+      } else {
+        slices_.emplace_back(Slice(size, account_));
+      }
     }
     uint64_t copy_size = slices_.back().append(src, size);
     src += copy_size;
@@ -233,6 +248,34 @@ RawSliceVector OwnedImpl::getRawSlices(std::optional<uint64_t> max_slices) const
   return raw_slices;
 }
 
+RawSliceVector OwnedImpl::getRawSlicesBeforeFileRange(std::optional<uint64_t> max_slices) const {
+  const uint64_t max_out = std::min<uint64_t>(slices_.size(), max_slices.value_or(UINT64_MAX));
+  RawSliceVector raw_slices;
+  for (const auto& slice : slices_) {
+    if (raw_slices.size() >= max_out) {
+      break;
+    }
+    if (slice.dataSize() == 0) {
+      continue;
+    }
+    if (slice.isFileBacked()) {
+      break;
+    }
+    raw_slices.emplace_back(
+        RawSlice{const_cast<uint8_t*>(slice.data()), static_cast<size_t>(slice.dataSize())});
+  }
+  return raw_slices;
+}
+
+std::optional<FileRange> OwnedImpl::frontFileRange() const {
+  for (const auto& slice : slices_) {
+    if (slice.dataSize() > 0) {
+      return slice.fileRange();
+    }
+  }
+  return std::nullopt;
+}
+
 RawSlice OwnedImpl::frontSlice() const {
   // Ignore zero-size slices and return the first slice with data.
   for (const auto& slice : slices_) {
@@ -9,16 +9,34 @@
 #include "envoy/buffer/buffer.h"
 #include "envoy/http/stream_reset_handler.h"
 
+#include "source/common/buffer/slice_arena.h"
 #include "source/common/common/assert.h"
 #include "source/common/common/non_copyable.h"
 #include "source/common/common/utility.h"
 #include "source/common/event/libevent.h"
 
+#include "absl/base/optimization.h"
 #include "absl/functional/any_invocable.h"
 
 namespace Envoy {
 namespace Buffer {
 
+/**
+ * Deleter for slice backing storage. Storage is either a heap array or, if arena_ is set, a block
+ * borrowed from a SliceArena.
+ */
+struct SliceStorageDeleter {
+  void operator()(uint8_t* mem) const {
+    if (arena_ != nullptr) {
+      arena_->release(mem);
+    } else {
+      delete[] mem;
+    }
+  }
+
+  SliceArena* arena_{nullptr};
+};
+
 /**
  * A Slice manages a contiguous block of bytes.
  * The block is arranged like this:
@@ -37,7 +55,7 @@ namespace Buffer {
 class Slice {
 public:
   using Reservation = RawSlice;
-  using StoragePtr = std::unique_ptr<uint8_t[]>;
+  using StoragePtr = std::unique_ptr<uint8_t[], SliceStorageDeleter>;
 
   struct SizedStorage {
     StoragePtr mem_;
@@ -85,13 +103,17 @@ public:
   }
 
   /**
-   * Create an immutable Slice that refers to an external buffer fragment.
+   * Create an immutable Slice that refers to an external buffer fragment. The data of a fragment
+   * referencing a file range is only fetched once accessed.
    * @param fragment provides externally owned immutable data.
    */
   Slice(BufferFragment& fragment)
-      : capacity_(fragment.size()), storage_(nullptr),
-        base_(static_cast<uint8_t*>(const_cast<void*>(fragment.data()))),
-        reservable_(fragment.size()) {
+      : capacity_(fragment.size()), storage_(nullptr), reservable_(fragment.size()) {
+    if (fragment.fileRange().has_value()) {
+      file_fragment_ = &fragment;
+    } else {
+      base_ = static_cast<uint8_t*>(const_cast<void*>(fragment.data()));
+    }
     releasor_ = [&fragment]() { fragment.done(); };
   }
 
@@ -104,9 +126,11 @@ public:
     drain_trackers_ = std::move(rhs.drain_trackers_);
     account_ = std::move(rhs.account_);
     releasor_.swap(rhs.releasor_);
+    file_fragment_ = rhs.file_fragment_;
 
     rhs.capacity_ = 0;
     rhs.base_ = nullptr;
+    rhs.file_fragment_ = nullptr;
     rhs.data_ = 0;
     rhs.reservable_ = 0;
   }
@@ -127,6 +151,8 @@ public:
       }
       releasor_ = rhs.releasor_;
       rhs.releasor_ = nullptr;
+      file_fragment_ = rhs.file_fragment_;
+      rhs.file_fragment_ = nullptr;
 
       rhs.capacity_ = 0;
       rhs.base_ = nullptr;
@@ -157,12 +183,31 @@ public:
   /**
    * @return a pointer to the start of the usable content.
    */
-  const uint8_t* data() const { return base_ + data_; }
+  const uint8_t* data() const { return base() + data_; }
 
   /**
    * @return a pointer to the start of the usable content.
    */
-  uint8_t* data() { return base_ + data_; }
+  uint8_t* data() { return base() + data_; }
+
+  /**
+   * @return true if the slice refers to a file-backed fragment.
+   */
+  bool isFileBacked() const { return file_fragment_ != nullptr; }
+
+  /**
+   * @return the file range holding the usable content, if the slice refers to a file-backed
+   *         fragment.
+   */
+  std::optional<FileRange> fileRange() const {
+    if (file_fragment_ == nullptr) {
+      return std::nullopt;
+    }
+    FileRange range = file_fragment_->fileRange().value();
+    range.offset_ += data_;
+    range.len_ = dataSize();
+    return range;
+  }
 
   /**
    * @return the size in bytes of the usable content.
@@ -343,6 +388,8 @@ public:
   }
 
   static constexpr uint32_t default_slice_size_ = 16384;
+  static_assert(default_slice_size_ == SliceArena::BlockSize,
+                "slice arena blocks must hold exactly one default size slice");
 
 public:
   /**
@@ -368,7 +415,28 @@ public:
     return {StoragePtr{new uint8_t[slice_size]}, static_cast<size_t>(slice_size)};
   }
 
+  /**
+   * Create new backend storage of default_slice_size_ bytes from the calling thread's slice arena.
+   * @return a backend storage for slice, or a storage with a null mem_ if slice arenas are disabled
+   *         or the arena is at its size cap.
+   */
+  static inline SizedStorage newArenaStorage() {
+    if (SliceArena* arena = SliceArena::threadLocalArena(); arena != nullptr) {
+      if (uint8_t* mem = arena->allocate(); mem != nullptr) {
+        return {StoragePtr{mem, SliceStorageDeleter{arena}}, default_slice_size_};
+      }
+    }
+    return {nullptr, default_slice_size_};
+  }
+
 protected:
+  uint8_t* base() const {
+    if (ABSL_PREDICT_FALSE(base_ == nullptr && file_fragment_ != nullptr)) {
+      base_ = static_cast<uint8_t*>(const_cast<void*>(file_fragment_->data()));
+    }
+    return base_;
+  }
+
   /** Length of the byte array that base_ points to. This is also the offset in bytes from the start
    * of the slice to the end of the Reservable section. */
   uint64_t capacity_ = 0;
@@ -377,8 +445,9 @@ protected:
    * accessed directly; access base_ instead. */
   StoragePtr storage_;
 
-  /** Start of the slice. Points to storage_ iff the slice owns its own storage. */
-  uint8_t* base_{nullptr};
+  /** Start of the slice. Points to storage_ iff the slice owns its own storage. Null until first
+   * accessed for a file-backed fragment. */
+  mutable uint8_t* base_{nullptr};
 
   /** Offset in bytes from the start of the slice to the start of the Data section. */
   uint64_t data_ = 0;
@@ -396,6 +465,9 @@ protected:
 
   /** The releasor for the BufferFragment */
   std::function<void()> releasor_;
+
+  /** The referenced fragment, if it is file-backed. */
+  BufferFragment* file_fragment_{nullptr};
 };
 
 class OwnedImpl;
@@ -662,6 +734,9 @@ public:
                            uint64_t num_slice) const override;
   void drain(uint64_t size) override;
   RawSliceVector getRawSlices(std::optional<uint64_t> max_slices = std::nullopt) const override;
+  RawSliceVector
+  getRawSlicesBeforeFileRange(std::optional<uint64_t> max_slices = std::nullopt) const override;
+  std::optional<FileRange> frontFileRange() const override;
   RawSlice frontSlice() const override;
   SliceDataPtr extractMutableFrontSlice() override;
   uint64_t length() const override;
@@ -784,7 +859,7 @@ private:
       if (!free_list_ref_.empty()) {
         storage.mem_ = std::move(free_list_ref_.back());
         free_list_ref_.pop_back();
-      } else {
+      } else if (storage = Slice::newArenaStorage(); storage.mem_ == nullptr) {
         storage.mem_.reset(new uint8_t[Slice::default_slice_size_]);
       }
 
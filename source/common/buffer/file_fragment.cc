@@ -0,0 +1,57 @@
+#include "source/common/buffer/file_fragment.h"
+
+#include <cstring>
+#include <utility>
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/common/utility.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Buffer {
+
+absl::Status FileFragment::append(Instance& buffer, os_fd_t fd, uint64_t offset,
+                                  uint64_t length, absl::AnyInvocable<void()> on_read_failure) {
+  const Api::SysCallSocketResult result = Api::OsSysCallsSingleton::get().duplicate(fd);
+  if (SOCKET_INVALID(result.return_value_)) {
+    return absl::InternalError(absl::StrCat("dup: ", errorDetails(result.errno_)));
+  }
+  buffer.addBufferFragment(
+      *new FileFragment(result.return_value_, offset, length, std::move(on_read_failure)));
+  return absl::OkStatus();
+}
+
+FileFragment::~FileFragment() { Api::OsSysCallsSingleton::get().close(fd_); }
+
+const void* FileFragment::data() const {
+  if (contents_ != nullptr) {
+    return contents_.get();
+  }
+  contents_ = std::make_unique<uint8_t[]>(length_);
+  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+  uint64_t read = 0;
+  while (read < length_) {
+    const Api::SysCallSizeResult result =
+        os_sys_calls.pread(fd_, contents_.get() + read, length_ - read, offset_ + read);
+    if (result.return_value_ > 0) {
+      read += result.return_value_;
+    } else if (result.return_value_ < 0 && result.errno_ == EINTR) {
+      continue;
+    } else {
+      ENVOY_LOG(error, "file range truncated at {} of {} bytes: {}", read, length_,
+                result.return_value_ == 0 ? "end of file" : errorDetails(result.errno_));
+      // The fragment still has to hold its length: the owner of the buffer is told to fail the
+      // stream instead.
+      memset(contents_.get() + read, 0, length_ - read);
+      if (on_read_failure_ != nullptr) {
+        std::exchange(on_read_failure_, nullptr)();
+      }
+      break;
+    }
+  }
+  return contents_.get();
+}
+
+} // namespace Buffer
+} // namespace Envoy
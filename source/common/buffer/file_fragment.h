@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/common/platform.h"
+
+#include "source/common/common/logger.h"
+#include "source/common/common/non_copyable.h"
+
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
+
+namespace Envoy {
+namespace Buffer {
+
+/**
+ * A BufferFragment referencing a range of a file. Sockets send the range with sendfile(), so that
+ * its contents never enter user space, unless something needs them in memory: a filter inspecting
+ * the body or a TLS socket encrypting it in BoringSSL, for instance. The range is then read with
+ * pread() the first time data() is called.
+ *
+ * The fragment holds its own duplicate of the file descriptor. The file must not be truncated
+ * while it is referenced: a socket writing a range past its end fails the write, which closes the
+ * connection, and reading such a range into memory calls the read failure callback of the fragment,
+ * so that its owner fails the stream rather than let the missing bytes go out as zeros.
+ */
+class FileFragment : NonCopyable,
+                     public BufferFragment,
+                     protected Logger::Loggable<Logger::Id::file> {
+public:
+  /**
+   * Appends a range of a file to a buffer.
+   * @param buffer supplies the buffer to append to.
+   * @param fd supplies the file, which the caller may close afterwards.
+   * @param offset supplies the offset of the range in the file.
+   * @param length supplies the length of the range.
+   * @param on_read_failure supplies an optional callback, called on the thread reading the
+   *        contents if the range could not be read in full. It must not modify the buffer.
+   * @return an error if the file descriptor could not be duplicated.
+   */
+  static absl::Status append(Instance& buffer, os_fd_t fd, uint64_t offset, uint64_t length,
+                             absl::AnyInvocable<void()> on_read_failure = nullptr);
+
+  ~FileFragment() override;
+
+  // Buffer::BufferFragment
+  const void* data() const override;
+  size_t size() const override { return length_; }
+  void done() override { delete this; }
+  std::optional<FileRange> fileRange() const override {
+    return FileRange{fd_, offset_, length_};
+  }
+
+private:
+  FileFragment(os_fd_t fd, uint64_t offset, uint64_t length,
+               absl::AnyInvocable<void()> on_read_failure)
+      : fd_(fd), offset_(offset), length_(length), on_read_failure_(std::move(on_read_failure)) {}
+
+  const os_fd_t fd_;
+  const uint64_t offset_;
+  const uint64_t length_;
+  // Called, then cleared, if the contents could not be read in full.
+  mutable absl::AnyInvocable<void()> on_read_failure_;
+  // The contents of the range, once read.
+  mutable std::unique_ptr<uint8_t[]> contents_;
+};
+
+} // namespace Buffer
+} // namespace Envoy
@@ -0,0 +1,179 @@
+#include "source/common/buffer/slice_arena.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include <algorithm>
+#include <new>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/macros.h"
+
+#include "absl/container/flat_hash_set.h"
+
+namespace Envoy {
+namespace Buffer {
+namespace {
+
+struct ArenaRegistry {
+  absl::Mutex mutex_;
+  absl::flat_hash_set<SliceArena*> arenas_ ABSL_GUARDED_BY(mutex_);
+};
+
+ArenaRegistry& registry() { MUTABLE_CONSTRUCT_ON_FIRST_USE(ArenaRegistry); }
+
+// Deliberately a trivially destructible pointer so that it stays readable while other thread local
+// objects holding slices are destroyed at thread exit.
+thread_local SliceArena* thread_local_arena = nullptr;
+} // namespace
+
+// Orphans the calling thread's arena when the thread exits.
+struct ThreadLocalSliceArena {
+  ~ThreadLocalSliceArena() {
+    if (thread_local_arena != nullptr) {
+      SliceArena* arena = thread_local_arena;
+      thread_local_arena = nullptr;
+      arena->orphan();
+    }
+  }
+};
+
+namespace {
+thread_local ThreadLocalSliceArena thread_local_arena_reaper;
+} // namespace
+
+std::atomic<uint64_t> SliceArena::max_bytes_{0};
+
+SliceArena::SliceArena() = default;
+
+SliceArena::~SliceArena() {
+  for (uint8_t* chunk : chunks_) {
+    ::operator delete(chunk, std::align_val_t{ChunkSize});
+  }
+}
+
+void SliceArena::configure(uint64_t max_bytes_per_arena) {
+  max_bytes_.store(max_bytes_per_arena - (max_bytes_per_arena % ChunkSize),
+                   std::memory_order_relaxed);
+}
+
+SliceArena* SliceArena::threadLocalArenaSlow() {
+  if (thread_local_arena == nullptr) {
+    // Touch the reaper so that its destructor runs when this thread exits.
+    static_cast<void>(&thread_local_arena_reaper);
+    thread_local_arena = new SliceArena();
+    ArenaRegistry& arenas = registry();
+    absl::MutexLock lock(&arenas.mutex_);
+    arenas.arenas_.insert(thread_local_arena);
+  }
+  return thread_local_arena;
+}
+
+uint8_t* SliceArena::allocate() {
+  ASSERT(thread_local_arena == this);
+  if (free_blocks_.empty() && has_remote_frees_.load(std::memory_order_acquire)) {
+    reclaimRemoteFrees();
+  }
+  if (free_blocks_.empty() && !addChunk()) {
+    overflow_allocations_.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  uint8_t* block = free_blocks_.back();
+  free_blocks_.pop_back();
+  in_use_blocks_.fetch_add(1, std::memory_order_relaxed);
+  return block;
+}
+
+void SliceArena::release(uint8_t* block) {
+  if (thread_local_arena == this) {
+    free_blocks_.push_back(block);
+    in_use_blocks_.fetch_sub(1, std::memory_order_relaxed);
+    return;
+  }
+
+  bool destroy = false;
+  {
+    absl::MutexLock lock(&remote_mutex_);
+    if (!orphaned_) {
+      remote_free_blocks_.push_back(block);
+      has_remote_frees_.store(true, std::memory_order_release);
+    }
+    destroy = in_use_blocks_.fetch_sub(1, std::memory_order_relaxed) == 1 && orphaned_;
+  }
+  if (destroy) {
+    delete this;
+  }
+}
+
+bool SliceArena::addChunk() {
+  const uint64_t reserved = reserved_bytes_.load(std::memory_order_relaxed);
+  if (reserved + ChunkSize > max_bytes_.load(std::memory_order_relaxed)) {
+    return false;
+  }
+  auto* chunk =
+      static_cast<uint8_t*>(::operator new(ChunkSize, std::align_val_t{ChunkSize}, std::nothrow));
+  if (chunk == nullptr) {
+    return false;
+  }
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  // Best effort; the chunk is still usable if transparent huge pages are unavailable.
+  ::madvise(chunk, ChunkSize, MADV_HUGEPAGE);
+#endif
+  chunks_.push_back(chunk);
+  reserved_bytes_.store(reserved + ChunkSize, std::memory_order_relaxed);
+
+  // Push in reverse so that blocks are handed out in address order.
+  free_blocks_.reserve(free_blocks_.size() + BlocksPerChunk);
+  for (uint64_t i = BlocksPerChunk; i > 0; --i) {
+    free_blocks_.push_back(chunk + (i - 1) * BlockSize);
+  }
+  return true;
+}
+
+void SliceArena::reclaimRemoteFrees() {
+  absl::MutexLock lock(&remote_mutex_);
+  free_blocks_.insert(free_blocks_.end(), remote_free_blocks_.begin(), remote_free_blocks_.end());
+  remote_free_blocks_.clear();
+  has_remote_frees_.store(false, std::memory_order_relaxed);
+}
+
+void SliceArena::orphan() {
+  {
+    ArenaRegistry& arenas = registry();
+    absl::MutexLock lock(&arenas.mutex_);
+    arenas.arenas_.erase(this);
+  }
+
+  bool destroy = false;
+  {
+    absl::MutexLock lock(&remote_mutex_);
+    orphaned_ = true;
+    destroy = in_use_blocks_.load(std::memory_order_relaxed) == 0;
+  }
+  if (destroy) {
+    delete this;
+  }
+}
+
+SliceArenaStats SliceArena::stats() {
+  SliceArenaStats stats;
+  const uint64_t max_bytes = max_bytes_.load(std::memory_order_relaxed);
+  ArenaRegistry& arenas = registry();
+  absl::MutexLock lock(&arenas.mutex_);
+  for (const SliceArena* arena : arenas.arenas_) {
+    const uint64_t in_use = arena->inUseBytes();
+    stats.reserved_bytes_ += arena->reservedBytes();
+    stats.in_use_bytes_ += in_use;
+    stats.overflow_allocations_ += arena->overflow_allocations_.load(std::memory_order_relaxed);
+    if (max_bytes > 0) {
+      stats.max_pressure_ =
+          std::max(stats.max_pressure_, std::min(1.0, static_cast<double>(in_use) / max_bytes));
+    }
+  }
+  stats.arenas_ = arenas.arenas_.size();
+  return stats;
+}
+
+} // namespace Buffer
+} // namespace Envoy
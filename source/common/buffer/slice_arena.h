@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "source/common/common/non_copyable.h"
+
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Buffer {
+
+/**
+ * Point-in-time usage summed over all live slice arenas in the process.
+ */
+struct SliceArenaStats {
+  // Bytes of chunk memory the arenas have obtained from the heap.
+  uint64_t reserved_bytes_{};
+  // Bytes of arena blocks currently backing buffer slices.
+  uint64_t in_use_bytes_{};
+  // Number of block requests that could not be served because an arena was at its size cap.
+  uint64_t overflow_allocations_{};
+  // Number of live arenas, i.e. threads that have used an arena since it was enabled.
+  uint64_t arenas_{};
+  // The highest ratio of in-use bytes to the configured cap across all arenas, in [0, 1].
+  double max_pressure_{};
+};
+
+/**
+ * A per-thread pool of fixed size buffer slice blocks. Blocks are carved out of 2 MiB chunks which
+ * are aligned so that the kernel can back them with transparent huge pages, and the chunks are
+ * kept for the lifetime of the arena. This takes steady-state slice allocation for socket reads
+ * off the general purpose heap.
+ *
+ * Blocks are normally allocated and released on the thread owning the arena without any locking.
+ * A block released on another thread (e.g. because its buffer was moved across threads) is
+ * queued under a mutex and reclaimed by the owner on its next allocation. If the owning thread
+ * exits while blocks are still outstanding, the arena is destroyed when the last block returns.
+ *
+ * Arenas are disabled by default. They are enabled process-wide with configure(), typically via
+ * the envoy.resource_monitors.slice_arena overload manager resource monitor.
+ */
+class SliceArena : NonCopyable {
+public:
+  // The size of a block handed out by allocate(). Matches Slice::default_slice_size_.
+  static constexpr uint64_t BlockSize = 16384;
+  // The size of a chunk obtained from the heap. Chosen to match the x86-64 huge page size.
+  static constexpr uint64_t ChunkSize = 2 * 1024 * 1024;
+  static constexpr uint64_t BlocksPerChunk = ChunkSize / BlockSize;
+
+  ~SliceArena();
+
+  /**
+   * Allocate a block of BlockSize bytes. Must be called on the owning thread.
+   * @return the block, or nullptr if the arena is at its size cap.
+   */
+  uint8_t* allocate();
+
+  /**
+   * Return a block obtained from allocate(). May be called on any thread.
+   */
+  void release(uint8_t* block);
+
+  /**
+   * @return bytes of chunk memory held by this arena.
+   */
+  uint64_t reservedBytes() const { return reserved_bytes_.load(std::memory_order_relaxed); }
+
+  /**
+   * @return bytes of blocks currently handed out by this arena.
+   */
+  uint64_t inUseBytes() const {
+    return in_use_blocks_.load(std::memory_order_relaxed) * BlockSize;
+  }
+
+  /**
+   * Enable or disable slice arenas for all threads.
+   * @param max_bytes_per_arena the cap on chunk memory each thread's arena may hold. A value of 0
+   *        disables arenas; blocks already handed out remain valid and are returned normally.
+   *        Values are rounded down to a multiple of ChunkSize.
+   */
+  static void configure(uint64_t max_bytes_per_arena);
+
+  /**
+   * @return whether arenas are enabled.
+   */
+  static bool enabled() { return max_bytes_.load(std::memory_order_relaxed) != 0; }
+
+  /**
+   * @return the calling thread's arena, creating it if needed, or nullptr if arenas are disabled.
+   */
+  static SliceArena* threadLocalArena() { return enabled() ? threadLocalArenaSlow() : nullptr; }
+
+  /**
+   * @return usage summed over all live arenas.
+   */
+  static SliceArenaStats stats();
+
+private:
+  friend struct ThreadLocalSliceArena;
+
+  SliceArena();
+
+  static SliceArena* threadLocalArenaSlow();
+
+  bool addChunk();
+  void reclaimRemoteFrees();
+  // Called on the owning thread when it exits.
+  void orphan();
+
+  static std::atomic<uint64_t> max_bytes_;
+
+  // Chunks and free blocks are only touched by the owning thread.
+  std::vector<uint8_t*> chunks_;
+  std::vector<uint8_t*> free_blocks_;
+  std::atomic<uint64_t> reserved_bytes_{0};
+  std::atomic<uint64_t> in_use_blocks_{0};
+  std::atomic<uint64_t> overflow_allocations_{0};
+
+  absl::Mutex remote_mutex_;
+  std::vector<uint8_t*> remote_free_blocks_ ABSL_GUARDED_BY(remote_mutex_);
+  std::atomic<bool> has_remote_frees_{false};
+  bool orphaned_ ABSL_GUARDED_BY(remote_mutex_){false};
+};
+
+} // namespace Buffer
+} // namespace Envoy
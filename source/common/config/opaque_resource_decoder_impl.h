@@ -28,6 +28,19 @@ public:
     return MessageUtil::getStringField(resource, name_field_);
   }
 
+  ProtobufTypes::MessagePtr parseResource(const Protobuf::Any& resource) override {
+    auto typed_message = std::make_unique<Current>();
+    // Leave the resources that fail to unpack to decodeResource(), which reports the error.
+    if (resource.type_url().empty() || !MessageUtil::unpackTo(resource, *typed_message).ok()) {
+      return nullptr;
+    }
+    return typed_message;
+  }
+
+  void validateResource(const Protobuf::Message& resource) override {
+    MessageUtil::validate(static_cast<const Current&>(resource), validation_visitor_);
+  }
+
 private:
   ProtobufMessage::ValidationVisitor& validation_visitor_;
   const std::string name_field_;
@@ -0,0 +1,91 @@
+#include "source/common/conn_pool/adaptive_preconnect.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "source/common/protobuf/utility.h"
+
+namespace Envoy {
+namespace ConnectionPool {
+namespace {
+
+// The weight of each new sample in the moving average of the connect latency.
+constexpr double ConnectLatencyWeight = 0.2;
+// Above this mean, the percentiles of the Poisson distribution are approximated by the ones of the
+// normal distribution, rather than summed term by term.
+constexpr double MaxExactPoissonMean = 30;
+
+// Returns the standard score whose standard normal cumulative probability is the given one.
+double standardScore(double probability) {
+  double low = -10;
+  double high = 10;
+  for (int i = 0; i < 64; ++i) {
+    const double mid = (low + high) / 2;
+    if (std::erfc(-mid / std::sqrt(2.0)) / 2 < probability) {
+      low = mid;
+    } else {
+      high = mid;
+    }
+  }
+  return (low + high) / 2;
+}
+
+} // namespace
+
+AdaptivePreconnect::AdaptivePreconnect(
+    const envoy::config::cluster::v3::Cluster::PreconnectPolicy::AdaptivePreconnect& config,
+    TimeSource& time_source)
+    : time_source_(time_source),
+      time_constant_(
+          std::max<uint64_t>(PROTOBUF_GET_MS_OR_DEFAULT(config, rate_time_constant, 1000), 1) /
+          1000.0),
+      percentile_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, burst_percentile, 99.0) / 100),
+      z_score_(standardScore(percentile_)),
+      max_headroom_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_headroom_streams, 100)),
+      last_arrival_(time_source_.monotonicTime()) {}
+
+void AdaptivePreconnect::onStreamRequested() {
+  // Each arrival adds 1 / time_constant_ to the decayed rate, which makes the expected rate equal
+  // to the arrival rate at steady state.
+  rate_ = arrivalRate() + 1 / time_constant_;
+  last_arrival_ = time_source_.monotonicTime();
+}
+
+void AdaptivePreconnect::onConnected(std::chrono::microseconds connect_latency) {
+  const double latency = connect_latency.count() / 1e6;
+  if (connect_latency_ == 0) {
+    connect_latency_ = latency;
+  } else {
+    connect_latency_ += ConnectLatencyWeight * (latency - connect_latency_);
+  }
+}
+
+double AdaptivePreconnect::arrivalRate() const {
+  const double elapsed =
+      std::chrono::duration<double>(time_source_.monotonicTime() - last_arrival_).count();
+  return rate_ * std::exp(-elapsed / time_constant_);
+}
+
+uint32_t AdaptivePreconnect::headroom() const {
+  const double mean = arrivalRate() * connect_latency_;
+  if (mean <= 0) {
+    return 0;
+  }
+  if (mean > MaxExactPoissonMean) {
+    const double quantile = std::ceil(mean + z_score_ * std::sqrt(mean));
+    return static_cast<uint32_t>(std::min<double>(quantile, max_headroom_));
+  }
+  // Sum the probabilities of 0, 1, 2... arrivals until they reach the percentile.
+  double probability = std::exp(-mean);
+  double cumulative = probability;
+  uint32_t arrivals = 0;
+  while (cumulative < percentile_ && arrivals < max_headroom_) {
+    ++arrivals;
+    probability *= mean / arrivals;
+    cumulative += probability;
+  }
+  return arrivals;
+}
+
+} // namespace ConnectionPool
+} // namespace Envoy
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/common/time.h"
+#include "envoy/config/cluster/v3/cluster.pb.h"
+
+namespace Envoy {
+namespace ConnectionPool {
+
+// Estimates how much warm capacity a connection pool needs, beyond the capacity for its pending
+// streams, to serve the streams that arrive while a new connection connects.
+//
+// The stream arrival rate and the connect latency are tracked as exponentially weighted moving
+// averages. The rate decays with the time since the last arrival, so the estimate drops as soon as
+// the load does rather than on the next stream. The number of arrivals within one connect latency
+// is taken as Poisson distributed, and the headroom is its configured percentile.
+class AdaptivePreconnect {
+public:
+  AdaptivePreconnect(
+      const envoy::config::cluster::v3::Cluster::PreconnectPolicy::AdaptivePreconnect& config,
+      TimeSource& time_source);
+
+  // Called for each new stream of the pool.
+  void onStreamRequested();
+
+  // Called when a connection of the pool connects, with the time it took to connect.
+  void onConnected(std::chrono::microseconds connect_latency);
+
+  // Returns the number of streams to keep warm capacity for. This is zero until the first
+  // connection of the pool has connected.
+  uint32_t headroom() const;
+
+  // Returns the estimated stream arrival rate, in streams per second.
+  double arrivalRate() const;
+
+  // Returns the estimated connect latency, in seconds.
+  double connectLatency() const { return connect_latency_; }
+
+private:
+  TimeSource& time_source_;
+  // In seconds.
+  const double time_constant_;
+  const double percentile_;
+  // The standard score of percentile_, for the normal approximation of large means.
+  const double z_score_;
+  const uint32_t max_headroom_;
+  double rate_{};
+  MonotonicTime last_arrival_;
+  double connect_latency_{};
+};
+
+} // namespace ConnectionPool
+} // namespace Envoy
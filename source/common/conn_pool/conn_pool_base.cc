@@ -64,6 +64,11 @@ ConnPoolImplBase::ConnPoolImplBase(
   ENVOY_LOG_ONCE_IF(trace, create_new_connection_load_shed_ == nullptr,
                     "LoadShedPoint envoy.load_shed_points.connection_pool_new_connection is not "
                     "found. Is it configured?");
+  const auto adaptive_preconnect_config = host_->cluster().adaptivePreconnectConfig();
+  if (adaptive_preconnect_config.has_value()) {
+    adaptive_preconnect_ = std::make_unique<AdaptivePreconnect>(*adaptive_preconnect_config,
+                                                                dispatcher_.timeSource());
+  }
 }
 
 ConnPoolImplBase::~ConnPoolImplBase() {
@@ -144,16 +149,19 @@ bool ConnPoolImplBase::shouldCreateNewConnection(float global_preconnect_ratio)
     //
     // Local preconnect does not need to anticipate a stream. It is called as
     // new streams are established or torn down and simply attempts to maintain
-    // the correct ratio of streams and anticipated capacity.
+    // the correct ratio of streams and anticipated capacity, and the capacity for
+    // the streams expected to arrive while a new connection connects.
+    const uint32_t headroom = adaptivePreconnectHeadroom();
     bool result =
         shouldConnect(pending_streams_.size(), num_active_streams_,
-                      connecting_and_connected_stream_capacity_, perUpstreamPreconnectRatio());
+                      connecting_and_connected_stream_capacity_, perUpstreamPreconnectRatio()) ||
+        pending_streams_.size() + headroom > connecting_and_connected_stream_capacity_;
     ENVOY_LOG(trace,
               "per-upstream shouldCreateNewConnection returns {} for pending {} active {} "
-              "connecting_and_connected_capacity {} connecting_capacity {} ratio {}",
+              "connecting_and_connected_capacity {} connecting_capacity {} ratio {} headroom {}",
               result, pending_streams_.size(), num_active_streams_,
               connecting_and_connected_stream_capacity_, connecting_stream_capacity_,
-              perUpstreamPreconnectRatio());
+              perUpstreamPreconnectRatio(), headroom);
     return result;
   }
 }
@@ -217,6 +225,9 @@ ConnPoolImplBase::tryCreateNewConnection(float global_preconnect_ratio) {
                   client->currentUnusedCapacity(),
               dumpState());
     ASSERT(client->real_host_description_);
+    // The connection is not needed by any pending stream if the connecting capacity already
+    // covers them.
+    client->preconnected_ = pending_streams_.size() <= connecting_stream_capacity_;
     // Increase the connecting capacity to reflect the streams this connection can serve.
     incrConnectingAndConnectedStreamCapacity(client->currentUnusedCapacity(), *client);
     LinkedList::moveIntoList(std::move(client), owningList(client->state()));
@@ -275,6 +286,12 @@ void ConnPoolImplBase::attachStreamToClient(Envoy::ConnectionPool::ActiveClient&
   traffic_stats.upstream_rq_total_.inc();
   traffic_stats.upstream_rq_active_.inc();
   host_->cluster().resourceManager(priority_).requests().inc();
+  if (!client.served_stream_) {
+    client.served_stream_ = true;
+    if (client.preconnected_) {
+      traffic_stats.upstream_cx_preconnect_hit_.inc();
+    }
+  }
 
   onPoolReady(client, context);
 }
@@ -326,6 +343,28 @@ void ConnPoolImplBase::onStreamClosed(Envoy::ConnectionPool::ActiveClient& clien
       }
     }
   }
+  if (adaptive_preconnect_ != nullptr && client.state() == ActiveClient::State::Ready &&
+      client.numActiveStreams() == 0) {
+    maybeTrimIdleClient(client);
+  }
+}
+
+void ConnPoolImplBase::maybeTrimIdleClient(ActiveClient& client) {
+  // Always keep one ready client, so that the pool does not go cold between streams. The pools
+  // that delay attaching the pending streams to a ready client have yet to hand this one a stream.
+  if (ready_clients_.size() <= 1 || !pending_streams_.empty()) {
+    return;
+  }
+  const uint64_t remaining_capacity =
+      connecting_and_connected_stream_capacity_ - client.currentUnusedCapacity();
+  if (pending_streams_.size() + adaptivePreconnectHeadroom() > remaining_capacity ||
+      shouldConnect(pending_streams_.size(), num_active_streams_, remaining_capacity,
+                    perUpstreamPreconnectRatio())) {
+    return;
+  }
+  ENVOY_CONN_LOG(debug, "closing idle client in excess of the adaptive preconnect headroom",
+                 client);
+  client.close();
 }
 
 ConnectionPool::Cancellable* ConnPoolImplBase::newStreamImpl(AttachContext& context,
@@ -334,6 +373,10 @@ ConnectionPool::Cancellable* ConnPoolImplBase::newStreamImpl(AttachContext& cont
   ASSERT(!deferred_deleting_, dumpState());
   assertCapacityCountsAreCorrect();
 
+  if (adaptive_preconnect_ != nullptr) {
+    adaptive_preconnect_->onStreamRequested();
+  }
+
   if (!ready_clients_.empty()) {
     ActiveClient& client = *ready_clients_.front();
     ENVOY_CONN_LOG(debug, "using existing fully connected connection", client);
@@ -588,6 +631,9 @@ void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view
     ENVOY_CONN_LOG(debug, "client disconnected, failure reason: {}", client, failure_reason);
 
     Envoy::Upstream::reportUpstreamCxDestroy(host_, event);
+    if (client.preconnected_ && !client.served_stream_) {
+      host_->cluster().trafficStats()->upstream_cx_preconnect_waste_.inc();
+    }
     const bool incomplete_stream = client.closingWithIncompleteStream();
     if (incomplete_stream) {
       Envoy::Upstream::reportUpstreamCxDestroyActiveRequest(host_, event);
@@ -668,6 +714,10 @@ void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view
     ENVOY_BUG(connecting_stream_capacity_ >= client.currentUnusedCapacity(), dumpState());
     connecting_stream_capacity_ -= client.currentUnusedCapacity();
     client.has_handshake_completed_ = true;
+    if (adaptive_preconnect_ != nullptr) {
+      adaptive_preconnect_->onConnected(std::chrono::duration_cast<std::chrono::microseconds>(
+          dispatcher_.timeSource().monotonicTime() - client.connect_start_time_));
+    }
     client.conn_connect_ms_->complete();
     client.conn_connect_ms_.reset();
     if (client.state() == ActiveClient::State::Connecting ||
@@ -756,8 +806,14 @@ bool ConnPoolImplBase::connectingConnectionIsExcess(const ActiveClient& client)
   // If preconnect ratio is set, it also factors in the anticipated load based on both queued
   // streams and active streams, and makes sure the connecting capacity would still be sufficient to
   // serve that even with the most recent client removed.
+  //
+  // With adaptive preconnecting, the rest of the pool must also keep the capacity for the
+  // pending streams and the headroom.
   return (pending_streams_.size() + num_active_streams_) * perUpstreamPreconnectRatio() <=
-         (connecting_stream_capacity_ - client.currentUnusedCapacity() + num_active_streams_);
+             (connecting_stream_capacity_ - client.currentUnusedCapacity() +
+              num_active_streams_) &&
+         pending_streams_.size() + adaptivePreconnectHeadroom() <=
+             connecting_and_connected_stream_capacity_ - client.currentUnusedCapacity();
 }
 
 void ConnPoolImplBase::onPendingStreamCancel(PendingStream& stream,
@@ -874,6 +930,7 @@ ActiveClient::ActiveClient(ConnPoolImplBase& parent, uint32_t lifetime_stream_li
     : parent_(parent), remaining_streams_(translateZeroToUnlimited(lifetime_stream_limit)),
       configured_stream_limit_(translateZeroToUnlimited(effective_concurrent_streams)),
       concurrent_stream_limit_(translateZeroToUnlimited(concurrent_stream_limit)),
+      connect_start_time_(parent_.dispatcher().timeSource().monotonicTime()),
       connect_timer_(parent_.dispatcher().createTimer([this]() { onConnectTimeout(); })) {
   conn_connect_ms_ = std::make_unique<Stats::HistogramCompletableTimespanImpl>(
       parent_.host()->cluster().trafficStats()->upstream_cx_connect_ms_,
@@ -10,6 +10,7 @@
 #include "source/common/common/debug_recursion_checker.h"
 #include "source/common/common/dump_state_utils.h"
 #include "source/common/common/linked_object.h"
+#include "source/common/conn_pool/adaptive_preconnect.h"
 
 #include "absl/strings/string_view.h"
 #include "fmt/ostream.h"
@@ -146,12 +147,17 @@ public:
   Upstream::HostDescriptionConstSharedPtr real_host_description_;
   Stats::TimespanPtr conn_connect_ms_;
   Stats::TimespanPtr conn_length_;
+  MonotonicTime connect_start_time_;
   Event::TimerPtr connect_timer_;
   Event::TimerPtr connection_duration_timer_;
   bool resources_released_{false};
   bool timed_out_{false};
   // TODO(danzh) remove this once http codec exposes the handshake state for h3.
   bool has_handshake_completed_{false};
+  // True if the connection was created ahead of the streams it would serve, rather than for a
+  // pending stream.
+  bool preconnected_{false};
+  bool served_stream_{false};
 
 protected:
   // HTTP/3 subclass should override this.
@@ -303,7 +309,8 @@ public:
        << DUMP_MEMBER(connecting_stream_capacity_)
        << DUMP_MEMBER(connecting_and_connected_stream_capacity_) << DUMP_MEMBER(num_active_streams_)
        << DUMP_MEMBER(pending_streams_.size())
-       << " per upstream preconnect ratio: " << perUpstreamPreconnectRatio();
+       << " per upstream preconnect ratio: " << perUpstreamPreconnectRatio()
+       << " adaptive preconnect headroom: " << adaptivePreconnectHeadroom();
   }
 
   friend std::ostream& operator<<(std::ostream& os, const ConnPoolImplBase& s) {
@@ -355,6 +362,16 @@ protected:
 
   float perUpstreamPreconnectRatio() const;
 
+  // Returns the number of streams to keep warm capacity for on top of the pending streams, if
+  // adaptive preconnecting is enabled.
+  uint32_t adaptivePreconnectHeadroom() const {
+    return adaptive_preconnect_ != nullptr ? adaptive_preconnect_->headroom() : 0;
+  }
+
+  // Closes the given idle client if the rest of the pool has enough capacity for the pending
+  // streams and the adaptive preconnect headroom.
+  void maybeTrimIdleClient(ActiveClient& client);
+
   ConnectionPool::Cancellable*
   addPendingStream(Envoy::ConnectionPool::PendingStreamPtr&& pending_stream) {
     LinkedList::moveIntoList(std::move(pending_stream), pending_streams_);
@@ -425,6 +442,7 @@ private:
   bool deferred_deleting_{false};
 
   Event::SchedulableCallbackPtr upstream_ready_cb_;
+  std::unique_ptr<AdaptivePreconnect> adaptive_preconnect_;
   Common::DebugRecursionChecker recursion_checker_;
   Server::LoadShedPoint* create_new_connection_load_shed_{nullptr};
 
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Coroutine {
+
+/**
+ * Allocator for the coroutine frames (and launch bookkeeping) of one logical operation, e.g. one
+ * HTTP stream. A coroutine opts in by taking a `FrameArena&` as its first parameter (after the
+ * implicit object parameter for member coroutines); its frame is then carved out of the arena
+ * instead of the heap. See `PromiseBase::operator new`.
+ *
+ * Allocation bumps a pointer through a caller-provided buffer. Frames of a `co_await` chain are
+ * released in reverse order of allocation, so a release of the most recent allocation moves the
+ * pointer back, and the arena rewinds entirely whenever nothing is live. Requests that do not fit
+ * fall back to the heap.
+ *
+ * Not thread-safe: a chain runs on a single executor. The arena must outlive every frame allocated
+ * from it.
+ */
+class FrameArena : NonCopyable {
+public:
+  // Every allocation is aligned for any frame, matching what `::operator new(size_t)` guarantees.
+  static constexpr size_t Alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+  ~FrameArena() { ASSERT(live_ == 0, "coroutine frames outlived their arena"); }
+
+  void* allocate(size_t size) {
+    const size_t rounded = roundUp(size);
+    if (rounded <= static_cast<size_t>(end_ - top_)) {
+      void* ptr = top_;
+      top_ += rounded;
+      ++live_;
+      return ptr;
+    }
+    ++heap_allocations_;
+    return ::operator new(size);
+  }
+
+  void deallocate(void* ptr, size_t size) {
+    std::byte* bytes = static_cast<std::byte*>(ptr);
+    if (bytes < begin_ || bytes >= end_) {
+      ::operator delete(ptr, size);
+      return;
+    }
+    ASSERT(live_ > 0);
+    if (--live_ == 0) {
+      top_ = begin_;
+    } else if (bytes + roundUp(size) == top_) {
+      top_ = bytes;
+    }
+  }
+
+  /**
+   * @return the number of allocations that did not fit in the arena and went to the heap.
+   */
+  uint64_t heapAllocations() const { return heap_allocations_; }
+
+  /**
+   * @return the number of bytes currently allocated from the arena buffer.
+   */
+  size_t bytesInUse() const { return top_ - begin_; }
+
+protected:
+  FrameArena(std::byte* buffer, size_t capacity)
+      : begin_(buffer), end_(buffer + capacity), top_(buffer) {}
+
+private:
+  static constexpr size_t roundUp(size_t size) {
+    return (size + Alignment - 1) & ~(Alignment - 1);
+  }
+
+  std::byte* const begin_;
+  std::byte* const end_;
+  std::byte* top_;
+  uint32_t live_{};
+  uint64_t heap_allocations_{};
+};
+
+/**
+ * A `FrameArena` over an inline buffer of `Capacity` bytes, so that embedding it in a per-stream
+ * object (such as an HTTP filter) makes frame allocation part of that object's allocation.
+ */
+template <size_t Capacity> class InlineFrameArena : public FrameArena {
+public:
+  InlineFrameArena() : FrameArena(storage_, Capacity) {}
+
+private:
+  alignas(FrameArena::Alignment) std::byte storage_[Capacity];
+};
+
+/**
+ * Standard allocator over a `FrameArena`, used to place shared state (e.g. with
+ * `std::allocate_shared`) in the arena.
+ */
+template <class T> class FrameArenaAllocator {
+public:
+  using value_type = T;
+
+  explicit FrameArenaAllocator(FrameArena& arena) : arena_(&arena) {}
+  template <class U>
+  FrameArenaAllocator(const FrameArenaAllocator<U>& other) : arena_(&other.arena()) {}
+
+  T* allocate(size_t n) {
+    static_assert(alignof(T) <= FrameArena::Alignment);
+    return static_cast<T*>(arena_->allocate(n * sizeof(T)));
+  }
+  void deallocate(T* ptr, size_t n) { arena_->deallocate(ptr, n * sizeof(T)); }
+
+  FrameArena& arena() const { return *arena_; }
+
+  template <class U> bool operator==(const FrameArenaAllocator<U>& other) const {
+    return arena_ == &other.arena();
+  }
+
+private:
+  FrameArena* arena_;
+};
+
+} // namespace Coroutine
+} // namespace Envoy
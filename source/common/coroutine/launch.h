@@ -7,6 +7,7 @@
 
 #include "source/common/coroutine/context.h"
 #include "source/common/coroutine/executor.h"
+#include "source/common/coroutine/frame_arena.h"
 #include "source/common/coroutine/task.h"
 
 #include "absl/functional/any_invocable.h"
@@ -123,16 +124,20 @@ RootTask awaitTaskAndCallOnDone(Task<T> task, OnDone on_done) {
   on_done(co_await std::move(task));
 }
 
+// Same as above, with the root frame allocated from `arena` (see PromiseBase::operator new).
+template <typename T, typename OnDone>
+RootTask awaitTaskAndCallOnDone(FrameArena&, Task<T> task, OnDone on_done) {
+  on_done(co_await std::move(task));
+}
+
 // Give the root its context and start it (lazily scheduled, or inline on the
 // caller's stack). The frame self-owns from here; the returned handle only carries
 // the cancellation state -- captured before the start, since an inline start may
 // run the coroutine to completion and self-destroy the frame before we return.
-inline DetachedHandle startRoot(RootTask root, std::shared_ptr<Executor> exec, StartMode mode) {
-  auto cancel = std::make_shared<CancellationState>();
-  // Keep a reference before `exec` is moved into the context.
-  Executor& executor = *exec;
-  root.promise().context_ = std::make_shared<CoroutineContext>(std::move(exec), cancel);
-  DetachedHandle handle(std::move(cancel));
+inline DetachedHandle startRoot(RootTask root, CoroutineContextPtr context, StartMode mode) {
+  Executor& executor = context->executor();
+  DetachedHandle handle(context->cancellation());
+  root.promise().context_ = std::move(context);
   if (mode == StartMode::Inline) {
     root.release().resume(); // Start on the caller's stack -- no post().
   } else {
@@ -141,6 +146,12 @@ inline DetachedHandle startRoot(RootTask root, std::shared_ptr<Executor> exec, S
   return handle;
 }
 
+inline DetachedHandle startRoot(RootTask root, std::shared_ptr<Executor> exec, StartMode mode) {
+  auto cancel = std::make_shared<CancellationState>();
+  return startRoot(std::move(root),
+                   std::make_shared<CoroutineContext>(std::move(exec), std::move(cancel)), mode);
+}
+
 } // namespace Detail
 
 /**
@@ -168,5 +179,23 @@ template <typename T>
                            std::move(exec), mode);
 }
 
+/**
+ * Same as above, with the root frame, the cancellation state and the context allocated
+ * from `arena` rather than the heap. Together with a `task` whose frames also come
+ * from `arena`, a launch performs no heap allocation as long as the arena has room.
+ * `arena` must outlive the coroutine and the returned handle.
+ */
+template <typename T>
+[[nodiscard]] DetachedHandle launch(FrameArena& arena, Task<T> task,
+                                    std::shared_ptr<Executor> exec,
+                                    std::type_identity_t<absl::AnyInvocable<void(T)>> on_done,
+                                    StartMode mode = StartMode::Scheduled) {
+  FrameArenaAllocator<CancellationState> allocator(arena);
+  auto cancel = std::allocate_shared<CancellationState>(allocator);
+  return Detail::startRoot(
+      Detail::awaitTaskAndCallOnDone(arena, std::move(task), std::move(on_done)),
+      std::allocate_shared<CoroutineContext>(allocator, std::move(exec), std::move(cancel)), mode);
+}
+
 } // namespace Coroutine
 } // namespace Envoy
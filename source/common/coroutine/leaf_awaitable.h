@@ -31,9 +31,9 @@ namespace Coroutine {
  * status to a normal `co_return`.
  *
  * Contract for derived types:
- *   - `onStart()` must arrange asynchronous completion. It must not call
- *     `complete()` synchronously within `onStart()` -- the frame is mid-suspend at
- *     that point and resuming it inline would be undefined.
+ *   - `onStart()` must arrange completion. It may call `complete()` synchronously
+ *     (e.g. a client that fails inline); the awaiting coroutine then continues
+ *     without suspending, instead of being resumed mid-suspend.
  *   - `onCancel()` must cancel the pending op and must not call `complete()`: the
  *     cancel path already delivers the aborted value, so a `complete()` here would
  *     resume the parent twice (a use-after-free). It is guarded by an ENVOY_BUG.
@@ -47,8 +47,9 @@ public:
   // Fail-fast: if the scope is already cancelled, don't even start.
   bool await_ready() { return context_->cancellation()->cancelled(); }
 
-  void await_suspend(std::coroutine_handle<> continuation) {
-    continuation_ = continuation;
+  // Returns false, resuming the awaiting coroutine right away, if onStart() completed
+  // synchronously.
+  bool await_suspend(std::coroutine_handle<> continuation) {
     // Register the cancel action while this is the pending leaf.
     context_->cancellation()->setCancelCallback([this] {
       cancelling_ = true;
@@ -56,6 +57,13 @@ public:
       finish(abortedValue());
     });
     onStart(); // derived kicks off the async op; must eventually call complete().
+    if (finished_) {
+      return false;
+    }
+    // Only set once the op is known to be pending, so that a synchronous complete()
+    // in onStart() stores the result without resuming the frame mid-suspend.
+    continuation_ = continuation;
+    return true;
   }
 
   // [[nodiscard]]: the result carries success/failure/cancellation, so a
@@ -2,12 +2,15 @@
 
 #include <concepts>
 #include <coroutine>
+#include <cstddef>
+#include <new>
 #include <optional>
 #include <type_traits>
 #include <utility>
 
 #include "source/common/common/assert.h"
 #include "source/common/coroutine/context.h"
+#include "source/common/coroutine/frame_arena.h"
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -134,11 +137,47 @@ struct PromiseBase {
     static_assert(dependent_false<A>, "co_await is only allowed on a Task or a LeafAwaitable");
   }
 
+  // Frame allocation. A coroutine whose first parameter (after the implicit object parameter of a
+  // member coroutine) is a `FrameArena&` gets its frame from that arena; any other coroutine gets
+  // it from the heap. Each frame is prefixed with the arena it came from (or null) so that the
+  // single sized `operator delete` can route it back.
+  static void* operator new(std::size_t size) { return allocateFrame(nullptr, size); }
+  template <class... Args>
+  static void* operator new(std::size_t size, FrameArena& arena, Args&...) {
+    return allocateFrame(&arena, size);
+  }
+  template <class Self, class... Args>
+  static void* operator new(std::size_t size, Self&, FrameArena& arena, Args&...) {
+    return allocateFrame(&arena, size);
+  }
+  static void operator delete(void* frame, std::size_t size) {
+    std::byte* block = static_cast<std::byte*>(frame) - FrameHeaderSize;
+    FrameArena* arena = *reinterpret_cast<FrameArena**>(block);
+    if (arena != nullptr) {
+      arena->deallocate(block, size + FrameHeaderSize);
+    } else {
+      ::operator delete(block, size + FrameHeaderSize);
+    }
+  }
+
   // Shared ownership keeps the context alive for detached frames.
   CoroutineContextPtr context_;
   // Where to resume to once the current coroutine `co_return`s. Generally pointing to a caller
   // that called `co_await` on the current coroutine (null for a root coroutine).
   std::coroutine_handle<> continuation_{};
+
+private:
+  // Keeps the frame that follows the header at the default new alignment.
+  static constexpr std::size_t FrameHeaderSize = FrameArena::Alignment;
+  static_assert(sizeof(FrameArena*) <= FrameHeaderSize);
+
+  static void* allocateFrame(FrameArena* arena, std::size_t size) {
+    std::byte* block =
+        static_cast<std::byte*>(arena != nullptr ? arena->allocate(size + FrameHeaderSize)
+                                                 : ::operator new(size + FrameHeaderSize));
+    *reinterpret_cast<FrameArena**>(block) = arena;
+    return block + FrameHeaderSize;
+  }
 };
 
 // Recover the shared `PromiseBase` from a type-erased coroutine handle. Valid
@@ -23,6 +23,7 @@
 #include "source/common/event/scaled_range_timer_manager_impl.h"
 #include "source/common/event/signal_impl.h"
 #include "source/common/event/timer_impl.h"
+#include "source/common/event/timer_wheel.h"
 #include "source/common/filesystem/watcher_impl.h"
 #include "source/common/network/address_impl.h"
 #include "source/common/network/connection_impl.h"
@@ -61,7 +62,13 @@ DispatcherImpl::DispatcherImpl(const std::string& name, Api::Api& api,
                      watermark_factory != nullptr
                          ? watermark_factory
                          : std::make_shared<Buffer::WatermarkBufferFactory>(
-                               api.bootstrap().overload_manager().buffer_factory_config())) {}
+                               api.bootstrap().overload_manager().buffer_factory_config())) {
+  if (api.bootstrap().has_timer_wheel()) {
+    const std::chrono::milliseconds tick(
+        PROTOBUF_GET_MS_OR_DEFAULT(api.bootstrap().timer_wheel(), tick, 1));
+    timer_wheel_ = std::make_unique<TimerWheel>(*scheduler_, time_source_, *this, tick);
+  }
+}
 
 DispatcherImpl::DispatcherImpl(const std::string& name, Thread::ThreadFactory& thread_factory,
                                TimeSource& time_source, Filesystem::Instance& file_system,
@@ -243,7 +250,8 @@ Event::SchedulableCallbackPtr DispatcherImpl::createSchedulableCallback(std::fun
 }
 
 TimerPtr DispatcherImpl::createTimerInternal(TimerCb cb) {
-  return scheduler_->createTimer(
+  Scheduler& scheduler = timer_wheel_ != nullptr ? *timer_wheel_ : *scheduler_;
+  return scheduler.createTimer(
       [this, cb]() {
         touchWatchdog();
         cb();
@@ -271,14 +279,9 @@ SignalEventPtr DispatcherImpl::listenForSignal(signal_t signal_num, SignalCb cb)
 }
 
 void DispatcherImpl::post(PostCb callback) {
-  bool do_post;
-  {
-    Thread::LockGuard lock(post_lock_);
-    do_post = post_callbacks_.empty();
-    post_callbacks_.push_back(std::move(callback));
-  }
-
-  if (do_post) {
+  // Only the post that finds the queue empty wakes up the dispatcher, which then runs the whole
+  // batch of callbacks posted until it gets to them.
+  if (post_callbacks_.push(std::move(callback))) {
     post_cb_->scheduleCallbackCurrentIteration();
   }
 }
@@ -318,11 +321,7 @@ void DispatcherImpl::shutdown() {
   // callbacks and dispatcher thread deletable objects.
   ASSERT(isThreadSafe());
   auto deferred_deletables_size = current_to_delete_->size();
-  std::list<std::function<void()>>::size_type post_callbacks_size;
-  {
-    Thread::LockGuard lock(post_lock_);
-    post_callbacks_size = post_callbacks_.size();
-  }
+  const uint64_t post_callbacks_size = post_callbacks_.size();
 
   std::list<DispatcherThreadDeletableConstPtr> local_deletables;
   {
@@ -368,18 +367,10 @@ void DispatcherImpl::runPostCallbacks() {
   // objects that is being deferred deleted.
   clearDeferredDeleteList();
 
-  std::list<PostCb> callbacks;
-  {
-    // Take ownership of the callbacks under the post_lock_. The lock must be released before
-    // callbacks execute. Callbacks added after this transfer will re-arm post_cb_ and will execute
-    // later in the event loop.
-    Thread::LockGuard lock(post_lock_);
-    callbacks = std::move(post_callbacks_);
-    // post_callbacks_ should be empty after the move.
-    ASSERT(post_callbacks_.empty());
-  }
-  // It is important that the execution and deletion of the callback happen while post_lock_ is not
-  // held. Either the invocation or destructor of the callback can call post() on this dispatcher.
+  // Take ownership of the callbacks posted so far. Callbacks added after this will re-arm post_cb_
+  // and will execute later in the event loop. Either the invocation or destructor of the callback
+  // can call post() on this dispatcher.
+  PostQueue::Batch callbacks = post_callbacks_.takeAll();
   while (!callbacks.empty()) {
     // Touch the watchdog before executing the callback to avoid spurious watchdog miss events when
     // executing a long list of callbacks.
@@ -388,7 +379,7 @@ void DispatcherImpl::runPostCallbacks() {
     callbacks.front()();
     // Pop the front so that the destructor of the callback that just executed runs before the next
     // callback executes.
-    callbacks.pop_front();
+    callbacks.popFront();
   }
 }
 
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "envoy/event/dispatcher.h"
+
+namespace Envoy {
+namespace Event {
+
+/**
+ * Lock-free queue of the callbacks posted to a dispatcher. Any thread can push callbacks, while
+ * only the dispatcher thread takes them, all at once, in the order they were pushed.
+ *
+ * The callbacks are kept in a list whose head is swapped atomically: producers push onto it, and
+ * the consumer takes the whole list and reverses it. As the consumer never removes single nodes,
+ * the list is not subject to the ABA problem.
+ */
+class PostQueue {
+  struct Node {
+    PostCb callback_;
+    Node* next_;
+  };
+
+public:
+  /**
+   * The callbacks taken from the queue, in the order they were pushed. The callbacks that are not
+   * popped are destroyed with the batch.
+   */
+  class Batch {
+  public:
+    Batch(Batch&& other) noexcept : front_(other.front_) { other.front_ = nullptr; }
+    Batch(const Batch&) = delete;
+    Batch& operator=(const Batch&) = delete;
+    ~Batch() {
+      while (!empty()) {
+        popFront();
+      }
+    }
+
+    bool empty() const { return front_ == nullptr; }
+    PostCb& front() { return front_->callback_; }
+
+    /**
+     * Destroys the front callback.
+     */
+    void popFront() {
+      Node* node = front_;
+      front_ = node->next_;
+      delete node;
+    }
+
+  private:
+    friend class PostQueue;
+    explicit Batch(Node* front) : front_(front) {}
+
+    Node* front_;
+  };
+
+  ~PostQueue() { takeAll(); }
+
+  /**
+   * Pushes a callback. This can be called from any thread.
+   * @return true if the queue was empty, in which case the caller must wake up the consumer.
+   */
+  bool push(PostCb callback) {
+    Node* expected = head_.load(std::memory_order_relaxed);
+    Node* node = new Node{std::move(callback), expected};
+    // The release ordering publishes the callback to the consumer that takes the node. Once
+    // published, the node may already be taken and deleted by the consumer, so it is only touched
+    // while the exchange fails.
+    while (!head_.compare_exchange_weak(expected, node, std::memory_order_release,
+                                        std::memory_order_relaxed)) {
+      node->next_ = expected;
+    }
+    return expected == nullptr;
+  }
+
+  /**
+   * Takes all the callbacks pushed so far. This must only be called from the consumer thread.
+   */
+  Batch takeAll() {
+    Node* node = head_.exchange(nullptr, std::memory_order_acquire);
+    // The list goes from the newest node to the oldest one, so this reverses it.
+    Node* front = nullptr;
+    while (node != nullptr) {
+      Node* next = node->next_;
+      node->next_ = front;
+      front = node;
+      node = next;
+    }
+    return Batch(front);
+  }
+
+  /**
+   * @return the number of callbacks in the queue, which may be outdated by the time it is
+   *         returned. This must only be called from the consumer thread, as it walks the nodes
+   *         that only the consumer deletes.
+   */
+  uint64_t size() const {
+    uint64_t size = 0;
+    for (const Node* node = head_.load(std::memory_order_acquire); node != nullptr;
+         node = node->next_) {
+      ++size;
+    }
+    return size;
+  }
+
+private:
+  std::atomic<Node*> head_{nullptr};
+};
+
+} // namespace Event
+} // namespace Envoy
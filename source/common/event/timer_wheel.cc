@@ -0,0 +1,250 @@
+#include "source/common/event/timer_wheel.h"
+
+#include <algorithm>
+#include <climits>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/scope_tracker.h"
+
+#include "absl/numeric/bits.h"
+
+namespace Envoy {
+namespace Event {
+
+class TimerWheel::WheelTimer : public Timer {
+public:
+  WheelTimer(TimerWheel& wheel, const TimerCb& cb, Dispatcher& dispatcher)
+      : wheel_(wheel), cb_(cb), dispatcher_(dispatcher) {
+    ASSERT(cb_);
+  }
+  ~WheelTimer() override { wheel_.remove(*this); }
+
+  // Timer
+  void disableTimer() override {
+    ASSERT(dispatcher_.isThreadSafe());
+    wheel_.remove(*this);
+    if (precise_timer_ != nullptr) {
+      precise_timer_->disableTimer();
+    }
+  }
+
+  void enableTimer(std::chrono::milliseconds d, const ScopeTrackedObject* object) override {
+    // A zero timeout asks to run on the next event loop iteration, not on the next tick.
+    if (d.count() <= 0) {
+      enablePreciseTimer(d, object);
+      return;
+    }
+    ASSERT(dispatcher_.isThreadSafe());
+    if (precise_timer_ != nullptr) {
+      precise_timer_->disableTimer();
+    }
+    object_ = object;
+    wheel_.add(*this, d);
+  }
+
+  void enableHRTimer(std::chrono::microseconds us, const ScopeTrackedObject* object) override {
+    enablePreciseTimer(us, object);
+  }
+
+  bool enabled() override {
+    ASSERT(dispatcher_.isThreadSafe());
+    return list_ != nullptr || (precise_timer_ != nullptr && precise_timer_->enabled());
+  }
+
+  void fire() {
+    if (object_ == nullptr) {
+      cb_();
+      return;
+    }
+    ScopeTrackerScopeState scope(object_, dispatcher_);
+    object_ = nullptr;
+    cb_();
+  }
+
+private:
+  friend class TimerWheel;
+
+  void enablePreciseTimer(std::chrono::microseconds us, const ScopeTrackedObject* object) {
+    ASSERT(dispatcher_.isThreadSafe());
+    wheel_.remove(*this);
+    if (precise_timer_ == nullptr) {
+      precise_timer_ = wheel_.scheduler_.createTimer(cb_, dispatcher_);
+    }
+    precise_timer_->enableHRTimer(us, object);
+  }
+
+  TimerWheel& wheel_;
+  const TimerCb cb_;
+  Dispatcher& dispatcher_;
+  // Created on the first zero or high resolution timeout.
+  TimerPtr precise_timer_;
+  const ScopeTrackedObject* object_{};
+  uint64_t expiry_tick_{};
+  // The list of the wheel that holds the timer, if it is enabled.
+  TimerList* list_{};
+  WheelTimer* prev_{};
+  WheelTimer* next_{};
+};
+
+TimerWheel::TimerWheel(Scheduler& scheduler, TimeSource& time_source, Dispatcher& dispatcher,
+                       std::chrono::milliseconds tick)
+    : scheduler_(scheduler), time_source_(time_source), tick_(tick),
+      start_(time_source.monotonicTime()),
+      tick_timer_(scheduler.createTimer([this]() { onTick(); }, dispatcher)) {
+  ASSERT(tick.count() > 0);
+}
+
+TimerPtr TimerWheel::createTimer(const TimerCb& cb, Dispatcher& dispatcher) {
+  return std::make_unique<WheelTimer>(*this, cb, dispatcher);
+}
+
+void TimerWheel::add(WheelTimer& timer, std::chrono::milliseconds d) {
+  // Clip the timeout like TimerUtils::durationToTimeval(), so that the ticks cannot overflow.
+  d = std::min<std::chrono::milliseconds>(d, std::chrono::seconds(INT32_MAX));
+  if (timer.list_ != nullptr) {
+    unlink(timer);
+  } else {
+    if (size_ == 0 && !processing_) {
+      // Nothing is pending, so skip the ticks that went by while the wheel was empty.
+      next_tick_ = std::max(next_tick_, elapsedTicks(false));
+    }
+    ++size_;
+  }
+  timer.expiry_tick_ = elapsedTicks(true) + (d + tick_ - std::chrono::nanoseconds(1)) / tick_;
+  insert(timer);
+  if (!processing_ && (!tick_armed_ || timer.expiry_tick_ < armed_tick_)) {
+    scheduleTick();
+  }
+}
+
+void TimerWheel::remove(WheelTimer& timer) {
+  if (timer.list_ != nullptr) {
+    unlink(timer);
+    --size_;
+  }
+}
+
+void TimerWheel::insert(WheelTimer& timer) {
+  if (timer.expiry_tick_ < next_tick_) {
+    link(slots_[0][next_tick_ & SlotMask], timer);
+    return;
+  }
+  // The timers beyond the range of the wheel are parked in its last slot, and moved again from
+  // there until they are in range.
+  const uint64_t delta =
+      std::min<uint64_t>(timer.expiry_tick_ - next_tick_, (uint64_t(1) << (SlotBits * Levels)) - 1);
+  const uint64_t slot_tick = next_tick_ + delta;
+  uint32_t level = 0;
+  while (delta >= (uint64_t(1) << (SlotBits * (level + 1)))) {
+    ++level;
+  }
+  link(slots_[level][(slot_tick >> (SlotBits * level)) & SlotMask], timer);
+}
+
+void TimerWheel::link(TimerList& list, WheelTimer& timer) {
+  timer.list_ = &list;
+  timer.prev_ = nullptr;
+  timer.next_ = list.head_;
+  if (list.head_ != nullptr) {
+    list.head_->prev_ = &timer;
+  }
+  list.head_ = &timer;
+  if (isFirstLevel(list)) {
+    const uint32_t index = &list - slots_[0].data();
+    first_level_occupancy_[index / 64] |= uint64_t(1) << (index % 64);
+  }
+}
+
+void TimerWheel::unlink(WheelTimer& timer) {
+  TimerList& list = *timer.list_;
+  if (timer.prev_ != nullptr) {
+    timer.prev_->next_ = timer.next_;
+  } else {
+    list.head_ = timer.next_;
+  }
+  if (timer.next_ != nullptr) {
+    timer.next_->prev_ = timer.prev_;
+  }
+  timer.list_ = nullptr;
+  if (list.head_ == nullptr && isFirstLevel(list)) {
+    const uint32_t index = &list - slots_[0].data();
+    first_level_occupancy_[index / 64] &= ~(uint64_t(1) << (index % 64));
+  }
+}
+
+uint32_t TimerWheel::cascade(uint32_t level, uint32_t index) {
+  TimerList& list = slots_[level][index];
+  while (list.head_ != nullptr) {
+    WheelTimer& timer = *list.head_;
+    unlink(timer);
+    insert(timer);
+  }
+  return index;
+}
+
+void TimerWheel::onTick() {
+  tick_armed_ = false;
+  processing_ = true;
+  const uint64_t now_tick = elapsedTicks(false);
+  while (next_tick_ <= now_tick && size_ > 0) {
+    const uint32_t index = next_tick_ & SlotMask;
+    // When the first level wraps around, move down the timers of the next slot of the upper
+    // levels, up to the first level that does not wrap around as well.
+    for (uint32_t level = 1;
+         index == 0 && level < Levels &&
+         cascade(level, (next_tick_ >> (SlotBits * level)) & SlotMask) == 0;
+         ++level) {
+    }
+    TimerList& slot = slots_[0][index];
+    while (slot.head_ != nullptr) {
+      WheelTimer& timer = *slot.head_;
+      unlink(timer);
+      link(expired_, timer);
+    }
+    ++next_tick_;
+    // The callbacks may disable, enable or destroy any of the timers that have yet to run.
+    while (expired_.head_ != nullptr) {
+      WheelTimer& timer = *expired_.head_;
+      unlink(timer);
+      --size_;
+      timer.fire();
+    }
+  }
+  processing_ = false;
+  scheduleTick();
+}
+
+void TimerWheel::scheduleTick() {
+  if (size_ == 0) {
+    return;
+  }
+  // Wake up for the next slot of the first level that holds timers, or for the wrap around of the
+  // first level, when the timers of the upper levels move down.
+  const uint32_t index = next_tick_ & SlotMask;
+  uint32_t next_slot = Slots;
+  for (uint32_t slot = index; slot < Slots; slot = (slot / 64 + 1) * 64) {
+    const uint64_t occupancy = first_level_occupancy_[slot / 64] >> (slot % 64);
+    if (occupancy != 0) {
+      next_slot = slot + absl::countr_zero(occupancy);
+      break;
+    }
+  }
+  const uint64_t target_tick = next_tick_ + (next_slot - index);
+  if (tick_armed_ && armed_tick_ <= target_tick) {
+    return;
+  }
+  const std::chrono::nanoseconds delay =
+      start_ + static_cast<int64_t>(target_tick) * tick_ - time_source_.monotonicTime();
+  tick_timer_->enableTimer(
+      std::max(std::chrono::ceil<std::chrono::milliseconds>(delay), std::chrono::milliseconds(0)));
+  tick_armed_ = true;
+  armed_tick_ = target_tick;
+}
+
+uint64_t TimerWheel::elapsedTicks(bool round_up) const {
+  const std::chrono::nanoseconds elapsed = time_source_.monotonicTime() - start_;
+  return (round_up ? elapsed + tick_ - std::chrono::nanoseconds(1) : elapsed) / tick_;
+}
+
+} // namespace Event
+} // namespace Envoy
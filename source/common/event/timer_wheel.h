@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "envoy/common/time.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+
+namespace Envoy {
+namespace Event {
+
+/**
+ * Hierarchical timer wheel implementation of Scheduler, for the coarse timers that are mostly
+ * disabled before they fire, like idle and stream timeouts. Enabling and disabling a timer is a
+ * constant time list operation instead of a libevent min-heap update.
+ *
+ * The wheel has 4 levels of 256 slots. The slots of the first level hold the timers that expire
+ * within the next 256 ticks, one tick per slot, and every other level covers 256 times the range of
+ * the previous one. When the first level wraps around, the timers of the next slot of the upper
+ * levels are moved down. A single timer of the underlying scheduler wakes up the wheel, only when
+ * there are timers in the next slots to run or to move.
+ *
+ * Timers fire at the first tick boundary after they expire, so they may run up to one tick late
+ * but never early. Timers enabled with a zero or high resolution timeout are handed to a timer of
+ * the underlying scheduler.
+ */
+class TimerWheel : public Scheduler {
+public:
+  TimerWheel(Scheduler& scheduler, TimeSource& time_source, Dispatcher& dispatcher,
+             std::chrono::milliseconds tick);
+
+  // Scheduler
+  TimerPtr createTimer(const TimerCb& cb, Dispatcher& dispatcher) override;
+
+  /**
+   * @return the number of timers in the wheel.
+   */
+  uint64_t size() const { return size_; }
+
+private:
+  class WheelTimer;
+
+  struct TimerList {
+    WheelTimer* head_{};
+  };
+
+  static constexpr uint32_t SlotBits = 8;
+  static constexpr uint32_t Slots = 1 << SlotBits;
+  static constexpr uint32_t SlotMask = Slots - 1;
+  static constexpr uint32_t Levels = 4;
+
+  void add(WheelTimer& timer, std::chrono::milliseconds d);
+  void remove(WheelTimer& timer);
+  void insert(WheelTimer& timer);
+  void link(TimerList& list, WheelTimer& timer);
+  void unlink(WheelTimer& timer);
+  uint32_t cascade(uint32_t level, uint32_t index);
+  void onTick();
+  void scheduleTick();
+  uint64_t elapsedTicks(bool round_up) const;
+  bool isFirstLevel(const TimerList& list) const {
+    return &list >= slots_[0].data() && &list < slots_[0].data() + Slots;
+  }
+
+  Scheduler& scheduler_;
+  TimeSource& time_source_;
+  const std::chrono::nanoseconds tick_;
+  const MonotonicTime start_;
+  // The next tick to process. The timers that expire before it are due.
+  uint64_t next_tick_{};
+  uint64_t size_{};
+  std::array<std::array<TimerList, Slots>, Levels> slots_{};
+  // Which slots of the first level hold timers, to skip the empty ones when scheduling the tick.
+  std::array<uint64_t, Slots / 64> first_level_occupancy_{};
+  // The due timers that have yet to run.
+  TimerList expired_;
+  TimerPtr tick_timer_;
+  uint64_t armed_tick_{};
+  bool tick_armed_{};
+  bool processing_{};
+};
+
+using TimerWheelPtr = std::unique_ptr<TimerWheel>;
+
+} // namespace Event
+} // namespace Envoy
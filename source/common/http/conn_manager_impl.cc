@@ -32,6 +32,7 @@
 #include "source/common/common/empty_string.h"
 #include "source/common/common/enum_to_int.h"
 #include "source/common/common/fmt.h"
+#include "source/common/common/macros.h"
 #include "source/common/common/perf_tracing.h"
 #include "source/common/common/scope_tracker.h"
 #include "source/common/common/utility.h"
@@ -70,6 +71,8 @@ const absl::string_view ConnectionManagerImpl::MaxRequestsPerIoCycle =
 // Don't attempt to intelligently delay close: https://github.com/envoyproxy/envoy/issues/30010
 const absl::string_view ConnectionManagerImpl::OptionallyDelayClose =
     "http1.optionally_delay_close";
+// Runtime fractional percent of streams for which the time spent in each HTTP filter is recorded.
+const absl::string_view ConnectionManagerImpl::FilterCostSampling = "http.filter_cost_sampling";
 
 bool requestWasConnect(const RequestHeaderMapSharedPtr& headers, Protocol protocol) {
   if (!headers) {
@@ -890,6 +893,11 @@ std::optional<uint64_t> ConnectionManagerImpl::HttpStreamIdProviderImpl::toInteg
 
 namespace {
 constexpr absl::string_view kRouteFactoryName = "envoy.route_config_update_requester.default";
+
+// Filter cost tracking is off unless sampled in through the runtime.
+const envoy::type::v3::FractionalPercent& defaultFilterCostSampling() {
+  CONSTRUCT_ON_FIRST_USE(envoy::type::v3::FractionalPercent);
+}
 } // namespace
 
 ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connection_manager,
@@ -932,6 +940,11 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
   filter_manager_.streamInfo().setShouldSchemeMatchUpstream(
       connection_manager.config_->shouldSchemeMatchUpstream());
 
+  if (connection_manager_.runtime_.snapshot().featureEnabled(
+          ConnectionManagerImpl::FilterCostSampling, defaultFilterCostSampling())) {
+    filter_manager_.enableFilterCostTracking();
+  }
+
   // Record the downstream connection begin time point for COMMON_DURATION access logging.
   filter_manager_.streamInfo().downstreamTiming().setDownstreamConnectionBegin(
       connection_manager_.read_callbacks_->connection().streamInfo().startTimeMonotonic());
@@ -1032,6 +1045,12 @@ void ConnectionManagerImpl::ActiveStream::log(AccessLog::AccessLogType type) {
 void ConnectionManagerImpl::ActiveStream::completeRequest() {
   filter_manager_.streamInfo().onRequestComplete();
 
+  if (const FilterCostTracker* filter_cost_tracker = filter_manager_.filterCostTracker();
+      filter_cost_tracker != nullptr) {
+    filter_cost_tracker->recordStats(connection_manager_.stats_.scope_,
+                                     connection_manager_.stats_.prefixStatName());
+  }
+
   connection_manager_.stats_.named_.downstream_rq_active_.dec();
   if (filter_manager_.streamInfo().healthCheck()) {
     connection_manager_.config_->tracingStats().health_check_.inc();
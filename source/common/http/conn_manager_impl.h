@@ -133,6 +133,7 @@ public:
   static const absl::string_view PrematureResetMinStreamLifetimeSecondsKey;
   static const absl::string_view MaxRequestsPerIoCycle;
   static const absl::string_view OptionallyDelayClose;
+  static const absl::string_view FilterCostSampling;
 
 private:
   struct ActiveStream;
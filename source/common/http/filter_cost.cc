@@ -0,0 +1,113 @@
+#include "source/common/http/filter_cost.h"
+
+#include <time.h>
+
+#include "source/common/common/assert.h"
+#include "source/common/stats/symbol_table.h"
+#include "source/common/stats/utility.h"
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+constexpr absl::string_view WallTimeUsSuffix = ".wall_time_us";
+constexpr absl::string_view CpuTimeUsSuffix = ".cpu_time_us";
+
+int64_t toMicroseconds(std::chrono::nanoseconds duration) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+} // namespace
+
+std::chrono::nanoseconds FilterCostTracker::threadCpuTime() {
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+    return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+  }
+#endif
+  return std::chrono::nanoseconds(0);
+}
+
+void FilterCostTracker::onFilterStart(absl::string_view filter_name) {
+  const MonotonicTime wall_now = time_source_.monotonicTime();
+  const std::chrono::nanoseconds cpu_now = threadCpuTime();
+  // Pause the enclosing callback, so it is only charged for its own work.
+  if (!active_calls_.empty()) {
+    charge(active_calls_.back(), wall_now, cpu_now);
+  }
+
+  size_t index = 0;
+  while (index < filter_costs_.size() && filter_costs_[index].filter_name_ != filter_name) {
+    ++index;
+  }
+  if (index == filter_costs_.size()) {
+    filter_costs_.push_back({std::string(filter_name), {}, {}});
+  }
+  active_calls_.push_back({index, wall_now, cpu_now});
+}
+
+void FilterCostTracker::onFilterEnd() {
+  ASSERT(!active_calls_.empty());
+  const MonotonicTime wall_now = time_source_.monotonicTime();
+  const std::chrono::nanoseconds cpu_now = threadCpuTime();
+  charge(active_calls_.back(), wall_now, cpu_now);
+  active_calls_.pop_back();
+  // Resume the enclosing callback.
+  if (!active_calls_.empty()) {
+    active_calls_.back().wall_start_ = wall_now;
+    active_calls_.back().cpu_start_ = cpu_now;
+  }
+}
+
+void FilterCostTracker::charge(const ActiveCall& call, MonotonicTime wall_now,
+                               std::chrono::nanoseconds cpu_now) {
+  FilterCost& cost = filter_costs_[call.index_];
+  cost.wall_time_ += wall_now - call.wall_start_;
+  cost.cpu_time_ += cpu_now - call.cpu_start_;
+}
+
+void FilterCostTracker::recordStats(Stats::Scope& scope, Stats::StatName prefix) const {
+  for (const FilterCost& cost : filter_costs_) {
+    const Stats::DynamicName filter_name(cost.filter_name_);
+    Stats::Utility::histogramFromElements(
+        scope, {prefix, Stats::DynamicName("filter_cost"), filter_name,
+                Stats::DynamicName("wall_time_us")},
+        Stats::Histogram::Unit::Microseconds)
+        .recordValue(toMicroseconds(cost.wall_time_));
+    Stats::Utility::histogramFromElements(
+        scope, {prefix, Stats::DynamicName("filter_cost"), filter_name,
+                Stats::DynamicName("cpu_time_us")},
+        Stats::Histogram::Unit::Microseconds)
+        .recordValue(toMicroseconds(cost.cpu_time_));
+  }
+}
+
+std::optional<std::string> FilterCostTracker::serializeAsString() const {
+  return absl::StrJoin(filter_costs_, ",", [](std::string* out, const FilterCost& cost) {
+    absl::StrAppend(out, cost.filter_name_, ":", toMicroseconds(cost.wall_time_), ":",
+                    toMicroseconds(cost.cpu_time_));
+  });
+}
+
+StreamInfo::FilterState::Object::FieldType
+FilterCostTracker::getField(absl::string_view field_name) const {
+  absl::string_view filter_name = field_name;
+  const bool wall_time = absl::ConsumeSuffix(&filter_name, WallTimeUsSuffix);
+  if (!wall_time && !absl::ConsumeSuffix(&filter_name, CpuTimeUsSuffix)) {
+    return absl::monostate{};
+  }
+  for (const FilterCost& cost : filter_costs_) {
+    if (cost.filter_name_ == filter_name) {
+      return toMicroseconds(wall_time ? cost.wall_time_ : cost.cpu_time_);
+    }
+  }
+  return absl::monostate{};
+}
+
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stream_info/filter_state.h"
+
+#include "source/common/common/macros.h"
+
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Http {
+
+/**
+ * Attributes the time a sampled stream spends in each HTTP filter's header and data callbacks to
+ * the filter. Wall time is taken from the dispatcher's monotonic clock and CPU time from the
+ * thread CPU clock. A callback that re-enters the filter chain, e.g. by continuing iteration or
+ * sending a local reply, is not charged for the time spent in the filters it calls into.
+ *
+ * The tracker is stored in the stream's filter state under key() so that access logs can use
+ * %FILTER_STATE(envoy.http.filter_cost:FIELD:<filter name>.wall_time_us)% and
+ * %FILTER_STATE(envoy.http.filter_cost:FIELD:<filter name>.cpu_time_us)%.
+ */
+class FilterCostTracker : public StreamInfo::FilterState::Object {
+public:
+  struct FilterCost {
+    std::string filter_name_;
+    std::chrono::nanoseconds wall_time_{};
+    std::chrono::nanoseconds cpu_time_{};
+  };
+
+  explicit FilterCostTracker(TimeSource& time_source) : time_source_(time_source) {}
+
+  static const std::string& key() {
+    CONSTRUCT_ON_FIRST_USE(std::string, "envoy.http.filter_cost");
+  }
+
+  /**
+   * Called before a filter callback is invoked.
+   * @param filter_name the config name of the filter.
+   */
+  void onFilterStart(absl::string_view filter_name);
+
+  /**
+   * Called after the filter callback matching the last onFilterStart() returns.
+   */
+  void onFilterEnd();
+
+  /**
+   * @return the accumulated costs, one entry per filter name in the order first called.
+   */
+  const std::vector<FilterCost>& filterCosts() const { return filter_costs_; }
+
+  /**
+   * Records the accumulated cost of each filter to the <prefix>filter_cost.<filter name>.*
+   * histograms.
+   */
+  void recordStats(Stats::Scope& scope, Stats::StatName prefix) const;
+
+  // StreamInfo::FilterState::Object
+  std::optional<std::string> serializeAsString() const override;
+  bool hasFieldSupport() const override { return true; }
+  FieldType getField(absl::string_view field_name) const override;
+
+private:
+  struct ActiveCall {
+    size_t index_;
+    MonotonicTime wall_start_;
+    std::chrono::nanoseconds cpu_start_;
+  };
+
+  static std::chrono::nanoseconds threadCpuTime();
+  void charge(const ActiveCall& call, MonotonicTime wall_now, std::chrono::nanoseconds cpu_now);
+
+  TimeSource& time_source_;
+  std::vector<FilterCost> filter_costs_;
+  // Callbacks in progress, innermost last. Filter chains are re-entered only a few levels deep.
+  absl::InlinedVector<ActiveCall, 4> active_calls_;
+};
+
+} // namespace Http
+} // namespace Envoy
@@ -612,7 +612,9 @@ void FilterManager::decodeHeaders(ActiveStreamDecoderFilter* filter, RequestHead
     if ((*entry)->end_stream_) {
       state_.filter_call_state_ |= FilterCallState::EndOfStream;
     }
+    onFilterCallbackStart(**entry);
     FilterHeadersStatus status = (*entry)->decodeHeaders(headers, (*entry)->end_stream_);
+    onFilterCallbackEnd();
     state_.filter_call_state_ &= ~FilterCallState::DecodeHeaders;
     if ((*entry)->end_stream_) {
       state_.filter_call_state_ &= ~FilterCallState::EndOfStream;
@@ -767,7 +769,9 @@ void FilterManager::decodeData(ActiveStreamDecoderFilter* filter, Buffer::Instan
 
     state_.filter_call_state_ |= FilterCallState::DecodeData;
     (*entry)->end_stream_ = end_stream && !filter_manager_callbacks_.requestTrailers();
+    onFilterCallbackStart(**entry);
     FilterDataStatus status = (*entry)->handle_->decodeData(data, (*entry)->end_stream_);
+    onFilterCallbackEnd();
     if ((*entry)->end_stream_) {
       (*entry)->handle_->decodeComplete();
     }
@@ -1332,7 +1336,9 @@ void FilterManager::encodeHeaders(ActiveStreamEncoderFilter* filter, ResponseHea
     if ((*entry)->end_stream_) {
       state_.filter_call_state_ |= FilterCallState::EndOfStream;
     }
+    onFilterCallbackStart(**entry);
     FilterHeadersStatus status = (*entry)->handle_->encodeHeaders(headers, (*entry)->end_stream_);
+    onFilterCallbackEnd();
     if (state_.encoder_filter_chain_aborted_) {
       ENVOY_STREAM_LOG(trace,
                        "encodeHeaders filter iteration aborted due to local reply: filter={}",
@@ -1555,7 +1561,9 @@ void FilterManager::encodeData(ActiveStreamEncoderFilter* filter, Buffer::Instan
     recordLatestDataFilter(entry, state_.latest_data_encoding_filter_, encoder_filters_);
 
     (*entry)->end_stream_ = end_stream && !filter_manager_callbacks_.responseTrailers();
+    onFilterCallbackStart(**entry);
     FilterDataStatus status = (*entry)->handle_->encodeData(data, (*entry)->end_stream_);
+    onFilterCallbackEnd();
     if (state_.encoder_filter_chain_aborted_) {
       ENVOY_STREAM_LOG(trace, "encodeData filter iteration aborted due to local reply: filter={}",
                        *this, (*entry)->filter_context_.config_name);
@@ -1769,6 +1777,13 @@ void FilterManager::contextOnContinue(ScopeTrackedObjectStack& tracked_object_st
   tracked_object_stack.add(filter_manager_callbacks_.scope());
 }
 
+void FilterManager::enableFilterCostTracking() {
+  ASSERT(filter_cost_tracker_ == nullptr);
+  filter_cost_tracker_ = std::make_shared<FilterCostTracker>(dispatcher_.timeSource());
+  streamInfo().filterState()->setData(FilterCostTracker::key(), filter_cost_tracker_,
+                                      StreamInfo::FilterState::LifeSpan::FilterChain);
+}
+
 FilterManager::UpgradeResult
 FilterManager::createUpgradeFilterChain(const FilterChainFactory& filter_chain_factory,
                                         FilterChainFactoryCallbacksImpl& callbacks) {
@@ -18,6 +18,7 @@
 #include "source/common/common/linked_object.h"
 #include "source/common/common/logger.h"
 #include "source/common/grpc/common.h"
+#include "source/common/http/filter_cost.h"
 #include "source/common/http/header_utility.h"
 #include "source/common/http/headers.h"
 #include "source/common/http/matching/data_impl.h"
@@ -938,6 +939,17 @@ public:
 
   void contextOnContinue(ScopeTrackedObjectStack& tracked_object_stack);
 
+  /**
+   * Starts attributing the time spent in each filter's header and data callbacks to the filter.
+   * The costs are kept in a FilterCostTracker stored in the stream's filter state.
+   */
+  void enableFilterCostTracking();
+
+  /**
+   * @return the filter cost tracker, or nullptr if filter cost tracking is not enabled.
+   */
+  const FilterCostTracker* filterCostTracker() const { return filter_cost_tracker_.get(); }
+
   void onDownstreamReset() { state_.saw_downstream_reset_ = true; }
   bool sawDownstreamReset() { return state_.saw_downstream_reset_; }
 
@@ -1145,6 +1157,17 @@ private:
 
   bool isTerminalDecoderFilter(const ActiveStreamDecoderFilter& filter) const;
 
+  void onFilterCallbackStart(const ActiveStreamFilterBase& filter) {
+    if (ABSL_PREDICT_FALSE(filter_cost_tracker_ != nullptr)) {
+      filter_cost_tracker_->onFilterStart(filter.filter_context_.config_name);
+    }
+  }
+  void onFilterCallbackEnd() {
+    if (ABSL_PREDICT_FALSE(filter_cost_tracker_ != nullptr)) {
+      filter_cost_tracker_->onFilterEnd();
+    }
+  }
+
   FilterManagerCallbacks& filter_manager_callbacks_;
   Event::Dispatcher& dispatcher_;
   // This is unset if there is no downstream connection, e.g. for health check or
@@ -1175,6 +1198,8 @@ private:
   Network::Socket::OptionsSharedPtr upstream_options_ =
       std::make_shared<Network::Socket::Options>();
   Upstream::LoadBalancerContext::OverrideHost upstream_override_host_;
+  // Only set for streams sampled for filter cost tracking.
+  std::shared_ptr<FilterCostTracker> filter_cost_tracker_;
 
   // TODO(snowp): Once FM has been moved to its own file we'll make these private classes of FM,
   // at which point they no longer need to be friends.
@@ -1,7 +1,6 @@
 #include "source/common/http/http1/balsa_parser.h"
 
 #include <algorithm>
-#include <array>
 #include <cctype>
 #include <cstddef>
 #include <cstdint>
@@ -27,42 +26,12 @@ constexpr absl::string_view kColonSlashSlash = "://";
 constexpr char kResponseFirstByte = 'H';
 constexpr absl::string_view kHttpVersionPrefix = "HTTP/";
 
-// RFC 9110 Sections 5.1 and 9.1 define field names and methods as tokens:
-// https://www.rfc-editor.org/rfc/rfc9110.html
-constexpr char kValidCharacters[] =
-    "!#$%&'*+-.0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ^_`abcdefghijklmnopqrstuvwxyz|~";
-
-consteval std::array<uint64_t, 4> makeValidCharacterMask() {
-  std::array<uint64_t, 4> mask{};
-  for (size_t i = 0; i < sizeof(kValidCharacters) - 1; ++i) {
-    const uint8_t index = static_cast<uint8_t>(kValidCharacters[i]);
-    mask[index / 64] |= 1ULL << (index % 64);
-  }
-  return mask;
-}
-
-// This keeps the per-character hot path branch-light and avoids a binary search through the valid
-// character list for every byte in every HTTP/1 header name.
-constexpr std::array<uint64_t, 4> kValidCharacterMask = makeValidCharacterMask();
-
-constexpr bool isValidTokenCharacter(char c) {
-  const uint8_t index = static_cast<uint8_t>(c);
-  return (kValidCharacterMask[index / 64] & (1ULL << (index % 64))) != 0;
-}
-
-static_assert(isValidTokenCharacter('a'));
-static_assert(isValidTokenCharacter('Z'));
-static_assert(isValidTokenCharacter('-'));
-static_assert(!isValidTokenCharacter(':'));
-static_assert(!isValidTokenCharacter(' '));
-
 // TODO(#21245): Skip method validation altogether when UHV method validation is
 // enabled.
-bool isMethodValid(absl::string_view method, bool allow_custom_methods) {
+bool isMethodValid(absl::string_view method, bool allow_custom_methods,
+                   const HeaderScanner& scanner) {
   if (allow_custom_methods) {
-    return !method.empty() &&
-           std::all_of(method.begin(), method.end(),
-                       [](absl::string_view::value_type c) { return isValidTokenCharacter(c); });
+    return !method.empty() && scanner.isValidToken(method);
   }
 
   static constexpr absl::string_view kValidMethods[] = {
@@ -152,16 +121,15 @@ bool isVersionValid(absl::string_view version_input) {
          version_input[1] == '.' && absl::ascii_isdigit(version_input[2]);
 }
 
-bool isHeaderNameValid(absl::string_view name) {
-  return std::all_of(name.begin(), name.end(),
-                     [](absl::string_view::value_type c) { return isValidTokenCharacter(c); });
-}
-
 } // anonymous namespace
 
 BalsaParser::BalsaParser(MessageType type, ParserCallbacks* connection, size_t max_header_length,
                          bool enable_trailers, bool allow_custom_methods)
-    : message_type_(type), connection_(connection), enable_trailers_(enable_trailers),
+    : header_scanner_(
+          Runtime::runtimeFeatureEnabled("envoy.reloadable_features.http1_vectorized_header_scan")
+              ? HeaderScanner::vectorized()
+              : HeaderScanner::scalar()),
+      message_type_(type), connection_(connection), enable_trailers_(enable_trailers),
       allow_custom_methods_(allow_custom_methods) {
   ASSERT(connection_ != nullptr);
 
@@ -306,7 +274,7 @@ void BalsaParser::OnRequestFirstLineInput(absl::string_view /*line_input*/,
   if (status_ == ParserStatus::Error) {
     return;
   }
-  if (!isMethodValid(method_input, allow_custom_methods_)) {
+  if (!isMethodValid(method_input, allow_custom_methods_, header_scanner_)) {
     status_ = ParserStatus::Error;
     error_message_ = "HPE_INVALID_METHOD";
     return;
@@ -420,7 +388,7 @@ void BalsaParser::validateAndProcessHeadersOrTrailersImpl(const quiche::BalsaHea
       return;
     }
 
-    if (!isHeaderNameValid(key)) {
+    if (!header_scanner_.isValidToken(key)) {
       status_ = ParserStatus::Error;
       error_message_ = "HPE_INVALID_HEADER_TOKEN";
       return;
@@ -436,12 +404,11 @@ void BalsaParser::validateAndProcessHeadersOrTrailersImpl(const quiche::BalsaHea
     }
 
     // Remove CR and LF characters to match http-parser behavior.
-    auto is_cr_or_lf = [](char c) { return c == '\r' || c == '\n'; };
-    if (std::any_of(value.begin(), value.end(), is_cr_or_lf)) {
+    if (header_scanner_.containsCrOrLf(value)) {
       std::string value_without_cr_or_lf;
       value_without_cr_or_lf.reserve(value.size());
       for (char c : value) {
-        if (!is_cr_or_lf(c)) {
+        if (c != '\r' && c != '\n') {
           value_without_cr_or_lf.push_back(c);
         }
       }
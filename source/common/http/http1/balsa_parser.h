@@ -2,6 +2,7 @@
 
 #include <memory>
 
+#include "source/common/http/http1/header_scanner.h"
 #include "source/common/http/http1/parser.h"
 #include "source/common/runtime/runtime_features.h"
 
@@ -70,6 +71,9 @@ private:
 
   quiche::BalsaFrame framer_;
   quiche::BalsaHeaders headers_;
+  // Validates header names and detects CR/LF in header values. Vectorized when
+  // envoy.reloadable_features.http1_vectorized_header_scan is enabled.
+  const HeaderScanner& header_scanner_;
 
   const MessageType message_type_ = MessageType::Request;
   ParserCallbacks* connection_ = nullptr;
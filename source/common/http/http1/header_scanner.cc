@@ -0,0 +1,244 @@
+#include "source/common/http/http1/header_scanner.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "source/common/common/macros.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ENVOY_HTTP1_HEADER_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+// RFC 9110 Sections 5.1 and 9.1 define field names and methods as tokens:
+// https://www.rfc-editor.org/rfc/rfc9110.html
+constexpr char kValidCharacters[] =
+    "!#$%&'*+-.0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ^_`abcdefghijklmnopqrstuvwxyz|~";
+
+consteval std::array<uint64_t, 4> makeValidCharacterMask() {
+  std::array<uint64_t, 4> mask{};
+  for (size_t i = 0; i < sizeof(kValidCharacters) - 1; ++i) {
+    const uint8_t index = static_cast<uint8_t>(kValidCharacters[i]);
+    mask[index / 64] |= 1ULL << (index % 64);
+  }
+  return mask;
+}
+
+// This keeps the per-character hot path branch-light and avoids a binary search through the valid
+// character list for every byte in every HTTP/1 header name.
+constexpr std::array<uint64_t, 4> kValidCharacterMask = makeValidCharacterMask();
+
+constexpr bool isValidTokenCharacter(char c) {
+  const uint8_t index = static_cast<uint8_t>(c);
+  return (kValidCharacterMask[index / 64] & (1ULL << (index % 64))) != 0;
+}
+
+static_assert(isValidTokenCharacter('a'));
+static_assert(isValidTokenCharacter('Z'));
+static_assert(isValidTokenCharacter('-'));
+static_assert(!isValidTokenCharacter(':'));
+static_assert(!isValidTokenCharacter(' '));
+
+bool isValidTokenScalar(const char* data, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    if (!isValidTokenCharacter(data[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool containsCrOrLfScalar(const char* data, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    if (data[i] == '\r' || data[i] == '\n') {
+      return true;
+    }
+  }
+  return false;
+}
+
+class ScalarHeaderScanner : public HeaderScanner {
+public:
+  bool isValidToken(absl::string_view input) const override {
+    return isValidTokenScalar(input.data(), input.size());
+  }
+  bool containsCrOrLf(absl::string_view input) const override {
+    return containsCrOrLfScalar(input.data(), input.size());
+  }
+  absl::string_view name() const override { return "scalar"; }
+};
+
+#ifdef ENVOY_HTTP1_HEADER_SCANNER_X86
+
+// Token characters are classified with the nibble lookup technique: every token character has a
+// high nibble between 2 and 7, and each of those high nibbles is given one bit. The low nibble
+// table holds, for each low nibble, the bits of the high nibbles that form a token character with
+// it. A byte is a token character iff the two lookups share a bit. Bytes with a high nibble outside
+// 2..7, including all bytes >= 0x80, look up 0 in the high nibble table and are rejected.
+consteval std::array<uint8_t, 16> makeLowNibbleTable() {
+  std::array<uint8_t, 16> table{};
+  for (int high = 2; high <= 7; ++high) {
+    for (int low = 0; low < 16; ++low) {
+      if (isValidTokenCharacter(static_cast<char>((high << 4) | low))) {
+        table[low] |= 1 << (high - 2);
+      }
+    }
+  }
+  return table;
+}
+
+consteval std::array<uint8_t, 16> makeHighNibbleTable() {
+  std::array<uint8_t, 16> table{};
+  for (int high = 2; high <= 7; ++high) {
+    table[high] = 1 << (high - 2);
+  }
+  return table;
+}
+
+alignas(16) constexpr std::array<uint8_t, 16> kLowNibbleTable = makeLowNibbleTable();
+alignas(16) constexpr std::array<uint8_t, 16> kHighNibbleTable = makeHighNibbleTable();
+
+__attribute__((target("sse4.2"))) bool isValidTokenSse42(const char* data, size_t size) {
+  const __m128i low_table =
+      _mm_load_si128(reinterpret_cast<const __m128i*>(kLowNibbleTable.data()));
+  const __m128i high_table =
+      _mm_load_si128(reinterpret_cast<const __m128i*>(kHighNibbleTable.data()));
+  const __m128i nibble_mask = _mm_set1_epi8(0x0f);
+  const __m128i zero = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    const __m128i low = _mm_shuffle_epi8(low_table, _mm_and_si128(input, nibble_mask));
+    const __m128i high =
+        _mm_shuffle_epi8(high_table, _mm_and_si128(_mm_srli_epi16(input, 4), nibble_mask));
+    const __m128i invalid = _mm_cmpeq_epi8(_mm_and_si128(low, high), zero);
+    if (_mm_movemask_epi8(invalid) != 0) {
+      return false;
+    }
+  }
+  return isValidTokenScalar(data + i, size - i);
+}
+
+__attribute__((target("sse4.2"))) bool containsCrOrLfSse42(const char* data, size_t size) {
+  const __m128i cr = _mm_set1_epi8('\r');
+  const __m128i lf = _mm_set1_epi8('\n');
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    const __m128i match = _mm_or_si128(_mm_cmpeq_epi8(input, cr), _mm_cmpeq_epi8(input, lf));
+    if (_mm_movemask_epi8(match) != 0) {
+      return true;
+    }
+  }
+  return containsCrOrLfScalar(data + i, size - i);
+}
+
+__attribute__((target("avx2"))) bool isValidTokenAvx2(const char* data, size_t size) {
+  // vpshufb looks up within each 128 bit lane, so the tables are replicated into both lanes.
+  const __m256i low_table = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(kLowNibbleTable.data())));
+  const __m256i high_table = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(kHighNibbleTable.data())));
+  const __m256i nibble_mask = _mm256_set1_epi8(0x0f);
+  const __m256i zero = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    const __m256i low = _mm256_shuffle_epi8(low_table, _mm256_and_si256(input, nibble_mask));
+    const __m256i high = _mm256_shuffle_epi8(
+        high_table, _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble_mask));
+    const __m256i invalid = _mm256_cmpeq_epi8(_mm256_and_si256(low, high), zero);
+    if (_mm256_movemask_epi8(invalid) != 0) {
+      return false;
+    }
+  }
+  return isValidTokenSse42(data + i, size - i);
+}
+
+__attribute__((target("avx2"))) bool containsCrOrLfAvx2(const char* data, size_t size) {
+  const __m256i cr = _mm256_set1_epi8('\r');
+  const __m256i lf = _mm256_set1_epi8('\n');
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    const __m256i match =
+        _mm256_or_si256(_mm256_cmpeq_epi8(input, cr), _mm256_cmpeq_epi8(input, lf));
+    if (_mm256_movemask_epi8(match) != 0) {
+      return true;
+    }
+  }
+  return containsCrOrLfSse42(data + i, size - i);
+}
+
+class Sse42HeaderScanner : public HeaderScanner {
+public:
+  bool isValidToken(absl::string_view input) const override {
+    return isValidTokenSse42(input.data(), input.size());
+  }
+  bool containsCrOrLf(absl::string_view input) const override {
+    return containsCrOrLfSse42(input.data(), input.size());
+  }
+  absl::string_view name() const override { return "sse4.2"; }
+};
+
+class Avx2HeaderScanner : public HeaderScanner {
+public:
+  bool isValidToken(absl::string_view input) const override {
+    return isValidTokenAvx2(input.data(), input.size());
+  }
+  bool containsCrOrLf(absl::string_view input) const override {
+    return containsCrOrLfAvx2(input.data(), input.size());
+  }
+  absl::string_view name() const override { return "avx2"; }
+};
+
+#endif
+
+} // namespace
+
+const HeaderScanner& HeaderScanner::scalar() { CONSTRUCT_ON_FIRST_USE(ScalarHeaderScanner); }
+
+const HeaderScanner* HeaderScanner::sse42() {
+#ifdef ENVOY_HTTP1_HEADER_SCANNER_X86
+  static const HeaderScanner* scanner =
+      __builtin_cpu_supports("sse4.2") ? new Sse42HeaderScanner() : nullptr;
+  return scanner;
+#else
+  return nullptr;
+#endif
+}
+
+const HeaderScanner* HeaderScanner::avx2() {
+#ifdef ENVOY_HTTP1_HEADER_SCANNER_X86
+  // The AVX2 implementation finishes short tails with the SSE4.2 one.
+  static const HeaderScanner* scanner =
+      __builtin_cpu_supports("avx2") && __builtin_cpu_supports("sse4.2") ? new Avx2HeaderScanner()
+                                                                         : nullptr;
+  return scanner;
+#else
+  return nullptr;
+#endif
+}
+
+const HeaderScanner& HeaderScanner::vectorized() {
+  static const HeaderScanner* scanner = []() -> const HeaderScanner* {
+    if (const HeaderScanner* scanner = avx2(); scanner != nullptr) {
+      return scanner;
+    }
+    if (const HeaderScanner* scanner = sse42(); scanner != nullptr) {
+      return scanner;
+    }
+    return &scalar();
+  }();
+  return *scanner;
+}
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "envoy/common/pure.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+/**
+ * Bulk checks over HTTP/1 header bytes. The vectorized implementations classify 16 or 32 bytes per
+ * instruction sequence instead of testing one character at a time, which matters for requests
+ * with many short headers where the per-character loops dominate header validation.
+ */
+class HeaderScanner {
+public:
+  virtual ~HeaderScanner() = default;
+
+  /**
+   * @return true if every character of `input` is a token character as defined by RFC 9110
+   *         Section 5.6.2. An empty input is valid.
+   */
+  virtual bool isValidToken(absl::string_view input) const PURE;
+
+  /**
+   * @return true if `input` contains a CR or LF character.
+   */
+  virtual bool containsCrOrLf(absl::string_view input) const PURE;
+
+  /**
+   * @return the name of the implementation, for logging and benchmarks.
+   */
+  virtual absl::string_view name() const PURE;
+
+  /**
+   * @return the portable character-at-a-time implementation.
+   */
+  static const HeaderScanner& scalar();
+
+  /**
+   * @return the widest vectorized implementation supported by the running CPU, or scalar() if
+   *         there is none.
+   */
+  static const HeaderScanner& vectorized();
+
+  /**
+   * @return the SSE4.2 implementation, or nullptr if it is not supported by the build or CPU.
+   */
+  static const HeaderScanner* sse42();
+
+  /**
+   * @return the AVX2 implementation, or nullptr if it is not supported by the build or CPU.
+   */
+  static const HeaderScanner* avx2();
+};
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
@@ -84,6 +84,9 @@ void HttpConnPoolImplMixed::onConnected(Envoy::ConnectionPool::ActiveClient& cli
   } else {
     new_client = std::make_unique<Http2::ActiveClient>(*this, data);
   }
+  // The HTTP client takes over the connection, so it connected when the TCP client did.
+  new_client->connect_start_time_ = client.connect_start_time_;
+  new_client->preconnected_ = client.preconnected_;
   // When we switch from TCP to HTTP clients, the base class onConnectionEvent
   // will be called for both, so add to the connecting stream capacity to
   // balance it being decremented.
@@ -0,0 +1,663 @@
+#include "source/common/http/shared_conn_pool.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/common/dump_state_utils.h"
+#include "source/common/http/header_map_impl.h"
+#include "source/common/http/header_utility.h"
+
+namespace Envoy {
+namespace Http {
+
+// The state that the two halves of a stream share. The borrower half is only set and read on the
+// thread of the borrower, and the owner half on the thread of the owner, so that the posts to each
+// thread find out there whether their half is still around.
+struct SharedConnPool::Handoff : public std::enable_shared_from_this<Handoff> {
+  Handoff(Event::Dispatcher& dispatcher, Event::Dispatcher& owner_dispatcher)
+      : dispatcher_(dispatcher), owner_dispatcher_(owner_dispatcher) {}
+
+  void postToStream(absl::AnyInvocable<void(ActiveStream&)> cb) {
+    dispatcher_.post([handoff = shared_from_this(), cb = std::move(cb)]() mutable {
+      if (handoff->stream_ != nullptr) {
+        cb(*handoff->stream_);
+      }
+    });
+  }
+
+  void postToOwner(absl::AnyInvocable<void(OwnerStream&)> cb) {
+    owner_dispatcher_.post([handoff = shared_from_this(), cb = std::move(cb)]() mutable {
+      if (handoff->owner_stream_ != nullptr) {
+        cb(*handoff->owner_stream_);
+      }
+    });
+  }
+
+  Event::Dispatcher& dispatcher_;
+  Event::Dispatcher& owner_dispatcher_;
+  ActiveStream* stream_{};
+  OwnerStream* owner_stream_{};
+};
+
+// The owner half of a stream, which is the caller of the connection pool of the owner. It owns
+// itself from the time it is started until the stream completes.
+class SharedConnPool::OwnerStream : public ConnectionPool::Callbacks,
+                                    public ResponseDecoder,
+                                    public StreamCallbacks,
+                                    public Event::DeferredDeletable,
+                                    protected Logger::Loggable<Logger::Id::pool> {
+public:
+  static void start(HandoffSharedPtr handoff, const OwnerPoolCb& owner_pool_cb,
+                    const Instance::StreamOptions& options,
+                    const Upstream::HostConstSharedPtr& host, MonotonicTime handed_off_at) {
+    host->cluster().trafficStats()->upstream_rq_shared_handoff_us_.recordValue(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            handoff->owner_dispatcher_.timeSource().monotonicTime() - handed_off_at)
+            .count());
+    ConnectionPool::Instance* pool = owner_pool_cb();
+    if (pool == nullptr) {
+      handoff->postToStream([options](ActiveStream& stream) { stream.onNoOwnerPool(options); });
+      return;
+    }
+    auto* stream = new OwnerStream(std::move(handoff));
+    ConnectionPool::Cancellable* handle = pool->newStream(*stream, *stream, options);
+    // The pool callbacks may have run inline, in which case the stream is already on its way out.
+    if (!stream->destroyed_ && stream->encoder_ == nullptr) {
+      stream->handle_ = handle;
+    }
+  }
+
+  // ConnectionPool::Callbacks
+  void onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                     absl::string_view transport_failure_reason,
+                     Upstream::HostDescriptionConstSharedPtr) override {
+    handle_ = nullptr;
+    handoff_->postToStream([reason, details = std::string(transport_failure_reason)](
+                               ActiveStream& stream) { stream.onPoolFailure(reason, details); });
+    destroy();
+  }
+
+  void onPoolReady(RequestEncoder& encoder, Upstream::HostDescriptionConstSharedPtr,
+                   StreamInfo::StreamInfo& info, std::optional<Protocol> protocol) override {
+    handle_ = nullptr;
+    encoder_ = &encoder;
+    Stream& stream = encoder.getStream();
+    stream.addCallbacks(*this);
+    buffer_limit_ = stream.bufferLimit();
+
+    // The SSL connection info is not shared, as its lazily filled caches are not thread safe.
+    ConnectionSnapshot snapshot;
+    snapshot.local_address_ = stream.connectionInfoProvider().localAddress();
+    snapshot.remote_address_ = stream.connectionInfoProvider().remoteAddress();
+    snapshot.connection_id_ = info.downstreamAddressProvider().connectionID();
+    if (info.upstreamInfo().has_value()) {
+      snapshot.upstream_timing_ = info.upstreamInfo()->upstreamTiming();
+      snapshot.upstream_num_streams_ = info.upstreamInfo()->upstreamNumStreams();
+    }
+    snapshot.buffer_limit_ = buffer_limit_;
+    snapshot.codec_stream_id_ = stream.codecStreamId();
+    handoff_->postToStream(
+        [snapshot = std::move(snapshot), protocol](ActiveStream& stream) mutable {
+          stream.onPoolReady(std::move(snapshot), protocol);
+        });
+  }
+
+  // ResponseDecoder
+  void decode1xxHeaders(ResponseHeaderMapPtr&& headers) override {
+    handoff_->postToStream([headers = std::move(headers)](ActiveStream& stream) mutable {
+      stream.decode1xxHeaders(std::move(headers));
+    });
+  }
+
+  void decodeHeaders(ResponseHeaderMapPtr&& headers, bool end_stream) override {
+    handoff_->postToStream(
+        [headers = std::move(headers), end_stream](ActiveStream& stream) mutable {
+          stream.decodeHeaders(std::move(headers), end_stream);
+        });
+    if (end_stream) {
+      onRemoteEnd();
+    }
+  }
+
+  void decodeData(Buffer::Instance& data, bool end_stream) override {
+    auto buffer = std::make_unique<Buffer::OwnedImpl>();
+    buffer->move(data);
+    response_bytes_in_flight_ += buffer->length();
+    handoff_->postToStream([buffer = std::move(buffer), end_stream](ActiveStream& stream) {
+      stream.decodeData(*buffer, end_stream);
+    });
+    if (end_stream) {
+      onRemoteEnd();
+      return;
+    }
+    // Stop reading the response while the borrower has yet to take too much of it.
+    if (!reads_disabled_ && buffer_limit_ > 0 && response_bytes_in_flight_ > buffer_limit_) {
+      reads_disabled_ = true;
+      encoder_->getStream().readDisable(true);
+    }
+  }
+
+  void decodeTrailers(ResponseTrailerMapPtr&& trailers) override {
+    handoff_->postToStream([trailers = std::move(trailers)](ActiveStream& stream) mutable {
+      stream.decodeTrailers(std::move(trailers));
+    });
+    onRemoteEnd();
+  }
+
+  void decodeMetadata(MetadataMapPtr&& metadata_map) override {
+    handoff_->postToStream([metadata_map = std::move(metadata_map)](ActiveStream& stream) mutable {
+      stream.decodeMetadata(std::move(metadata_map));
+    });
+  }
+
+  void dumpState(std::ostream& os, int indent_level) const override {
+    const char* spaces = spacesForLevel(indent_level);
+    os << spaces << "SharedConnPool::OwnerStream " << this << DUMP_MEMBER(local_end_stream_)
+       << DUMP_MEMBER(remote_end_stream_) << DUMP_MEMBER(response_bytes_in_flight_) << "\n";
+  }
+
+  ResponseDecoderHandlePtr createResponseDecoderHandle() override {
+    return std::make_unique<DecoderHandle>(handoff_);
+  }
+
+  // StreamCallbacks
+  void onResetStream(StreamResetReason reason,
+                     absl::string_view transport_failure_reason) override {
+    encoder_ = nullptr;
+    handoff_->postToStream([reason, details = std::string(transport_failure_reason)](
+                               ActiveStream& stream) { stream.onResetStream(reason, details); });
+    destroy();
+  }
+
+  void onAboveWriteBufferHighWatermark() override {
+    handoff_->postToStream([](ActiveStream& stream) { stream.runHighWatermarkCallbacks(); });
+  }
+
+  void onBelowWriteBufferLowWatermark() override {
+    handoff_->postToStream([](ActiveStream& stream) { stream.runLowWatermarkCallbacks(); });
+  }
+
+  // Relayed from the borrower half.
+  void encodeHeaders(RequestHeaderMapPtr&& headers, bool end_stream) {
+    ASSERT(encoder_ != nullptr);
+    const Status status = encoder_->encodeHeaders(*headers, end_stream);
+    if (destroyed_) {
+      return;
+    }
+    if (!status.ok()) {
+      ENVOY_LOG(debug, "failed to encode the headers of a shared stream: {}", status.message());
+      // Resetting removes the callbacks of this half first, so the borrower is told here.
+      handoff_->postToStream([details = std::string(status.message())](ActiveStream& stream) {
+        stream.onResetStream(StreamResetReason::LocalReset, details);
+      });
+      resetStream(StreamResetReason::LocalReset);
+      return;
+    }
+    if (end_stream) {
+      onLocalEnd();
+    }
+  }
+
+  void encodeData(Buffer::Instance& data, bool end_stream) {
+    ASSERT(encoder_ != nullptr);
+    const uint64_t length = data.length();
+    encoder_->encodeData(data, end_stream);
+    handoff_->postToStream([length](ActiveStream& stream) { stream.onRequestDataSent(length); });
+    if (!destroyed_ && end_stream) {
+      onLocalEnd();
+    }
+  }
+
+  void encodeTrailers(RequestTrailerMapPtr&& trailers) {
+    ASSERT(encoder_ != nullptr);
+    encoder_->encodeTrailers(*trailers);
+    if (!destroyed_) {
+      onLocalEnd();
+    }
+  }
+
+  void encodeMetadata(const MetadataMapVector& metadata_map_vector) {
+    ASSERT(encoder_ != nullptr);
+    encoder_->encodeMetadata(metadata_map_vector);
+  }
+
+  void enableTcpTunneling() {
+    ASSERT(encoder_ != nullptr);
+    encoder_->enableTcpTunneling();
+  }
+
+  void readDisable(bool disable) {
+    if (encoder_ != nullptr) {
+      encoder_->getStream().readDisable(disable);
+    }
+  }
+
+  void setFlushTimeout(std::chrono::milliseconds timeout) {
+    if (encoder_ != nullptr) {
+      encoder_->getStream().setFlushTimeout(timeout);
+    }
+  }
+
+  void onResponseDataReceived(uint64_t length) {
+    ASSERT(response_bytes_in_flight_ >= length);
+    response_bytes_in_flight_ -= length;
+    if (reads_disabled_ && response_bytes_in_flight_ <= buffer_limit_ / 2) {
+      reads_disabled_ = false;
+      encoder_->getStream().readDisable(false);
+    }
+  }
+
+  void cancel(Envoy::ConnectionPool::CancelPolicy cancel_policy) {
+    if (handle_ != nullptr) {
+      handle_->cancel(cancel_policy);
+      handle_ = nullptr;
+      destroy();
+      return;
+    }
+    // The stream became ready before the borrower found out.
+    resetStream(StreamResetReason::LocalReset);
+  }
+
+  void resetStream(StreamResetReason reason) {
+    if (encoder_ != nullptr) {
+      Stream& stream = encoder_->getStream();
+      encoder_ = nullptr;
+      stream.removeCallbacks(*this);
+      stream.resetStream(reason);
+    }
+    destroy();
+  }
+
+private:
+  class DecoderHandle : public ResponseDecoderHandle {
+  public:
+    explicit DecoderHandle(const HandoffSharedPtr& handoff) : handoff_(handoff) {}
+
+    // ResponseDecoderHandle
+    OptRef<ResponseDecoder> get() override {
+      HandoffSharedPtr handoff = handoff_.lock();
+      if (handoff == nullptr || handoff->owner_stream_ == nullptr) {
+        return {};
+      }
+      return *handoff->owner_stream_;
+    }
+
+  private:
+    const std::weak_ptr<Handoff> handoff_;
+  };
+
+  explicit OwnerStream(HandoffSharedPtr&& handoff) : handoff_(std::move(handoff)) {
+    handoff_->owner_stream_ = this;
+  }
+
+  void onLocalEnd() {
+    local_end_stream_ = true;
+    if (remote_end_stream_) {
+      onDone();
+    }
+  }
+
+  void onRemoteEnd() {
+    remote_end_stream_ = true;
+    if (local_end_stream_) {
+      onDone();
+    }
+  }
+
+  void onDone() {
+    encoder_->getStream().removeCallbacks(*this);
+    encoder_ = nullptr;
+    destroy();
+  }
+
+  void destroy() {
+    if (destroyed_) {
+      return;
+    }
+    destroyed_ = true;
+    handoff_->owner_stream_ = nullptr;
+    handoff_->owner_dispatcher_.deferredDelete(std::unique_ptr<OwnerStream>(this));
+  }
+
+  const HandoffSharedPtr handoff_;
+  ConnectionPool::Cancellable* handle_{};
+  RequestEncoder* encoder_{};
+  uint32_t buffer_limit_{};
+  // The response data that the borrower half has yet to decode.
+  uint64_t response_bytes_in_flight_{};
+  bool reads_disabled_{};
+  bool local_end_stream_{};
+  bool remote_end_stream_{};
+  bool destroyed_{};
+};
+
+SharedConnPool::ActiveStream::ActiveStream(SharedConnPool& parent, ResponseDecoder& decoder,
+                                           ConnectionPool::Callbacks& callbacks)
+    : parent_(parent), decoder_(decoder), callbacks_(callbacks),
+      handoff_(std::make_shared<Handoff>(parent.dispatcher_, parent.owner_dispatcher_)),
+      connection_info_provider_(
+          std::make_shared<Network::ConnectionInfoSetterImpl>(nullptr, nullptr)) {
+  handoff_->stream_ = this;
+}
+
+SharedConnPool::ActiveStream::~ActiveStream() { ASSERT(handoff_->stream_ == nullptr); }
+
+void SharedConnPool::ActiveStream::start(const Instance::StreamOptions& options) {
+  const MonotonicTime handed_off_at = parent_.dispatcher_.timeSource().monotonicTime();
+  parent_.owner_dispatcher_.post([handoff = handoff_, owner_pool_cb = parent_.owner_pool_cb_,
+                                  options, host = parent_.host_, handed_off_at]() {
+    OwnerStream::start(handoff, *owner_pool_cb, options, host, handed_off_at);
+  });
+}
+
+void SharedConnPool::ActiveStream::onPoolDestroyed() {
+  if (pending_) {
+    cancel(Envoy::ConnectionPool::CancelPolicy::Default);
+    callbacks_.onPoolFailure(ConnectionPool::PoolFailureReason::LocalConnectionFailure,
+                             "shared connection pool destroyed", parent_.host_);
+    return;
+  }
+  postToOwner([](OwnerStream& stream) { stream.resetStream(StreamResetReason::LocalReset); });
+  onDone();
+  runResetCallbacks(StreamResetReason::ConnectionTermination, "");
+}
+
+void SharedConnPool::ActiveStream::cancel(Envoy::ConnectionPool::CancelPolicy cancel_policy) {
+  ASSERT(pending_);
+  if (local_handle_ != nullptr) {
+    local_handle_->cancel(cancel_policy);
+    local_handle_ = nullptr;
+  } else {
+    postToOwner([cancel_policy](OwnerStream& stream) { stream.cancel(cancel_policy); });
+  }
+  onDone();
+}
+
+void SharedConnPool::ActiveStream::onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                                                 absl::string_view transport_failure_reason,
+                                                 Upstream::HostDescriptionConstSharedPtr host) {
+  local_handle_ = nullptr;
+  onDone();
+  callbacks_.onPoolFailure(reason, transport_failure_reason, std::move(host));
+}
+
+void SharedConnPool::ActiveStream::onPoolReady(RequestEncoder& encoder,
+                                               Upstream::HostDescriptionConstSharedPtr host,
+                                               StreamInfo::StreamInfo& info,
+                                               std::optional<Protocol> protocol) {
+  // The caller takes the stream of the local pool from here on.
+  local_handle_ = nullptr;
+  onDone();
+  callbacks_.onPoolReady(encoder, std::move(host), info, protocol);
+}
+
+void SharedConnPool::ActiveStream::encodeData(Buffer::Instance& data, bool end_stream) {
+  auto buffer = std::make_unique<Buffer::OwnedImpl>();
+  buffer->move(data);
+  request_bytes_in_flight_ += buffer->length();
+  postToOwner([buffer = std::move(buffer), end_stream](OwnerStream& stream) {
+    stream.encodeData(*buffer, end_stream);
+  });
+  if (end_stream) {
+    onLocalEnd();
+    return;
+  }
+  // Push back on the caller while the owner has yet to encode too much of the request.
+  if (!above_in_flight_limit_ && buffer_limit_ > 0 && request_bytes_in_flight_ > buffer_limit_) {
+    above_in_flight_limit_ = true;
+    runHighWatermarkCallbacks();
+  }
+}
+
+void SharedConnPool::ActiveStream::encodeMetadata(const MetadataMapVector& metadata_map_vector) {
+  MetadataMapVector copy;
+  copy.reserve(metadata_map_vector.size());
+  for (const MetadataMapPtr& metadata_map : metadata_map_vector) {
+    copy.push_back(std::make_unique<MetadataMap>(*metadata_map));
+  }
+  postToOwner([copy = std::move(copy)](OwnerStream& stream) { stream.encodeMetadata(copy); });
+}
+
+Status SharedConnPool::ActiveStream::encodeHeaders(const RequestHeaderMap& headers,
+                                                   bool end_stream) {
+  // Fail the headers that the codec of the owner would reject here, where the caller can see it.
+  RETURN_IF_ERROR(HeaderUtility::checkRequiredRequestHeaders(headers));
+  RETURN_IF_ERROR(HeaderUtility::checkValidRequestHeaders(headers));
+  postToOwner([headers = createHeaderMap<RequestHeaderMapImpl>(headers),
+               end_stream](OwnerStream& stream) mutable {
+    stream.encodeHeaders(std::move(headers), end_stream);
+  });
+  if (end_stream) {
+    onLocalEnd();
+  }
+  return okStatus();
+}
+
+void SharedConnPool::ActiveStream::encodeTrailers(const RequestTrailerMap& trailers) {
+  postToOwner([trailers = createHeaderMap<RequestTrailerMapImpl>(trailers)](
+                  OwnerStream& stream) mutable { stream.encodeTrailers(std::move(trailers)); });
+  onLocalEnd();
+}
+
+void SharedConnPool::ActiveStream::enableTcpTunneling() {
+  postToOwner([](OwnerStream& stream) { stream.enableTcpTunneling(); });
+}
+
+void SharedConnPool::ActiveStream::resetStream(StreamResetReason reason) {
+  if (done_) {
+    return;
+  }
+  ASSERT(!pending_);
+  postToOwner([reason](OwnerStream& stream) { stream.resetStream(reason); });
+  onDone();
+  runResetCallbacks(reason, "");
+}
+
+void SharedConnPool::ActiveStream::readDisable(bool disable) {
+  postToOwner([disable](OwnerStream& stream) { stream.readDisable(disable); });
+}
+
+void SharedConnPool::ActiveStream::setFlushTimeout(std::chrono::milliseconds timeout) {
+  postToOwner([timeout](OwnerStream& stream) { stream.setFlushTimeout(timeout); });
+}
+
+void SharedConnPool::ActiveStream::onNoOwnerPool(const Instance::StreamOptions& options) {
+  ConnectionPool::Instance* pool = parent_.localPool();
+  if (pool == nullptr) {
+    onPoolFailure(ConnectionPool::PoolFailureReason::LocalConnectionFailure,
+                  "no connection pool on the owner");
+    return;
+  }
+  ENVOY_LOG(debug, "no connection pool on the owner, using a local one");
+  ConnectionPool::Cancellable* handle = pool->newStream(decoder_, *this, options);
+  // The pool callbacks may have run inline, in which case the stream is already done.
+  if (!done_) {
+    local_handle_ = handle;
+  }
+}
+
+void SharedConnPool::ActiveStream::onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                                                 absl::string_view transport_failure_reason) {
+  onDone();
+  callbacks_.onPoolFailure(reason, transport_failure_reason, parent_.host_);
+}
+
+void SharedConnPool::ActiveStream::onPoolReady(ConnectionSnapshot&& snapshot,
+                                               std::optional<Protocol> protocol) {
+  pending_ = false;
+  parent_.onPendingHandoffDone();
+  connection_info_provider_ = std::make_shared<Network::ConnectionInfoSetterImpl>(
+      snapshot.local_address_, snapshot.remote_address_);
+  if (snapshot.connection_id_.has_value()) {
+    connection_info_provider_->setConnectionID(snapshot.connection_id_.value());
+  }
+  buffer_limit_ = snapshot.buffer_limit_;
+  codec_stream_id_ = snapshot.codec_stream_id_;
+
+  auto upstream_info = std::make_shared<StreamInfo::UpstreamInfoImpl>();
+  upstream_info->upstreamTiming() = snapshot.upstream_timing_;
+  upstream_info->setUpstreamNumStreams(snapshot.upstream_num_streams_);
+  stream_info_ = std::make_unique<StreamInfo::StreamInfoImpl>(
+      parent_.dispatcher_.timeSource(), connection_info_provider_,
+      StreamInfo::FilterState::LifeSpan::Connection);
+  stream_info_->setUpstreamInfo(std::move(upstream_info));
+  callbacks_.onPoolReady(*this, parent_.host_, *stream_info_, protocol);
+}
+
+void SharedConnPool::ActiveStream::decode1xxHeaders(ResponseHeaderMapPtr&& headers) {
+  decoder_.decode1xxHeaders(std::move(headers));
+}
+
+void SharedConnPool::ActiveStream::decodeHeaders(ResponseHeaderMapPtr&& headers,
+                                                 bool end_stream) {
+  if (end_stream) {
+    onRemoteEnd();
+  }
+  decoder_.decodeHeaders(std::move(headers), end_stream);
+}
+
+void SharedConnPool::ActiveStream::decodeData(Buffer::Instance& data, bool end_stream) {
+  const uint64_t length = data.length();
+  if (end_stream) {
+    onRemoteEnd();
+  }
+  decoder_.decodeData(data, end_stream);
+  postToOwner([length](OwnerStream& stream) { stream.onResponseDataReceived(length); });
+}
+
+void SharedConnPool::ActiveStream::decodeTrailers(ResponseTrailerMapPtr&& trailers) {
+  onRemoteEnd();
+  decoder_.decodeTrailers(std::move(trailers));
+}
+
+void SharedConnPool::ActiveStream::decodeMetadata(MetadataMapPtr&& metadata_map) {
+  decoder_.decodeMetadata(std::move(metadata_map));
+}
+
+void SharedConnPool::ActiveStream::onRequestDataSent(uint64_t length) {
+  ASSERT(request_bytes_in_flight_ >= length);
+  request_bytes_in_flight_ -= length;
+  if (above_in_flight_limit_ && request_bytes_in_flight_ <= buffer_limit_ / 2) {
+    above_in_flight_limit_ = false;
+    runLowWatermarkCallbacks();
+  }
+}
+
+void SharedConnPool::ActiveStream::onResetStream(StreamResetReason reason,
+                                                 absl::string_view transport_failure_reason) {
+  onDone();
+  runResetCallbacks(reason, transport_failure_reason);
+}
+
+void SharedConnPool::ActiveStream::onLocalEnd() {
+  local_end_stream_ = true;
+  if (remote_end_stream_) {
+    onDone();
+  }
+}
+
+void SharedConnPool::ActiveStream::onRemoteEnd() {
+  remote_end_stream_ = true;
+  if (local_end_stream_) {
+    onDone();
+  }
+}
+
+void SharedConnPool::ActiveStream::onDone() {
+  if (done_) {
+    return;
+  }
+  done_ = true;
+  if (pending_) {
+    pending_ = false;
+    parent_.onPendingHandoffDone();
+  }
+  // The posts of the owner half that are still on their way are dropped from here on.
+  handoff_->stream_ = nullptr;
+  parent_.onStreamDone(*this);
+}
+
+void SharedConnPool::ActiveStream::postToOwner(absl::AnyInvocable<void(OwnerStream&)> cb) {
+  handoff_->postToOwner(std::move(cb));
+}
+
+SharedConnPool::SharedConnPool(Event::Dispatcher& dispatcher, Event::Dispatcher& owner_dispatcher,
+                               OwnerPoolCb owner_pool_cb, LocalPoolFactory local_pool_factory,
+                               Upstream::HostConstSharedPtr host, uint32_t max_pending_handoffs)
+    : dispatcher_(dispatcher), owner_dispatcher_(owner_dispatcher),
+      owner_pool_cb_(std::make_shared<const OwnerPoolCb>(std::move(owner_pool_cb))),
+      local_pool_factory_(std::move(local_pool_factory)),
+      host_(std::move(host)), max_pending_handoffs_(max_pending_handoffs),
+      socket_options_(std::make_shared<Network::Socket::Options>()) {
+  ASSERT(&dispatcher_ != &owner_dispatcher_);
+}
+
+SharedConnPool::~SharedConnPool() {
+  while (!streams_.empty()) {
+    streams_.front()->onPoolDestroyed();
+  }
+}
+
+ConnectionPool::Cancellable* SharedConnPool::newStream(ResponseDecoder& response_decoder,
+                                                       ConnectionPool::Callbacks& callbacks,
+                                                       const Instance::StreamOptions& options) {
+  if (pending_handoffs_ >= max_pending_handoffs_) {
+    host_->cluster().trafficStats()->upstream_rq_shared_handoff_overflow_.inc();
+    callbacks.onPoolFailure(ConnectionPool::PoolFailureReason::Overflow,
+                            "too many pending shared stream handoffs", host_);
+    return nullptr;
+  }
+  host_->cluster().trafficStats()->upstream_rq_shared_handoff_.inc();
+  ++pending_handoffs_;
+  auto stream = std::make_unique<ActiveStream>(*this, response_decoder, callbacks);
+  ActiveStream& ref = *stream;
+  LinkedList::moveIntoList(std::move(stream), streams_);
+  ref.start(options);
+  return &ref;
+}
+
+void SharedConnPool::drainConnections(Envoy::ConnectionPool::DrainBehavior drain_behavior) {
+  // The shared connections belong to the owner, which drains them on its own.
+  if (drain_behavior == Envoy::ConnectionPool::DrainBehavior::DrainAndDelete) {
+    draining_ = true;
+  }
+  if (local_pool_ != nullptr) {
+    local_pool_->drainConnections(drain_behavior);
+  }
+  checkForIdle();
+}
+
+void SharedConnPool::onStreamDone(ActiveStream& stream) {
+  dispatcher_.deferredDelete(stream.removeFromList(streams_));
+  checkForIdle();
+}
+
+void SharedConnPool::onPendingHandoffDone() {
+  ASSERT(pending_handoffs_ > 0);
+  --pending_handoffs_;
+}
+
+void SharedConnPool::checkForIdle() {
+  if (draining_ && isIdle()) {
+    for (const IdleCb& cb : idle_callbacks_) {
+      cb();
+    }
+  }
+}
+
+ConnectionPool::Instance* SharedConnPool::localPool() {
+  // A draining pool no longer creates the local one, as its factory may be gone by then.
+  if (draining_) {
+    return nullptr;
+  }
+  if (local_pool_ == nullptr) {
+    local_pool_ = local_pool_factory_();
+    if (local_pool_ == nullptr) {
+      return nullptr;
+    }
+    local_pool_->addIdleCallback([this]() { checkForIdle(); });
+  }
+  return local_pool_.get();
+}
+
+} // namespace Http
+} // namespace Envoy
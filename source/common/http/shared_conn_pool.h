@@ -0,0 +1,216 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+
+#include "envoy/common/time.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/http/codec.h"
+#include "envoy/http/conn_pool.h"
+#include "envoy/upstream/upstream.h"
+
+#include "source/common/common/linked_object.h"
+#include "source/common/common/logger.h"
+#include "source/common/http/codec_helper.h"
+#include "source/common/network/socket_impl.h"
+#include "source/common/stream_info/stream_info_impl.h"
+
+#include "absl/functional/any_invocable.h"
+
+namespace Envoy {
+namespace Http {
+
+// An HTTP connection pool which runs its streams on the connection pool of the same host on
+// another worker, the owner, so that the workers share the HTTP/2 and HTTP/3 connections of a few
+// owners instead of each opening their own.
+//
+// The pool runs on the thread of the borrowing worker. Each stream has a half on each thread, and
+// the halves relay the pool, encoder, decoder and stream events to each other with dispatcher
+// posts, moving the headers and the data across. Each half is only accessed on its own thread.
+//
+// The handoffs are bounded: new streams fail with an overflow when too many of them wait for the
+// owner, and the halves apply the buffer limit of the owner stream to the data that is in flight
+// between the threads, raising watermarks on the request side and disabling reads on the response
+// side.
+//
+// When the owner has no pool for the host, e.g. because it has yet to receive the cluster, the
+// stream falls back to a pool of its own on the borrowing worker instead.
+class SharedConnPool : public ConnectionPool::Instance,
+                       protected Logger::Loggable<Logger::Id::pool> {
+public:
+  // Returns the connection pool of the owner for the host, or nullptr if the owner no longer has
+  // one, e.g. because the cluster was removed. This is only called on the thread of the owner.
+  using OwnerPoolCb = std::function<ConnectionPool::Instance*()>;
+  // Creates the local pool for the host, which the streams fall back to when the owner has no
+  // pool. This is only called on the thread of the borrower, before the pool is drained.
+  using LocalPoolFactory = std::function<ConnectionPool::InstancePtr()>;
+
+  SharedConnPool(Event::Dispatcher& dispatcher, Event::Dispatcher& owner_dispatcher,
+                 OwnerPoolCb owner_pool_cb, LocalPoolFactory local_pool_factory,
+                 Upstream::HostConstSharedPtr host, uint32_t max_pending_handoffs);
+  ~SharedConnPool() override;
+
+  // ConnectionPool::Instance
+  bool hasActiveConnections() const override {
+    return !streams_.empty() || (local_pool_ != nullptr && local_pool_->hasActiveConnections());
+  }
+  ConnectionPool::Cancellable* newStream(ResponseDecoder& response_decoder,
+                                         ConnectionPool::Callbacks& callbacks,
+                                         const Instance::StreamOptions& options) override;
+  absl::string_view protocolDescription() const override { return "shared"; }
+  void addIdleCallback(IdleCb cb) override { idle_callbacks_.push_back(cb); }
+  bool isIdle() const override {
+    return streams_.empty() && (local_pool_ == nullptr || local_pool_->isIdle());
+  }
+  void drainConnections(Envoy::ConnectionPool::DrainBehavior drain_behavior) override;
+  Upstream::HostDescriptionConstSharedPtr host() const override { return host_; }
+  const Network::ConnectionSocket::OptionsSharedPtr& socketOptions() override {
+    return socket_options_;
+  }
+  bool maybePreconnect(float) override { return false; }
+
+private:
+  class ActiveStream;
+  class OwnerStream;
+  struct Handoff;
+  using HandoffSharedPtr = std::shared_ptr<Handoff>;
+
+  // What the owner half learns about the connection when the stream is ready.
+  struct ConnectionSnapshot {
+    Network::Address::InstanceConstSharedPtr local_address_;
+    Network::Address::InstanceConstSharedPtr remote_address_;
+    std::optional<uint64_t> connection_id_;
+    StreamInfo::UpstreamTiming upstream_timing_;
+    uint64_t upstream_num_streams_{};
+    uint32_t buffer_limit_{};
+    std::optional<uint32_t> codec_stream_id_;
+  };
+
+  // The borrower half of a stream, which is the encoder and the stream of the caller.
+  class ActiveStream : public LinkedObject<ActiveStream>,
+                       public ConnectionPool::Cancellable,
+                       public ConnectionPool::Callbacks,
+                       public RequestEncoder,
+                       public Stream,
+                       public StreamCallbackHelper,
+                       public Event::DeferredDeletable {
+  public:
+    ActiveStream(SharedConnPool& parent, ResponseDecoder& decoder,
+                 ConnectionPool::Callbacks& callbacks);
+    ~ActiveStream() override;
+
+    // Hands the stream off to the owner.
+    void start(const Instance::StreamOptions& options);
+    // Fails or resets the stream when the pool goes away before it completes.
+    void onPoolDestroyed();
+
+    // ConnectionPool::Cancellable
+    void cancel(Envoy::ConnectionPool::CancelPolicy cancel_policy) override;
+
+    // ConnectionPool::Callbacks, for a stream on the local pool.
+    void onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                       absl::string_view transport_failure_reason,
+                       Upstream::HostDescriptionConstSharedPtr host) override;
+    void onPoolReady(RequestEncoder& encoder, Upstream::HostDescriptionConstSharedPtr host,
+                     StreamInfo::StreamInfo& info, std::optional<Protocol> protocol) override;
+
+    // StreamEncoder
+    void encodeData(Buffer::Instance& data, bool end_stream) override;
+    Stream& getStream() override { return *this; }
+    void encodeMetadata(const MetadataMapVector& metadata_map_vector) override;
+    Http1StreamEncoderOptionsOptRef http1StreamEncoderOptions() override { return {}; }
+
+    // RequestEncoder
+    Status encodeHeaders(const RequestHeaderMap& headers, bool end_stream) override;
+    void encodeTrailers(const RequestTrailerMap& trailers) override;
+    void enableTcpTunneling() override;
+
+    // Stream
+    void resetStream(StreamResetReason reason) override;
+    void addCallbacks(StreamCallbacks& callbacks) override { addCallbacksHelper(callbacks); }
+    void removeCallbacks(StreamCallbacks& callbacks) override { removeCallbacksHelper(callbacks); }
+    CodecEventCallbacks*
+    registerCodecEventCallbacks(CodecEventCallbacks* codec_callbacks) override {
+      std::swap(codec_callbacks, codec_callbacks_);
+      return codec_callbacks;
+    }
+    void readDisable(bool disable) override;
+    uint32_t bufferLimit() const override { return buffer_limit_; }
+    const Network::ConnectionInfoProvider& connectionInfoProvider() override {
+      return *connection_info_provider_;
+    }
+    void setFlushTimeout(std::chrono::milliseconds timeout) override;
+    Buffer::BufferMemoryAccountSharedPtr account() const override { return account_; }
+    void setAccount(Buffer::BufferMemoryAccountSharedPtr account) override {
+      account_ = std::move(account);
+    }
+    const StreamInfo::BytesMeterSharedPtr& bytesMeter() override { return bytes_meter_; }
+    std::optional<uint32_t> codecStreamId() const override { return codec_stream_id_; }
+
+    // Relayed from the owner half.
+    void onNoOwnerPool(const Instance::StreamOptions& options);
+    void onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                       absl::string_view transport_failure_reason);
+    void onPoolReady(ConnectionSnapshot&& snapshot, std::optional<Protocol> protocol);
+    void decode1xxHeaders(ResponseHeaderMapPtr&& headers);
+    void decodeHeaders(ResponseHeaderMapPtr&& headers, bool end_stream);
+    void decodeData(Buffer::Instance& data, bool end_stream);
+    void decodeTrailers(ResponseTrailerMapPtr&& trailers);
+    void decodeMetadata(MetadataMapPtr&& metadata_map);
+    void onRequestDataSent(uint64_t length);
+    void onResetStream(StreamResetReason reason, absl::string_view transport_failure_reason);
+
+  private:
+    void onLocalEnd();
+    void onRemoteEnd();
+    void onDone();
+    void postToOwner(absl::AnyInvocable<void(OwnerStream&)> cb);
+
+    SharedConnPool& parent_;
+    ResponseDecoder& decoder_;
+    ConnectionPool::Callbacks& callbacks_;
+    const HandoffSharedPtr handoff_;
+    // The stream that waits on the local pool.
+    ConnectionPool::Cancellable* local_handle_{};
+    std::shared_ptr<Network::ConnectionInfoSetterImpl> connection_info_provider_;
+    std::unique_ptr<StreamInfo::StreamInfoImpl> stream_info_;
+    StreamInfo::BytesMeterSharedPtr bytes_meter_{std::make_shared<StreamInfo::BytesMeter>()};
+    Buffer::BufferMemoryAccountSharedPtr account_;
+    CodecEventCallbacks* codec_callbacks_{};
+    std::optional<uint32_t> codec_stream_id_;
+    uint32_t buffer_limit_{};
+    // The request data that the owner half has yet to encode.
+    uint64_t request_bytes_in_flight_{};
+    bool pending_{true};
+    bool above_in_flight_limit_{};
+    bool remote_end_stream_{};
+    bool done_{};
+  };
+  using ActiveStreamPtr = std::unique_ptr<ActiveStream>;
+
+  void onStreamDone(ActiveStream& stream);
+  void onPendingHandoffDone();
+  void checkForIdle();
+  ConnectionPool::Instance* localPool();
+
+  Event::Dispatcher& dispatcher_;
+  Event::Dispatcher& owner_dispatcher_;
+  // Shared with the posts to the owner, which may run after the pool is gone.
+  const std::shared_ptr<const OwnerPoolCb> owner_pool_cb_;
+  const LocalPoolFactory local_pool_factory_;
+  const Upstream::HostConstSharedPtr host_;
+  const uint32_t max_pending_handoffs_;
+  const Network::ConnectionSocket::OptionsSharedPtr socket_options_;
+  uint32_t pending_handoffs_{};
+  std::list<ActiveStreamPtr> streams_;
+  std::list<IdleCb> idle_callbacks_;
+  // Created for the first stream that the owner has no pool for.
+  ConnectionPool::InstancePtr local_pool_;
+  bool draining_{};
+};
+
+} // namespace Http
+} // namespace Envoy
@@ -1,8 +1,13 @@
 #include "source/common/io/io_uring_impl.h"
 
 #include <sys/eventfd.h>
+#include <sys/utsname.h>
 
 #include <chrono>
+#include <vector>
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
 
 namespace Envoy {
 namespace Io {
@@ -16,6 +21,30 @@ constexpr uint16_t ProvidedBufferGroupId = 0;
 // empty.
 constexpr uint32_t SqPollIdleMs = 100;
 
+// Whether the kernel is 6.2 or newer, which added `IORING_SEND_ZC_REPORT_USAGE`. Older kernels fail
+// zero-copy sends carrying the flag with EINVAL. No opcode or feature flag came with it, so unlike
+// zero-copy sends themselves it can only be told from the kernel version.
+bool kernelReportsZeroCopyUsage() {
+  struct utsname name;
+  if (uname(&name) != 0) {
+    return false;
+  }
+  const std::vector<absl::string_view> version =
+      absl::StrSplit(name.release, absl::MaxSplits('.', 2));
+  uint32_t major = 0;
+  uint32_t minor = 0;
+  if (version.size() < 2 || !absl::SimpleAtoi(version[0], &major)) {
+    return false;
+  }
+  // The minor version may be followed by a suffix, e.g. "6.2-rc1".
+  const absl::string_view minor_digits =
+      version[1].substr(0, version[1].find_first_not_of("0123456789"));
+  if (!absl::SimpleAtoi(minor_digits, &minor)) {
+    return false;
+  }
+  return major > 6 || (major == 6 && minor >= 2);
+}
+
 // Rounds the configured ring size up to the next power of two, as required by the provided buffer
 // ring, capped so the number of provided buffers stays bounded.
 uint32_t providedBufferCount(uint32_t io_uring_size) {
@@ -115,7 +144,9 @@ bool isIoUringSupported() {
 }
 
 IoUringImpl::IoUringImpl(uint32_t io_uring_size, bool use_submission_queue_polling,
-                         bool enable_multishot_receive, uint32_t multishot_buffer_size) {
+                         bool enable_provided_buffer_receive, bool enable_multishot_receive,
+                         uint32_t provided_buffer_size)
+    : enable_multishot_receive_(enable_multishot_receive) {
   struct io_uring_params p{};
 
   // Size the completion queue at twice the submission queue to reduce the chance of overflow.
@@ -142,22 +173,31 @@ IoUringImpl::IoUringImpl(uint32_t io_uring_size, bool use_submission_queue_polli
   // later passes, which the worker re-arms while hasReadyCompletions stays true.
   cqes_.resize(io_uring_size, nullptr);
 
-  // Set up the provided buffer ring for `multishot` reads when requested. A failure here means the
-  // running kernel lacks provided buffer ring support, in which case `multishot` reads stay
-  // disabled and the readv-based read path is used instead.
-  if (enable_multishot_receive && multishot_buffer_size > 0) {
+  // Set up the provided buffer ring for `multishot` or provided buffer reads when requested. A
+  // failure here means the running kernel lacks provided buffer ring support, in which case both
+  // stay disabled and the readv-based read path is used instead.
+  if ((enable_provided_buffer_receive || enable_multishot_receive) && provided_buffer_size > 0) {
     const uint32_t buffer_count = providedBufferCount(io_uring_size);
     auto pool = std::make_shared<IoUringBufferPoolImpl>(ring_, ProvidedBufferGroupId, buffer_count,
-                                                        multishot_buffer_size);
+                                                        provided_buffer_size);
     if (pool->valid()) {
       buffer_pool_ = std::move(pool);
-      ENVOY_LOG(debug, "io_uring multishot reads enabled, {} buffers of {} bytes", buffer_count,
-                multishot_buffer_size);
+      ENVOY_LOG(debug, "io_uring provided buffer reads enabled, {} buffers of {} bytes",
+                buffer_count, provided_buffer_size);
     } else {
-      ENVOY_LOG(debug, "io_uring multishot reads requested but provided buffer rings are "
+      ENVOY_LOG(debug, "io_uring provided buffer reads requested but provided buffer rings are "
                        "unsupported, falling back to readv");
     }
   }
+
+  // Zero-copy sends need kernel 6.1 or newer. Probe the opcode rather than the kernel version so
+  // that backports are picked up.
+  struct io_uring_probe* probe = io_uring_get_probe_ring(&ring_);
+  if (probe != nullptr) {
+    send_zero_copy_supported_ = io_uring_opcode_supported(probe, IORING_OP_SENDMSG_ZC);
+    io_uring_free_probe(probe);
+  }
+  send_zero_copy_report_usage_ = send_zero_copy_supported_ && kernelReportsZeroCopyUsage();
 }
 
 IoUringImpl::~IoUringImpl() {
@@ -225,6 +265,7 @@ void IoUringImpl::forEveryCompletion(const CompletionCb& completion_cb) {
       req->setBufferId((cqe->flags & IORING_CQE_F_BUFFER)
                            ? static_cast<int32_t>(cqe->flags >> IORING_CQE_BUFFER_SHIFT)
                            : -1);
+      req->setZeroCopyNotification((cqe->flags & IORING_CQE_F_NOTIF) != 0);
     }
     completion_cb(req, cqe->res, false);
   }
@@ -283,7 +324,9 @@ IoUringResult IoUringImpl::prepareReadv(os_fd_t fd, const struct iovec* iovecs,
   return IoUringResult::Ok;
 }
 
-bool IoUringImpl::isMultishotEnabled() const { return buffer_pool_ != nullptr; }
+bool IoUringImpl::isMultishotEnabled() const {
+  return enable_multishot_receive_ && buffer_pool_ != nullptr;
+}
 
 IoUringBufferPoolSharedPtr IoUringImpl::bufferPool() { return buffer_pool_; }
 
@@ -302,6 +345,21 @@ IoUringResult IoUringImpl::prepareReadMultishot(os_fd_t fd, Request* user_data)
   return IoUringResult::Ok;
 }
 
+IoUringResult IoUringImpl::prepareReadProvidedBuffer(os_fd_t fd, Request* user_data) {
+  ENVOY_LOG(trace, "prepare read provided buffer for fd = {}", fd);
+  ASSERT(buffer_pool_ != nullptr);
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  io_uring_prep_recv(sqe, fd, nullptr, buffer_pool_->bufferSize(), 0);
+  sqe->flags |= IOSQE_BUFFER_SELECT;
+  io_uring_sqe_set_buf_group(sqe, buffer_pool_->groupId());
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
 IoUringResult IoUringImpl::prepareWritev(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
                                          off_t offset, Request* user_data) {
   ENVOY_LOG(trace, "prepare writev for fd = {}", fd);
@@ -315,6 +373,27 @@ IoUringResult IoUringImpl::prepareWritev(os_fd_t fd, const struct iovec* iovecs,
   return IoUringResult::Ok;
 }
 
+bool IoUringImpl::isSendZeroCopySupported() const { return send_zero_copy_supported_; }
+
+IoUringResult IoUringImpl::prepareSendmsgZeroCopy(os_fd_t fd, const struct msghdr* msg,
+                                                  Request* user_data) {
+  ENVOY_LOG(trace, "prepare sendmsg zero copy for fd = {}", fd);
+  ASSERT(send_zero_copy_supported_);
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  io_uring_prep_sendmsg_zc(sqe, fd, msg, 0);
+  if (send_zero_copy_report_usage_) {
+    // Ask the kernel to report in the notification whether it had to copy the data after all,
+    // e.g. when the device does not support scatter-gather.
+    sqe->ioprio |= IORING_SEND_ZC_REPORT_USAGE;
+  }
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
 IoUringResult IoUringImpl::prepareClose(os_fd_t fd, Request* user_data) {
   ENVOY_LOG(trace, "prepare close for fd = {}", fd);
   struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
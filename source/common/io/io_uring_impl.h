@@ -28,7 +28,8 @@ class IoUringImpl : public IoUring,
                     protected Logger::Loggable<Logger::Id::io> {
 public:
   IoUringImpl(uint32_t io_uring_size, bool use_submission_queue_polling,
-              bool enable_multishot_receive, uint32_t multishot_buffer_size);
+              bool enable_provided_buffer_receive, bool enable_multishot_receive,
+              uint32_t provided_buffer_size);
   ~IoUringImpl() override;
 
   os_fd_t registerEventfd() override;
@@ -45,8 +46,12 @@ public:
   bool isMultishotEnabled() const override;
   IoUringBufferPoolSharedPtr bufferPool() override;
   IoUringResult prepareReadMultishot(os_fd_t fd, Request* user_data) override;
+  IoUringResult prepareReadProvidedBuffer(os_fd_t fd, Request* user_data) override;
   IoUringResult prepareWritev(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
                               off_t offset, Request* user_data) override;
+  bool isSendZeroCopySupported() const override;
+  IoUringResult prepareSendmsgZeroCopy(os_fd_t fd, const struct msghdr* msg,
+                                       Request* user_data) override;
   IoUringResult prepareClose(os_fd_t fd, Request* user_data) override;
   IoUringResult prepareCancel(Request* cancelling_user_data, Request* user_data) override;
   IoUringResult prepareShutdown(os_fd_t fd, int how, Request* user_data) override;
@@ -64,10 +69,16 @@ private:
   os_fd_t event_fd_{INVALID_SOCKET};
   std::list<InjectedCompletion> injected_completions_;
   uint64_t cq_overflow_count_{0};
-  // The provided buffer pool backing `multishot` reads. Null when `multishot` reads are disabled or
-  // not supported by the kernel. Held as a shared_ptr so read fragments can keep the buffer memory
-  // alive after this ring is gone.
+  // The provided buffer pool backing `multishot` and provided buffer reads. Null when both are
+  // disabled or the kernel does not support provided buffer rings. Held as a shared_ptr so read
+  // fragments can keep the buffer memory alive after this ring is gone.
   std::shared_ptr<IoUringBufferPoolImpl> buffer_pool_;
+  // Whether `multishot` reads were requested. They also need `buffer_pool_`.
+  const bool enable_multishot_receive_;
+  // Whether the kernel supports `IORING_OP_SENDMSG_ZC`, probed once at construction.
+  bool send_zero_copy_supported_{false};
+  // Whether zero-copy sends ask for `IORING_SEND_ZC_REPORT_USAGE`, which needs kernel 6.2 or newer.
+  bool send_zero_copy_report_usage_{false};
 };
 
 } // namespace Io
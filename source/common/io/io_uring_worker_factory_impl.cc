@@ -1,18 +1,20 @@
 #include "source/common/io/io_uring_worker_factory_impl.h"
 
-#include "source/common/io/io_uring_worker_impl.h"
-
 namespace Envoy {
 namespace Io {
 
 IoUringWorkerFactoryImpl::IoUringWorkerFactoryImpl(
-    uint32_t io_uring_size, bool use_submission_queue_polling, bool enable_multishot_receive,
-    uint32_t read_buffer_size, uint32_t write_timeout_ms, uint32_t write_high_watermark_bytes,
-    uint32_t write_low_watermark_bytes, ThreadLocal::SlotAllocator& tls)
+    uint32_t io_uring_size, bool use_submission_queue_polling, bool enable_provided_buffer_receive,
+    bool enable_multishot_receive, uint32_t read_buffer_size, uint32_t write_timeout_ms,
+    uint32_t write_high_watermark_bytes, uint32_t write_low_watermark_bytes,
+    uint32_t zero_copy_send_threshold, Stats::Scope& scope, ThreadLocal::SlotAllocator& tls)
     : io_uring_size_(io_uring_size), use_submission_queue_polling_(use_submission_queue_polling),
+      enable_provided_buffer_receive_(enable_provided_buffer_receive),
       enable_multishot_receive_(enable_multishot_receive), read_buffer_size_(read_buffer_size),
       write_timeout_ms_(write_timeout_ms), write_high_watermark_bytes_(write_high_watermark_bytes),
-      write_low_watermark_bytes_(write_low_watermark_bytes), tls_(tls) {}
+      write_low_watermark_bytes_(write_low_watermark_bytes),
+      zero_copy_send_threshold_(zero_copy_send_threshold),
+      stats_(generateIoUringWorkerStats(scope)), tls_(tls) {}
 
 OptRef<IoUringWorker> IoUringWorkerFactoryImpl::getIoUringWorker() {
   auto ret = tls_.get();
@@ -25,13 +27,17 @@ OptRef<IoUringWorker> IoUringWorkerFactoryImpl::getIoUringWorker() {
 void IoUringWorkerFactoryImpl::onWorkerThreadInitialized() {
   tls_.set([io_uring_size = io_uring_size_,
             use_submission_queue_polling = use_submission_queue_polling_,
+            enable_provided_buffer_receive = enable_provided_buffer_receive_,
             enable_multishot_receive = enable_multishot_receive_,
             read_buffer_size = read_buffer_size_, write_timeout_ms = write_timeout_ms_,
             write_high_watermark_bytes = write_high_watermark_bytes_,
-            write_low_watermark_bytes = write_low_watermark_bytes_](Event::Dispatcher& dispatcher) {
+            write_low_watermark_bytes = write_low_watermark_bytes_,
+            zero_copy_send_threshold = zero_copy_send_threshold_,
+            stats = stats_](Event::Dispatcher& dispatcher) {
     return std::make_shared<IoUringWorkerImpl>(
-        io_uring_size, use_submission_queue_polling, enable_multishot_receive, read_buffer_size,
-        write_timeout_ms, write_high_watermark_bytes, write_low_watermark_bytes, dispatcher);
+        io_uring_size, use_submission_queue_polling, enable_provided_buffer_receive,
+        enable_multishot_receive, read_buffer_size, write_timeout_ms, write_high_watermark_bytes,
+        write_low_watermark_bytes, zero_copy_send_threshold, stats, dispatcher);
   });
 }
 
@@ -1,17 +1,22 @@
 #pragma once
 
 #include "envoy/common/io/io_uring.h"
+#include "envoy/stats/scope.h"
 #include "envoy/thread_local/thread_local.h"
 
+#include "source/common/io/io_uring_worker_impl.h"
+
 namespace Envoy {
 namespace Io {
 
 class IoUringWorkerFactoryImpl : public IoUringWorkerFactory {
 public:
   IoUringWorkerFactoryImpl(uint32_t io_uring_size, bool use_submission_queue_polling,
-                           bool enable_multishot_receive, uint32_t read_buffer_size,
-                           uint32_t write_timeout_ms, uint32_t write_high_watermark_bytes,
-                           uint32_t write_low_watermark_bytes, ThreadLocal::SlotAllocator& tls);
+                           bool enable_provided_buffer_receive, bool enable_multishot_receive,
+                           uint32_t read_buffer_size, uint32_t write_timeout_ms,
+                           uint32_t write_high_watermark_bytes, uint32_t write_low_watermark_bytes,
+                           uint32_t zero_copy_send_threshold, Stats::Scope& scope,
+                           ThreadLocal::SlotAllocator& tls);
 
   OptRef<IoUringWorker> getIoUringWorker() override;
 
@@ -21,11 +26,14 @@ public:
 private:
   const uint32_t io_uring_size_;
   const bool use_submission_queue_polling_;
+  const bool enable_provided_buffer_receive_;
   const bool enable_multishot_receive_;
   const uint32_t read_buffer_size_;
   const uint32_t write_timeout_ms_;
   const uint32_t write_high_watermark_bytes_;
   const uint32_t write_low_watermark_bytes_;
+  const uint32_t zero_copy_send_threshold_;
+  const IoUringWorkerStats stats_;
   ThreadLocal::TypedSlot<IoUringWorker> tls_;
 };
 
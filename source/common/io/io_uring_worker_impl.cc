@@ -12,15 +12,19 @@ constexpr uint32_t MaxReadBufferSizeMultiplier = 16;
 namespace {
 // A negative provided buffer id would index the pool out of bounds. Flag the bug and let the caller
 // skip the buffer when that happens.
-bool multishotBufferIdValid(int32_t buffer_id) {
+bool providedBufferIdValid(int32_t buffer_id) {
   if (buffer_id < 0) {
-    IS_ENVOY_BUG(fmt::format("invalid multishot buffer id {}", buffer_id));
+    IS_ENVOY_BUG(fmt::format("invalid provided buffer id {}", buffer_id));
     return false;
   }
   return true;
 }
 } // namespace
 
+IoUringWorkerStats generateIoUringWorkerStats(Stats::Scope& scope) {
+  return {ALL_IO_URING_WORKER_STATS(POOL_COUNTER_PREFIX(scope, "io_uring."))};
+}
+
 ReadRequest::ReadRequest(IoUringSocket& socket, uint32_t size)
     // Value-initialize the buffer because io_uring fills it in the kernel, which MemorySanitizer
     // cannot observe and would otherwise report as uninitialized.
@@ -37,6 +41,23 @@ WriteRequest::WriteRequest(IoUringSocket& socket, const Buffer::RawSliceVector&
   }
 }
 
+void ZeroCopySentSlices::retain(Buffer::Instance& buffer, uint64_t length) {
+  while (length > 0 && buffer.length() > 0) {
+    const uint64_t slice_length = buffer.frontSlice().len_;
+    ASSERT(slice_length <= length);
+    slices_.emplace_back().move(buffer, slice_length);
+    length -= slice_length;
+  }
+}
+
+ZeroCopyWriteRequest::ZeroCopyWriteRequest(IoUringSocket& socket,
+                                           const Buffer::RawSliceVector& slices,
+                                           ZeroCopySentSlicesSharedPtr sent_slices)
+    : WriteRequest(socket, slices), sent_slices_(std::move(sent_slices)) {
+  msg_.msg_iov = iov_.data();
+  msg_.msg_iovlen = iov_.size();
+}
+
 IoUringSocketEntry::IoUringSocketEntry(os_fd_t fd, IoUringWorkerImpl& parent, Event::FileReadyCb cb,
                                        bool enable_close_event)
     : fd_(fd), parent_(parent), enable_close_event_(enable_close_event), cb_(std::move(cb)) {}
@@ -78,23 +99,34 @@ void IoUringSocketEntry::onRemoteClose() {
 }
 
 IoUringWorkerImpl::IoUringWorkerImpl(uint32_t io_uring_size, bool use_submission_queue_polling,
+                                     bool enable_provided_buffer_receive,
                                      bool enable_multishot_receive, uint32_t read_buffer_size,
                                      uint32_t write_timeout_ms, uint32_t write_high_watermark_bytes,
                                      uint32_t write_low_watermark_bytes,
-                                     Event::Dispatcher& dispatcher)
-    : IoUringWorkerImpl(std::make_unique<IoUringImpl>(io_uring_size, use_submission_queue_polling,
-                                                      enable_multishot_receive, read_buffer_size),
+                                     uint32_t zero_copy_send_threshold,
+                                     const IoUringWorkerStats& stats, Event::Dispatcher& dispatcher)
+    : IoUringWorkerImpl(std::make_unique<IoUringImpl>(
+                            io_uring_size, use_submission_queue_polling,
+                            enable_provided_buffer_receive, enable_multishot_receive,
+                            read_buffer_size),
                         read_buffer_size, write_timeout_ms, write_high_watermark_bytes,
-                        write_low_watermark_bytes, dispatcher) {}
+                        write_low_watermark_bytes, zero_copy_send_threshold, stats, dispatcher) {}
 
 IoUringWorkerImpl::IoUringWorkerImpl(IoUringPtr&& io_uring, uint32_t read_buffer_size,
                                      uint32_t write_timeout_ms, uint32_t write_high_watermark_bytes,
                                      uint32_t write_low_watermark_bytes,
-                                     Event::Dispatcher& dispatcher)
+                                     uint32_t zero_copy_send_threshold,
+                                     const IoUringWorkerStats& stats, Event::Dispatcher& dispatcher)
     : io_uring_(std::move(io_uring)), multishot_enabled_(io_uring_->isMultishotEnabled()),
       buffer_pool_(io_uring_->bufferPool()), read_buffer_size_(read_buffer_size),
       write_timeout_ms_(write_timeout_ms), write_high_watermark_bytes_(write_high_watermark_bytes),
-      write_low_watermark_bytes_(write_low_watermark_bytes), dispatcher_(dispatcher) {
+      write_low_watermark_bytes_(write_low_watermark_bytes),
+      zero_copy_send_threshold_(io_uring_->isSendZeroCopySupported() ? zero_copy_send_threshold
+                                                                     : 0),
+      stats_(stats), dispatcher_(dispatcher) {
+  if (zero_copy_send_threshold > 0 && zero_copy_send_threshold_ == 0) {
+    ENVOY_LOG(info, "io_uring zero-copy sends are not supported by the kernel, using writev");
+  }
   const os_fd_t event_fd = io_uring_->registerEventfd();
   // We only care about the read event of Eventfd, since we only receive the
   // event here.
@@ -124,6 +156,13 @@ IoUringWorkerImpl::~IoUringWorkerImpl() {
     onFileEvent();
   }
 
+  // Waiting for the remaining zero-copy notifications could block on peers acknowledging the data,
+  // so release what they retain along with the ring.
+  for (Request* req : zero_copy_requests_) {
+    delete req;
+  }
+  zero_copy_requests_.clear();
+
   dispatcher_.clearDeferredDeleteList();
 }
 
@@ -218,6 +257,23 @@ Request* IoUringWorkerImpl::submitReadMultishotRequest(IoUringSocket& socket) {
   return req;
 }
 
+Request* IoUringWorkerImpl::submitReadProvidedBufferRequest(IoUringSocket& socket) {
+  Request* req = new Request(Request::RequestType::Read, socket);
+
+  ENVOY_LOG(trace, "submit read provided buffer request, fd = {}, req = {}", socket.fd(),
+            fmt::ptr(req));
+
+  auto res = io_uring_->prepareReadProvidedBuffer(socket.fd(), req);
+  if (res == IoUringResult::Failed) {
+    // TODO(rojkov): handle `EBUSY` in case the completion queue is never reaped.
+    submit();
+    res = io_uring_->prepareReadProvidedBuffer(socket.fd(), req);
+    RELEASE_ASSERT(res == IoUringResult::Ok, "unable to prepare read provided buffer");
+  }
+  submit();
+  return req;
+}
+
 Request* IoUringWorkerImpl::submitWriteRequest(IoUringSocket& socket,
                                                const Buffer::RawSliceVector& slices) {
   WriteRequest* req = new WriteRequest(socket, slices);
@@ -232,6 +288,28 @@ Request* IoUringWorkerImpl::submitWriteRequest(IoUringSocket& socket,
     RELEASE_ASSERT(res == IoUringResult::Ok, "unable to prepare writev");
   }
   submit();
+  stats_.send_copy_.inc();
+  return req;
+}
+
+Request* IoUringWorkerImpl::submitZeroCopyWriteRequest(IoUringSocket& socket,
+                                                       const Buffer::RawSliceVector& slices,
+                                                       ZeroCopySentSlicesSharedPtr sent_slices) {
+  ZeroCopyWriteRequest* req = new ZeroCopyWriteRequest(socket, slices, std::move(sent_slices));
+
+  ENVOY_LOG(trace, "submit zero copy write request, fd = {}, req = {}", socket.fd(),
+            fmt::ptr(req));
+
+  auto res = io_uring_->prepareSendmsgZeroCopy(socket.fd(), &req->msg_, req);
+  if (res == IoUringResult::Failed) {
+    // TODO(rojkov): handle `EBUSY` in case the completion queue is never reaped.
+    submit();
+    res = io_uring_->prepareSendmsgZeroCopy(socket.fd(), &req->msg_, req);
+    RELEASE_ASSERT(res == IoUringResult::Ok, "unable to prepare sendmsg zero copy");
+  }
+  submit();
+  zero_copy_requests_.insert(req);
+  stats_.send_zero_copy_.inc();
   return req;
 }
 
@@ -301,11 +379,17 @@ void IoUringWorkerImpl::injectCompletion(IoUringSocket& socket, Request::Request
 void IoUringWorkerImpl::onFileEvent() {
   ENVOY_LOG(trace, "io uring worker, on file event");
   delay_submit_ = true;
-  io_uring_->forEveryCompletion([](Request* req, int32_t result, bool injected) {
+  io_uring_->forEveryCompletion([this](Request* req, int32_t result, bool injected) {
     ENVOY_LOG(trace, "receive request completion, type = {}, req = {}",
               static_cast<uint8_t>(req->type()), fmt::ptr(req));
     ASSERT(req != nullptr);
 
+    // The socket already handled the result of the send and may be gone.
+    if (req->zeroCopyNotification()) {
+      onZeroCopyNotification(req, result);
+      return;
+    }
+
     switch (req->type()) {
     case Request::RequestType::Accept:
       ENVOY_LOG(trace, "receive accept request completion, fd = {}, req = {}", req->socket().fd(),
@@ -347,6 +431,9 @@ void IoUringWorkerImpl::onFileEvent() {
     // A `multishot` request is reused by the kernel across completions, so keep it alive until the
     // kernel signals it will deliver no more completions for it.
     if (!req->moreCompletions()) {
+      if (!zero_copy_requests_.empty()) {
+        zero_copy_requests_.erase(req);
+      }
       delete req;
     }
   });
@@ -362,6 +449,16 @@ void IoUringWorkerImpl::onFileEvent() {
   }
 }
 
+void IoUringWorkerImpl::onZeroCopyNotification(Request* req, int32_t result) {
+  ENVOY_LOG(trace, "receive zero copy notification, req = {}", fmt::ptr(req));
+  if (static_cast<uint32_t>(result) & IORING_NOTIF_USAGE_ZC_COPIED) {
+    stats_.send_zero_copy_kernel_copied_.inc();
+  }
+  zero_copy_requests_.erase(req);
+  // Releases the slices written by the request.
+  delete req;
+}
+
 void IoUringWorkerImpl::submit() {
   if (!delay_submit_) {
     io_uring_->submit();
@@ -393,6 +490,10 @@ IoUringServerSocket::~IoUringServerSocket() {
   if (write_timeout_timer_) {
     write_timeout_timer_->disableTimer();
   }
+  // A partially written front slice may still be referenced by a zero-copy send in flight.
+  if (zero_copy_sent_ != nullptr) {
+    zero_copy_sent_->retain(write_buf_, write_buf_.length());
+  }
 }
 
 void IoUringServerSocket::close(bool keep_fd_open, IoUringSocketOnClosedCb cb) {
@@ -510,12 +611,13 @@ void IoUringServerSocket::onCancel(Request* req, int32_t result, bool injected)
 }
 
 void IoUringServerSocket::moveReadDataToBuffer(Request* req, size_t data_length) {
-  // A `multishot` read delivers data in a provided buffer. Wrap it as a fragment that releases the
-  // buffer to the pool once drained. The captured pool keeps the buffer memory alive even after the
-  // io_uring is gone, at which point releasing a buffer is a safe no-op.
-  if (read_is_multishot_) {
+  // `Multishot` and provided buffer reads deliver data in a buffer from the pool. Wrap it as a
+  // fragment that releases the buffer to the pool once drained. The captured pool keeps the buffer
+  // memory alive even after the io_uring is gone, at which point releasing a buffer is a safe
+  // no-op.
+  if (read_uses_buffer_pool_) {
     const int32_t buffer_id = req->bufferId();
-    if (!multishotBufferIdValid(buffer_id)) {
+    if (!providedBufferIdValid(buffer_id)) {
       return;
     }
     const IoUringBufferPoolSharedPtr& pool = parent_.bufferPool();
@@ -567,11 +669,11 @@ void IoUringServerSocket::onRead(Request* req, int32_t result, bool injected) {
       if (result > 0) {
         if (keep_fd_open_) {
           moveReadDataToBuffer(req, result);
-        } else if (read_is_multishot_) {
+        } else if (read_uses_buffer_pool_) {
           // The data is dropped while closing, but the provided buffer must still be released to
           // the ring so the pool is not depleted.
           const int32_t buffer_id = req->bufferId();
-          if (multishotBufferIdValid(buffer_id)) {
+          if (providedBufferIdValid(buffer_id)) {
             const IoUringBufferPoolSharedPtr& pool = parent_.bufferPool();
             pool->releaseBuffer(pool->getBuffer(buffer_id));
           }
@@ -590,8 +692,8 @@ void IoUringServerSocket::onRead(Request* req, int32_t result, bool injected) {
     moveReadDataToBuffer(req, result);
     // Adaptive read sizing for the readv path. Grow the next read when the buffer is filled and
     // reset it to the base size otherwise, so large transfers use fewer reads while small responses
-    // stay small. `Multishot` reads use fixed-size provided buffers and skip this.
-    if (!injected && !read_is_multishot_) {
+    // stay small. Reads from the provided buffer pool use fixed-size buffers and skip this.
+    if (!injected && !read_uses_buffer_pool_) {
       const uint32_t base_read_size = parent_.readBufferSize();
       if (static_cast<uint32_t>(result) >= next_read_size_) {
         next_read_size_ =
@@ -601,13 +703,16 @@ void IoUringServerSocket::onRead(Request* req, int32_t result, bool injected) {
       }
     }
   } else if (result == -ENOBUFS) {
-    // The provided buffer pool is exhausted, which ends the `multishot` read. Fall back to a readv
-    // for the next read so progress continues until buffers are recycled.
-    multishot_fallback_ = true;
+    // The provided buffer pool is exhausted, which also ends a `multishot` read. Fall back to a
+    // readv for the next read so progress continues until buffers are recycled.
+    buffer_pool_fallback_ = true;
   } else if (read_is_multishot_ && (result == -EINVAL || result == -EOPNOTSUPP)) {
     // The kernel registered the provided buffer ring but does not support `multishot` recv, which
-    // needs Linux 6.0. Disable `multishot` for this socket and use readv from now on.
+    // needs Linux 6.0. Disable `multishot` for this socket and use provided buffer reads instead.
     multishot_disabled_ = true;
+  } else if (read_uses_buffer_pool_ && (result == -EINVAL || result == -EOPNOTSUPP)) {
+    // The kernel does not support selecting a buffer from the ring for recv. Use readv from now on.
+    provided_buffer_read_disabled_ = true;
   } else if (result != -ECANCELED) {
     read_error_ = result;
   }
@@ -711,13 +816,26 @@ void IoUringServerSocket::onWrite(Request* req, int32_t result, bool injected) {
     return;
   }
 
+  if (write_is_zero_copy_ && (result == -EOPNOTSUPP || result == -EINVAL)) {
+    // The socket does not support zero-copy sends, e.g. a Unix domain socket. Nothing was written,
+    // so send the same data with writev.
+    ENVOY_LOG(debug, "zero copy send is not supported, fall back to writev, fd = {}", fd_);
+    parent_.stats().send_zero_copy_unsupported_.inc();
+    zero_copy_disabled_ = true;
+    if (write_offset_ == 0) {
+      zero_copy_sent_.reset();
+    }
+    submitWriteOrShutdownRequest();
+    return;
+  }
+
   if (result > 0) {
-    write_buf_.drain(result);
+    consumeWriteData(result);
     ENVOY_LOG(trace, "drain write buf, drain size = {}, fd = {}", result, fd_);
     checkWriteWatermarks();
   } else {
     // Drain all write buf since the write failed.
-    write_buf_.drain(write_buf_.length());
+    consumeWriteData(pendingWriteBytes());
     // The write buffer is empty now, so clear backpressure to avoid a stuck write if the socket
     // lingers before close.
     above_write_high_watermark_ = false;
@@ -748,11 +866,11 @@ void IoUringServerSocket::onShutdown(Request* req, int32_t result, bool injected
 void IoUringServerSocket::closeInternal() {
   if (keep_fd_open_) {
     if (on_closed_cb_) {
-      // The fd is handed to another worker thread. `Multishot` reads leave provided buffer
+      // The fd is handed to another worker thread. Reads from the provided buffer pool leave
       // fragments in the read buffer that are bound to this worker's ring, so copy the data into
       // owned memory and drain the read buffer here so those buffers return to the ring on this
       // thread right away.
-      if (parent_.isMultishotEnabled() && read_buf_.length() > 0) {
+      if (parent_.bufferPool() != nullptr && read_buf_.length() > 0) {
         Buffer::OwnedImpl owned_data;
         owned_data.add(read_buf_);
         read_buf_.drain(read_buf_.length());
@@ -774,15 +892,26 @@ void IoUringServerSocket::submitReadRequest() {
     return;
   }
   // Prefer a `multishot` read when available so the kernel keeps delivering data without a new
-  // submission per read. After a buffer pool exhaustion fall back to a single readv, then re-arm
-  // `multishot` on the following read.
-  if (parent_.isMultishotEnabled() && !multishot_fallback_ && !multishot_disabled_) {
-    read_is_multishot_ = true;
-    read_req_ = parent_.submitReadMultishotRequest(*this);
-    return;
+  // submission per read. Otherwise use a provided buffer read, which only takes a buffer from the
+  // pool once data arrives, so idle sockets hold no read memory. After a buffer pool exhaustion
+  // fall back to a single readv, then return to the pool on the following read.
+  if (!buffer_pool_fallback_) {
+    if (parent_.isMultishotEnabled() && !multishot_disabled_) {
+      read_is_multishot_ = true;
+      read_uses_buffer_pool_ = true;
+      read_req_ = parent_.submitReadMultishotRequest(*this);
+      return;
+    }
+    if (parent_.bufferPool() != nullptr && !provided_buffer_read_disabled_) {
+      read_is_multishot_ = false;
+      read_uses_buffer_pool_ = true;
+      read_req_ = parent_.submitReadProvidedBufferRequest(*this);
+      return;
+    }
   }
-  multishot_fallback_ = false;
+  buffer_pool_fallback_ = false;
   read_is_multishot_ = false;
+  read_uses_buffer_pool_ = false;
   if (next_read_size_ == 0) {
     next_read_size_ = parent_.readBufferSize();
   }
@@ -791,11 +920,26 @@ void IoUringServerSocket::submitReadRequest() {
 
 void IoUringServerSocket::submitWriteOrShutdownRequest() {
   if (!write_or_shutdown_req_) {
-    if (write_buf_.length() > 0) {
+    const uint64_t pending_bytes = pendingWriteBytes();
+    if (pending_bytes > 0) {
       Buffer::RawSliceVector slices = write_buf_.getRawSlices(IOV_MAX);
+      if (write_offset_ > 0) {
+        slices[0].mem_ = static_cast<uint8_t*>(slices[0].mem_) + write_offset_;
+        slices[0].len_ -= write_offset_;
+      }
       ENVOY_LOG(trace, "submit write request, write_buf size = {}, num_iovecs = {}, fd = {}",
-                write_buf_.length(), slices.size(), fd_);
-      write_or_shutdown_req_ = parent_.submitWriteRequest(*this, slices);
+                pending_bytes, slices.size(), fd_);
+      const uint32_t zero_copy_threshold = parent_.zeroCopySendThreshold();
+      write_is_zero_copy_ =
+          zero_copy_threshold > 0 && !zero_copy_disabled_ && pending_bytes >= zero_copy_threshold;
+      if (write_is_zero_copy_) {
+        if (zero_copy_sent_ == nullptr) {
+          zero_copy_sent_ = std::make_shared<ZeroCopySentSlices>();
+        }
+        write_or_shutdown_req_ = parent_.submitZeroCopyWriteRequest(*this, slices, zero_copy_sent_);
+      } else {
+        write_or_shutdown_req_ = parent_.submitWriteRequest(*this, slices);
+      }
     } else if (shutdown_.has_value() && !shutdown_.value()) {
       write_or_shutdown_req_ = parent_.submitShutdownRequest(*this, SHUT_WR);
     } else if (status_ == Closed && read_req_ == nullptr && read_cancel_req_ == nullptr &&
@@ -805,15 +949,37 @@ void IoUringServerSocket::submitWriteOrShutdownRequest() {
   }
 }
 
+void IoUringServerSocket::consumeWriteData(uint64_t length) {
+  if (zero_copy_sent_ == nullptr) {
+    write_buf_.drain(length);
+    return;
+  }
+  // Move the fully written slices out of the way without copying them; a zero-copy send in flight
+  // may still reference them. A partially written front slice stays.
+  uint64_t written = write_offset_ + length;
+  while (written > 0 && write_buf_.length() > 0) {
+    const uint64_t slice_length = write_buf_.frontSlice().len_;
+    if (slice_length > written) {
+      break;
+    }
+    zero_copy_sent_->retain(write_buf_, slice_length);
+    written -= slice_length;
+  }
+  write_offset_ = written;
+  if (write_offset_ == 0) {
+    zero_copy_sent_.reset();
+  }
+}
+
 void IoUringServerSocket::checkWriteWatermarks() {
-  if (!above_write_high_watermark_ && write_buf_.length() > write_high_watermark_bytes_) {
+  if (!above_write_high_watermark_ && pendingWriteBytes() > write_high_watermark_bytes_) {
     above_write_high_watermark_ = true;
     ENVOY_LOG(trace, "write buffer above high watermark, fd = {}, size = {}", fd_,
-              write_buf_.length());
-  } else if (above_write_high_watermark_ && write_buf_.length() <= write_low_watermark_bytes_) {
+              pendingWriteBytes());
+  } else if (above_write_high_watermark_ && pendingWriteBytes() <= write_low_watermark_bytes_) {
     above_write_high_watermark_ = false;
     ENVOY_LOG(trace, "write buffer below low watermark, fd = {}, size = {}", fd_,
-              write_buf_.length());
+              pendingWriteBytes());
     // Inject a write event so the handler resumes writing the data it kept while `backpressured`.
     if (!shutdown_.has_value() && status_ != Closed) {
       injectCompletion(Request::RequestType::Write);
@@ -1,17 +1,38 @@
 #pragma once
 
 #include "envoy/common/io/io_uring.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
 
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/linked_object.h"
 #include "source/common/common/logger.h"
 #include "source/common/io/io_uring_impl.h"
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
 
 namespace Envoy {
 namespace Io {
 
+/**
+ * All io_uring worker stats. @see stats_macros.h
+ */
+#define ALL_IO_URING_WORKER_STATS(COUNTER)                                                         \
+  COUNTER(send_copy)                                                                               \
+  COUNTER(send_zero_copy)                                                                          \
+  COUNTER(send_zero_copy_kernel_copied)                                                            \
+  COUNTER(send_zero_copy_unsupported)
+
+/**
+ * Struct definition for all io_uring worker stats. @see stats_macros.h
+ */
+struct IoUringWorkerStats {
+  ALL_IO_URING_WORKER_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+IoUringWorkerStats generateIoUringWorkerStats(Stats::Scope& scope);
+
 class ReadRequest : public Request {
 public:
   ReadRequest(IoUringSocket& socket, uint32_t size);
@@ -29,17 +50,46 @@ public:
   absl::InlinedVector<struct iovec, 16> iov_;
 };
 
+/**
+ * Slices written with a zero-copy send. The kernel may read their memory until it delivers the
+ * send's notification, so they are kept here rather than drained from the write buffer, and freed
+ * once the last request referencing them is notified. Each slice is held in its own buffer so that
+ * moving it in never coalesces or copies it.
+ */
+class ZeroCopySentSlices {
+public:
+  // Moves whole slices totalling `length` bytes from the front of `buffer`.
+  void retain(Buffer::Instance& buffer, uint64_t length);
+
+private:
+  std::list<Buffer::OwnedImpl> slices_;
+};
+using ZeroCopySentSlicesSharedPtr = std::shared_ptr<ZeroCopySentSlices>;
+
+class ZeroCopyWriteRequest : public WriteRequest {
+public:
+  ZeroCopyWriteRequest(IoUringSocket& socket, const Buffer::RawSliceVector& slices,
+                       ZeroCopySentSlicesSharedPtr sent_slices);
+
+  struct msghdr msg_{};
+  // Keeps the memory referenced by `msg_` alive until the notification.
+  ZeroCopySentSlicesSharedPtr sent_slices_;
+};
+
 class IoUringSocketEntry;
 using IoUringSocketEntryPtr = std::unique_ptr<IoUringSocketEntry>;
 
 class IoUringWorkerImpl : public IoUringWorker, private Logger::Loggable<Logger::Id::io> {
 public:
   IoUringWorkerImpl(uint32_t io_uring_size, bool use_submission_queue_polling,
-                    bool enable_multishot_receive, uint32_t read_buffer_size,
-                    uint32_t write_timeout_ms, uint32_t write_high_watermark_bytes,
-                    uint32_t write_low_watermark_bytes, Event::Dispatcher& dispatcher);
+                    bool enable_provided_buffer_receive, bool enable_multishot_receive,
+                    uint32_t read_buffer_size, uint32_t write_timeout_ms,
+                    uint32_t write_high_watermark_bytes, uint32_t write_low_watermark_bytes,
+                    uint32_t zero_copy_send_threshold, const IoUringWorkerStats& stats,
+                    Event::Dispatcher& dispatcher);
   IoUringWorkerImpl(IoUringPtr&& io_uring, uint32_t read_buffer_size, uint32_t write_timeout_ms,
                     uint32_t write_high_watermark_bytes, uint32_t write_low_watermark_bytes,
+                    uint32_t zero_copy_send_threshold, const IoUringWorkerStats& stats,
                     Event::Dispatcher& dispatcher);
   ~IoUringWorkerImpl() override;
 
@@ -58,7 +108,13 @@ public:
   Request* submitReadRequest(IoUringSocket& socket, uint32_t read_size);
   // Submit a `multishot` read request that draws buffers from the provided buffer pool.
   Request* submitReadMultishotRequest(IoUringSocket& socket);
+  // Submit a single read request that draws a buffer from the provided buffer pool.
+  Request* submitReadProvidedBufferRequest(IoUringSocket& socket);
   Request* submitWriteRequest(IoUringSocket& socket, const Buffer::RawSliceVector& slices) override;
+  // Submit a zero-copy write request. `sent_slices` receives the written slices from the socket and
+  // is kept alive by the request until the kernel releases their memory.
+  Request* submitZeroCopyWriteRequest(IoUringSocket& socket, const Buffer::RawSliceVector& slices,
+                                      ZeroCopySentSlicesSharedPtr sent_slices);
   Request* submitCloseRequest(IoUringSocket& socket) override;
   Request* submitCancelRequest(IoUringSocket& socket, Request* request_to_cancel) override;
   Request* submitShutdownRequest(IoUringSocket& socket, int how) override;
@@ -80,14 +136,21 @@ public:
   // Whether this worker's io_uring has `multishot` reads backed by a provided buffer pool
   // available.
   bool isMultishotEnabled() const { return multishot_enabled_; }
-  // The provided buffer pool used for `multishot` reads, or nullptr when `multishot` reads are not
-  // available. Cached at construction to avoid a virtual call on each read completion.
+  // The provided buffer pool used for `multishot` and provided buffer reads, or nullptr when
+  // neither is available. Cached at construction to avoid a virtual call on each read completion.
   const IoUringBufferPoolSharedPtr& bufferPool() const { return buffer_pool_; }
 
+  // The minimum write size sent with zero-copy, or 0 when zero-copy sends are disabled or not
+  // supported by the kernel.
+  uint32_t zeroCopySendThreshold() const { return zero_copy_send_threshold_; }
+
+  IoUringWorkerStats& stats() { return stats_; }
+
 protected:
   // Add a socket to the worker.
   IoUringSocketEntry& addSocket(IoUringSocketEntryPtr&& socket);
   void onFileEvent();
+  void onZeroCopyNotification(Request* req, int32_t result);
   void submit();
 
   // The iouring instance.
@@ -95,19 +158,24 @@ protected:
   // Whether `multishot` reads are available, cached once at construction to avoid a virtual call on
   // each read submission.
   const bool multishot_enabled_;
-  // The provided buffer pool used for `multishot` reads, cached once at construction. Null when
-  // `multishot` reads are not available.
+  // The provided buffer pool used for `multishot` and provided buffer reads, cached once at
+  // construction. Null when neither is available.
   const IoUringBufferPoolSharedPtr buffer_pool_;
   const uint32_t read_buffer_size_;
   const uint32_t write_timeout_ms_;
   const uint32_t write_high_watermark_bytes_;
   const uint32_t write_low_watermark_bytes_;
+  const uint32_t zero_copy_send_threshold_;
+  IoUringWorkerStats stats_;
   // The dispatcher of this worker is running on.
   Event::Dispatcher& dispatcher_;
   // The file event of iouring's eventfd.
   Event::FileEventPtr file_event_{nullptr};
   // All the sockets in this worker.
   std::list<IoUringSocketEntryPtr> sockets_;
+  // Zero-copy write requests whose final completion has not arrived yet. The socket may be gone by
+  // the time their notification arrives, so the worker owns them until then.
+  absl::flat_hash_set<Request*> zero_copy_requests_;
   // This is used to mark whether delay submit is enabled.
   // The IoUringWorker will delay the submit the requests which are submitted in request completion
   // callback.
@@ -251,11 +319,17 @@ protected:
   uint32_t next_read_size_{0};
   // Whether the in-flight read request is a `multishot` read drawing from the provided buffer pool.
   bool read_is_multishot_{false};
-  // Set when a `multishot` read ends with an exhausted buffer pool. The next read uses a readv that
-  // re-arms `multishot` once buffers are recycled.
-  bool multishot_fallback_{false};
-  // Set when the kernel reports `multishot` recv is unsupported. The socket then uses readv only.
+  // Whether the in-flight read request draws its buffer from the provided buffer pool, either as a
+  // `multishot` read or as a provided buffer read.
+  bool read_uses_buffer_pool_{false};
+  // Set when a read from the provided buffer pool ends with an exhausted pool. The next read uses a
+  // readv and the one after returns to the pool once buffers are recycled.
+  bool buffer_pool_fallback_{false};
+  // Set when the kernel reports `multishot` recv is unsupported. The socket then uses provided
+  // buffer reads, or readv if those are unsupported too.
   bool multishot_disabled_{false};
+  // Set when the kernel rejects provided buffer reads. The socket then uses readv only.
+  bool provided_buffer_read_disabled_{false};
   // TODO (soulxu): Add water mark here.
   Buffer::OwnedImpl read_buf_;
   std::optional<int32_t> read_error_;
@@ -266,6 +340,16 @@ protected:
   // notified to resume after write_buf_ drains below the low watermark. This applies backpressure
   // to the upper layer so flood protection can kick in.
   Buffer::OwnedImpl write_buf_;
+  // With zero-copy sends, bytes of the front slice of write_buf_ that are already written. The
+  // slice stays in write_buf_ until it is fully written, then moves to zero_copy_sent_.
+  uint64_t write_offset_{0};
+  // Collects written slices while a zero-copy send may still reference them. Reset once nothing
+  // in write_buf_ is referenced any more; in-flight requests keep their own reference.
+  ZeroCopySentSlicesSharedPtr zero_copy_sent_;
+  // Whether the in-flight write request is a zero-copy send.
+  bool write_is_zero_copy_{false};
+  // Set when the socket rejects zero-copy sends. The socket then uses writev only.
+  bool zero_copy_disabled_{false};
   // shutdown_ has 3 states. A std::nullopt indicates the socket has not been shutdown, a false
   // value represents the socket wants to be shutdown but the shutdown has not been performed or
   // completed, and a true value means the socket has been shutdown.
@@ -290,6 +374,10 @@ protected:
   void closeInternal();
   void submitReadRequest();
   void submitWriteOrShutdownRequest();
+  // The number of bytes in write_buf_ that are not written yet.
+  uint64_t pendingWriteBytes() const { return write_buf_.length() - write_offset_; }
+  // Removes `length` written bytes from write_buf_.
+  void consumeWriteData(uint64_t length);
   void moveReadDataToBuffer(Request* req, size_t data_length);
   void onReadCompleted(int32_t result);
   void onWriteCompleted(int32_t result);
@@ -19,6 +19,7 @@
 #include "source/common/common/scope_tracker.h"
 #include "source/common/network/address_impl.h"
 #include "source/common/network/connection_socket_impl.h"
+#include "source/common/network/io_socket_handle_impl.h"
 #include "source/common/network/raw_buffer_socket.h"
 #include "source/common/network/socket_option_factory.h"
 #include "source/common/network/socket_option_impl.h"
@@ -1022,6 +1023,20 @@ std::optional<uint64_t> ConnectionImpl::congestionWindowInBytes() const {
   return socket_->congestionWindowInBytes();
 }
 
+bool ConnectionImpl::canSpliceSocket() const {
+  // Other IoHandle implementations either have no file descriptor or may read from it on their
+  // own, e.g. io_uring.
+  return state() == State::Open && !connecting_ && !read_end_stream_ && !write_end_stream_ &&
+         read_buffer_->length() == 0 && write_buffer_->length() == 0 &&
+         transport_socket_->passesBytesThrough() && filter_manager_.hasAtMostOneReadFilter() &&
+         dynamic_cast<const IoSocketHandleImpl*>(&ioHandle()) != nullptr;
+}
+
+bool ConnectionImpl::canSendFile() const {
+  return state() == State::Open && transport_socket_->sendsFileRanges() &&
+         dynamic_cast<const IoSocketHandleImpl*>(&ioHandle()) != nullptr;
+}
+
 void ConnectionImpl::flushWriteBuffer() {
   if (state() == State::Open && write_buffer_->length() > 0) {
     onWriteReady();
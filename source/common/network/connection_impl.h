@@ -119,6 +119,8 @@ public:
   void configureInitialCongestionWindow(uint64_t bandwidth_bits_per_sec,
                                         std::chrono::microseconds rtt) override;
   std::optional<uint64_t> congestionWindowInBytes() const override;
+  bool canSpliceSocket() const override;
+  bool canSendFile() const override;
 
   // Network::FilterManagerConnection
   void rawWrite(Buffer::Instance& data, bool end_stream) override;
@@ -134,6 +134,10 @@ public:
   void maybeClose();
   void onConnectionClose(ConnectionCloseAction close_action);
   bool pendingClose() { return state_.local_close_pending_ || state_.remote_close_pending_; }
+  // Whether at most one read filter and no write filters see the bytes of the connection.
+  bool hasAtMostOneReadFilter() const {
+    return upstream_filters_.size() <= 1 && downstream_filters_.empty();
+  }
 
   void addAccessLogHandler(AccessLog::InstanceSharedPtr handler);
   void log(AccessLog::AccessLogType type);
@@ -1,5 +1,6 @@
 #include "source/common/network/io_socket_handle_impl.h"
 
+#include <algorithm>
 #include <memory>
 #include <optional>
 
@@ -138,7 +139,35 @@ Api::IoCallUint64Result IoSocketHandleImpl::writev(const Buffer::RawSlice* slice
 
 Api::IoCallUint64Result IoSocketHandleImpl::write(Buffer::Instance& buffer) {
   constexpr uint64_t MaxSlices = 16;
-  Buffer::RawSliceVector slices = buffer.getRawSlices(MaxSlices);
+  const std::optional<Buffer::FileRange> file_range = buffer.frontFileRange();
+  if (file_range.has_value() && sendfile_supported_) {
+    // The front of the buffer is a range of a file: have the kernel copy it to the socket
+    // without reading it into user space.
+    Api::SysCallSizeResult sendfile_result = Api::OsSysCallsSingleton::get().sendfile(
+        fd_, file_range->fd_, file_range->offset_, file_range->len_);
+    if (sendfile_result.return_value_ >= 0 ||
+        (sendfile_result.errno_ != SOCKET_ERROR_INVAL && sendfile_result.errno_ != ENOSYS &&
+         sendfile_result.errno_ != SOCKET_ERROR_NOT_SUP)) {
+      if (sendfile_result.return_value_ == 0 && file_range->len_ > 0) {
+        // Nothing is left of the range in the file: it was truncated after being referenced.
+        // Fail the write, as a zero-byte result would have the transport socket retry it forever.
+        sendfile_result.return_value_ = -1;
+        sendfile_result.errno_ = EIO;
+      }
+      Api::IoCallUint64Result result = sysCallResultToIoCallResult(sendfile_result);
+      if (result.ok() && result.return_value_ > 0) {
+        buffer.drain(static_cast<uint64_t>(result.return_value_));
+      }
+      return result;
+    }
+    // The file or the socket does not support sendfile(), e.g. the file is on a file system
+    // without page cache support. Write the contents of the ranges from now on.
+    sendfile_supported_ = false;
+  }
+  if (file_range.has_value()) {
+    return writeFileRangeContents(buffer, file_range.value());
+  }
+  Buffer::RawSliceVector slices = buffer.getRawSlicesBeforeFileRange(MaxSlices);
   Api::IoCallUint64Result result = writev(slices.begin(), slices.size());
   if (result.ok() && result.return_value_ > 0) {
     buffer.drain(static_cast<uint64_t>(result.return_value_));
@@ -146,6 +175,33 @@ Api::IoCallUint64Result IoSocketHandleImpl::write(Buffer::Instance& buffer) {
   return result;
 }
 
+Api::IoCallUint64Result
+IoSocketHandleImpl::writeFileRangeContents(Buffer::Instance& buffer,
+                                           const Buffer::FileRange& file_range) {
+  // The range is read in bounded chunks rather than through BufferFragment::data(), which would
+  // hold all of it in memory and has no way to report that the file was truncated.
+  constexpr uint64_t MaxChunkSize = 64 * 1024;
+  const uint64_t length = std::min(file_range.len_, MaxChunkSize);
+  auto chunk = std::make_unique<uint8_t[]>(length);
+  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+  Api::SysCallSizeResult read_result =
+      os_sys_calls.pread(file_range.fd_, chunk.get(), length, file_range.offset_);
+  if (read_result.return_value_ == 0 && length > 0) {
+    // Nothing is left of the range in the file: it was truncated after being referenced.
+    read_result.return_value_ = -1;
+    read_result.errno_ = EIO;
+  }
+  if (read_result.return_value_ < 0) {
+    return sysCallResultToIoCallResult(read_result);
+  }
+  Api::IoCallUint64Result result = sysCallResultToIoCallResult(
+      os_sys_calls.send(fd_, chunk.get(), static_cast<size_t>(read_result.return_value_), 0));
+  if (result.ok() && result.return_value_ > 0) {
+    buffer.drain(static_cast<uint64_t>(result.return_value_));
+  }
+  return result;
+}
+
 Api::IoCallUint64Result IoSocketHandleImpl::sendmsg(const Buffer::RawSlice* slices,
                                                     uint64_t num_slice, int flags,
                                                     const Address::Ip* self_ip,
@@ -116,6 +116,10 @@ private:
   Address::InstanceConstSharedPtr getOrCreateEnvoyAddressInstance(sockaddr_storage ss,
                                                                   socklen_t ss_len);
 
+  // Writes the front of a file range through user space, once sendfile() is not supported.
+  Api::IoCallUint64Result writeFileRangeContents(Buffer::Instance& buffer,
+                                                 const Buffer::FileRange& file_range);
+
   // Caches the address instances of the most recently received packets on this socket.
   // Should only be used by QUIC client sockets to avoid creating multiple address instances for
   // the same address in each read operation. Since the QUIC client sockets are connected via a
@@ -124,6 +128,9 @@ private:
   size_t address_cache_max_capacity_;
   // Only non-null if address_cache_max_capacity_ is greater than 0.
   std::optional<std::vector<QuicEnvoyAddressPair>> recent_received_addresses_ = std::nullopt;
+  // Cleared once sendfile() failed because the socket or a file does not support it, after which
+  // the file ranges of the written buffers are read with pread() and written with send().
+  bool sendfile_supported_{true};
 
   // For testing and benchmarking non-public methods.
   friend class IoSocketHandleImplTestWrapper;
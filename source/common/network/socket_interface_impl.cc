@@ -180,13 +180,17 @@ Server::BootstrapExtensionPtr SocketInterfaceImpl::createBootstrapExtension(
     if (write_low_watermark >= write_high_watermark) {
       write_low_watermark = write_high_watermark / 2;
     }
+    // A threshold of 0 disables zero-copy sends.
+    const uint32_t zero_copy_send_threshold =
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(options, zero_copy_send_threshold, 0);
     std::shared_ptr<Io::IoUringWorkerFactoryImpl> io_uring_worker_factory =
         std::make_shared<Io::IoUringWorkerFactoryImpl>(
             PROTOBUF_GET_WRAPPED_OR_DEFAULT(options, io_uring_size, 1000),
-            options.enable_submission_queue_polling(), options.enable_multishot_receive(),
+            options.enable_submission_queue_polling(), options.enable_provided_buffer_receive(),
+            options.enable_multishot_receive(),
             PROTOBUF_GET_WRAPPED_OR_DEFAULT(options, read_buffer_size, 8192),
             PROTOBUF_GET_WRAPPED_OR_DEFAULT(options, write_timeout_ms, 1000), write_high_watermark,
-            write_low_watermark, context.threadLocal());
+            write_low_watermark, zero_copy_send_threshold, context.scope(), context.threadLocal());
     io_uring_worker_factory_ = io_uring_worker_factory;
 
     return std::make_unique<DefaultSocketInterfaceExtension>(*this, io_uring_worker_factory);
@@ -137,6 +137,27 @@ void UdpListenerImpl::processPacket(Address::InstanceConstSharedPtr local_addres
   cb_.onData(std::move(recvData));
 }
 
+void UdpListenerImpl::processCoalescedDatagrams(Address::InstanceConstSharedPtr local_address,
+                                                Address::InstanceConstSharedPtr peer_address,
+                                                Buffer::InstancePtr buffer, uint64_t gso_size,
+                                                MonotonicTime receive_time, uint8_t tos,
+                                                Buffer::OwnedImpl saved_cmsg) {
+  if (!cb_.supportsCoalescedDatagrams()) {
+    UdpPacketProcessor::processCoalescedDatagrams(std::move(local_address), std::move(peer_address),
+                                                  std::move(buffer), gso_size, receive_time, tos,
+                                                  std::move(saved_cmsg));
+    return;
+  }
+  ASSERT(local_address != nullptr);
+  UdpRecvData recvData{{std::move(local_address), std::move(peer_address)},
+                       std::move(buffer),
+                       receive_time,
+                       tos,
+                       std::move(saved_cmsg),
+                       gso_size};
+  cb_.onData(std::move(recvData));
+}
+
 void UdpListenerImpl::handleWriteCallback() {
   ENVOY_UDP_LOG(trace, "handleWriteCallback");
   cb_.onWriteReady(*socket_);
@@ -48,6 +48,11 @@ public:
                      Address::InstanceConstSharedPtr peer_address, Buffer::InstancePtr buffer,
                      MonotonicTime receive_time, uint8_t tos,
                      Buffer::OwnedImpl saved_cmsg) override;
+  void processCoalescedDatagrams(Address::InstanceConstSharedPtr local_address,
+                                 Address::InstanceConstSharedPtr peer_address,
+                                 Buffer::InstancePtr buffer, uint64_t gso_size,
+                                 MonotonicTime receive_time, uint8_t tos,
+                                 Buffer::OwnedImpl saved_cmsg) override;
   uint64_t maxDatagramSize() const override { return config_.max_rx_datagram_size_; }
   void onDatagramsDropped(uint32_t dropped) override { cb_.onDatagramsDropped(dropped); }
   size_t numPacketsExpectedPerEventLoop() const override {
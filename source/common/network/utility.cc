@@ -529,13 +529,26 @@ Api::IoCallUint64Result Utility::writeToSocket(IoHandle& handle, Buffer::RawSlic
   return send_result;
 }
 
+void UdpPacketProcessor::processCoalescedDatagrams(Address::InstanceConstSharedPtr local_address,
+                                                   Address::InstanceConstSharedPtr peer_address,
+                                                   Buffer::InstancePtr buffer, uint64_t gso_size,
+                                                   MonotonicTime receive_time, uint8_t tos,
+                                                   Buffer::OwnedImpl saved_cmsg) {
+  // TODO(mattklein123): The following code should be optimized to avoid buffer copies, either by
+  // switching to slices or by using a CoW buffer type.
+  while (buffer->length() > 0) {
+    const uint64_t bytes_to_copy = std::min(buffer->length(), gso_size);
+    Buffer::InstancePtr sub_buffer = std::make_unique<Buffer::OwnedImpl>();
+    sub_buffer->move(*buffer, bytes_to_copy);
+    processPacket(local_address, peer_address, std::move(sub_buffer), receive_time, tos,
+                  std::move(saved_cmsg));
+  }
+}
+
 namespace {
 
-void passPayloadToProcessor(uint64_t bytes_read, Buffer::InstancePtr buffer,
-                            Address::InstanceConstSharedPtr peer_addess,
-                            Address::InstanceConstSharedPtr local_address,
-                            UdpPacketProcessor& udp_packet_processor, MonotonicTime receive_time,
-                            uint8_t tos, Buffer::OwnedImpl saved_cmsg) {
+void checkPeerAddress(uint64_t bytes_read, const Address::InstanceConstSharedPtr& peer_addess,
+                      const Address::InstanceConstSharedPtr& local_address) {
   ENVOY_BUG(peer_addess != nullptr,
             fmt::format("Unable to get remote address on the socket bound to local address: {}.",
                         (local_address == nullptr ? "unknown" : local_address->asString())));
@@ -547,6 +560,14 @@ void passPayloadToProcessor(uint64_t bytes_read, Buffer::InstancePtr buffer,
                         peer_addess->asString(),
                         (local_address == nullptr ? "unknown" : local_address->asString()),
                         bytes_read));
+}
+
+void passPayloadToProcessor(uint64_t bytes_read, Buffer::InstancePtr buffer,
+                            Address::InstanceConstSharedPtr peer_addess,
+                            Address::InstanceConstSharedPtr local_address,
+                            UdpPacketProcessor& udp_packet_processor, MonotonicTime receive_time,
+                            uint8_t tos, Buffer::OwnedImpl saved_cmsg) {
+  checkPeerAddress(bytes_read, peer_addess, local_address);
   udp_packet_processor.processPacket(std::move(local_address), std::move(peer_addess),
                                      std::move(buffer), receive_time, tos, std::move(saved_cmsg));
 }
@@ -596,20 +617,16 @@ Api::IoCallUint64Result readFromSocketRecvGro(IoHandle& handle,
     return result;
   }
 
-  // Segment the buffer read by the recvmsg syscall into gso_sized sub buffers.
-  // TODO(mattklein123): The following code should be optimized to avoid buffer copies, either by
-  // switching to slices or by using a CoW buffer type.
-  while (buffer->length() > 0) {
-    const uint64_t bytes_to_copy = std::min(buffer->length(), gso_size);
-    Buffer::InstancePtr sub_buffer = std::make_unique<Buffer::OwnedImpl>();
-    sub_buffer->move(*buffer, bytes_to_copy);
-    if (num_packets_read != nullptr) {
-      *num_packets_read += 1;
-    }
-    passPayloadToProcessor(bytes_to_copy, std::move(sub_buffer), output.msg_[0].peer_address_,
-                           output.msg_[0].local_address_, udp_packet_processor, receive_time,
-                           output.msg_[0].tos_, std::move(output.msg_[0].saved_cmsg_));
+  // The buffer read by the recvmsg syscall holds gso_sized datagrams, which the processor either
+  // consumes in place or segments into sub buffers.
+  if (num_packets_read != nullptr) {
+    *num_packets_read += (buffer->length() + gso_size - 1) / gso_size;
   }
+  checkPeerAddress(buffer->length(), output.msg_[0].peer_address_, output.msg_[0].local_address_);
+  udp_packet_processor.processCoalescedDatagrams(
+      std::move(output.msg_[0].local_address_), std::move(output.msg_[0].peer_address_),
+      std::move(buffer), gso_size, receive_time, output.msg_[0].tos_,
+      std::move(output.msg_[0].saved_cmsg_));
 
   return result;
 }
@@ -43,6 +43,19 @@ public:
                              Buffer::InstancePtr buffer, MonotonicTime receive_time, uint8_t tos,
                              Buffer::OwnedImpl saved_cmsg) PURE;
 
+  /**
+   * Consume the datagrams read out of the socket by a single GRO receive, which share the
+   * information from the UDP header. By default, each datagram is moved to its own buffer and
+   * passed to processPacket().
+   * @param buffer contains the datagrams back to back.
+   * @param gso_size is the size of each datagram but the last one, which may be shorter.
+   */
+  virtual void processCoalescedDatagrams(Address::InstanceConstSharedPtr local_address,
+                                         Address::InstanceConstSharedPtr peer_address,
+                                         Buffer::InstancePtr buffer, uint64_t gso_size,
+                                         MonotonicTime receive_time, uint8_t tos,
+                                         Buffer::OwnedImpl saved_cmsg);
+
   /**
    * Called whenever datagrams are dropped due to overflow or truncation.
    * @param dropped supplies the number of dropped datagrams.
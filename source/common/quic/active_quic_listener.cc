@@ -55,6 +55,12 @@ ActiveQuicListener::ActiveQuicListener(
       version_manager_(reject_new_connections ? quic::ParsedQuicVersionVector()
                                               : quic::CurrentSupportedHttp3Versions()),
       kernel_worker_routing_(kernel_worker_routing),
+      // The datagrams coalesced by GRO all go to the worker the first one is routed to, which is
+      // only right if the kernel already routes them to their worker or if there is only one.
+      process_coalesced_datagrams_(
+          Runtime::runtimeFeatureEnabled(
+              "envoy.reloadable_features.quic_process_coalesced_datagrams") &&
+          (kernel_worker_routing || concurrency == 1)),
       packets_to_read_to_connection_count_ratio_(packets_to_read_to_connection_count_ratio),
       crypto_server_stream_factory_(crypto_server_stream_factory),
       connection_id_generator_(std::move(cid_generator)),
@@ -185,18 +191,33 @@ void ActiveQuicListener::onDataWorker(Network::UdpRecvData&& data) {
                                                   .count());
   Buffer::RawSlice slice = data.buffer_->frontSlice();
   ASSERT(data.buffer_->length() == slice.len_);
-  // TODO(danzh): pass in TTL and UDP header.
-  quic::QuicReceivedPacket packet(reinterpret_cast<char*>(slice.mem_), slice.len_, timestamp,
-                                  /*owns_buffer=*/false, /*ttl=*/0, /*ttl_valid=*/false,
-                                  reinterpret_cast<char*>(data.saved_cmsg_.frontSlice().mem_),
-                                  data.saved_cmsg_.frontSlice().len_,
-                                  /*owns_header_buffer*/ false,
-                                  getQuicEcnCodepointFromTosByte(data.tos_));
-  if (!quic_dispatcher_->processPacket(self_address, peer_address, packet)) {
-    if (non_dispatched_udp_packet_handler_.has_value()) {
-      non_dispatched_udp_packet_handler_->handle(worker_index_, std::move(data));
+  Buffer::RawSlice saved_cmsg = data.saved_cmsg_.frontSlice();
+  const quic::QuicEcnCodepoint ecn = getQuicEcnCodepointFromTosByte(data.tos_);
+  // The datagrams coalesced by GRO share the UDP header, so they are passed to the dispatcher in
+  // place, one after the other, with the addresses and the receive time converted only once.
+  const uint64_t gso_size = data.gso_size_ > 0 ? data.gso_size_ : slice.len_;
+  uint64_t offset = 0;
+  do {
+    const uint64_t length = std::min(gso_size, slice.len_ - offset);
+    // TODO(danzh): pass in TTL and UDP header.
+    quic::QuicReceivedPacket packet(static_cast<char*>(slice.mem_) + offset, length, timestamp,
+                                    /*owns_buffer=*/false, /*ttl=*/0, /*ttl_valid=*/false,
+                                    static_cast<char*>(saved_cmsg.mem_), saved_cmsg.len_,
+                                    /*owns_header_buffer*/ false, ecn);
+    if (!quic_dispatcher_->processPacket(self_address, peer_address, packet) &&
+        non_dispatched_udp_packet_handler_.has_value()) {
+      if (data.gso_size_ == 0) {
+        non_dispatched_udp_packet_handler_->handle(worker_index_, data);
+      } else {
+        Network::UdpRecvData datagram{data.addresses_,
+                                      std::make_unique<Buffer::OwnedImpl>(packet.data(), length),
+                                      data.receive_time_, data.tos_};
+        datagram.saved_cmsg_.add(data.saved_cmsg_);
+        non_dispatched_udp_packet_handler_->handle(worker_index_, datagram);
+      }
     }
-  }
+    offset += length;
+  } while (offset < slice.len_);
 
   if (quic_dispatcher_->HasChlosBuffered()) {
     // If there are any buffered CHLOs, activate a read event for the next event loop to process
@@ -270,6 +291,10 @@ uint32_t ActiveQuicListener::destination(const Network::UdpRecvData& data) const
   return select_connection_id_worker_(*data.buffer_, worker_index_);
 }
 
+bool ActiveQuicListener::supportsCoalescedDatagrams() const {
+  return process_coalesced_datagrams_;
+}
+
 size_t ActiveQuicListener::numPacketsExpectedPerEventLoop() const {
   // Expect each session to read packets_to_read_to_connection_count_ratio_ number of packets in
   // this read event.
@@ -66,6 +66,7 @@ public:
   const Network::IoHandle::UdpSaveCmsgConfig& udpSaveCmsgConfig() const override {
     return udp_save_cmsg_config_;
   }
+  bool supportsCoalescedDatagrams() const override;
 
   // ActiveListenerImplBase
   void pauseListening() override;
@@ -94,6 +95,7 @@ private:
   quic::QuicVersionManager version_manager_;
   std::unique_ptr<EnvoyQuicDispatcher> quic_dispatcher_;
   const bool kernel_worker_routing_;
+  const bool process_coalesced_datagrams_;
   std::optional<Runtime::FeatureFlag> enabled_;
   Network::UdpPacketWriter* udp_packet_writer_;
   quic::QuicPacketWriter* quic_packet_writer_{nullptr};
@@ -1813,7 +1813,63 @@ VirtualHostImpl::VirtualHostImpl(const envoy::config::route::v3::VirtualHost& vi
       SET_AND_RETURN_IF_NOT_OK(route_or_error.status(), creation_status);
       routes_.emplace_back(route_or_error.value());
     }
+    if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.compiled_route_path_matching")) {
+      buildRoutePathIndex();
+    }
+  }
+}
+
+void VirtualHostImpl::buildRoutePathIndex() {
+  auto index = std::make_unique<RoutePathIndex>();
+  for (uint32_t position = 0; position < routes_.size(); ++position) {
+    const RouteEntryImplBase& route = *routes_[position];
+    // Case insensitive routes would need a lowercased copy of every request path, so they are
+    // evaluated on every request like regex and template routes.
+    const bool indexable = route.case_sensitive() && !route.matcher().empty();
+    switch (route.matchType()) {
+    case PathMatchType::Exact:
+      if (indexable) {
+        index->addExact(position, route.matcher());
+        continue;
+      }
+      break;
+    case PathMatchType::Prefix:
+    case PathMatchType::PathSeparatedPrefix:
+      if (indexable) {
+        index->addPrefix(position, route.matcher());
+        continue;
+      }
+      break;
+    case PathMatchType::None:
+    case PathMatchType::Regex:
+    case PathMatchType::Template:
+      break;
+    }
+    index->addUnindexed(position);
+  }
+  if (index->indexedRoutes() == 0) {
+    return;
+  }
+  index->compile();
+  route_path_index_ = std::move(index);
+}
+
+RouteConstSharedPtr
+VirtualHostImpl::getRouteFromIndex(const RouteMatchContext& route_match_context,
+                                   const StreamInfo::StreamInfo& stream_info,
+                                   uint64_t random_value) const {
+  RoutePathIndex::Candidates candidates;
+  route_path_index_->findCandidates(route_match_context.sanitizedPathWithoutQuery(), candidates);
+  for (const uint32_t position : candidates) {
+    RouteConstSharedPtr route_entry =
+        routes_[position]->matches(route_match_context, stream_info, random_value);
+    if (route_entry != nullptr) {
+      return route_entry;
+    }
   }
+
+  ENVOY_LOG(debug, "route was resolved but final route list did not match incoming request");
+  return nullptr;
 }
 
 RouteConstSharedPtr VirtualHostImpl::getRouteFromRoutes(
@@ -1909,6 +1965,12 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const RouteCallback& cb
     return nullptr;
   }
 
+  // The index skips routes that cannot match the path, which would change the route evaluation
+  // status reported to a route callback, so callers with a callback always get the full scan.
+  if (route_path_index_ != nullptr && cb == nullptr && headers.Path() != nullptr) {
+    return getRouteFromIndex(route_match_context, stream_info, random_value);
+  }
+
   // Check for a route that matches the request.
   return getRouteFromRoutes(cb, route_match_context, stream_info, random_value, routes_);
 }
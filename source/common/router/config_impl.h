@@ -38,6 +38,7 @@
 #include "source/common/router/metadatamatchcriteria_impl.h"
 #include "source/common/router/per_filter_config.h"
 #include "source/common/router/retry_policy_impl.h"
+#include "source/common/router/route_path_index.h"
 #include "source/common/router/router_ratelimit.h"
 #include "source/common/router/tls_context_match_criteria_impl.h"
 #include "source/common/stats/symbol_table.h"
@@ -478,12 +479,21 @@ public:
 private:
   enum class SslRequirements : uint8_t { None, ExternalOnly, All };
 
+  // Builds route_path_index_ over routes_.
+  void buildRoutePathIndex();
+  // First-match evaluation of routes_ restricted to the candidates returned by route_path_index_.
+  RouteConstSharedPtr getRouteFromIndex(const RouteMatchContext& route_match_context,
+                                        const StreamInfo::StreamInfo& stream_info,
+                                        uint64_t random_value) const;
+
   CommonVirtualHostSharedPtr shared_virtual_host_;
 
   std::shared_ptr<const SslRedirectRoute> ssl_redirect_route_;
   SslRequirements ssl_requirements_;
 
   absl::InlinedVector<RouteEntryImplBaseConstSharedPtr, 2> routes_;
+  // Only built when envoy.reloadable_features.compiled_route_path_matching is enabled.
+  std::unique_ptr<const RoutePathIndex> route_path_index_;
   Matcher::MatchTreeSharedPtr<Http::HttpMatchingData> matcher_;
 };
 
@@ -674,6 +684,8 @@ public:
 
   bool isRedirect() const;
 
+  bool case_sensitive() const { return case_sensitive_; }
+
   bool matchRoute(const RouteMatchContext& route_match_context,
                   const StreamInfo::StreamInfo& stream_info, uint64_t random_value) const;
   absl::Status validateClusters(const Upstream::ClusterManager& cluster_manager) const;
@@ -866,7 +878,6 @@ protected:
 
   std::unique_ptr<ConnectConfig> connect_config_;
 
-  bool case_sensitive() const { return case_sensitive_; }
   RouteConstSharedPtr clusterEntry(const Http::RequestHeaderMap& headers,
                                    const StreamInfo::StreamInfo& stream_info,
                                    uint64_t random_value) const;
@@ -0,0 +1,57 @@
+#include "source/common/router/route_path_index.h"
+
+#include <algorithm>
+
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+namespace Router {
+
+void RoutePathIndex::addExact(uint32_t position, absl::string_view path) {
+  exact_positions_[path].push_back(position);
+  ++indexed_routes_;
+}
+
+void RoutePathIndex::addPrefix(uint32_t position, absl::string_view prefix) {
+  prefix_positions_[prefix].push_back(position);
+  ++indexed_routes_;
+}
+
+void RoutePathIndex::addUnindexed(uint32_t position) { unindexed_positions_.push_back(position); }
+
+void RoutePathIndex::compile() {
+  std::vector<CompiledStringMap<const Positions*>::KV> exact_contents;
+  exact_contents.reserve(exact_positions_.size());
+  for (const auto& [path, positions] : exact_positions_) {
+    exact_contents.emplace_back(path, &positions);
+  }
+  exact_map_.compile(std::move(exact_contents));
+
+  for (const auto& [prefix, positions] : prefix_positions_) {
+    prefix_tree_.add(prefix, &positions);
+  }
+}
+
+void RoutePathIndex::mergeInto(const Positions& positions, Candidates& candidates) {
+  const size_t middle = candidates.size();
+  candidates.insert(candidates.end(), positions.begin(), positions.end());
+  if (middle != 0) {
+    std::inplace_merge(candidates.begin(), candidates.begin() + middle, candidates.end());
+  }
+}
+
+void RoutePathIndex::findCandidates(absl::string_view path, Candidates& candidates) const {
+  ASSERT(candidates.empty());
+  if (!unindexed_positions_.empty()) {
+    mergeInto(unindexed_positions_, candidates);
+  }
+  if (const Positions* exact = exact_map_.find(path); exact != nullptr) {
+    mergeInto(*exact, candidates);
+  }
+  for (const Positions* prefix : prefix_tree_.findMatchingPrefixes(path)) {
+    mergeInto(*prefix, candidates);
+  }
+}
+
+} // namespace Router
+} // namespace Envoy
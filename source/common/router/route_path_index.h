@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "source/common/common/compiled_string_map.h"
+#include "source/common/common/radix_tree.h"
+
+#include "absl/container/inlined_vector.h"
+#include "absl/container/node_hash_map.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * Index over the path match criteria of an ordered list of routes. Given a request path, it
+ * produces the positions of the routes whose path criterion may match it, in route order, so that
+ * a virtual host with thousands of exact and prefix routes does not have to evaluate each of them
+ * in turn. Routes whose path criterion cannot be indexed (regex, templates, case insensitive
+ * matching, ...) are registered as unindexed and are always returned as candidates.
+ *
+ * Candidates still have to be evaluated in full: the index only rules out routes whose path
+ * criterion cannot match, and says nothing about header, query parameter or runtime constraints.
+ */
+class RoutePathIndex {
+public:
+  using Candidates = absl::InlinedVector<uint32_t, 8>;
+
+  /**
+   * Register the route at `position` as matching `path` exactly. Routes must be added in
+   * increasing position order.
+   */
+  void addExact(uint32_t position, absl::string_view path);
+
+  /**
+   * Register the route at `position` as matching paths starting with `prefix`. This is also used
+   * for path separated prefixes, whose segment boundary check is left to the route itself.
+   */
+  void addPrefix(uint32_t position, absl::string_view prefix);
+
+  /**
+   * Register the route at `position` as a candidate for every path.
+   */
+  void addUnindexed(uint32_t position);
+
+  /**
+   * Build the lookup structures. Must be called once after all routes have been added.
+   */
+  void compile();
+
+  /**
+   * @param path the request path with the query string, fragment and (if configured) path
+   *        parameters removed.
+   * @param candidates receives the positions of all routes that may match `path`, ascending.
+   */
+  void findCandidates(absl::string_view path, Candidates& candidates) const;
+
+  /**
+   * @return the number of routes that are looked up by path rather than always evaluated.
+   */
+  uint32_t indexedRoutes() const { return indexed_routes_; }
+
+private:
+  using Positions = std::vector<uint32_t>;
+
+  static void mergeInto(const Positions& positions, Candidates& candidates);
+
+  // Owning storage; node_hash_map keeps the keys and position lists at stable addresses for the
+  // lookup structures below.
+  absl::node_hash_map<std::string, Positions> exact_positions_;
+  absl::node_hash_map<std::string, Positions> prefix_positions_;
+  Positions unindexed_positions_;
+
+  CompiledStringMap<const Positions*> exact_map_;
+  RadixTree<const Positions*> prefix_tree_;
+  uint32_t indexed_routes_{};
+};
+
+} // namespace Router
+} // namespace Envoy
@@ -1,7 +1,10 @@
 #include "source/common/stats/allocator.h"
 
 #include <algorithm>
+#include <bit>
 #include <cstdint>
+#include <memory>
+#include <thread>
 
 #include "envoy/stats/sink.h"
 #include "envoy/stats/stats.h"
@@ -164,6 +167,82 @@ private:
   std::atomic<uint64_t> pending_increment_{0};
 };
 
+// A counter that spreads increments over cache-line sized cells, picked by the incrementing
+// thread, so that workers incrementing the same counter do not bounce a shared cache line between
+// cores. The cells are only summed when the counter is read or latched, i.e. on stats flushes and
+// admin requests. Threads are assigned cells round robin; with more threads than cells some
+// threads share a cell, which is still correct as the cells are atomic.
+class ShardedCounterImpl : public StatsSharedImpl<Counter> {
+public:
+  ShardedCounterImpl(StatName name, Allocator& alloc, StatName tag_extracted_name,
+                     StatNameTagSpan stat_name_tags)
+      : StatsSharedImpl(name, alloc, tag_extracted_name, stat_name_tags),
+        shard_mask_(shardCount() - 1), shards_(std::make_unique<Shard[]>(shardCount())) {}
+
+  void removeFromSetLockHeld() ABSL_EXCLUSIVE_LOCKS_REQUIRED(alloc_.mutex_) override {
+    const size_t count = alloc_.counters_.erase(statName());
+    ASSERT(count == 1);
+    alloc_.sinked_counters_.erase(this);
+  }
+
+  // Stats::Counter
+  void add(uint64_t amount) override {
+    shards_[threadIndex() & shard_mask_].value_.fetch_add(amount, std::memory_order_relaxed);
+    // Only write the shared flags the first time so that steady state increments stay on the
+    // thread's own cell.
+    if (!(flags_.load(std::memory_order_relaxed) & Flags::Used)) {
+      flags_ |= Flags::Used;
+    }
+  }
+  void inc() override { add(1); }
+  uint64_t latch() override {
+    // Like value(), sum() may miss increments racing with the latch; they are picked up by the
+    // next latch.
+    const uint64_t total = sum();
+    return total - latched_.exchange(total);
+  }
+  void reset() override { reset_offset_ = sum(); }
+  uint64_t value() const override {
+    // Load the offset first: the cells only grow, so the sum read afterwards is never below it.
+    const uint64_t reset_offset = reset_offset_;
+    return sum() - reset_offset;
+  }
+
+private:
+  struct alignas(64) Shard {
+    std::atomic<uint64_t> value_{0};
+  };
+
+  // The number of cells per counter: the number of hardware threads rounded up to a power of two,
+  // capped at 64.
+  static uint32_t shardCount() {
+    static const uint32_t count =
+        std::bit_ceil(std::clamp(std::thread::hardware_concurrency(), 1u, 64u));
+    return count;
+  }
+
+  static uint32_t threadIndex() {
+    static std::atomic<uint32_t> next_thread_index{0};
+    thread_local const uint32_t thread_index =
+        next_thread_index.fetch_add(1, std::memory_order_relaxed);
+    return thread_index;
+  }
+
+  uint64_t sum() const {
+    uint64_t total = 0;
+    for (uint32_t i = 0; i <= shard_mask_; ++i) {
+      total += shards_[i].value_.load(std::memory_order_relaxed);
+    }
+    return total;
+  }
+
+  const uint32_t shard_mask_;
+  const std::unique_ptr<Shard[]> shards_;
+  // Sum of the cells at the last latch() and reset() respectively.
+  std::atomic<uint64_t> latched_{0};
+  std::atomic<uint64_t> reset_offset_{0};
+};
+
 class GaugeImpl : public StatsSharedImpl<Gauge> {
 public:
   GaugeImpl(StatName name, Allocator& alloc, StatName tag_extracted_name,
@@ -363,6 +442,9 @@ bool Allocator::isMutexLockedForTest() {
 
 Counter* Allocator::makeCounterInternal(StatName name, StatName tag_extracted_name,
                                         StatNameTagSpan stat_name_tags) {
+  if (sharded_counter_matcher_ != nullptr && !sharded_counter_matcher_->rejects(name)) {
+    return new ShardedCounterImpl(name, *this, tag_extracted_name, stat_name_tags);
+  }
   return new CounterImpl(name, *this, tag_extracted_name, stat_name_tags);
 }
 
@@ -463,6 +545,10 @@ void Allocator::setSinkPredicates(std::unique_ptr<SinkPredicates>&& sink_predica
   }
 }
 
+void Allocator::setShardedCounterMatcher(StatsMatcherPtr&& matcher) {
+  sharded_counter_matcher_ = std::move(matcher);
+}
+
 void Allocator::markCounterForDeletion(const CounterSharedPtr& counter) {
   Thread::LockGuard lock(mutex_);
   auto iter = counters_.find(counter->statName());
@@ -4,6 +4,7 @@
 
 #include "envoy/stats/sink.h"
 #include "envoy/stats/stats.h"
+#include "envoy/stats/stats_matcher.h"
 
 #include "source/common/common/thread.h"
 #include "source/common/common/thread_synchronizer.h"
@@ -80,6 +81,18 @@ public:
    * Set the predicates to filter stats for sink.
    */
   void setSinkPredicates(std::unique_ptr<SinkPredicates>&& sink_predicates);
+
+  /**
+   * Select the counters to create as sharded counters. Increments of a sharded counter go to a
+   * cache-line sized cell picked by the incrementing thread rather than a single shared atomic,
+   * and the cells are summed when the counter is read or latched. This trades memory for less
+   * cache line contention on counters that are incremented on every worker.
+   *
+   * Must be called during startup, before worker threads are started. Only affects counters
+   * created after the call.
+   * @param matcher counters whose names are not rejected by the matcher are sharded.
+   */
+  void setShardedCounterMatcher(StatsMatcherPtr&& matcher);
 #ifndef ENVOY_CONFIG_COVERAGE
   void debugPrint();
 #endif
@@ -112,6 +125,7 @@ protected:
 private:
   template <class BaseClass> friend class StatsSharedImpl;
   friend class CounterImpl;
+  friend class ShardedCounterImpl;
   friend class GaugeImpl;
   friend class TextReadoutImpl;
 
@@ -133,6 +147,8 @@ private:
 
   // Predicates used to filter stats to be flushed.
   std::unique_ptr<SinkPredicates> sink_predicates_;
+  // Selects sharded counters. Only set during startup, see setShardedCounterMatcher().
+  StatsMatcherPtr sharded_counter_matcher_;
   SymbolTable& symbol_table_;
 
   Thread::ThreadSynchronizer sync_;
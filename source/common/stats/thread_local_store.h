@@ -202,6 +202,10 @@ public:
   }
   void setStatsMatcher(StatsMatcherPtr&& stats_matcher) override;
   void setHistogramSettings(HistogramSettingsConstPtr&& histogram_settings) override;
+  void setShardedCounterMatcher(StatsMatcherPtr&& matcher) override {
+    ASSERT_IS_MAIN_OR_TEST_THREAD();
+    alloc_.setShardedCounterMatcher(std::move(matcher));
+  }
   // Enables/disables the explicit-tags logic store-wide. This should be called before
   // any scope that with non-empty prefix is created.
   void setUseExplicitTags(bool use_explicit_tags) override {
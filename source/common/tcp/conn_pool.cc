@@ -85,7 +85,10 @@ void ActiveTcpClient::clearCallbacks() {
   callbacks_ = nullptr;
   tcp_connection_data_ = nullptr;
   parent_.onStreamClosed(*this, true);
-  setIdleTimer();
+  // The pool closes the idle clients in excess of its adaptive preconnect headroom.
+  if (state() != Envoy::ConnectionPool::ActiveClient::State::Closed) {
+    setIdleTimer();
+  }
   parent_.checkForIdleAndCloseIdleConnsIfDraining();
 }
 
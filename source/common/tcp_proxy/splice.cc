@@ -0,0 +1,215 @@
+#include "source/common/tcp_proxy/splice.h"
+
+#include "envoy/api/os_sys_calls.h"
+#include "envoy/event/dispatcher.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/common/utility.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace TcpProxy {
+namespace {
+
+// The default capacity of a pipe on Linux.
+constexpr uint64_t MaxBytesPerSplice = 64 * 1024;
+// Yield to the other events after moving this many bytes in one direction, as ConnectionImpl
+// does once its read buffer reaches the high watermark.
+constexpr uint64_t MaxBytesPerEvent = 1024 * 1024;
+
+os_fd_t socketFd(Network::Connection& connection) {
+  return connection.getSocket()->ioHandle().fdDoNotUse();
+}
+
+} // namespace
+
+SpliceSession::Pipe::Pipe(Network::Connection& from, Network::Connection& to, Side from_side)
+    : from_(from), to_(to), from_side_(from_side),
+      to_side_(from_side == Side::Downstream ? Side::Upstream : Side::Downstream),
+      from_fd_(socketFd(from)), to_fd_(socketFd(to)) {}
+
+SpliceSession::Pipe::~Pipe() {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  for (os_fd_t fd : {read_fd_, write_fd_}) {
+    if (SOCKET_VALID(fd)) {
+      os_sys_calls.close(fd);
+    }
+  }
+}
+
+SpliceSessionPtr SpliceSession::start(Network::Connection& downstream,
+                                      Network::Connection& upstream, Callbacks& callbacks) {
+  // The pump relies on edge triggered events to learn when a socket becomes readable or writable
+  // again.
+  if constexpr (Event::PlatformDefaultTriggerType != Event::FileTriggerType::Edge) {
+    return nullptr;
+  }
+  ASSERT(downstream.canSpliceSocket() && upstream.canSpliceSocket());
+  SpliceSessionPtr session(new SpliceSession(downstream, upstream, callbacks));
+  if (!session->initialize()) {
+    return nullptr;
+  }
+  return session;
+}
+
+SpliceSession::SpliceSession(Network::Connection& downstream, Network::Connection& upstream,
+                             Callbacks& callbacks)
+    : callbacks_(callbacks), downstream_to_upstream_(downstream, upstream, Side::Downstream),
+      upstream_to_downstream_(upstream, downstream, Side::Upstream) {}
+
+SpliceSession::~SpliceSession() = default;
+
+bool SpliceSession::initialize() {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  for (Pipe* pipe : {&downstream_to_upstream_, &upstream_to_downstream_}) {
+    os_fd_t fds[2];
+    const Api::SysCallIntResult result = os_sys_calls.pipe(fds);
+    if (result.return_value_ != 0) {
+      ENVOY_LOG(debug, "cannot create a pipe to splice sockets: {}", errorDetails(result.errno_));
+      return false;
+    }
+    pipe->read_fd_ = fds[0];
+    pipe->write_fd_ = fds[1];
+  }
+
+  Network::Connection& downstream = downstream_to_upstream_.from_;
+  Network::Connection& upstream = downstream_to_upstream_.to_;
+  // These events share the sockets with the file events of the connections, which keep only
+  // watching for writes once the connections are read disabled.
+  downstream_file_event_ = downstream.dispatcher().createFileEvent(
+      downstream_to_upstream_.from_fd_,
+      [this](uint32_t events) {
+        onFileEvent(Side::Downstream, events);
+        return absl::OkStatus();
+      },
+      Event::FileTriggerType::Edge, Event::FileReadyType::Read | Event::FileReadyType::Write);
+  upstream_file_event_ = upstream.dispatcher().createFileEvent(
+      upstream_to_downstream_.from_fd_,
+      [this](uint32_t events) {
+        onFileEvent(Side::Upstream, events);
+        return absl::OkStatus();
+      },
+      Event::FileTriggerType::Edge, Event::FileReadyType::Read | Event::FileReadyType::Write);
+  downstream.readDisable(true);
+  upstream.readDisable(true);
+  active_ = true;
+
+  // Move the bytes that are already waiting in the sockets.
+  downstream_file_event_->activate(Event::FileReadyType::Read);
+  upstream_file_event_->activate(Event::FileReadyType::Read);
+  return true;
+}
+
+void SpliceSession::onFileEvent(Side side, uint32_t events) {
+  ASSERT(active_);
+  Pipe& inbound = side == Side::Downstream ? downstream_to_upstream_ : upstream_to_downstream_;
+  Pipe& outbound = side == Side::Downstream ? upstream_to_downstream_ : downstream_to_upstream_;
+  // A writable socket drains the pipe towards it, and a readable socket fills its own pipe.
+  if ((events & Event::FileReadyType::Write) && !pump(outbound)) {
+    stop();
+    return;
+  }
+  if (active_ && (events & Event::FileReadyType::Read) && !pump(inbound)) {
+    stop();
+  }
+}
+
+bool SpliceSession::pump(Pipe& pipe) {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  uint64_t bytes_read = 0;
+  uint64_t bytes_written = 0;
+  bool keep_splicing = true;
+  while (true) {
+    if (pipe.length_ > 0) {
+      const Api::SysCallSizeResult result =
+          os_sys_calls.splice(pipe.read_fd_, pipe.to_fd_, pipe.length_);
+      if (result.return_value_ <= 0) {
+        // Unless the destination is full, in which case its write event resumes the pump, let the
+        // connection see the error itself.
+        keep_splicing = result.errno_ == SOCKET_ERROR_AGAIN;
+        break;
+      }
+      pipe.length_ -= result.return_value_;
+      bytes_written += result.return_value_;
+    }
+
+    if (bytes_read >= MaxBytesPerEvent) {
+      fileEvent(pipe.from_side_).activate(Event::FileReadyType::Read);
+      break;
+    }
+
+    // This also fails with EAGAIN when the pipe is full, which the next write makes room for.
+    const Api::SysCallSizeResult result =
+        os_sys_calls.splice(pipe.from_fd_, pipe.write_fd_, MaxBytesPerSplice);
+    if (result.return_value_ > 0) {
+      pipe.length_ += result.return_value_;
+      bytes_read += result.return_value_;
+    } else if (result.return_value_ == 0 || result.errno_ != SOCKET_ERROR_AGAIN) {
+      // The end of stream or an error, which the connection reads itself once splicing stops.
+      keep_splicing = false;
+      break;
+    } else if (pipe.length_ == 0) {
+      // The source is drained, its read event resumes the pump.
+      break;
+    }
+  }
+
+  if (bytes_read > 0) {
+    callbacks_.onSplicedBytesRead(pipe.from_side_, bytes_read);
+  }
+  if (bytes_written > 0) {
+    callbacks_.onSplicedBytesWritten(pipe.to_side_, bytes_written);
+  }
+  return keep_splicing;
+}
+
+void SpliceSession::stop() {
+  if (!active_) {
+    return;
+  }
+  active_ = false;
+  downstream_file_event_.reset();
+  upstream_file_event_.reset();
+
+  Buffer::OwnedImpl downstream_data;
+  Buffer::OwnedImpl upstream_data;
+  drain(downstream_to_upstream_, downstream_data);
+  drain(upstream_to_downstream_, upstream_data);
+  callbacks_.onSpliceStopped(downstream_data, upstream_data);
+
+  for (Network::Connection* connection :
+       {&downstream_to_upstream_.from_, &upstream_to_downstream_.from_}) {
+    if (connection->state() == Network::Connection::State::Open) {
+      connection->readDisable(false);
+    }
+  }
+}
+
+void SpliceSession::drain(Pipe& pipe, Buffer::Instance& data) {
+  if (pipe.length_ == 0) {
+    return;
+  }
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  Buffer::ReservationSingleSlice reservation = data.reserveSingleSlice(pipe.length_);
+  uint64_t length = 0;
+  while (length < pipe.length_) {
+    iovec iov;
+    iov.iov_base = static_cast<uint8_t*>(reservation.slice().mem_) + length;
+    iov.iov_len = pipe.length_ - length;
+    const Api::SysCallSizeResult result = os_sys_calls.readv(pipe.read_fd_, &iov, 1);
+    if (result.return_value_ <= 0) {
+      IS_ENVOY_BUG(absl::StrCat("cannot read the spliced bytes back from a pipe: ",
+                                errorDetails(result.errno_)));
+      break;
+    }
+    length += result.return_value_;
+  }
+  reservation.commit(length);
+  pipe.length_ = 0;
+}
+
+} // namespace TcpProxy
+} // namespace Envoy
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/common/platform.h"
+#include "envoy/event/deferred_deletable.h"
+#include "envoy/event/file_event.h"
+#include "envoy/network/connection.h"
+
+#include "source/common/common/logger.h"
+
+namespace Envoy {
+namespace TcpProxy {
+
+class SpliceSession;
+using SpliceSessionPtr = std::unique_ptr<SpliceSession>;
+
+/**
+ * Moves the bytes between the sockets of a downstream and an upstream connection with splice(),
+ * through a pipe per direction, so that they are never copied to user space. Both connections are
+ * read disabled while splicing, so they only see write events, which find their buffers empty.
+ * The pipes bound the bytes in flight: once one is full, its source socket is not read from until
+ * the destination socket drains it.
+ *
+ * Splicing stops when a socket reaches the end of stream or fails, or when stop() is called. The
+ * bytes left in the pipes are then handed to the callbacks, and the connections are read enabled
+ * again, so that they read the end of stream or the error themselves.
+ */
+class SpliceSession : public Event::DeferredDeletable, Logger::Loggable<Logger::Id::filter> {
+public:
+  enum class Side { Downstream, Upstream };
+
+  class Callbacks {
+  public:
+    virtual ~Callbacks() = default;
+
+    /**
+     * Called when bytes were read from the socket of a connection into its pipe.
+     * @param side supplies the connection the bytes were read from.
+     * @param bytes supplies the number of bytes.
+     */
+    virtual void onSplicedBytesRead(Side side, uint64_t bytes) PURE;
+
+    /**
+     * Called when bytes were written from a pipe to the socket of a connection.
+     * @param side supplies the connection the bytes were written to.
+     * @param bytes supplies the number of bytes.
+     */
+    virtual void onSplicedBytesWritten(Side side, uint64_t bytes) PURE;
+
+    /**
+     * Called once when splicing stops, before the connections are read enabled again. The session
+     * must not be destroyed from within this call.
+     * @param downstream_data supplies the bytes read from the downstream connection that were not
+     *        written to the upstream connection yet.
+     * @param upstream_data supplies the bytes read from the upstream connection that were not
+     *        written to the downstream connection yet.
+     */
+    virtual void onSpliceStopped(Buffer::Instance& downstream_data,
+                                 Buffer::Instance& upstream_data) PURE;
+  };
+
+  /**
+   * Starts splicing between two connections whose canSpliceSocket() returned true.
+   * @return the session, or nullptr if splicing is not available on this platform, in which case
+   *         the connections are left untouched.
+   */
+  static SpliceSessionPtr start(Network::Connection& downstream, Network::Connection& upstream,
+                                Callbacks& callbacks);
+
+  ~SpliceSession() override;
+
+  /**
+   * Stops splicing. Does nothing if splicing already stopped.
+   */
+  void stop();
+
+  bool active() const { return active_; }
+
+private:
+  // The pipe carrying the bytes read from one connection to the other.
+  struct Pipe {
+    Pipe(Network::Connection& from, Network::Connection& to, Side from_side);
+    ~Pipe();
+
+    Network::Connection& from_;
+    Network::Connection& to_;
+    const Side from_side_;
+    const Side to_side_;
+    const os_fd_t from_fd_;
+    const os_fd_t to_fd_;
+    os_fd_t read_fd_{INVALID_SOCKET};
+    os_fd_t write_fd_{INVALID_SOCKET};
+    // The number of bytes in the pipe.
+    uint64_t length_{};
+  };
+
+  SpliceSession(Network::Connection& downstream, Network::Connection& upstream,
+                Callbacks& callbacks);
+
+  // Creates the pipes and the file events. Returns false if splicing is not available.
+  bool initialize();
+  void onFileEvent(Side side, uint32_t events);
+  // Moves bytes through the pipe until its source or its destination would block. Returns false
+  // if splicing must stop.
+  bool pump(Pipe& pipe);
+  void drain(Pipe& pipe, Buffer::Instance& data);
+  Event::FileEvent& fileEvent(Side side) {
+    return side == Side::Downstream ? *downstream_file_event_ : *upstream_file_event_;
+  }
+
+  Callbacks& callbacks_;
+  Pipe downstream_to_upstream_;
+  Pipe upstream_to_downstream_;
+  Event::FileEventPtr downstream_file_event_;
+  Event::FileEventPtr upstream_file_event_;
+  bool active_{};
+};
+
+} // namespace TcpProxy
+} // namespace Envoy
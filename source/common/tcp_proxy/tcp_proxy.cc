@@ -225,7 +225,8 @@ Config::Config(const envoy::extensions::filters::network::tcp_proxy::v3::TcpProx
       drain_close_scope_(context.direction() == envoy::config::core::v3::TrafficDirection::INBOUND
                              ? Network::DrainDirection::InboundOnly
                              : Network::DrainDirection::All),
-      check_drain_close_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, check_drain_close, false)) {
+      check_drain_close_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, check_drain_close, false)),
+      splice_sockets_(config.splice_sockets()) {
   upstream_drain_manager_slot_->set([](Event::Dispatcher&) {
     ThreadLocal::ThreadLocalObjectSharedPtr drain_manager =
         std::make_shared<UpstreamDrainManager>();
@@ -933,6 +934,7 @@ void Filter::onGenericPoolReady(StreamInfo::StreamInfo* info,
   if (info) {
     upstream_info.setUpstreamFilterState(info->filterState());
   }
+  maybeStartSplice();
 } // namespace TcpProxy
 
 const Router::MetadataMatchCriteria* Filter::metadataMatchCriteria() {
@@ -1241,6 +1243,7 @@ void Filter::onDownstreamEvent(Network::ConnectionEvent event) {
         read_callbacks_->connection().dispatcher().timeSource());
     // Cancel the potential odcds callback.
     cluster_discovery_handle_ = nullptr;
+    stopSplice();
   }
 
   ENVOY_CONN_LOG(trace, "on downstream event {}, has upstream = {}", read_callbacks_->connection(),
@@ -1292,6 +1295,7 @@ void Filter::maybeCloseDownstreamForDrainClose() {
 
   ENVOY_CONN_LOG(debug, "drain closing tcp_proxy connection", read_callbacks_->connection());
   config_->stats().downstream_cx_drain_close_.inc();
+  stopSplice();
   read_callbacks_->connection().close(Network::ConnectionCloseType::FlushWrite,
                                       StreamInfo::LocalCloseReasons::get().TcpProxyDrainClose);
 }
@@ -1307,6 +1311,8 @@ void Filter::onUpstreamEvent(Network::ConnectionEvent event) {
 
   if (event == Network::ConnectionEvent::RemoteClose ||
       event == Network::ConnectionEvent::LocalClose) {
+    // Flush what is left in the pipes to the downstream connection before closing it.
+    stopSplice();
     // Propagate the upstream local close reason to the downstream stream info's upstreamInfo.
     if (upstream_) {
       getStreamInfo().upstreamInfo()->setUpstreamLocalCloseReason(upstream_->localCloseReason());
@@ -1428,6 +1434,75 @@ void Filter::onUpstreamConnection() {
   }
 }
 
+void Filter::maybeStartSplice() {
+  if (!config_->spliceSockets() || upstream_ == nullptr) {
+    return;
+  }
+  OptRef<Network::Connection> upstream_connection = upstream_->connection();
+  if (!upstream_connection.has_value() || !read_callbacks_->connection().canSpliceSocket() ||
+      !upstream_connection->canSpliceSocket()) {
+    return;
+  }
+
+  splice_ = SpliceSession::start(read_callbacks_->connection(), *upstream_connection, *this);
+  if (splice_ != nullptr) {
+    ENVOY_CONN_LOG(debug, "splicing the downstream and upstream sockets",
+                   read_callbacks_->connection());
+    config_->stats().downstream_cx_spliced_total_.inc();
+  }
+}
+
+void Filter::stopSplice() {
+  if (splice_ != nullptr) {
+    splice_->stop();
+  }
+}
+
+void Filter::onSplicedBytesRead(SpliceSession::Side side, uint64_t bytes) {
+  // The connections do not see the spliced bytes, so account for them as they would.
+  if (side == SpliceSession::Side::Downstream) {
+    getStreamInfo().getDownstreamBytesMeter()->addWireBytesReceived(bytes);
+    config_->stats().downstream_cx_rx_bytes_total_.add(bytes);
+  } else {
+    getStreamInfo().getUpstreamBytesMeter()->addWireBytesReceived(bytes);
+    read_callbacks_->upstreamHost()->cluster().trafficStats()->upstream_cx_rx_bytes_total_.add(
+        bytes);
+  }
+  resetIdleTimer();
+}
+
+void Filter::onSplicedBytesWritten(SpliceSession::Side side, uint64_t bytes) {
+  if (side == SpliceSession::Side::Downstream) {
+    getStreamInfo().getDownstreamBytesMeter()->addWireBytesSent(bytes);
+    config_->stats().downstream_cx_tx_bytes_total_.add(bytes);
+  } else {
+    getStreamInfo().getUpstreamBytesMeter()->addWireBytesSent(bytes);
+    read_callbacks_->upstreamHost()->cluster().trafficStats()->upstream_cx_tx_bytes_total_.add(
+        bytes);
+  }
+  resetIdleTimer();
+  maybeCloseDownstreamForDrainClose();
+}
+
+void Filter::onSpliceStopped(Buffer::Instance& downstream_data, Buffer::Instance& upstream_data) {
+  ENVOY_CONN_LOG(debug, "stopped splicing, {} bytes to upstream and {} bytes to downstream left",
+                 read_callbacks_->connection(), downstream_data.length(), upstream_data.length());
+  OptRef<Network::Connection> upstream_connection =
+      upstream_ != nullptr ? upstream_->connection() : OptRef<Network::Connection>();
+  if (downstream_data.length() > 0 && upstream_connection.has_value() &&
+      upstream_connection->state() == Network::Connection::State::Open) {
+    getStreamInfo().getUpstreamBytesMeter()->addWireBytesSent(downstream_data.length());
+    upstream_->encodeData(downstream_data, false);
+  }
+  if (upstream_data.length() > 0 &&
+      read_callbacks_->connection().state() == Network::Connection::State::Open) {
+    getStreamInfo().getDownstreamBytesMeter()->addWireBytesSent(upstream_data.length());
+    read_callbacks_->connection().write(upstream_data, false);
+  }
+  // This runs within the session, so it can only be destroyed later.
+  read_callbacks_->connection().dispatcher().deferredDelete(std::move(splice_));
+}
+
 void Filter::onIdleTimeout() {
   ENVOY_CONN_LOG(debug, "Session timed out", read_callbacks_->connection());
   config_->stats().idle_timeout_.inc();
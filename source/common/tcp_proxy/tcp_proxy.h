@@ -34,6 +34,7 @@
 #include "source/common/network/hash_policy.h"
 #include "source/common/network/utility.h"
 #include "source/common/stream_info/stream_info_impl.h"
+#include "source/common/tcp_proxy/splice.h"
 #include "source/common/tcp_proxy/upstream.h"
 #include "source/common/upstream/load_balancer_context_base.h"
 #include "source/common/upstream/od_cds_api_impl.h"
@@ -62,6 +63,7 @@ constexpr absl::string_view ReceiveBeforeConnectKey = "envoy.tcp_proxy.receive_b
   COUNTER(downstream_cx_drain_close)                                                               \
   COUNTER(downstream_cx_no_route)                                                                  \
   COUNTER(downstream_cx_rx_bytes_total)                                                            \
+  COUNTER(downstream_cx_spliced_total)                                                             \
   COUNTER(downstream_cx_total)                                                                     \
   COUNTER(downstream_cx_tx_bytes_total)                                                            \
   COUNTER(downstream_flow_control_paused_reading_total)                                            \
@@ -380,6 +382,7 @@ public:
 
   const std::optional<uint32_t>& maxEarlyDataBytes() const { return max_early_data_bytes_; }
   bool checkDrainClose() const { return check_drain_close_; }
+  bool spliceSockets() const { return splice_sockets_; }
   const Network::DrainDecision& drainDecision() const { return drain_decision_; }
   Network::DrainDirection drainCloseScope() const { return drain_close_scope_; }
 
@@ -441,6 +444,7 @@ private:
   const Network::DrainDecision& drain_decision_;
   const Network::DrainDirection drain_close_scope_{};
   const bool check_drain_close_{false};
+  const bool splice_sockets_{false};
 };
 
 using ConfigSharedPtr = std::shared_ptr<Config>;
@@ -467,7 +471,8 @@ private:
 class Filter : public Network::ReadFilter,
                public Upstream::LoadBalancerContextBase,
                protected Logger::Loggable<Logger::Id::filter>,
-               public GenericConnectionPoolCallbacks {
+               public GenericConnectionPoolCallbacks,
+               public SpliceSession::Callbacks {
 public:
   Filter(ConfigSharedPtr config, Upstream::ClusterManager& cluster_manager);
   ~Filter() override;
@@ -487,6 +492,11 @@ public:
                             absl::string_view failure_reason,
                             Upstream::HostDescriptionConstSharedPtr host) override;
 
+  // SpliceSession::Callbacks
+  void onSplicedBytesRead(SpliceSession::Side side, uint64_t bytes) override;
+  void onSplicedBytesWritten(SpliceSession::Side side, uint64_t bytes) override;
+  void onSpliceStopped(Buffer::Instance& downstream_data, Buffer::Instance& upstream_data) override;
+
   // Upstream::LoadBalancerContext
   const Router::MetadataMatchCriteria* metadataMatchCriteria() override;
   std::optional<uint64_t> computeHashKey() override {
@@ -702,6 +712,10 @@ protected:
   void onUpstreamEvent(Network::ConnectionEvent event);
   void maybeCloseDownstreamForDrainClose();
   void onUpstreamConnection();
+  // Starts splicing the sockets if enabled and both connections allow it.
+  void maybeStartSplice();
+  // Goes back to proxying the bytes through the filter if the sockets are being spliced.
+  void stopSplice();
   void onIdleTimeout();
   void resetIdleTimer();
   void disableIdleTimer();
@@ -737,6 +751,8 @@ protected:
   // The upstream handle (either TCP or HTTP). This is set in onGenericPoolReady and should persist
   // until either the upstream or downstream connection is terminated.
   std::unique_ptr<GenericUpstream> upstream_;
+  // Set while the downstream and upstream sockets are being spliced.
+  SpliceSessionPtr splice_;
   // The connection pool used to set up |upstream_|.
   // This will be non-null from when an upstream connection is attempted until
   // it either succeeds or fails.
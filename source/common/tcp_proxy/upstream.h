@@ -193,6 +193,7 @@ public:
   Ssl::ConnectionInfoConstSharedPtr getUpstreamConnectionSslInfo() override;
   StreamInfo::DetectedCloseType detectedCloseType() const override;
   absl::string_view localCloseReason() const override;
+  OptRef<Network::Connection> connection() override;
 
 private:
   Tcp::ConnectionPool::ConnectionDataPtr upstream_conn_data_;
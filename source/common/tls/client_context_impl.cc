@@ -115,6 +115,15 @@ ClientContextImpl::ClientContextImpl(
           nullptr);
     }
   }
+
+  // A certificate selector picks the client certificate per connection, which the key of the
+  // process-wide cache does not cover.
+  if (max_session_keys_ > 0 && tls_certificate_selector_ == nullptr) {
+    session_cache_ = SessionCache::get(factory_context.singletonManager());
+    if (session_cache_ != nullptr) {
+      session_cache_key_prefix_ = generateSessionCacheKeyPrefix();
+    }
+  }
 }
 
 absl::StatusOr<bssl::UniquePtr<SSL>>
@@ -139,17 +148,19 @@ ClientContextImpl::newSsl(const Network::TransportSocketOptionsConstSharedPtr& o
   }
 
   // BoringSSL does not expose the callback's original SNI key when it later
-  // returns a new session. Store Envoy's effective SNI on this SSL object so
-  // the new-session callback can cache the ticket under the same name that
-  // was sent in the ClientHello. An empty string is the valid cache key for
-  // connections that do not send SNI.
-  auto effective_sni = std::make_unique<std::string>(server_name_indication);
-  if (SSL_set_ex_data(ssl_con.get(), sslEffectiveSniIndex(), effective_sni.get()) != 1) {
+  // returns a new session. Store the cache key derived from Envoy's effective
+  // SNI on this SSL object so the new-session callback can cache the ticket
+  // under the same name that was sent in the ClientHello. An empty string is
+  // the valid cache key for connections that do not send SNI.
+  auto session_cache_key =
+      std::make_unique<std::string>(sessionCacheKey(server_name_indication, options));
+  const std::string* session_cache_key_ptr = session_cache_key.get();
+  if (SSL_set_ex_data(ssl_con.get(), sslSessionCacheKeyIndex(), session_cache_key.get()) != 1) {
     return absl::InvalidArgumentError(
         absl::StrCat("Failed to create upstream TLS due to failure storing SNI: ",
                      Utility::getLastCryptoError().value_or("unknown")));
   }
-  effective_sni.release();
+  session_cache_key.release();
 
   if (options && !options->verifySubjectAltNameListOverride().empty()) {
     SSL_set_verify(ssl_con.get(), SSL_VERIFY_PEER | SSL_VERIFY_FAIL_IF_NO_PEER_CERT, nullptr);
@@ -182,31 +193,37 @@ ClientContextImpl::newSsl(const Network::TransportSocketOptionsConstSharedPtr& o
   }
 
   if (max_session_keys_ > 0) {
-    if (scopeUpstreamTlsSessionCacheBySni()) {
-      setSessionForSni(ssl_con.get(), server_name_indication);
-    } else {
+    if (!scopeUpstreamTlsSessionCacheBySni()) {
       setSessionFromContextCache(ssl_con.get());
+    } else if (session_cache_ != nullptr) {
+      bssl::UniquePtr<SSL_SESSION> session =
+          session_cache_->lookup(SessionCache::Direction::Upstream, *session_cache_key_ptr);
+      if (session != nullptr) {
+        SSL_set_session(ssl_con.get(), session.get());
+      }
+    } else {
+      setSessionForSni(ssl_con.get(), server_name_indication);
     }
   }
 
   return ssl_con;
 }
 
-int ClientContextImpl::sslEffectiveSniIndex() {
+int ClientContextImpl::sslSessionCacheKeyIndex() {
   CONSTRUCT_ON_FIRST_USE(int, []() -> int {
     // BoringSSL ex-data is per-SSL application storage. Envoy installs the
-    // effective SNI string in newSsl() so the later new-session callback can
+    // session cache key in newSsl() so the later new-session callback can
     // recover the same cache key from the SSL*. The ex-data free callback owns
     // and deletes that string when BoringSSL frees the SSL object.
     // See BoringSSL API-CONVENTIONS.md, "ex_data", for this callback-state
     // pattern:
     // https://boringssl.googlesource.com/boringssl/+/HEAD/API-CONVENTIONS.md
-    int ssl_effective_sni_index = SSL_get_ex_new_index(
+    int ssl_session_cache_key_index = SSL_get_ex_new_index(
         0, nullptr, nullptr, nullptr, [](void*, void* ptr, CRYPTO_EX_DATA*, int, long, void*) {
           delete static_cast<std::string*>(ptr);
         });
-    RELEASE_ASSERT(ssl_effective_sni_index >= 0, "");
-    return ssl_effective_sni_index;
+    RELEASE_ASSERT(ssl_session_cache_key_index >= 0, "");
+    return ssl_session_cache_key_index;
   }());
 }
 
@@ -225,6 +242,47 @@ ClientContextImpl::effectiveSni(const Network::TransportSocketOptionsConstShared
   return server_name_indication_;
 }
 
+std::string ClientContextImpl::sessionCacheKey(
+    absl::string_view sni, const Network::TransportSocketOptionsConstSharedPtr& options) const {
+  if (session_cache_ == nullptr) {
+    return std::string(sni);
+  }
+  // The subject alt names verified instead of the configured ones are part of the key, so that a
+  // session is only resumed by the connections that would have accepted the same server.
+  std::string key = absl::StrCat(session_cache_key_prefix_, sni);
+  if (options) {
+    for (const std::string& san : options->verifySubjectAltNameListOverride()) {
+      absl::StrAppend(&key, absl::string_view("\0", 1), san);
+    }
+  }
+  return key;
+}
+
+std::string ClientContextImpl::generateSessionCacheKeyPrefix() {
+  uint8_t hash_buffer[EVP_MAX_MD_SIZE];
+  unsigned hash_length = 0;
+
+  bssl::ScopedEVP_MD_CTX md;
+  int rc = EVP_DigestInit(md.get(), EVP_sha256());
+  RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
+
+  // Hash the client certificate, which the server may have authenticated the session with, and
+  // the settings the server certificate was validated against. The contexts that share sessions in
+  // the process-wide cache then present the same identity and accept the same servers.
+  X509* cert = SSL_CTX_get0_certificate(tls_contexts_[0].ssl_ctx_.get());
+  if (cert != nullptr) {
+    rc = X509_digest(cert, EVP_sha256(), hash_buffer, &hash_length);
+    RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
+    rc = EVP_DigestUpdate(md.get(), hash_buffer, hash_length);
+    RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
+  }
+  cert_validator_->updateDigestForSessionId(md, hash_buffer, hash_length);
+
+  rc = EVP_DigestFinal(md.get(), hash_buffer, &hash_length);
+  RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
+  return {reinterpret_cast<const char*>(hash_buffer), hash_length};
+}
+
 void ClientContextImpl::setSessionForSni(SSL* ssl, absl::string_view sni) {
   absl::WriterMutexLock lock(session_keys_mu_);
   auto it = session_keys_by_sni_.find(sni);
@@ -285,15 +343,23 @@ int ClientContextImpl::newSessionKey(SSL* ssl, SSL_SESSION* session) {
     return 1; // Tell BoringSSL that we took ownership of the session.
   }
 
-  const auto* effective_sni =
-      static_cast<const std::string*>(SSL_get_ex_data(ssl, sslEffectiveSniIndex()));
-  if (effective_sni == nullptr) {
+  const auto* session_cache_key =
+      static_cast<const std::string*>(SSL_get_ex_data(ssl, sslSessionCacheKeyIndex()));
+  if (session_cache_key == nullptr) {
     SSL_SESSION_free(session);
     return 1;
   }
 
+  if (session_cache_ != nullptr) {
+    // max_session_keys_ bounds the sessions kept for each key of the process-wide cache, which
+    // bounds the total itself.
+    session_cache_->insert(SessionCache::Direction::Upstream, *session_cache_key,
+                           bssl::UniquePtr<SSL_SESSION>(session), max_session_keys_);
+    return 1; // Tell BoringSSL that we took ownership of the session.
+  }
+
   absl::WriterMutexLock lock(session_keys_mu_);
-  const std::string& sni = *effective_sni;
+  const std::string& sni = *session_cache_key;
   sni_session_keys_lru_.push_front({sni, bssl::UniquePtr<SSL_SESSION>(session)});
   auto it = session_keys_by_sni_.try_emplace(sni).first;
   it->second.sessions.push_front(sni_session_keys_lru_.begin());
@@ -23,6 +23,7 @@
 #include "source/common/tls/cert_validator/cert_validator.h"
 #include "source/common/tls/context_impl.h"
 #include "source/common/tls/context_manager_impl.h"
+#include "source/common/tls/session_cache.h"
 #include "source/common/tls/stats.h"
 
 #include "absl/container/flat_hash_map.h"
@@ -79,11 +80,16 @@ private:
     std::deque<SniSessionCacheList::iterator> sessions;
   };
 
-  static int sslEffectiveSniIndex();
+  static int sslSessionCacheKeyIndex();
 
   int newSessionKey(SSL* ssl, SSL_SESSION* session);
   std::string effectiveSni(const Network::TransportSocketOptionsConstSharedPtr& options,
                            Upstream::HostDescriptionConstSharedPtr host) const;
+  // The key the sessions of a connection are cached under: the SNI, prefixed and suffixed in the
+  // process-wide cache with the rest of what a session can be resumed with.
+  std::string sessionCacheKey(absl::string_view sni,
+                              const Network::TransportSocketOptionsConstSharedPtr& options) const;
+  std::string generateSessionCacheKeyPrefix();
   void setSessionForSni(SSL* ssl, absl::string_view sni);
   void setSessionFromContextCache(SSL* ssl);
   bool scopeUpstreamTlsSessionCacheBySni() const;
@@ -99,6 +105,9 @@ private:
   absl::flat_hash_map<std::string, SniSessionBucket>
       session_keys_by_sni_ ABSL_GUARDED_BY(session_keys_mu_);
   Ssl::UpstreamTlsCertificateSelectorPtr tls_certificate_selector_;
+  // Set when the sessions are kept in the process-wide cache rather than in the maps above.
+  SessionCacheSharedPtr session_cache_;
+  std::string session_cache_key_prefix_;
 };
 
 } // namespace Tls
@@ -62,6 +62,7 @@ public:
   const Network::Address::IpList& tlsKeyLogLocal() const override { return *tls_keylog_local_; };
   const Network::Address::IpList& tlsKeyLogRemote() const override { return *tls_keylog_remote_; };
   const std::string& tlsKeyLogPath() const override { return tls_keylog_path_; };
+  bool kernelTlsOffload() const override { return kernel_tls_offload_; }
   AccessLog::AccessLogManager& accessLogManager() const override {
     return factory_context_.serverFactoryContext().accessLogManager();
   }
@@ -134,6 +135,7 @@ private:
   const std::string tls_keylog_path_;
   std::unique_ptr<Network::Address::IpList> tls_keylog_local_;
   std::unique_ptr<Network::Address::IpList> tls_keylog_remote_;
+  const bool kernel_tls_offload_;
   const std::optional<
       envoy::extensions::transport_sockets::tls::v3::TlsParameters::CompliancePolicy>
       compliance_policy_;
@@ -0,0 +1,411 @@
+#include "source/common/tls/ktls.h"
+
+#include <cstring>
+
+#include "envoy/common/exception.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "openssl/digest.h"
+#include "openssl/hkdf.h"
+#include "openssl/mem.h"
+
+#if defined(__linux__) && !defined(ENVOY_SSL_OPENSSL)
+#include <linux/tls.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#define ENVOY_KERNEL_TLS 1
+
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+#endif
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+#ifdef ENVOY_KERNEL_TLS
+
+namespace {
+
+// TLS content types.
+constexpr uint8_t AlertRecord = 21;
+constexpr uint8_t HandshakeRecord = 22;
+
+// TLS handshake message types.
+constexpr uint8_t HelloRequest = 0;
+constexpr uint8_t NewSessionTicket = 4;
+constexpr uint8_t KeyUpdate = 24;
+
+constexpr uint8_t AlertLevelWarning = 1;
+constexpr uint8_t AlertCloseNotify = 0;
+
+// The largest plaintext of a record.
+constexpr size_t MaxRecordSize = 16384;
+constexpr size_t NonceSize = 12;
+
+absl::StatusOr<size_t> keySize(int cipher_nid) {
+  switch (cipher_nid) {
+  case NID_aes_128_gcm:
+    return 16;
+  case NID_aes_256_gcm:
+  case NID_chacha20_poly1305:
+    return 32;
+  default:
+    return absl::UnavailableError("unsupported cipher");
+  }
+}
+
+// HKDF-Expand-Label of RFC 8446 section 7.1, with an empty context.
+absl::StatusOr<std::vector<uint8_t>> hkdfExpandLabel(const EVP_MD* digest,
+                                                     absl::Span<const uint8_t> secret,
+                                                     absl::string_view label, size_t length) {
+  const std::string full_label = absl::StrCat("tls13 ", label);
+  std::vector<uint8_t> info;
+  info.reserve(4 + full_label.size());
+  info.push_back(length >> 8);
+  info.push_back(length & 0xff);
+  info.push_back(full_label.size());
+  info.insert(info.end(), full_label.begin(), full_label.end());
+  info.push_back(0);
+
+  std::vector<uint8_t> out(length);
+  if (!HKDF_expand(out.data(), out.size(), digest, secret.data(), secret.size(), info.data(),
+                   info.size())) {
+    return absl::InternalError("HKDF_expand failed");
+  }
+  return out;
+}
+
+absl::Status deriveTls13KeyAndIv(KernelTlsKeys& keys, size_t key_size) {
+  auto key = hkdfExpandLabel(keys.digest_, keys.secret_, "key", key_size);
+  RETURN_IF_NOT_OK(key.status());
+  auto iv = hkdfExpandLabel(keys.digest_, keys.secret_, "iv", NonceSize);
+  RETURN_IF_NOT_OK(iv.status());
+  keys.key_ = std::move(key.value());
+  keys.iv_ = std::move(iv.value());
+  return absl::OkStatus();
+}
+
+template <class CryptoInfo>
+size_t fillCryptoInfo(CryptoInfo& crypto_info, uint16_t cipher_type, const KernelTlsKeys& keys) {
+  uint8_t sequence[8];
+  for (int i = 0; i < 8; ++i) {
+    sequence[i] = keys.sequence_ >> (56 - 8 * i);
+  }
+  crypto_info.info.version = keys.version_;
+  crypto_info.info.cipher_type = cipher_type;
+  ASSERT(keys.key_.size() == sizeof(crypto_info.key));
+  memcpy(crypto_info.key, keys.key_.data(), sizeof(crypto_info.key));
+  memcpy(crypto_info.rec_seq, sequence, sizeof(crypto_info.rec_seq));
+  if (keys.iv_.size() == NonceSize) {
+    // The kernel concatenates the salt and the iv into the nonce, which it XORs with the sequence
+    // number.
+    memcpy(crypto_info.salt, keys.iv_.data(), sizeof(crypto_info.salt));
+    memcpy(crypto_info.iv, keys.iv_.data() + sizeof(crypto_info.salt), sizeof(crypto_info.iv));
+  } else {
+    // TLS 1.2 AES-GCM: the salt is the implicit nonce, and the iv the explicit nonce of the first
+    // record, which BoringSSL takes from the sequence number.
+    memcpy(crypto_info.salt, keys.iv_.data(), sizeof(crypto_info.salt));
+    memcpy(crypto_info.iv, sequence, sizeof(crypto_info.iv));
+  }
+  return sizeof(crypto_info);
+}
+
+absl::Status installKeys(os_fd_t fd, int direction, const KernelTlsKeys& keys) {
+  union {
+    tls12_crypto_info_aes_gcm_128 aes_gcm_128;
+    tls12_crypto_info_aes_gcm_256 aes_gcm_256;
+    tls12_crypto_info_chacha20_poly1305 chacha20_poly1305;
+  } crypto_info;
+  memset(&crypto_info, 0, sizeof(crypto_info));
+  size_t size = 0;
+  switch (keys.cipher_nid_) {
+  case NID_aes_128_gcm:
+    size = fillCryptoInfo(crypto_info.aes_gcm_128, TLS_CIPHER_AES_GCM_128, keys);
+    break;
+  case NID_aes_256_gcm:
+    size = fillCryptoInfo(crypto_info.aes_gcm_256, TLS_CIPHER_AES_GCM_256, keys);
+    break;
+  case NID_chacha20_poly1305:
+    size = fillCryptoInfo(crypto_info.chacha20_poly1305, TLS_CIPHER_CHACHA20_POLY1305, keys);
+    break;
+  default:
+    return absl::UnavailableError("unsupported cipher");
+  }
+  const Api::SysCallIntResult result =
+      Api::OsSysCallsSingleton::get().setsockopt(fd, SOL_TLS, direction, &crypto_info, size);
+  OPENSSL_cleanse(&crypto_info, sizeof(crypto_info));
+  if (result.return_value_ != 0) {
+    return absl::InternalError(absl::StrCat(direction == TLS_TX ? "setsockopt(TLS_TX): "
+                                                                : "setsockopt(TLS_RX): ",
+                                            errorDetails(result.errno_)));
+  }
+  return absl::OkStatus();
+}
+
+} // namespace
+
+absl::StatusOr<KernelTlsKeys> KernelTls::keys(SSL* ssl, bool write) {
+  KernelTlsKeys keys;
+  keys.version_ = SSL_version(ssl);
+  if (keys.version_ != TLS1_2_VERSION && keys.version_ != TLS1_3_VERSION) {
+    return absl::UnavailableError("unsupported protocol version");
+  }
+  const SSL_CIPHER* cipher = SSL_get_current_cipher(ssl);
+  if (cipher == nullptr) {
+    return absl::UnavailableError("no cipher negotiated");
+  }
+  keys.cipher_nid_ = SSL_CIPHER_get_cipher_nid(cipher);
+  const absl::StatusOr<size_t> key_size = keySize(keys.cipher_nid_);
+  RETURN_IF_NOT_OK(key_size.status());
+  keys.sequence_ = write ? SSL_get_write_sequence(ssl) : SSL_get_read_sequence(ssl);
+
+  if (keys.version_ == TLS1_3_VERSION) {
+    bssl::Span<const uint8_t> read_secret;
+    bssl::Span<const uint8_t> write_secret;
+    if (!bssl::SSL_get_traffic_secrets(ssl, &read_secret, &write_secret)) {
+      return absl::UnavailableError("no traffic secrets");
+    }
+    const bssl::Span<const uint8_t> secret = write ? write_secret : read_secret;
+    keys.secret_.assign(secret.begin(), secret.end());
+    keys.digest_ = SSL_CIPHER_get_handshake_digest(cipher);
+    RETURN_IF_NOT_OK(deriveTls13KeyAndIv(keys, key_size.value()));
+    return keys;
+  }
+
+  // The AEAD ciphers have no MAC keys, so the TLS 1.2 key block is made of the client and server
+  // write keys followed by the client and server write ivs.
+  const size_t iv_size = keys.cipher_nid_ == NID_chacha20_poly1305 ? NonceSize : 4;
+  std::vector<uint8_t> key_block(SSL_get_key_block_len(ssl));
+  if (key_block.size() != 2 * (key_size.value() + iv_size) ||
+      !SSL_generate_key_block(ssl, key_block.data(), key_block.size())) {
+    return absl::UnavailableError("unexpected key block");
+  }
+  // The client writes with the client keys, and the server reads with them.
+  const bool client_keys = write != static_cast<bool>(SSL_is_server(ssl));
+  const uint8_t* key = key_block.data() + (client_keys ? 0 : key_size.value());
+  const uint8_t* iv = key_block.data() + 2 * key_size.value() + (client_keys ? 0 : iv_size);
+  keys.key_.assign(key, key + key_size.value());
+  keys.iv_.assign(iv, iv + iv_size);
+  OPENSSL_cleanse(key_block.data(), key_block.size());
+  return keys;
+}
+
+absl::Status KernelTls::updateKeys(KernelTlsKeys& keys) {
+  ASSERT(keys.version_ == TLS1_3_VERSION);
+  auto secret =
+      hkdfExpandLabel(keys.digest_, keys.secret_, "traffic upd", EVP_MD_size(keys.digest_));
+  RETURN_IF_NOT_OK(secret.status());
+  keys.secret_ = std::move(secret.value());
+  keys.sequence_ = 0;
+  return deriveTls13KeyAndIv(keys, keys.key_.size());
+}
+
+absl::StatusOr<std::unique_ptr<KernelTls>> KernelTls::enable(SSL* ssl, os_fd_t fd,
+                                                             SslStats& stats) {
+  // BoringSSL only reads the records it needs, so this only happens if the peer sent data right
+  // behind its last handshake message.
+  if (SSL_pending(ssl) > 0 || SSL_has_pending(ssl)) {
+    return absl::UnavailableError("data received past the handshake");
+  }
+  auto read_keys = keys(ssl, /*write=*/false);
+  if (!read_keys.ok()) {
+    return absl::UnavailableError(read_keys.status().message());
+  }
+  auto write_keys = keys(ssl, /*write=*/true);
+  if (!write_keys.ok()) {
+    return absl::UnavailableError(write_keys.status().message());
+  }
+
+  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+  const Api::SysCallIntResult result = os_sys_calls.setsockopt(fd, IPPROTO_TCP, TCP_ULP, "tls", 3);
+  if (result.return_value_ != 0) {
+    return absl::UnavailableError(
+        absl::StrCat("setsockopt(TCP_ULP): ", errorDetails(result.errno_)));
+  }
+  // The socket carries plain TCP until keys are installed, so it is still usable if the first
+  // installation fails.
+  if (absl::Status status = installKeys(fd, TLS_TX, write_keys.value()); !status.ok()) {
+    return absl::UnavailableError(status.message());
+  }
+  RETURN_IF_NOT_OK(installKeys(fd, TLS_RX, read_keys.value()));
+  return std::unique_ptr<KernelTls>(
+      new KernelTls(fd, std::move(read_keys.value()), std::move(write_keys.value()), stats));
+}
+
+KernelTls::KernelTls(os_fd_t fd, KernelTlsKeys read_keys, KernelTlsKeys write_keys,
+                     SslStats& stats)
+    : fd_(fd), read_keys_(std::move(read_keys)), write_keys_(std::move(write_keys)),
+      stats_(stats) {}
+
+KernelTls::ControlRecordAction KernelTls::readControlRecord() {
+  std::vector<uint8_t> record(MaxRecordSize);
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(uint8_t))];
+  iovec iov{record.data(), record.size()};
+  msghdr message{};
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  const Api::SysCallSizeResult result =
+      Api::OsSysCallsSingleton::get().recvmsg(fd_, &message, 0);
+  if (result.return_value_ < 0) {
+    return fail(absl::StrCat("recvmsg: ", errorDetails(result.errno_)));
+  }
+  const cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+  if (cmsg == nullptr || cmsg->cmsg_level != SOL_TLS || cmsg->cmsg_type != TLS_GET_RECORD_TYPE) {
+    return fail("no record type");
+  }
+  const uint8_t type = *CMSG_DATA(cmsg);
+  const absl::Span<const uint8_t> payload(record.data(), result.return_value_);
+  switch (type) {
+  case AlertRecord:
+    return onAlert(payload);
+  case HandshakeRecord:
+    return onHandshakeMessages(payload);
+  default:
+    return fail(absl::StrCat("unexpected record type ", type));
+  }
+}
+
+KernelTls::ControlRecordAction KernelTls::onAlert(absl::Span<const uint8_t> payload) {
+  if (payload.size() != 2) {
+    return fail("malformed alert");
+  }
+  if (payload[1] == AlertCloseNotify) {
+    return ControlRecordAction::EndStream;
+  }
+  return fail(absl::StrCat("received alert ", payload[1]));
+}
+
+KernelTls::ControlRecordAction
+KernelTls::onHandshakeMessages(absl::Span<const uint8_t> payload) {
+  const bool tls13 = read_keys_.version_ == TLS1_3_VERSION;
+  while (!payload.empty()) {
+    if (payload.size() < 4) {
+      return fail("truncated handshake message");
+    }
+    const uint8_t type = payload[0];
+    const size_t length = (payload[1] << 16) | (payload[2] << 8) | payload[3];
+    if (payload.size() < 4 + length) {
+      return fail("handshake message split across records");
+    }
+    const absl::Span<const uint8_t> body = payload.subspan(4, length);
+    payload.remove_prefix(4 + length);
+
+    if (tls13 && type == NewSessionTicket) {
+      // The tickets cannot be handed back to BoringSSL.
+      ENVOY_LOG(trace, "kernel TLS dropped a session ticket");
+      continue;
+    }
+    if (tls13 && type == KeyUpdate && body.size() == 1 && body[0] <= 1) {
+      // A key update ends its record, so the next records use the new keys.
+      if (!payload.empty()) {
+        return fail("key update not at the end of its record");
+      }
+      return onKeyUpdate(body[0] == 1);
+    }
+    if (!tls13 && type == HelloRequest && body.empty()) {
+      // Renegotiation is not supported, and peers may ignore the requests.
+      continue;
+    }
+    return fail(absl::StrCat("unexpected handshake message ", type));
+  }
+  return ControlRecordAction::Continue;
+}
+
+KernelTls::ControlRecordAction KernelTls::onKeyUpdate(bool update_requested) {
+  if (absl::Status status = updateKeys(read_keys_); !status.ok()) {
+    return fail(status.message());
+  }
+  if (absl::Status status = installKeys(fd_, TLS_RX, read_keys_); !status.ok()) {
+    return fail(status.message());
+  }
+  stats_.kernel_tls_key_update_.inc();
+  if (!update_requested) {
+    return ControlRecordAction::Continue;
+  }
+
+  // Answer with a key update that does not request one in turn, sent with the current keys.
+  const uint8_t key_update[] = {KeyUpdate, 0, 0, 1, 0};
+  if (absl::Status status = sendRecord(HandshakeRecord, key_update); !status.ok()) {
+    return fail(status.message());
+  }
+  if (absl::Status status = updateKeys(write_keys_); !status.ok()) {
+    return fail(status.message());
+  }
+  if (absl::Status status = installKeys(fd_, TLS_TX, write_keys_); !status.ok()) {
+    return fail(status.message());
+  }
+  stats_.kernel_tls_key_update_.inc();
+  return ControlRecordAction::Continue;
+}
+
+void KernelTls::sendCloseNotify() {
+  const uint8_t alert[] = {AlertLevelWarning, AlertCloseNotify};
+  if (absl::Status status = sendRecord(AlertRecord, alert); !status.ok()) {
+    ENVOY_LOG(debug, "kernel TLS failed to send close_notify: {}", status.message());
+  }
+}
+
+absl::Status KernelTls::sendRecord(uint8_t type, absl::Span<const uint8_t> payload) {
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(uint8_t))];
+  memset(control, 0, sizeof(control));
+  iovec iov{const_cast<uint8_t*>(payload.data()), payload.size()};
+  msghdr message{};
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+  cmsg->cmsg_level = SOL_TLS;
+  cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(uint8_t));
+  *CMSG_DATA(cmsg) = type;
+  // The records are small enough to always fit in the socket buffer of an open connection.
+  const Api::SysCallSizeResult result = Api::OsSysCallsSingleton::get().sendmsg(fd_, &message, 0);
+  if (result.return_value_ != static_cast<ssize_t>(payload.size())) {
+    return absl::InternalError(absl::StrCat("sendmsg: ", errorDetails(result.errno_)));
+  }
+  return absl::OkStatus();
+}
+
+KernelTls::ControlRecordAction KernelTls::fail(absl::string_view reason) {
+  failure_reason_ = absl::StrCat("kernel_TLS_error:", reason);
+  return ControlRecordAction::Close;
+}
+
+#else // ENVOY_KERNEL_TLS
+
+absl::StatusOr<KernelTlsKeys> KernelTls::keys(SSL*, bool) {
+  return absl::UnavailableError("kernel TLS is not supported on this platform");
+}
+
+absl::Status KernelTls::updateKeys(KernelTlsKeys&) {
+  return absl::UnavailableError("kernel TLS is not supported on this platform");
+}
+
+absl::StatusOr<std::unique_ptr<KernelTls>> KernelTls::enable(SSL*, os_fd_t, SslStats&) {
+  return absl::UnavailableError("kernel TLS is not supported on this platform");
+}
+
+KernelTls::ControlRecordAction KernelTls::readControlRecord() { PANIC("not reached"); }
+
+void KernelTls::sendCloseNotify() { PANIC("not reached"); }
+
+#endif // ENVOY_KERNEL_TLS
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
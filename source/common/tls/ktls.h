@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/platform.h"
+
+#include "source/common/common/logger.h"
+#include "source/common/tls/stats.h"
+
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * The record protection keys of one direction of a TLS connection.
+ */
+struct KernelTlsKeys {
+  uint16_t version_{};
+  // NID_aes_128_gcm, NID_aes_256_gcm or NID_chacha20_poly1305.
+  int cipher_nid_{};
+  std::vector<uint8_t> key_;
+  // The 12 byte nonce of TLS 1.3 and of ChaCha20-Poly1305, or the 4 byte implicit nonce of
+  // TLS 1.2 AES-GCM.
+  std::vector<uint8_t> iv_;
+  // The sequence number of the next record.
+  uint64_t sequence_{};
+  // For TLS 1.3, the traffic secret of the key and iv, and its hash, for the key updates.
+  std::vector<uint8_t> secret_;
+  const EVP_MD* digest_{};
+};
+
+/**
+ * Offloads the record layer of a TLS connection to the Linux kernel TLS module (kTLS) once
+ * BoringSSL completed its handshake: the negotiated keys and sequence numbers are installed in the
+ * kernel for both directions, after which the application data is read and written with plain
+ * socket I/O. TLS 1.2 and TLS 1.3 with AES-GCM and ChaCha20-Poly1305 are supported.
+ *
+ * The kernel only processes the application data records. A read of the socket fails with EIO
+ * when the next record is of another type, which readControlRecord() then processes: alerts, TLS
+ * 1.3 key updates, for which the next keys are derived and installed, and TLS 1.3 session tickets,
+ * which are dropped.
+ */
+class KernelTls : protected Logger::Loggable<Logger::Id::connection> {
+public:
+  enum class ControlRecordAction { Continue, EndStream, Close };
+
+  /**
+   * Installs the keys of the connection in the kernel.
+   * @param ssl supplies the connection, whose handshake completed.
+   * @param fd supplies the socket of the connection.
+   * @param stats supplies the stats of the connection's context.
+   * @return the offloaded connection. Fails with absl::StatusCode::kUnavailable when the socket is
+   *         unchanged, and the connection carries on through BoringSSL. With any other code, the
+   *         connection cannot be used anymore.
+   */
+  static absl::StatusOr<std::unique_ptr<KernelTls>> enable(SSL* ssl, os_fd_t fd, SslStats& stats);
+
+  /**
+   * @param ssl supplies the connection, whose handshake completed.
+   * @param write supplies whether to return the keys that protect the sent records, rather than
+   *        the received ones.
+   * @return the current keys of one direction of the connection, or why they cannot be offloaded.
+   */
+  static absl::StatusOr<KernelTlsKeys> keys(SSL* ssl, bool write);
+
+  /**
+   * Replaces TLS 1.3 keys with the ones following a key update.
+   */
+  static absl::Status updateKeys(KernelTlsKeys& keys);
+
+  /**
+   * Reads and processes the record at the head of the socket, which is not application data.
+   * @return whether to carry on reading, or that the peer closed or failed the connection, in
+   *         which case failureReason() tells why.
+   */
+  ControlRecordAction readControlRecord();
+
+  /**
+   * Sends a close_notify alert. Errors are ignored, as when BoringSSL shuts down the connection.
+   */
+  void sendCloseNotify();
+
+  const std::string& failureReason() const { return failure_reason_; }
+
+private:
+  KernelTls(os_fd_t fd, KernelTlsKeys read_keys, KernelTlsKeys write_keys, SslStats& stats);
+
+  ControlRecordAction onAlert(absl::Span<const uint8_t> payload);
+  ControlRecordAction onHandshakeMessages(absl::Span<const uint8_t> payload);
+  ControlRecordAction onKeyUpdate(bool update_requested);
+  absl::Status sendRecord(uint8_t type, absl::Span<const uint8_t> payload);
+  ControlRecordAction fail(absl::string_view reason);
+
+  const os_fd_t fd_;
+  KernelTlsKeys read_keys_;
+  KernelTlsKeys write_keys_;
+  SslStats& stats_;
+  std::string failure_reason_;
+};
+
+using KernelTlsPtr = std::unique_ptr<KernelTls>;
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -32,6 +32,7 @@
 
 #include "absl/container/node_hash_set.h"
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "cert_validator/cert_validator.h"
 #include "openssl/evp.h"
@@ -143,6 +144,14 @@ ServerContextImpl::ServerContextImpl(
     session_id = *id_or_error;
   }
 
+  // The sessions are keyed by the session ID context, so they are only shared by the contexts that
+  // can resume them.
+  if (session_id && !config.disableStatefulSessionResumption() &&
+      !config.capabilities().handles_session_resumption) {
+    session_cache_ = SessionCache::get(factory_context.singletonManager());
+    session_id_context_.assign(session_id->begin(), session_id->end());
+  }
+
   for (uint32_t i = 0; i < tls_contexts_.size(); ++i) {
     auto& ctx = tls_contexts_[i];
     if (!config.capabilities().verifies_peer_certificates) {
@@ -186,6 +195,23 @@ ServerContextImpl::ServerContextImpl(
 
     if (config.disableStatefulSessionResumption()) {
       SSL_CTX_set_session_cache_mode(ctx.ssl_ctx_.get(), SSL_SESS_CACHE_OFF);
+    } else if (session_cache_ != nullptr) {
+      // Keep the sessions in the process-wide cache rather than in the one of the SSL_CTX, which
+      // goes away with this context.
+      SSL_CTX_set_session_cache_mode(ctx.ssl_ctx_.get(),
+                                     SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+      SSL_CTX_sess_set_new_cb(ctx.ssl_ctx_.get(), [](SSL* ssl, SSL_SESSION* session) -> int {
+        return static_cast<ServerContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)))
+            ->newSession(session);
+      });
+      SSL_CTX_sess_set_get_cb(
+          ctx.ssl_ctx_.get(),
+          [](SSL* ssl, const uint8_t* id, int id_len, int* out_copy) -> SSL_SESSION* {
+            // The session returned is a new reference.
+            *out_copy = 0;
+            return static_cast<ServerContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)))
+                ->getSession(id, id_len);
+          });
     }
 
     if (config.sessionTimeout() && !config.capabilities().handles_session_resumption) {
@@ -335,6 +361,24 @@ ServerContextImpl::generateHashForSessionContextId(const std::vector<std::string
   return session_id;
 }
 
+std::string ServerContextImpl::sessionCacheKey(const uint8_t* id, size_t id_len) const {
+  return absl::StrCat(session_id_context_,
+                      absl::string_view(reinterpret_cast<const char*>(id), id_len));
+}
+
+int ServerContextImpl::newSession(SSL_SESSION* session) {
+  unsigned id_len;
+  const uint8_t* id = SSL_SESSION_get_id(session, &id_len);
+  session_cache_->insert(SessionCache::Direction::Downstream, sessionCacheKey(id, id_len),
+                         bssl::UniquePtr<SSL_SESSION>(session), 1);
+  return 1; // Tell BoringSSL that we took ownership of the session.
+}
+
+SSL_SESSION* ServerContextImpl::getSession(const uint8_t* id, int id_len) {
+  return session_cache_->lookup(SessionCache::Direction::Downstream, sessionCacheKey(id, id_len))
+      .release();
+}
+
 int ServerContextImpl::sessionTicketProcess(SSL*, uint8_t* key_name, uint8_t* iv,
                                             EVP_CIPHER_CTX* ctx, HMAC_CTX* hmac_ctx, int encrypt) {
   const EVP_MD* hmac = EVP_sha256();
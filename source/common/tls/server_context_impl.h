@@ -25,6 +25,7 @@
 #include "source/common/tls/context_manager_impl.h"
 #include "source/common/tls/default_tls_certificate_selector.h"
 #include "source/common/tls/ocsp/ocsp.h"
+#include "source/common/tls/session_cache.h"
 #include "source/common/tls/stats.h"
 
 #include "absl/synchronization/mutex.h"
@@ -90,8 +91,17 @@ private:
   absl::StatusOr<SessionContextID>
   generateHashForSessionContextId(const std::vector<std::string>& server_names);
 
+  // Process-wide session cache callbacks.
+  std::string sessionCacheKey(const uint8_t* id, size_t id_len) const;
+  int newSession(SSL_SESSION* session);
+  SSL_SESSION* getSession(const uint8_t* id, int id_len);
+
   Ssl::TlsCertificateSelectorPtr tls_certificate_selector_;
   const std::vector<Envoy::Ssl::ServerContextConfig::SessionTicketKey> session_ticket_keys_;
+  // Set when the stateful sessions are kept in the process-wide cache, under keys prefixed by the
+  // session ID context.
+  SessionCacheSharedPtr session_cache_;
+  std::string session_id_context_;
 
 protected:
   const Ssl::ServerContextConfig::OcspStaplePolicy ocsp_staple_policy_;
@@ -0,0 +1,178 @@
+#include "source/common/tls/session_cache.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/hash.h"
+#include "source/common/protobuf/utility.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+SINGLETON_MANAGER_REGISTRATION(tls_session_cache);
+
+namespace {
+
+// The default size of the session cache of an SSL_CTX in BoringSSL.
+constexpr uint32_t DefaultMaxSessions = 20480;
+constexpr uint32_t MaxShards = 16;
+
+uint32_t maxSessions(const envoy::config::bootstrap::v3::Bootstrap::TlsSessionCache& config) {
+  return PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_sessions, DefaultMaxSessions);
+}
+
+} // namespace
+
+SessionCache::SessionCache(const envoy::config::bootstrap::v3::Bootstrap::TlsSessionCache& config,
+                           Stats::Scope& scope)
+    : stats_({ALL_TLS_SESSION_CACHE_STATS(POOL_COUNTER_PREFIX(scope, "tls_session_cache."),
+                                          POOL_GAUGE_PREFIX(scope, "tls_session_cache."))}),
+      persist_across_hot_restart_(config.persist_across_hot_restart()),
+      shards_(std::min(MaxShards, maxSessions(config))),
+      max_sessions_per_shard_((maxSessions(config) + shards_.size() - 1) / shards_.size()) {
+  if (persist_across_hot_restart_) {
+    import_ctx_.reset(SSL_CTX_new(TLS_method()));
+    RELEASE_ASSERT(import_ctx_ != nullptr, "");
+  }
+}
+
+std::shared_ptr<SessionCache>
+SessionCache::create(const envoy::config::bootstrap::v3::Bootstrap::TlsSessionCache& config,
+                     Singleton::Manager& singleton_manager, Stats::Scope& scope) {
+  return singleton_manager.getTyped<SessionCache>(
+      SINGLETON_MANAGER_REGISTERED_NAME(tls_session_cache),
+      [&config, &scope] { return std::make_shared<SessionCache>(config, scope); },
+      /*pin=*/true);
+}
+
+std::shared_ptr<SessionCache> SessionCache::get(Singleton::Manager& singleton_manager) {
+  return singleton_manager.getTyped<SessionCache>(
+      SINGLETON_MANAGER_REGISTERED_NAME(tls_session_cache));
+}
+
+std::string SessionCache::fullKey(Direction direction, absl::string_view key) {
+  // The server and the client keys are built differently, keep them apart.
+  return absl::StrCat(direction == Direction::Downstream ? "d" : "u", key);
+}
+
+SessionCache::Shard& SessionCache::shard(absl::string_view full_key) {
+  return shards_[HashUtil::xxHash64(full_key) % shards_.size()];
+}
+
+void SessionCache::insert(Direction direction, absl::string_view key,
+                          bssl::UniquePtr<SSL_SESSION> session, uint32_t max_sessions_per_key) {
+  insertEntry(fullKey(direction, key), std::move(session), max_sessions_per_key);
+}
+
+void SessionCache::insertEntry(std::string full_key, bssl::UniquePtr<SSL_SESSION> session,
+                               uint32_t max_sessions_per_key) {
+  ASSERT(max_sessions_per_key > 0);
+  Shard& shard = this->shard(full_key);
+  uint64_t evicted = 0;
+  {
+    absl::MutexLock lock(shard.mutex_);
+    shard.lru_.push_front({full_key, std::move(session)});
+    auto& sessions = shard.sessions_by_key_[std::move(full_key)];
+    sessions.push_front(shard.lru_.begin());
+    stats_.sessions_.inc();
+    while (sessions.size() > max_sessions_per_key) {
+      popOldest(shard, sessions);
+    }
+
+    while (shard.lru_.size() > max_sessions_per_shard_) {
+      auto bucket = shard.sessions_by_key_.find(shard.lru_.back().key);
+      ASSERT(bucket != shard.sessions_by_key_.end());
+      ASSERT(bucket->second.back() == std::prev(shard.lru_.end()));
+      popOldest(shard, bucket->second);
+      if (bucket->second.empty()) {
+        shard.sessions_by_key_.erase(bucket);
+      }
+      ++evicted;
+    }
+  }
+  stats_.evicted_.add(evicted);
+}
+
+void SessionCache::popOldest(Shard& shard, std::deque<EntryList::iterator>& sessions) {
+  shard.lru_.erase(sessions.back());
+  sessions.pop_back();
+  stats_.sessions_.dec();
+}
+
+bssl::UniquePtr<SSL_SESSION> SessionCache::lookup(Direction direction, absl::string_view key) {
+  const std::string full_key = fullKey(direction, key);
+  Shard& shard = this->shard(full_key);
+  bssl::UniquePtr<SSL_SESSION> session;
+  {
+    absl::MutexLock lock(shard.mutex_);
+    auto bucket = shard.sessions_by_key_.find(full_key);
+    if (bucket != shard.sessions_by_key_.end()) {
+      auto entry = bucket->second.front();
+      session = bssl::UpRef(entry->session);
+      if (SSL_SESSION_should_be_single_use(session.get())) {
+        shard.lru_.erase(entry);
+        bucket->second.pop_front();
+        stats_.sessions_.dec();
+        if (bucket->second.empty()) {
+          shard.sessions_by_key_.erase(bucket);
+        }
+      } else {
+        shard.lru_.splice(shard.lru_.begin(), shard.lru_, entry);
+      }
+    }
+  }
+
+  if (direction == Direction::Downstream) {
+    (session != nullptr ? stats_.downstream_hit_ : stats_.downstream_miss_).inc();
+  } else {
+    (session != nullptr ? stats_.upstream_hit_ : stats_.upstream_miss_).inc();
+  }
+  return session;
+}
+
+void SessionCache::exportSessions(const SessionCb& cb) {
+  for (Shard& shard : shards_) {
+    absl::MutexLock lock(shard.mutex_);
+    for (auto entry = shard.lru_.rbegin(); entry != shard.lru_.rend(); ++entry) {
+      uint8_t* data;
+      size_t length;
+      if (!SSL_SESSION_to_bytes(entry->session.get(), &data, &length)) {
+        continue;
+      }
+      cb(entry->key, absl::string_view(reinterpret_cast<const char*>(data), length));
+      OPENSSL_free(data);
+    }
+  }
+}
+
+bool SessionCache::importSession(absl::string_view key, absl::string_view session) {
+  ASSERT(import_ctx_ != nullptr);
+  bssl::UniquePtr<SSL_SESSION> parsed(SSL_SESSION_from_bytes(
+      reinterpret_cast<const uint8_t*>(session.data()), session.size(), import_ctx_.get()));
+  if (parsed == nullptr) {
+    return false;
+  }
+  // The exporting process already bounded the sessions of each key.
+  insertEntry(std::string(key), std::move(parsed), std::numeric_limits<uint32_t>::max());
+  stats_.imported_.inc();
+  return true;
+}
+
+size_t SessionCache::size() {
+  size_t size = 0;
+  for (Shard& shard : shards_) {
+    absl::MutexLock lock(shard.mutex_);
+    size += shard.lru_.size();
+  }
+  return size;
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
+#include "envoy/singleton/instance.h"
+#include "envoy/singleton/manager.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+#define ALL_TLS_SESSION_CACHE_STATS(COUNTER, GAUGE)                                                \
+  COUNTER(downstream_hit)                                                                          \
+  COUNTER(downstream_miss)                                                                         \
+  COUNTER(upstream_hit)                                                                            \
+  COUNTER(upstream_miss)                                                                           \
+  COUNTER(evicted)                                                                                 \
+  COUNTER(imported)                                                                                \
+  GAUGE(sessions, NeverImport)
+
+/**
+ * Wrapper struct for TLS session cache stats. @see stats_macros.h
+ */
+struct SessionCacheStats {
+  ALL_TLS_SESSION_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * Process-wide cache of the TLS sessions that the server and the client contexts can resume,
+ * configured by the bootstrap tls_session_cache. Unlike the session cache of an SSL_CTX, it
+ * outlives the contexts, so a context rebuilt on a configuration or a certificate update keeps
+ * resuming the sessions of the previous one, and the contexts with the same configuration share
+ * their sessions.
+ *
+ * The sessions are spread over shards by key, each with its own lock and least recently used
+ * list, so that the workers handshaking in parallel rarely contend. The callers make the keys
+ * unique to the configurations a session can be resumed with.
+ *
+ * Thread safe: the sessions are looked up and inserted from the BoringSSL callbacks on the
+ * workers.
+ */
+class SessionCache : public Singleton::Instance {
+public:
+  enum class Direction { Downstream, Upstream };
+
+  using SessionCb = std::function<void(absl::string_view key, absl::string_view session)>;
+
+  SessionCache(const envoy::config::bootstrap::v3::Bootstrap::TlsSessionCache& config,
+               Stats::Scope& scope);
+
+  /**
+   * Creates the process-wide cache and pins it in the singleton manager, where the contexts
+   * created afterwards find it.
+   */
+  static std::shared_ptr<SessionCache>
+  create(const envoy::config::bootstrap::v3::Bootstrap::TlsSessionCache& config,
+         Singleton::Manager& singleton_manager, Stats::Scope& scope);
+
+  /**
+   * @return the process-wide cache, or nullptr if the bootstrap does not configure one.
+   */
+  static std::shared_ptr<SessionCache> get(Singleton::Manager& singleton_manager);
+
+  /**
+   * Caches a session, as the most recently used one.
+   * @param direction supplies whether a server or a client context cached the session.
+   * @param key supplies the key to look the session up with.
+   * @param session supplies the session.
+   * @param max_sessions_per_key supplies the number of sessions kept under the key, beyond which
+   *        the oldest one is dropped.
+   */
+  void insert(Direction direction, absl::string_view key, bssl::UniquePtr<SSL_SESSION> session,
+              uint32_t max_sessions_per_key);
+
+  /**
+   * Looks up the most recently cached session under a key. A session that should be used once,
+   * such as a TLS 1.3 ticket, is removed from the cache.
+   * @return a new reference to the session, or nullptr if there is none.
+   */
+  bssl::UniquePtr<SSL_SESSION> lookup(Direction direction, absl::string_view key);
+
+  /**
+   * Calls the callback with the key and the serialized form of each session, from the least to
+   * the most recently used one of each shard, to hand them over to another process.
+   */
+  void exportSessions(const SessionCb& cb);
+
+  /**
+   * Caches a session exported by exportSessions(), as the most recently used one.
+   * @return false if the session cannot be parsed.
+   */
+  bool importSession(absl::string_view key, absl::string_view session);
+
+  bool persistAcrossHotRestart() const { return persist_across_hot_restart_; }
+
+  /**
+   * @return the number of sessions in the cache.
+   */
+  size_t size();
+
+private:
+  struct Entry {
+    std::string key;
+    bssl::UniquePtr<SSL_SESSION> session;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  struct Shard {
+    absl::Mutex mutex_;
+    // The most recently used session first.
+    EntryList lru_ ABSL_GUARDED_BY(mutex_);
+    // Iterators into lru_, the most recently inserted session first for each key. Only the first
+    // one is ever looked up, so the sessions of a key are in the same order in lru_.
+    absl::flat_hash_map<std::string, std::deque<EntryList::iterator>>
+        sessions_by_key_ ABSL_GUARDED_BY(mutex_);
+  };
+
+  static std::string fullKey(Direction direction, absl::string_view key);
+  Shard& shard(absl::string_view full_key);
+  void insertEntry(std::string full_key, bssl::UniquePtr<SSL_SESSION> session,
+                   uint32_t max_sessions_per_key);
+  // Removes the oldest session of a key.
+  void popOldest(Shard& shard, std::deque<EntryList::iterator>& sessions)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex_);
+
+  SessionCacheStats stats_;
+  const bool persist_across_hot_restart_;
+  std::vector<Shard> shards_;
+  const uint32_t max_sessions_per_shard_;
+  // Parses the imported sessions. Only set when the sessions persist across hot restart.
+  bssl::UniquePtr<SSL_CTX> import_ctx_;
+};
+
+using SessionCacheSharedPtr = std::shared_ptr<SessionCache>;
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
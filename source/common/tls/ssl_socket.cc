@@ -118,6 +118,13 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
     }
   }
 
+  if (kernel_tls_pending_ && !enableKernelTls()) {
+    return {PostIoAction::Close, 0, false};
+  }
+  if (kernel_tls_ != nullptr) {
+    return doKernelTlsRead(read_buffer);
+  }
+
   bool keep_reading = true;
   bool end_stream = false;
   PostIoAction action = PostIoAction::KeepOpen;
@@ -211,6 +218,9 @@ void SslSocket::onSuccess(SSL* ssl) {
     callbacks_->connection().readDisable(false);
   }
 
+  // The keys are installed on the next read or write rather than here, as the handshake may
+  // still have records to flush.
+  kernel_tls_pending_ = ctx_->kernelTlsOffload();
   callbacks_->raiseEvent(Network::ConnectionEvent::Connected);
 }
 
@@ -236,6 +246,105 @@ PostIoAction SslSocket::doHandshake() {
   return ret;
 }
 
+bool SslSocket::enableKernelTls() {
+  kernel_tls_pending_ = false;
+  absl::StatusOr<KernelTlsPtr> kernel_tls =
+      KernelTls::enable(rawSsl(), callbacks_->ioHandle().fdDoNotUse(), ctx_->stats());
+  if (kernel_tls.ok()) {
+    ENVOY_CONN_LOG(debug, "TLS records offloaded to the kernel", callbacks_->connection());
+    ctx_->stats().kernel_tls_offload_.inc();
+    kernel_tls_ = std::move(kernel_tls.value());
+    return true;
+  }
+  if (kernel_tls.status().code() == absl::StatusCode::kUnavailable) {
+    ENVOY_CONN_LOG(debug, "TLS records not offloaded to the kernel: {}", callbacks_->connection(),
+                   kernel_tls.status().message());
+    ctx_->stats().kernel_tls_fallback_.inc();
+    return true;
+  }
+  failure_reason_ = absl::StrCat("kernel_TLS_error:", kernel_tls.status().message());
+  ENVOY_CONN_LOG(debug, "{}", callbacks_->connection(), failure_reason_);
+  ctx_->stats().connection_error_.inc();
+  return false;
+}
+
+Network::IoResult SslSocket::doKernelTlsRead(Buffer::Instance& read_buffer) {
+  PostIoAction action = PostIoAction::KeepOpen;
+  uint64_t bytes_read = 0;
+  bool end_stream = false;
+  std::optional<Api::IoError::IoErrorCode> err = std::nullopt;
+  do {
+    Api::IoCallUint64Result result = callbacks_->ioHandle().read(read_buffer, std::nullopt);
+
+    if (result.ok()) {
+      ENVOY_CONN_LOG(trace, "kernel TLS read returns: {}", callbacks_->connection(),
+                     result.return_value_);
+      if (result.return_value_ == 0) {
+        // Non-graceful shutdown by closing the underlying socket.
+        end_stream = true;
+        break;
+      }
+      bytes_read += result.return_value_;
+      if (callbacks_->shouldDrainReadBuffer()) {
+        callbacks_->setTransportSocketIsReadable();
+        break;
+      }
+    } else if (result.err_->getSystemErrorCode() == EIO) {
+      // The next record is not application data.
+      const KernelTls::ControlRecordAction control_action = kernel_tls_->readControlRecord();
+      if (control_action == KernelTls::ControlRecordAction::Continue) {
+        continue;
+      }
+      if (control_action == KernelTls::ControlRecordAction::EndStream) {
+        // Graceful shutdown using close_notify TLS alert.
+        end_stream = true;
+      } else {
+        failure_reason_ = kernel_tls_->failureReason();
+        ENVOY_CONN_LOG(debug, "{}", callbacks_->connection(), failure_reason_);
+        ctx_->stats().connection_error_.inc();
+        action = PostIoAction::Close;
+      }
+      break;
+    } else {
+      ENVOY_CONN_LOG(trace, "kernel TLS read error: {}, code: {}", callbacks_->connection(),
+                     result.err_->getErrorDetails(), static_cast<int>(result.err_->getErrorCode()));
+      if (result.err_->getErrorCode() != Api::IoError::IoErrorCode::Again) {
+        action = PostIoAction::Close;
+        err = result.err_->getErrorCode();
+      }
+      break;
+    }
+  } while (true);
+
+  ENVOY_CONN_LOG(trace, "kernel TLS read {} bytes", callbacks_->connection(), bytes_read);
+  return {action, bytes_read, end_stream, err};
+}
+
+Network::IoResult SslSocket::doKernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream) {
+  uint64_t bytes_written = 0;
+  while (write_buffer.length() > 0) {
+    Api::IoCallUint64Result result = callbacks_->ioHandle().write(write_buffer);
+
+    if (result.ok()) {
+      ENVOY_CONN_LOG(trace, "kernel TLS write returns: {}", callbacks_->connection(),
+                     result.return_value_);
+      bytes_written += result.return_value_;
+    } else {
+      ENVOY_CONN_LOG(trace, "kernel TLS write error: {}, code: {}", callbacks_->connection(),
+                     result.err_->getErrorDetails(), static_cast<int>(result.err_->getErrorCode()));
+      if (result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again) {
+        return {PostIoAction::KeepOpen, bytes_written, false};
+      }
+      return {PostIoAction::Close, bytes_written, false, result.err_->getErrorCode()};
+    }
+  }
+
+  if (end_stream) {
+    shutdownSsl();
+  }
+  return {PostIoAction::KeepOpen, bytes_written, false};
+}
+
 void SslSocket::drainErrorQueue() {
   bool saw_error = false;
   bool saw_counted_error = false;
@@ -337,6 +446,13 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
     }
   }
 
+  if (kernel_tls_pending_ && !enableKernelTls()) {
+    return {PostIoAction::Close, 0, false};
+  }
+  if (kernel_tls_ != nullptr) {
+    return doKernelTlsWrite(write_buffer, end_stream);
+  }
+
   uint64_t bytes_to_write;
   if (bytes_to_retry_) {
     bytes_to_write = bytes_to_retry_;
@@ -397,6 +513,12 @@ void SslSocket::shutdownSsl() {
   ASSERT(info_->state() != Ssl::SocketState::HandshakeWaitingForConnectionData);
   if (info_->state() != Ssl::SocketState::ShutdownSent &&
       callbacks_->connection().state() != Network::Connection::State::Closed) {
+    if (kernel_tls_ != nullptr) {
+      // BoringSSL no longer owns the record layer.
+      kernel_tls_->sendCloseNotify();
+      info_->setState(Ssl::SocketState::ShutdownSent);
+      return;
+    }
     int rc = SSL_shutdown(rawSsl());
     if constexpr (Event::PlatformDefaultTriggerType == Event::FileTriggerType::EmulatedEdge) {
       // Windows operate under `EmulatedEdge`. These are level events that are artificially
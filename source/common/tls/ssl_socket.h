@@ -17,6 +17,7 @@
 #include "source/common/common/logger.h"
 #include "source/common/network/transport_socket_options_impl.h"
 #include "source/common/tls/context_impl.h"
+#include "source/common/tls/ktls.h"
 #include "source/common/tls/ssl_handshaker.h"
 #include "source/common/tls/utility.h"
 
@@ -66,6 +67,8 @@ public:
   Ssl::ConnectionInfoConstSharedPtr ssl() const override;
   bool startSecureTransport() override { return false; }
   void configureInitialCongestionWindow(uint64_t, std::chrono::microseconds) override {}
+  // The records of kernel TLS connections are encrypted by the kernel, sendfile() included.
+  bool sendsFileRanges() const override { return kernel_tls_ != nullptr; }
   // Ssl::PrivateKeyConnectionCallbacks
   void onPrivateKeyMethodComplete() override;
   // Ssl::HandshakeCallbacks
@@ -96,6 +99,9 @@ private:
   ReadResult sslReadIntoSlice(Buffer::RawSlice& slice);
 
   Network::PostIoAction doHandshake();
+  bool enableKernelTls();
+  Network::IoResult doKernelTlsRead(Buffer::Instance& read_buffer);
+  Network::IoResult doKernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream);
   void drainErrorQueue();
   void shutdownSsl();
   void shutdownBasic();
@@ -108,8 +114,11 @@ private:
   std::string failure_reason_;
   std::optional<Api::IoError::IoErrorCode> detected_io_error_;
   bool read_disabled_{false};
+  // Whether to offload the record layer to the kernel on the next read or write.
+  bool kernel_tls_pending_{false};
 
   SslHandshakerImplSharedPtr info_;
+  KernelTlsPtr kernel_tls_;
 };
 
 class InvalidSslSocket : public Network::TransportSocket {
@@ -33,6 +33,7 @@
 #include "source/common/http/http1/conn_pool.h"
 #include "source/common/http/http2/conn_pool.h"
 #include "source/common/http/mixed_conn_pool.h"
+#include "source/common/http/shared_conn_pool.h"
 #include "source/common/network/utility.h"
 #include "source/common/protobuf/utility.h"
 #include "source/common/router/shadow_writer_impl.h"
@@ -443,7 +444,12 @@ ClusterManagerImpl::initialize(const envoy::config::bootstrap::v3::Bootstrap& bo
   // Once the initial set of static bootstrap clusters are created (including the local cluster),
   // we can instantiate the thread local cluster manager.
   tls_.set([this, local_cluster_params](Event::Dispatcher& dispatcher) {
-    return std::make_shared<ThreadLocalClusterManagerImpl>(*this, dispatcher, local_cluster_params);
+    auto tls =
+        std::make_shared<ThreadLocalClusterManagerImpl>(*this, dispatcher, local_cluster_params);
+    if (&dispatcher != &dispatcher_) {
+      addSharedConnOwner(dispatcher, tls);
+    }
+    return tls;
   });
 
   const auto& dyn_resources = bootstrap.dynamic_resources();
@@ -1139,6 +1145,29 @@ void ClusterManagerImpl::postThreadLocalRemoveHosts(const Cluster& cluster,
   });
 }
 
+void ClusterManagerImpl::addSharedConnOwner(Event::Dispatcher& dispatcher,
+                                            std::weak_ptr<ThreadLocalClusterManagerImpl> tls) {
+  absl::MutexLock lock(shared_conn_owners_mutex_);
+  auto it = std::lower_bound(shared_conn_owners_.begin(), shared_conn_owners_.end(),
+                             dispatcher.name(), [](const SharedConnOwner& owner, const auto& name) {
+                               return owner.dispatcher_->name() < name;
+                             });
+  shared_conn_owners_.insert(it, SharedConnOwner{&dispatcher, std::move(tls)});
+}
+
+std::optional<ClusterManagerImpl::SharedConnOwner>
+ClusterManagerImpl::sharedConnOwner(const Host& host, uint32_t owners) {
+  // The owners are picked among the fixed number of workers rather than those registered so far,
+  // so that the hosts keep their owners while the workers start up.
+  const uint32_t workers = context_.options().concurrency();
+  absl::MutexLock lock(shared_conn_owners_mutex_);
+  if (workers == 0 || shared_conn_owners_.size() < workers || host.address() == nullptr) {
+    return std::nullopt;
+  }
+  const uint64_t hash = absl::Hash<absl::string_view>()(host.address()->asStringView());
+  return shared_conn_owners_[hash % std::min(owners, workers)];
+}
+
 bool ClusterManagerImpl::deferralIsSupportedForCluster(
     const ClusterInfoConstSharedPtr& info) const {
   if (!deferred_cluster_creation_) {
@@ -2027,7 +2056,8 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::~ClusterEntry()
 Http::ConnectionPool::Instance*
 ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::httpConnPoolImpl(
     HostConstSharedPtr host, ResourcePriority priority,
-    std::optional<Http::Protocol> downstream_protocol, LoadBalancerContext* context) {
+    std::optional<Http::Protocol> downstream_protocol, LoadBalancerContext* context,
+    bool allow_shared) {
   if (!host) {
     return nullptr;
   }
@@ -2073,18 +2103,68 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::httpConnPoolImp
     context->downstreamConnection()->hashKey(hash_key);
   }
 
+  // If configured, run the multiplexed streams on the connections of the owner worker of the host.
+  // The pools that are keyed on anything but the host and the protocols are never shared, as the
+  // owner would not find the same pool.
+  std::optional<SharedConnOwner> shared_owner;
+  if (allow_shared && cluster_info_->sharedUpstreamConnectionOwners() > 0 &&
+      upstream_options->empty() && !have_transport_socket_options &&
+      !cluster_info_->connectionPoolPerDownstreamConnection() &&
+      std::all_of(upstream_protocols.begin(), upstream_protocols.end(),
+                  [](Http::Protocol protocol) {
+                    return protocol == Http::Protocol::Http2 || protocol == Http::Protocol::Http3;
+                  })) {
+    shared_owner =
+        parent_.parent_.sharedConnOwner(*host, cluster_info_->sharedUpstreamConnectionOwners());
+    if (shared_owner.has_value() &&
+        shared_owner->dispatcher_ == &parent_.thread_local_dispatcher_) {
+      shared_owner.reset();
+    }
+  }
+
   ConnPoolsContainer& container = *parent_.getHttpConnPoolsContainer(host, true);
 
   // Note: to simplify this, we assume that the factory is only called in the scope of this
   // function. Otherwise, we'd need to capture a few of these variables by value.
   ConnPoolsContainer::ConnPools::PoolOptRef pool =
       container.pools_->getPool(priority, hash_key, [&]() {
-        auto pool = parent_.parent_.factory_.allocateConnPool(
-            parent_.thread_local_dispatcher_, host, priority, upstream_protocols,
-            alternate_protocol_options, !upstream_options->empty() ? upstream_options : nullptr,
-            have_transport_socket_options ? context->upstreamTransportSocketOptions() : nullptr,
-            parent_.parent_.time_source_, parent_.cluster_manager_state_, quic_info_,
-            parent_.getNetworkObserverRegistry());
+        Http::ConnectionPool::InstancePtr pool;
+        if (shared_owner.has_value()) {
+          pool = std::make_unique<Http::SharedConnPool>(
+              parent_.thread_local_dispatcher_, *shared_owner->dispatcher_,
+              [tls = shared_owner->tls_, name = cluster_info_->name(), host, priority,
+               downstream_protocol]() -> Http::ConnectionPool::Instance* {
+                // Runs on the owner, which looks up its own pool for the host.
+                std::shared_ptr<ThreadLocalClusterManagerImpl> owner = tls.lock();
+                if (owner == nullptr) {
+                  return nullptr;
+                }
+                auto cluster = owner->thread_local_clusters_.find(name);
+                if (cluster == owner->thread_local_clusters_.end()) {
+                  return nullptr;
+                }
+                return cluster->second->httpConnPoolImpl(host, priority, downstream_protocol,
+                                                         nullptr, false);
+              },
+              [this, host, priority, upstream_protocols,
+               alternate_protocol_options]() mutable -> Http::ConnectionPool::InstancePtr {
+                // Runs on this worker when the owner has yet to receive the cluster. The shared
+                // pool stops calling this once it drains, which it does before this entry goes.
+                return parent_.parent_.factory_.allocateConnPool(
+                    parent_.thread_local_dispatcher_, host, priority, upstream_protocols,
+                    alternate_protocol_options, nullptr, nullptr, parent_.parent_.time_source_,
+                    parent_.cluster_manager_state_, quic_info_,
+                    parent_.getNetworkObserverRegistry());
+              },
+              host, cluster_info_->maxPendingStreamHandoffs());
+        } else {
+          pool = parent_.parent_.factory_.allocateConnPool(
+              parent_.thread_local_dispatcher_, host, priority, upstream_protocols,
+              alternate_protocol_options, !upstream_options->empty() ? upstream_options : nullptr,
+              have_transport_socket_options ? context->upstreamTransportSocketOptions() : nullptr,
+              parent_.parent_.time_source_, parent_.cluster_manager_state_, quic_info_,
+              parent_.getNetworkObserverRegistry());
+        }
 
         pool->addIdleCallback([&parent = parent_, host, priority, hash_key]() {
           parent.httpConnPoolIsIdle(host, priority, hash_key);
@@ -43,6 +43,7 @@
 #include "source/common/upstream/upstream_impl.h"
 
 #include "absl/container/btree_map.h"
+#include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Upstream {
@@ -650,7 +651,7 @@ private:
       Http::ConnectionPool::Instance*
       httpConnPoolImpl(HostConstSharedPtr host, ResourcePriority priority,
                        std::optional<Http::Protocol> downstream_protocol,
-                       LoadBalancerContext* context);
+                       LoadBalancerContext* context, bool allow_shared = true);
 
       Tcp::ConnectionPool::Instance* tcpConnPoolImpl(HostConstSharedPtr host,
                                                      ResourcePriority priority,
@@ -936,11 +937,26 @@ private:
 
   bool deferralIsSupportedForCluster(const ClusterInfoConstSharedPtr& info) const;
 
+  // A worker that may hold the shared upstream connections of the other workers.
+  struct SharedConnOwner {
+    Event::Dispatcher* dispatcher_;
+    std::weak_ptr<ThreadLocalClusterManagerImpl> tls_;
+  };
+
+  void addSharedConnOwner(Event::Dispatcher& dispatcher,
+                          std::weak_ptr<ThreadLocalClusterManagerImpl> tls);
+  // Returns the worker that holds the shared connections to the host, among the given number of
+  // owners, or nullopt until all the workers have registered.
+  std::optional<SharedConnOwner> sharedConnOwner(const Host& host, uint32_t owners);
+
   Server::Configuration::ServerFactoryContext& context_;
   ClusterManagerFactory& factory_;
   Runtime::Loader& runtime_;
   Stats::Store& stats_;
   ThreadLocal::TypedSlot<ThreadLocalClusterManagerImpl> tls_;
+  // The workers, ordered by name so that they pick the same owners for the same hosts.
+  absl::Mutex shared_conn_owners_mutex_;
+  std::vector<SharedConnOwner> shared_conn_owners_ ABSL_GUARDED_BY(shared_conn_owners_mutex_);
   // Contains information about ongoing on-demand cluster discoveries.
   ClusterCreationsMap pending_cluster_creations_;
   Config::XdsManager& xds_manager_;
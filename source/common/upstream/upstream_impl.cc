@@ -448,6 +448,23 @@ createUpstreamLocalAddressSelector(
   return selector_or_error.value();
 }
 
+// Replaces partition with previous if they hold the same hosts.
+template <class HostVectorType>
+void keepUnchangedPartition(std::shared_ptr<const HostVectorType>& partition,
+                            const std::shared_ptr<const HostVectorType>& previous) {
+  if (previous != nullptr && *partition == *previous) {
+    partition = previous;
+  }
+}
+
+void keepUnchangedPartition(HostsPerLocalityConstSharedPtr& partition,
+                            const HostsPerLocalityConstSharedPtr& previous) {
+  if (previous != nullptr && partition->hasLocalLocality() == previous->hasLocalLocality() &&
+      partition->get() == previous->get()) {
+    partition = previous;
+  }
+}
+
 } // namespace
 
 // Allow disabling ALPN checks for transport sockets. See
@@ -929,6 +946,20 @@ HostSetImpl::partitionHosts(HostVectorConstSharedPtr hosts,
                            std::move(std::get<2>(healthy_degraded_excluded_hosts_per_locality)));
 }
 
+PrioritySet::UpdateHostsParams HostSetImpl::repartitionHosts(const HostSet& host_set) {
+  PrioritySet::UpdateHostsParams params =
+      partitionHosts(host_set.hostsPtr(), host_set.hostsPerLocalityPtr());
+  keepUnchangedPartition(params.healthy_hosts, host_set.healthyHostsPtr());
+  keepUnchangedPartition(params.degraded_hosts, host_set.degradedHostsPtr());
+  keepUnchangedPartition(params.excluded_hosts, host_set.excludedHostsPtr());
+  keepUnchangedPartition(params.healthy_hosts_per_locality, host_set.healthyHostsPerLocalityPtr());
+  keepUnchangedPartition(params.degraded_hosts_per_locality,
+                         host_set.degradedHostsPerLocalityPtr());
+  keepUnchangedPartition(params.excluded_hosts_per_locality,
+                         host_set.excludedHostsPerLocalityPtr());
+  return params;
+}
+
 const HostSet&
 PrioritySetImpl::getOrCreateHostSet(uint32_t priority, std::optional<bool> weighted_priority_health,
                                     std::optional<uint32_t> overprovisioning_factor) {
@@ -1242,6 +1273,12 @@ ClusterInfoImpl::ClusterInfoImpl(
           config.preconnect_policy(), per_upstream_preconnect_ratio, 1.0)),
       peekahead_ratio_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.preconnect_policy(),
                                                        predictive_preconnect_ratio, 0)),
+      adaptive_preconnect_config_(
+          config.preconnect_policy().has_adaptive_preconnect()
+              ? std::make_unique<
+                    envoy::config::cluster::v3::Cluster::PreconnectPolicy::AdaptivePreconnect>(
+                    config.preconnect_policy().adaptive_preconnect())
+              : nullptr),
       socket_matcher_(std::move(socket_matcher)), stats_scope_(std::move(stats_scope)),
       traffic_stats_(generateStats(
           stats_scope_, factory_context.serverFactoryContext().clusterManager().clusterStatNames(),
@@ -1327,6 +1364,13 @@ ClusterInfoImpl::ClusterInfoImpl(
             }
             return runtime_val;
           }())),
+      shared_upstream_connection_owners_(
+          config.has_shared_upstream_connections()
+              ? PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.shared_upstream_connections(),
+                                                owner_workers, 1)
+              : 0),
+      max_pending_stream_handoffs_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          config.shared_upstream_connections(), max_pending_handoffs, 1024)),
       type_(config.type()),
       drain_connections_on_host_removal_(config.ignore_health_on_host_removal()),
       connection_pool_per_downstream_connection_(
@@ -2006,16 +2050,26 @@ void ClusterImplBase::reloadHealthyHosts(const HostSharedPtr& host) {
   reloadHealthyHostsHelper(host);
 }
 
-void ClusterImplBase::reloadHealthyHostsHelper(const HostSharedPtr&) {
+void ClusterImplBase::reloadHealthyHostsHelper(const HostSharedPtr& host) {
+  const bool incremental =
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.incremental_host_health_updates");
   const auto& host_sets = prioritySet().hostSetsPerPriority();
   for (size_t priority = 0; priority < host_sets.size(); ++priority) {
     const auto& host_set = host_sets[priority];
-    // TODO(htuch): Can we skip these copies by exporting out const shared_ptr from HostSet?
-    HostVectorConstSharedPtr hosts_copy = std::make_shared<HostVector>(host_set->hosts());
-
-    HostsPerLocalityConstSharedPtr hosts_per_locality_copy = host_set->hostsPerLocality().clone();
-    prioritySet().updateHosts(priority,
-                              HostSetImpl::partitionHosts(hosts_copy, hosts_per_locality_copy),
+    if (!incremental) {
+      HostVectorConstSharedPtr hosts_copy = std::make_shared<HostVector>(host_set->hosts());
+      HostsPerLocalityConstSharedPtr hosts_per_locality_copy = host_set->hostsPerLocality().clone();
+      prioritySet().updateHosts(priority,
+                                HostSetImpl::partitionHosts(hosts_copy, hosts_per_locality_copy),
+                                host_set->localityWeights(), {}, {}, std::nullopt, std::nullopt);
+      continue;
+    }
+    // The health of a single host only affects the partitions of its own priority, so the other
+    // priorities are not pushed to the workers again.
+    if (host != nullptr && host->priority() != priority) {
+      continue;
+    }
+    prioritySet().updateHosts(priority, HostSetImpl::repartitionHosts(*host_set),
                               host_set->localityWeights(), {}, {}, std::nullopt, std::nullopt);
   }
 }
@@ -703,6 +703,12 @@ public:
   static PrioritySet::UpdateHostsParams updateHostsParams(const HostSet& host_set);
   static PrioritySet::UpdateHostsParams
   partitionHosts(HostVectorConstSharedPtr hosts, HostsPerLocalityConstSharedPtr hosts_per_locality);
+  /**
+   * Partitions the hosts of host_set again after health changes. The hosts and every partition
+   * whose hosts did not change keep their current snapshot, so that consumers such as the load
+   * balancers can tell by pointer which partitions they need to rebuild state for.
+   */
+  static PrioritySet::UpdateHostsParams repartitionHosts(const HostSet& host_set);
 
   void updateHosts(PrioritySet::UpdateHostsParams&& update_hosts_params,
                    LocalityWeightsConstSharedPtr locality_weights, const HostVector& hosts_added,
@@ -930,6 +936,13 @@ public:
 
   float perUpstreamPreconnectRatio() const override { return per_upstream_preconnect_ratio_; }
   float peekaheadRatio() const override { return peekahead_ratio_; }
+  OptRef<const envoy::config::cluster::v3::Cluster::PreconnectPolicy::AdaptivePreconnect>
+  adaptivePreconnectConfig() const override {
+    if (adaptive_preconnect_config_ == nullptr) {
+      return std::nullopt;
+    }
+    return *adaptive_preconnect_config_;
+  }
   uint32_t perConnectionBufferLimitBytes() const override {
     return per_connection_buffer_limit_bytes_;
   }
@@ -1027,6 +1040,10 @@ public:
   bool connectionPoolPerDownstreamConnection() const override {
     return connection_pool_per_downstream_connection_;
   }
+  uint32_t sharedUpstreamConnectionOwners() const override {
+    return shared_upstream_connection_owners_;
+  }
+  uint32_t maxPendingStreamHandoffs() const override { return max_pending_stream_handoffs_; }
   bool warmHosts() const override { return warm_hosts_; }
   bool setLocalInterfaceNameOnUpstreamConnections() const override {
     return set_local_interface_name_on_upstream_connections_;
@@ -1140,6 +1157,9 @@ private:
   OptionalTimeouts optional_timeouts_;
   const float per_upstream_preconnect_ratio_;
   const float peekahead_ratio_;
+  const std::unique_ptr<
+      const envoy::config::cluster::v3::Cluster::PreconnectPolicy::AdaptivePreconnect>
+      adaptive_preconnect_config_;
   TransportSocketMatcherPtr socket_matcher_;
   Stats::ScopeSharedPtr stats_scope_;
   mutable DeferredCreationCompatibleClusterTrafficStats traffic_stats_;
@@ -1188,6 +1208,8 @@ private:
   const std::chrono::milliseconds buffer_high_watermark_timeout_;
   const uint32_t max_response_headers_count_;
   const std::optional<uint16_t> max_response_headers_kb_;
+  const uint32_t shared_upstream_connection_owners_;
+  const uint32_t max_pending_stream_handoffs_;
   const envoy::config::cluster::v3::Cluster::DiscoveryType type_;
   const bool drain_connections_on_host_removal_ : 1;
   const bool connection_pool_per_downstream_connection_ : 1;
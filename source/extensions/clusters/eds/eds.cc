@@ -375,6 +375,11 @@ void EdsClusterImpl::reloadHealthyHostsHelper(const HostSharedPtr& host) {
       host_to_exclude->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC) &&
       host_to_exclude->healthFlagGet(Host::HealthFlag::PENDING_DYNAMIC_REMOVAL)) {
     // Empty for clarity.
+  } else if (Runtime::runtimeFeatureEnabled(
+                 "envoy.reloadable_features.incremental_host_health_updates")) {
+    // Nothing to remove, so only the partitions of the host's priority need to be updated.
+    ClusterImplBase::reloadHealthyHostsHelper(host);
+    return;
   } else {
     // Do not exclude and remove the host during the update.
     host_to_exclude = nullptr;
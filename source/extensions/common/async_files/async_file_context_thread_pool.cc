@@ -2,11 +2,15 @@
 
 #include <fcntl.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
 
+#include "envoy/common/exception.h"
+
 #include "source/common/buffer/buffer_impl.h"
+#include "source/common/buffer/file_fragment.h"
 #include "source/extensions/common/async_files/async_file_action.h"
 #include "source/extensions/common/async_files/async_file_context_base.h"
 #include "source/extensions/common/async_files/async_file_manager_thread_pool.h"
@@ -138,6 +142,42 @@ private:
   const size_t length_;
 };
 
+class ActionReadFileBacked
+    : public AsyncFileActionThreadPool<absl::StatusOr<Buffer::InstancePtr>> {
+public:
+  ActionReadFileBacked(AsyncFileHandle handle, off_t offset, size_t length,
+                       absl::AnyInvocable<void()> on_read_failure,
+                       absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete)
+      : AsyncFileActionThreadPool<absl::StatusOr<Buffer::InstancePtr>>(handle,
+                                                                       std::move(on_complete)),
+        offset_(offset), length_(length), on_read_failure_(std::move(on_read_failure)) {}
+
+  absl::StatusOr<Buffer::InstancePtr> executeImpl() override {
+    ASSERT(fileDescriptor() != -1);
+    struct stat stat_result;
+    auto stat_call = posix().fstat(fileDescriptor(), &stat_result);
+    if (stat_call.return_value_ != 0) {
+      return statusAfterFileError(stat_call);
+    }
+    auto result = std::make_unique<Buffer::OwnedImpl>();
+    // As with read, a range reaching past the end of the file is cut short.
+    const size_t length =
+        offset_ >= stat_result.st_size
+            ? 0
+            : std::min<size_t>(length_, static_cast<uint64_t>(stat_result.st_size - offset_));
+    if (length > 0) {
+      RETURN_IF_NOT_OK(Buffer::FileFragment::append(*result, fileDescriptor(), offset_, length,
+                                                    std::move(on_read_failure_)));
+    }
+    return result;
+  }
+
+private:
+  const off_t offset_;
+  const size_t length_;
+  absl::AnyInvocable<void()> on_read_failure_;
+};
+
 class ActionWriteFile : public AsyncFileActionThreadPool<absl::StatusOr<size_t>> {
 public:
   ActionWriteFile(AsyncFileHandle handle, Buffer::Instance& contents, off_t offset,
@@ -248,6 +288,15 @@ absl::StatusOr<CancelFunction> AsyncFileContextThreadPool::read(
                                                                           std::move(on_complete)));
 }
 
+absl::StatusOr<CancelFunction> AsyncFileContextThreadPool::readFileBacked(
+    Event::Dispatcher* dispatcher, off_t offset, size_t length,
+    absl::AnyInvocable<void()> on_read_failure,
+    absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) {
+  return checkFileAndEnqueue(dispatcher, std::make_unique<ActionReadFileBacked>(
+                                             handle(), offset, length, std::move(on_read_failure),
+                                             std::move(on_complete)));
+}
+
 absl::StatusOr<CancelFunction>
 AsyncFileContextThreadPool::write(Event::Dispatcher* dispatcher, Buffer::Instance& contents,
                                   off_t offset,
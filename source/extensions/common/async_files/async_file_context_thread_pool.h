@@ -36,6 +36,10 @@ public:
   absl::StatusOr<CancelFunction>
   read(Event::Dispatcher* dispatcher, off_t offset, size_t length,
        absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) override;
+  absl::StatusOr<CancelFunction> readFileBacked(
+      Event::Dispatcher* dispatcher, off_t offset, size_t length,
+      absl::AnyInvocable<void()> on_read_failure,
+      absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) override;
   absl::StatusOr<CancelFunction>
   write(Event::Dispatcher* dispatcher, Buffer::Instance& contents, off_t offset,
         absl::AnyInvocable<void(absl::StatusOr<size_t>)> on_complete) override;
@@ -52,6 +52,17 @@ public:
   read(Event::Dispatcher* dispatcher, off_t offset, size_t length,
        absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) PURE;
 
+  // Like read, but the buffer passed to on_complete references the range of the file rather than
+  // holding a copy of it: sockets send it with sendfile(), and it is only read into memory if
+  // something accesses its contents. The range is clamped to the size of the file. The file may
+  // be closed while the buffer is still in use, but it must not be truncated: if the contents are
+  // then read short, on_read_failure is called by the thread reading them, which must not modify
+  // the buffer from within the callback.
+  virtual absl::StatusOr<CancelFunction>
+  readFileBacked(Event::Dispatcher* dispatcher, off_t offset, size_t length,
+                 absl::AnyInvocable<void()> on_read_failure,
+                 absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) PURE;
+
   // Enqueues an action to write to the currently open file, at position offset, the bytes contained
   // by contents. It is an error to call write on an AsyncFileContext that does not have a file
   // open.
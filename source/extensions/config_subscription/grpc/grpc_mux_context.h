@@ -11,6 +11,7 @@
 #include "envoy/stats/scope.h"
 
 #include "source/common/config/utility.h"
+#include "source/extensions/config_subscription/grpc/resource_decode_pool.h"
 
 namespace Envoy {
 namespace Config {
@@ -34,6 +35,8 @@ struct GrpcMuxContext {
   // A factory method that allows a GrpcMux lazily create a Load-Stats-Reporter
   // if needed.
   std::function<std::unique_ptr<Upstream::LoadStatsReporter>()> load_stats_reporter_factory_;
+  // An optional pool that decodes the resources of discovery responses off the main thread.
+  ResourceDecodePoolSharedPtr resource_decode_pool_;
 };
 
 } // namespace Config
@@ -80,7 +80,8 @@ GrpcMuxImpl::GrpcMuxImpl(GrpcMuxContext& grpc_mux_context)
               [this](absl::string_view resource_type_url) {
                 onDynamicContextUpdate(resource_type_url);
                 return absl::OkStatus();
-              })) {
+              })),
+      resource_decode_pool_(std::move(grpc_mux_context.resource_decode_pool_)) {
   THROW_IF_NOT_OK(Config::Utility::checkLocalInfo("ads", local_info_));
   AllMuxes::get().insert(this);
 }
@@ -147,7 +148,10 @@ GrpcMuxImpl::createGrpcStreamObject(Grpc::RawAsyncClientSharedPtr&& async_client
           envoy::service::discovery::v3::DiscoveryResponse>::ConnectedStateValue::FirstEntry);
 }
 
-GrpcMuxImpl::~GrpcMuxImpl() { AllMuxes::get().erase(this); }
+GrpcMuxImpl::~GrpcMuxImpl() {
+  cancelPendingResponses();
+  AllMuxes::get().erase(this);
+}
 
 void GrpcMuxImpl::shutdownAll() { AllMuxes::get().shutdownAll(); }
 
@@ -374,11 +378,95 @@ void GrpcMuxImpl::onDiscoveryResponse(
     return;
   }
 
-  ApiState& api_state = apiStateFor(type_url);
-
   if (message->has_control_plane()) {
     control_plane_stats.identifier_.set(message->control_plane().identifier());
+  }
 
+  std::vector<ProtobufTypes::MessagePtr> parsed_resources;
+  if (resource_decode_pool_ == nullptr) {
+    processDiscoveryResponse(message, nullptr, parsed_resources);
+    return;
+  }
+
+  // The responses are processed in the order they were received, so this one waits for the ones
+  // whose resources are still being parsed, even if it has nothing to parse itself.
+  auto pending = std::make_shared<PendingResponse>();
+  pending->message_ = std::move(message);
+  const uint32_t num_jobs = parseResourcesInPool(pending);
+  if (num_jobs == 0 && pending_responses_.empty()) {
+    processDiscoveryResponse(pending->message_, pending->resource_decoder_.get(),
+                             pending->parsed_resources_);
+    return;
+  }
+  ENVOY_LOG(debug, "Parsing {} resources for {} in {} jobs", pending->message_->resources_size(),
+            type_url, num_jobs);
+  pending_responses_.push_back(std::move(pending));
+}
+
+uint32_t GrpcMuxImpl::parseResourcesInPool(const PendingResponseSharedPtr& pending) {
+  const envoy::service::discovery::v3::DiscoveryResponse& message = *pending->message_;
+  const ApiState& api_state = apiStateFor(message.type_url());
+  if (api_state.watches_.empty() || message.resources().empty()) {
+    return 0;
+  }
+  pending->resource_decoder_ = api_state.watches_.front()->resource_decoder_;
+  pending->parsed_resources_.resize(message.resources_size());
+
+  // Splits the resources into contiguous ranges, one per thread of the pool. Resources wrapped in
+  // a Resource, or of another type than the response, are decoded on the main thread.
+  const uint32_t num_resources = message.resources_size();
+  const uint32_t num_jobs = std::min(resource_decode_pool_->size(), num_resources);
+  pending->remaining_jobs_ = num_jobs;
+  for (uint32_t job = 0; job < num_jobs; ++job) {
+    const uint32_t begin = num_resources * job / num_jobs;
+    const uint32_t end = num_resources * (job + 1) / num_jobs;
+    resource_decode_pool_->post([this, pending, begin, end, &dispatcher = dispatcher_]() {
+      const envoy::service::discovery::v3::DiscoveryResponse& message = *pending->message_;
+      for (uint32_t i = begin; i < end; ++i) {
+        const Protobuf::Any& resource = message.resources(i);
+        if (resource.type_url() == message.type_url()) {
+          pending->parsed_resources_[i] = pending->resource_decoder_->parseResource(resource);
+        }
+      }
+      if (pending->remaining_jobs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        // The mux is only used on the main thread, where it cancels the response before it goes
+        // away.
+        dispatcher.post([this, pending]() {
+          if (!pending->cancelled_) {
+            processPendingResponses();
+          }
+        });
+      }
+    });
+  }
+  return num_jobs;
+}
+
+void GrpcMuxImpl::processPendingResponses() {
+  while (!pending_responses_.empty() &&
+         pending_responses_.front()->remaining_jobs_.load(std::memory_order_acquire) == 0) {
+    PendingResponseSharedPtr pending = std::move(pending_responses_.front());
+    pending_responses_.pop_front();
+    processDiscoveryResponse(pending->message_, pending->resource_decoder_.get(),
+                             pending->parsed_resources_);
+  }
+}
+
+void GrpcMuxImpl::cancelPendingResponses() {
+  for (const PendingResponseSharedPtr& pending : pending_responses_) {
+    pending->cancelled_ = true;
+  }
+  pending_responses_.clear();
+}
+
+void GrpcMuxImpl::processDiscoveryResponse(
+    const ResponseProtoPtr<envoy::service::discovery::v3::DiscoveryResponse>& message,
+    const OpaqueResourceDecoder* parsed_by,
+    std::vector<ProtobufTypes::MessagePtr>& parsed_resources) {
+  const std::string& type_url = message->type_url();
+  ApiState& api_state = apiStateFor(type_url);
+
+  if (message->has_control_plane()) {
     if (message->control_plane().identifier() != api_state.control_plane_identifier_) {
       api_state.control_plane_identifier_ = message->control_plane().identifier();
       ENVOY_LOG(debug, "Receiving gRPC updates for {} from {}", type_url,
@@ -413,8 +501,11 @@ void GrpcMuxImpl::onDiscoveryResponse(
   TRY_ASSERT_MAIN_THREAD {
     std::vector<DecodedResourcePtr> resources;
     OpaqueResourceDecoder& resource_decoder = *api_state.watches_.front()->resource_decoder_;
+    // The parsed resources are dropped if the watches changed while they were parsed.
+    const bool use_parsed_resources = parsed_by == &resource_decoder;
 
-    for (const auto& resource : message->resources()) {
+    for (int i = 0; i < message->resources_size(); ++i) {
+      const Protobuf::Any& resource = message->resources(i);
       // TODO(snowp): Check the underlying type when the resource is a Resource.
       if (!resource.Is<envoy::service::discovery::v3::Resource>() &&
           type_url != resource.type_url()) {
@@ -423,9 +514,18 @@ void GrpcMuxImpl::onDiscoveryResponse(
                         resource.type_url(), type_url, message->DebugString()));
       }
 
-      auto decoded_resource = THROW_OR_RETURN_VALUE(
-          DecodedResourceImpl::fromResource(resource_decoder, resource, message->version_info()),
-          DecodedResourceImplPtr);
+      DecodedResourceImplPtr decoded_resource;
+      if (use_parsed_resources && parsed_resources[i] != nullptr) {
+        resource_decoder.validateResource(*parsed_resources[i]);
+        const std::string name = resource_decoder.resourceName(*parsed_resources[i]);
+        decoded_resource = std::make_unique<DecodedResourceImpl>(
+            std::move(parsed_resources[i]), name, std::vector<std::string>{},
+            message->version_info());
+      } else {
+        decoded_resource = THROW_OR_RETURN_VALUE(
+            DecodedResourceImpl::fromResource(resource_decoder, resource, message->version_info()),
+            DecodedResourceImplPtr);
+      }
 
       if (!isHeartbeatResource(type_url, *decoded_resource)) {
         resources.emplace_back(std::move(decoded_resource));
@@ -568,6 +668,9 @@ void GrpcMuxImpl::processDiscoveryResources(const std::vector<DecodedResourcePtr
 void GrpcMuxImpl::onWriteable() { drainRequests(); }
 
 void GrpcMuxImpl::onStreamEstablished() {
+  // The responses of the previous stream are not acknowledged on the new one, which gets them
+  // again.
+  cancelPendingResponses();
   first_stream_request_ = true;
   grpc_stream_->maybeUpdateQueueSizeStat(0);
   clearNonce();
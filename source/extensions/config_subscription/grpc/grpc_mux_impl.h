@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <queue>
@@ -308,6 +309,34 @@ private:
   // Must be invoked from the main or test thread.
   void loadConfigFromDelegate(const std::string& type_url,
                               const absl::flat_hash_set<std::string>& resource_names);
+  // A DiscoveryResponse whose resources are being parsed by the resource decode pool.
+  struct PendingResponse {
+    ResponseProtoPtr<envoy::service::discovery::v3::DiscoveryResponse> message_;
+    // The decoder of the first watch of the type when the response was received.
+    OpaqueResourceDecoderSharedPtr resource_decoder_;
+    // Indexed like the resources of the message, null for the resources to decode on the main
+    // thread.
+    std::vector<ProtobufTypes::MessagePtr> parsed_resources_;
+    // The number of pool jobs that have not completed yet.
+    std::atomic<uint32_t> remaining_jobs_{};
+    // Set on the main thread when the mux no longer wants the response.
+    bool cancelled_{};
+  };
+  using PendingResponseSharedPtr = std::shared_ptr<PendingResponse>;
+
+  // Hands the resources of the response to the resource decode pool, and returns the number of
+  // jobs posted to it.
+  uint32_t parseResourcesInPool(const PendingResponseSharedPtr& pending);
+  // Processes the pending responses, in the order they were received, until the first one whose
+  // resources are still being parsed.
+  void processPendingResponses();
+  // Drops the pending responses, e.g. when the stream they were received on goes away.
+  void cancelPendingResponses();
+  // Must be invoked from the main or test thread.
+  void processDiscoveryResponse(
+      const ResponseProtoPtr<envoy::service::discovery::v3::DiscoveryResponse>& message,
+      const OpaqueResourceDecoder* parsed_by,
+      std::vector<ProtobufTypes::MessagePtr>& parsed_resources);
   // Must be invoked from the main or test thread.
   void processDiscoveryResources(const std::vector<DecodedResourcePtr>& resources,
                                  ApiState& api_state, const std::string& type_url,
@@ -350,6 +379,11 @@ private:
 
   Common::CallbackHandlePtr dynamic_update_callback_handle_;
 
+  // Set when the resources of the responses are parsed off the main thread.
+  ResourceDecodePoolSharedPtr resource_decode_pool_;
+  // The responses that are waiting for their resources to be parsed, or for an earlier response.
+  std::list<PendingResponseSharedPtr> pending_responses_;
+
   bool started_{false};
   // True iff Envoy is shutting down; no messages should be sent on the `grpc_stream_` when this is
   // true because it may contain dangling pointers.
@@ -7,6 +7,7 @@
 #include "source/extensions/config_subscription/grpc/grpc_mux_impl.h"
 #include "source/extensions/config_subscription/grpc/grpc_subscription_impl.h"
 #include "source/extensions/config_subscription/grpc/new_grpc_mux_impl.h"
+#include "source/extensions/config_subscription/grpc/resource_decode_pool.h"
 #include "source/extensions/config_subscription/grpc/xds_mux/grpc_mux_impl.h"
 
 namespace Envoy {
@@ -61,7 +62,10 @@ GrpcConfigSubscriptionFactory::create(ConfigSubscriptionFactory::SubscriptionDat
       /*target_xds_authority_=*/control_plane_id,
       /*eds_resources_cache_=*/nullptr, // EDS cache is only used for ADS.
       /*skip_subsequent_node_=*/api_config_source.set_node_on_first_message_only(),
-      /*load_stats_reporter_factory_=*/lrs_factory};
+      /*load_stats_reporter_factory_=*/lrs_factory,
+      /*resource_decode_pool_=*/api_config_source.offload_resource_decoding()
+          ? ResourceDecodePool::get(data.api_.threadFactory())
+          : nullptr};
 
   if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.unified_mux")) {
     mux = std::make_shared<Config::XdsMux::GrpcMuxSotw>(grpc_mux_context);
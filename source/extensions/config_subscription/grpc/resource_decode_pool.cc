@@ -0,0 +1,86 @@
+#include "source/extensions/config_subscription/grpc/resource_decode_pool.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "source/common/singleton/threadsafe_singleton.h"
+
+namespace Envoy {
+namespace Config {
+
+namespace {
+// Parsing is memory bound, so a few threads take most of the load off the main thread without
+// competing with the workers for every core.
+constexpr uint32_t MaxThreads = 4;
+
+class SharedPoolState {
+public:
+  ResourceDecodePoolSharedPtr get(Thread::ThreadFactory& thread_factory) {
+    absl::MutexLock lock(mu_);
+    ResourceDecodePoolSharedPtr pool = pool_.lock();
+    if (pool == nullptr) {
+      pool = std::make_shared<ResourceDecodePool>(
+          thread_factory, std::clamp(std::thread::hardware_concurrency(), 1U, MaxThreads));
+      pool_ = pool;
+    }
+    return pool;
+  }
+
+private:
+  absl::Mutex mu_;
+  std::weak_ptr<ResourceDecodePool> pool_ ABSL_GUARDED_BY(mu_);
+};
+using SharedPool = ThreadSafeSingleton<SharedPoolState>;
+} // namespace
+
+ResourceDecodePool::ResourceDecodePool(Thread::ThreadFactory& thread_factory,
+                                       uint32_t num_threads) {
+  ASSERT(num_threads > 0);
+  threads_.reserve(num_threads);
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads_.push_back(thread_factory.createThread([this]() { work(); },
+                                                   Thread::Options{"xds_decode"}));
+  }
+}
+
+ResourceDecodePool::~ResourceDecodePool() {
+  {
+    absl::MutexLock lock(mu_);
+    terminating_ = true;
+  }
+  for (Thread::ThreadPtr& thread : threads_) {
+    thread->join();
+  }
+}
+
+ResourceDecodePoolSharedPtr ResourceDecodePool::get(Thread::ThreadFactory& thread_factory) {
+  return SharedPool::get().get(thread_factory);
+}
+
+void ResourceDecodePool::post(Job job) {
+  absl::MutexLock lock(mu_);
+  ASSERT(!terminating_);
+  jobs_.push(std::move(job));
+}
+
+void ResourceDecodePool::work() {
+  while (true) {
+    Job job;
+    {
+      absl::MutexLock lock(mu_);
+      auto ready = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        return terminating_ || !jobs_.empty();
+      };
+      mu_.Await(absl::Condition(&ready));
+      if (terminating_) {
+        return;
+      }
+      job = std::move(jobs_.front());
+      jobs_.pop();
+    }
+    job();
+  }
+}
+
+} // namespace Config
+} // namespace Envoy
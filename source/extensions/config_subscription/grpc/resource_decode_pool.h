@@ -0,0 +1,69 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <queue>
+#include <vector>
+
+#include "envoy/thread/thread.h"
+
+#include "source/common/common/logger.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Config {
+
+class ResourceDecodePool;
+using ResourceDecodePoolSharedPtr = std::shared_ptr<ResourceDecodePool>;
+
+/**
+ * A pool of threads that parse the resources of large discovery responses off the main thread,
+ * see ApiConfigSource.offload_resource_decoding. The pool is shared by all the gRPC muxes that
+ * use it: it is created with the first one and destroyed with the last one.
+ *
+ * The class is final, as the threads may still be running during the destructor, which is fine so
+ * long as no class members or vtable entries have yet been destroyed.
+ */
+class ResourceDecodePool final : public Logger::Loggable<Logger::Id::config> {
+public:
+  using Job = std::function<void()>;
+
+  ResourceDecodePool(Thread::ThreadFactory& thread_factory, uint32_t num_threads);
+
+  /**
+   * The destructor blocks until the jobs that are already running complete. Queued jobs that did
+   * not start are dropped.
+   */
+  ~ResourceDecodePool();
+
+  /**
+   * @return the pool shared by the gRPC muxes, creating it if there is none.
+   */
+  static ResourceDecodePoolSharedPtr get(Thread::ThreadFactory& thread_factory);
+
+  /**
+   * Runs the job on one of the threads of the pool. The job must be thread safe.
+   */
+  void post(Job job);
+
+  /**
+   * @return the number of threads of the pool.
+   */
+  uint32_t size() const { return threads_.size(); }
+
+private:
+  void work();
+
+  absl::Mutex mu_;
+  std::queue<Job> jobs_ ABSL_GUARDED_BY(mu_);
+  bool terminating_ ABSL_GUARDED_BY(mu_) = false;
+
+  // It is important that threads_ be last, as the threads run with 'this' and may access any
+  // other members.
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
+} // namespace Config
+} // namespace Envoy
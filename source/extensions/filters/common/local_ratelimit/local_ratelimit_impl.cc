@@ -1,8 +1,11 @@
 #include "source/extensions/filters/common/local_ratelimit/local_ratelimit_impl.h"
 
+#include <algorithm>
+#include <bit>
 #include <chrono>
 #include <cmath>
 #include <memory>
+#include <thread>
 
 #include "envoy/runtime/runtime.h"
 
@@ -17,6 +20,50 @@ namespace LocalRateLimit {
 
 SINGLETON_MANAGER_REGISTRATION(local_ratelimit_share_provider_manager);
 
+namespace {
+
+// The leases of a token bucket take at most this fraction of its tokens.
+constexpr uint64_t LeasedTokensDivisor = 16;
+// Buckets whose leases would hold fewer tokens do not lease.
+constexpr uint64_t MinLeaseSize = 4;
+// The dynamic descriptor caches use one shard per this many descriptors, up to MaxDescriptorShards.
+constexpr uint32_t DescriptorsPerShard = 64;
+constexpr uint32_t MaxDescriptorShards = 16;
+
+// One lease per core, so that the workers rarely share one.
+uint32_t leaseCount() {
+  static const uint32_t count =
+      std::bit_ceil(std::clamp(std::thread::hardware_concurrency(), 1u, 64u));
+  return count;
+}
+
+uint32_t threadIndex() {
+  static std::atomic<uint32_t> next_thread_index{0};
+  thread_local const uint32_t thread_index =
+      next_thread_index.fetch_add(1, std::memory_order_relaxed);
+  return thread_index;
+}
+
+uint64_t leaseSize(uint64_t max_tokens, bool lease_tokens) {
+  if (!lease_tokens) {
+    return 0;
+  }
+  const uint64_t lease_size = max_tokens / (leaseCount() * LeasedTokensDivisor);
+  return lease_size < MinLeaseSize ? 0 : lease_size;
+}
+
+bool takeToken(std::atomic<uint64_t>& tokens) {
+  uint64_t current = tokens.load(std::memory_order_relaxed);
+  while (current > 0) {
+    if (tokens.compare_exchange_weak(current, current - 1, std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
 class DefaultEvenShareMonitor : public ShareProviderManager::ShareMonitor {
 public:
   double getTokensShareFactor() const override { return share_factor_.load(); }
@@ -76,17 +123,65 @@ ShareProviderManagerSharedPtr ShareProviderManager::singleton(Event::Dispatcher&
 
 RateLimitTokenBucket::RateLimitTokenBucket(uint64_t max_tokens, uint64_t tokens_per_fill,
                                            std::chrono::milliseconds fill_interval,
-                                           TimeSource& time_source, bool shadow_mode)
-    : token_bucket_(max_tokens, time_source,
+                                           TimeSource& time_source, bool shadow_mode,
+                                           bool lease_tokens)
+    : max_tokens_(max_tokens), lease_count_(leaseCount()),
+      lease_size_(leaseSize(max_tokens, lease_tokens)),
+      token_bucket_(max_tokens - lease_count_ * lease_size_, time_source,
                     // Calculate the fill rate in tokens per second.
                     tokens_per_fill / std::chrono::duration<double>(fill_interval).count()),
-      fill_interval_(fill_interval), shadow_mode_(shadow_mode) {}
+      fill_interval_(fill_interval), shadow_mode_(shadow_mode) {
+  if (lease_size_ > 0) {
+    // Start with full leases, so that the initial burst is max_tokens as without leasing.
+    leases_ = std::make_unique<Lease[]>(lease_count_);
+    for (uint32_t i = 0; i < lease_count_; ++i) {
+      leases_[i].tokens_.store(lease_size_, std::memory_order_relaxed);
+    }
+  }
+}
+
 bool RateLimitTokenBucket::consume(double factor, uint64_t to_consume) {
   ASSERT(!(factor <= 0.0 || factor > 1.0));
+  // The leases hold whole tokens, so only the requests for a single unscaled token use them.
+  if (lease_size_ > 0 && factor == 1.0 && to_consume == 1) {
+    return consumeLeased();
+  }
   auto cb = [tokens = to_consume / factor](double total) { return total < tokens ? 0.0 : tokens; };
   return token_bucket_.consume(cb) != 0.0;
 }
 
+bool RateLimitTokenBucket::consumeLeased() {
+  const uint32_t mask = lease_count_ - 1;
+  const uint32_t own = threadIndex() & mask;
+  if (takeToken(leases_[own].tokens_)) {
+    return true;
+  }
+  // Take a token for this request and a new lease in a single update of the shared bucket. Two
+  // threads sharing the lease may both renew it, which only holds back a few more tokens.
+  const uint64_t taken = token_bucket_.consume(1 + lease_size_, /*allow_partial=*/true);
+  if (taken > 0) {
+    leases_[own].tokens_.fetch_add(taken - 1, std::memory_order_relaxed);
+    return true;
+  }
+  // The shared bucket is empty: take over the tokens left in the leases of the other workers.
+  for (uint32_t i = 1; i <= mask; ++i) {
+    if (takeToken(leases_[(own + i) & mask].tokens_)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+uint64_t RateLimitTokenBucket::remainingTokens() const {
+  uint64_t remaining = static_cast<uint64_t>(token_bucket_.remainingTokens());
+  if (leases_ != nullptr) {
+    for (uint32_t i = 0; i < lease_count_; ++i) {
+      remaining += leases_[i].tokens_.load(std::memory_order_relaxed);
+    }
+  }
+  return remaining;
+}
+
 void RateLimitTokenBucket::refill(uint64_t tokens) {
   if (tokens == 0) {
     return;
@@ -109,7 +204,7 @@ LocalRateLimiterImpl::LocalRateLimiterImpl(
     const Protobuf::RepeatedPtrField<
         envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor>& descriptors,
     bool always_consume_default_token_bucket, ShareProviderSharedPtr shared_provider,
-    uint32_t lru_size)
+    uint32_t lru_size, bool lease_tokens)
     : time_source_(dispatcher.timeSource()), share_provider_(std::move(shared_provider)),
       always_consume_default_token_bucket_(always_consume_default_token_bucket) {
   // Ignore the default token bucket if fill_interval is 0 because 0 fill_interval means nothing
@@ -123,7 +218,7 @@ LocalRateLimiterImpl::LocalRateLimiterImpl(
         throw EnvoyException("local rate limit token bucket fill timer must be >= 50ms");
       }
       default_token_bucket_ = std::make_shared<RateLimitTokenBucket>(
-          max_tokens, tokens_per_fill, fill_interval, time_source_, false);
+          max_tokens, tokens_per_fill, fill_interval, time_source_, false, lease_tokens);
     }
   }
 
@@ -163,7 +258,7 @@ LocalRateLimiterImpl::LocalRateLimiterImpl(
     RateLimitTokenBucketSharedPtr per_descriptor_token_bucket =
         std::make_shared<RateLimitTokenBucket>(
             per_descriptor_max_tokens, per_descriptor_tokens_per_fill, per_descriptor_fill_interval,
-            time_source_, shadow_mode);
+            time_source_, shadow_mode, lease_tokens);
     auto result =
         descriptors_.emplace(std::move(new_descriptor), std::move(per_descriptor_token_bucket));
     if (!result.second) {
@@ -326,41 +421,84 @@ DynamicDescriptor::DynamicDescriptor(uint64_t per_descriptor_max_tokens,
                                      uint32_t lru_size, TimeSource& time_source, bool shadow_mode)
     : max_tokens_(per_descriptor_max_tokens), tokens_per_fill_(per_descriptor_tokens_per_fill),
       fill_interval_(per_descriptor_fill_interval), lru_size_(lru_size), time_source_(time_source),
-      shadow_mode_(shadow_mode) {}
+      shadow_mode_(shadow_mode),
+      shard_count_(std::clamp(lru_size / DescriptorsPerShard, 1u, MaxDescriptorShards)),
+      shards_(std::make_unique<Shard[]>(shard_count_)) {
+  // Split lru_size over the shards, so that they cache lru_size descriptors in total.
+  for (uint32_t i = 0; i < shard_count_; ++i) {
+    shards_[i].capacity_ = lru_size_ / shard_count_ + (i < lru_size_ % shard_count_ ? 1 : 0);
+  }
+}
+
+DynamicDescriptor::Shard&
+DynamicDescriptor::shardFor(const RateLimit::Descriptor& descriptor) const {
+  // Use the high bits of the hash, as the maps of the shards use the low ones.
+  const size_t hash = RateLimit::Descriptor::Hash()(descriptor);
+  return shards_[(hash >> 32) % shard_count_];
+}
+
+RateLimitTokenBucketSharedPtr DynamicDescriptor::createTokenBucket() const {
+  ENVOY_LOG(trace, "creating atomic token bucket for dynamic descriptor");
+  ENVOY_LOG(trace, "max_tokens: {}, tokens_per_fill: {}, fill_interval: {}", max_tokens_,
+            tokens_per_fill_, std::chrono::duration<double>(fill_interval_).count());
+  return std::make_shared<RateLimitTokenBucket>(max_tokens_, tokens_per_fill_, fill_interval_,
+                                                time_source_, shadow_mode_);
+}
 
 RateLimitTokenBucketSharedPtr
 DynamicDescriptor::addOrGetDescriptor(const RateLimit::Descriptor& request_descriptor) {
-  absl::WriterMutexLock lock(dyn_desc_lock_);
-  auto iter = dynamic_descriptors_.find(request_descriptor);
-  if (iter != dynamic_descriptors_.end()) {
-    if (iter->second.second != lru_list_.begin()) {
-      lru_list_.splice(lru_list_.begin(), lru_list_, iter->second.second);
+  if (lru_size_ == 0) {
+    // Nothing is cached: every request gets a new bucket.
+    return createTokenBucket();
+  }
+
+  Shard& shard = shardFor(request_descriptor);
+  {
+    absl::ReaderMutexLock lock(shard.lock_);
+    auto iter = shard.descriptors_.find(request_descriptor);
+    if (iter != shard.descriptors_.end()) {
+      Entry& entry = *iter->second;
+      // Only write the flag when it is clear, so that the hits on a hot descriptor do not bounce
+      // its cache line between the workers.
+      if (!entry.referenced_.load(std::memory_order_relaxed)) {
+        entry.referenced_.store(true, std::memory_order_relaxed);
+      }
+      return entry.token_bucket_;
     }
-    return iter->second.first;
   }
-  // add a new descriptor to the set along with its token bucket
-  RateLimitTokenBucketSharedPtr per_descriptor_token_bucket;
-  ENVOY_LOG(trace, "creating atomic token bucket for dynamic descriptor");
-  ENVOY_LOG(trace, "max_tokens: {}, tokens_per_fill: {}, fill_interval: {}", max_tokens_,
-            tokens_per_fill_, std::chrono::duration<double>(fill_interval_).count());
-  per_descriptor_token_bucket = std::make_shared<RateLimitTokenBucket>(
-      max_tokens_, tokens_per_fill_, fill_interval_, time_source_, shadow_mode_);
+
+  absl::WriterMutexLock lock(shard.lock_);
+  // Another worker may have added the descriptor since the lookup.
+  auto iter = shard.descriptors_.find(request_descriptor);
+  if (iter != shard.descriptors_.end()) {
+    iter->second->referenced_.store(true, std::memory_order_relaxed);
+    return iter->second->token_bucket_;
+  }
 
   ENVOY_LOG(trace, "DynamicDescriptor::addorGetDescriptor: adding dynamic descriptor: {}",
             request_descriptor.toString());
-  lru_list_.emplace_front(request_descriptor);
-  auto result = dynamic_descriptors_.emplace(
-      request_descriptor, std::pair(per_descriptor_token_bucket, lru_list_.begin()));
-  auto token_bucket = result.first->second.first;
-  if (lru_list_.size() > lru_size_) {
+  RateLimitTokenBucketSharedPtr token_bucket = createTokenBucket();
+  if (shard.clock_.size() < shard.capacity_) {
+    shard.clock_.push_back(request_descriptor);
+  } else {
+    // Advance the hand past the descriptors referenced since its last pass, clearing their flag,
+    // and replace the first one that was not.
+    auto victim = shard.descriptors_.find(shard.clock_[shard.hand_]);
+    ASSERT(victim != shard.descriptors_.end());
+    while (victim->second->referenced_.exchange(false, std::memory_order_relaxed)) {
+      shard.hand_ = (shard.hand_ + 1) % shard.capacity_;
+      victim = shard.descriptors_.find(shard.clock_[shard.hand_]);
+    }
     ENVOY_LOG(trace,
               "DynamicDescriptor::addorGetDescriptor: lru_size({}) overflow. Removing dynamic "
               "descriptor: {}",
-              lru_size_, lru_list_.back().toString());
-    dynamic_descriptors_.erase(lru_list_.back());
-    lru_list_.pop_back();
+              lru_size_, victim->first.toString());
+    shard.descriptors_.erase(victim);
+    shard.clock_[shard.hand_] = request_descriptor;
+    shard.hand_ = (shard.hand_ + 1) % shard.capacity_;
   }
-  ASSERT(lru_list_.size() == dynamic_descriptors_.size());
+  shard.descriptors_.emplace(request_descriptor, std::make_unique<Entry>(token_bucket));
+  ASSERT(shard.clock_.size() == shard.descriptors_.size());
   return token_bucket;
 }
 
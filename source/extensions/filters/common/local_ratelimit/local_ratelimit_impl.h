@@ -1,7 +1,10 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <memory>
 #include <ratio>
+#include <vector>
 
 #include "envoy/event/dispatcher.h"
 #include "envoy/event/timer.h"
@@ -26,6 +29,13 @@ class RateLimitTokenBucket;
 using RateLimitTokenBucketSharedPtr = std::shared_ptr<RateLimitTokenBucket>;
 using ProtoLocalClusterRateLimit = envoy::extensions::common::ratelimit::v3::LocalClusterRateLimit;
 
+// Caches the token buckets of the request descriptors matching a wildcard descriptor, up to
+// lru_size of them.
+//
+// The cache is split in shards by descriptor hash, each with its own lock, and approximates the
+// LRU eviction order with the CLOCK algorithm: a hit only marks the descriptor as referenced, so
+// that concurrent hits share the shard lock in reader mode, and the eviction gives the referenced
+// descriptors a second chance. Small caches use a single shard.
 class DynamicDescriptor : public Logger::Loggable<Logger::Id::rate_limit_quota> {
 public:
   DynamicDescriptor(uint64_t max_tokens, uint64_t tokens_per_fill,
@@ -35,19 +45,35 @@ public:
   RateLimitTokenBucketSharedPtr addOrGetDescriptor(const RateLimit::Descriptor& request_descriptor);
 
 private:
-  using LruList = std::list<RateLimit::Descriptor>;
+  struct Entry {
+    explicit Entry(RateLimitTokenBucketSharedPtr token_bucket)
+        : token_bucket_(std::move(token_bucket)) {}
 
-  mutable absl::Mutex dyn_desc_lock_;
-  RateLimit::Descriptor::Map<std::pair<RateLimitTokenBucketSharedPtr, LruList::iterator>>
-      dynamic_descriptors_ ABSL_GUARDED_BY(dyn_desc_lock_);
+    const RateLimitTokenBucketSharedPtr token_bucket_;
+    // Set by the hits, cleared by the eviction hand.
+    std::atomic<bool> referenced_{false};
+  };
+
+  struct Shard {
+    absl::Mutex lock_;
+    RateLimit::Descriptor::Map<std::unique_ptr<Entry>> descriptors_ ABSL_GUARDED_BY(lock_);
+    // The cached descriptors in the order swept by the eviction hand.
+    std::vector<RateLimit::Descriptor> clock_ ABSL_GUARDED_BY(lock_);
+    uint32_t hand_ ABSL_GUARDED_BY(lock_){0};
+    uint32_t capacity_{0};
+  };
+
+  Shard& shardFor(const RateLimit::Descriptor& descriptor) const;
+  RateLimitTokenBucketSharedPtr createTokenBucket() const;
 
   uint64_t max_tokens_;
   uint64_t tokens_per_fill_;
   const std::chrono::milliseconds fill_interval_;
-  LruList lru_list_;
   uint32_t lru_size_;
   TimeSource& time_source_;
   const bool shadow_mode_{false};
+  uint32_t shard_count_;
+  std::unique_ptr<Shard[]> shards_;
 };
 
 using DynamicDescriptorSharedPtr = std::shared_ptr<DynamicDescriptor>;
@@ -102,12 +128,20 @@ private:
 };
 using ShareProviderManagerSharedPtr = std::shared_ptr<ShareProviderManager>;
 
+// A token bucket shared by all the workers.
+//
+// With lease_tokens, every worker takes tokens from the shared bucket in batches, and consumes
+// them from a lease of its own, so that the workers only contend on the shared bucket once per
+// batch. A worker that finds both its lease and the shared bucket empty takes the leftover tokens
+// of the other leases, which rebalances the leases towards the busy workers. The capacity of the
+// leases is taken from the one of the shared bucket, so that the burst stays within max_tokens.
+// Buckets too small to give each lease a few tokens do not lease.
 class RateLimitTokenBucket : public TokenBucketContext,
                              public Logger::Loggable<Logger::Id::local_rate_limit> {
 public:
   RateLimitTokenBucket(uint64_t max_tokens, uint64_t tokens_per_fill,
                        std::chrono::milliseconds fill_interval, TimeSource& time_source,
-                       bool shadow_mode);
+                       bool shadow_mode, bool lease_tokens = false);
 
   // RateLimitTokenBucket
   bool consume(double factor = 1.0, uint64_t tokens = 1);
@@ -115,19 +149,32 @@ public:
   void refill(uint64_t tokens);
   double fillRate() const { return token_bucket_.fillRate(); }
   std::chrono::milliseconds fillInterval() const { return fill_interval_; }
+  // The number of tokens a worker takes from the shared bucket at once, or 0 if it does not lease.
+  uint64_t leaseSize() const { return lease_size_; }
 
   bool shadowMode() const override { return shadow_mode_; }
-  uint64_t maxTokens() const override { return static_cast<uint64_t>(token_bucket_.maxTokens()); }
-  uint64_t remainingTokens() const override {
-    return static_cast<uint64_t>(token_bucket_.remainingTokens());
-  }
+  uint64_t maxTokens() const override { return max_tokens_; }
+  uint64_t remainingTokens() const override;
   uint64_t resetSeconds() const override {
+    if (remainingTokens() >= 1) {
+      return 0;
+    }
     return static_cast<uint64_t>(
         std::chrono::ceil<std::chrono::seconds>(token_bucket_.nextTokenAvailable()).count());
   }
 
 private:
+  struct alignas(64) Lease {
+    std::atomic<uint64_t> tokens_{0};
+  };
+
+  bool consumeLeased();
+
+  const uint64_t max_tokens_;
+  const uint32_t lease_count_;
+  const uint64_t lease_size_;
   AtomicTokenBucketImpl token_bucket_;
+  std::unique_ptr<Lease[]> leases_;
   const std::chrono::milliseconds fill_interval_;
   const bool shadow_mode_{false};
 };
@@ -142,7 +189,8 @@ public:
       const Protobuf::RepeatedPtrField<
           envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor>& descriptors,
       bool always_consume_default_token_bucket = true,
-      ShareProviderSharedPtr shared_provider = nullptr, const uint32_t lru_size = 20);
+      ShareProviderSharedPtr shared_provider = nullptr, const uint32_t lru_size = 20,
+      bool lease_tokens = false);
   ~LocalRateLimiterImpl() override;
 
   LocalRateLimiter::Result
@@ -0,0 +1,109 @@
+#include "source/extensions/filters/http/common/coroutine_filter.h"
+
+#include <memory>
+#include <utility>
+
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Common {
+
+void CoroutineDecoderFilter::RequestBodyAwaitable::onStart() {
+  const Buffer::Instance* buffered = filter_.decoder_callbacks_->decodingBuffer();
+  if (bodyComplete(buffered != nullptr ? buffered->length() : 0)) {
+    complete(absl::OkStatus());
+    return;
+  }
+  filter_.pending_body_ = this;
+}
+
+Http::FilterHeadersStatus CoroutineDecoderFilter::decodeHeaders(Http::RequestHeaderMap& headers,
+                                                          bool end_stream) {
+  ASSERT(state_ == State::NotStarted);
+  end_stream_ = end_stream;
+  executor_.emplace(decoder_callbacks_->dispatcher());
+  state_ = State::Running;
+
+  // The executor is owned by this filter, which outlives the coroutine (see onDestroy()), so the
+  // context holds it through a non-owning pointer rather than allocating a control block.
+  std::shared_ptr<Coroutine::Executor> executor(std::shared_ptr<void>(), &executor_.value());
+  in_decoder_callback_ = true;
+  decode_task_.emplace(Coroutine::launch(
+      arena_, decodeRequest(arena_, headers, end_stream), std::move(executor),
+      [this](absl::Status status) { onDecodeTaskDone(std::move(status)); },
+      Coroutine::StartMode::Inline));
+  in_decoder_callback_ = false;
+
+  if (state_ == State::Done && decode_status_.ok()) {
+    return Http::FilterHeadersStatus::Continue;
+  }
+  return Http::FilterHeadersStatus::StopIteration;
+}
+
+Http::FilterDataStatus CoroutineDecoderFilter::decodeData(Buffer::Instance& data, bool end_stream) {
+  end_stream_ = end_stream;
+  if (pending_body_ != nullptr) {
+    if (!pending_body_->bodyComplete(bufferedBytes(data))) {
+      return Http::FilterDataStatus::StopIterationAndBuffer;
+    }
+    // Make the whole body available through decodingBuffer() before resuming.
+    decoder_callbacks_->addDecodedData(data, true);
+    in_decoder_callback_ = true;
+    std::exchange(pending_body_, nullptr)->onBodyComplete();
+    in_decoder_callback_ = false;
+  }
+
+  switch (state_) {
+  case State::NotStarted:
+    return Http::FilterDataStatus::Continue;
+  case State::Running:
+    // The request is not buffered while waiting on anything but the body; rely on watermarks to
+    // stop reading if it is large.
+    return Http::FilterDataStatus::StopIterationAndWatermark;
+  case State::Done:
+    return decode_status_.ok() ? Http::FilterDataStatus::Continue
+                               : Http::FilterDataStatus::StopIterationNoBuffer;
+  }
+  PANIC_DUE_TO_CORRUPT_ENUM;
+}
+
+Http::FilterTrailersStatus CoroutineDecoderFilter::decodeTrailers(Http::RequestTrailerMap&) {
+  end_stream_ = true;
+  if (pending_body_ != nullptr) {
+    in_decoder_callback_ = true;
+    std::exchange(pending_body_, nullptr)->onBodyComplete();
+    in_decoder_callback_ = false;
+  }
+
+  if (state_ == State::Running || (state_ == State::Done && !decode_status_.ok())) {
+    return Http::FilterTrailersStatus::StopIteration;
+  }
+  return Http::FilterTrailersStatus::Continue;
+}
+
+void CoroutineDecoderFilter::cancelDecodeTask() {
+  if (state_ == State::Running) {
+    decode_task_->cancel();
+    ASSERT(state_ == State::Done, "decodeRequest() did not complete on cancellation");
+  }
+}
+
+void CoroutineDecoderFilter::onDecodeTaskDone(absl::Status status) {
+  state_ = State::Done;
+  decode_status_ = std::move(status);
+  if (!in_decoder_callback_ && decode_status_.ok()) {
+    decoder_callbacks_->continueDecoding();
+  }
+}
+
+uint64_t CoroutineDecoderFilter::bufferedBytes(const Buffer::Instance& data) const {
+  const Buffer::Instance* buffered = decoder_callbacks_->decodingBuffer();
+  return data.length() + (buffered != nullptr ? buffered->length() : 0);
+}
+
+} // namespace Common
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include "envoy/common/pure.h"
+#include "envoy/http/filter.h"
+
+#include "source/common/coroutine/dispatcher_executor.h"
+#include "source/common/coroutine/frame_arena.h"
+#include "source/common/coroutine/launch.h"
+#include "source/common/coroutine/leaf_awaitable.h"
+#include "source/common/coroutine/task.h"
+
+#include "absl/status/status.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Common {
+
+/**
+ * A decoder filter whose request processing is a coroutine rather than a callback state machine.
+ * decodeRequest() is started from decodeHeaders() and may `co_await` leaf awaitables for
+ * asynchronous calls (see Coroutine::LeafAwaitable), timers (Coroutine::sleep()) and the request
+ * body (requestBody()). Decoding of the request is paused until it completes:
+ *   - an OK status continues decoding, inline if decodeRequest() completed within a decoder
+ *     callback and through continueDecoding() otherwise.
+ *   - any other status stops decoding. decodeRequest() is expected to have sent a local reply;
+ *     cancellation also completes with a non-OK status.
+ *
+ * The coroutine frames and launch state are allocated from an arena inside the filter, so that a
+ * request normally performs no allocations for them beyond the filter itself. Member coroutines
+ * called from decodeRequest() can share the arena by taking it as their first parameter.
+ *
+ * onDestroy() cancels a running decodeRequest(); filters overriding it must call
+ * CoroutineDecoderFilter::onDestroy() (or cancelDecodeTask()) before releasing anything the
+ * coroutine uses.
+ */
+class CoroutineDecoderFilter : public virtual Http::StreamDecoderFilter {
+public:
+  // Frames beyond this size are allocated from the heap.
+  static constexpr size_t FrameArenaSize = 1024;
+
+  ~CoroutineDecoderFilter() override {
+    ASSERT(state_ != State::Running, "filter destroyed without onDestroy()");
+  }
+
+  // Http::StreamFilterBase
+  void onDestroy() override { cancelDecodeTask(); }
+
+  // Http::StreamDecoderFilter
+  Http::FilterHeadersStatus decodeHeaders(Http::RequestHeaderMap& headers,
+                                          bool end_stream) override;
+  Http::FilterDataStatus decodeData(Buffer::Instance& data, bool end_stream) override;
+  Http::FilterTrailersStatus decodeTrailers(Http::RequestTrailerMap& trailers) override;
+  void setDecoderFilterCallbacks(Http::StreamDecoderFilterCallbacks& callbacks) override {
+    decoder_callbacks_ = &callbacks;
+  }
+
+  const Coroutine::FrameArena& frameArena() const { return arena_; }
+
+protected:
+  /**
+   * Waits until the request body is buffered: until the end of the stream or, if `max_bytes` is
+   * not zero, until at least `max_bytes` are buffered. The body is then available through
+   * decodingBuffer(). Must be awaited before any other awaitable, as data that arrives while the
+   * coroutine waits for something else is not buffered.
+   */
+  class RequestBodyAwaitable : public Coroutine::LeafAwaitable<absl::Status> {
+  public:
+    RequestBodyAwaitable(CoroutineDecoderFilter& filter, uint64_t max_bytes)
+        : filter_(filter), max_bytes_(max_bytes) {}
+
+  protected:
+    // Coroutine::LeafAwaitable
+    void onStart() override;
+    void onCancel() override { filter_.pending_body_ = nullptr; }
+
+  private:
+    friend class CoroutineDecoderFilter;
+
+    bool bodyComplete(uint64_t buffered_bytes) const {
+      return filter_.end_stream_ || (max_bytes_ != 0 && buffered_bytes >= max_bytes_);
+    }
+    void onBodyComplete() { complete(absl::OkStatus()); }
+
+    CoroutineDecoderFilter& filter_;
+    const uint64_t max_bytes_;
+  };
+
+  /**
+   * The request processing. Started from decodeHeaders() with the same arguments.
+   * @param arena the arena the frame is allocated from; see the class comment.
+   */
+  virtual Coroutine::Task<absl::Status> decodeRequest(Coroutine::FrameArena& arena,
+                                                      Http::RequestHeaderMap& headers,
+                                                      bool end_stream) PURE;
+
+  RequestBodyAwaitable requestBody(uint64_t max_bytes = 0) {
+    return RequestBodyAwaitable(*this, max_bytes);
+  }
+
+  /**
+   * @return whether decodeRequest() has started and not completed yet.
+   */
+  bool decodeTaskRunning() const { return state_ == State::Running; }
+
+  /**
+   * Cancels decodeRequest() if it is running. It completes before this returns.
+   */
+  void cancelDecodeTask();
+
+  Http::StreamDecoderFilterCallbacks* decoder_callbacks_{};
+
+private:
+  enum class State { NotStarted, Running, Done };
+
+  void onDecodeTaskDone(absl::Status status);
+  uint64_t bufferedBytes(const Buffer::Instance& data) const;
+
+  // Declared first so that it outlives the handle below, whose cancellation state it holds.
+  Coroutine::InlineFrameArena<FrameArenaSize> arena_;
+  std::optional<Coroutine::DispatcherExecutor> executor_;
+  std::optional<Coroutine::DetachedHandle> decode_task_;
+  RequestBodyAwaitable* pending_body_{};
+  absl::Status decode_status_;
+  State state_{State::NotStarted};
+  bool end_stream_{};
+  // Set while a decoder callback is resuming the coroutine, in which case its completion is
+  // reported through the callback's return value rather than continueDecoding().
+  bool in_decoder_callback_{};
+};
+
+} // namespace Common
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -23,10 +23,12 @@ const Http::LowerCaseString& acceptRangesHeaderKey() {
 } // namespace
 
 void FileStreamer::begin(const FileServerConfig& config, Event::Dispatcher& dispatcher,
-                         uint64_t start, uint64_t end, std::filesystem::path file_path) {
+                         uint64_t start, uint64_t end, std::filesystem::path file_path,
+                         bool file_backed) {
   ASSERT(config.asyncFileManager() != nullptr);
   file_server_config_ = &config;
   dispatcher_ = &dispatcher;
+  file_backed_ = file_backed;
   pos_ = start;
   end_ = end;
   file_path_ = std::move(file_path);
@@ -164,31 +166,49 @@ void FileStreamer::unpause() {
 void FileStreamer::readBodyChunk() {
   ASSERT(async_file_);
   static const uint64_t kMaxReadSize = 32 * 1024;
-  uint64_t sz = std::min(end_ - pos_, kMaxReadSize);
-  auto queued = async_file_->read(dispatcher_, pos_, sz,
-                                  Envoy::CancelWrapper::cancelWrapped(
-                                      [this](absl::StatusOr<Buffer::InstancePtr> result) {
-                                        if (!result.ok()) {
-                                          client_.errorFromFile(
-                                              abslStatusToHttpStatus(result.status().code()),
-                                              "file_server_read_operation_failed");
-                                          return;
-                                        }
-                                        Buffer::InstancePtr buf = std::move(result.value());
-                                        pos_ += buf->length();
-                                        client_.bodyChunkFromFile(std::move(buf), pos_ == end_);
-                                        if (!paused_ && pos_ != end_) {
-                                          readBodyChunk();
-                                        } else if (paused_) {
-                                          action_has_been_postponed_by_pause_ = true;
-                                        }
-                                      },
-                                      &cancel_dispatcher_callbacks_));
+  // File-backed chunks cost no memory until something reads them, so fewer, larger chunks only
+  // save round trips through the file thread pool.
+  static const uint64_t kMaxFileBackedReadSize = 256 * 1024;
+  uint64_t sz = std::min(end_ - pos_, file_backed_ ? kMaxFileBackedReadSize : kMaxReadSize);
+  auto on_read = Envoy::CancelWrapper::cancelWrapped(
+      [this](absl::StatusOr<Buffer::InstancePtr> result) {
+        if (!result.ok()) {
+          client_.errorFromFile(abslStatusToHttpStatus(result.status().code()),
+                                "file_server_read_operation_failed");
+          return;
+        }
+        Buffer::InstancePtr buf = std::move(result.value());
+        pos_ += buf->length();
+        client_.bodyChunkFromFile(std::move(buf), pos_ == end_);
+        if (!paused_ && pos_ != end_) {
+          readBodyChunk();
+        } else if (paused_) {
+          action_has_been_postponed_by_pause_ = true;
+        }
+      },
+      &cancel_dispatcher_callbacks_);
+  auto queued = file_backed_
+                    ? async_file_->readFileBacked(dispatcher_, pos_, sz, onFileBackedReadFailure(),
+                                                  std::move(on_read))
+                    : async_file_->read(dispatcher_, pos_, sz, std::move(on_read));
   ASSERT(queued.ok());
   cancel_callback_ = std::move(queued.value());
 }
 
+absl::AnyInvocable<void()> FileStreamer::onFileBackedReadFailure() {
+  // The contents of a file-backed chunk are read by whatever accesses them, possibly in the middle
+  // of the filter chain, so the stream is failed from the dispatcher rather than from there.
+  return [this, dispatcher = dispatcher_, alive = std::weak_ptr<bool>(alive_)]() {
+    dispatcher->post([this, alive]() {
+      if (!alive.expired()) {
+        client_.errorFromFile(Http::Code::InternalServerError, "file_server_file_truncated");
+      }
+    });
+  };
+}
+
 void FileStreamer::abort() {
+  alive_.reset();
   cancel_callback_();
   // Short-circuit any callback the dispatcher has already enqueued before the
   // cancel could land (see source/extensions/common/async_files/
@@ -198,6 +218,7 @@ void FileStreamer::abort() {
 }
 
 FileStreamer::~FileStreamer() {
+  alive_.reset();
   cancel_dispatcher_callbacks_();
   if (async_file_) {
     async_file_->close(nullptr, [](absl::Status) {}).IgnoreError();
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <memory>
+
 #include "envoy/buffer/buffer.h"
 #include "envoy/http/codes.h"
 #include "envoy/http/header_map.h"
@@ -8,6 +10,7 @@
 #include "source/extensions/common/async_files/async_file_manager.h"
 #include "source/extensions/filters/http/file_server/filter_config.h"
 
+#include "absl/functional/any_invocable.h"
 #include "absl/strings/string_view.h"
 
 namespace Envoy {
@@ -34,8 +37,10 @@ public:
   ~FileStreamer();
   // Starts reading and streaming the file.
   // end == 0 means read to end of file.
+  // file_backed means the body chunks reference the file rather than holding its contents, for
+  // downstream connections that send them with sendfile().
   void begin(const FileServerConfig& config, Event::Dispatcher& dispatcher, uint64_t start,
-             uint64_t end, std::filesystem::path file_path);
+             uint64_t end, std::filesystem::path file_path, bool file_backed);
   // Call when the downstream buffer is over watermark.
   // Stops at the completion of the current action if not unpaused first.
   void pause();
@@ -51,6 +56,8 @@ private:
   void startDir(int behavior_index);
   void onFileOpened(AsyncFileHandle handle);
   void readBodyChunk();
+  // Returns the callback failing the stream if a file-backed chunk cannot be read in full.
+  absl::AnyInvocable<void()> onFileBackedReadFailure();
   Event::Dispatcher* dispatcher_;
   FileStreamerClient& client_;
   std::filesystem::path file_path_;
@@ -59,6 +66,7 @@ private:
   // To get the last byte, end_ must be the size of the file, not the inclusive last byte
   // like a range request uses.
   uint64_t end_ = 0;
+  bool file_backed_ = false;
   bool paused_ = false;
   bool action_has_been_postponed_by_pause_ = false;
   AsyncFileHandle async_file_;
@@ -72,6 +80,9 @@ private:
   // queued by the time abort() runs. Invoking this on destruction
   // short-circuits the queued callback before it dereferences this object.
   Envoy::CancelWrapper::CancelFunction cancel_dispatcher_callbacks_ = []() {};
+  // Reset by abort() and on destruction, so that the read failures of the file-backed chunks that
+  // are still referenced afterwards are ignored.
+  std::shared_ptr<bool> alive_ = std::make_shared<bool>(true);
 };
 
 } // namespace FileServer
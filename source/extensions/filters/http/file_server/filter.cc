@@ -115,10 +115,19 @@ Http::FilterHeadersStatus FileServerFilter::decodeHeaders(RequestHeaderMap& head
   auto [start, end] = parseRangeHeader(headers);
   is_head_ = headers.Method()->value() == Http::Headers::get().MethodValues.Head;
   file_streamer_.begin(*config, decoder_callbacks_->dispatcher(), start, end,
-                       std::move(*file_path));
+                       std::move(*file_path), config->fileBackedBody() && canSendFileBackedBody());
   return Http::FilterHeadersStatus::StopIteration;
 }
 
+bool FileServerFilter::canSendFileBackedBody() const {
+  // Other connections would read file-backed chunks on the worker thread, as would the HTTP/2 and
+  // HTTP/3 codecs framing them.
+  const std::optional<Http::Protocol> protocol = decoder_callbacks_->streamInfo().protocol();
+  OptRef<const Network::Connection> connection = decoder_callbacks_->connection();
+  return protocol.has_value() && protocol.value() < Http::Protocol::Http2 &&
+         connection.has_value() && connection->canSendFile();
+}
+
 bool FileServerFilter::headersFromFile(Http::ResponseHeaderMapPtr response_headers) {
   bool end_response = is_head_ || response_headers->getContentLengthValue() == "0";
   decoder_callbacks_->encodeHeaders(std::move(response_headers), end_response, "file_server");
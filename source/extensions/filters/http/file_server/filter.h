@@ -40,6 +40,9 @@ public:
   void onBelowWriteBufferLowWatermark() override;
 
 private:
+  // Whether the downstream connection sends file-backed body chunks with sendfile().
+  bool canSendFileBackedBody() const;
+
   std::shared_ptr<const FileServerConfig> file_server_config_;
   friend class FileServerConfigTest; // Allow test access to file_server_config_.
   FileStreamer file_streamer_;
@@ -52,7 +52,8 @@ FileServerConfig::FileServerConfig(const ProtoFileServerConfig& config,
       content_types_(config.content_types().begin(), config.content_types().end()),
       default_content_type_(config.default_content_type()),
       directory_behaviors_(config.directory_behaviors().begin(),
-                           config.directory_behaviors().end()) {}
+                           config.directory_behaviors().end()),
+      file_backed_body_(config.file_backed_body()) {}
 
 std::shared_ptr<const ProtoFileServerConfig::PathMapping>
 FileServerConfig::pathMapping(absl::string_view path) const {
@@ -45,6 +45,8 @@ public:
   absl::string_view contentTypeForPath(const std::filesystem::path& path) const;
   // nullopt if out of behaviors.
   OptRef<const ProtoFileServerConfig::DirectoryBehavior> directoryBehavior(size_t index) const;
+  // True if the response bodies should reference the files rather than copies of them.
+  bool fileBackedBody() const { return file_backed_body_; }
 
 private:
   // The factory is held to keep the singleton alive.
@@ -54,6 +56,7 @@ private:
   const absl::flat_hash_map<std::string, std::string> content_types_;
   const std::string default_content_type_;
   const std::vector<ProtoFileServerConfig::DirectoryBehavior> directory_behaviors_;
+  const bool file_backed_body_;
 };
 
 } // namespace FileServer
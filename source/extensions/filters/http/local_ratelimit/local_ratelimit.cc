@@ -41,6 +41,7 @@ FilterConfig::FilterConfig(
           config.has_always_consume_default_token_bucket()
               ? config.always_consume_default_token_bucket().value()
               : true),
+      lease_tokens_to_workers_(config.lease_tokens_to_workers()),
 
       local_info_(context.localInfo()), runtime_(context.runtime()),
       filter_enabled_(
@@ -128,7 +129,8 @@ FilterConfig::FilterConfig(
 
   rate_limiter_ = std::make_unique<Filters::Common::LocalRateLimit::LocalRateLimiterImpl>(
       fill_interval_, max_tokens_, tokens_per_fill_, dispatcher_, descriptors_,
-      always_consume_default_token_bucket_, std::move(share_provider), max_dynamic_descriptors_);
+      always_consume_default_token_bucket_, std::move(share_provider), max_dynamic_descriptors_,
+      lease_tokens_to_workers_);
 }
 
 Filters::Common::LocalRateLimit::LocalRateLimiter::Result
@@ -13,6 +13,7 @@
 #include "source/common/http/codes.h"
 #include "source/common/http/header_utility.h"
 #include "source/common/router/config_impl.h"
+#include "source/common/runtime/runtime_features.h"
 #include "source/common/stream_info/uint32_accessor_impl.h"
 #include "source/extensions/filters/http/ratelimit/ratelimit_headers.h"
 
@@ -49,23 +50,58 @@ struct RcDetailsValues {
 };
 using RcDetails = ConstSingleton<RcDetailsValues>;
 
-void Filter::initiateCall(const Http::RequestHeaderMap& headers) {
+Coroutine::Task<absl::Status> Filter::decodeRequest(Coroutine::FrameArena&,
+                                                    Http::RequestHeaderMap& headers, bool) {
+  request_headers_ = &headers;
+  if (!config_->enabled()) {
+    co_return absl::OkStatus();
+  }
+
   const bool is_internal_request = Http::HeaderUtility::isEnvoyInternalRequest(headers);
   if ((is_internal_request && config_->requestType() == FilterRequestType::External) ||
       (!is_internal_request && config_->requestType() == FilterRequestType::Internal)) {
-    return;
+    co_return absl::OkStatus();
   }
 
   descriptors_.clear();
   populateRateLimitDescriptors(descriptors_, headers, false);
   ENVOY_LOG(debug, "rate limit descriptors size: {}", descriptors_.size());
-  if (!descriptors_.empty()) {
-    state_ = State::Calling;
-    initiating_call_ = true;
-    client_->limit(*this, getDomain(), descriptors_, callbacks_->activeSpan(),
-                   callbacks_->streamInfo(), getHitAddend());
-    initiating_call_ = false;
+  if (descriptors_.empty()) {
+    co_return absl::OkStatus();
+  }
+
+  LimitAwaitable response(*this);
+  const absl::Status status = co_await response;
+  if (!status.ok()) {
+    // Cancelled by onDestroy().
+    co_return status;
   }
+  co_return onLimitResponse(response);
+}
+
+void Filter::LimitAwaitable::onStart() {
+  starting_ = true;
+  filter_.client_->limit(*this, filter_.getDomain(), filter_.descriptors_,
+                         filter_.decoder_callbacks_->activeSpan(),
+                         filter_.decoder_callbacks_->streamInfo(), filter_.getHitAddend());
+  starting_ = false;
+}
+
+void Filter::LimitAwaitable::complete(
+    Filters::Common::RateLimit::LimitStatus status,
+    Filters::Common::RateLimit::DescriptorStatusListPtr&& descriptor_statuses,
+    Http::ResponseHeaderMapPtr&& response_headers_to_add,
+    Http::RequestHeaderMapPtr&& request_headers_to_add, const std::string& response_body,
+    Filters::Common::RateLimit::DynamicMetadataPtr&& dynamic_metadata) {
+  completed_inline_ = starting_;
+  status_ = status;
+  descriptor_statuses_ = std::move(descriptor_statuses);
+  response_headers_to_add_ = std::move(response_headers_to_add);
+  request_headers_to_add_ = std::move(request_headers_to_add);
+  response_body_ = response_body;
+  dynamic_metadata_ = std::move(dynamic_metadata);
+  // Resumes decodeRequest(), which may destroy this awaitable.
+  LeafAwaitable<absl::Status>::complete(absl::OkStatus());
 }
 
 void Filter::populateRateLimitDescriptors(std::vector<Envoy::RateLimit::Descriptor>& descriptors,
@@ -74,8 +110,8 @@ void Filter::populateRateLimitDescriptors(std::vector<Envoy::RateLimit::Descript
   if (!on_stream_done) {
     // To use the exact same context for both request and on_stream_done rate limiting descriptors,
     // we save the route and per-route configuration here and use them later.
-    route_ = callbacks_->routeSharedPtr();
-    cluster_ = callbacks_->clusterInfoSharedPtr();
+    route_ = decoder_callbacks_->routeSharedPtr();
+    cluster_ = decoder_callbacks_->clusterInfoSharedPtr();
   }
   if (!route_ || !cluster_) {
     return;
@@ -86,21 +122,22 @@ void Filter::populateRateLimitDescriptors(std::vector<Envoy::RateLimit::Descript
   }
   if (!on_stream_done) {
     route_config_ =
-        Http::Utility::resolveMostSpecificPerFilterConfig<FilterConfigPerRoute>(callbacks_);
+        Http::Utility::resolveMostSpecificPerFilterConfig<FilterConfigPerRoute>(decoder_callbacks_);
     initializeVirtualHostRateLimitOption(route_entry);
   }
 
   // The the embedded rate limits is set in the typed_per_filter_config, use it and ignore the
   // rate limits of route.
   if (route_config_ != nullptr && route_config_->hasRateLimitConfigs()) {
-    route_config_->populateDescriptors(headers, callbacks_->streamInfo(), descriptors,
+    route_config_->populateDescriptors(headers, decoder_callbacks_->streamInfo(), descriptors,
                                        on_stream_done);
     return;
   }
 
   // Rate Limit config in typed_per_filter_config takes precedence over route's rate limit.
   if (config_->hasRateLimitConfigs()) {
-    config_->populateDescriptors(headers, callbacks_->streamInfo(), descriptors, on_stream_done);
+    config_->populateDescriptors(headers, decoder_callbacks_->streamInfo(), descriptors,
+                                 on_stream_done);
     return;
   }
 
@@ -125,7 +162,7 @@ void Filter::populateRateLimitDescriptors(std::vector<Envoy::RateLimit::Descript
 
 double Filter::getHitAddend() {
   const StreamInfo::UInt32Accessor* hits_addend_filter_state =
-      callbacks_->streamInfo().filterState()->getDataReadOnly<StreamInfo::UInt32Accessor>(
+      decoder_callbacks_->streamInfo().filterState()->getDataReadOnly<StreamInfo::UInt32Accessor>(
           HitsAddendFilterStateKey);
   double hits_addend = 0;
   if (hits_addend_filter_state != nullptr) {
@@ -134,37 +171,6 @@ double Filter::getHitAddend() {
   return hits_addend;
 }
 
-Http::FilterHeadersStatus Filter::decodeHeaders(Http::RequestHeaderMap& headers, bool) {
-  request_headers_ = &headers;
-  if (!config_->enabled()) {
-    return Http::FilterHeadersStatus::Continue;
-  }
-
-  initiateCall(headers);
-  return (state_ == State::Calling || state_ == State::Responded)
-             ? Http::FilterHeadersStatus::StopIteration
-             : Http::FilterHeadersStatus::Continue;
-}
-
-Http::FilterDataStatus Filter::decodeData(Buffer::Instance&, bool) {
-  ASSERT(state_ != State::Responded);
-  if (state_ != State::Calling) {
-    return Http::FilterDataStatus::Continue;
-  }
-  // If the request is too large, stop reading new data until the buffer drains.
-  return Http::FilterDataStatus::StopIterationAndWatermark;
-}
-
-Http::FilterTrailersStatus Filter::decodeTrailers(Http::RequestTrailerMap&) {
-  ASSERT(state_ != State::Responded);
-  return state_ == State::Calling ? Http::FilterTrailersStatus::StopIteration
-                                  : Http::FilterTrailersStatus::Continue;
-}
-
-void Filter::setDecoderFilterCallbacks(Http::StreamDecoderFilterCallbacks& callbacks) {
-  callbacks_ = &callbacks;
-}
-
 Http::Filter1xxHeadersStatus Filter::encode1xxHeaders(Http::ResponseHeaderMap&) {
   return Http::Filter1xxHeadersStatus::Continue;
 }
@@ -189,9 +195,8 @@ Http::FilterMetadataStatus Filter::encodeMetadata(Http::MetadataMap&) {
 void Filter::setEncoderFilterCallbacks(Http::StreamEncoderFilterCallbacks&) {}
 
 void Filter::onDestroy() {
-  if (state_ == State::Calling) {
-    state_ = State::Complete;
-    client_->cancel();
+  if (decodeTaskRunning()) {
+    cancelDecodeTask();
   } else if (client_ != nullptr && request_headers_ != nullptr) {
     std::vector<Envoy::RateLimit::Descriptor> descriptors;
     populateRateLimitDescriptors(descriptors, *request_headers_, true);
@@ -207,27 +212,23 @@ void Filter::onDestroy() {
           std::make_shared<OnStreamDoneCallBack>(shared_client);
       callback->keepAlive();
       callback->client().limit(*callback, getDomain(), descriptors, Tracing::NullSpan::instance(),
-                               callbacks_->streamInfo(), getHitAddend());
+                               decoder_callbacks_->streamInfo(), getHitAddend());
       // If the limit() call fails directly then the detach() will be no-op.
       shared_client->detach();
     }
   }
 }
 
-void Filter::complete(Filters::Common::RateLimit::LimitStatus status,
-                      Filters::Common::RateLimit::DescriptorStatusListPtr&& descriptor_statuses,
-                      Http::ResponseHeaderMapPtr&& response_headers_to_add,
-                      Http::RequestHeaderMapPtr&& request_headers_to_add,
-                      const std::string& response_body,
-                      Filters::Common::RateLimit::DynamicMetadataPtr&& dynamic_metadata) {
-  state_ = State::Complete;
-  response_headers_to_add_ = std::move(response_headers_to_add);
-  Http::HeaderMapPtr req_headers_to_add = std::move(request_headers_to_add);
+absl::Status Filter::onLimitResponse(LimitAwaitable& response) {
+  const Filters::Common::RateLimit::LimitStatus status = response.status_;
+  response_headers_to_add_ = std::move(response.response_headers_to_add_);
+  Http::HeaderMapPtr req_headers_to_add = std::move(response.request_headers_to_add_);
   Stats::StatName empty_stat_name;
   Filters::Common::RateLimit::StatNames& stat_names = config_->statNames();
 
-  if (dynamic_metadata != nullptr && !dynamic_metadata->fields().empty()) {
-    callbacks_->streamInfo().setDynamicMetadata(config_->metadataNamespace(), *dynamic_metadata);
+  if (response.dynamic_metadata_ != nullptr && !response.dynamic_metadata_->fields().empty()) {
+    decoder_callbacks_->streamInfo().setDynamicMetadata(config_->metadataNamespace(),
+                                                        *response.dynamic_metadata_);
   }
 
   switch (status) {
@@ -262,43 +263,44 @@ void Filter::complete(Filters::Common::RateLimit::LimitStatus status,
     break;
   }
 
-  if (descriptor_statuses != nullptr && !descriptor_statuses->empty()) {
+  if (response.descriptor_statuses_ != nullptr && !response.descriptor_statuses_->empty()) {
     if (response_headers_to_add_ == nullptr) {
       response_headers_to_add_ = Http::ResponseHeaderMapImpl::create();
     }
     XRateLimitHeaderUtils::populateHeaders(descriptors_, config_->enableXRateLimitHeaders(),
-                                           *descriptor_statuses, *response_headers_to_add_);
+                                           *response.descriptor_statuses_,
+                                           *response_headers_to_add_);
   }
 
   if (status == Filters::Common::RateLimit::LimitStatus::OverLimit && config_->enforced()) {
-    state_ = State::Responded;
-    callbacks_->streamInfo().setResponseFlag(StreamInfo::CoreResponseFlag::RateLimited);
-    callbacks_->sendLocalReply(
-        config_->rateLimitedStatus(), response_body,
+    decoder_callbacks_->streamInfo().setResponseFlag(StreamInfo::CoreResponseFlag::RateLimited);
+    decoder_callbacks_->sendLocalReply(
+        config_->rateLimitedStatus(), response.response_body_,
         [this](Http::HeaderMap& headers) {
           populateResponseHeaders(headers, /*from_local_reply=*/true);
           config_->responseHeadersParser().evaluateHeaders(
               headers, {request_headers_, dynamic_cast<const Http::ResponseHeaderMap*>(&headers)},
-              callbacks_->streamInfo());
+              decoder_callbacks_->streamInfo());
         },
         config_->rateLimitedGrpcStatus(), RcDetails::get().RateLimited);
-  } else if (status == Filters::Common::RateLimit::LimitStatus::Error) {
-    if (config_->failureModeAllow()) {
-      cluster_->statsScope().counterFromStatName(stat_names.failure_mode_allowed_).inc();
-      if (!initiating_call_) {
-        appendRequestHeaders(req_headers_to_add);
-        callbacks_->continueDecoding();
-      }
-    } else {
-      state_ = State::Responded;
-      callbacks_->streamInfo().setResponseFlag(StreamInfo::CoreResponseFlag::RateLimitServiceError);
-      callbacks_->sendLocalReply(config_->statusOnError(), response_body, nullptr, std::nullopt,
-                                 RcDetails::get().RateLimitError);
+    return absl::ResourceExhaustedError(RcDetails::get().RateLimited);
+  }
+  if (status == Filters::Common::RateLimit::LimitStatus::Error) {
+    if (!config_->failureModeAllow()) {
+      decoder_callbacks_->streamInfo().setResponseFlag(
+          StreamInfo::CoreResponseFlag::RateLimitServiceError);
+      decoder_callbacks_->sendLocalReply(config_->statusOnError(), response.response_body_,
+                                         nullptr, std::nullopt, RcDetails::get().RateLimitError);
+      return absl::UnavailableError(RcDetails::get().RateLimitError);
     }
-  } else if (!initiating_call_) {
+    cluster_->statsScope().counterFromStatName(stat_names.failure_mode_allowed_).inc();
+  }
+  if (!response.completed_inline_ ||
+      Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.ratelimit_request_headers_on_inline_response")) {
     appendRequestHeaders(req_headers_to_add);
-    callbacks_->continueDecoding();
   }
+  return absl::OkStatus();
 }
 
 void Filter::populateRateLimitDescriptorsForPolicy(const Router::RateLimitPolicy& rate_limit_policy,
@@ -316,7 +318,7 @@ void Filter::populateRateLimitDescriptorsForPolicy(const Router::RateLimitPolicy
     const bool apply_on_stream_done = rate_limit.applyOnStreamDone();
     if (on_stream_done == apply_on_stream_done) {
       rate_limit.populateDescriptors(descriptors, config_->localInfo().clusterName(), headers,
-                                     callbacks_->streamInfo());
+                                     decoder_callbacks_->streamInfo());
     }
   }
 }
@@ -15,12 +15,16 @@
 #include "envoy/upstream/cluster_manager.h"
 
 #include "source/common/common/assert.h"
+#include "source/common/coroutine/frame_arena.h"
+#include "source/common/coroutine/leaf_awaitable.h"
+#include "source/common/coroutine/task.h"
 #include "source/common/http/header_map_impl.h"
 #include "source/common/router/header_parser.h"
 #include "source/common/runtime/runtime_protos.h"
 #include "source/extensions/filters/common/ratelimit/ratelimit.h"
 #include "source/extensions/filters/common/ratelimit/stat_names.h"
 #include "source/extensions/filters/common/ratelimit_config/ratelimit_config.h"
+#include "source/extensions/filters/http/common/coroutine_filter.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -225,10 +229,11 @@ using FilterConfigPerRouteSharedPtr = std::shared_ptr<FilterConfigPerRoute>;
 
 /**
  * HTTP rate limit filter. Depending on the route configuration, this filter calls the global
- * rate limiting service before allowing further filter iteration.
+ * rate limiting service before allowing further filter iteration. The call is made from a
+ * coroutine (see Common::CoroutineDecoderFilter).
  */
 class Filter : public Http::StreamFilter,
-               public Filters::Common::RateLimit::RequestCallbacks,
+               public Common::CoroutineDecoderFilter,
                public Logger::Loggable<Logger::Id::filter> {
 public:
   Filter(FilterConfigSharedPtr config, Filters::Common::RateLimit::ClientPtr&& client)
@@ -237,13 +242,6 @@ public:
   // Http::StreamFilterBase
   void onDestroy() override;
 
-  // Http::StreamDecoderFilter
-  Http::FilterHeadersStatus decodeHeaders(Http::RequestHeaderMap& headers,
-                                          bool end_stream) override;
-  Http::FilterDataStatus decodeData(Buffer::Instance& data, bool end_stream) override;
-  Http::FilterTrailersStatus decodeTrailers(Http::RequestTrailerMap& trailers) override;
-  void setDecoderFilterCallbacks(Http::StreamDecoderFilterCallbacks& callbacks) override;
-
   // Http::StreamEncoderFilter
   Http::Filter1xxHeadersStatus encode1xxHeaders(Http::ResponseHeaderMap& headers) override;
   Http::FilterHeadersStatus encodeHeaders(Http::ResponseHeaderMap& headers,
@@ -253,16 +251,50 @@ public:
   Http::FilterMetadataStatus encodeMetadata(Http::MetadataMap&) override;
   void setEncoderFilterCallbacks(Http::StreamEncoderFilterCallbacks& callbacks) override;
 
-  // RateLimit::RequestCallbacks
-  void complete(Filters::Common::RateLimit::LimitStatus status,
-                Filters::Common::RateLimit::DescriptorStatusListPtr&& descriptor_statuses,
-                Http::ResponseHeaderMapPtr&& response_headers_to_add,
-                Http::RequestHeaderMapPtr&& request_headers_to_add,
-                const std::string& response_body,
-                Filters::Common::RateLimit::DynamicMetadataPtr&& dynamic_metadata) override;
+protected:
+  // Common::CoroutineDecoderFilter
+  Coroutine::Task<absl::Status> decodeRequest(Coroutine::FrameArena& arena,
+                                              Http::RequestHeaderMap& headers,
+                                              bool end_stream) override;
 
 private:
-  void initiateCall(const Http::RequestHeaderMap& headers);
+  /**
+   * A call to the rate limit service. The response is kept here for the filter to apply once the
+   * await completes with an OK status.
+   */
+  class LimitAwaitable : public Coroutine::LeafAwaitable<absl::Status>,
+                         public Filters::Common::RateLimit::RequestCallbacks {
+  public:
+    explicit LimitAwaitable(Filter& filter) : filter_(filter) {}
+
+    // RateLimit::RequestCallbacks
+    void complete(Filters::Common::RateLimit::LimitStatus status,
+                  Filters::Common::RateLimit::DescriptorStatusListPtr&& descriptor_statuses,
+                  Http::ResponseHeaderMapPtr&& response_headers_to_add,
+                  Http::RequestHeaderMapPtr&& request_headers_to_add,
+                  const std::string& response_body,
+                  Filters::Common::RateLimit::DynamicMetadataPtr&& dynamic_metadata) override;
+
+    Filters::Common::RateLimit::LimitStatus status_{};
+    Filters::Common::RateLimit::DescriptorStatusListPtr descriptor_statuses_;
+    Http::ResponseHeaderMapPtr response_headers_to_add_;
+    Http::RequestHeaderMapPtr request_headers_to_add_;
+    std::string response_body_;
+    Filters::Common::RateLimit::DynamicMetadataPtr dynamic_metadata_;
+    // Whether the client completed the call from within limit().
+    bool completed_inline_{false};
+
+  protected:
+    // Coroutine::LeafAwaitable
+    void onStart() override;
+    void onCancel() override { filter_.client_->cancel(); }
+
+  private:
+    Filter& filter_;
+    bool starting_{false};
+  };
+
+  absl::Status onLimitResponse(LimitAwaitable& response);
   void populateRateLimitDescriptors(std::vector<Envoy::RateLimit::Descriptor>& descriptors,
                                     const Http::RequestHeaderMap& headers, bool on_stream_done);
   void populateRateLimitDescriptorsForPolicy(const Router::RateLimitPolicy& rate_limit_policy,
@@ -277,17 +309,12 @@ private:
 
   Http::Context& httpContext() { return config_->httpContext(); }
 
-  enum class State { NotStarted, Calling, Complete, Responded };
-
   FilterConfigSharedPtr config_;
   Filters::Common::RateLimit::ClientPtr client_;
-  Http::StreamDecoderFilterCallbacks* callbacks_{};
-  State state_{State::NotStarted};
   VhRateLimitOptions vh_rate_limits_{};
   Upstream::ClusterInfoConstSharedPtr cluster_;
   Router::RouteConstSharedPtr route_ = nullptr;
   const FilterConfigPerRoute* route_config_ = nullptr;
-  bool initiating_call_{};
   Http::ResponseHeaderMapPtr response_headers_to_add_;
   Http::RequestHeaderMap* request_headers_{};
   std::vector<Envoy::RateLimit::Descriptor> descriptors_;
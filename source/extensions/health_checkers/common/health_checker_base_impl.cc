@@ -6,9 +6,12 @@
 #include "envoy/stats/scope.h"
 
 #include "source/common/network/utility.h"
+#include "source/common/protobuf/utility.h"
 #include "source/common/router/router.h"
 #include "source/common/runtime/runtime_features.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -40,6 +43,7 @@ HealthCheckerImplBase::HealthCheckerImplBase(const Cluster& cluster,
           PROTOBUF_GET_MS_OR_DEFAULT(config, healthy_edge_interval, interval_.count())),
       transport_socket_options_(initTransportSocketOptions(config)),
       transport_socket_match_metadata_(initTransportSocketMatchMetadata(config)),
+      config_hash_(config.share_across_clusters() ? MessageUtil::hash(config) : 0),
       member_update_cb_{cluster_.prioritySet().addMemberUpdateCb(
           [this](const HostVector& hosts_added, const HostVector& hosts_removed) {
             onClusterMemberUpdate(hosts_added, hosts_removed);
@@ -277,6 +281,9 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::onDeferredDeleteBase() {
   // implementation specific state is destroyed.
   interval_timer_.reset();
   timeout_timer_.reset();
+  if (!shared_key_.empty()) {
+    parent_.shared_health_checks_->unsubscribe(shared_key_, *this);
+  }
   if (!host_->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC)) {
     parent_.decHealthy();
     state = HealthState::Healthy;
@@ -292,7 +299,50 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::onDeferredDeleteBase() {
   }
 }
 
+void HealthCheckerImplBase::ActiveHealthCheckSession::start() {
+  if (parent_.shared_health_checks_ != nullptr) {
+    shared_key_ =
+        absl::StrCat(parent_.config_hash_, "_", host_->healthCheckAddress()->asString());
+    sends_checks_ = parent_.shared_health_checks_->subscribe(shared_key_, *this);
+  }
+  onInitialInterval();
+}
+
+void HealthCheckerImplBase::ActiveHealthCheckSession::onSharedResult(
+    const SharedHealthCheckResult& result) {
+  parent_.stats_.shared_result_.inc();
+  if (result.state_ == HealthState::Healthy) {
+    recordSuccess(result.degraded_);
+  } else {
+    recordFailure(result.failure_type_, result.retriable_, result.http_status_code_);
+  }
+}
+
+void HealthCheckerImplBase::ActiveHealthCheckSession::onSendChecks() {
+  ASSERT(!sends_checks_);
+  sends_checks_ = true;
+  const HealthState state = host_->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC)
+                                ? HealthState::Unhealthy
+                                : HealthState::Healthy;
+  interval_timer_->enableTimer(parent_.interval(state, HealthTransition::Unchanged));
+}
+
+void HealthCheckerImplBase::ActiveHealthCheckSession::publishResult(
+    const SharedHealthCheckResult& result) {
+  if (!shared_key_.empty()) {
+    parent_.shared_health_checks_->publish(shared_key_, *this, result);
+  }
+}
+
 void HealthCheckerImplBase::ActiveHealthCheckSession::handleSuccess(bool degraded) {
+  const HealthTransition changed_state = recordSuccess(degraded);
+  publishResult({HealthState::Healthy, degraded});
+
+  timeout_timer_->disableTimer();
+  interval_timer_->enableTimer(parent_.interval(HealthState::Healthy, changed_state));
+}
+
+HealthTransition HealthCheckerImplBase::ActiveHealthCheckSession::recordSuccess(bool degraded) {
   // If we are healthy, reset the # of unhealthy to zero.
   num_unhealthy_ = 0;
 
@@ -353,9 +403,7 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::handleSuccess(bool degrade
   parent_.stats_.success_.inc();
   first_check_ = false;
   parent_.runCallbacks(host_, changed_state, HealthState::Healthy);
-
-  timeout_timer_->disableTimer();
-  interval_timer_->enableTimer(parent_.interval(HealthState::Healthy, changed_state));
+  return changed_state;
 }
 
 namespace {
@@ -418,12 +466,8 @@ HealthTransition HealthCheckerImplBase::ActiveHealthCheckSession::setUnhealthy(
 
 void HealthCheckerImplBase::ActiveHealthCheckSession::handleFailure(
     envoy::data::core::v3::HealthCheckFailureType type, bool retriable, uint64_t http_status_code) {
-  HealthTransition changed_state = setUnhealthy(type, retriable, http_status_code);
-  // Clear the cached HTTP status code on non-HTTP failures so the HDS report does
-  // not ship a stale code from the last successful response.
-  if (type == envoy::data::core::v3::NETWORK || type == envoy::data::core::v3::NETWORK_TIMEOUT) {
-    host_->setLastHealthCheckHttpStatus(0);
-  }
+  const HealthTransition changed_state = recordFailure(type, retriable, http_status_code);
+  publishResult({HealthState::Unhealthy, false, type, retriable, http_status_code});
   // It's possible that the previous call caused this session to be deferred deleted.
   if (timeout_timer_ != nullptr) {
     timeout_timer_->disableTimer();
@@ -434,6 +478,17 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::handleFailure(
   }
 }
 
+HealthTransition HealthCheckerImplBase::ActiveHealthCheckSession::recordFailure(
+    envoy::data::core::v3::HealthCheckFailureType type, bool retriable, uint64_t http_status_code) {
+  const HealthTransition changed_state = setUnhealthy(type, retriable, http_status_code);
+  // Clear the cached HTTP status code on non-HTTP failures so the HDS report does
+  // not ship a stale code from the last successful response.
+  if (type == envoy::data::core::v3::NETWORK || type == envoy::data::core::v3::NETWORK_TIMEOUT) {
+    host_->setLastHealthCheckHttpStatus(0);
+  }
+  return changed_state;
+}
+
 HealthTransition
 HealthCheckerImplBase::ActiveHealthCheckSession::clearPendingFlag(HealthTransition changed_state) {
   if (host_->healthFlagGet(Host::HealthFlag::PENDING_ACTIVE_HC)) {
@@ -447,6 +502,14 @@ HealthCheckerImplBase::ActiveHealthCheckSession::clearPendingFlag(HealthTransiti
 }
 
 void HealthCheckerImplBase::ActiveHealthCheckSession::onIntervalBase() {
+  if (!sends_checks_) {
+    // Only scheduled by onInitialInterval(), to pick up the result of the last shared check.
+    const SharedHealthCheckResult* result = parent_.shared_health_checks_->lastResult(shared_key_);
+    if (result != nullptr) {
+      onSharedResult(*result);
+    }
+    return;
+  }
   onInterval();
   timeout_timer_->enableTimer(parent_.timeout_);
   parent_.stats_.attempt_.inc();
@@ -458,6 +521,12 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::onTimeoutBase() {
 }
 
 void HealthCheckerImplBase::ActiveHealthCheckSession::onInitialInterval() {
+  if (!sends_checks_) {
+    // The host starts with the result of the last check sent for another cluster, if any. This is
+    // deferred so that it is not applied while the cluster is still adding its hosts.
+    interval_timer_->enableTimer(std::chrono::milliseconds(0));
+    return;
+  }
   if (parent_.initial_jitter_.count() == 0) {
     onIntervalBase();
   } else {
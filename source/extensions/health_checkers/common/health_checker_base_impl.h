@@ -14,6 +14,7 @@
 #include "source/common/common/logger.h"
 #include "source/common/common/matchers.h"
 #include "source/common/network/transport_socket_options_impl.h"
+#include "source/extensions/health_checkers/common/shared_health_checks.h"
 
 namespace Envoy {
 namespace Upstream {
@@ -26,6 +27,7 @@ namespace Upstream {
   COUNTER(failure)                                                                                 \
   COUNTER(network_failure)                                                                         \
   COUNTER(passive_failure)                                                                         \
+  COUNTER(shared_result)                                                                           \
   COUNTER(success)                                                                                 \
   COUNTER(verify_cluster)                                                                          \
   GAUGE(degraded, Accumulate)                                                                      \
@@ -55,14 +57,28 @@ public:
     return transport_socket_match_metadata_;
   }
 
+  /**
+   * Shares the checks of the hosts with the health checkers of other clusters that have the same
+   * configuration, see HealthCheck.share_across_clusters. Must be called before start().
+   */
+  void setSharedHealthChecks(SharedHealthChecksSharedPtr shared_health_checks) {
+    ASSERT(!started_);
+    shared_health_checks_ = std::move(shared_health_checks);
+  }
+
 protected:
-  class ActiveHealthCheckSession : public Event::DeferredDeletable {
+  class ActiveHealthCheckSession : public Event::DeferredDeletable,
+                                   public SharedHealthChecks::Subscriber {
   public:
     ~ActiveHealthCheckSession() override;
     HealthTransition setUnhealthy(envoy::data::core::v3::HealthCheckFailureType type,
                                   bool retriable, uint64_t http_status_code = 0);
     void onDeferredDeleteBase();
-    void start() { onInitialInterval(); }
+    void start();
+
+    // SharedHealthChecks::Subscriber
+    void onSharedResult(const SharedHealthCheckResult& result) override;
+    void onSendChecks() override;
 
   protected:
     ActiveHealthCheckSession(HealthCheckerImplBase& parent, HostSharedPtr host);
@@ -78,6 +94,11 @@ protected:
     // been health checked.
     // Returns the changed state to use following the flag update.
     HealthTransition clearPendingFlag(HealthTransition changed_state);
+    // Update the host with the result of a check, without scheduling the next one.
+    HealthTransition recordSuccess(bool degraded);
+    HealthTransition recordFailure(envoy::data::core::v3::HealthCheckFailureType type,
+                                  bool retriable, uint64_t http_status_code);
+    void publishResult(const SharedHealthCheckResult& result);
     virtual void onInterval() PURE;
     void onIntervalBase();
     virtual void onTimeout() PURE;
@@ -92,6 +113,10 @@ protected:
     uint32_t num_healthy_{};
     bool first_check_{true};
     TimeSource& time_source_;
+    // Set when the checks of the host are shared with other clusters.
+    std::string shared_key_;
+    // False when another cluster's session sends the checks that this one applies.
+    bool sends_checks_{true};
   };
 
   using ActiveHealthCheckSessionPtr = std::unique_ptr<ActiveHealthCheckSession>;
@@ -162,6 +187,9 @@ private:
   absl::node_hash_map<HostSharedPtr, ActiveHealthCheckSessionPtr> active_sessions_;
   const std::shared_ptr<const Network::TransportSocketOptionsImpl> transport_socket_options_;
   const MetadataConstSharedPtr transport_socket_match_metadata_;
+  // Identifies the configuration of the checks shared with other clusters.
+  const uint64_t config_hash_;
+  SharedHealthChecksSharedPtr shared_health_checks_;
   const Common::CallbackHandlePtr member_update_cb_;
   bool started_{false};
 };
@@ -0,0 +1,78 @@
+#include "source/extensions/health_checkers/common/shared_health_checks.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace Envoy {
+namespace Upstream {
+
+SINGLETON_MANAGER_REGISTRATION(shared_health_checks);
+
+SharedHealthChecksSharedPtr SharedHealthChecks::get(Singleton::Manager& singleton_manager) {
+  return singleton_manager.getTyped<SharedHealthChecks>(
+      SINGLETON_MANAGER_REGISTERED_NAME(shared_health_checks),
+      [] { return std::make_shared<SharedHealthChecks>(); });
+}
+
+bool SharedHealthChecks::subscribe(const std::string& key, Subscriber& subscriber) {
+  std::list<Subscriber*>& subscribers = entries_[key].subscribers_;
+  ASSERT(std::find(subscribers.begin(), subscribers.end(), &subscriber) == subscribers.end());
+  subscribers.push_back(&subscriber);
+  return subscribers.size() == 1;
+}
+
+void SharedHealthChecks::unsubscribe(const std::string& key, Subscriber& subscriber) {
+  auto entry_it = entries_.find(key);
+  ASSERT(entry_it != entries_.end());
+  std::list<Subscriber*>& subscribers = entry_it->second.subscribers_;
+  const bool was_sending_checks = subscribers.front() == &subscriber;
+  subscribers.remove(&subscriber);
+  if (subscribers.empty()) {
+    entries_.erase(entry_it);
+    return;
+  }
+  if (was_sending_checks) {
+    subscribers.front()->onSendChecks();
+  }
+}
+
+void SharedHealthChecks::publish(const std::string& key, const Subscriber& publisher,
+                                 const SharedHealthCheckResult& result) {
+  auto entry_it = entries_.find(key);
+  if (entry_it == entries_.end()) {
+    // The publisher was the last subscriber, and was removed while handling its own result.
+    return;
+  }
+  entry_it->second.last_result_ = result;
+
+  // Applying a result can remove subscribers, e.g. when a cluster drops a host that it no longer
+  // has in its configuration once it fails its health check. So this works on a copy and skips
+  // the subscribers that are gone by the time they would be called.
+  const std::vector<Subscriber*> subscribers(entry_it->second.subscribers_.begin(),
+                                             entry_it->second.subscribers_.end());
+  for (Subscriber* subscriber : subscribers) {
+    if (subscriber != &publisher && isSubscribed(key, *subscriber)) {
+      subscriber->onSharedResult(result);
+    }
+  }
+}
+
+const SharedHealthCheckResult* SharedHealthChecks::lastResult(const std::string& key) const {
+  auto entry_it = entries_.find(key);
+  if (entry_it == entries_.end() || !entry_it->second.last_result_.has_value()) {
+    return nullptr;
+  }
+  return &entry_it->second.last_result_.value();
+}
+
+bool SharedHealthChecks::isSubscribed(const std::string& key, const Subscriber& subscriber) const {
+  auto entry_it = entries_.find(key);
+  if (entry_it == entries_.end()) {
+    return false;
+  }
+  const std::list<Subscriber*>& subscribers = entry_it->second.subscribers_;
+  return std::find(subscribers.begin(), subscribers.end(), &subscriber) != subscribers.end();
+}
+
+} // namespace Upstream
+} // namespace Envoy
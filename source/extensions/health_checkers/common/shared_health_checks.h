@@ -0,0 +1,98 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "envoy/data/core/v3/health_check_event.pb.h"
+#include "envoy/singleton/instance.h"
+#include "envoy/singleton/manager.h"
+#include "envoy/upstream/health_checker.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * The result of a health check, as applied to the hosts that share it.
+ */
+struct SharedHealthCheckResult {
+  HealthState state_;
+  // Only set for healthy results.
+  bool degraded_{};
+  // Only set for unhealthy results.
+  envoy::data::core::v3::HealthCheckFailureType failure_type_{};
+  bool retriable_{};
+  uint64_t http_status_code_{};
+};
+
+/**
+ * Shares health checks between the health checkers of different clusters, see
+ * HealthCheck.share_across_clusters. The health check sessions of the hosts that have the same
+ * key subscribe to it: the first one sends the checks and publishes their results, which are
+ * applied by the other ones. When it goes away, the next one takes over.
+ *
+ * This is only used on the main thread.
+ */
+class SharedHealthChecks : public Singleton::Instance {
+public:
+  class Subscriber {
+  public:
+    virtual ~Subscriber() = default;
+
+    /**
+     * Called on the subscribers that do not send the checks when a check completes.
+     */
+    virtual void onSharedResult(const SharedHealthCheckResult& result) PURE;
+
+    /**
+     * Called when the subscriber becomes the one that sends the checks.
+     */
+    virtual void onSendChecks() PURE;
+  };
+
+  /**
+   * @return the registry of the server.
+   */
+  static std::shared_ptr<SharedHealthChecks> get(Singleton::Manager& singleton_manager);
+
+  /**
+   * @return true if the subscriber is the first one for the key and must send the checks.
+   */
+  bool subscribe(const std::string& key, Subscriber& subscriber);
+
+  /**
+   * Removes the subscriber, which hands the checks over to the next subscriber if it was sending
+   * them.
+   */
+  void unsubscribe(const std::string& key, Subscriber& subscriber);
+
+  /**
+   * Applies the result of a check sent by the publisher to the other subscribers of the key.
+   */
+  void publish(const std::string& key, const Subscriber& publisher,
+               const SharedHealthCheckResult& result);
+
+  /**
+   * @return the result of the last check of the key, or nullptr if there was none yet.
+   */
+  const SharedHealthCheckResult* lastResult(const std::string& key) const;
+
+private:
+  struct Entry {
+    // The first subscriber sends the checks.
+    std::list<Subscriber*> subscribers_;
+    std::optional<SharedHealthCheckResult> last_result_;
+  };
+
+  bool isSubscribed(const std::string& key, const Subscriber& subscriber) const;
+
+  absl::flat_hash_map<std::string, Entry> entries_;
+};
+
+using SharedHealthChecksSharedPtr = std::shared_ptr<SharedHealthChecks>;
+
+} // namespace Upstream
+} // namespace Envoy
@@ -45,9 +45,14 @@ const std::string& getHostname(const HostSharedPtr& host,
 Upstream::HealthCheckerSharedPtr GrpcHealthCheckerFactory::createCustomHealthChecker(
     const envoy::config::core::v3::HealthCheck& config,
     Server::Configuration::HealthCheckerFactoryContext& context) {
-  return std::make_shared<ProdGrpcHealthCheckerImpl>(
+  auto health_checker = std::make_shared<ProdGrpcHealthCheckerImpl>(
       context.cluster(), config, context.mainThreadDispatcher(), context.runtime(),
       context.api().randomGenerator(), context.eventLogger());
+  if (config.share_across_clusters()) {
+    health_checker->setSharedHealthChecks(
+        SharedHealthChecks::get(context.serverFactoryContext().singletonManager()));
+  }
+  return health_checker;
 }
 
 REGISTER_FACTORY(GrpcHealthCheckerFactory, Server::Configuration::CustomHealthCheckerFactory);
@@ -48,8 +48,13 @@ getMethod(const envoy::config::core::v3::RequestMethod config_method) {
 Upstream::HealthCheckerSharedPtr HttpHealthCheckerFactory::createCustomHealthChecker(
     const envoy::config::core::v3::HealthCheck& config,
     Server::Configuration::HealthCheckerFactoryContext& context) {
-  return std::make_shared<ProdHttpHealthCheckerImpl>(context.cluster(), config, context,
-                                                     context.eventLogger());
+  auto health_checker = std::make_shared<ProdHttpHealthCheckerImpl>(context.cluster(), config,
+                                                                    context, context.eventLogger());
+  if (config.share_across_clusters()) {
+    health_checker->setSharedHealthChecks(
+        SharedHealthChecks::get(context.serverFactoryContext().singletonManager()));
+  }
+  return health_checker;
 }
 
 REGISTER_FACTORY(HttpHealthCheckerFactory, Server::Configuration::CustomHealthCheckerFactory);
@@ -69,10 +69,11 @@ ClientSideWeightedRoundRobinLoadBalancer::WorkerLocalLb::WorkerLocalLb(
   if (tls_shim.has_value()) {
     apply_weights_cb_handle_ = tls_shim->apply_weights_cb_helper_.add([this]() {
       // Refresh the EDF scheduler on the hosts in priority set of the
-      // worker-local load balancer on the worker thread.
+      // worker-local load balancer on the worker thread. Only the weights changed, so the
+      // schedulers are rebuilt even though the hosts are the same.
       for (const HostSetPtr& host_set : priority_set_.hostSetsPerPriority()) {
         if (host_set != nullptr) {
-          refresh(host_set->priority());
+          forceRefresh(host_set->priority());
         }
       }
     });
@@ -407,6 +407,12 @@ uint64_t LoadBalancerBase::random(bool peeking) {
   }
 }
 
+bool LoadBalancerBase::sameHostsSnapshot(const std::weak_ptr<const void>& built_from,
+                                         const std::shared_ptr<const void>& current) {
+  return current != nullptr && !built_from.owner_before(current) &&
+         !current.owner_before(built_from);
+}
+
 ZoneAwareLoadBalancerBase::ZoneAwareLoadBalancerBase(
     const PrioritySet& priority_set, const PrioritySet* local_priority_set, ClusterLbStats& stats,
     Runtime::Loader& runtime, Random::RandomGenerator& random, uint32_t healthy_panic_threshold,
@@ -1037,9 +1043,22 @@ void EdfLoadBalancerBase::refresh(uint32_t priority) {
   if (priority >= priority_set_.hostSetsPerPriority().size()) {
     return;
   }
-  const auto add_hosts_source = [this](HostsSource source, const HostVector& hosts) {
+  // Health changes only replace the partitions they affect (see HostSetImpl::repartitionHosts()),
+  // so the schedulers of the other partitions are kept. Slow start weights change over time, so
+  // with slow start every refresh rebuilds the schedulers.
+  const bool keep_unchanged =
+      !isSlowStartEnabled() &&
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.incremental_host_health_updates");
+  const auto add_hosts_source = [this, keep_unchanged](
+                                    HostsSource source, const HostVector& hosts,
+                                    const std::shared_ptr<const void>& hosts_snapshot) {
+    auto& scheduler = scheduler_[source];
+    if (keep_unchanged && sameHostsSnapshot(scheduler.hosts_snapshot_, hosts_snapshot)) {
+      return;
+    }
     // Nuke existing scheduler if it exists.
-    auto& scheduler = scheduler_[source] = Scheduler{};
+    scheduler = Scheduler{};
+    scheduler.hosts_snapshot_ = hosts_snapshot;
     refreshHostSource(source);
     if (isSlowStartEnabled()) {
       recalculateHostsInSlowStart(hosts);
@@ -1076,23 +1095,38 @@ void EdfLoadBalancerBase::refresh(uint32_t priority) {
   };
   // Populate EdfSchedulers for each valid HostsSource value for the host set at this priority.
   const auto& host_set = priority_set_.hostSetsPerPriority()[priority];
-  add_hosts_source(HostsSource(priority, HostsSource::SourceType::AllHosts), host_set->hosts());
+  add_hosts_source(HostsSource(priority, HostsSource::SourceType::AllHosts), host_set->hosts(),
+                   host_set->hostsPtr());
   add_hosts_source(HostsSource(priority, HostsSource::SourceType::HealthyHosts),
-                   host_set->healthyHosts());
+                   host_set->healthyHosts(), host_set->healthyHostsPtr());
   add_hosts_source(HostsSource(priority, HostsSource::SourceType::DegradedHosts),
-                   host_set->degradedHosts());
+                   host_set->degradedHosts(), host_set->degradedHostsPtr());
+  // The per locality sources share the snapshot of all localities.
+  const HostsPerLocalityConstSharedPtr healthy_hosts_per_locality =
+      host_set->healthyHostsPerLocalityPtr();
   for (uint32_t locality_index = 0;
        locality_index < host_set->healthyHostsPerLocality().get().size(); ++locality_index) {
     add_hosts_source(
         HostsSource(priority, HostsSource::SourceType::LocalityHealthyHosts, locality_index),
-        host_set->healthyHostsPerLocality().get()[locality_index]);
+        host_set->healthyHostsPerLocality().get()[locality_index], healthy_hosts_per_locality);
   }
+  const HostsPerLocalityConstSharedPtr degraded_hosts_per_locality =
+      host_set->degradedHostsPerLocalityPtr();
   for (uint32_t locality_index = 0;
        locality_index < host_set->degradedHostsPerLocality().get().size(); ++locality_index) {
     add_hosts_source(
         HostsSource(priority, HostsSource::SourceType::LocalityDegradedHosts, locality_index),
-        host_set->degradedHostsPerLocality().get()[locality_index]);
+        host_set->degradedHostsPerLocality().get()[locality_index], degraded_hosts_per_locality);
+  }
+}
+
+void EdfLoadBalancerBase::forceRefresh(uint32_t priority) {
+  for (auto& [source, scheduler] : scheduler_) {
+    if (source.priority_ == priority) {
+      scheduler.hosts_snapshot_.reset();
+    }
   }
+  refresh(priority);
 }
 
 bool EdfLoadBalancerBase::isSlowStartEnabled() const {
@@ -193,6 +193,14 @@ protected:
   bool isInPanic(uint32_t priority) const { return per_priority_panic_[priority]; }
   uint64_t random(bool peeking);
 
+  /**
+   * @return true if built_from refers to the same, non-null, host set snapshot as current.
+   * Comparing the owners rather than the addresses cannot mistake a new snapshot for one that was
+   * freed.
+   */
+  static bool sameHostsSnapshot(const std::weak_ptr<const void>& built_from,
+                                const std::shared_ptr<const void>& current);
+
   ClusterLbStats& stats_;
   Runtime::Loader& runtime_;
   std::deque<uint64_t> stashed_random_;
@@ -532,12 +540,25 @@ protected:
     // host weights of 2 or more hosts differ. When not present, the
     // implementation of chooseHostOnce falls back to unweightedHostPick.
     std::unique_ptr<EdfScheduler<Host>> edf_;
+    // The host set snapshot the scheduler was built from. Host set snapshots are immutable, so a
+    // refresh that finds the same snapshot keeps the scheduler. A weak reference is enough to
+    // compare snapshots, and does not keep removed hosts alive.
+    std::weak_ptr<const void> hosts_snapshot_;
   };
 
   void initialize();
 
+  /**
+   * Rebuilds the schedulers of the host sources at the given priority whose hosts changed.
+   */
   virtual void refresh(uint32_t priority);
 
+  /**
+   * Rebuilds all the schedulers at the given priority, for when host weights changed without the
+   * hosts changing.
+   */
+  void forceRefresh(uint32_t priority);
+
   bool isSlowStartEnabled() const;
   bool noHostsAreInSlowStart() const;
 
@@ -70,12 +70,31 @@ void normalizeLocalityWeights(const HostsPerLocality& hosts_per_locality,
   }
 }
 
+bool useLocalityWeights(const HostSet& host_set, bool locality_weighted_balancing) {
+  return locality_weighted_balancing && host_set.localityWeights() != nullptr &&
+         !host_set.localityWeights()->empty();
+}
+
+// Returns the snapshot of the hosts normalizeWeights() reads.
+std::shared_ptr<const void> hostsSnapshot(const HostSet& host_set, bool in_panic,
+                                          bool locality_weighted_balancing) {
+  if (!useLocalityWeights(host_set, locality_weighted_balancing)) {
+    if (in_panic) {
+      return host_set.hostsPtr();
+    }
+    return host_set.healthyHostsPtr();
+  }
+  if (in_panic) {
+    return host_set.hostsPerLocalityPtr();
+  }
+  return host_set.healthyHostsPerLocalityPtr();
+}
+
 void normalizeWeights(const HostSet& host_set, bool in_panic,
                       NormalizedHostWeightVector& normalized_host_weights,
                       double& min_normalized_weight, double& max_normalized_weight,
                       bool locality_weighted_balancing) {
-  if (!locality_weighted_balancing || host_set.localityWeights() == nullptr ||
-      host_set.localityWeights()->empty()) {
+  if (!useLocalityWeights(host_set, locality_weighted_balancing)) {
     // If we're not dealing with locality weights, just normalize weights for the flat set of hosts.
     const auto& hosts = in_panic ? host_set.hosts() : host_set.healthyHosts();
     normalizeHostWeights(hosts, 1.0, normalized_host_weights, min_normalized_weight,
@@ -150,6 +169,14 @@ absl::Status ThreadAwareLoadBalancerBase::initialize() {
 }
 
 void ThreadAwareLoadBalancerBase::refresh() {
+  // Only the main thread publishes the state, so it is read here to reuse the tables of the
+  // priorities whose hosts did not change.
+  std::shared_ptr<std::vector<PerPriorityStatePtr>> previous_per_priority_state;
+  {
+    absl::ReaderMutexLock lock(factory_->mutex_);
+    previous_per_priority_state = factory_->per_priority_state_;
+  }
+
   auto per_priority_state_vector = std::make_shared<std::vector<PerPriorityStatePtr>>(
       priority_set_.hostSetsPerPriority().size());
   auto healthy_per_priority_load =
@@ -166,6 +193,27 @@ void ThreadAwareLoadBalancerBase::refresh() {
     ASSERT(priority < per_priority_panic_.size());
     per_priority_state->global_panic_ = per_priority_panic_[priority];
 
+    // Host set snapshots are immutable, and the table of a priority only depends on the hosts
+    // and the locality weights it was built from. When both are the same as for the previous
+    // table, typically because another priority was updated, the previous table is shared with
+    // the new state rather than rebuilt.
+    const std::shared_ptr<const void> hosts_snapshot =
+        hostsSnapshot(*host_set, per_priority_state->global_panic_, locality_weighted_balancing_);
+    const LocalityWeightsConstSharedPtr locality_weights =
+        useLocalityWeights(*host_set, locality_weighted_balancing_) ? host_set->localityWeights()
+                                                                    : nullptr;
+    per_priority_state->hosts_snapshot_ = hosts_snapshot;
+    per_priority_state->locality_weights_snapshot_ = locality_weights;
+    if (previous_per_priority_state != nullptr && priority < previous_per_priority_state->size()) {
+      const auto& previous = (*previous_per_priority_state)[priority];
+      if (previous != nullptr && sameHostsSnapshot(previous->hosts_snapshot_, hosts_snapshot) &&
+          (locality_weights == nullptr ||
+           sameHostsSnapshot(previous->locality_weights_snapshot_, locality_weights))) {
+        per_priority_state->current_lb_ = previous->current_lb_;
+        continue;
+      }
+    }
+
     // Normalize host and locality weights such that the sum of all normalized weights is 1.
     NormalizedHostWeightVector normalized_host_weights;
     double min_normalized_weight = 1.0;
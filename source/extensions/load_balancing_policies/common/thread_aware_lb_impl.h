@@ -123,6 +123,10 @@ private:
   struct PerPriorityState {
     std::shared_ptr<HashingLoadBalancer> current_lb_;
     bool global_panic_{};
+    // The host set snapshots current_lb_ was built from. Only used on the main thread, to tell
+    // whether refresh() can reuse current_lb_.
+    std::weak_ptr<const void> hosts_snapshot_;
+    std::weak_ptr<const void> locality_weights_snapshot_;
   };
   using PerPriorityStatePtr = std::unique_ptr<PerPriorityState>;
 
@@ -11,6 +11,15 @@ uint64_t LeastRequestLoadBalancer::effectiveActiveRequests(const Host& host) con
   return active;
 }
 
+uint64_t
+LeastRequestLoadBalancer::effectiveActiveRequests(const ActiveRequestGauges& gauges) const {
+  uint64_t active = gauges.rq_active_->value();
+  if (count_pending_requests_) {
+    active += gauges.rq_pending_active_->value();
+  }
+  return active;
+}
+
 double LeastRequestLoadBalancer::hostWeight(const Host& host) const {
   // This method is called to calculate the dynamic weight as following when all load balancing
   // weights are not equal:
@@ -53,6 +62,16 @@ double LeastRequestLoadBalancer::hostWeight(const Host& host) const {
   }
 }
 
+void LeastRequestLoadBalancer::refreshHostSource(const HostsSource& source) {
+  const HostVector& hosts = hostSourceToHosts(source);
+  ActiveRequestGaugesVector& gauges = active_request_gauges_[source];
+  gauges.clear();
+  gauges.reserve(hosts.size());
+  for (const HostSharedPtr& host : hosts) {
+    gauges.push_back({&host->stats().rq_active_, &host->stats().rq_pending_active_});
+  }
+}
+
 HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPeek(const HostVector&,
                                                                 const HostsSource&) {
   // LeastRequestLoadBalancer can not do deterministic preconnecting, because
@@ -62,15 +81,20 @@ HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPeek(const HostVector
 }
 
 HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPick(const HostVector& hosts_to_use,
-                                                                const HostsSource&) {
+                                                                const HostsSource& source) {
   HostSharedPtr candidate_host = nullptr;
+  auto gauges_it = active_request_gauges_.find(source);
+  // We should always have the gauges of any host source we pick from via refreshHostSource().
+  ASSERT(gauges_it != active_request_gauges_.end() &&
+         gauges_it->second.size() == hosts_to_use.size());
+  const ActiveRequestGaugesVector& gauges = gauges_it->second;
 
   switch (selection_method_) {
   case envoy::extensions::load_balancing_policies::least_request::v3::LeastRequest::FULL_SCAN:
-    candidate_host = unweightedHostPickFullScan(hosts_to_use);
+    candidate_host = unweightedHostPickFullScan(hosts_to_use, gauges);
     break;
   case envoy::extensions::load_balancing_policies::least_request::v3::LeastRequest::N_CHOICES:
-    candidate_host = unweightedHostPickNChoices(hosts_to_use);
+    candidate_host = unweightedHostPickNChoices(hosts_to_use, gauges);
     break;
   default:
     IS_ENVOY_BUG("unknown selection method specified for least request load balancer");
@@ -79,72 +103,65 @@ HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPick(const HostVector
   return candidate_host;
 }
 
-HostSharedPtr LeastRequestLoadBalancer::unweightedHostPickFullScan(const HostVector& hosts_to_use) {
-  HostSharedPtr candidate_host = nullptr;
-
-  size_t num_hosts_known_tied_for_least = 0;
+HostSharedPtr
+LeastRequestLoadBalancer::unweightedHostPickFullScan(const HostVector& hosts_to_use,
+                                                     const ActiveRequestGaugesVector& gauges) {
+  size_t candidate_index = 0;
+  uint64_t candidate_active_rq = effectiveActiveRequests(gauges[0]);
+  size_t num_hosts_known_tied_for_least = 1;
 
   const size_t num_hosts = hosts_to_use.size();
 
-  for (size_t i = 0; i < num_hosts; ++i) {
-    const HostSharedPtr& sampled_host = hosts_to_use[i];
-
-    if (candidate_host == nullptr) {
-      // Make a first choice to start the comparisons.
-      num_hosts_known_tied_for_least = 1;
-      candidate_host = sampled_host;
-      continue;
-    }
-
-    const auto candidate_active_rq = effectiveActiveRequests(*candidate_host);
-    const auto sampled_active_rq = effectiveActiveRequests(*sampled_host);
+  for (size_t i = 1; i < num_hosts; ++i) {
+    const uint64_t sampled_active_rq = effectiveActiveRequests(gauges[i]);
 
     if (sampled_active_rq < candidate_active_rq) {
       // Reset the count of known tied hosts.
       num_hosts_known_tied_for_least = 1;
-      candidate_host = sampled_host;
+      candidate_index = i;
+      candidate_active_rq = sampled_active_rq;
     } else if (sampled_active_rq == candidate_active_rq) {
       ++num_hosts_known_tied_for_least;
 
       // Use reservoir sampling to select 1 unique sample from the total number of hosts N
       // that will tie for least requests after processing the full hosts array.
       //
-      // Upon each new tie encountered, replace candidate_host with sampled_host
+      // Upon each new tie encountered, replace the candidate with the sampled host
       // with probability (1 / num_hosts_known_tied_for_least percent).
       // The end result is that each tied host has an equal 1 / N chance of being the
-      // candidate_host returned by this function.
+      // candidate returned by this function.
       const size_t random_tied_host_index = random_.random() % num_hosts_known_tied_for_least;
       if (random_tied_host_index == 0) {
-        candidate_host = sampled_host;
+        candidate_index = i;
       }
     }
   }
 
-  return candidate_host;
+  return hosts_to_use[candidate_index];
 }
 
-HostSharedPtr LeastRequestLoadBalancer::unweightedHostPickNChoices(const HostVector& hosts_to_use) {
-  HostSharedPtr candidate_host = nullptr;
+HostSharedPtr
+LeastRequestLoadBalancer::unweightedHostPickNChoices(const HostVector& hosts_to_use,
+                                                     const ActiveRequestGaugesVector& gauges) {
+  if (choice_count_ == 0) {
+    return nullptr;
+  }
 
-  for (uint32_t choice_idx = 0; choice_idx < choice_count_; ++choice_idx) {
-    const int rand_idx = random_.random() % hosts_to_use.size();
-    const HostSharedPtr& sampled_host = hosts_to_use[rand_idx];
+  // Make a first choice to start the comparisons.
+  size_t candidate_index = random_.random() % hosts_to_use.size();
+  uint64_t candidate_active_rq = effectiveActiveRequests(gauges[candidate_index]);
 
-    if (candidate_host == nullptr) {
-      // Make a first choice to start the comparisons.
-      candidate_host = sampled_host;
-      continue;
-    }
-
-    const auto candidate_active_rq = effectiveActiveRequests(*candidate_host);
-    const auto sampled_active_rq = effectiveActiveRequests(*sampled_host);
+  for (uint32_t choice_idx = 1; choice_idx < choice_count_; ++choice_idx) {
+    const size_t rand_idx = random_.random() % hosts_to_use.size();
+    const uint64_t sampled_active_rq = effectiveActiveRequests(gauges[rand_idx]);
 
     if (sampled_active_rq < candidate_active_rq) {
-      candidate_host = sampled_host;
+      candidate_index = rand_idx;
+      candidate_active_rq = sampled_active_rq;
     }
   }
 
-  return candidate_host;
+  return hosts_to_use[candidate_index];
 }
 
 } // namespace Upstream
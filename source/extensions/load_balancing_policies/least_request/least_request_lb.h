@@ -65,18 +65,34 @@ protected:
   }
 
 private:
-  void refreshHostSource(const HostsSource&) override {}
+  // The active request gauges of a host, which live in the host.
+  struct ActiveRequestGauges {
+    const Stats::PrimitiveGauge* rq_active_;
+    const Stats::PrimitiveGauge* rq_pending_active_;
+  };
+  using ActiveRequestGaugesVector = std::vector<ActiveRequestGauges>;
+
+  void refreshHostSource(const HostsSource& source) override;
   double hostWeight(const Host& host) const override;
   HostConstSharedPtr unweightedHostPeek(const HostVector& hosts_to_use,
                                         const HostsSource& source) override;
   HostConstSharedPtr unweightedHostPick(const HostVector& hosts_to_use,
                                         const HostsSource& source) override;
-  HostSharedPtr unweightedHostPickFullScan(const HostVector& hosts_to_use);
-  HostSharedPtr unweightedHostPickNChoices(const HostVector& hosts_to_use);
+  HostSharedPtr unweightedHostPickFullScan(const HostVector& hosts_to_use,
+                                           const ActiveRequestGaugesVector& gauges);
+  HostSharedPtr unweightedHostPickNChoices(const HostVector& hosts_to_use,
+                                           const ActiveRequestGaugesVector& gauges);
   uint64_t effectiveActiveRequests(const Host& host) const;
+  uint64_t effectiveActiveRequests(const ActiveRequestGauges& gauges) const;
 
   const uint32_t choice_count_;
 
+  // The active request gauges of the hosts of each host source, in the order of the hosts. The
+  // unweighted picks compare the sampled hosts through this contiguous array, without touching
+  // the hosts themselves or copying their shared pointers, until the chosen one is returned.
+  absl::flat_hash_map<HostsSource, ActiveRequestGaugesVector, HostsSourceHash>
+      active_request_gauges_;
+
   // The exponent used to calculate host weights can be configured via runtime. We cache it for
   // performance reasons and refresh it in `LeastRequestLoadBalancer::refresh(uint32_t priority)`
   // whenever a `HostSet` is updated.
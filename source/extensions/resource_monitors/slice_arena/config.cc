@@ -0,0 +1,32 @@
+#include "source/extensions/resource_monitors/slice_arena/config.h"
+
+#include "envoy/extensions/resource_monitors/slice_arena/v3/slice_arena.pb.h"
+#include "envoy/extensions/resource_monitors/slice_arena/v3/slice_arena.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "source/common/buffer/slice_arena.h"
+#include "source/extensions/resource_monitors/slice_arena/slice_arena_monitor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace SliceArenaMonitor {
+
+Server::ResourceMonitorPtr SliceArenaMonitorFactory::createResourceMonitorFromProtoTyped(
+    const envoy::extensions::resource_monitors::slice_arena::v3::SliceArenaConfig& config,
+    Server::Configuration::ResourceMonitorFactoryContext& /*unused_context*/) {
+  // The overload manager is created before the workers are started, so every worker sees the
+  // arenas enabled from its first read.
+  Buffer::SliceArena::configure(config.max_arena_size_bytes());
+  return std::make_unique<SliceArenaMonitor>();
+}
+
+/**
+ * Static registration for the slice arena resource monitor factory. @see RegistryFactory.
+ */
+REGISTER_FACTORY(SliceArenaMonitorFactory, Server::Configuration::ResourceMonitorFactory);
+
+} // namespace SliceArenaMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
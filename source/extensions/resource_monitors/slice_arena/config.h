@@ -0,0 +1,29 @@
+#pragma once
+
+#include "envoy/extensions/resource_monitors/slice_arena/v3/slice_arena.pb.h"
+#include "envoy/extensions/resource_monitors/slice_arena/v3/slice_arena.pb.validate.h"
+#include "envoy/server/resource_monitor_config.h"
+
+#include "source/extensions/resource_monitors/common/factory_base.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace SliceArenaMonitor {
+
+class SliceArenaMonitorFactory
+    : public Common::FactoryBase<
+          envoy::extensions::resource_monitors::slice_arena::v3::SliceArenaConfig> {
+public:
+  SliceArenaMonitorFactory() : FactoryBase("envoy.resource_monitors.slice_arena") {}
+
+private:
+  Server::ResourceMonitorPtr createResourceMonitorFromProtoTyped(
+      const envoy::extensions::resource_monitors::slice_arena::v3::SliceArenaConfig& config,
+      Server::Configuration::ResourceMonitorFactoryContext& context) override;
+};
+
+} // namespace SliceArenaMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,29 @@
+#include "source/extensions/resource_monitors/slice_arena/slice_arena_monitor.h"
+
+#include "source/common/common/logger.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace SliceArenaMonitor {
+
+SliceArenaMonitor::SliceArenaMonitor(std::unique_ptr<SliceArenaStatsReader> stats)
+    : stats_(std::move(stats)) {}
+
+void SliceArenaMonitor::updateResourceUsage(Server::ResourceUpdateCallbacks& callbacks) {
+  const Buffer::SliceArenaStats stats = stats_->stats();
+
+  Server::ResourceUsage usage;
+  usage.resource_pressure_ = stats.max_pressure_;
+
+  ENVOY_LOG_MISC(trace, "SliceArenaMonitor: arenas={}, reserved={}, in_use={}, pressure={}",
+                 stats.arenas_, stats.reserved_bytes_, stats.in_use_bytes_,
+                 usage.resource_pressure_);
+
+  callbacks.onSuccess(usage);
+}
+
+} // namespace SliceArenaMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
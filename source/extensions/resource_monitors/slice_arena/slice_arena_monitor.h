@@ -0,0 +1,41 @@
+#pragma once
+
+#include <memory>
+
+#include "envoy/server/resource_monitor.h"
+
+#include "source/common/buffer/slice_arena.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace SliceArenaMonitor {
+
+/**
+ * Helper class for getting slice arena usage.
+ */
+class SliceArenaStatsReader {
+public:
+  virtual ~SliceArenaStatsReader() = default;
+
+  virtual Buffer::SliceArenaStats stats() { return Buffer::SliceArena::stats(); }
+};
+
+/**
+ * Reports the pressure of the most utilized per-thread buffer slice arena.
+ */
+class SliceArenaMonitor : public Server::ResourceMonitor {
+public:
+  SliceArenaMonitor(
+      std::unique_ptr<SliceArenaStatsReader> stats = std::make_unique<SliceArenaStatsReader>());
+
+  void updateResourceUsage(Server::ResourceUpdateCallbacks& callbacks) override;
+
+private:
+  std::unique_ptr<SliceArenaStatsReader> stats_;
+};
+
+} // namespace SliceArenaMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,53 @@
+#include "source/extensions/stat_sinks/shared_memory/config.h"
+
+#include <memory>
+
+#include "envoy/extensions/stat_sinks/shared_memory/v3/shared_memory.pb.h"
+#include "envoy/extensions/stat_sinks/shared_memory/v3/shared_memory.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/stat_sinks/shared_memory/shared_memory_sink.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace SharedMemory {
+
+namespace {
+
+constexpr uint32_t DefaultMaxStats = 65536;
+constexpr uint64_t DefaultNameBytesPerStat = 128;
+
+} // namespace
+
+absl::StatusOr<Stats::SinkPtr>
+SharedMemoryStatsSinkFactory::createStatsSink(const Protobuf::Message& config,
+                                              Server::Configuration::ServerFactoryContext& server) {
+  const auto& sink_config = MessageUtil::downcastAndValidate<
+      const envoy::extensions::stat_sinks::shared_memory::v3::SharedMemoryStatsSink&>(
+      config, server.messageValidationContext().staticValidationVisitor());
+  const uint32_t max_stats =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(sink_config, max_stats, DefaultMaxStats);
+  const uint64_t max_name_bytes = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+      sink_config, max_name_bytes, max_stats * DefaultNameBytesPerStat);
+  absl::StatusOr<SharedMemoryStatsSinkPtr> sink = SharedMemoryStatsSink::create(
+      sink_config.path(), max_stats, max_name_bytes, server.scope().symbolTable());
+  RETURN_IF_NOT_OK_REF(sink.status());
+  return std::move(sink.value());
+}
+
+ProtobufTypes::MessagePtr SharedMemoryStatsSinkFactory::createEmptyConfigProto() {
+  return std::make_unique<
+      envoy::extensions::stat_sinks::shared_memory::v3::SharedMemoryStatsSink>();
+}
+
+/**
+ * Static registration for the shared memory stats sink factory. @see RegisterFactory.
+ */
+REGISTER_FACTORY(SharedMemoryStatsSinkFactory, Server::Configuration::StatsSinkFactory);
+
+} // namespace SharedMemory
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
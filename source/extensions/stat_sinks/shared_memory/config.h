@@ -0,0 +1,32 @@
+#pragma once
+
+#include "envoy/server/instance.h"
+
+#include "source/server/configuration_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace SharedMemory {
+
+/**
+ * Config registration for the shared memory stats sink. @see StatsSinkFactory.
+ */
+class SharedMemoryStatsSinkFactory : public Server::Configuration::StatsSinkFactory {
+public:
+  // StatsSinkFactory
+  absl::StatusOr<Stats::SinkPtr>
+  createStatsSink(const Protobuf::Message& config,
+                  Server::Configuration::ServerFactoryContext& server) override;
+
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override;
+
+  std::string name() const override { return "envoy.stat_sinks.shared_memory"; }
+};
+
+DECLARE_FACTORY(SharedMemoryStatsSinkFactory);
+
+} // namespace SharedMemory
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace SharedMemory {
+
+/**
+ * Layout of the file published by the shared memory stats sink. The file holds a SegmentHeader,
+ * followed by SegmentHeader::capacity_ SegmentEntry slots, followed by
+ * SegmentHeader::names_capacity_ bytes of stat names. All integers are in host byte order, as the
+ * file is only meant to be read on the host that wrote it.
+ *
+ * A slot is assigned to a stat the first time it is flushed and is never reused, so that readers
+ * can cache the slot index of the stats they are interested in. The name fields of a slot are
+ * written before SegmentHeader::num_entries_ is advanced past it and never change afterwards.
+ *
+ * Values are published under a sequence lock: SegmentHeader::sequence_ is odd while a flush is in
+ * progress, and a reader that sees the same even sequence before and after copying the values has
+ * a consistent snapshot of a single flush.
+ *
+ * Changes to this layout that are not backwards compatible must bump SegmentVersion.
+ */
+constexpr char SegmentMagic[8] = {'E', 'N', 'V', 'O', 'Y', 'S', 'T', 'S'};
+constexpr uint32_t SegmentVersion = 1;
+
+enum class EntryType : uint32_t {
+  Counter = 0,
+  Gauge = 1,
+};
+
+// Set in SegmentEntry::flags_ when the stat was not present in the last flush, e.g. because the
+// scope that owned it was deleted. The slot keeps the last published value.
+constexpr uint32_t EntryFlagStale = 0x1;
+
+struct SegmentHeader {
+  char magic_[8];
+  uint32_t version_;
+  uint32_t header_size_;
+  uint32_t entry_size_;
+  uint32_t capacity_;
+  uint64_t names_offset_;
+  uint64_t names_capacity_;
+  // Process id of the Envoy that owns the file.
+  uint64_t pid_;
+  std::atomic<uint64_t> sequence_;
+  std::atomic<uint32_t> num_entries_;
+  uint32_t reserved_;
+  // Time of the last flush, in milliseconds since the epoch.
+  std::atomic<uint64_t> flush_time_ms_;
+  // Number of stats that were not published because the file was full.
+  std::atomic<uint64_t> dropped_;
+};
+
+struct SegmentEntry {
+  std::atomic<uint64_t> value_;
+  // Offset of the name from the start of the names region.
+  uint64_t name_offset_;
+  uint32_t name_length_;
+  EntryType type_;
+  std::atomic<uint32_t> flags_;
+  uint32_t reserved_;
+};
+
+// The file is shared between processes, so the atomics must be lock free and the structs must
+// have the same layout in every process.
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+static_assert(std::is_standard_layout_v<SegmentHeader>);
+static_assert(std::is_standard_layout_v<SegmentEntry>);
+static_assert(sizeof(SegmentHeader) == 80);
+static_assert(sizeof(SegmentEntry) == 32);
+
+/**
+ * @return the size of a segment with the given capacities.
+ */
+constexpr uint64_t segmentSize(uint32_t capacity, uint64_t names_capacity) {
+  return sizeof(SegmentHeader) + uint64_t(capacity) * sizeof(SegmentEntry) + names_capacity;
+}
+
+} // namespace SharedMemory
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,124 @@
+#include "source/extensions/stat_sinks/shared_memory/segment_reader.h"
+
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace SharedMemory {
+
+absl::StatusOr<SegmentReaderPtr> SegmentReader::open(const std::string& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    return absl::NotFoundError(absl::StrCat("cannot open ", path, ": ", strerror(errno)));
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == -1) {
+    const int error = errno;
+    close(fd);
+    return absl::InternalError(absl::StrCat("cannot stat ", path, ": ", strerror(error)));
+  }
+  const uint64_t size = file_stat.st_size;
+  if (size < sizeof(SegmentHeader)) {
+    close(fd);
+    return absl::FailedPreconditionError(absl::StrCat(path, " is not initialized"));
+  }
+  void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  const int error = errno;
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return absl::InternalError(absl::StrCat("cannot map ", path, ": ", strerror(error)));
+  }
+
+  const SegmentHeader& header = *static_cast<const SegmentHeader*>(mapping);
+  // The magic is written last, see SharedMemoryStatsSink::create().
+  const bool initialized = memcmp(header.magic_, SegmentMagic, sizeof(SegmentMagic)) == 0;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  absl::Status status;
+  if (!initialized) {
+    status = absl::FailedPreconditionError(absl::StrCat(path, " is not initialized"));
+  } else if (header.version_ != SegmentVersion || header.header_size_ != sizeof(SegmentHeader) ||
+             header.entry_size_ != sizeof(SegmentEntry)) {
+    status = absl::FailedPreconditionError(
+        absl::StrCat(path, " has unsupported layout version ", header.version_));
+  } else if (header.names_offset_ != segmentSize(header.capacity_, 0) ||
+             segmentSize(header.capacity_, header.names_capacity_) > size) {
+    status = absl::FailedPreconditionError(absl::StrCat(path, " is truncated"));
+  }
+  if (!status.ok()) {
+    munmap(mapping, size);
+    return status;
+  }
+  return SegmentReaderPtr(new SegmentReader(mapping, size));
+}
+
+SegmentReader::SegmentReader(const void* mapping, uint64_t size)
+    : mapping_(mapping), size_(size), header_(*static_cast<const SegmentHeader*>(mapping)),
+      entries_(reinterpret_cast<const SegmentEntry*>(static_cast<const char*>(mapping) +
+                                                     sizeof(SegmentHeader))),
+      names_(static_cast<const char*>(mapping) + header_.names_offset_) {}
+
+SegmentReader::~SegmentReader() { munmap(const_cast<void*>(mapping_), size_); }
+
+absl::Status SegmentReader::read(Snapshot& snapshot, uint32_t max_attempts) {
+  for (uint32_t attempt = 0; attempt < max_attempts; ++attempt) {
+    const uint64_t sequence = header_.sequence_.load(std::memory_order_acquire);
+    if (sequence & 1) {
+      // A flush is in progress.
+      sched_yield();
+      continue;
+    }
+    const uint32_t num_entries =
+        std::min(header_.num_entries_.load(std::memory_order_acquire), header_.capacity_);
+    absl::Status status = loadNames(num_entries);
+    if (!status.ok()) {
+      return status;
+    }
+
+    snapshot.entries_.resize(num_entries);
+    for (uint32_t i = 0; i < num_entries; ++i) {
+      const SegmentEntry& entry = entries_[i];
+      Entry& out = snapshot.entries_[i];
+      out.name_ = names_cache_[i];
+      out.type_ = entry.type_;
+      out.value_ = entry.value_.load(std::memory_order_relaxed);
+      out.stale_ = (entry.flags_.load(std::memory_order_relaxed) & EntryFlagStale) != 0;
+    }
+    snapshot.flush_time_ms_ = header_.flush_time_ms_.load(std::memory_order_relaxed);
+    snapshot.dropped_ = header_.dropped_.load(std::memory_order_relaxed);
+
+    // Orders the loads above before the sequence is checked again.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (header_.sequence_.load(std::memory_order_relaxed) == sequence) {
+      return absl::OkStatus();
+    }
+  }
+  return absl::UnavailableError("stats were being flushed on every read attempt");
+}
+
+absl::Status SegmentReader::loadNames(uint32_t num_entries) {
+  for (uint32_t i = names_cache_.size(); i < num_entries; ++i) {
+    const SegmentEntry& entry = entries_[i];
+    if (entry.name_offset_ > header_.names_capacity_ ||
+        entry.name_length_ > header_.names_capacity_ - entry.name_offset_) {
+      return absl::DataLossError(absl::StrCat("slot ", i, " has an invalid name"));
+    }
+    names_cache_.emplace_back(names_ + entry.name_offset_, entry.name_length_);
+  }
+  return absl::OkStatus();
+}
+
+} // namespace SharedMemory
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/extensions/stat_sinks/shared_memory/segment_format.h"
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace SharedMemory {
+
+class SegmentReader;
+using SegmentReaderPtr = std::unique_ptr<SegmentReader>;
+
+/**
+ * Reads the file published by SharedMemoryStatsSink. This is meant to be embedded in exporters
+ * running next to Envoy, so it only depends on the layout in segment_format.h and maps the file
+ * read-only.
+ */
+class SegmentReader {
+public:
+  struct Entry {
+    // Points into the mapping, which outlives the reader's snapshots.
+    absl::string_view name_;
+    EntryType type_;
+    uint64_t value_;
+    bool stale_;
+  };
+
+  struct Snapshot {
+    std::vector<Entry> entries_;
+    uint64_t flush_time_ms_{};
+    uint64_t dropped_{};
+  };
+
+  /**
+   * Maps the file at path.
+   * @return an error if the file cannot be mapped or does not have a supported layout.
+   */
+  static absl::StatusOr<SegmentReaderPtr> open(const std::string& path);
+  ~SegmentReader();
+
+  /**
+   * Copies the values published by the last complete flush into snapshot, reusing its storage.
+   * @param max_attempts the number of times to retry when the read races with a flush.
+   * @return an Unavailable error if every attempt raced with a flush.
+   */
+  absl::Status read(Snapshot& snapshot, uint32_t max_attempts = 100);
+
+  /**
+   * @return the process id of the Envoy that published the file.
+   */
+  uint64_t pid() const { return header_.pid_; }
+
+private:
+  SegmentReader(const void* mapping, uint64_t size);
+
+  absl::Status loadNames(uint32_t num_entries);
+
+  const void* const mapping_;
+  const uint64_t size_;
+  const SegmentHeader& header_;
+  const SegmentEntry* const entries_;
+  const char* const names_;
+  // Names of the slots seen so far. Slot names never change, so they are validated once.
+  std::vector<absl::string_view> names_cache_;
+};
+
+} // namespace SharedMemory
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
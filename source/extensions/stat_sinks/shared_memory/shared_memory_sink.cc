@@ -0,0 +1,149 @@
+#include "source/extensions/stat_sinks/shared_memory/shared_memory_sink.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+
+#include "envoy/api/os_sys_calls.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/common/fmt.h"
+#include "source/common/common/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace SharedMemory {
+
+absl::StatusOr<SharedMemoryStatsSinkPtr>
+SharedMemoryStatsSink::create(const std::string& path, uint32_t capacity, uint64_t names_capacity,
+                              Stats::SymbolTable& symbol_table) {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  // Replace any existing file rather than truncating it, as a reader that still has it mapped
+  // would fault on pages past the new end of the file.
+  os_sys_calls.unlink(path.c_str());
+  const Api::SysCallIntResult open_result =
+      os_sys_calls.open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+  if (open_result.return_value_ == -1) {
+    return absl::InvalidArgumentError(fmt::format("cannot create shared memory stats file {}: {}",
+                                                  path, errorDetails(open_result.errno_)));
+  }
+  const int fd = open_result.return_value_;
+
+  const uint64_t size = segmentSize(capacity, names_capacity);
+  const Api::SysCallIntResult truncate_result = os_sys_calls.ftruncate(fd, size);
+  if (truncate_result.return_value_ == -1) {
+    os_sys_calls.close(fd);
+    return absl::InvalidArgumentError(fmt::format("cannot size shared memory stats file {}: {}",
+                                                  path, errorDetails(truncate_result.errno_)));
+  }
+  const Api::SysCallPtrResult mmap_result =
+      os_sys_calls.mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  // The mapping stays valid once the descriptor is closed.
+  os_sys_calls.close(fd);
+  if (mmap_result.return_value_ == MAP_FAILED) {
+    return absl::InvalidArgumentError(fmt::format("cannot map shared memory stats file {}: {}",
+                                                  path, errorDetails(mmap_result.errno_)));
+  }
+
+  SegmentHeader& header = *static_cast<SegmentHeader*>(mmap_result.return_value_);
+  header.version_ = SegmentVersion;
+  header.header_size_ = sizeof(SegmentHeader);
+  header.entry_size_ = sizeof(SegmentEntry);
+  header.capacity_ = capacity;
+  header.names_offset_ = segmentSize(capacity, 0);
+  header.names_capacity_ = names_capacity;
+  header.pid_ = getpid();
+  // Readers check the magic first, so it is written once the rest of the header is in place.
+  std::atomic_thread_fence(std::memory_order_release);
+  memcpy(header.magic_, SegmentMagic, sizeof(SegmentMagic));
+
+  return SharedMemoryStatsSinkPtr(
+      new SharedMemoryStatsSink(mmap_result.return_value_, size, symbol_table));
+}
+
+SharedMemoryStatsSink::SharedMemoryStatsSink(void* mapping, uint64_t size,
+                                             Stats::SymbolTable& symbol_table)
+    : mapping_(mapping), size_(size), header_(*static_cast<SegmentHeader*>(mapping)),
+      entries_(
+          reinterpret_cast<SegmentEntry*>(static_cast<char*>(mapping) + sizeof(SegmentHeader))),
+      names_(static_cast<char*>(mapping) + header_.names_offset_), pool_(symbol_table) {}
+
+SharedMemoryStatsSink::~SharedMemoryStatsSink() { munmap(mapping_, size_); }
+
+void SharedMemoryStatsSink::flush(Stats::MetricSnapshot& snapshot) {
+  const uint64_t sequence = header_.sequence_.load(std::memory_order_relaxed);
+  header_.sequence_.store(sequence + 1, std::memory_order_relaxed);
+  // Orders the odd sequence before the value stores below, see the reader.
+  std::atomic_thread_fence(std::memory_order_release);
+
+  seen_.assign(num_entries_, false);
+  dropped_ = 0;
+  for (const Stats::MetricSnapshot::CounterSnapshot& counter : snapshot.counters()) {
+    publish(counter_slots_, counter.counter_.get(), EntryType::Counter,
+            counter.counter_.get().value());
+  }
+  for (const auto& gauge : snapshot.gauges()) {
+    publish(gauge_slots_, gauge.get(), EntryType::Gauge, gauge.get().value());
+  }
+  for (uint32_t i = 0; i < num_entries_; ++i) {
+    entries_[i].flags_.store(seen_[i] ? 0 : EntryFlagStale, std::memory_order_relaxed);
+  }
+
+  header_.dropped_.store(dropped_, std::memory_order_relaxed);
+  header_.flush_time_ms_.store(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                   snapshot.snapshotTime().time_since_epoch())
+                                   .count(),
+                               std::memory_order_relaxed);
+  // Publishes the names of the slots allocated by this flush.
+  header_.num_entries_.store(num_entries_, std::memory_order_release);
+  header_.sequence_.store(sequence + 2, std::memory_order_release);
+}
+
+void SharedMemoryStatsSink::publish(SlotMap& slots, const Stats::Metric& metric, EntryType type,
+                                    uint64_t value) {
+  uint32_t index;
+  auto it = slots.find(metric.statName());
+  if (it != slots.end()) {
+    index = it->second;
+  } else {
+    const std::optional<uint32_t> slot = allocateSlot(metric, type);
+    if (!slot.has_value()) {
+      ++dropped_;
+      return;
+    }
+    index = slot.value();
+    slots.emplace(pool_.add(metric.statName()), index);
+  }
+  entries_[index].value_.store(value, std::memory_order_relaxed);
+  seen_[index] = true;
+}
+
+std::optional<uint32_t> SharedMemoryStatsSink::allocateSlot(const Stats::Metric& metric,
+                                                            EntryType type) {
+  if (num_entries_ == header_.capacity_) {
+    return std::nullopt;
+  }
+  const std::string name = metric.name();
+  if (name.size() > header_.names_capacity_ - names_used_) {
+    return std::nullopt;
+  }
+
+  memcpy(names_ + names_used_, name.data(), name.size());
+  SegmentEntry& entry = entries_[num_entries_];
+  entry.name_offset_ = names_used_;
+  entry.name_length_ = name.size();
+  entry.type_ = type;
+  names_used_ += name.size();
+  ENVOY_LOG(trace, "shared memory stats: assigned slot {} to {}", num_entries_, name);
+  seen_.push_back(false);
+  return num_entries_++;
+}
+
+} // namespace SharedMemory
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "envoy/stats/sink.h"
+#include "envoy/stats/stats.h"
+
+#include "source/common/common/logger.h"
+#include "source/common/stats/symbol_table.h"
+#include "source/extensions/stat_sinks/shared_memory/segment_format.h"
+
+#include "absl/status/statusor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace SharedMemory {
+
+class SharedMemoryStatsSink;
+using SharedMemoryStatsSinkPtr = std::unique_ptr<SharedMemoryStatsSink>;
+
+/**
+ * Publishes counter and gauge values to a memory mapped file on each stats flush, with the layout
+ * described in segment_format.h. A process on the same host can map the file read-only and read
+ * the values without a round trip to the admin interface, and without costing Envoy more than a
+ * hash lookup and a store per stat per flush.
+ */
+class SharedMemoryStatsSink : public Stats::Sink, Logger::Loggable<Logger::Id::stats> {
+public:
+  /**
+   * Creates the file at path, replacing any existing file, and maps it.
+   * @param capacity the maximum number of stats that can be published.
+   * @param names_capacity the number of bytes reserved for stat names.
+   */
+  static absl::StatusOr<SharedMemoryStatsSinkPtr> create(const std::string& path,
+                                                         uint32_t capacity,
+                                                         uint64_t names_capacity,
+                                                         Stats::SymbolTable& symbol_table);
+  ~SharedMemoryStatsSink() override;
+
+  // Stats::Sink
+  void flush(Stats::MetricSnapshot& snapshot) override;
+  void onHistogramComplete(const Stats::Histogram&, uint64_t) override {}
+
+private:
+  using SlotMap = Stats::StatNameHashMap<uint32_t>;
+
+  SharedMemoryStatsSink(void* mapping, uint64_t size, Stats::SymbolTable& symbol_table);
+
+  void publish(SlotMap& slots, const Stats::Metric& metric, EntryType type, uint64_t value);
+  std::optional<uint32_t> allocateSlot(const Stats::Metric& metric, EntryType type);
+
+  void* const mapping_;
+  const uint64_t size_;
+  SegmentHeader& header_;
+  SegmentEntry* const entries_;
+  char* const names_;
+  uint32_t num_entries_{};
+  uint64_t names_used_{};
+  // Owns the stat names used as keys in the slot maps, as the stats themselves may be freed.
+  Stats::StatNamePool pool_;
+  // Counters and gauges may share a name, so they are assigned slots independently.
+  SlotMap counter_slots_;
+  SlotMap gauge_slots_;
+  // Whether each slot was published in the flush in progress.
+  std::vector<bool> seen_;
+  uint64_t dropped_{};
+};
+
+} // namespace SharedMemory
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
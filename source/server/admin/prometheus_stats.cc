@@ -73,6 +73,28 @@ struct MetricLessThan {
   }
 };
 
+/**
+ * Returns the formatted labels of a metric, from the output format's name cache if it has one.
+ * @param storage holds the labels when there is no cache.
+ */
+absl::string_view metricLabels(const PrometheusStatsFormatter::OutputFormat& output_format,
+                               const Stats::Metric& metric, std::string& storage) {
+  if (output_format.nameCache() != nullptr) {
+    return output_format.nameCache()->formattedTags(metric);
+  }
+  storage = PrometheusStatsFormatter::formattedTags(metric.tags());
+  return storage;
+}
+
+/**
+ * Appends a `name{labels} value` sample line, without formatting it into a temporary string.
+ */
+void addSample(Buffer::Instance& output, absl::string_view name, absl::string_view labels,
+               uint64_t value) {
+  const absl::AlphaNum formatted_value(value);
+  output.addFragments({name, "{", labels, "} ", formatted_value.Piece(), "\n"});
+}
+
 struct PrimitiveMetricSnapshotLessThan {
   bool operator()(const Stats::PrimitiveMetricMetadata* a,
                   const Stats::PrimitiveMetricMetadata* b) {
@@ -160,10 +182,10 @@ private:
     }
 
     generateTypeOutput(output, type, prefixed_tag_extracted_name);
+    std::string storage;
     for (const auto* metric : metrics) {
-      const std::string formatted_tags = PrometheusStatsFormatter::formattedTags(metric->tags());
-      output.add(fmt::format("{0}{{{1}}} {2}\n", prefixed_tag_extracted_name, formatted_tags,
-                             metric->value()));
+      addSample(output, prefixed_tag_extracted_name, metricLabels(*this, *metric, storage),
+                metric->value());
     }
   }
 
@@ -198,12 +220,10 @@ private:
                                const std::string& prefixed_tag_extracted_name) const {
     generateTypeOutput(output, "histogram", prefixed_tag_extracted_name);
 
+    std::string storage;
     for (const auto* histogram : histograms) {
-      auto histogram_tags = histogram->tags();
-      const bool empty_tags = histogram_tags.empty();
-
-      const std::string tags = PrometheusStatsFormatter::formattedTags(std::move(histogram_tags));
-      const std::string hist_tags = empty_tags ? EMPTY_STRING : (tags + ",");
+      const absl::string_view tags = metricLabels(*this, *histogram, storage);
+      const std::string hist_tags = tags.empty() ? EMPTY_STRING : absl::StrCat(tags, ",");
 
       const Stats::HistogramStatistics& stats = histogram->cumulativeStatistics();
       Stats::ConstSupportedBuckets& supported_buckets = stats.supportedBuckets();
@@ -239,9 +259,10 @@ private:
                              const std::string& prefixed_tag_extracted_name) const {
     generateTypeOutput(output, "summary", prefixed_tag_extracted_name);
 
+    std::string storage;
     for (const auto* histogram : histograms) {
-      const std::string tags = PrometheusStatsFormatter::formattedTags(histogram->tags());
-      const std::string hist_tags = histogram->tags().empty() ? EMPTY_STRING : (tags + ",");
+      const absl::string_view tags = metricLabels(*this, *histogram, storage);
+      const std::string hist_tags = tags.empty() ? EMPTY_STRING : absl::StrCat(tags, ",");
 
       const Stats::HistogramStatistics& stats = histogram->intervalStatistics();
       Stats::ConstSupportedBuckets& supported_quantiles = stats.supportedQuantiles();
@@ -768,12 +789,16 @@ uint64_t outputStatType(Buffer::Instance& response, const StatsParams& params,
   Stats::StatNameLessThan comp(global_symbol_table);
   std::sort(sorted_stat_names.begin(), sorted_stat_names.end(), comp);
 
+  PrometheusNameCache* name_cache = output_format.nameCache();
   auto result = groups.size();
   for (auto& group_name : sorted_stat_names) {
     auto& group = groups[group_name];
-    const std::optional<std::string> prefixed_tag_extracted_name =
-        PrometheusStatsFormatter::metricName(global_symbol_table.toString(group_name),
-                                             custom_namespaces);
+    std::optional<std::string> uncached_name;
+    const std::optional<std::string>& prefixed_tag_extracted_name =
+        name_cache != nullptr
+            ? name_cache->metricName(group_name, custom_namespaces)
+            : (uncached_name = PrometheusStatsFormatter::metricName(
+                   global_symbol_table.toString(group_name), custom_namespaces));
     if (!prefixed_tag_extracted_name.has_value()) {
       --result;
       continue;
@@ -901,6 +926,55 @@ bool useProtobufFormat(const StatsParams& params, const Http::RequestHeaderMap&
 
 } // namespace
 
+void PrometheusNameCache::startScrape(bool all_stats) {
+  ++generation_;
+  used_ = 0;
+  all_stats_ = all_stats;
+}
+
+void PrometheusNameCache::finishScrape() {
+  if (all_stats_ && used_ * 2 < size()) {
+    evictUnused(metric_names_);
+    evictUnused(formatted_tags_);
+  }
+}
+
+const std::optional<std::string>&
+PrometheusNameCache::metricName(Stats::StatName tag_extracted_name,
+                                const Stats::CustomStatNamespaces& custom_namespaces) {
+  return lookup(metric_names_, tag_extracted_name, [&]() {
+    return PrometheusStatsFormatter::metricName(symbol_table_.toString(tag_extracted_name),
+                                                custom_namespaces);
+  });
+}
+
+const std::string& PrometheusNameCache::formattedTags(const Stats::Metric& metric) {
+  return lookup(formatted_tags_, metric.statName(),
+                [&]() { return PrometheusStatsFormatter::formattedTags(metric.tags()); });
+}
+
+template <class Value, class ComputeFn>
+const Value& PrometheusNameCache::lookup(EntryMap<Value>& map, Stats::StatName name,
+                                         ComputeFn compute) {
+  auto it = map.find(name);
+  if (it == map.end()) {
+    Stats::StatNameManagedStorage storage(name, symbol_table_);
+    const Stats::StatName key = storage.statName();
+    it = map.emplace(key, Entry<Value>{std::move(storage), compute(), 0}).first;
+  }
+  Entry<Value>& entry = it->second;
+  if (entry.generation_ != generation_) {
+    entry.generation_ = generation_;
+    ++used_;
+  }
+  return entry.value_;
+}
+
+template <class Value> void PrometheusNameCache::evictUnused(EntryMap<Value>& map) {
+  absl::erase_if(map,
+                 [this](const auto& entry) { return entry.second.generation_ != generation_; });
+}
+
 std::string PrometheusStatsFormatter::formattedTags(std::vector<Stats::Tag>&& tags) {
   std::vector<std::string> buf;
   buf.reserve(tags.size());
@@ -996,6 +1070,12 @@ uint64_t PrometheusStatsFormatter::generateWithOutputFormat(
   }
 
   output_format.setHistogramType(hist_type);
+  if (output_format.nameCache() != nullptr) {
+    const bool all_stats = params.re2_filter_ == nullptr && !params.used_only_ &&
+                           params.type_ == StatsType::All &&
+                           params.hidden_ != HiddenFlag::ShowOnly;
+    output_format.nameCache()->startScrape(all_stats);
+  }
 
   uint64_t metric_name_count = 0;
   metric_name_count +=
@@ -1027,6 +1107,9 @@ uint64_t PrometheusStatsFormatter::generateWithOutputFormat(
   metric_name_count += outputPrimitiveStatType(response, params, std::move(host_gauges),
                                                output_format, custom_namespaces);
 
+  if (output_format.nameCache() != nullptr) {
+    output_format.nameCache()->finishScrape();
+  }
   return metric_name_count;
 }
 
@@ -1036,9 +1119,11 @@ uint64_t PrometheusStatsFormatter::statsAsPrometheusText(
     const std::vector<Stats::ParentHistogramSharedPtr>& histograms,
     const std::vector<Stats::TextReadoutSharedPtr>& text_readouts,
     const Upstream::ClusterManager& cluster_manager, Buffer::Instance& response,
-    const StatsParams& params, const Stats::CustomStatNamespaces& custom_namespaces) {
+    const StatsParams& params, const Stats::CustomStatNamespaces& custom_namespaces,
+    PrometheusNameCache* name_cache) {
 
   TextFormat output_format;
+  output_format.setNameCache(name_cache);
   return generateWithOutputFormat(counters, gauges, histograms, text_readouts, cluster_manager,
                                   response, params, custom_namespaces, output_format);
 }
@@ -1050,13 +1135,14 @@ uint64_t PrometheusStatsFormatter::statsAsPrometheusProtobuf(
     const std::vector<Stats::TextReadoutSharedPtr>& text_readouts,
     const Upstream::ClusterManager& cluster_manager, Http::ResponseHeaderMap& response_headers,
     Buffer::Instance& response, const StatsParams& params,
-    const Stats::CustomStatNamespaces& custom_namespaces) {
+    const Stats::CustomStatNamespaces& custom_namespaces, PrometheusNameCache* name_cache) {
 
   response_headers.setReferenceContentType(
       "application/vnd.google.protobuf; "
       "proto=io.prometheus.client.MetricFamily; encoding=delimited");
 
   ProtobufFormat output_format(params.native_histogram_max_buckets_);
+  output_format.setNameCache(name_cache);
   return generateWithOutputFormat(counters, gauges, histograms, text_readouts, cluster_manager,
                                   response, params, custom_namespaces, output_format);
 }
@@ -1068,14 +1154,15 @@ uint64_t PrometheusStatsFormatter::statsAsPrometheus(
     const std::vector<Stats::TextReadoutSharedPtr>& text_readouts,
     const Upstream::ClusterManager& cluster_manager, const Http::RequestHeaderMap& request_headers,
     Http::ResponseHeaderMap& response_headers, Buffer::Instance& response,
-    const StatsParams& params, const Stats::CustomStatNamespaces& custom_namespaces) {
+    const StatsParams& params, const Stats::CustomStatNamespaces& custom_namespaces,
+    PrometheusNameCache* name_cache) {
 
   return useProtobufFormat(params, request_headers)
              ? statsAsPrometheusProtobuf(counters, gauges, histograms, text_readouts,
                                          cluster_manager, response_headers, response, params,
-                                         custom_namespaces)
+                                         custom_namespaces, name_cache)
              : statsAsPrometheusText(counters, gauges, histograms, text_readouts, cluster_manager,
-                                     response, params, custom_namespaces);
+                                     response, params, custom_namespaces, name_cache);
 }
 
 } // namespace Server
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <optional>
 #include <string>
 
 #include "envoy/buffer/buffer.h"
@@ -7,10 +8,79 @@
 #include "envoy/stats/histogram.h"
 #include "envoy/stats/stats.h"
 
+#include "source/common/stats/symbol_table.h"
 #include "source/server/admin/stats_params.h"
 
+#include "absl/container/node_hash_map.h"
+
 namespace Envoy {
 namespace Server {
+
+/**
+ * Caches the parts of the Prometheus exposition that only depend on a stat's name: the sanitized
+ * metric family name of each tag-extracted name, and the formatted label set of each stat. This
+ * lets repeated scrapes skip decoding names from the symbol table, extracting tags and sanitizing
+ * them, leaving only the values to be formatted.
+ *
+ * New stats are added on first use. Entries that were not used by a scrape of all the stats are
+ * evicted at the end of it once they make up more than half of the cache, which bounds the memory
+ * held for deleted stats. Filtered scrapes only touch some of the stats, so they never evict, and
+ * do not make the next scrape of all the stats rebuild the entries.
+ *
+ * The cache is not thread safe; admin requests are rendered on the main thread.
+ */
+class PrometheusNameCache {
+public:
+  explicit PrometheusNameCache(Stats::SymbolTable& symbol_table) : symbol_table_(symbol_table) {}
+
+  /**
+   * Called before and after rendering a scrape with the cache.
+   * @param all_stats whether the scrape renders every stat, so that the entries it does not use
+   *        belong to deleted stats.
+   */
+  void startScrape(bool all_stats);
+  void finishScrape();
+
+  /**
+   * @return the metric family name for a tag-extracted name, as returned by
+   *         PrometheusStatsFormatter::metricName().
+   */
+  const std::optional<std::string>&
+  metricName(Stats::StatName tag_extracted_name,
+             const Stats::CustomStatNamespaces& custom_namespaces);
+
+  /**
+   * @return the labels of the metric, as returned by PrometheusStatsFormatter::formattedTags().
+   */
+  const std::string& formattedTags(const Stats::Metric& metric);
+
+  /**
+   * @return the number of cached metric family names and label sets.
+   */
+  size_t size() const { return metric_names_.size() + formatted_tags_.size(); }
+
+private:
+  template <class Value> struct Entry {
+    // Backs the StatName used as the entry's key, as the stat may be deleted before the entry.
+    Stats::StatNameManagedStorage name_;
+    Value value_;
+    uint64_t generation_;
+  };
+  // A node map, so that references returned by lookup() stay valid as entries are added.
+  template <class Value> using EntryMap = absl::node_hash_map<Stats::StatName, Entry<Value>>;
+
+  template <class Value, class ComputeFn>
+  const Value& lookup(EntryMap<Value>& map, Stats::StatName name, ComputeFn compute);
+  template <class Value> void evictUnused(EntryMap<Value>& map);
+
+  Stats::SymbolTable& symbol_table_;
+  EntryMap<std::optional<std::string>> metric_names_;
+  EntryMap<std::string> formatted_tags_;
+  uint64_t generation_{};
+  uint64_t used_{};
+  bool all_stats_{};
+};
+
 /**
  * Formatter for metric/labels exported to Prometheus.
  *
@@ -34,6 +104,11 @@ public:
 
     HistogramType histogramType() const { return histogram_type_; }
 
+    void setNameCache(PrometheusNameCache* name_cache) { name_cache_ = name_cache; }
+
+    // The cache to use for names and labels, or nullptr if they are computed for every scrape.
+    PrometheusNameCache* nameCache() const { return name_cache_; }
+
     // Return the prometheus output for a group of Counters.
     virtual void generateOutput(Buffer::Instance& output,
                                 const std::vector<const Stats::Counter*>& counters,
@@ -66,12 +141,14 @@ public:
 
   private:
     HistogramType histogram_type_;
+    PrometheusNameCache* name_cache_{};
   };
 
   /**
    * Extracts counters and gauges and relevant tags, appending them to
    * the response buffer after sanitizing the metric / label names.
    * Detects based on request headers whether to emit text or protobuf format.
+   * @param name_cache if not nullptr, the cache used for metric names and labels across scrapes.
    * @return uint64_t total number of metric types inserted in response.
    */
   static uint64_t statsAsPrometheus(const std::vector<Stats::CounterSharedPtr>& counters,
@@ -82,7 +159,8 @@ public:
                                     const Http::RequestHeaderMap& request_headers,
                                     Http::ResponseHeaderMap& response_headers,
                                     Buffer::Instance& response, const StatsParams& params,
-                                    const Stats::CustomStatNamespaces& custom_namespaces);
+                                    const Stats::CustomStatNamespaces& custom_namespaces,
+                                    PrometheusNameCache* name_cache = nullptr);
 
   static uint64_t
   statsAsPrometheusText(const std::vector<Stats::CounterSharedPtr>& counters,
@@ -91,7 +169,8 @@ public:
                         const std::vector<Stats::TextReadoutSharedPtr>& text_readouts,
                         const Upstream::ClusterManager& cluster_manager, Buffer::Instance& response,
                         const StatsParams& params,
-                        const Stats::CustomStatNamespaces& custom_namespaces);
+                        const Stats::CustomStatNamespaces& custom_namespaces,
+                        PrometheusNameCache* name_cache = nullptr);
 
   static uint64_t
   statsAsPrometheusProtobuf(const std::vector<Stats::CounterSharedPtr>& counters,
@@ -101,7 +180,8 @@ public:
                             const Upstream::ClusterManager& cluster_manager,
                             Http::ResponseHeaderMap& response_headers, Buffer::Instance& response,
                             const StatsParams& params,
-                            const Stats::CustomStatNamespaces& custom_namespaces);
+                            const Stats::CustomStatNamespaces& custom_namespaces,
+                            PrometheusNameCache* name_cache = nullptr);
 
   static uint64_t
   generateWithOutputFormat(const std::vector<Stats::CounterSharedPtr>& counters,
@@ -173,8 +173,12 @@ Http::Code StatsHandler::prometheusFlushAndRender(const StatsParams& params,
   if (server_.statsConfig().flushOnAdmin()) {
     server_.flushStats();
   }
+  if (prometheus_name_cache_ == nullptr) {
+    prometheus_name_cache_ = std::make_unique<PrometheusNameCache>(server_.stats().symbolTable());
+  }
   prometheusRender(server_.stats(), server_.api().customStatNamespaces(), server_.clusterManager(),
-                   params, request_headers, response_headers, response);
+                   params, request_headers, response_headers, response,
+                   prometheus_name_cache_.get());
   return Http::Code::OK;
 }
 
@@ -184,13 +188,14 @@ void StatsHandler::prometheusRender(Stats::Store& stats,
                                     const StatsParams& params,
                                     const Http::RequestHeaderMap& request_headers,
                                     Http::ResponseHeaderMap& response_headers,
-                                    Buffer::Instance& response) {
+                                    Buffer::Instance& response,
+                                    PrometheusNameCache* name_cache) {
   const std::vector<Stats::TextReadoutSharedPtr>& text_readouts_vec =
       params.prometheus_text_readouts_ ? stats.textReadouts()
                                        : std::vector<Stats::TextReadoutSharedPtr>();
   PrometheusStatsFormatter::statsAsPrometheus(
       stats.counters(), stats.gauges(), stats.histograms(), text_readouts_vec, cluster_manager,
-      request_headers, response_headers, response, params, custom_namespaces);
+      request_headers, response_headers, response, params, custom_namespaces, name_cache);
 }
 
 Http::Code StatsHandler::handlerContention(Http::ResponseHeaderMap& response_headers,
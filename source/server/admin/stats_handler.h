@@ -10,6 +10,7 @@
 #include "envoy/server/instance.h"
 
 #include "source/server/admin/handler_ctx.h"
+#include "source/server/admin/prometheus_stats.h"
 #include "source/server/admin/stats_request.h"
 #include "source/server/admin/utils.h"
 
@@ -68,12 +69,14 @@ public:
    * @param custom_namespaces namespace mappings used for prometheus
    * @params params the already-parsed parameters.
    * @param response buffer into which to write response
+   * @param name_cache if not nullptr, caches metric names and labels across calls.
    */
   static void
   prometheusRender(Stats::Store& stats, const Stats::CustomStatNamespaces& custom_namespaces,
                    const Upstream::ClusterManager& cluster_manager, const StatsParams& params,
                    const Http::RequestHeaderMap& request_headers,
-                   Http::ResponseHeaderMap& response_headers, Buffer::Instance& response);
+                   Http::ResponseHeaderMap& response_headers, Buffer::Instance& response,
+                   PrometheusNameCache* name_cache = nullptr);
 
   Http::Code handlerContention(Http::ResponseHeaderMap& response_headers,
                                Buffer::Instance& response, AdminStream&);
@@ -96,6 +99,11 @@ public:
                                        const Upstream::ClusterManager& cm,
                                        StatsRequest::UrlHandlerFn url_handler_fn = nullptr);
   Admin::RequestPtr makeRequest(AdminStream&);
+
+private:
+  // Created on the first Prometheus scrape, so that servers which are never scraped do not hold
+  // a copy of every stat's labels.
+  std::unique_ptr<PrometheusNameCache> prometheus_name_cache_;
 };
 
 } // namespace Server
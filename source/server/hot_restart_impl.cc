@@ -155,6 +155,15 @@ HotRestartImpl::mergeParentStatsIfAny(Stats::StoreRoot& stats_store) {
   return response;
 }
 
+void HotRestartImpl::mergeParentTlsSessionsIfAny(const TlsSessionCb& cb) {
+  std::unique_ptr<envoy::HotRestartMessage> wrapper_msg = as_child_.getParentTlsSessions();
+  if (wrapper_msg) {
+    for (const auto& session : wrapper_msg->reply().tls_sessions().sessions()) {
+      cb(session.key(), session.session());
+    }
+  }
+}
+
 void HotRestartImpl::shutdown() {
   as_parent_.shutdown();
   as_child_.shutdown();
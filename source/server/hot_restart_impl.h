@@ -112,6 +112,7 @@ public:
   std::optional<AdminShutdownResponse> sendParentAdminShutdownRequest() override;
   void sendParentTerminateRequest() override;
   ServerStatsFromParent mergeParentStatsIfAny(Stats::StoreRoot& stats_store) override;
+  void mergeParentTlsSessionsIfAny(const TlsSessionCb& cb) override;
   void shutdown() override;
   uint32_t baseId() override;
   std::string version() override;
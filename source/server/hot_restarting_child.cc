@@ -164,6 +164,25 @@ std::unique_ptr<HotRestartMessage> HotRestartingChild::getParentStats() {
   return wrapped_reply;
 }
 
+std::unique_ptr<HotRestartMessage> HotRestartingChild::getParentTlsSessions() {
+  if (parent_terminated_) {
+    return nullptr;
+  }
+
+  HotRestartMessage wrapped_request;
+  wrapped_request.mutable_request()->mutable_tls_sessions();
+  main_rpc_stream_.sendHotRestartMessage(parent_address_, wrapped_request);
+
+  std::unique_ptr<HotRestartMessage> wrapped_reply =
+      main_rpc_stream_.receiveHotRestartMessage(RpcStream::Blocking::Yes);
+  // A parent built before the sessions were handed over does not recognize the request.
+  if (!main_rpc_stream_.replyIsExpectedType(wrapped_reply.get(),
+                                            HotRestartMessage::Reply::kTlsSessions)) {
+    return nullptr;
+  }
+  return wrapped_reply;
+}
+
 void HotRestartingChild::drainParentListeners() {
   if (parent_terminated_) {
     return;
@@ -58,6 +58,7 @@ public:
   void registerParentDrainedCallback(const Network::Address::InstanceConstSharedPtr& addr,
                                      absl::AnyInvocable<void()> action) override;
   std::unique_ptr<envoy::HotRestartMessage> getParentStats();
+  std::unique_ptr<envoy::HotRestartMessage> getParentTlsSessions();
   void drainParentListeners();
   std::optional<HotRestart::AdminShutdownResponse> sendParentAdminShutdownRequest();
   void sendParentTerminateRequest();
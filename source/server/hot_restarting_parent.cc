@@ -7,6 +7,7 @@
 #include "source/common/stats/stat_merger.h"
 #include "source/common/stats/symbol_table.h"
 #include "source/common/stats/utility.h"
+#include "source/common/tls/session_cache.h"
 
 namespace Envoy {
 namespace Server {
@@ -90,6 +91,13 @@ void HotRestartingParent::onSocketEvent() {
       break;
     }
 
+    case HotRestartMessage::Request::kTlsSessions: {
+      HotRestartMessage wrapped_reply;
+      internal_->exportTlsSessionsToChild(wrapped_reply.mutable_reply()->mutable_tls_sessions());
+      main_rpc_stream_.sendHotRestartMessage(child_address_, wrapped_reply);
+      break;
+    }
+
     case HotRestartMessage::Request::kDrainListeners: {
       internal_->drainListeners();
       break;
@@ -231,5 +239,19 @@ void HotRestartingParent::Internal::drainListeners() {
   server_->drainListeners(options);
 }
 
+void HotRestartingParent::Internal::exportTlsSessionsToChild(
+    HotRestartMessage::Reply::TlsSessions* tls_sessions) {
+  Extensions::TransportSockets::Tls::SessionCacheSharedPtr session_cache =
+      Extensions::TransportSockets::Tls::SessionCache::get(server_->singletonManager());
+  if (session_cache == nullptr || !session_cache->persistAcrossHotRestart()) {
+    return;
+  }
+  session_cache->exportSessions([tls_sessions](absl::string_view key, absl::string_view session) {
+    auto* entry = tls_sessions->add_sessions();
+    entry->set_key(key);
+    entry->set_session(session);
+  });
+}
+
 } // namespace Server
 } // namespace Envoy
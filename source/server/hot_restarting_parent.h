@@ -42,6 +42,9 @@ public:
     void recordDynamics(envoy::HotRestartMessage::Reply::Stats* stats, const std::string& name,
                         Stats::StatName stat_name);
     void drainListeners();
+    // 'tls_sessions' is a field in the reply protobuf to be sent to the child, which we should
+    // populate if the process-wide TLS session cache persists its sessions across hot restart.
+    void exportTlsSessionsToChild(envoy::HotRestartMessage::Reply::TlsSessions* tls_sessions);
 
     // Network::NonDispatchedUdpPacketHandler
     void handle(uint32_t worker_index, const Network::UdpRecvData& packet) override;
@@ -26,6 +26,7 @@
 
 #include "source/common/api/api_impl.h"
 #include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/buffer/slice_arena.h"
 #include "source/common/common/enum_to_int.h"
 #include "source/common/common/mutex_tracer_impl.h"
 #include "source/common/common/notification.h"
@@ -50,6 +51,7 @@
 #include "source/common/stats/thread_local_store.h"
 #include "source/common/stats/timespan_impl.h"
 #include "source/common/tls/context_manager_impl.h"
+#include "source/common/tls/session_cache.h"
 #include "source/common/upstream/cluster_manager_impl.h"
 #include "source/common/version/version.h"
 #include "source/server/cgroup_cpu_util.h"
@@ -268,6 +270,11 @@ void InstanceBase::updateServerStats() {
                                        parent_stats.parent_memory_allocated_);
   server_stats_->memory_heap_size_.set(Memory::Stats::totalCurrentlyReserved());
   server_stats_->memory_physical_size_.set(Memory::Stats::totalPhysicalBytes());
+  if (Buffer::SliceArena::enabled()) {
+    const Buffer::SliceArenaStats arena_stats = Buffer::SliceArena::stats();
+    server_stats_->memory_slice_arena_allocated_.set(arena_stats.in_use_bytes_);
+    server_stats_->memory_slice_arena_reserved_.set(arena_stats.reserved_bytes_);
+  }
   if (!options_.hotRestartDisabled()) {
     server_stats_->parent_connections_.set(parent_stats.parent_connections_);
   }
@@ -567,6 +574,11 @@ absl::Status InstanceBase::initializeOrThrow(Network::Address::InstanceConstShar
       bootstrap_.stats_config(), stats_store_.symbolTable(), server_contexts_));
   stats_store_.setHistogramSettings(
       std::make_unique<Stats::HistogramSettingsImpl>(bootstrap_.stats_config(), server_contexts_));
+  if (bootstrap_.stats_config().has_sharded_counter_matcher()) {
+    stats_store_.setShardedCounterMatcher(std::make_unique<Stats::StatsMatcherImpl>(
+        bootstrap_.stats_config().sharded_counter_matcher(), stats_store_.symbolTable(),
+        server_contexts_));
+  }
 
   const std::string server_stats_prefix = "server.";
   const std::string server_compilation_settings_stats_prefix = "server.compilation_settings";
@@ -831,6 +843,24 @@ absl::Status InstanceBase::initializeOrThrow(Network::Address::InstanceConstShar
     admin_->addListenerToHandler(handler_.get());
   }
 
+  // The contexts find the process-wide TLS session cache in the singleton manager, so create it
+  // before any of them. The parent still serves its listeners, and hands over its sessions if
+  // they persist across hot restart.
+  if (bootstrap_.has_tls_session_cache()) {
+    Extensions::TransportSockets::Tls::SessionCacheSharedPtr session_cache =
+        Extensions::TransportSockets::Tls::SessionCache::create(
+            bootstrap_.tls_session_cache(), singletonManager(), *stats_store_.rootScope());
+    if (session_cache->persistAcrossHotRestart()) {
+      restarter_.mergeParentTlsSessionsIfAny(
+          [&session_cache](absl::string_view key, absl::string_view session) {
+            if (!session_cache->importSession(key, session)) {
+              ENVOY_LOG(debug, "dropping a TLS session of the parent that cannot be parsed");
+            }
+          });
+      ENVOY_LOG(info, "imported TLS sessions of the parent: {} cached", session_cache->size());
+    }
+  }
+
   // Once we have runtime we can initialize the SSL context manager.
   ssl_context_manager_ =
       std::make_unique<Extensions::TransportSockets::Tls::ContextManagerImpl>(server_contexts_);
@@ -87,6 +87,8 @@ struct ServerCompilationSettingsStats {
   GAUGE(memory_allocated, Accumulate)                                                              \
   GAUGE(memory_heap_size, Accumulate)                                                              \
   GAUGE(memory_physical_size, Accumulate)                                                          \
+  GAUGE(memory_slice_arena_allocated, Accumulate)                                                  \
+  GAUGE(memory_slice_arena_reserved, Accumulate)                                                   \
   GAUGE(parent_connections, Accumulate)                                                            \
   GAUGE(state, NeverImport)                                                                        \
   GAUGE(stats_recent_lookups, NeverImport)                                                         \
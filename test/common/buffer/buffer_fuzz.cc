@@ -143,6 +143,13 @@ public:
     return {{const_cast<char*>(start()), size_}};
   }
 
+  Buffer::RawSliceVector
+  getRawSlicesBeforeFileRange(std::optional<uint64_t> max_slices = std::nullopt) const override {
+    return getRawSlices(max_slices);
+  }
+
+  std::optional<Buffer::FileRange> frontFileRange() const override { return std::nullopt; }
+
   Buffer::RawSlice frontSlice() const override { return {const_cast<char*>(start()), size_}; }
 
   uint64_t length() const override { return size_; }
@@ -1,7 +1,10 @@
+#include <vector>
+
 #include "envoy/config/overload/v3/overload.pb.h"
 #include "envoy/http/stream_reset_handler.h"
 
 #include "source/common/buffer/buffer_impl.h"
+#include "source/common/buffer/slice_arena.h"
 #include "source/common/buffer/watermark_buffer.h"
 #include "source/common/common/assert.h"
 
@@ -320,6 +323,40 @@ BENCHMARK(bufferReserveCommit)
     ->Arg(64 * 1024)
     ->Arg(128 * 1024);
 
+// Test socket-read style reserve+commit cycles across many connections, with and without the
+// per-thread slice arena. Each connection keeps its read slice until the next round, so the
+// thread's small slice free list cannot absorb the churn and every read without the arena is a
+// heap allocation. With the arena, slices are recycled through the arena and the only allocations
+// are the 2 MiB chunks reported in the arena_chunks counter.
+static void bufferReserveCommitManyConnections(benchmark::State& state) {
+  const bool use_arena = state.range(0) != 0;
+  const uint64_t connections = state.range(1);
+  Buffer::SliceArena::configure(use_arena ? 64 * Buffer::SliceArena::ChunkSize : 0);
+  const uint64_t overflow_before = Buffer::SliceArena::stats().overflow_allocations_;
+  {
+    std::vector<Buffer::OwnedImpl> buffers(connections);
+    for (auto _ : state) {
+      UNREFERENCED_PARAMETER(_);
+      for (Buffer::OwnedImpl& buffer : buffers) {
+        buffer.drain(buffer.length());
+        Buffer::Reservation reservation =
+            buffer.reserveForReadWithLengthForTest(Buffer::Slice::default_slice_size_);
+        reservation.commit(reservation.length());
+      }
+    }
+    benchmark::DoNotOptimize(buffers.front().length());
+  }
+  const Buffer::SliceArenaStats arena_stats = Buffer::SliceArena::stats();
+  state.counters["arena_chunks"] = arena_stats.reserved_bytes_ / Buffer::SliceArena::ChunkSize;
+  state.counters["arena_overflow"] = arena_stats.overflow_allocations_ - overflow_before;
+  Buffer::SliceArena::configure(0);
+}
+BENCHMARK(bufferReserveCommitManyConnections)
+    ->Args({0, 64})
+    ->Args({1, 64})
+    ->Args({0, 1024})
+    ->Args({1, 1024});
+
 // Test the reserve+commit cycle, for the common case where the reserved space is
 // only partially used (and therefore the commit size is smaller than the reservation size).
 static void bufferReserveCommitPartial(benchmark::State& state) {
@@ -0,0 +1,118 @@
+// Compares sending a file over loopback TCP when it is read into the buffer in 32 KiB chunks, as
+// the file_server filter does by default, and when the buffer references it with a FileFragment,
+// which the socket sends with sendfile().
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <string>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/buffer/file_fragment.h"
+#include "source/common/common/assert.h"
+#include "source/common/network/io_socket_handle_impl.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+
+// Returns a connected pair of non-blocking loopback TCP sockets.
+static std::pair<int, int> tcpSocketPair() {
+  int listener = socket(AF_INET, SOCK_STREAM, 0);
+  RELEASE_ASSERT(listener >= 0, "socket");
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t address_length = sizeof(address);
+  RELEASE_ASSERT(bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0,
+                 "bind");
+  RELEASE_ASSERT(listen(listener, 1) == 0, "listen");
+  RELEASE_ASSERT(
+      getsockname(listener, reinterpret_cast<sockaddr*>(&address), &address_length) == 0,
+      "getsockname");
+  int client = socket(AF_INET, SOCK_STREAM, 0);
+  RELEASE_ASSERT(connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0,
+                 "connect");
+  int server = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK);
+  RELEASE_ASSERT(server >= 0, "accept");
+  ::close(listener);
+  RELEASE_ASSERT(fcntl(client, F_SETFL, O_NONBLOCK) == 0, "fcntl");
+  return {client, server};
+}
+
+// Returns a descriptor of an unlinked temporary file of the given size.
+static int temporaryFile(size_t size) {
+  const char* tmpdir = std::getenv("TEST_TMPDIR");
+  std::string path = absl::StrCat(tmpdir != nullptr ? tmpdir : "/tmp", "/file_fragment.XXXXXX");
+  int fd = mkstemp(path.data());
+  RELEASE_ASSERT(fd >= 0, "mkstemp");
+  ::unlink(path.c_str());
+  const std::string data(size, 'a');
+  RELEASE_ASSERT(::write(fd, data.data(), data.size()) == static_cast<ssize_t>(size), "write");
+  return fd;
+}
+
+// state.range(0): 0 to read the file into the buffer, 1 to reference it with a FileFragment.
+// state.range(1): the size of the file.
+static void sendFile(benchmark::State& state) {
+  const bool file_backed = state.range(0);
+  const size_t file_size = state.range(1);
+  constexpr size_t ChunkSize = 32 * 1024;
+
+  const int file_fd = temporaryFile(file_size);
+  auto [client_fd, server_fd] = tcpSocketPair();
+  Network::IoSocketHandleImpl io_handle(client_fd);
+  static uint8_t read_buf[1024 * 1024];
+  uint64_t bytes_transferred = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    size_t queued = 0;
+    size_t read = 0;
+    Buffer::OwnedImpl buffer;
+    while (read < file_size) {
+      // Keep at most one chunk of the file queued, as the filters respecting the watermarks do.
+      if (queued < file_size && buffer.length() == 0) {
+        const size_t length = std::min(file_size - queued, file_backed ? file_size : ChunkSize);
+        if (file_backed) {
+          RELEASE_ASSERT(Buffer::FileFragment::append(buffer, file_fd, queued, length).ok(), "");
+        } else {
+          auto reservation = buffer.reserveSingleSlice(length);
+          RELEASE_ASSERT(::pread(file_fd, reservation.slice().mem_, length, queued) ==
+                             static_cast<ssize_t>(length),
+                         "pread");
+          reservation.commit(length);
+        }
+        queued += length;
+      }
+      if (buffer.length() > 0) {
+        io_handle.write(buffer);
+      }
+      const ssize_t rc = ::read(server_fd, read_buf, sizeof(read_buf));
+      if (rc > 0) {
+        read += rc;
+      }
+    }
+    bytes_transferred += read;
+  }
+  state.counters["throughput"] =
+      benchmark::Counter(bytes_transferred, benchmark::Counter::kIsRate);
+
+  ::close(server_fd);
+  ::close(file_fd);
+}
+
+static void testParams(benchmark::internal::Benchmark* b) {
+  for (int file_backed : {0, 1}) {
+    for (int file_size : {64 * 1024, 1024 * 1024, 16 * 1024 * 1024}) {
+      b->Args({file_backed, file_size});
+    }
+  }
+}
+
+BENCHMARK(sendFile)->Unit(::benchmark::kMillisecond)->Apply(testParams);
+
+} // namespace Envoy
@@ -0,0 +1,193 @@
+#include <fcntl.h>
+
+#include <string>
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/buffer/file_fragment.h"
+#include "source/common/network/io_socket_handle_impl.h"
+
+#include "test/mocks/api/mocks.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Return;
+
+namespace Envoy {
+namespace Buffer {
+namespace {
+
+class FileFragmentTest : public testing::Test {
+protected:
+  void SetUp() override {
+    path_ = TestEnvironment::writeStringToFileForTest("file_fragment_test", "0123456789");
+    fd_ = os_sys_calls_.open(path_.c_str(), O_RDONLY).return_value_;
+    ASSERT_NE(fd_, -1);
+  }
+
+  void TearDown() override { os_sys_calls_.close(fd_); }
+
+  Api::OsSysCalls& os_sys_calls_ = Api::OsSysCallsSingleton::get();
+  std::string path_;
+  int fd_;
+};
+
+TEST_F(FileFragmentTest, ReferencesTheFileUntilRead) {
+  OwnedImpl buffer;
+  ASSERT_TRUE(FileFragment::append(buffer, fd_, 2, 6).ok());
+  // The fragment holds its own file descriptor.
+  os_sys_calls_.close(fd_);
+  fd_ = -1;
+  EXPECT_EQ(6, buffer.length());
+  std::optional<FileRange> range = buffer.frontFileRange();
+  ASSERT_TRUE(range.has_value());
+  EXPECT_EQ(2, range->offset_);
+  EXPECT_EQ(6, range->len_);
+  EXPECT_TRUE(buffer.getRawSlicesBeforeFileRange().empty());
+
+  buffer.drain(1);
+  range = buffer.frontFileRange();
+  ASSERT_TRUE(range.has_value());
+  EXPECT_EQ(3, range->offset_);
+  EXPECT_EQ(5, range->len_);
+
+  EXPECT_EQ("34567", buffer.toString());
+  // Reading the contents does not lose the range.
+  EXPECT_TRUE(buffer.frontFileRange().has_value());
+}
+
+TEST_F(FileFragmentTest, RawSlicesStopAtTheFileRange) {
+  OwnedImpl buffer("head");
+  ASSERT_TRUE(FileFragment::append(buffer, fd_, 0, 4).ok());
+  buffer.add("tail");
+  EXPECT_FALSE(buffer.frontFileRange().has_value());
+  RawSliceVector slices = buffer.getRawSlicesBeforeFileRange();
+  ASSERT_EQ(1, slices.size());
+  EXPECT_EQ("head", absl::string_view(static_cast<const char*>(slices[0].mem_), slices[0].len_));
+
+  buffer.drain(4);
+  EXPECT_TRUE(buffer.frontFileRange().has_value());
+  EXPECT_EQ("0123tail", buffer.toString());
+}
+
+TEST_F(FileFragmentTest, ReportsARangePastTheEndOfTheFile) {
+  OwnedImpl buffer;
+  int read_failures = 0;
+  ASSERT_TRUE(FileFragment::append(buffer, fd_, 8, 4, [&]() { ++read_failures; }).ok());
+  EXPECT_EQ(4, buffer.toString().size());
+  EXPECT_EQ(1, read_failures);
+  // The contents are only read once.
+  buffer.toString();
+  EXPECT_EQ(1, read_failures);
+}
+
+TEST_F(FileFragmentTest, WritesTheFileToASocket) {
+  os_fd_t fds[2];
+  ASSERT_EQ(0, os_sys_calls_.socketpair(AF_UNIX, SOCK_STREAM, 0, fds).return_value_);
+  Network::IoSocketHandleImpl io_handle(fds[0]);
+  OwnedImpl buffer("head");
+  ASSERT_TRUE(FileFragment::append(buffer, fd_, 0, 10).ok());
+  buffer.add("tail");
+  while (buffer.length() > 0) {
+    ASSERT_TRUE(io_handle.write(buffer).ok());
+  }
+  char received[18];
+  ASSERT_EQ(sizeof(received),
+            os_sys_calls_.recv(fds[1], received, sizeof(received), MSG_WAITALL).return_value_);
+  EXPECT_EQ("head0123456789tail", absl::string_view(received, sizeof(received)));
+  os_sys_calls_.close(fds[1]);
+}
+
+TEST_F(FileFragmentTest, FailsTheWriteOfATruncatedRange) {
+  os_fd_t fds[2];
+  ASSERT_EQ(0, os_sys_calls_.socketpair(AF_UNIX, SOCK_STREAM, 0, fds).return_value_);
+  Network::IoSocketHandleImpl io_handle(fds[0]);
+  OwnedImpl buffer;
+  ASSERT_TRUE(FileFragment::append(buffer, fd_, 0, 10).ok());
+  const int writable_fd = os_sys_calls_.open(path_.c_str(), O_WRONLY).return_value_;
+  ASSERT_NE(writable_fd, -1);
+  EXPECT_EQ(0, os_sys_calls_.ftruncate(writable_fd, 4).return_value_);
+  os_sys_calls_.close(writable_fd);
+
+  // What is left of the range is sent, then the write fails rather than sending nothing.
+  Api::IoCallUint64Result result = io_handle.write(buffer);
+  ASSERT_TRUE(result.ok());
+  EXPECT_EQ(4, result.return_value_);
+  result = io_handle.write(buffer);
+  EXPECT_FALSE(result.ok());
+  EXPECT_NE(Api::IoError::IoErrorCode::Again, result.err_->getErrorCode());
+  EXPECT_EQ(6, buffer.length());
+  os_sys_calls_.close(fds[1]);
+}
+
+// A file-backed fragment with fixed contents, for the tests mocking the system calls.
+class TestFileBackedFragment : public BufferFragment {
+public:
+  const void* data() const override { return "contents"; }
+  size_t size() const override { return 8; }
+  void done() override {}
+  std::optional<FileRange> fileRange() const override { return FileRange{42, 100, 8}; }
+};
+
+TEST(FileBackedWriteTest, SendsTheRangeWithSendfile) {
+  Api::MockOsSysCalls os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  Network::IoSocketHandleImpl io_handle;
+  TestFileBackedFragment fragment;
+  OwnedImpl buffer;
+  buffer.addBufferFragment(fragment);
+
+  EXPECT_CALL(os_sys_calls, sendfile(_, 42, 100, 8)).WillOnce(Return(Api::SysCallSizeResult{5, 0}));
+  Api::IoCallUint64Result result = io_handle.write(buffer);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(5, result.return_value_);
+  EXPECT_EQ(3, buffer.length());
+
+  EXPECT_CALL(os_sys_calls, sendfile(_, 42, 105, 3))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, SOCKET_ERROR_AGAIN}));
+  result = io_handle.write(buffer);
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again, result.err_->getErrorCode());
+  EXPECT_EQ(3, buffer.length());
+}
+
+TEST(FileBackedWriteTest, FallsBackToReadingAndWritingTheRange) {
+  Api::MockOsSysCalls os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  Network::IoSocketHandleImpl io_handle;
+  TestFileBackedFragment fragment1;
+  TestFileBackedFragment fragment2;
+  OwnedImpl buffer;
+  buffer.addBufferFragment(fragment1);
+  buffer.addBufferFragment(fragment2);
+
+  EXPECT_CALL(os_sys_calls, sendfile(_, _, _, _))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, SOCKET_ERROR_INVAL}));
+  EXPECT_CALL(os_sys_calls, pread(42, _, 8, 100)).WillOnce(Return(Api::SysCallSizeResult{8, 0}));
+  EXPECT_CALL(os_sys_calls, send(_, _, 8, _)).WillOnce(Return(Api::SysCallSizeResult{8, 0}));
+  Api::IoCallUint64Result result = io_handle.write(buffer);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(8, buffer.length());
+
+  // The socket does not try sendfile() again.
+  EXPECT_CALL(os_sys_calls, pread(42, _, 8, 100)).WillOnce(Return(Api::SysCallSizeResult{6, 0}));
+  EXPECT_CALL(os_sys_calls, send(_, _, 6, _)).WillOnce(Return(Api::SysCallSizeResult{6, 0}));
+  result = io_handle.write(buffer);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(2, buffer.length());
+
+  // A range past the end of the file fails the write.
+  EXPECT_CALL(os_sys_calls, pread(42, _, 2, 106)).WillOnce(Return(Api::SysCallSizeResult{0, 0}));
+  EXPECT_CALL(os_sys_calls, send(_, _, _, _)).Times(0);
+  result = io_handle.write(buffer);
+  EXPECT_FALSE(result.ok());
+  EXPECT_EQ(2, buffer.length());
+}
+
+} // namespace
+} // namespace Buffer
+} // namespace Envoy
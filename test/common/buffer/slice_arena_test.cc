@@ -0,0 +1,158 @@
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/buffer/slice_arena.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Buffer {
+namespace {
+
+class SliceArenaTest : public testing::Test {
+protected:
+  ~SliceArenaTest() override { SliceArena::configure(0); }
+
+  // Run on a new thread so that each test starts with an empty arena and slice free list.
+  void runOnNewThread(std::function<void()> fn) {
+    Thread::ThreadPtr thread = Thread::threadFactoryForTest().createThread(std::move(fn));
+    thread->join();
+  }
+};
+
+TEST_F(SliceArenaTest, DisabledByDefault) {
+  runOnNewThread([]() {
+    EXPECT_FALSE(SliceArena::enabled());
+    EXPECT_EQ(nullptr, SliceArena::threadLocalArena());
+    Slice::SizedStorage storage = Slice::newArenaStorage();
+    EXPECT_EQ(nullptr, storage.mem_);
+  });
+}
+
+TEST_F(SliceArenaTest, CapIsRoundedDownToChunkSize) {
+  SliceArena::configure(SliceArena::ChunkSize - 1);
+  EXPECT_FALSE(SliceArena::enabled());
+  SliceArena::configure(2 * SliceArena::ChunkSize + 1);
+  EXPECT_TRUE(SliceArena::enabled());
+}
+
+TEST_F(SliceArenaTest, AllocateUpToCap) {
+  SliceArena::configure(2 * SliceArena::ChunkSize);
+  runOnNewThread([]() {
+    SliceArena* arena = SliceArena::threadLocalArena();
+    ASSERT_NE(nullptr, arena);
+    EXPECT_EQ(arena, SliceArena::threadLocalArena());
+
+    std::vector<uint8_t*> blocks;
+    for (uint64_t i = 0; i < 2 * SliceArena::BlocksPerChunk; i++) {
+      uint8_t* block = arena->allocate();
+      ASSERT_NE(nullptr, block);
+      blocks.push_back(block);
+    }
+    EXPECT_EQ(2 * SliceArena::ChunkSize, arena->reservedBytes());
+    EXPECT_EQ(2 * SliceArena::ChunkSize, arena->inUseBytes());
+    EXPECT_EQ(nullptr, arena->allocate());
+    EXPECT_EQ(1, SliceArena::stats().overflow_allocations_);
+    EXPECT_DOUBLE_EQ(1.0, SliceArena::stats().max_pressure_);
+
+    for (uint8_t* block : blocks) {
+      arena->release(block);
+    }
+    EXPECT_EQ(0, arena->inUseBytes());
+    EXPECT_EQ(2 * SliceArena::ChunkSize, arena->reservedBytes());
+    EXPECT_NE(nullptr, arena->allocate());
+    EXPECT_EQ(2 * SliceArena::ChunkSize, arena->reservedBytes());
+  });
+}
+
+TEST_F(SliceArenaTest, CrossThreadReleaseIsReclaimed) {
+  SliceArena::configure(SliceArena::ChunkSize);
+  runOnNewThread([this]() {
+    SliceArena* arena = SliceArena::threadLocalArena();
+    std::vector<uint8_t*> blocks;
+    for (uint64_t i = 0; i < SliceArena::BlocksPerChunk; i++) {
+      blocks.push_back(arena->allocate());
+    }
+    EXPECT_EQ(nullptr, arena->allocate());
+
+    runOnNewThread([&]() {
+      for (uint8_t* block : blocks) {
+        arena->release(block);
+      }
+    });
+    EXPECT_EQ(0, arena->inUseBytes());
+
+    // The blocks released on the other thread are reused without growing the arena.
+    EXPECT_NE(nullptr, arena->allocate());
+    EXPECT_EQ(SliceArena::ChunkSize, arena->reservedBytes());
+  });
+}
+
+TEST_F(SliceArenaTest, ArenaOutlivesOwningThread) {
+  SliceArena::configure(SliceArena::ChunkSize);
+  const uint64_t arenas_before = SliceArena::stats().arenas_;
+
+  OwnedImpl buffer;
+  runOnNewThread([&buffer, arenas_before]() {
+    OwnedImpl local(std::string(Slice::default_slice_size_, 'a'));
+    EXPECT_EQ(1, SliceArena::stats().arenas_ - arenas_before);
+    buffer.move(local);
+  });
+
+  // The owning thread is gone, but its arena stays alive until the moved slice is released.
+  EXPECT_EQ(arenas_before, SliceArena::stats().arenas_);
+  EXPECT_EQ(std::string(Slice::default_slice_size_, 'a'), buffer.toString());
+  buffer.drain(buffer.length());
+}
+
+TEST_F(SliceArenaTest, ReserveForReadUsesArena) {
+  SliceArena::configure(SliceArena::ChunkSize);
+  runOnNewThread([]() {
+    SliceArena* arena = SliceArena::threadLocalArena();
+    OwnedImpl buffer;
+    {
+      Reservation reservation = buffer.reserveForRead();
+      EXPECT_EQ(Reservation::MAX_SLICES_ * SliceArena::BlockSize, arena->inUseBytes());
+      reservation.commit(100);
+    }
+    // Unused reservation slices are kept on the thread's slice free list.
+    EXPECT_EQ(Reservation::MAX_SLICES_ * SliceArena::BlockSize, arena->inUseBytes());
+    EXPECT_EQ(100, buffer.length());
+
+    buffer.drain(100);
+    EXPECT_EQ((Reservation::MAX_SLICES_ - 1) * SliceArena::BlockSize, arena->inUseBytes());
+  });
+}
+
+TEST_F(SliceArenaTest, LargeAddUsesArena) {
+  SliceArena::configure(SliceArena::ChunkSize);
+  runOnNewThread([]() {
+    SliceArena* arena = SliceArena::threadLocalArena();
+    OwnedImpl buffer;
+
+    // Small appends keep using right-sized heap slices.
+    buffer.add(std::string(100, 'a'));
+    EXPECT_EQ(0, arena->inUseBytes());
+
+    // Large appends fill the tail slice, then go to arena blocks until the remainder drops below
+    // half a block.
+    buffer.add(std::string(Slice::default_slice_size_ + 5000, 'b'));
+    EXPECT_EQ(SliceArena::BlockSize, arena->inUseBytes());
+    std::vector<Slice::SliceRepresentation> slices = buffer.describeSlicesForTest();
+    ASSERT_EQ(3, slices.size());
+    EXPECT_EQ(4096, slices[0].capacity);
+    EXPECT_EQ(Slice::default_slice_size_, slices[1].capacity);
+    EXPECT_EQ(4096, slices[2].capacity);
+
+    buffer.drain(buffer.length());
+    EXPECT_EQ(0, arena->inUseBytes());
+  });
+}
+
+} // namespace
+} // namespace Buffer
+} // namespace Envoy
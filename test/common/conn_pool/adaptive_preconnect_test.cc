@@ -0,0 +1,86 @@
+#include <cmath>
+
+#include "source/common/conn_pool/adaptive_preconnect.h"
+
+#include "test/test_common/simulated_time_system.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace ConnectionPool {
+namespace {
+
+class AdaptivePreconnectTest : public testing::Test {
+protected:
+  // Requests streams evenly at the given rate for the given number of seconds.
+  void requestStreams(AdaptivePreconnect& estimator, uint32_t streams_per_second,
+                      uint32_t seconds) {
+    for (uint32_t i = 0; i < streams_per_second * seconds; ++i) {
+      time_system_.advanceTimeWait(std::chrono::microseconds(1000000 / streams_per_second));
+      estimator.onStreamRequested();
+    }
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  envoy::config::cluster::v3::Cluster::PreconnectPolicy::AdaptivePreconnect config_;
+};
+
+TEST_F(AdaptivePreconnectTest, NoHeadroomWithoutConnectLatency) {
+  AdaptivePreconnect estimator(config_, time_system_);
+  requestStreams(estimator, 1000, 5);
+  EXPECT_NEAR(1000, estimator.arrivalRate(), 10);
+  EXPECT_EQ(0, estimator.headroom());
+}
+
+// Small means use the exact percentiles of the Poisson distribution.
+TEST_F(AdaptivePreconnectTest, PoissonPercentile) {
+  AdaptivePreconnect estimator(config_, time_system_);
+  requestStreams(estimator, 100, 5);
+  estimator.onConnected(std::chrono::milliseconds(20));
+  EXPECT_DOUBLE_EQ(0.02, estimator.connectLatency());
+  // About 2 streams arrive within a connect latency, and 6 or fewer do 99% of the time.
+  EXPECT_EQ(6, estimator.headroom());
+
+  config_.mutable_burst_percentile()->set_value(50);
+  AdaptivePreconnect median(config_, time_system_);
+  requestStreams(median, 100, 5);
+  median.onConnected(std::chrono::milliseconds(20));
+  EXPECT_EQ(2, median.headroom());
+}
+
+// Large means use the normal approximation, and the headroom is capped.
+TEST_F(AdaptivePreconnectTest, NormalApproximationAndCap) {
+  AdaptivePreconnect estimator(config_, time_system_);
+  requestStreams(estimator, 1000, 5);
+  estimator.onConnected(std::chrono::milliseconds(50));
+  // 50 + 2.33 * sqrt(50) = 66.4.
+  EXPECT_NEAR(67, estimator.headroom(), 1);
+
+  config_.mutable_max_headroom_streams()->set_value(10);
+  AdaptivePreconnect capped(config_, time_system_);
+  requestStreams(capped, 1000, 5);
+  capped.onConnected(std::chrono::milliseconds(50));
+  EXPECT_EQ(10, capped.headroom());
+}
+
+// The estimates follow the changes of the rate and of the connect latency.
+TEST_F(AdaptivePreconnectTest, Decay) {
+  AdaptivePreconnect estimator(config_, time_system_);
+  requestStreams(estimator, 1000, 5);
+  estimator.onConnected(std::chrono::milliseconds(50));
+  estimator.onConnected(std::chrono::milliseconds(100));
+  EXPECT_DOUBLE_EQ(0.06, estimator.connectLatency());
+
+  // The rate decays by e every time constant without streams.
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  EXPECT_NEAR(1000 / M_E, estimator.arrivalRate(), 5);
+  time_system_.advanceTimeWait(std::chrono::seconds(20));
+  EXPECT_EQ(0, estimator.headroom());
+
+  requestStreams(estimator, 10, 5);
+  EXPECT_NEAR(10, estimator.arrivalRate(), 1);
+}
+
+} // namespace
+} // namespace ConnectionPool
+} // namespace Envoy
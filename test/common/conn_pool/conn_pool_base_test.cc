@@ -734,5 +734,122 @@ TEST_F(ConnPoolImplDispatcherBaseTest, MaxActiveRequestsOverflowLegacy) {
   closeStreamAndDrainClient();
 }
 
+class ConnPoolImplAdaptivePreconnectTest : public testing::Test {
+public:
+  ConnPoolImplAdaptivePreconnectTest()
+      : upstream_ready_cb_(new NiceMock<Event::MockSchedulableCallback>(&dispatcher_)) {
+    cluster_->resetResourceManager(1024, 1024, 1024, 1, 1);
+    config_.mutable_max_headroom_streams()->set_value(3);
+    ON_CALL(*cluster_, adaptivePreconnectConfig())
+        .WillByDefault(Return(
+            OptRef<const envoy::config::cluster::v3::Cluster::PreconnectPolicy::AdaptivePreconnect>(
+                config_)));
+    pool_ = std::make_unique<TestConnPoolImplBase>(host_, Upstream::ResourcePriority::Default,
+                                                   dispatcher_, nullptr, nullptr, state_,
+                                                   overload_manager_);
+    ON_CALL(*pool_, instantiateActiveClient).WillByDefault(Invoke([&]() -> ActiveClientPtr {
+      auto ret = std::make_unique<NiceMock<TestActiveClient>>(*pool_, 100, 1,
+                                                              /*supports_early_data=*/false);
+      clients_.push_back(ret.get());
+      ret->real_host_description_ = descr_;
+      return ret;
+    }));
+    ON_CALL(*pool_, onPoolReady(_, _))
+        .WillByDefault(Invoke([](ActiveClient& client, AttachContext&) {
+          TestActiveClient::incrementActiveStreams(client);
+        }));
+  }
+
+  void closeStream(TestActiveClient& client) {
+    --client.active_streams_;
+    pool_->onStreamClosed(client, false);
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  envoy::config::cluster::v3::Cluster::PreconnectPolicy::AdaptivePreconnect config_;
+  Upstream::ClusterConnectivityState state_;
+  std::shared_ptr<NiceMock<Upstream::MockHostDescription>> descr_{
+      new NiceMock<Upstream::MockHostDescription>()};
+  std::shared_ptr<Upstream::MockClusterInfo> cluster_{new NiceMock<Upstream::MockClusterInfo>()};
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<Event::MockSchedulableCallback>* upstream_ready_cb_;
+  NiceMock<Server::MockOverloadManager> overload_manager_;
+  Upstream::HostSharedPtr host_{Upstream::makeTestHost(cluster_, "tcp://127.0.0.1:80")};
+  std::unique_ptr<TestConnPoolImplBase> pool_;
+  AttachContext context_;
+  std::vector<TestActiveClient*> clients_;
+};
+
+// The pool preconnects for the streams expected within a connect latency, counts the preconnected
+// connections that serve streams and the ones that do not, and trims the idle connections once the
+// rate drops.
+TEST_F(ConnPoolImplAdaptivePreconnectTest, PreconnectHitWasteAndTrim) {
+  // Without a connect latency estimate, the first stream only gets its own connection.
+  EXPECT_CALL(*pool_, instantiateActiveClient);
+  pool_->newStreamImpl(context_, /*can_send_early_data=*/false);
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  clients_[0]->onEvent(Network::ConnectionEvent::Connected);
+  EXPECT_EQ(1, clients_[0]->active_streams_);
+  closeStream(*clients_[0]);
+  EXPECT_EQ(ActiveClient::State::Ready, clients_[0]->state());
+
+  // The second stream takes the ready connection, and a second of connect latency at about one
+  // stream per second calls for the full headroom of 3 streams.
+  EXPECT_CALL(*pool_, instantiateActiveClient).Times(3);
+  pool_->newStreamImpl(context_, /*can_send_early_data=*/false);
+  EXPECT_EQ(4, clients_.size());
+  EXPECT_EQ(1, state_.active_streams_);
+  EXPECT_EQ(3, state_.connecting_and_connected_stream_capacity_);
+  for (size_t i = 1; i < clients_.size(); ++i) {
+    clients_[i]->onEvent(Network::ConnectionEvent::Connected);
+  }
+
+  // The third stream is served by a preconnected connection, and the pool tops up its headroom.
+  EXPECT_CALL(*pool_, instantiateActiveClient);
+  pool_->newStreamImpl(context_, /*can_send_early_data=*/false);
+  EXPECT_EQ(1U, cluster_->traffic_stats_->upstream_cx_preconnect_hit_.value());
+  TestActiveClient* hit = nullptr;
+  for (size_t i = 1; i < 4; ++i) {
+    if (clients_[i]->active_streams_ > 0) {
+      hit = clients_[i];
+    }
+  }
+  ASSERT_NE(nullptr, hit);
+
+  // Once the rate has decayed, the connection that goes idle is closed.
+  time_system_.advanceTimeWait(std::chrono::seconds(100));
+  closeStream(*hit);
+  EXPECT_EQ(ActiveClient::State::Closed, hit->state());
+  EXPECT_EQ(0U, cluster_->traffic_stats_->upstream_cx_preconnect_waste_.value());
+
+  // The three preconnected connections which never served a stream are wasted.
+  pool_->destructAllConnections();
+  EXPECT_EQ(3U, cluster_->traffic_stats_->upstream_cx_preconnect_waste_.value());
+}
+
+// The pools that delay attaching the pending streams keep the client that goes idle for them.
+TEST_F(ConnPoolImplAdaptivePreconnectTest, KeepIdleClientForPendingStream) {
+  EXPECT_CALL(*pool_, instantiateActiveClient).Times(AnyNumber());
+  for (int i = 0; i < 3; ++i) {
+    pool_->newStreamImpl(context_, /*can_send_early_data=*/false);
+  }
+  ASSERT_GE(clients_.size(), 3);
+  clients_[0]->onEvent(Network::ConnectionEvent::Connected);
+  clients_[1]->onEvent(Network::ConnectionEvent::Connected);
+  EXPECT_EQ(1, clients_[0]->active_streams_);
+  EXPECT_EQ(1, clients_[1]->active_streams_);
+
+  // Both streams close once the rate has decayed, while the third one is still pending.
+  time_system_.advanceTimeWait(std::chrono::seconds(100));
+  --clients_[0]->active_streams_;
+  pool_->onStreamClosed(*clients_[0], /*delay_attaching_stream=*/true);
+  --clients_[1]->active_streams_;
+  pool_->onStreamClosed(*clients_[1], /*delay_attaching_stream=*/true);
+  EXPECT_EQ(ActiveClient::State::Ready, clients_[0]->state());
+  EXPECT_EQ(ActiveClient::State::Ready, clients_[1]->state());
+
+  pool_->destructAllConnections();
+}
+
 } // namespace ConnectionPool
 } // namespace Envoy
@@ -32,6 +32,8 @@ struct LeafController {
   // When set, the leaf's onCancel() erroneously calls complete() -- a contract
   // violation used to exercise the ENVOY_BUG guard in LeafAwaitable::complete().
   bool complete_during_on_cancel = false;
+  // When set, onStart() completes the leaf synchronously with this value.
+  std::optional<absl::Status> complete_in_on_start;
   Executor* observed_executor = nullptr;
   // Valid while the leaf is the pending op; invoking it delivers a value.
   absl::AnyInvocable<void(absl::Status)> completer;
@@ -54,6 +56,10 @@ protected:
   void onStart() override {
     controller_.started = true;
     controller_.observed_executor = &context().executor();
+    if (controller_.complete_in_on_start.has_value()) {
+      complete(*controller_.complete_in_on_start);
+      return;
+    }
     controller_.completer = [this](absl::Status status) { complete(std::move(status)); };
   }
   void onCancel() override {
@@ -100,6 +106,12 @@ Task<absl::Status> awaitLeaf(LeafController& controller) {
   co_return co_await leaf;
 }
 
+// Same as awaitLeaf(), with its frame allocated from `arena`.
+Task<absl::Status> awaitLeafInArena(FrameArena&, LeafController& controller) {
+  TestLeaf leaf(controller);
+  co_return co_await leaf;
+}
+
 // A chain N levels deep, ending in a leaf, to exercise context propagation.
 Task<absl::Status> chainLevel0(LeafController& controller) {
   TestLeaf leaf(controller);
@@ -480,6 +492,85 @@ TEST(LaunchTest, InlineStartRunsUpToFirstSuspension) {
   EXPECT_TRUE(result->ok());
 }
 
+// A leaf may complete inside onStart(); the coroutine then continues without
+// suspending and without anything being scheduled.
+TEST(LeafAwaitableTest, CompleteInOnStartContinuesWithoutSuspending) {
+  auto exec = std::make_shared<ManualExecutor>();
+  LeafController controller;
+  controller.complete_in_on_start = absl::UnavailableError("inline failure");
+  std::optional<absl::Status> result;
+  DetachedHandle handle = launch(
+      awaitLeaf(controller), exec, [&result](absl::Status status) { result = std::move(status); },
+      StartMode::Inline);
+  EXPECT_TRUE(controller.started);
+  EXPECT_TRUE(exec->empty());
+  ASSERT_TRUE(result.has_value());
+  EXPECT_TRUE(absl::IsUnavailable(*result));
+
+  // The leaf is no longer pending, so a late cancel has nothing to do.
+  handle.cancel();
+  EXPECT_FALSE(controller.cancelled);
+}
+
+// ---------------------------------------------------------------------------
+// FrameArena.
+// ---------------------------------------------------------------------------
+TEST(FrameArenaTest, LaunchAllocatesFromArena) {
+  auto exec = std::make_shared<ManualExecutor>();
+  InlineFrameArena<4096> arena;
+  LeafController controller;
+  std::optional<absl::Status> result;
+  std::optional<DetachedHandle> handle = launch(
+      arena, awaitLeafInArena(arena, controller), exec,
+      [&result](absl::Status status) { result = std::move(status); }, StartMode::Inline);
+  EXPECT_TRUE(controller.started);
+  EXPECT_GT(arena.bytesInUse(), 0);
+
+  controller.completeWith(absl::OkStatus());
+  ASSERT_TRUE(result.has_value());
+  EXPECT_TRUE(result->ok());
+  // The cancellation state is shared with the handle, so the arena only rewinds
+  // once the handle is gone.
+  EXPECT_GT(arena.bytesInUse(), 0);
+  handle.reset();
+  EXPECT_EQ(0, arena.bytesInUse());
+  EXPECT_EQ(0, arena.heapAllocations());
+}
+
+TEST(FrameArenaTest, CancelReleasesFrames) {
+  auto exec = std::make_shared<ManualExecutor>();
+  InlineFrameArena<4096> arena;
+  LeafController controller;
+  std::optional<absl::Status> result;
+  {
+    DetachedHandle handle = launch(
+        arena, awaitLeafInArena(arena, controller), exec,
+        [&result](absl::Status status) { result = std::move(status); }, StartMode::Inline);
+    handle.cancel();
+    EXPECT_TRUE(controller.cancelled);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_TRUE(absl::IsCancelled(*result));
+  }
+  EXPECT_EQ(0, arena.bytesInUse());
+}
+
+TEST(FrameArenaTest, FallsBackToHeapWhenFull) {
+  auto exec = std::make_shared<ManualExecutor>();
+  InlineFrameArena<16> arena;
+  LeafController controller;
+  std::optional<absl::Status> result;
+  {
+    DetachedHandle handle = launch(
+        arena, awaitLeafInArena(arena, controller), exec,
+        [&result](absl::Status status) { result = std::move(status); }, StartMode::Inline);
+    EXPECT_GT(arena.heapAllocations(), 0);
+    controller.completeWith(absl::OkStatus());
+  }
+  ASSERT_TRUE(result.has_value());
+  EXPECT_TRUE(result->ok());
+  EXPECT_EQ(0, arena.bytesInUse());
+}
+
 } // namespace
 } // namespace Coroutine
 } // namespace Envoy
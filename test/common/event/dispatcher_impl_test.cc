@@ -445,7 +445,7 @@ TEST_F(DispatcherImplTest, RunPostCallbacksLocking) {
     // Block dispatcher first to ensure that both posted events below are handled
     // by a single call to runPostCallbacks().
     //
-    // This also ensures that the post_lock_ is not held while callbacks are called,
+    // This also ensures that callbacks can post while the posted callbacks are called,
     // or else this would deadlock.
     Thread::LockGuard lock(mu_);
     dispatcher_->post([this]() { Thread::LockGuard lock(mu_); });
@@ -468,6 +468,42 @@ TEST_F(DispatcherImplTest, RunPostCallbacksLocking) {
   }
 }
 
+// Ensure that the callbacks posted concurrently by several threads all run, in the order each
+// thread posted them.
+TEST_F(DispatcherImplTest, ConcurrentPosts) {
+  constexpr uint32_t NumThreads = 4;
+  constexpr uint32_t PostsPerThread = 10000;
+  // Only accessed from the dispatcher thread.
+  std::vector<uint32_t> next_post(NumThreads, 0);
+  uint32_t num_run = 0;
+
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t i = 0; i < NumThreads; ++i) {
+    threads.push_back(api_->threadFactory().createThread([&, i]() {
+      for (uint32_t post = 0; post < PostsPerThread; ++post) {
+        dispatcher_->post([&, i, post]() {
+          EXPECT_EQ(next_post[i]++, post);
+          if (++num_run == NumThreads * PostsPerThread) {
+            {
+              Thread::LockGuard lock(mu_);
+              work_finished_ = true;
+            }
+            cv_.notifyOne();
+          }
+        });
+      }
+    }));
+  }
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+
+  Thread::LockGuard lock(mu_);
+  while (!work_finished_) {
+    cv_.wait(mu_);
+  }
+}
+
 TEST_F(DispatcherImplTest, DispatcherThreadDeleted) {
   dispatcher_->deleteInDispatcherThread(std::make_unique<TestDispatcherThreadDeletable>(
       [this, id = api_->threadFactory().currentThreadId()]() {
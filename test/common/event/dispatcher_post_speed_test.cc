@@ -0,0 +1,68 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <algorithm>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+
+#include "source/common/api/api_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Event {
+
+// Measures the throughput of the callbacks posted to a dispatcher by the given number of threads
+// at the same time, as the main thread does to the workers during cluster updates, and the
+// latency between posting a callback and running it.
+static void dispatcherPost(::benchmark::State& state) {
+  const uint32_t num_producers = state.range(0);
+  const uint32_t posts_per_producer =
+      (benchmark::skipExpensiveBenchmarks() ? 1000 : 1000000) / num_producers;
+  const uint32_t total_posts = num_producers * posts_per_producer;
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher = api->allocateDispatcher("post_speed_test");
+  TimeSource& time_source = api->timeSource();
+
+  // Only accessed from the dispatcher thread.
+  std::vector<std::chrono::nanoseconds> latencies;
+  latencies.reserve(total_posts);
+  uint32_t remaining = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    latencies.clear();
+    remaining = total_posts;
+    std::vector<Thread::ThreadPtr> producers;
+    for (uint32_t i = 0; i < num_producers; ++i) {
+      producers.push_back(api->threadFactory().createThread([&]() {
+        for (uint32_t post = 0; post < posts_per_producer; ++post) {
+          dispatcher->post([&, posted_at = time_source.monotonicTime()]() {
+            latencies.push_back(time_source.monotonicTime() - posted_at);
+            if (--remaining == 0) {
+              dispatcher->exit();
+            }
+          });
+        }
+      }));
+    }
+    dispatcher->run(Dispatcher::RunType::RunUntilExit);
+    for (Thread::ThreadPtr& producer : producers) {
+      producer->join();
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * total_posts);
+  std::sort(latencies.begin(), latencies.end());
+  state.counters["p50_latency_us"] =
+      std::chrono::duration<double, std::micro>(latencies[latencies.size() / 2]).count();
+  state.counters["p99_latency_us"] =
+      std::chrono::duration<double, std::micro>(latencies[latencies.size() * 99 / 100]).count();
+}
+BENCHMARK(dispatcherPost)->Arg(1)->Arg(4)->Arg(16)->Arg(64)->UseRealTime()->Unit(
+    ::benchmark::kMillisecond);
+
+} // namespace Event
+} // namespace Envoy
@@ -0,0 +1,103 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <chrono>
+#include <vector>
+
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
+
+#include "source/common/api/api_impl.h"
+#include "source/common/common/random_generator.h"
+#include "source/common/event/real_time_system.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Event {
+
+class TimerSpeedTest {
+public:
+  TimerSpeedTest(bool timer_wheel, uint32_t num_timers) {
+    if (timer_wheel) {
+      bootstrap_.mutable_timer_wheel();
+    }
+    api_ = std::make_unique<Api::Impl>(Thread::threadFactoryForTest(), stats_store_, time_system_,
+                                       Filesystem::fileSystemForTest(), random_, bootstrap_);
+    dispatcher_ = api_->allocateDispatcher("timer_speed_test");
+    timers_.reserve(num_timers);
+    for (uint32_t i = 0; i < num_timers; ++i) {
+      timers_.push_back(dispatcher_->createTimer([this]() {
+        if (--remaining_ == 0) {
+          dispatcher_->exit();
+        }
+      }));
+    }
+  }
+
+  // Moves the timers forwards, as the idle and stream timeouts are on every read and write, and
+  // disables some of them, as most timeouts are disabled before they fire.
+  void rearm() {
+    for (uint32_t i = 0; i < timers_.size(); ++i) {
+      if (i % 4 == 0) {
+        timers_[i]->disableTimer();
+      } else {
+        timers_[i]->enableTimer(std::chrono::milliseconds(15000 + i % 1000));
+      }
+    }
+  }
+
+  // Enables the timers with timeouts spread over 100ms, and runs the dispatcher until they fire.
+  void fire() {
+    remaining_ = timers_.size();
+    for (uint32_t i = 0; i < timers_.size(); ++i) {
+      timers_[i]->enableTimer(std::chrono::milliseconds(1 + i % 100));
+    }
+    dispatcher_->run(Dispatcher::RunType::RunUntilExit);
+  }
+
+private:
+  RealTimeSystem time_system_;
+  Stats::IsolatedStoreImpl stats_store_;
+  Random::RandomGeneratorImpl random_;
+  envoy::config::bootstrap::v3::Bootstrap bootstrap_;
+  Api::ApiPtr api_;
+  DispatcherPtr dispatcher_;
+  std::vector<TimerPtr> timers_;
+  uint64_t remaining_{};
+};
+
+// Measures enabling and disabling timers that do not fire, with libevent timers for a first
+// argument of 0, and with the timer wheel for 1.
+static void timerRearm(::benchmark::State& state) {
+  const uint32_t num_timers = benchmark::skipExpensiveBenchmarks() ? 1000 : state.range(1);
+  TimerSpeedTest test(state.range(0) != 0, num_timers);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    test.rearm();
+  }
+  state.SetItemsProcessed(state.iterations() * num_timers);
+}
+BENCHMARK(timerRearm)
+    ->ArgsProduct({{0, 1}, {1000, 100000, 1000000}})
+    ->Unit(::benchmark::kMillisecond);
+
+// Measures running timers that fire, with libevent timers for a first argument of 0, and with the
+// timer wheel for 1.
+static void timerFire(::benchmark::State& state) {
+  const uint32_t num_timers = benchmark::skipExpensiveBenchmarks() ? 1000 : state.range(1);
+  TimerSpeedTest test(state.range(0) != 0, num_timers);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    test.fire();
+  }
+  state.SetItemsProcessed(state.iterations() * num_timers);
+}
+BENCHMARK(timerFire)
+    ->ArgsProduct({{0, 1}, {1000, 100000, 1000000}})
+    ->UseRealTime()
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace Event
+} // namespace Envoy
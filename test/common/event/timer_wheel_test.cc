@@ -0,0 +1,172 @@
+#include <chrono>
+
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
+
+#include "source/common/api/api_impl.h"
+#include "source/common/common/random_generator.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Event {
+namespace {
+
+class TimerWheelTest : public testing::Test {
+protected:
+  void initialize(std::chrono::milliseconds tick) {
+    *bootstrap_.mutable_timer_wheel()->mutable_tick() =
+        Protobuf::util::TimeUtil::MillisecondsToDuration(tick.count());
+    api_ = std::make_unique<Api::Impl>(Thread::threadFactoryForTest(), stats_store_, time_system_,
+                                       Filesystem::fileSystemForTest(), random_, bootstrap_);
+    dispatcher_ = api_->allocateDispatcher("test_thread");
+  }
+
+  // Advances the time one millisecond at a time, running the dispatcher after each step.
+  void advance(std::chrono::milliseconds duration) {
+    for (int64_t i = 0; i < duration.count(); ++i) {
+      time_system_.advanceTimeAndRun(std::chrono::milliseconds(1), *dispatcher_,
+                                     Dispatcher::RunType::NonBlock);
+    }
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Stats::IsolatedStoreImpl stats_store_;
+  Random::RandomGeneratorImpl random_;
+  envoy::config::bootstrap::v3::Bootstrap bootstrap_;
+  Api::ApiPtr api_;
+  DispatcherPtr dispatcher_;
+};
+
+// Timers fire on the millisecond they expire, whichever level of the wheel holds them.
+TEST_F(TimerWheelTest, TimerTiming) {
+  initialize(std::chrono::milliseconds(1));
+  uint32_t fired = 0;
+  TimerPtr timer = dispatcher_->createTimer([&fired]() { ++fired; });
+
+  const uint64_t timings[] = {1, 10, 255, 256, 257, 1234, 65535, 65537};
+  for (const uint64_t timing : timings) {
+    timer->enableTimer(std::chrono::milliseconds(timing));
+    advance(std::chrono::milliseconds(timing - 1));
+    EXPECT_TRUE(timer->enabled()) << timing;
+    EXPECT_EQ(0, fired) << timing;
+    advance(std::chrono::milliseconds(1));
+    EXPECT_FALSE(timer->enabled()) << timing;
+    EXPECT_EQ(1, fired) << timing;
+    fired = 0;
+  }
+}
+
+// Timers fire at the first tick after they expire.
+TEST_F(TimerWheelTest, CoarseTick) {
+  initialize(std::chrono::milliseconds(10));
+  bool fired = false;
+  TimerPtr timer = dispatcher_->createTimer([&fired]() { fired = true; });
+
+  timer->enableTimer(std::chrono::milliseconds(15));
+  advance(std::chrono::milliseconds(19));
+  EXPECT_FALSE(fired);
+  advance(std::chrono::milliseconds(1));
+  EXPECT_TRUE(fired);
+}
+
+TEST_F(TimerWheelTest, DisableAndReenable) {
+  initialize(std::chrono::milliseconds(1));
+  uint32_t fired = 0;
+  TimerPtr timer = dispatcher_->createTimer([&fired]() { ++fired; });
+
+  timer->enableTimer(std::chrono::milliseconds(100));
+  advance(std::chrono::milliseconds(50));
+  timer->disableTimer();
+  EXPECT_FALSE(timer->enabled());
+  advance(std::chrono::milliseconds(100));
+  EXPECT_EQ(0, fired);
+
+  // Moving the timer forwards and backwards only keeps the last timeout.
+  timer->enableTimer(std::chrono::milliseconds(1000));
+  timer->enableTimer(std::chrono::milliseconds(10));
+  advance(std::chrono::milliseconds(10));
+  EXPECT_EQ(1, fired);
+  advance(std::chrono::milliseconds(1000));
+  EXPECT_EQ(1, fired);
+}
+
+// Zero and high resolution timeouts are not rounded up to a tick.
+TEST_F(TimerWheelTest, PreciseTimeouts) {
+  initialize(std::chrono::milliseconds(10));
+  uint32_t fired = 0;
+  TimerPtr timer = dispatcher_->createTimer([&fired]() { ++fired; });
+
+  timer->enableTimer(std::chrono::milliseconds(0));
+  EXPECT_TRUE(timer->enabled());
+  dispatcher_->run(Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(1, fired);
+
+  timer->enableHRTimer(std::chrono::microseconds(500));
+  EXPECT_TRUE(timer->enabled());
+  time_system_.advanceTimeAndRun(std::chrono::microseconds(499), *dispatcher_,
+                                 Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(1, fired);
+  time_system_.advanceTimeAndRun(std::chrono::microseconds(1), *dispatcher_,
+                                 Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(2, fired);
+
+  // Enabling a coarse timeout replaces the high resolution one.
+  timer->enableHRTimer(std::chrono::microseconds(500));
+  timer->enableTimer(std::chrono::milliseconds(20));
+  advance(std::chrono::milliseconds(19));
+  EXPECT_EQ(2, fired);
+  advance(std::chrono::milliseconds(1));
+  EXPECT_EQ(3, fired);
+  EXPECT_FALSE(timer->enabled());
+}
+
+// The callbacks of the timers that expire on the same tick can disable, enable and destroy each
+// other.
+TEST_F(TimerWheelTest, CallbacksUpdateDueTimers) {
+  initialize(std::chrono::milliseconds(1));
+  TimerPtr timer2;
+  TimerPtr timer3;
+  uint32_t fired3 = 0;
+  TimerPtr timer1 = dispatcher_->createTimer([&]() {
+    timer2.reset();
+    if (timer3->enabled()) {
+      timer3->enableTimer(std::chrono::milliseconds(5));
+    }
+  });
+  timer2 = dispatcher_->createTimer([]() {});
+  timer3 = dispatcher_->createTimer([&fired3]() { ++fired3; });
+
+  timer1->enableTimer(std::chrono::milliseconds(10));
+  timer2->enableTimer(std::chrono::milliseconds(10));
+  timer3->enableTimer(std::chrono::milliseconds(10));
+  advance(std::chrono::milliseconds(10));
+  EXPECT_EQ(nullptr, timer2);
+  // The third timer either ran before the first one, or was moved by it.
+  advance(std::chrono::milliseconds(5));
+  EXPECT_EQ(1, fired3);
+  EXPECT_FALSE(timer1->enabled());
+  EXPECT_FALSE(timer3->enabled());
+}
+
+// Timers keep firing at the right time when the wheel was idle for longer than its first level.
+TEST_F(TimerWheelTest, IdleWheel) {
+  initialize(std::chrono::milliseconds(1));
+  bool fired = false;
+  TimerPtr timer = dispatcher_->createTimer([&fired]() { fired = true; });
+
+  time_system_.advanceTimeAndRun(std::chrono::seconds(100), *dispatcher_,
+                                 Dispatcher::RunType::NonBlock);
+  timer->enableTimer(std::chrono::milliseconds(300));
+  advance(std::chrono::milliseconds(299));
+  EXPECT_FALSE(fired);
+  advance(std::chrono::milliseconds(1));
+  EXPECT_TRUE(fired);
+}
+
+} // namespace
+} // namespace Event
+} // namespace Envoy
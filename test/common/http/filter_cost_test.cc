@@ -0,0 +1,87 @@
+#include <chrono>
+
+#include "source/common/http/filter_cost.h"
+#include "source/common/stats/symbol_table.h"
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+class FilterCostTrackerTest : public testing::Test {
+public:
+  void runFilter(absl::string_view name, std::chrono::milliseconds duration) {
+    tracker_.onFilterStart(name);
+    time_system_.advanceTimeWait(duration);
+    tracker_.onFilterEnd();
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  FilterCostTracker tracker_{time_system_};
+};
+
+TEST_F(FilterCostTrackerTest, AccumulatesPerFilter) {
+  runFilter("a", std::chrono::milliseconds(5));
+  runFilter("b", std::chrono::milliseconds(3));
+  runFilter("a", std::chrono::milliseconds(2));
+
+  const auto& costs = tracker_.filterCosts();
+  ASSERT_EQ(2, costs.size());
+  EXPECT_EQ("a", costs[0].filter_name_);
+  EXPECT_EQ(std::chrono::milliseconds(7), costs[0].wall_time_);
+  EXPECT_EQ("b", costs[1].filter_name_);
+  EXPECT_EQ(std::chrono::milliseconds(3), costs[1].wall_time_);
+  EXPECT_GE(costs[0].cpu_time_.count(), 0);
+}
+
+// A callback that re-enters the filter chain is not charged for the filters it calls into.
+TEST_F(FilterCostTrackerTest, NestedCallbackNotChargedToCaller) {
+  tracker_.onFilterStart("a");
+  time_system_.advanceTimeWait(std::chrono::milliseconds(1));
+  runFilter("b", std::chrono::milliseconds(4));
+  time_system_.advanceTimeWait(std::chrono::milliseconds(2));
+  tracker_.onFilterEnd();
+
+  const auto& costs = tracker_.filterCosts();
+  ASSERT_EQ(2, costs.size());
+  EXPECT_EQ(std::chrono::milliseconds(3), costs[0].wall_time_);
+  EXPECT_EQ(std::chrono::milliseconds(4), costs[1].wall_time_);
+}
+
+TEST_F(FilterCostTrackerTest, Fields) {
+  runFilter("envoy.filters.http.router", std::chrono::milliseconds(5));
+
+  EXPECT_TRUE(tracker_.hasFieldSupport());
+  EXPECT_EQ(5000, absl::get<int64_t>(tracker_.getField("envoy.filters.http.router.wall_time_us")));
+  EXPECT_TRUE(absl::holds_alternative<int64_t>(
+      tracker_.getField("envoy.filters.http.router.cpu_time_us")));
+  EXPECT_TRUE(absl::holds_alternative<absl::monostate>(tracker_.getField("other.wall_time_us")));
+  EXPECT_TRUE(
+      absl::holds_alternative<absl::monostate>(tracker_.getField("envoy.filters.http.router")));
+  EXPECT_THAT(tracker_.serializeAsString().value(),
+              testing::MatchesRegex("envoy\\.filters\\.http\\.router:5000:[0-9]+"));
+}
+
+TEST_F(FilterCostTrackerTest, RecordStats) {
+  runFilter("a", std::chrono::milliseconds(5));
+  runFilter("b", std::chrono::milliseconds(3));
+
+  Stats::TestUtil::TestStore store;
+  Stats::StatNameManagedStorage prefix("http.test.", store.symbolTable());
+  tracker_.recordStats(*store.rootScope(), prefix.statName());
+
+  EXPECT_EQ(std::vector<uint64_t>({5000}),
+            store.histogramValues("http.test.filter_cost.a.wall_time_us", false));
+  EXPECT_EQ(std::vector<uint64_t>({3000}),
+            store.histogramValues("http.test.filter_cost.b.wall_time_us", false));
+  EXPECT_TRUE(store.histogramRecordedValues("http.test.filter_cost.a.cpu_time_us"));
+}
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
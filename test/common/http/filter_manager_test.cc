@@ -224,6 +224,53 @@ TEST_F(FilterManagerTest, RequestHeadersOrResponseHeadersAccess) {
   filter_manager_->destroyFilters();
 }
 
+// Verifies that the time spent in each filter callback is attributed to the filter when filter
+// cost tracking is enabled.
+TEST_F(FilterManagerTest, FilterCostTracking) {
+  initialize();
+
+  std::shared_ptr<MockStreamDecoderFilter> filter_1(new NiceMock<MockStreamDecoderFilter>());
+  std::shared_ptr<MockStreamDecoderFilter> filter_2(new NiceMock<MockStreamDecoderFilter>());
+
+  EXPECT_CALL(filter_factory_, createFilterChain(_))
+      .WillOnce(Invoke([&](FilterChainFactoryCallbacks& callbacks) -> bool {
+        auto factory = createDecoderFilterFactoryCb(filter_1);
+        callbacks.setFilterConfigName("configName1");
+        factory(callbacks);
+        factory = createDecoderFilterFactoryCb(filter_2);
+        callbacks.setFilterConfigName("configName2");
+        factory(callbacks);
+        return true;
+      }));
+
+  RequestHeaderMapPtr request_headers{
+      new TestRequestHeaderMapImpl{{":authority", "host"}, {":path", "/"}, {":method", "GET"}}};
+  ON_CALL(filter_manager_callbacks_, requestHeaders())
+      .WillByDefault(Return(makeOptRef(*request_headers)));
+
+  EXPECT_EQ(nullptr, filter_manager_->filterCostTracker());
+  filter_manager_->enableFilterCostTracking();
+  filter_manager_->createDownstreamFilterChain();
+  filter_manager_->requestHeadersInitialized();
+
+  EXPECT_CALL(*filter_1, decodeHeaders(_, false)).WillOnce(Return(FilterHeadersStatus::Continue));
+  EXPECT_CALL(*filter_2, decodeHeaders(_, false))
+      .WillOnce(Return(FilterHeadersStatus::StopIteration));
+  filter_manager_->decodeHeaders(*request_headers, false);
+
+  const auto* tracker =
+      filter_manager_->streamInfo().filterState()->getDataReadOnly<FilterCostTracker>(
+          FilterCostTracker::key());
+  ASSERT_NE(nullptr, tracker);
+  EXPECT_EQ(tracker, filter_manager_->filterCostTracker());
+  ASSERT_EQ(2, tracker->filterCosts().size());
+  EXPECT_EQ("configName1", tracker->filterCosts()[0].filter_name_);
+  EXPECT_EQ("configName2", tracker->filterCosts()[1].filter_name_);
+  EXPECT_TRUE(absl::holds_alternative<int64_t>(tracker->getField("configName2.wall_time_us")));
+
+  filter_manager_->destroyFilters();
+}
+
 // Verifies that the local reply persists the gRPC classification even if the request headers are
 // modified.
 TEST_F(FilterManagerTest, SendLocalReplyDuringDecodingGrpcClassiciation) {
@@ -1,8 +1,12 @@
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
 
+#include "source/common/common/cleanup.h"
 #include "source/common/http/http1/balsa_parser.h"
+#include "source/common/http/http1/legacy_parser_impl.h"
+#include "source/common/runtime/runtime_features.h"
 
 #include "benchmark/benchmark.h"
 
@@ -32,6 +36,24 @@ const char* headerNameShapeLabel(const HeaderNameShape shape) {
   return "unknown";
 }
 
+enum class ParserKind : int {
+  Legacy = 0,
+  Balsa = 1,
+  BalsaVectorized = 2,
+};
+
+const char* parserKindLabel(const ParserKind kind) {
+  switch (kind) {
+  case ParserKind::Legacy:
+    return "legacy";
+  case ParserKind::Balsa:
+    return "balsa";
+  case ParserKind::BalsaVectorized:
+    return "balsa-vectorized";
+  }
+  return "unknown";
+}
+
 class HeaderCountingCallbacks : public ParserCallbacks {
 public:
   CallbackResult onMessageBegin() override { return CallbackResult::Success; }
@@ -88,16 +110,36 @@ std::string makeRequest(const int header_count, const HeaderNameShape shape) {
   return request;
 }
 
+std::unique_ptr<Parser> makeParser(const ParserKind kind, HeaderCountingCallbacks& callbacks,
+                                   const size_t max_header_length) {
+  if (kind == ParserKind::Legacy) {
+    return std::make_unique<LegacyHttpParserImpl>(MessageType::Request, &callbacks);
+  }
+  return std::make_unique<BalsaParser>(MessageType::Request, &callbacks, max_header_length, false,
+                                       false);
+}
+
 void bmParseHeaders(benchmark::State& state) {
   const int header_count = state.range(0);
   const HeaderNameShape shape = static_cast<HeaderNameShape>(state.range(1));
+  const ParserKind kind = static_cast<ParserKind>(state.range(2));
   const std::string request = makeRequest(header_count, shape);
-  state.SetLabel(headerNameShapeLabel(shape));
+  state.SetLabel(std::string(headerNameShapeLabel(shape)) + "/" + parserKindLabel(kind));
+  // The Balsa parsers select their scanner when they are constructed. The guard is set once,
+  // outside of the timed loop, and restored for the next benchmark.
+  const bool vectorized_header_scan =
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.http1_vectorized_header_scan");
+  Runtime::maybeSetRuntimeGuard("envoy.reloadable_features.http1_vectorized_header_scan",
+                                kind == ParserKind::BalsaVectorized);
+  Cleanup restore_guard([vectorized_header_scan]() {
+    Runtime::maybeSetRuntimeGuard("envoy.reloadable_features.http1_vectorized_header_scan",
+                                  vectorized_header_scan);
+  });
   {
     HeaderCountingCallbacks callbacks;
-    BalsaParser parser(MessageType::Request, &callbacks, request.size(), false, false);
-    const size_t parsed = parser.execute(request.data(), request.size());
-    if (parsed != request.size() || parser.getStatus() != ParserStatus::Ok ||
+    std::unique_ptr<Parser> parser = makeParser(kind, callbacks, request.size());
+    const size_t parsed = parser->execute(request.data(), request.size());
+    if (parsed != request.size() || parser->getStatus() != ParserStatus::Ok ||
         callbacks.headersSeen() != static_cast<size_t>(header_count)) {
       state.SkipWithError("benchmark request failed to parse");
       return;
@@ -106,8 +148,8 @@ void bmParseHeaders(benchmark::State& state) {
 
   for (auto _ : state) {
     HeaderCountingCallbacks callbacks;
-    BalsaParser parser(MessageType::Request, &callbacks, request.size(), false, false);
-    const size_t parsed = parser.execute(request.data(), request.size());
+    std::unique_ptr<Parser> parser = makeParser(kind, callbacks, request.size());
+    const size_t parsed = parser->execute(request.data(), request.size());
     benchmark::DoNotOptimize(parsed);
     benchmark::DoNotOptimize(callbacks.headersSeen());
     benchmark::DoNotOptimize(callbacks.bytesSeen());
@@ -117,8 +159,8 @@ void bmParseHeaders(benchmark::State& state) {
 }
 
 BENCHMARK(bmParseHeaders)
-    ->ArgsProduct({{8, 16, 64, 256, 512}, {0, 1, 2}})
-    ->ArgNames({"headers", "shape"});
+    ->ArgsProduct({{8, 16, 64, 256, 512}, {0, 1, 2}, {0, 1, 2}})
+    ->ArgNames({"headers", "shape", "parser"});
 
 } // namespace
 } // namespace Http1
@@ -4,6 +4,8 @@
 
 #include "source/common/http/http1/balsa_parser.h"
 
+#include "test/test_common/test_runtime.h"
+
 #include "gtest/gtest.h"
 
 namespace Envoy {
@@ -100,6 +102,63 @@ TEST(BalsaParserMethodValidationTest, ParsesCustomMethodContainingEveryTokenChar
   EXPECT_EQ(kValidHttpTokenCharacters, parser.methodName());
 }
 
+// Runs with both the scalar and the vectorized header scanner.
+class BalsaParserHeaderScannerTest : public testing::TestWithParam<bool> {
+protected:
+  BalsaParserHeaderScannerTest() {
+    scoped_runtime_.mergeValues({{"envoy.reloadable_features.http1_vectorized_header_scan",
+                                  GetParam() ? "true" : "false"}});
+  }
+
+  TestScopedRuntime scoped_runtime_;
+};
+
+INSTANTIATE_TEST_SUITE_P(Vectorized, BalsaParserHeaderScannerTest, testing::Bool());
+
+// Header names long enough to take the vector loops, with an invalid character at every position.
+TEST_P(BalsaParserHeaderScannerTest, RejectsInvalidCharacterAtEveryPosition) {
+  const std::string valid_name = std::string(kValidHttpTokenCharacters).substr(0, 70);
+  for (size_t position = 0; position < valid_name.size(); ++position) {
+    SCOPED_TRACE(testing::Message() << "position " << position);
+    std::string name = valid_name;
+    name[position] = '@';
+    const std::string request = "GET / HTTP/1.1\r\n" + name + ": value\r\n\r\n";
+
+    RecordingCallbacks callbacks;
+    BalsaParser parser(MessageType::Request, &callbacks, request.size(), false, false);
+    parser.execute(request.data(), request.size());
+
+    EXPECT_EQ(ParserStatus::Error, parser.getStatus());
+    EXPECT_EQ("HPE_INVALID_HEADER_TOKEN", parser.errorMessage());
+  }
+}
+
+TEST_P(BalsaParserHeaderScannerTest, ParsesLongValidHeaderNames) {
+  std::string request = "GET / HTTP/1.1\r\n";
+  for (int i = 0; i < 4; ++i) {
+    request += std::to_string(i) + kValidHttpTokenCharacters + ": value\r\n";
+  }
+  request += "\r\n";
+
+  RecordingCallbacks callbacks;
+  BalsaParser parser(MessageType::Request, &callbacks, request.size(), false, false);
+
+  EXPECT_EQ(request.size(), parser.execute(request.data(), request.size()));
+  EXPECT_EQ(ParserStatus::Ok, parser.getStatus()) << parser.errorMessage();
+  EXPECT_EQ(4, callbacks.headerNames().size());
+}
+
+TEST_P(BalsaParserHeaderScannerTest, RejectsInvalidCustomMethod) {
+  const std::string request = std::string(kValidHttpTokenCharacters) + "@ / HTTP/1.1\r\n\r\n";
+
+  RecordingCallbacks callbacks;
+  BalsaParser parser(MessageType::Request, &callbacks, request.size(), false, true);
+  parser.execute(request.data(), request.size());
+
+  EXPECT_EQ(ParserStatus::Error, parser.getStatus());
+  EXPECT_EQ("HPE_INVALID_METHOD", parser.errorMessage());
+}
+
 } // namespace
 } // namespace Http1
 } // namespace Http
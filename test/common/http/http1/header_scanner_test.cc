@@ -0,0 +1,80 @@
+#include <string>
+#include <vector>
+
+#include "source/common/http/http1/header_scanner.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+constexpr char kValidHttpTokenCharacters[] =
+    "!#$%&'*+-.0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ^_`abcdefghijklmnopqrstuvwxyz|~";
+
+std::vector<const HeaderScanner*> availableScanners() {
+  std::vector<const HeaderScanner*> scanners{&HeaderScanner::scalar(),
+                                             &HeaderScanner::vectorized()};
+  if (HeaderScanner::sse42() != nullptr) {
+    scanners.push_back(HeaderScanner::sse42());
+  }
+  if (HeaderScanner::avx2() != nullptr) {
+    scanners.push_back(HeaderScanner::avx2());
+  }
+  return scanners;
+}
+
+TEST(HeaderScannerTest, ScalarTokenCharacters) {
+  const HeaderScanner& scanner = HeaderScanner::scalar();
+  EXPECT_TRUE(scanner.isValidToken(""));
+  EXPECT_TRUE(scanner.isValidToken(kValidHttpTokenCharacters));
+  EXPECT_FALSE(scanner.isValidToken("x-header:"));
+  EXPECT_FALSE(scanner.isValidToken("x header"));
+  EXPECT_FALSE(scanner.isValidToken("\x80"));
+  EXPECT_TRUE(scanner.containsCrOrLf("a\r"));
+  EXPECT_TRUE(scanner.containsCrOrLf("\na"));
+  EXPECT_FALSE(scanner.containsCrOrLf("value"));
+  EXPECT_FALSE(scanner.containsCrOrLf(""));
+}
+
+// Every implementation must agree with the scalar one for each byte value at each position of
+// inputs long enough to exercise the vector loops and the scalar tails.
+TEST(HeaderScannerTest, ImplementationsMatchScalar) {
+  const HeaderScanner& scalar = HeaderScanner::scalar();
+  for (const HeaderScanner* scanner : availableScanners()) {
+    SCOPED_TRACE(scanner->name());
+    for (size_t length = 1; length <= 70; ++length) {
+      std::string input(length, 'a');
+      for (size_t position = 0; position < length; ++position) {
+        for (int c = 0; c < 256; ++c) {
+          input[position] = static_cast<char>(c);
+          ASSERT_EQ(scalar.isValidToken(input), scanner->isValidToken(input))
+              << "length " << length << " position " << position << " byte " << c;
+          ASSERT_EQ(scalar.containsCrOrLf(input), scanner->containsCrOrLf(input))
+              << "length " << length << " position " << position << " byte " << c;
+        }
+        input[position] = 'a';
+      }
+    }
+  }
+}
+
+TEST(HeaderScannerTest, LongTokens) {
+  std::string token;
+  for (int i = 0; i < 8; ++i) {
+    token.append(kValidHttpTokenCharacters);
+  }
+  for (const HeaderScanner* scanner : availableScanners()) {
+    SCOPED_TRACE(scanner->name());
+    EXPECT_TRUE(scanner->isValidToken(token));
+    EXPECT_FALSE(scanner->containsCrOrLf(token));
+    EXPECT_FALSE(scanner->isValidToken(token + ":"));
+    EXPECT_TRUE(scanner->containsCrOrLf(token + "\r\n"));
+  }
+}
+
+} // namespace
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
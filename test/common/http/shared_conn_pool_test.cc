@@ -0,0 +1,348 @@
+#include <memory>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/http/shared_conn_pool.h"
+
+#include "test/common/http/common.h"
+#include "test/mocks/buffer/mocks.h"
+#include "test/mocks/common.h"
+#include "test/mocks/http/conn_pool.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/http/stream_encoder.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/mocks/upstream/host.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+// Runs both sides of the pool on the test thread, one dispatcher at a time, so that each side only
+// sees what the other one posted.
+class SharedConnPoolTest : public testing::Test {
+protected:
+  SharedConnPoolTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("borrower")),
+        owner_dispatcher_(api_->allocateDispatcher("owner")),
+        host_(std::make_shared<NiceMock<Upstream::MockHost>>()) {
+    ON_CALL(owner_pool_, newStream(_, _, _))
+        .WillByDefault(Invoke([this](ResponseDecoder& decoder, ConnectionPool::Callbacks& callbacks,
+                                     const ConnectionPool::Instance::StreamOptions&) {
+          owner_decoder_ = &decoder;
+          owner_callbacks_ = &callbacks;
+          return &owner_handle_;
+        }));
+    ON_CALL(encoder_.stream_, bufferLimit()).WillByDefault(Return(16));
+  }
+
+  void initialize(uint32_t max_pending_handoffs = 1024) {
+    pool_ = std::make_unique<SharedConnPool>(
+        *dispatcher_, *owner_dispatcher_,
+        [this]() -> ConnectionPool::Instance* { return owner_has_pool_ ? &owner_pool_ : nullptr; },
+        [this]() -> ConnectionPool::InstancePtr {
+          auto pool = std::make_unique<NiceMock<ConnectionPool::MockInstance>>();
+          ON_CALL(*pool, isIdle()).WillByDefault(Return(true));
+          ON_CALL(*pool, newStream(_, _, _))
+              .WillByDefault(Invoke([this](ResponseDecoder& decoder,
+                                           ConnectionPool::Callbacks& callbacks,
+                                           const ConnectionPool::Instance::StreamOptions&) {
+                local_decoder_ = &decoder;
+                local_callbacks_ = &callbacks;
+                return &local_handle_;
+              }));
+          local_pool_ = pool.get();
+          return pool;
+        },
+        host_, max_pending_handoffs);
+  }
+
+  void runOwner() { owner_dispatcher_->run(Event::Dispatcher::RunType::NonBlock); }
+  void runBorrower() { dispatcher_->run(Event::Dispatcher::RunType::NonBlock); }
+
+  // Hands a stream off and makes it ready on both sides.
+  RequestEncoder& readyStream() {
+    EXPECT_NE(nullptr, pool_->newStream(decoder_, callbacks_, {false, false}));
+    runOwner();
+    EXPECT_NE(nullptr, owner_callbacks_);
+    NiceMock<StreamInfo::MockStreamInfo> info;
+    owner_callbacks_->onPoolReady(encoder_, host_, info, Protocol::Http2);
+    EXPECT_CALL(callbacks_.pool_ready_, ready());
+    runBorrower();
+    return *callbacks_.outer_encoder_;
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  Event::DispatcherPtr owner_dispatcher_;
+  std::shared_ptr<NiceMock<Upstream::MockHost>> host_;
+  NiceMock<ConnectionPool::MockInstance> owner_pool_;
+  NiceMock<Envoy::ConnectionPool::MockCancellable> owner_handle_;
+  NiceMock<MockRequestEncoder> encoder_;
+  ResponseDecoder* owner_decoder_{};
+  ConnectionPool::Callbacks* owner_callbacks_{};
+  bool owner_has_pool_{true};
+  NiceMock<ConnectionPool::MockInstance>* local_pool_{};
+  NiceMock<Envoy::ConnectionPool::MockCancellable> local_handle_;
+  ResponseDecoder* local_decoder_{};
+  ConnectionPool::Callbacks* local_callbacks_{};
+  NiceMock<MockResponseDecoder> decoder_;
+  ConnPoolCallbacks callbacks_;
+  std::unique_ptr<SharedConnPool> pool_;
+};
+
+TEST_F(SharedConnPoolTest, RequestAndResponse) {
+  initialize();
+  RequestEncoder& request_encoder = readyStream();
+  EXPECT_EQ(1U, host_->cluster_.traffic_stats_->upstream_rq_shared_handoff_.value());
+  EXPECT_FALSE(pool_->isIdle());
+
+  TestRequestHeaderMapImpl headers{{":method", "GET"}, {":path", "/"}, {":authority", "host"}};
+  EXPECT_TRUE(request_encoder.encodeHeaders(headers, true).ok());
+  EXPECT_CALL(encoder_, encodeHeaders(HeaderMapEqualRef(&headers), true));
+  runOwner();
+
+  owner_decoder_->decodeHeaders(
+      ResponseHeaderMapPtr{new TestResponseHeaderMapImpl{{":status", "200"}}}, false);
+  Buffer::OwnedImpl body("response");
+  owner_decoder_->decodeData(body, true);
+  EXPECT_EQ(0, body.length());
+
+  EXPECT_CALL(decoder_, decodeHeaders_(_, false));
+  EXPECT_CALL(decoder_, decodeData(BufferString("response"), true));
+  runBorrower();
+  EXPECT_TRUE(pool_->isIdle());
+}
+
+// The headers that the codec of the owner would reject fail on the borrower.
+TEST_F(SharedConnPoolTest, InvalidHeaders) {
+  initialize();
+  RequestEncoder& request_encoder = readyStream();
+
+  TestRequestHeaderMapImpl headers{{":method", "GET"}};
+  EXPECT_FALSE(request_encoder.encodeHeaders(headers, true).ok());
+  EXPECT_CALL(encoder_, encodeHeaders(_, _)).Times(0);
+  runOwner();
+  request_encoder.getStream().resetStream(StreamResetReason::LocalReset);
+}
+
+// The headers that the codec of the owner fails to encode reset the stream on both sides.
+TEST_F(SharedConnPoolTest, EncodeHeadersFailure) {
+  initialize();
+  RequestEncoder& request_encoder = readyStream();
+  NiceMock<MockStreamCallbacks> stream_callbacks;
+  request_encoder.getStream().addCallbacks(stream_callbacks);
+
+  TestRequestHeaderMapImpl headers{{":method", "GET"}, {":path", "/"}, {":authority", "host"}};
+  EXPECT_TRUE(request_encoder.encodeHeaders(headers, true).ok());
+  EXPECT_CALL(encoder_, encodeHeaders(_, true))
+      .WillOnce(Return(absl::InvalidArgumentError("rejected")));
+  EXPECT_CALL(encoder_.stream_, resetStream(StreamResetReason::LocalReset));
+  runOwner();
+
+  EXPECT_CALL(stream_callbacks, onResetStream(StreamResetReason::LocalReset, "rejected"));
+  runBorrower();
+  EXPECT_TRUE(pool_->isIdle());
+}
+
+TEST_F(SharedConnPoolTest, PendingHandoffOverflow) {
+  initialize(1);
+  EXPECT_NE(nullptr, pool_->newStream(decoder_, callbacks_, {false, false}));
+
+  ConnPoolCallbacks callbacks2;
+  EXPECT_CALL(callbacks2.pool_failure_, ready());
+  EXPECT_EQ(nullptr, pool_->newStream(decoder_, callbacks2, {false, false}));
+  EXPECT_EQ(ConnectionPool::PoolFailureReason::Overflow, callbacks2.reason_);
+  EXPECT_EQ(1U, host_->cluster_.traffic_stats_->upstream_rq_shared_handoff_overflow_.value());
+}
+
+// The streams that the owner has no pool for, e.g. while it has yet to receive the cluster, run on
+// a local pool instead.
+TEST_F(SharedConnPoolTest, NoPoolOnOwner) {
+  initialize();
+  owner_has_pool_ = false;
+  EXPECT_NE(nullptr, pool_->newStream(decoder_, callbacks_, {false, false}));
+  runOwner();
+  runBorrower();
+  ASSERT_NE(nullptr, local_pool_);
+  EXPECT_EQ(&decoder_, local_decoder_);
+  EXPECT_FALSE(pool_->isIdle());
+
+  NiceMock<MockRequestEncoder> local_encoder;
+  NiceMock<StreamInfo::MockStreamInfo> info;
+  EXPECT_CALL(callbacks_.pool_ready_, ready());
+  local_callbacks_->onPoolReady(local_encoder, host_, info, Protocol::Http2);
+  EXPECT_EQ(&local_encoder, callbacks_.outer_encoder_);
+  EXPECT_TRUE(pool_->isIdle());
+
+  // The local pool is kept for the next stream.
+  EXPECT_NE(nullptr, pool_->newStream(decoder_, callbacks_, {false, false}));
+  runOwner();
+  EXPECT_CALL(*local_pool_, newStream(_, _, _));
+  runBorrower();
+  EXPECT_CALL(callbacks_.pool_failure_, ready());
+  local_callbacks_->onPoolFailure(ConnectionPool::PoolFailureReason::RemoteConnectionFailure,
+                                  "failed", host_);
+  EXPECT_EQ(ConnectionPool::PoolFailureReason::RemoteConnectionFailure, callbacks_.reason_);
+  EXPECT_TRUE(pool_->isIdle());
+}
+
+TEST_F(SharedConnPoolTest, CancelStreamOnLocalPool) {
+  initialize();
+  owner_has_pool_ = false;
+  ConnectionPool::Cancellable* handle = pool_->newStream(decoder_, callbacks_, {false, false});
+  runOwner();
+  runBorrower();
+  EXPECT_CALL(local_handle_, cancel(Envoy::ConnectionPool::CancelPolicy::Default));
+  handle->cancel(Envoy::ConnectionPool::CancelPolicy::Default);
+  EXPECT_TRUE(pool_->isIdle());
+}
+
+// A draining pool fails the streams that the owner has no pool for instead of creating a local one.
+TEST_F(SharedConnPoolTest, NoPoolOnOwnerWhileDraining) {
+  initialize();
+  owner_has_pool_ = false;
+  EXPECT_NE(nullptr, pool_->newStream(decoder_, callbacks_, {false, false}));
+  pool_->drainConnections(Envoy::ConnectionPool::DrainBehavior::DrainAndDelete);
+  runOwner();
+  EXPECT_CALL(callbacks_.pool_failure_, ready());
+  runBorrower();
+  EXPECT_EQ(nullptr, local_pool_);
+  EXPECT_EQ(ConnectionPool::PoolFailureReason::LocalConnectionFailure, callbacks_.reason_);
+  EXPECT_TRUE(pool_->isIdle());
+}
+
+// A stream cancelled on the borrower is cancelled on the owner once the owner picks it up.
+TEST_F(SharedConnPoolTest, CancelPendingStream) {
+  initialize();
+  ConnectionPool::Cancellable* handle = pool_->newStream(decoder_, callbacks_, {false, false});
+  handle->cancel(Envoy::ConnectionPool::CancelPolicy::Default);
+  EXPECT_TRUE(pool_->isIdle());
+
+  EXPECT_CALL(owner_handle_, cancel(Envoy::ConnectionPool::CancelPolicy::Default));
+  runOwner();
+  EXPECT_CALL(callbacks_.pool_ready_, ready()).Times(0);
+  runBorrower();
+}
+
+TEST_F(SharedConnPoolTest, OwnerReset) {
+  initialize();
+  RequestEncoder& request_encoder = readyStream();
+  NiceMock<MockStreamCallbacks> stream_callbacks;
+  request_encoder.getStream().addCallbacks(stream_callbacks);
+
+  encoder_.stream_.resetStream(StreamResetReason::RemoteReset);
+  EXPECT_CALL(stream_callbacks, onResetStream(StreamResetReason::RemoteReset, _));
+  runBorrower();
+  EXPECT_TRUE(pool_->isIdle());
+}
+
+TEST_F(SharedConnPoolTest, BorrowerReset) {
+  initialize();
+  RequestEncoder& request_encoder = readyStream();
+  request_encoder.getStream().resetStream(StreamResetReason::LocalReset);
+  EXPECT_TRUE(pool_->isIdle());
+
+  EXPECT_CALL(encoder_.stream_, resetStream(StreamResetReason::LocalReset));
+  runOwner();
+}
+
+// The request data that the owner has yet to encode counts against the buffer limit of the
+// owner stream.
+TEST_F(SharedConnPoolTest, RequestFlowControl) {
+  initialize();
+  RequestEncoder& request_encoder = readyStream();
+  NiceMock<MockStreamCallbacks> stream_callbacks;
+  request_encoder.getStream().addCallbacks(stream_callbacks);
+
+  TestRequestHeaderMapImpl headers{{":method", "POST"}, {":path", "/"}, {":authority", "host"}};
+  EXPECT_TRUE(request_encoder.encodeHeaders(headers, false).ok());
+  Buffer::OwnedImpl data(std::string(32, 'a'));
+  EXPECT_CALL(stream_callbacks, onAboveWriteBufferHighWatermark());
+  request_encoder.encodeData(data, false);
+
+  EXPECT_CALL(encoder_, encodeData(_, false));
+  runOwner();
+  EXPECT_CALL(stream_callbacks, onBelowWriteBufferLowWatermark());
+  runBorrower();
+  request_encoder.getStream().resetStream(StreamResetReason::LocalReset);
+}
+
+// The owner stops reading the response while the borrower has yet to decode too much of it.
+TEST_F(SharedConnPoolTest, ResponseFlowControl) {
+  initialize();
+  RequestEncoder& request_encoder = readyStream();
+
+  owner_decoder_->decodeHeaders(
+      ResponseHeaderMapPtr{new TestResponseHeaderMapImpl{{":status", "200"}}}, false);
+  Buffer::OwnedImpl data(std::string(32, 'a'));
+  EXPECT_CALL(encoder_.stream_, readDisable(true));
+  owner_decoder_->decodeData(data, false);
+
+  EXPECT_CALL(decoder_, decodeData(_, false));
+  runBorrower();
+  EXPECT_CALL(encoder_.stream_, readDisable(false));
+  runOwner();
+  request_encoder.getStream().resetStream(StreamResetReason::LocalReset);
+}
+
+// The streams that are still running when the pool goes away are reset on both sides.
+TEST_F(SharedConnPoolTest, DestroyWithActiveStream) {
+  initialize();
+  RequestEncoder& request_encoder = readyStream();
+  NiceMock<MockStreamCallbacks> stream_callbacks;
+  request_encoder.getStream().addCallbacks(stream_callbacks);
+
+  EXPECT_CALL(stream_callbacks, onResetStream(StreamResetReason::ConnectionTermination, _));
+  pool_.reset();
+  EXPECT_CALL(encoder_.stream_, resetStream(StreamResetReason::LocalReset));
+  runOwner();
+  runBorrower();
+}
+
+TEST_F(SharedConnPoolTest, DrainAndDeleteWithLocalPool) {
+  initialize();
+  ReadyWatcher idle;
+  pool_->addIdleCallback([&idle]() { idle.ready(); });
+  owner_has_pool_ = false;
+  EXPECT_NE(nullptr, pool_->newStream(decoder_, callbacks_, {false, false}));
+  runOwner();
+  runBorrower();
+  NiceMock<MockRequestEncoder> local_encoder;
+  NiceMock<StreamInfo::MockStreamInfo> info;
+  local_callbacks_->onPoolReady(local_encoder, host_, info, Protocol::Http2);
+
+  // The shared pool is idle once the local one is.
+  EXPECT_CALL(*local_pool_, isIdle()).WillRepeatedly(Return(false));
+  EXPECT_CALL(*local_pool_,
+              drainConnections(Envoy::ConnectionPool::DrainBehavior::DrainAndDelete));
+  EXPECT_CALL(idle, ready()).Times(0);
+  pool_->drainConnections(Envoy::ConnectionPool::DrainBehavior::DrainAndDelete);
+  testing::Mock::VerifyAndClearExpectations(&idle);
+
+  EXPECT_CALL(*local_pool_, isIdle()).WillRepeatedly(Return(true));
+  EXPECT_CALL(idle, ready());
+  local_pool_->idle_cb_();
+}
+
+TEST_F(SharedConnPoolTest, DrainAndDelete) {
+  initialize();
+  ReadyWatcher idle;
+  pool_->addIdleCallback([&idle]() { idle.ready(); });
+  RequestEncoder& request_encoder = readyStream();
+
+  pool_->drainConnections(Envoy::ConnectionPool::DrainBehavior::DrainAndDelete);
+  EXPECT_CALL(idle, ready());
+  request_encoder.getStream().resetStream(StreamResetReason::LocalReset);
+}
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
@@ -31,7 +31,7 @@ class IoUringImplTest : public ::testing::Test {
 public:
   IoUringImplTest() : api_(Api::createApiForTest()), should_skip_(!isIoUringSupported()) {
     if (!should_skip_) {
-      io_uring_ = std::make_unique<IoUringImpl>(2, false, false, 0);
+      io_uring_ = std::make_unique<IoUringImpl>(2, false, false, false, 0);
     }
   }
 
@@ -453,7 +453,7 @@ TEST_F(IoUringImplTest, MultishotDisabledHasNoBufferPool) {
 }
 
 TEST_F(IoUringImplTest, MultishotEnabledExposesBufferPool) {
-  auto io_uring = std::make_unique<IoUringImpl>(8, false, true, 4096);
+  auto io_uring = std::make_unique<IoUringImpl>(8, false, false, true, 4096);
   if (!io_uring->isMultishotEnabled()) {
     GTEST_SKIP() << "provided buffer rings not supported on this kernel";
   }
@@ -463,7 +463,7 @@ TEST_F(IoUringImplTest, MultishotEnabledExposesBufferPool) {
 }
 
 TEST_F(IoUringImplTest, MultishotRecvDeliversDataInProvidedBuffer) {
-  auto io_uring = std::make_unique<IoUringImpl>(8, false, true, 4096);
+  auto io_uring = std::make_unique<IoUringImpl>(8, false, false, true, 4096);
   if (!io_uring->isMultishotEnabled()) {
     GTEST_SKIP() << "provided buffer rings not supported on this kernel";
   }
@@ -517,8 +517,62 @@ TEST_F(IoUringImplTest, MultishotRecvDeliversDataInProvidedBuffer) {
   ::close(fds[1]);
 }
 
+TEST_F(IoUringImplTest, ProvidedBufferRecvDeliversDataWithoutMultishot) {
+  auto io_uring = std::make_unique<IoUringImpl>(8, false, true, false, 4096);
+  if (io_uring->bufferPool() == nullptr) {
+    GTEST_SKIP() << "provided buffer rings not supported on this kernel";
+  }
+  EXPECT_FALSE(io_uring->isMultishotEnabled());
+  IoUringBufferPoolSharedPtr pool = io_uring->bufferPool();
+
+  os_fd_t fds[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+  auto dispatcher = api_->allocateDispatcher("test_thread");
+  os_fd_t event_fd = io_uring->registerEventfd();
+  const Event::FileTriggerType trigger = Event::PlatformDefaultTriggerType;
+
+  int32_t completions_nr = 0;
+  int32_t result = 0;
+  int32_t buffer_id = -1;
+  bool more = true;
+  auto file_event = dispatcher->createFileEvent(
+      event_fd,
+      [&](uint32_t) {
+        io_uring->forEveryCompletion([&](Request* req, int32_t res, bool) {
+          completions_nr++;
+          result = res;
+          buffer_id = req->bufferId();
+          more = req->moreCompletions();
+        });
+        return absl::OkStatus();
+      },
+      trigger, Event::FileReadyType::Read);
+
+  MockIoUringSocket socket;
+  Request req(Request::RequestType::Read, socket);
+  EXPECT_EQ(io_uring->prepareReadProvidedBuffer(fds[0], &req), IoUringResult::Ok);
+  EXPECT_EQ(io_uring->submit(), IoUringResult::Ok);
+
+  const std::string data = "hello provided buffer";
+  ASSERT_EQ(::write(fds[1], data.data(), data.size()), static_cast<ssize_t>(data.size()));
+
+  waitForCondition(*dispatcher, [&completions_nr]() { return completions_nr == 1; });
+
+  EXPECT_EQ(result, static_cast<int32_t>(data.size()));
+  ASSERT_GE(buffer_id, 0);
+  // A single read completes once.
+  EXPECT_FALSE(more);
+  EXPECT_EQ(0, memcmp(pool->getBuffer(buffer_id), data.data(), data.size()));
+  pool->releaseBuffer(pool->getBuffer(buffer_id));
+
+  io_uring->unregisterEventfd();
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
 TEST_F(IoUringImplTest, MultishotReleaseBufferRejectsOutOfBoundsPointer) {
-  auto io_uring = std::make_unique<IoUringImpl>(8, false, true, 4096);
+  auto io_uring = std::make_unique<IoUringImpl>(8, false, false, true, 4096);
   if (!io_uring->isMultishotEnabled()) {
     GTEST_SKIP() << "provided buffer rings not supported on this kernel";
   }
@@ -29,8 +29,8 @@ public:
 };
 
 TEST_F(IoUringWorkerFactoryImplTest, Basic) {
-  IoUringWorkerFactoryImpl factory(2, false, false, 8192, 1000, 131072, 16384,
-                                   context_.threadLocal());
+  IoUringWorkerFactoryImpl factory(2, false, false, false, 8192, 1000, 131072, 16384, 0,
+                                   context_.scope(), context_.threadLocal());
   EXPECT_TRUE(factory.currentThreadRegistered());
   auto dispatcher = api_->allocateDispatcher("test_thread");
   factory.onWorkerThreadInitialized();
@@ -5,6 +5,7 @@
 #include "source/common/api/os_sys_calls_impl.h"
 #include "source/common/io/io_uring_worker_impl.h"
 #include "source/common/network/address_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
 
 #include "test/test_common/test_time.h"
 #include "test/test_common/utility.h"
@@ -86,10 +87,16 @@ public:
   bool is_shutdown_injected_completion_{false};
 };
 
-class IoUringWorkerTestImpl : public IoUringWorkerImpl {
+// Holds the stats store ahead of the worker base so that it outlives the worker.
+struct IoUringWorkerTestStats {
+  Stats::IsolatedStoreImpl store_;
+};
+
+class IoUringWorkerTestImpl : private IoUringWorkerTestStats, public IoUringWorkerImpl {
 public:
   IoUringWorkerTestImpl(IoUringPtr io_uring_instance, Event::Dispatcher& dispatcher)
-      : IoUringWorkerImpl(std::move(io_uring_instance), 8192, 1000, 131072, 16384, dispatcher) {}
+      : IoUringWorkerImpl(std::move(io_uring_instance), 8192, 1000, 131072, 16384, 0,
+                          generateIoUringWorkerStats(*store_.rootScope()), dispatcher) {}
 
   IoUringSocket& addTestSocket(os_fd_t fd) {
     return addSocket(std::make_unique<IoUringSocketTestImpl>(fd, *this));
@@ -112,14 +119,14 @@ protected:
     api_ = Api::createApiForTest(time_system_);
     dispatcher_ = api_->allocateDispatcher("test_thread");
     io_uring_worker_ = std::make_unique<IoUringWorkerTestImpl>(
-        std::make_unique<IoUringImpl>(20, false, false, 0), *dispatcher_);
+        std::make_unique<IoUringImpl>(20, false, false, false, 0), *dispatcher_);
   }
 
   void initializeMultishot() {
     api_ = Api::createApiForTest(time_system_);
     dispatcher_ = api_->allocateDispatcher("test_thread");
     io_uring_worker_ = std::make_unique<IoUringWorkerTestImpl>(
-        std::make_unique<IoUringImpl>(20, false, true, 65536), *dispatcher_);
+        std::make_unique<IoUringImpl>(20, false, false, true, 65536), *dispatcher_);
   }
 
   void createListenerAndConnectedSocketPair() {
@@ -6,6 +6,7 @@
 
 #include "source/common/io/io_uring_worker_impl.h"
 #include "source/common/network/address_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
 
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/io/mocks.h"
@@ -38,10 +39,18 @@ public:
   void shutdown(int) override {}
 };
 
-class IoUringWorkerTestImpl : public IoUringWorkerImpl {
+// Holds the stats store ahead of the worker base so that it outlives the worker.
+struct IoUringWorkerTestStats {
+  Stats::IsolatedStoreImpl store_;
+};
+
+class IoUringWorkerTestImpl : private IoUringWorkerTestStats, public IoUringWorkerImpl {
 public:
-  IoUringWorkerTestImpl(IoUringPtr io_uring_instance, Event::Dispatcher& dispatcher)
-      : IoUringWorkerImpl(std::move(io_uring_instance), 8192, 1000, 131072, 16384, dispatcher) {}
+  IoUringWorkerTestImpl(IoUringPtr io_uring_instance, Event::Dispatcher& dispatcher,
+                        uint32_t zero_copy_send_threshold = 0)
+      : IoUringWorkerImpl(std::move(io_uring_instance), 8192, 1000, 131072, 16384,
+                          zero_copy_send_threshold,
+                          generateIoUringWorkerStats(*store_.rootScope()), dispatcher) {}
 
   IoUringSocket& addTestSocket(os_fd_t fd) {
     return addSocket(std::make_unique<IoUringSocketTestImpl>(fd, *this));
@@ -851,6 +860,218 @@ TEST(IoUringWorkerImplTest, WriteFailureClearsBackpressure) {
   delete write_req2;
 }
 
+// Writes at or above the threshold are sent with zero-copy. Written slices stay allocated until the
+// kernel notifies that it is done with them, including a partially written slice that a following
+// writev picks up from where the zero-copy send stopped.
+TEST(IoUringWorkerImplTest, ServerSocketZeroCopyWriteKeepsSlicesUntilNotification) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  Event::FileReadyCb file_event_callback;
+
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(mock_io_uring, isSendZeroCopySupported()).WillRepeatedly(Return(true));
+  EXPECT_CALL(dispatcher,
+              createFileEvent_(_, _, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read))
+      .WillOnce(
+          DoAll(SaveArg<1>(&file_event_callback), ReturnNew<NiceMock<Event::MockFileEvent>>()));
+  IoUringWorkerTestImpl worker(std::move(io_uring_instance), dispatcher, 64);
+
+  IoUringServerSocket socket(
+      0, worker, [](uint32_t) { return absl::OkStatus(); }, 0, 131072, 16384, false);
+
+  std::string first(100, 'a');
+  std::string second(100, 'b');
+  bool first_released = false;
+  bool second_released = false;
+  Buffer::BufferFragmentImpl first_fragment(
+      first.data(), first.size(),
+      [&first_released](const void*, size_t, const Buffer::BufferFragmentImpl*) {
+        first_released = true;
+      });
+  Buffer::BufferFragmentImpl second_fragment(
+      second.data(), second.size(),
+      [&second_released](const void*, size_t, const Buffer::BufferFragmentImpl*) {
+        second_released = true;
+      });
+
+  Request* zero_copy_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareSendmsgZeroCopy(0, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&zero_copy_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  Buffer::OwnedImpl buf;
+  buf.addBufferFragment(first_fragment);
+  buf.addBufferFragment(second_fragment);
+  socket.write(buf);
+  EXPECT_EQ(1, worker.stats().send_zero_copy_.value());
+
+  // 150 bytes are written. The remaining 50 bytes are below the threshold, so they are written with
+  // writev starting in the middle of the second slice.
+  Request* writev_req = nullptr;
+  const struct iovec* iovecs = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareWritev(0, _, 1, _, _))
+      .WillOnce(DoAll(SaveArg<1>(&iovecs), SaveArg<4>(&writev_req),
+                      Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  zero_copy_req->setMoreCompletions(true);
+  socket.onWrite(zero_copy_req, 150, false);
+  EXPECT_EQ(second.data() + 50, iovecs[0].iov_base);
+  EXPECT_EQ(50, iovecs[0].iov_len);
+  EXPECT_EQ(1, worker.stats().send_copy_.value());
+
+  socket.onWrite(writev_req, 50, false);
+  delete writev_req;
+  EXPECT_FALSE(first_released);
+  EXPECT_FALSE(second_released);
+
+  // The notification releases both slices.
+  EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
+      .WillOnce(Invoke([zero_copy_req](const CompletionCb& cb) {
+        zero_copy_req->setZeroCopyNotification(true);
+        zero_copy_req->setMoreCompletions(false);
+        cb(zero_copy_req, static_cast<int32_t>(IORING_NOTIF_USAGE_ZC_COPIED), false);
+      }));
+  EXPECT_CALL(mock_io_uring, submit());
+  ASSERT_OK(file_event_callback(Event::FileReadyType::Read));
+  EXPECT_TRUE(first_released);
+  EXPECT_TRUE(second_released);
+  EXPECT_EQ(1, worker.stats().send_zero_copy_kernel_copied_.value());
+
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+}
+
+// A socket that rejects zero-copy sends writes the same data with writev and does not try
+// zero-copy again.
+TEST(IoUringWorkerImplTest, ServerSocketZeroCopyUnsupportedFallsBackToWritev) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  Event::FileReadyCb file_event_callback;
+
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(mock_io_uring, isSendZeroCopySupported()).WillRepeatedly(Return(true));
+  EXPECT_CALL(dispatcher,
+              createFileEvent_(_, _, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read))
+      .WillOnce(
+          DoAll(SaveArg<1>(&file_event_callback), ReturnNew<NiceMock<Event::MockFileEvent>>()));
+  IoUringWorkerTestImpl worker(std::move(io_uring_instance), dispatcher, 64);
+
+  IoUringServerSocket socket(
+      0, worker, [](uint32_t) { return absl::OkStatus(); }, 0, 131072, 16384, false);
+
+  Request* zero_copy_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareSendmsgZeroCopy(0, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&zero_copy_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  Buffer::OwnedImpl buf(std::string(100, 'x'));
+  socket.write(buf);
+
+  Request* writev_req = nullptr;
+  const struct iovec* iovecs = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareWritev(0, _, 1, _, _))
+      .WillOnce(DoAll(SaveArg<1>(&iovecs), SaveArg<4>(&writev_req),
+                      Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
+      .WillOnce(Invoke([zero_copy_req](const CompletionCb& cb) {
+        zero_copy_req->setMoreCompletions(false);
+        cb(zero_copy_req, -EOPNOTSUPP, false);
+      }));
+  EXPECT_CALL(mock_io_uring, submit());
+  ASSERT_OK(file_event_callback(Event::FileReadyType::Read));
+  EXPECT_EQ(100, iovecs[0].iov_len);
+  EXPECT_EQ(1, worker.stats().send_zero_copy_unsupported_.value());
+
+  // Later large writes use writev as well.
+  Request* writev_req2 = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareWritev(0, _, _, _, _))
+      .WillOnce(DoAll(SaveArg<4>(&writev_req2), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  socket.onWrite(writev_req, 100, false);
+  Buffer::OwnedImpl buf2(std::string(100, 'y'));
+  socket.write(buf2);
+  EXPECT_EQ(1, worker.stats().send_zero_copy_.value());
+  EXPECT_EQ(2, worker.stats().send_copy_.value());
+
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+  delete writev_req;
+  delete writev_req2;
+}
+
+// Zero-copy sends are not used when the kernel does not support them.
+TEST(IoUringWorkerImplTest, ZeroCopySendDisabledWhenUnsupportedByKernel) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(dispatcher,
+              createFileEvent_(_, _, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read))
+      .WillOnce(ReturnNew<NiceMock<Event::MockFileEvent>>());
+  IoUringWorkerTestImpl worker(std::move(io_uring_instance), dispatcher, 64);
+  EXPECT_EQ(0, worker.zeroCopySendThreshold());
+
+  IoUringServerSocket socket(
+      0, worker, [](uint32_t) { return absl::OkStatus(); }, 0, 131072, 16384, false);
+  Request* writev_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareSendmsgZeroCopy(_, _, _)).Times(0);
+  EXPECT_CALL(mock_io_uring, prepareWritev(0, _, _, _, _))
+      .WillOnce(DoAll(SaveArg<4>(&writev_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  Buffer::OwnedImpl buf(std::string(100, 'x'));
+  socket.write(buf);
+
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+  delete writev_req;
+}
+
+// Zero-copy requests still waiting for their notification are released with the worker.
+TEST(IoUringWorkerImplTest, WorkerDestructionReleasesPendingZeroCopyWrites) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  Event::FileReadyCb file_event_callback;
+
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(mock_io_uring, isSendZeroCopySupported()).WillRepeatedly(Return(true));
+  EXPECT_CALL(dispatcher,
+              createFileEvent_(_, _, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read))
+      .WillOnce(
+          DoAll(SaveArg<1>(&file_event_callback), ReturnNew<NiceMock<Event::MockFileEvent>>()));
+  auto worker = std::make_unique<IoUringWorkerTestImpl>(std::move(io_uring_instance), dispatcher,
+                                                        64);
+
+  bool released = false;
+  std::string data(100, 'x');
+  Buffer::BufferFragmentImpl fragment(
+      data.data(), data.size(),
+      [&released](const void*, size_t, const Buffer::BufferFragmentImpl*) { released = true; });
+  {
+    IoUringServerSocket socket(
+        0, *worker, [](uint32_t) { return absl::OkStatus(); }, 0, 131072, 16384, false);
+    Request* zero_copy_req = nullptr;
+    EXPECT_CALL(mock_io_uring, prepareSendmsgZeroCopy(0, _, _))
+        .WillOnce(DoAll(SaveArg<2>(&zero_copy_req), Return<IoUringResult>(IoUringResult::Ok)));
+    EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+    Buffer::OwnedImpl buf;
+    buf.addBufferFragment(fragment);
+    socket.write(buf);
+
+    // The send completes, while the notification is still outstanding.
+    EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
+        .WillOnce(Invoke([zero_copy_req](const CompletionCb& cb) {
+          zero_copy_req->setMoreCompletions(true);
+          cb(zero_copy_req, 100, false);
+        }));
+    EXPECT_CALL(mock_io_uring, submit());
+    ASSERT_OK(file_event_callback(Event::FileReadyType::Read));
+  }
+  EXPECT_FALSE(released);
+
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+  worker.reset();
+  EXPECT_TRUE(released);
+}
+
 TEST(IoUringWorkerImplTest, NoEnableReadOnConnectError) {
   Event::MockDispatcher dispatcher;
   IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
@@ -912,7 +1133,7 @@ TEST(IoUringWorkerImplTest, DoubleFreeOnSocketCloseDuringInjectedCompletion) {
   }
 
   Event::MockDispatcher dispatcher;
-  auto io_uring = std::make_unique<IoUringImpl>(64, false, false, 0);
+  auto io_uring = std::make_unique<IoUringImpl>(64, false, false, false, 0);
   Event::FileReadyCb file_event_callback;
   EXPECT_CALL(dispatcher, createFileEvent_(_, _, _, _))
       .WillOnce(testing::DoAll(testing::SaveArg<1>(&file_event_callback),
@@ -1048,7 +1269,7 @@ TEST(IoUringWorkerImplTest, ServerSocketMultishotReadInvalidBufferIdDropsData) {
   // The completion reports data with an absent buffer id, which is dropped and recycles no buffer.
   read_req->setBufferId(-1);
   read_req->setMoreCompletions(true);
-  EXPECT_ENVOY_BUG(socket.onRead(read_req, 5, false), "invalid multishot buffer id");
+  EXPECT_ENVOY_BUG(socket.onRead(read_req, 5, false), "invalid provided buffer id");
   EXPECT_EQ(0, socket.getReadBuffer().length());
   EXPECT_TRUE(buffer_pool->released_buffers_.empty());
 
@@ -1104,6 +1325,80 @@ TEST(IoUringWorkerImplTest, ServerSocketMultishotEnobufsFallback) {
   delete rearm_req;
 }
 
+// Without `multishot`, a provided buffer read takes a buffer from the pool only when data arrives
+// and is re-submitted after each completion. A pool exhaustion falls back to a single readv.
+TEST(IoUringWorkerImplTest, ServerSocketProvidedBufferRead) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  auto buffer_pool = std::make_shared<FakeIoUringBufferPool>(16, 4);
+  buffer_pool->fill(2, "hello");
+
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(mock_io_uring, isMultishotEnabled()).WillRepeatedly(Return(false));
+  EXPECT_CALL(mock_io_uring, bufferPool()).WillRepeatedly(Return(buffer_pool));
+  EXPECT_CALL(dispatcher, createFileEvent_(_, _, Event::PlatformDefaultTriggerType,
+                                           Event::FileReadyType::Read));
+  IoUringWorkerTestImpl worker(std::move(io_uring_instance), dispatcher);
+
+  IoUringServerSocket* socket_ptr = nullptr;
+  std::string read_data;
+  auto read_cb = [&socket_ptr, &read_data](uint32_t events) -> absl::Status {
+    if (events & Event::FileReadyType::Read) {
+      const ReadParam& param = socket_ptr->getReadParam().ref();
+      if (param.buf_.length() > 0) {
+        read_data.append(param.buf_.toString());
+        param.buf_.drain(param.buf_.length());
+      }
+    }
+    return absl::OkStatus();
+  };
+
+  // Enabling read submits a provided buffer read rather than a readv.
+  Request* read_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareReadProvidedBuffer(_, _))
+      .WillOnce(DoAll(SaveArg<1>(&read_req), Return<IoUringResult>(IoUringResult::Ok)))
+      .RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  IoUringServerSocket socket(0, worker, read_cb, 0, 131072, 16384, false);
+  socket_ptr = &socket;
+  socket.enableRead();
+
+  // The completion delivers data in provided buffer 2, which is recycled once drained, and the
+  // next provided buffer read is submitted.
+  Request* next_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareReadProvidedBuffer(_, _))
+      .WillOnce(DoAll(SaveArg<1>(&next_req), Return<IoUringResult>(IoUringResult::Ok)))
+      .RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  read_req->setBufferId(2);
+  socket.onRead(read_req, 5, false);
+  EXPECT_EQ("hello", read_data);
+  EXPECT_EQ(std::vector<uint32_t>({2}), buffer_pool->released_buffers_);
+
+  // A pool exhaustion falls back to a readv.
+  Request* readv_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareReadv(_, _, _, _, _))
+      .WillOnce(DoAll(SaveArg<4>(&readv_req), Return<IoUringResult>(IoUringResult::Ok)))
+      .RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  socket.onRead(next_req, -ENOBUFS, false);
+
+  // The read after the readv returns to the pool.
+  Request* pool_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareReadProvidedBuffer(_, _))
+      .WillOnce(DoAll(SaveArg<1>(&pool_req), Return<IoUringResult>(IoUringResult::Ok)))
+      .RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  socket.onRead(readv_req, 4, false);
+
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+  delete read_req;
+  delete next_req;
+  delete readv_req;
+  delete pool_req;
+}
+
 // The readv path grows the next read size when a read fills the buffer, caps the growth at the
 // configured multiple and resets to the base size when a read does not fill the buffer.
 TEST(IoUringWorkerImplTest, ServerSocketAdaptiveReadSize) {
@@ -1164,7 +1459,8 @@ TEST(IoUringWorkerImplTest, ServerSocketAdaptiveReadSize) {
 }
 
 // A kernel that registers the buffer ring but rejects `multishot` recv with the given error
-// disables `multishot` for the socket, which then uses readv for every read.
+// disables `multishot` for the socket, which then uses provided buffer reads. A kernel that rejects
+// those too leaves the socket using readv for every read.
 void multishotDisabledOnUnsupportedKernel(int32_t reject_error) {
   Event::MockDispatcher dispatcher;
   IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
@@ -1188,16 +1484,24 @@ void multishotDisabledOnUnsupportedKernel(int32_t reject_error) {
       0, worker, [](uint32_t) { return absl::OkStatus(); }, 0, 131072, 16384, false);
   socket.enableRead();
 
-  // The kernel rejects `multishot` recv, so the next read falls back to a readv.
+  // The kernel rejects `multishot` recv, so the next read is a provided buffer read.
+  Request* provided_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareReadProvidedBuffer(_, _))
+      .WillOnce(DoAll(SaveArg<1>(&provided_req), Return<IoUringResult>(IoUringResult::Ok)))
+      .RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  multishot_req->setMoreCompletions(false);
+  socket.onRead(multishot_req, reject_error, false);
+
+  // The kernel rejects the provided buffer read too, so the next read falls back to a readv.
   Request* readv_req = nullptr;
   EXPECT_CALL(mock_io_uring, prepareReadv(_, _, _, _, _))
       .WillOnce(DoAll(SaveArg<4>(&readv_req), Return<IoUringResult>(IoUringResult::Ok)))
       .RetiresOnSaturation();
   EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
-  multishot_req->setMoreCompletions(false);
-  socket.onRead(multishot_req, reject_error, false);
+  socket.onRead(provided_req, reject_error, false);
 
-  // A successful readv does not re-arm `multishot` since it is permanently disabled.
+  // A successful readv does not return to the pool since both reads are permanently disabled.
   Request* next_readv_req = nullptr;
   EXPECT_CALL(mock_io_uring, prepareReadv(_, _, _, _, _))
       .WillOnce(DoAll(SaveArg<4>(&next_readv_req), Return<IoUringResult>(IoUringResult::Ok)))
@@ -1207,6 +1511,7 @@ void multishotDisabledOnUnsupportedKernel(int32_t reject_error) {
 
   EXPECT_CALL(dispatcher, clearDeferredDeleteList());
   delete multishot_req;
+  delete provided_req;
   delete readv_req;
   delete next_readv_req;
 }
@@ -367,6 +367,15 @@ TEST_P(ConnectionImplTest, GetCongestionWindow) {
   disconnect(true);
 }
 
+TEST_P(ConnectionImplTest, CanSendFile) {
+  setUpBasicConnection();
+  connect();
+  // Raw buffer sockets hand the file ranges of their buffers to sendfile().
+  EXPECT_TRUE(client_connection_->canSendFile());
+  EXPECT_TRUE(server_connection_->canSendFile());
+  disconnect(true);
+}
+
 TEST_P(ConnectionImplTest, DrainFiresOnDrainOnAllCallbacks) {
   setUpBasicConnection();
   connect();
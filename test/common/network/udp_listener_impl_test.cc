@@ -92,6 +92,86 @@ public:
     ON_CALL(listener_callbacks_, udpPacketWriter()).WillByDefault(ReturnRef(*udp_packet_writer_));
   }
 
+#ifdef UDP_GRO
+  // Fills in the header of a recvmsg() call as the kernel does when GRO coalesced the datagrams
+  // of stacked_message, up to the 64kB the listener reads at once.
+  Api::SysCallSizeResult groRecvmsg(msghdr* msg, absl::string_view stacked_message,
+                                    uint16_t gso_size) {
+    // Set msg_name and msg_namelen
+    if (client_.localAddress()->ip()->version() == Address::IpVersion::v4) {
+      sockaddr_storage ss;
+      auto ipv4_addr = reinterpret_cast<sockaddr_in*>(&ss);
+      memset(ipv4_addr, 0, sizeof(sockaddr_in));
+      ipv4_addr->sin_family = AF_INET;
+      ipv4_addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      ipv4_addr->sin_port = client_.localAddress()->ip()->port();
+      msg->msg_namelen = sizeof(sockaddr_in);
+      *reinterpret_cast<sockaddr_in*>(msg->msg_name) = *ipv4_addr;
+    } else if (client_.localAddress()->ip()->version() == Address::IpVersion::v6) {
+      sockaddr_storage ss;
+      auto ipv6_addr = reinterpret_cast<sockaddr_in6*>(&ss);
+      memset(ipv6_addr, 0, sizeof(sockaddr_in6));
+      ipv6_addr->sin6_family = AF_INET6;
+      ipv6_addr->sin6_addr = in6addr_loopback;
+      ipv6_addr->sin6_port = client_.localAddress()->ip()->port();
+      *reinterpret_cast<sockaddr_in6*>(msg->msg_name) = *ipv6_addr;
+      msg->msg_namelen = sizeof(sockaddr_in6);
+    }
+
+    // Set msg_iovec
+    EXPECT_EQ(msg->msg_iovlen, 1);
+    // The aggregated read limit is now always applied.
+    EXPECT_EQ(msg->msg_iov[0].iov_len, 64 * 1024);
+    const size_t length = std::min<size_t>(stacked_message.length(), msg->msg_iov[0].iov_len);
+    memcpy(msg->msg_iov[0].iov_base, stacked_message.data(), length);
+    msg->msg_iov[0].iov_len = length;
+
+    // Set control headers
+    memset(msg->msg_control, 0, msg->msg_controllen);
+    cmsghdr* cmsg = CMSG_FIRSTHDR(msg);
+    if (send_to_addr_->ip()->version() == Address::IpVersion::v4) {
+      cmsg->cmsg_level = IPPROTO_IP;
+#ifndef IP_RECVDSTADDR
+      cmsg->cmsg_type = IP_PKTINFO;
+      cmsg->cmsg_len = CMSG_LEN(sizeof(in_pktinfo));
+      reinterpret_cast<in_pktinfo*>(CMSG_DATA(cmsg))->ipi_addr.s_addr =
+          send_to_addr_->ip()->ipv4()->address();
+#else
+      cmsg.cmsg_type = IP_RECVDSTADDR;
+      cmsg->cmsg_len = CMSG_LEN(sizeof(in_addr));
+      *reinterpret_cast<in_addr*>(CMSG_DATA(cmsg)) = send_to_addr_->ip()->ipv4()->address();
+#endif
+    } else if (send_to_addr_->ip()->version() == Address::IpVersion::v6) {
+      cmsg->cmsg_len = CMSG_LEN(sizeof(in6_pktinfo));
+      cmsg->cmsg_level = IPPROTO_IPV6;
+      cmsg->cmsg_type = IPV6_PKTINFO;
+      auto pktinfo = reinterpret_cast<in6_pktinfo*>(CMSG_DATA(cmsg));
+      pktinfo->ipi6_ifindex = 0;
+      *(reinterpret_cast<absl::uint128*>(pktinfo->ipi6_addr.s6_addr)) =
+          send_to_addr_->ip()->ipv6()->address();
+    }
+
+    // Set gso_size
+    cmsg = CMSG_NXTHDR(msg, cmsg);
+    cmsg->cmsg_level = SOL_UDP;
+    cmsg->cmsg_type = UDP_GRO;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    *reinterpret_cast<uint16_t*>(CMSG_DATA(cmsg)) = gso_size;
+
+#ifdef SO_RXQ_OVFL
+    // Set SO_RXQ_OVFL
+    cmsg = CMSG_NXTHDR(msg, cmsg);
+    EXPECT_NE(cmsg, nullptr);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SO_RXQ_OVFL;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(uint32_t));
+    const uint32_t overflow = 0;
+    *reinterpret_cast<uint32_t*>(CMSG_DATA(cmsg)) = overflow;
+#endif
+    return Api::SysCallSizeResult{static_cast<long>(length), 0};
+  }
+#endif
+
   NiceMock<OverrideOsSysCallsImpl> override_syscall_;
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls{&override_syscall_};
   bool recvbuf_large_enough_{true};
@@ -610,78 +690,7 @@ TEST_P(UdpListenerImplTest, UdpGroBasic) {
 
   EXPECT_CALL(os_sys_calls, recvmsg(_, _, _))
       .WillOnce(Invoke([&](os_fd_t, msghdr* msg, int) {
-        // Set msg_name and msg_namelen
-        if (client_.localAddress()->ip()->version() == Address::IpVersion::v4) {
-          sockaddr_storage ss;
-          auto ipv4_addr = reinterpret_cast<sockaddr_in*>(&ss);
-          memset(ipv4_addr, 0, sizeof(sockaddr_in));
-          ipv4_addr->sin_family = AF_INET;
-          ipv4_addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
-          ipv4_addr->sin_port = client_.localAddress()->ip()->port();
-          msg->msg_namelen = sizeof(sockaddr_in);
-          *reinterpret_cast<sockaddr_in*>(msg->msg_name) = *ipv4_addr;
-        } else if (client_.localAddress()->ip()->version() == Address::IpVersion::v6) {
-          sockaddr_storage ss;
-          auto ipv6_addr = reinterpret_cast<sockaddr_in6*>(&ss);
-          memset(ipv6_addr, 0, sizeof(sockaddr_in6));
-          ipv6_addr->sin6_family = AF_INET6;
-          ipv6_addr->sin6_addr = in6addr_loopback;
-          ipv6_addr->sin6_port = client_.localAddress()->ip()->port();
-          *reinterpret_cast<sockaddr_in6*>(msg->msg_name) = *ipv6_addr;
-          msg->msg_namelen = sizeof(sockaddr_in6);
-        }
-
-        // Set msg_iovec
-        EXPECT_EQ(msg->msg_iovlen, 1);
-        memcpy(msg->msg_iov[0].iov_base, stacked_message.data(), stacked_message.length());
-        // The aggregated read limit is now always applied.
-        EXPECT_EQ(msg->msg_iov[0].iov_len, 64 * 1024);
-        msg->msg_iov[0].iov_len = stacked_message.length();
-
-        // Set control headers
-        memset(msg->msg_control, 0, msg->msg_controllen);
-        cmsghdr* cmsg = CMSG_FIRSTHDR(msg);
-        if (send_to_addr_->ip()->version() == Address::IpVersion::v4) {
-          cmsg->cmsg_level = IPPROTO_IP;
-#ifndef IP_RECVDSTADDR
-          cmsg->cmsg_type = IP_PKTINFO;
-          cmsg->cmsg_len = CMSG_LEN(sizeof(in_pktinfo));
-          reinterpret_cast<in_pktinfo*>(CMSG_DATA(cmsg))->ipi_addr.s_addr =
-              send_to_addr_->ip()->ipv4()->address();
-#else
-          cmsg.cmsg_type = IP_RECVDSTADDR;
-          cmsg->cmsg_len = CMSG_LEN(sizeof(in_addr));
-          *reinterpret_cast<in_addr*>(CMSG_DATA(cmsg)) = send_to_addr_->ip()->ipv4()->address();
-#endif
-        } else if (send_to_addr_->ip()->version() == Address::IpVersion::v6) {
-          cmsg->cmsg_len = CMSG_LEN(sizeof(in6_pktinfo));
-          cmsg->cmsg_level = IPPROTO_IPV6;
-          cmsg->cmsg_type = IPV6_PKTINFO;
-          auto pktinfo = reinterpret_cast<in6_pktinfo*>(CMSG_DATA(cmsg));
-          pktinfo->ipi6_ifindex = 0;
-          *(reinterpret_cast<absl::uint128*>(pktinfo->ipi6_addr.s6_addr)) =
-              send_to_addr_->ip()->ipv6()->address();
-        }
-
-        // Set gso_size
-        cmsg = CMSG_NXTHDR(msg, cmsg);
-        cmsg->cmsg_level = SOL_UDP;
-        cmsg->cmsg_type = UDP_GRO;
-        cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
-        const uint16_t gso_size = 8;
-        *reinterpret_cast<uint16_t*>(CMSG_DATA(cmsg)) = gso_size;
-
-#ifdef SO_RXQ_OVFL
-        // Set SO_RXQ_OVFL
-        cmsg = CMSG_NXTHDR(msg, cmsg);
-        EXPECT_NE(cmsg, nullptr);
-        cmsg->cmsg_level = SOL_SOCKET;
-        cmsg->cmsg_type = SO_RXQ_OVFL;
-        cmsg->cmsg_len = CMSG_LEN(sizeof(uint32_t));
-        const uint32_t overflow = 0;
-        *reinterpret_cast<uint32_t*>(CMSG_DATA(cmsg)) = overflow;
-#endif
-        return Api::SysCallSizeResult{static_cast<long>(stacked_message.length()), 0};
+        return groRecvmsg(msg, stacked_message, /*gso_size=*/8);
       }))
       .WillRepeatedly(Return(Api::SysCallSizeResult{-1, EAGAIN}));
 
@@ -702,6 +711,39 @@ TEST_P(UdpListenerImplTest, UdpGroBasic) {
   dispatcher_->run(Event::Dispatcher::RunType::Block);
 }
 
+// Test that the datagrams coalesced by GRO are passed at once to the callbacks supporting it.
+TEST_P(UdpListenerImplTest, UdpGroCoalescedDatagrams) {
+  setup(true);
+  ON_CALL(listener_callbacks_, supportsCoalescedDatagrams()).WillByDefault(Return(true));
+
+  absl::FixedArray<std::string> client_data({"Equal!!!", "Length!!", "Messages", "trail"});
+  for (const auto& i : client_data) {
+    client_.write(i, *send_to_addr_);
+  }
+  std::string stacked_message = absl::StrJoin(client_data, "");
+
+  Api::MockOsSysCalls os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  EXPECT_CALL(os_sys_calls, supportsUdpGro).WillRepeatedly(Return(true));
+  EXPECT_CALL(os_sys_calls, supportsMmsg).Times(0);
+  EXPECT_CALL(os_sys_calls, recvmsg(_, _, _))
+      .WillOnce(Invoke([&](os_fd_t, msghdr* msg, int) {
+        return groRecvmsg(msg, stacked_message, /*gso_size=*/8);
+      }))
+      .WillRepeatedly(Return(Api::SysCallSizeResult{-1, EAGAIN}));
+
+  EXPECT_CALL(listener_callbacks_, onReadReady()).WillOnce(Invoke([&]() { dispatcher_->exit(); }));
+  EXPECT_CALL(listener_callbacks_, onData(_)).WillOnce(Invoke([&](const UdpRecvData& data) {
+    validateRecvCallbackParams(data, 1);
+    EXPECT_EQ(8, data.gso_size_);
+    EXPECT_EQ(stacked_message, data.buffer_->toString());
+    // The datagrams are read in place, from a single slice.
+    EXPECT_EQ(1, data.buffer_->getRawSlices().size());
+  }));
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+}
+
 TEST_P(UdpListenerImplTest, GroLargeDatagramRecvmsgNoDrop) {
   // The aggregated read limit is now always applied.
   setup(true);
@@ -760,77 +802,7 @@ TEST_P(UdpListenerImplTest, UdpGroReadLimit) {
   EXPECT_CALL(os_sys_calls, supportsMmsg).Times(0);
 
   EXPECT_CALL(os_sys_calls, recvmsg(_, _, _)).WillOnce(Invoke([&](os_fd_t, msghdr* msg, int) {
-    // Set msg_name and msg_namelen
-    if (client_.localAddress()->ip()->version() == Address::IpVersion::v4) {
-      sockaddr_storage ss;
-      auto ipv4_addr = reinterpret_cast<sockaddr_in*>(&ss);
-      memset(ipv4_addr, 0, sizeof(sockaddr_in));
-      ipv4_addr->sin_family = AF_INET;
-      ipv4_addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
-      ipv4_addr->sin_port = client_.localAddress()->ip()->port();
-      msg->msg_namelen = sizeof(sockaddr_in);
-      *reinterpret_cast<sockaddr_in*>(msg->msg_name) = *ipv4_addr;
-    } else if (client_.localAddress()->ip()->version() == Address::IpVersion::v6) {
-      sockaddr_storage ss;
-      auto ipv6_addr = reinterpret_cast<sockaddr_in6*>(&ss);
-      memset(ipv6_addr, 0, sizeof(sockaddr_in6));
-      ipv6_addr->sin6_family = AF_INET6;
-      ipv6_addr->sin6_addr = in6addr_loopback;
-      ipv6_addr->sin6_port = client_.localAddress()->ip()->port();
-      *reinterpret_cast<sockaddr_in6*>(msg->msg_name) = *ipv6_addr;
-      msg->msg_namelen = sizeof(sockaddr_in6);
-    }
-
-    // Set msg_iovec
-    EXPECT_EQ(msg->msg_iovlen, 1);
-    EXPECT_EQ(msg->msg_iov[0].iov_len, 64 * 1024);
-    memcpy(msg->msg_iov[0].iov_base, stacked_message.data(), 64 * 1024);
-    msg->msg_iov[0].iov_len = 64 * 1024;
-
-    // Set control headers
-    memset(msg->msg_control, 0, msg->msg_controllen);
-    cmsghdr* cmsg = CMSG_FIRSTHDR(msg);
-    if (send_to_addr_->ip()->version() == Address::IpVersion::v4) {
-      cmsg->cmsg_level = IPPROTO_IP;
-#ifndef IP_RECVDSTADDR
-      cmsg->cmsg_type = IP_PKTINFO;
-      cmsg->cmsg_len = CMSG_LEN(sizeof(in_pktinfo));
-      reinterpret_cast<in_pktinfo*>(CMSG_DATA(cmsg))->ipi_addr.s_addr =
-          send_to_addr_->ip()->ipv4()->address();
-#else
-      cmsg.cmsg_type = IP_RECVDSTADDR;
-      cmsg->cmsg_len = CMSG_LEN(sizeof(in_addr));
-      *reinterpret_cast<in_addr*>(CMSG_DATA(cmsg)) = send_to_addr_->ip()->ipv4()->address();
-#endif
-    } else if (send_to_addr_->ip()->version() == Address::IpVersion::v6) {
-      cmsg->cmsg_len = CMSG_LEN(sizeof(in6_pktinfo));
-      cmsg->cmsg_level = IPPROTO_IPV6;
-      cmsg->cmsg_type = IPV6_PKTINFO;
-      auto pktinfo = reinterpret_cast<in6_pktinfo*>(CMSG_DATA(cmsg));
-      pktinfo->ipi6_ifindex = 0;
-      *(reinterpret_cast<absl::uint128*>(pktinfo->ipi6_addr.s6_addr)) =
-          send_to_addr_->ip()->ipv6()->address();
-    }
-
-    // Set gso_size
-    cmsg = CMSG_NXTHDR(msg, cmsg);
-    cmsg->cmsg_level = SOL_UDP;
-    cmsg->cmsg_type = UDP_GRO;
-    cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
-    const uint16_t gso_size = 1024;
-    *reinterpret_cast<uint16_t*>(CMSG_DATA(cmsg)) = gso_size;
-
-#ifdef SO_RXQ_OVFL
-    // Set SO_RXQ_OVFL
-    cmsg = CMSG_NXTHDR(msg, cmsg);
-    EXPECT_NE(cmsg, nullptr);
-    cmsg->cmsg_level = SOL_SOCKET;
-    cmsg->cmsg_type = SO_RXQ_OVFL;
-    cmsg->cmsg_len = CMSG_LEN(sizeof(uint32_t));
-    const uint32_t overflow = 0;
-    *reinterpret_cast<uint32_t*>(CMSG_DATA(cmsg)) = overflow;
-#endif
-    return Api::SysCallSizeResult{static_cast<long>(64 * 1024), 0};
+    return groRecvmsg(msg, stacked_message, /*gso_size=*/1024);
   }));
 
   EXPECT_CALL(listener_callbacks_, onReadReady()).WillOnce(Invoke([&]() { dispatcher_->exit(); }));
@@ -308,6 +308,37 @@ protected:
     }
   }
 
+  // Returns the packets of a CHLO coalesced in a single buffer, as read with GRO.
+  Network::UdpRecvData coalescedCHLO(quic::QuicConnectionId connection_id) {
+    Network::Address::InstanceConstSharedPtr client_address =
+        Network::Test::getCanonicalLoopbackAddress(version_);
+    client_sockets_.push_back(
+        std::make_unique<Network::SocketImpl>(Network::Socket::Type::Datagram, client_address,
+                                              nullptr, Network::SocketCreationOptions{}));
+    EXPECT_EQ(0, client_sockets_.back()->bind(client_address).return_value_);
+
+    Network::UdpRecvData data;
+    data.addresses_.local_ = Network::Utility::getAddressWithPort(
+        *client_address, listen_socket_->connectionInfoProvider().localAddress()->ip()->port());
+    data.addresses_.peer_ = client_sockets_.back()->connectionInfoProvider().localAddress();
+    data.buffer_ = std::make_unique<Buffer::OwnedImpl>();
+    data.receive_time_ = dispatcher_->timeSource().monotonicTime();
+    std::vector<Buffer::OwnedImpl> payloads =
+        generateChloPacketsToSend(quic_version_, quic_config_, connection_id);
+    data.gso_size_ = payloads[0].length();
+    for (size_t i = 0; i < payloads.size(); ++i) {
+      // GRO only coalesces datagrams of the same size, but the last one.
+      if (i + 1 < payloads.size()) {
+        EXPECT_EQ(data.gso_size_, payloads[i].length());
+      } else {
+        EXPECT_LE(payloads[i].length(), data.gso_size_);
+      }
+      data.buffer_->move(payloads[i]);
+    }
+    data.buffer_->linearize(data.buffer_->length());
+    return data;
+  }
+
   void readFromClientSockets() {
     for (auto& client_socket : client_sockets_) {
       Buffer::InstancePtr result_buffer(new Buffer::OwnedImpl());
@@ -487,6 +518,51 @@ TEST_P(ActiveQuicListenerTest, ReceiveCHLODuringHotRestartShouldForwardPacket) {
   EXPECT_EQ(0u, quic_dispatcher_->NumSessions());
 }
 
+TEST_P(ActiveQuicListenerTest, ReceiveCoalescedCHLO) {
+  initialize();
+  EXPECT_TRUE(quic_listener_->supportsCoalescedDatagrams());
+  maybeConfigureMocks(/* connection_count = */ 1);
+  quic::QuicConnectionId connection_id = quic::test::TestConnectionId(1);
+  dispatcher_->post([this, connection_id]() {
+    quic_listener_->onDataWorker(coalescedCHLO(connection_id));
+    quic_listener_->onReadReady();
+  });
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_NE(nullptr, quic::test::QuicDispatcherPeer::FindSession(quic_dispatcher_, connection_id));
+  readFromClientSockets();
+}
+
+TEST_P(ActiveQuicListenerTest, ReceiveCoalescedCHLODuringHotRestartShouldForwardEachPacket) {
+  initialize();
+  MockNonDispatchedUdpPacketHandler mock_packet_forwarding;
+  Network::ExtraShutdownListenerOptions options;
+  options.non_dispatched_udp_packet_handler_ = mock_packet_forwarding;
+  quic_listener_->shutdownListener(options);
+  maybeConfigureMocks(/* connection_count = */ 0);
+  quic::QuicConnectionId connection_id = quic::test::TestConnectionId(1);
+  std::vector<Buffer::OwnedImpl> packets =
+      generateChloPacketsToSend(quic_version_, quic_config_, connection_id);
+  testing::Sequence seq;
+  for (Buffer::OwnedImpl& packet : packets) {
+    EXPECT_CALL(mock_packet_forwarding, handle(_, _))
+        .InSequence(seq)
+        .WillOnce(Invoke([expected = packet.toString()](uint32_t,
+                                                        const Network::UdpRecvData& data) {
+          EXPECT_EQ(0, data.gso_size_);
+          EXPECT_EQ(expected, data.buffer_->toString());
+        }));
+  }
+  quic_listener_->onDataWorker(coalescedCHLO(connection_id));
+  EXPECT_EQ(0u, quic_dispatcher_->NumSessions());
+}
+
+TEST_P(ActiveQuicListenerTest, CoalescedDatagramsRuntimeDisabled) {
+  scoped_runtime_.mergeValues(
+      {{"envoy.reloadable_features.quic_process_coalesced_datagrams", "false"}});
+  initialize();
+  EXPECT_FALSE(quic_listener_->supportsCoalescedDatagrams());
+}
+
 TEST_P(ActiveQuicListenerTest, NormalizeTimeouts) {
   idle_timeout_ = 0.0005;      // 0.5ms
   handshake_timeout_ = 0.0009; // 0.9ms
@@ -0,0 +1,184 @@
+// Compares receiving QUIC packets sent with GSO over loopback when the datagrams coalesced by GRO
+// are moved to buffers of their own and dispatched one at a time, as UdpListenerImpl does by
+// default, and when they are dispatched in place from the buffer they were read in, as
+// ActiveQuicListener does.
+
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/event/real_time_system.h"
+#include "source/common/network/address_impl.h"
+#include "source/common/network/io_socket_handle_impl.h"
+#include "source/common/network/utility.h"
+#include "source/common/quic/envoy_quic_utils.h"
+
+#include "benchmark/benchmark.h"
+#include "quiche/quic/core/quic_packets.h"
+
+namespace Envoy {
+
+// A QUIC packet as sent by quiche over IPv4 with the default MTU.
+constexpr size_t PacketSize = 1350;
+
+// Returns a pair of non-blocking loopback UDP sockets, the first one connected to the second one
+// and the second one reading with GRO.
+static std::pair<int, int> udpSocketPair() {
+  int server = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+  RELEASE_ASSERT(server >= 0, "socket");
+  const int on = 1;
+  RELEASE_ASSERT(setsockopt(server, SOL_UDP, UDP_GRO, &on, sizeof(on)) == 0, "UDP_GRO");
+  RELEASE_ASSERT(setsockopt(server, IPPROTO_IP, IP_PKTINFO, &on, sizeof(on)) == 0, "IP_PKTINFO");
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t address_length = sizeof(address);
+  RELEASE_ASSERT(bind(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0,
+                 "bind");
+  RELEASE_ASSERT(getsockname(server, reinterpret_cast<sockaddr*>(&address), &address_length) == 0,
+                 "getsockname");
+  int client = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+  RELEASE_ASSERT(client >= 0, "socket");
+  RELEASE_ASSERT(connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0,
+                 "connect");
+  return {client, server};
+}
+
+// Hands the packets read to a QuicReceivedPacket, as ActiveQuicListener does before passing them
+// to the QuicDispatcher.
+class QuicPacketProcessor : public Network::UdpPacketProcessor {
+public:
+  explicit QuicPacketProcessor(bool batched) : batched_(batched) {}
+
+  // Network::UdpPacketProcessor
+  void processPacket(Network::Address::InstanceConstSharedPtr local_address,
+                     Network::Address::InstanceConstSharedPtr peer_address,
+                     Buffer::InstancePtr buffer, MonotonicTime receive_time, uint8_t,
+                     Buffer::OwnedImpl) override {
+    const quic::QuicSocketAddress self =
+        Quic::envoyIpAddressToQuicSocketAddress(local_address->ip());
+    const quic::QuicSocketAddress peer =
+        Quic::envoyIpAddressToQuicSocketAddress(peer_address->ip());
+    const Buffer::RawSlice slice = buffer->frontSlice();
+    dispatch(self, peer, static_cast<char*>(slice.mem_), slice.len_, quicTime(receive_time));
+  }
+  void processCoalescedDatagrams(Network::Address::InstanceConstSharedPtr local_address,
+                                 Network::Address::InstanceConstSharedPtr peer_address,
+                                 Buffer::InstancePtr buffer, uint64_t gso_size,
+                                 MonotonicTime receive_time, uint8_t tos,
+                                 Buffer::OwnedImpl saved_cmsg) override {
+    ++coalesced_reads_;
+    if (!batched_) {
+      UdpPacketProcessor::processCoalescedDatagrams(
+          std::move(local_address), std::move(peer_address), std::move(buffer), gso_size,
+          receive_time, tos, std::move(saved_cmsg));
+      return;
+    }
+    const quic::QuicSocketAddress self =
+        Quic::envoyIpAddressToQuicSocketAddress(local_address->ip());
+    const quic::QuicSocketAddress peer =
+        Quic::envoyIpAddressToQuicSocketAddress(peer_address->ip());
+    const quic::QuicTime timestamp = quicTime(receive_time);
+    const Buffer::RawSlice slice = buffer->frontSlice();
+    for (uint64_t offset = 0; offset < slice.len_; offset += gso_size) {
+      dispatch(self, peer, static_cast<char*>(slice.mem_) + offset,
+               std::min(gso_size, slice.len_ - offset), timestamp);
+    }
+  }
+  void onDatagramsDropped(uint32_t) override {}
+  uint64_t maxDatagramSize() const override { return Network::DEFAULT_UDP_MAX_DATAGRAM_SIZE; }
+  size_t numPacketsExpectedPerEventLoop() const override {
+    return Network::MAX_NUM_PACKETS_PER_EVENT_LOOP;
+  }
+  const Network::IoHandle::UdpSaveCmsgConfig& saveCmsgConfig() const override {
+    return save_cmsg_config_;
+  }
+
+  uint64_t packets_{0};
+  uint64_t bytes_{0};
+  uint64_t coalesced_reads_{0};
+
+private:
+  static quic::QuicTime quicTime(MonotonicTime time) {
+    return quic::QuicTime::Zero() +
+           quic::QuicTime::Delta::FromMicroseconds(
+               std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch())
+                   .count());
+  }
+
+  void dispatch(const quic::QuicSocketAddress& self, const quic::QuicSocketAddress& peer,
+                char* data, uint64_t length, quic::QuicTime timestamp) {
+    quic::QuicReceivedPacket packet(data, length, timestamp);
+    benchmark::DoNotOptimize(self);
+    benchmark::DoNotOptimize(peer);
+    benchmark::DoNotOptimize(packet.data()[0]);
+    ++packets_;
+    bytes_ += length;
+  }
+
+  const bool batched_;
+  Network::IoHandle::UdpSaveCmsgConfig save_cmsg_config_;
+};
+
+// state.range(0): 0 to dispatch the packets one at a time, 1 to dispatch them in place.
+// state.range(1): the number of packets sent with each GSO send.
+static void receiveCoalescedPackets(benchmark::State& state) {
+  const bool batched = state.range(0);
+  const size_t packets_per_send = state.range(1);
+  constexpr size_t SendsPerIteration = 16;
+
+  auto [client_fd, server_fd] = udpSocketPair();
+  const int gso_size = PacketSize;
+  RELEASE_ASSERT(setsockopt(client_fd, SOL_UDP, UDP_SEGMENT, &gso_size, sizeof(gso_size)) == 0,
+                 "UDP_SEGMENT");
+  sockaddr_in address{};
+  socklen_t address_length = sizeof(address);
+  RELEASE_ASSERT(
+      getsockname(server_fd, reinterpret_cast<sockaddr*>(&address), &address_length) == 0,
+      "getsockname");
+  const Network::Address::Ipv4Instance local_address(&address);
+  Network::IoSocketHandleImpl io_handle(server_fd);
+  Event::RealTimeSystem time_system;
+  QuicPacketProcessor processor(batched);
+  const std::string data(PacketSize * packets_per_send, 'a');
+  uint32_t packets_dropped = 0;
+
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    // Read each send before the next one, so that the socket never drops packets.
+    for (size_t i = 0; i < SendsPerIteration; ++i) {
+      RELEASE_ASSERT(::send(client_fd, data.data(), data.size(), 0) ==
+                         static_cast<ssize_t>(data.size()),
+                     "send");
+      const uint64_t expected = processor.packets_ + packets_per_send;
+      while (processor.packets_ < expected) {
+        Network::Utility::readPacketsFromSocket(io_handle, local_address, processor, time_system,
+                                                /*allow_gro=*/true, /*allow_mmsg=*/false,
+                                                packets_dropped);
+      }
+    }
+  }
+  state.counters["throughput"] = benchmark::Counter(processor.bytes_, benchmark::Counter::kIsRate);
+  // Zero if the kernel does not coalesce the packets sent with GSO on loopback.
+  state.counters["coalesced_reads"] =
+      benchmark::Counter(processor.coalesced_reads_, benchmark::Counter::kAvgIterations);
+
+  ::close(client_fd);
+}
+
+static void testParams(benchmark::internal::Benchmark* b) {
+  for (int batched : {0, 1}) {
+    for (int packets_per_send : {1, 8, 40}) {
+      b->Args({batched, packets_per_send});
+    }
+  }
+}
+
+BENCHMARK(receiveCoalescedPackets)->Unit(::benchmark::kMicrosecond)->Apply(testParams);
+
+} // namespace Envoy
@@ -3,6 +3,7 @@
 
 #include "source/common/common/assert.h"
 #include "source/common/router/config_impl.h"
+#include "source/common/runtime/runtime_features.h"
 
 #include "test/mocks/server/server_factory_context.h"
 #include "test/mocks/stream_info/mocks.h"
@@ -59,7 +60,7 @@ static RouteConfiguration genRouteConfig(benchmark::State& state,
       break;
     }
     case RouteMatch::PathSpecifierCase::kPath: {
-      match->set_prefix(absl::StrCat("/shelves/shelf_", i, "/route_", i));
+      match->set_path(absl::StrCat("/shelves/shelf_", i, "/route_", i));
       break;
     }
     case RouteMatch::PathSpecifierCase::kSafeRegex: {
@@ -435,6 +436,82 @@ static void bmVirtualHostLookup(benchmark::State& state) {
   }
 }
 
+/**
+ * Route config with `n` routes cycling through exact, prefix and path separated prefix matchers,
+ * with a regex route every 100 routes, in the form of:
+ * - /shelves/shelf_0/route_0 (exact)
+ * - /shelves/shelf_1/ (prefix)
+ * - /shelves/shelf_2 (path separated prefix)
+ * - ^/shelves/[^/]+/regex_99$ (regex)
+ * - etc.
+ */
+static RouteConfiguration genLargeRouteConfig(int n) {
+  RouteConfiguration route_config;
+  VirtualHost* v_host = route_config.add_virtual_hosts();
+  v_host->set_name("default");
+  v_host->add_domains("*");
+  for (int i = 0; i < n; ++i) {
+    Route* route = v_host->add_routes();
+    route->mutable_direct_response()->set_status(200);
+    RouteMatch* match = route->mutable_match();
+    if (i % 100 == 99) {
+      envoy::type::matcher::v3::RegexMatcher* regex = match->mutable_safe_regex();
+      regex->mutable_google_re2();
+      regex->set_regex(absl::StrCat("^/shelves/[^\\/]+/regex_", i, "$"));
+      continue;
+    }
+    switch (i % 3) {
+    case 0:
+      match->set_path(absl::StrCat("/shelves/shelf_", i, "/route_", i));
+      break;
+    case 1:
+      match->set_prefix(absl::StrCat("/shelves/shelf_", i, "/"));
+      break;
+    default:
+      match->set_path_separated_prefix(absl::StrCat("/shelves/shelf_", i));
+      break;
+    }
+  }
+  return route_config;
+}
+
+/**
+ * Benchmark route selection over large route tables with and without
+ * envoy.reloadable_features.compiled_route_path_matching. The request matches the last non-regex
+ * route, so the ordered scan evaluates nearly every route while the compiled index only evaluates
+ * the regex routes and the matching route.
+ */
+static void bmCompiledRouteMatching(benchmark::State& state) {
+  const int n = state.range(0);
+  const bool compiled = state.range(1) != 0;
+  Runtime::maybeSetRuntimeGuard("envoy.reloadable_features.compiled_route_path_matching",
+                                compiled);
+  Api::ApiPtr api = Api::createApiForTest();
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+  NiceMock<Envoy::StreamInfo::MockStreamInfo> stream_info;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+  std::shared_ptr<ConfigImpl> config = *ConfigImpl::create(
+      genLargeRouteConfig(n), factory_context, ProtobufMessage::getNullValidationVisitor(), true);
+  Runtime::maybeSetRuntimeGuard("envoy.reloadable_features.compiled_route_path_matching", false);
+
+  int last_route_num = n - 1;
+  while (last_route_num % 100 == 99) {
+    --last_route_num;
+  }
+  Http::TestRequestHeaderMapImpl headers = genRequestHeaders(last_route_num);
+  if (config->route(headers, stream_info, 0) == nullptr) {
+    state.SkipWithError("request did not match a route");
+    return;
+  }
+  for (auto _ : state) { // NOLINT
+    config->route(headers, stream_info, 0);
+  }
+}
+
+BENCHMARK(bmCompiledRouteMatching)
+    ->ArgsProduct({{1000, 5000, 10000}, {0, 1}})
+    ->ArgNames({"routes", "compiled"});
+
 BENCHMARK(bmPlainRoutes)->RangeMultiplier(2)->Ranges({{64, 2 << 10}});
 BENCHMARK(bmMixedRoutes)->RangeMultiplier(2)->Ranges({{64, 2 << 10}});
 BENCHMARK(bmVirtualHostLookup)->RangeMultiplier(2)->Ranges({{1, 2 << 9}});
@@ -10190,6 +10190,81 @@ virtual_hosts:
   }
 }
 
+// The compiled path index must select the same route as the ordered scan, including for routes
+// that are shadowed by earlier ones and for routes that cannot be indexed.
+TEST_F(RouteMatcherTest, CompiledRoutePathMatching) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: compiled
+    domains: ["*"]
+    routes:
+      - match:
+          prefix: "/api/v1/"
+          headers:
+            - name: x-canary
+              present_match: true
+        route: { cluster: canary }
+      - match:
+          safe_regex:
+            regex: "^/api/v1/users/[0-9]+$"
+        route: { cluster: regex }
+      - match: { path: "/api/v1/users/me" }
+        route: { cluster: me }
+      - match:
+          prefix: "/API/"
+          case_sensitive: false
+        route: { cluster: insensitive }
+      - match: { path_separated_prefix: "/api/v1" }
+        route: { cluster: api-v1 }
+      - match: { prefix: "/api" }
+        route: { cluster: api }
+      - match: { path: "/api" }
+        route: { cluster: shadowed }
+      - match: { prefix: "/" }
+        route: { cluster: default }
+  )EOF";
+
+  factory_context_.cluster_manager_.initializeClusters(
+      {"canary", "regex", "me", "insensitive", "api-v1", "api", "shadowed", "default"}, {});
+
+  const std::vector<std::pair<std::string, std::string>> expectations = {
+      {"/api/v1/users/42", "regex"},  {"/api/v1/users/me", "me"},
+      {"/api/v1/users/me?x=1", "me"}, {"/Api/v1/users/me", "insensitive"},
+      {"/api/v1", "api-v1"},          {"/api/v1/other#fragment", "api-v1"},
+      {"/api/v1x", "api"},            {"/api", "api"},
+      {"/other", "default"},
+  };
+
+  for (const bool compiled : {false, true}) {
+    SCOPED_TRACE(compiled);
+    mergeValues({{"envoy.reloadable_features.compiled_route_path_matching",
+                  compiled ? "true" : "false"}});
+    TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, true,
+                          creation_status_);
+
+    for (const auto& [path, cluster] : expectations) {
+      EXPECT_EQ(cluster, config.route(genHeaders("www.lyft.com", path, "GET"), 0)
+                             ->routeEntry()
+                             ->clusterName())
+          << path;
+    }
+
+    auto headers = genHeaders("www.lyft.com", "/api/v1/users/42", "GET");
+    headers.addCopy("x-canary", "1");
+    EXPECT_EQ("canary", config.route(headers, 0)->routeEntry()->clusterName());
+
+    // Route callbacks see every matching route in order, including shadowed ones.
+    std::vector<std::string> clusters;
+    config.route(
+        [&clusters](RouteConstSharedPtr route, RouteEvalStatus) -> RouteMatchStatus {
+          clusters.push_back(route->routeEntry()->clusterName());
+          return RouteMatchStatus::Continue;
+        },
+        genHeaders("www.lyft.com", "/api", "GET"));
+    EXPECT_EQ((std::vector<std::string>{"api", "shadowed", "default"}), clusters);
+  }
+}
+
 TEST_F(RouteMatcherTest, CookieMatch) {
 
   const std::string yaml = R"EOF(
@@ -0,0 +1,76 @@
+#include "source/common/router/route_path_index.h"
+
+#include "absl/strings/str_cat.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+RoutePathIndex::Candidates findCandidates(const RoutePathIndex& index, absl::string_view path) {
+  RoutePathIndex::Candidates candidates;
+  index.findCandidates(path, candidates);
+  return candidates;
+}
+
+TEST(RoutePathIndexTest, Empty) {
+  RoutePathIndex index;
+  index.compile();
+  EXPECT_EQ(0, index.indexedRoutes());
+  EXPECT_THAT(findCandidates(index, "/"), IsEmpty());
+}
+
+TEST(RoutePathIndexTest, CandidatesAreInRouteOrder) {
+  RoutePathIndex index;
+  index.addPrefix(0, "/a");
+  index.addUnindexed(1);
+  index.addExact(2, "/a/b");
+  index.addPrefix(3, "/");
+  index.addPrefix(4, "/a/b");
+  index.addExact(5, "/c");
+  index.addUnindexed(6);
+  index.compile();
+  EXPECT_EQ(5, index.indexedRoutes());
+
+  EXPECT_THAT(findCandidates(index, "/a/b"), ElementsAre(0, 1, 2, 3, 4, 6));
+  EXPECT_THAT(findCandidates(index, "/a/bc"), ElementsAre(0, 1, 3, 4, 6));
+  EXPECT_THAT(findCandidates(index, "/c"), ElementsAre(1, 3, 5, 6));
+  EXPECT_THAT(findCandidates(index, "/x"), ElementsAre(1, 3, 6));
+  EXPECT_THAT(findCandidates(index, "x"), ElementsAre(1, 6));
+}
+
+TEST(RoutePathIndexTest, DuplicateKeys) {
+  RoutePathIndex index;
+  index.addExact(0, "/a");
+  index.addPrefix(1, "/a");
+  index.addExact(2, "/a");
+  index.addPrefix(3, "/a");
+  index.compile();
+
+  EXPECT_THAT(findCandidates(index, "/a"), ElementsAre(0, 1, 2, 3));
+  EXPECT_THAT(findCandidates(index, "/ab"), ElementsAre(1, 3));
+}
+
+TEST(RoutePathIndexTest, ManyRoutes) {
+  RoutePathIndex index;
+  for (uint32_t i = 0; i < 10000; ++i) {
+    if (i % 2 == 0) {
+      index.addExact(i, absl::StrCat("/shelves/shelf_", i, "/route_", i));
+    } else {
+      index.addPrefix(i, absl::StrCat("/shelves/shelf_", i, "/"));
+    }
+  }
+  index.compile();
+
+  EXPECT_THAT(findCandidates(index, "/shelves/shelf_9998/route_9998"), ElementsAre(9998));
+  EXPECT_THAT(findCandidates(index, "/shelves/shelf_9999/route_9999"), ElementsAre(9999));
+  EXPECT_THAT(findCandidates(index, "/shelves/shelf_9998/route_9999"), IsEmpty());
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
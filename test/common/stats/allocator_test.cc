@@ -10,6 +10,7 @@
 #include "test/test_common/logging.h"
 #include "test/test_common/thread_factory_for_test.h"
 
+#include "absl/strings/match.h"
 #include "absl/synchronization/notification.h"
 #include "gmock/gmock-matchers.h"
 #include "gtest/gtest.h"
@@ -18,6 +19,26 @@ namespace Envoy {
 namespace Stats {
 namespace {
 
+// Accepts the stats whose names start with a prefix.
+class PrefixStatsMatcher : public StatsMatcher {
+public:
+  PrefixStatsMatcher(const SymbolTable& symbol_table, std::string prefix)
+      : symbol_table_(symbol_table), prefix_(std::move(prefix)) {}
+
+  // StatsMatcher
+  bool rejects(StatName name) const override {
+    return !absl::StartsWith(symbol_table_.toString(name), prefix_);
+  }
+  FastResult fastRejects(StatName) const override { return FastResult::NoMatch; }
+  bool slowRejects(FastResult, StatName name) const override { return rejects(name); }
+  bool acceptsAll() const override { return false; }
+  bool rejectsAll() const override { return false; }
+
+private:
+  const SymbolTable& symbol_table_;
+  const std::string prefix_;
+};
+
 class AllocatorTest : public testing::Test {
 protected:
   AllocatorTest() : pool_(symbol_table_), alloc_(symbol_table_) {}
@@ -712,6 +733,70 @@ TEST_F(AllocatorTest, ForEachSinkedTextReadout) {
   EXPECT_EQ(num_iterations, 0);
 }
 
+TEST_F(AllocatorTest, ShardedCounter) {
+  alloc_.setShardedCounterMatcher(std::make_unique<PrefixStatsMatcher>(symbol_table_, "sharded."));
+  CounterSharedPtr sharded = alloc_.makeCounter(makeStat("sharded.counter"), StatName(), {});
+  CounterSharedPtr plain = alloc_.makeCounter(makeStat("plain.counter"), StatName(), {});
+
+  for (const CounterSharedPtr& counter : {sharded, plain}) {
+    SCOPED_TRACE(counter->name());
+    EXPECT_FALSE(counter->used());
+    EXPECT_EQ(0, counter->value());
+    counter->inc();
+    counter->add(4);
+    EXPECT_TRUE(counter->used());
+    EXPECT_EQ(5, counter->value());
+    EXPECT_EQ(5, counter->latch());
+    EXPECT_EQ(0, counter->latch());
+    counter->add(2);
+    EXPECT_EQ(7, counter->value());
+    counter->reset();
+    EXPECT_EQ(0, counter->value());
+    // Resetting the value does not drop the increments pending the next latch.
+    EXPECT_EQ(2, counter->latch());
+    counter->inc();
+    EXPECT_EQ(1, counter->value());
+    EXPECT_EQ(1, counter->latch());
+    counter->markUnused();
+    EXPECT_FALSE(counter->used());
+  }
+
+  // Sharded counters are looked up and released like any other counter.
+  EXPECT_EQ(sharded.get(), alloc_.makeCounter(makeStat("sharded.counter"), StatName(), {}).get());
+  sharded.reset();
+  EXPECT_EQ(0, alloc_.makeCounter(makeStat("sharded.counter"), StatName(), {})->value());
+}
+
+TEST_F(AllocatorTest, ShardedCounterConcurrentIncrements) {
+  alloc_.setShardedCounterMatcher(std::make_unique<PrefixStatsMatcher>(symbol_table_, "sharded."));
+  CounterSharedPtr counter = alloc_.makeCounter(makeStat("sharded.counter"), StatName(), {});
+  Thread::ThreadFactory& thread_factory = Thread::threadFactoryForTest();
+
+  const uint32_t num_threads = 12;
+  const uint32_t iters = 10000;
+  std::vector<Thread::ThreadPtr> threads;
+  absl::Notification go;
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads.push_back(thread_factory.createThread([&]() {
+      go.WaitForNotification();
+      for (uint32_t iter = 0; iter < iters; ++iter) {
+        counter->inc();
+      }
+    }));
+  }
+  go.Notify();
+  uint64_t latched = 0;
+  while (latched < num_threads * iters / 2) {
+    latched += counter->latch();
+  }
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads[i]->join();
+  }
+
+  EXPECT_EQ(num_threads * iters, counter->value());
+  EXPECT_EQ(num_threads * iters, latched + counter->latch());
+}
+
 } // namespace
 } // namespace Stats
 } // namespace Envoy
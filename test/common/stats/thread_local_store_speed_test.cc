@@ -72,6 +72,17 @@ public:
         std::make_unique<Stats::StatsMatcherImpl>(stats_config_, symbol_table_, context_));
   }
 
+  void initShardedCounters(const std::string& prefix) {
+    stats_config_.mutable_sharded_counter_matcher()
+        ->mutable_inclusion_list()
+        ->add_patterns()
+        ->set_prefix(prefix);
+    store_.setShardedCounterMatcher(std::make_unique<Stats::StatsMatcherImpl>(
+        stats_config_.sharded_counter_matcher(), symbol_table_, context_));
+  }
+
+  Stats::Counter& counter(const std::string& name) { return store_.rootScope()->counter(name); }
+
 private:
   NiceMock<Server::Configuration::MockServerFactoryContext> context_;
   Stats::SymbolTableImpl symbol_table_;
@@ -137,5 +148,32 @@ static void BM_StatsWithTlsAndRejectionsWithoutDot(benchmark::State& state) {
 }
 BENCHMARK(BM_StatsWithTlsAndRejectionsWithoutDot);
 
+std::unique_ptr<Envoy::ThreadLocalStorePerf> hot_counter_context;
+void hotCounterSetup(const benchmark::State& state) {
+  hot_counter_context = std::make_unique<Envoy::ThreadLocalStorePerf>();
+  if (state.range(0) == 1) {
+    hot_counter_context->initShardedCounters("hot.");
+  }
+}
+void hotCounterTeardown(const benchmark::State&) { hot_counter_context.reset(); }
+
+// Increments a single counter from a growing number of threads, with the counter being a plain
+// atomic (range 0) or sharded across threads (range 1). This models a counter such as
+// downstream_rq_total that every worker increments on every request.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_HotCounterIncrement(benchmark::State& state) {
+  Envoy::Stats::Counter& counter = hot_counter_context->counter("hot.rq_total");
+  for (auto _ : state) { // NOLINT
+    counter.inc();
+  }
+}
+BENCHMARK(BM_HotCounterIncrement)
+    ->Arg(0)
+    ->Arg(1)
+    ->ThreadRange(1, 64)
+    ->UseRealTime()
+    ->Setup(hotCounterSetup)
+    ->Teardown(hotCounterTeardown);
+
 // TODO(jmarantz): add multi-threaded variant of this test, that aggressively
 // looks up stats in multiple threads to try to trigger contention issues.
@@ -0,0 +1,228 @@
+#include <sys/socket.h>
+
+#include <string>
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/network/connection_socket_impl.h"
+#include "source/common/network/io_socket_handle_impl.h"
+#include "source/common/tcp_proxy/splice.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace TcpProxy {
+namespace {
+
+class MockSpliceCallbacks : public SpliceSession::Callbacks {
+public:
+  MOCK_METHOD(void, onSplicedBytesRead, (SpliceSession::Side side, uint64_t bytes));
+  MOCK_METHOD(void, onSplicedBytesWritten, (SpliceSession::Side side, uint64_t bytes));
+  MOCK_METHOD(void, onSpliceStopped,
+              (Buffer::Instance & downstream_data, Buffer::Instance& upstream_data));
+};
+
+// A mock connection wrapping one end of a socket pair, with its file events on a real dispatcher.
+class SplicedConnection {
+public:
+  SplicedConnection(Event::Dispatcher& dispatcher, os_fd_t fd)
+      : socket_(std::make_unique<Network::ConnectionSocketImpl>(
+            std::make_unique<Network::IoSocketHandleImpl>(fd), nullptr, nullptr)) {
+    ON_CALL(connection_, dispatcher()).WillByDefault(ReturnRef(dispatcher));
+    ON_CALL(connection_, getSocket()).WillByDefault(ReturnRef(socket_));
+    ON_CALL(connection_, canSpliceSocket()).WillByDefault(Return(true));
+  }
+
+  Network::ConnectionSocketPtr socket_;
+  NiceMock<Network::MockConnection> connection_;
+};
+
+class SpliceSessionTest : public testing::Test {
+protected:
+  SpliceSessionTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")) {
+    os_fd_t downstream_fds[2];
+    os_fd_t upstream_fds[2];
+    RELEASE_ASSERT(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, downstream_fds) == 0, "");
+    RELEASE_ASSERT(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, upstream_fds) == 0, "");
+    client_fd_ = downstream_fds[0];
+    server_fd_ = upstream_fds[1];
+    downstream_ = std::make_unique<SplicedConnection>(*dispatcher_, downstream_fds[1]);
+    upstream_ = std::make_unique<SplicedConnection>(*dispatcher_, upstream_fds[0]);
+  }
+
+  ~SpliceSessionTest() override {
+    session_.reset();
+    os_sys_calls_.close(client_fd_);
+    os_sys_calls_.close(server_fd_);
+  }
+
+  void start() {
+    EXPECT_CALL(downstream_->connection_, readDisable(true));
+    EXPECT_CALL(upstream_->connection_, readDisable(true));
+    session_ = SpliceSession::start(downstream_->connection_, upstream_->connection_, callbacks_);
+    ASSERT_NE(nullptr, session_);
+    EXPECT_TRUE(session_->active());
+  }
+
+  void send(os_fd_t fd, const std::string& data) {
+    ASSERT_EQ(data.size(), os_sys_calls_.send(fd, data.data(), data.size(), 0).return_value_);
+  }
+
+  // Runs the dispatcher until the given number of bytes arrives on the socket.
+  std::string receive(os_fd_t fd, size_t length) {
+    std::string received;
+    while (received.size() < length) {
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+      char buffer[4096];
+      const Api::SysCallSizeResult result = os_sys_calls_.recv(fd, buffer, sizeof(buffer), 0);
+      if (result.return_value_ > 0) {
+        received.append(buffer, result.return_value_);
+      }
+    }
+    return received;
+  }
+
+  Api::OsSysCalls& os_sys_calls_ = Api::OsSysCallsSingleton::get();
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  os_fd_t client_fd_;
+  os_fd_t server_fd_;
+  std::unique_ptr<SplicedConnection> downstream_;
+  std::unique_ptr<SplicedConnection> upstream_;
+  NiceMock<MockSpliceCallbacks> callbacks_;
+  SpliceSessionPtr session_;
+};
+
+TEST_F(SpliceSessionTest, SplicesBothDirections) {
+  uint64_t read[2] = {};
+  uint64_t written[2] = {};
+  ON_CALL(callbacks_, onSplicedBytesRead(_, _))
+      .WillByDefault(Invoke([&](SpliceSession::Side side, uint64_t bytes) {
+        read[static_cast<int>(side)] += bytes;
+      }));
+  ON_CALL(callbacks_, onSplicedBytesWritten(_, _))
+      .WillByDefault(Invoke([&](SpliceSession::Side side, uint64_t bytes) {
+        written[static_cast<int>(side)] += bytes;
+      }));
+  // Bytes already waiting in a socket are spliced as soon as the session starts.
+  send(client_fd_, "hello");
+  start();
+
+  EXPECT_EQ("hello", receive(server_fd_, 5));
+  send(server_fd_, "world!");
+  EXPECT_EQ("world!", receive(client_fd_, 6));
+
+  // More than a pipe holds, which the pump moves as the destination drains it.
+  const std::string large(1024 * 1024, 'a');
+  size_t sent = 0;
+  std::string received;
+  while (received.size() < large.size()) {
+    if (sent < large.size()) {
+      const Api::SysCallSizeResult result =
+          os_sys_calls_.send(client_fd_, large.data() + sent, large.size() - sent, 0);
+      if (result.return_value_ > 0) {
+        sent += result.return_value_;
+      }
+    }
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    char buffer[65536];
+    const Api::SysCallSizeResult result =
+        os_sys_calls_.recv(server_fd_, buffer, sizeof(buffer), 0);
+    if (result.return_value_ > 0) {
+      received.append(buffer, result.return_value_);
+    }
+  }
+  EXPECT_EQ(large, received);
+
+  const int downstream = static_cast<int>(SpliceSession::Side::Downstream);
+  const int upstream = static_cast<int>(SpliceSession::Side::Upstream);
+  EXPECT_EQ(5 + large.size(), read[downstream]);
+  EXPECT_EQ(5 + large.size(), written[upstream]);
+  EXPECT_EQ(6, read[upstream]);
+  EXPECT_EQ(6, written[downstream]);
+
+  EXPECT_CALL(callbacks_, onSpliceStopped(_, _))
+      .WillOnce(Invoke([](Buffer::Instance& downstream_data, Buffer::Instance& upstream_data) {
+        EXPECT_EQ(0, downstream_data.length());
+        EXPECT_EQ(0, upstream_data.length());
+      }));
+  EXPECT_CALL(downstream_->connection_, readDisable(false));
+  EXPECT_CALL(upstream_->connection_, readDisable(false));
+  session_->stop();
+  EXPECT_FALSE(session_->active());
+  // Stopping again does nothing.
+  session_->stop();
+}
+
+TEST_F(SpliceSessionTest, StopsAtEndOfStream) {
+  start();
+  send(client_fd_, "hello");
+  EXPECT_EQ("hello", receive(server_fd_, 5));
+
+  EXPECT_CALL(callbacks_, onSpliceStopped(_, _));
+  EXPECT_CALL(downstream_->connection_, readDisable(false));
+  EXPECT_CALL(upstream_->connection_, readDisable(false));
+  os_sys_calls_.shutdown(server_fd_, SHUT_WR);
+  while (session_->active()) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+}
+
+TEST_F(SpliceSessionTest, HandsBackTheBytesInThePipes) {
+  uint64_t read = 0;
+  uint64_t written = 0;
+  ON_CALL(callbacks_, onSplicedBytesRead(SpliceSession::Side::Downstream, _))
+      .WillByDefault(Invoke([&](SpliceSession::Side, uint64_t bytes) { read += bytes; }));
+  ON_CALL(callbacks_, onSplicedBytesWritten(SpliceSession::Side::Upstream, _))
+      .WillByDefault(Invoke([&](SpliceSession::Side, uint64_t bytes) { written += bytes; }));
+  start();
+
+  // The server does not read, so the upstream socket and then the pipe fill up.
+  const std::string data(4 * 1024 * 1024, 'a');
+  size_t sent = 0;
+  while (true) {
+    const Api::SysCallSizeResult result =
+        os_sys_calls_.send(client_fd_, data.data() + sent, data.size() - sent, 0);
+    if (result.return_value_ <= 0) {
+      break;
+    }
+    sent += result.return_value_;
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_GT(read, written);
+
+  uint64_t left = 0;
+  EXPECT_CALL(callbacks_, onSpliceStopped(_, _))
+      .WillOnce(Invoke([&](Buffer::Instance& downstream_data, Buffer::Instance& upstream_data) {
+        left = downstream_data.length();
+        EXPECT_EQ(0, upstream_data.length());
+      }));
+  EXPECT_CALL(downstream_->connection_, readDisable(false));
+  EXPECT_CALL(upstream_->connection_, readDisable(false));
+  session_->stop();
+  EXPECT_EQ(read, written + left);
+}
+
+TEST_F(SpliceSessionTest, DoesNotReadEnableClosedConnections) {
+  start();
+  EXPECT_CALL(callbacks_, onSpliceStopped(_, _));
+  upstream_->connection_.state_ = Network::Connection::State::Closed;
+  EXPECT_CALL(downstream_->connection_, readDisable(false));
+  EXPECT_CALL(upstream_->connection_, readDisable(false)).Times(0);
+  session_->stop();
+}
+
+} // namespace
+} // namespace TcpProxy
+} // namespace Envoy
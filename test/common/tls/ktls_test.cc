@@ -0,0 +1,390 @@
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "source/common/tls/ktls.h"
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/mocks/api/mocks.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "openssl/aead.h"
+#include "openssl/ssl.h"
+
+#if defined(__linux__) && !defined(ENVOY_SSL_OPENSSL)
+#include <linux/tls.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#endif
+
+using testing::_;
+using testing::Eq;
+using testing::Invoke;
+using testing::Return;
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+#if defined(__linux__) && !defined(ENVOY_SSL_OPENSSL)
+
+constexpr os_fd_t Fd = 42;
+
+// Runs a handshake between a client and a server over an in-memory BIO pair. The records the
+// client sends can then be read from the server's BIO.
+class KernelTlsTest : public testing::Test {
+protected:
+  void handshake(uint16_t version, const char* cipher_list = nullptr) {
+    client_ctx_.reset(SSL_CTX_new(TLS_method()));
+    server_ctx_.reset(SSL_CTX_new(TLS_method()));
+    for (SSL_CTX* ctx : {client_ctx_.get(), server_ctx_.get()}) {
+      ASSERT_TRUE(SSL_CTX_set_min_proto_version(ctx, version));
+      ASSERT_TRUE(SSL_CTX_set_max_proto_version(ctx, version));
+      if (cipher_list != nullptr) {
+        ASSERT_TRUE(SSL_CTX_set_strict_cipher_list(ctx, cipher_list));
+      }
+    }
+    const std::string cert_path =
+        TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/san_dns_cert.pem");
+    const std::string key_path =
+        TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/san_dns_key.pem");
+    ASSERT_TRUE(
+        SSL_CTX_use_certificate_file(server_ctx_.get(), cert_path.c_str(), SSL_FILETYPE_PEM));
+    ASSERT_TRUE(SSL_CTX_use_PrivateKey_file(server_ctx_.get(), key_path.c_str(), SSL_FILETYPE_PEM));
+
+    client_.reset(SSL_new(client_ctx_.get()));
+    server_.reset(SSL_new(server_ctx_.get()));
+    BIO* client_bio;
+    BIO* server_bio;
+    ASSERT_TRUE(BIO_new_bio_pair(&client_bio, 0, &server_bio, 0));
+    SSL_set_bio(client_.get(), client_bio, client_bio);
+    SSL_set_bio(server_.get(), server_bio, server_bio);
+    SSL_set_connect_state(client_.get());
+    SSL_set_accept_state(server_.get());
+
+    for (int i = 0; i < 10; ++i) {
+      const int client_rc = SSL_do_handshake(client_.get());
+      const int server_rc = SSL_do_handshake(server_.get());
+      if (client_rc == 1 && server_rc == 1) {
+        return;
+      }
+    }
+    FAIL() << "handshake did not complete";
+  }
+
+  // Sends data from the client, and returns the records it wrote.
+  std::string clientWrite(absl::string_view data) {
+    EXPECT_EQ(static_cast<int>(data.size()), SSL_write(client_.get(), data.data(), data.size()));
+    std::string records;
+    char buffer[4096];
+    int rc;
+    while ((rc = BIO_read(SSL_get_rbio(server_.get()), buffer, sizeof(buffer))) > 0) {
+      records.append(buffer, rc);
+    }
+    return records;
+  }
+
+  // Decrypts the record at the head of records with keys as the kernel would, and consumes both
+  // the record and its sequence number.
+  static std::string openRecord(KernelTlsKeys& keys, std::string& records, uint8_t& type) {
+    EXPECT_GE(records.size(), 5);
+    const auto* header = reinterpret_cast<const uint8_t*>(records.data());
+    const size_t length = (header[3] << 8) | header[4];
+    std::vector<uint8_t> body(records.begin() + 5, records.begin() + 5 + length);
+    const std::vector<uint8_t> header_bytes(header, header + 5);
+    records.erase(0, 5 + length);
+
+    uint8_t sequence[8];
+    for (int i = 0; i < 8; ++i) {
+      sequence[i] = keys.sequence_ >> (56 - 8 * i);
+    }
+    std::vector<uint8_t> nonce(12);
+    std::vector<uint8_t> ad;
+    if (keys.iv_.size() == 12) {
+      for (int i = 0; i < 12; ++i) {
+        nonce[i] = keys.iv_[i] ^ (i < 4 ? 0 : sequence[i - 4]);
+      }
+    } else {
+      // TLS 1.2 AES-GCM: the explicit nonce leads the record.
+      memcpy(nonce.data(), keys.iv_.data(), 4);
+      memcpy(nonce.data() + 4, body.data(), 8);
+      body.erase(body.begin(), body.begin() + 8);
+    }
+    if (keys.version_ == TLS1_3_VERSION) {
+      ad = header_bytes;
+    } else {
+      const size_t plaintext_length = body.size() - EVP_AEAD_DEFAULT_TAG_LENGTH;
+      ad.assign(sequence, sequence + 8);
+      ad.insert(ad.end(), header_bytes.begin(), header_bytes.begin() + 3);
+      ad.push_back(plaintext_length >> 8);
+      ad.push_back(plaintext_length & 0xff);
+    }
+
+    const EVP_AEAD* aead = keys.cipher_nid_ == NID_aes_128_gcm   ? EVP_aead_aes_128_gcm()
+                           : keys.cipher_nid_ == NID_aes_256_gcm ? EVP_aead_aes_256_gcm()
+                                                                 : EVP_aead_chacha20_poly1305();
+    bssl::ScopedEVP_AEAD_CTX ctx;
+    EXPECT_TRUE(EVP_AEAD_CTX_init(ctx.get(), aead, keys.key_.data(), keys.key_.size(),
+                                  EVP_AEAD_DEFAULT_TAG_LENGTH, nullptr));
+    std::vector<uint8_t> plaintext(body.size());
+    size_t plaintext_length = 0;
+    EXPECT_TRUE(EVP_AEAD_CTX_open(ctx.get(), plaintext.data(), &plaintext_length,
+                                  plaintext.size(), nonce.data(), nonce.size(), body.data(),
+                                  body.size(), ad.data(), ad.size()));
+    plaintext.resize(plaintext_length);
+    ++keys.sequence_;
+
+    type = header[0];
+    if (keys.version_ == TLS1_3_VERSION) {
+      while (!plaintext.empty() && plaintext.back() == 0) {
+        plaintext.pop_back();
+      }
+      type = plaintext.back();
+      plaintext.pop_back();
+    }
+    return {plaintext.begin(), plaintext.end()};
+  }
+
+  // Returns a recvmsg() that reads a record of the given type.
+  static auto controlRecord(uint8_t type, std::vector<uint8_t> payload) {
+    return [type, payload](os_fd_t, msghdr* message, int) {
+      memcpy(message->msg_iov[0].iov_base, payload.data(), payload.size());
+      cmsghdr* cmsg = CMSG_FIRSTHDR(message);
+      cmsg->cmsg_level = SOL_TLS;
+      cmsg->cmsg_type = TLS_GET_RECORD_TYPE;
+      cmsg->cmsg_len = CMSG_LEN(sizeof(uint8_t));
+      *CMSG_DATA(cmsg) = type;
+      return Api::SysCallSizeResult{static_cast<ssize_t>(payload.size()), 0};
+    };
+  }
+
+  KernelTlsPtr enable() {
+    EXPECT_CALL(os_sys_calls_, setsockopt_(Fd, IPPROTO_TCP, TCP_ULP, _, 3)).WillOnce(Return(0));
+    EXPECT_CALL(os_sys_calls_, setsockopt_(Fd, SOL_TLS, TLS_TX, _, _)).WillOnce(Return(0));
+    EXPECT_CALL(os_sys_calls_, setsockopt_(Fd, SOL_TLS, TLS_RX, _, _)).WillOnce(Return(0));
+    auto kernel_tls = KernelTls::enable(server_.get(), Fd, stats_);
+    EXPECT_TRUE(kernel_tls.ok()) << kernel_tls.status();
+    return kernel_tls.ok() ? std::move(kernel_tls.value()) : nullptr;
+  }
+
+  testing::NiceMock<Api::MockOsSysCalls> os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls_{&os_sys_calls_};
+  Stats::TestUtil::TestStore store_;
+  SslStats stats_{generateSslStats(*store_.rootScope())};
+  bssl::UniquePtr<SSL_CTX> client_ctx_;
+  bssl::UniquePtr<SSL_CTX> server_ctx_;
+  bssl::UniquePtr<SSL> client_;
+  bssl::UniquePtr<SSL> server_;
+};
+
+// The server's read keys are the client's write keys, and decrypt its records.
+TEST_F(KernelTlsTest, Tls13Keys) {
+  handshake(TLS1_3_VERSION);
+  auto client_keys = KernelTls::keys(client_.get(), /*write=*/true);
+  auto server_keys = KernelTls::keys(server_.get(), /*write=*/false);
+  ASSERT_TRUE(client_keys.ok());
+  ASSERT_TRUE(server_keys.ok());
+  EXPECT_EQ(client_keys->key_, server_keys->key_);
+  EXPECT_EQ(client_keys->iv_, server_keys->iv_);
+  EXPECT_EQ(client_keys->sequence_, server_keys->sequence_);
+  EXPECT_EQ(12, server_keys->iv_.size());
+
+  std::string records = clientWrite("hello");
+  uint8_t type;
+  EXPECT_EQ("hello", openRecord(server_keys.value(), records, type));
+  EXPECT_EQ(23, type);
+  EXPECT_TRUE(records.empty());
+}
+
+// The records following a key update decrypt with the updated keys.
+TEST_F(KernelTlsTest, Tls13KeyUpdate) {
+  handshake(TLS1_3_VERSION);
+  auto keys = KernelTls::keys(server_.get(), /*write=*/false);
+  ASSERT_TRUE(keys.ok());
+
+  ASSERT_TRUE(SSL_key_update(client_.get(), SSL_KEY_UPDATE_NOT_REQUESTED));
+  std::string records = clientWrite("after update");
+  uint8_t type;
+  EXPECT_EQ(std::string("\x18\x00\x00\x01\x00", 5), openRecord(keys.value(), records, type));
+  EXPECT_EQ(22, type);
+
+  ASSERT_TRUE(KernelTls::updateKeys(keys.value()).ok());
+  EXPECT_EQ(0, keys->sequence_);
+  EXPECT_EQ("after update", openRecord(keys.value(), records, type));
+  EXPECT_EQ(23, type);
+}
+
+TEST_F(KernelTlsTest, Tls12AesGcm) {
+  handshake(TLS1_2_VERSION, "ECDHE-RSA-AES128-GCM-SHA256");
+  auto keys = KernelTls::keys(server_.get(), /*write=*/false);
+  ASSERT_TRUE(keys.ok());
+  EXPECT_EQ(NID_aes_128_gcm, keys->cipher_nid_);
+  EXPECT_EQ(4, keys->iv_.size());
+  // The client's Finished message was the first record protected with the keys.
+  EXPECT_EQ(1, keys->sequence_);
+
+  std::string records = clientWrite("hello");
+  uint8_t type;
+  EXPECT_EQ("hello", openRecord(keys.value(), records, type));
+  EXPECT_EQ(23, type);
+}
+
+TEST_F(KernelTlsTest, Tls12ChaCha20Poly1305) {
+  handshake(TLS1_2_VERSION, "ECDHE-RSA-CHACHA20-POLY1305");
+  auto keys = KernelTls::keys(server_.get(), /*write=*/false);
+  ASSERT_TRUE(keys.ok());
+  EXPECT_EQ(NID_chacha20_poly1305, keys->cipher_nid_);
+  EXPECT_EQ(12, keys->iv_.size());
+
+  std::string records = clientWrite("hello");
+  uint8_t type;
+  EXPECT_EQ("hello", openRecord(keys.value(), records, type));
+}
+
+// The socket is left alone when the cipher cannot be offloaded.
+TEST_F(KernelTlsTest, UnsupportedCipher) {
+  handshake(TLS1_2_VERSION, "ECDHE-RSA-AES128-SHA");
+  EXPECT_EQ(absl::StatusCode::kUnavailable,
+            KernelTls::keys(server_.get(), /*write=*/false).status().code());
+  EXPECT_CALL(os_sys_calls_, setsockopt_(_, _, _, _, _)).Times(0);
+  EXPECT_EQ(absl::StatusCode::kUnavailable,
+            KernelTls::enable(server_.get(), Fd, stats_).status().code());
+}
+
+// Falls back when the kernel has no TLS module.
+TEST_F(KernelTlsTest, NoKernelSupport) {
+  handshake(TLS1_3_VERSION);
+  EXPECT_CALL(os_sys_calls_, setsockopt_(Fd, IPPROTO_TCP, TCP_ULP, _, _)).WillOnce(Return(-1));
+  EXPECT_CALL(os_sys_calls_, setsockopt_(Fd, SOL_TLS, _, _, _)).Times(0);
+  EXPECT_EQ(absl::StatusCode::kUnavailable,
+            KernelTls::enable(server_.get(), Fd, stats_).status().code());
+}
+
+// The connection is unusable once the kernel encrypts the sent records but fails to decrypt the
+// received ones.
+TEST_F(KernelTlsTest, ReceiveKeysRejected) {
+  handshake(TLS1_3_VERSION);
+  EXPECT_CALL(os_sys_calls_, setsockopt_(Fd, IPPROTO_TCP, TCP_ULP, _, _)).WillOnce(Return(0));
+  EXPECT_CALL(os_sys_calls_, setsockopt_(Fd, SOL_TLS, TLS_TX, _, _)).WillOnce(Return(0));
+  EXPECT_CALL(os_sys_calls_, setsockopt_(Fd, SOL_TLS, TLS_RX, _, _)).WillOnce(Return(-1));
+  EXPECT_EQ(absl::StatusCode::kInternal,
+            KernelTls::enable(server_.get(), Fd, stats_).status().code());
+}
+
+// The kernel is given the negotiated keys.
+TEST_F(KernelTlsTest, InstallsKeys) {
+  handshake(TLS1_3_VERSION);
+  auto write_keys = KernelTls::keys(server_.get(), /*write=*/true);
+  ASSERT_TRUE(write_keys.ok());
+  if (write_keys->cipher_nid_ != NID_aes_128_gcm) {
+    GTEST_SKIP() << "BoringSSL prefers ChaCha20-Poly1305 without AES hardware support";
+  }
+
+  tls12_crypto_info_aes_gcm_128 crypto_info;
+  EXPECT_CALL(os_sys_calls_, setsockopt_(Fd, IPPROTO_TCP, TCP_ULP, _, 3)).WillOnce(Return(0));
+  EXPECT_CALL(os_sys_calls_, setsockopt_(Fd, SOL_TLS, TLS_TX, _, Eq(sizeof(crypto_info))))
+      .WillOnce(Invoke([&](os_fd_t, int, int, const void* optval, socklen_t) {
+        memcpy(&crypto_info, optval, sizeof(crypto_info));
+        return 0;
+      }));
+  EXPECT_CALL(os_sys_calls_, setsockopt_(Fd, SOL_TLS, TLS_RX, _, _)).WillOnce(Return(0));
+  ASSERT_TRUE(KernelTls::enable(server_.get(), Fd, stats_).ok());
+
+  EXPECT_EQ(TLS_1_3_VERSION, crypto_info.info.version);
+  EXPECT_EQ(TLS_CIPHER_AES_GCM_128, crypto_info.info.cipher_type);
+  EXPECT_EQ(0, memcmp(crypto_info.key, write_keys->key_.data(), sizeof(crypto_info.key)));
+  EXPECT_EQ(0, memcmp(crypto_info.salt, write_keys->iv_.data(), sizeof(crypto_info.salt)));
+  EXPECT_EQ(0, memcmp(crypto_info.iv, write_keys->iv_.data() + 4, sizeof(crypto_info.iv)));
+}
+
+TEST_F(KernelTlsTest, CloseNotify) {
+  handshake(TLS1_3_VERSION);
+  KernelTlsPtr kernel_tls = enable();
+  ASSERT_NE(nullptr, kernel_tls);
+
+  EXPECT_CALL(os_sys_calls_, recvmsg(Fd, _, _)).WillOnce(Invoke(controlRecord(21, {1, 0})));
+  EXPECT_EQ(KernelTls::ControlRecordAction::EndStream, kernel_tls->readControlRecord());
+
+  EXPECT_CALL(os_sys_calls_, sendmsg(Fd, _, _))
+      .WillOnce(Invoke([](os_fd_t, const msghdr* message, int) {
+        const cmsghdr* cmsg = CMSG_FIRSTHDR(message);
+        EXPECT_EQ(TLS_SET_RECORD_TYPE, cmsg->cmsg_type);
+        EXPECT_EQ(21, *CMSG_DATA(cmsg));
+        return Api::SysCallSizeResult{2, 0};
+      }));
+  kernel_tls->sendCloseNotify();
+}
+
+TEST_F(KernelTlsTest, FatalAlert) {
+  handshake(TLS1_3_VERSION);
+  KernelTlsPtr kernel_tls = enable();
+  ASSERT_NE(nullptr, kernel_tls);
+
+  EXPECT_CALL(os_sys_calls_, recvmsg(Fd, _, _)).WillOnce(Invoke(controlRecord(21, {2, 40})));
+  EXPECT_EQ(KernelTls::ControlRecordAction::Close, kernel_tls->readControlRecord());
+  EXPECT_EQ("kernel_TLS_error:received alert 40", kernel_tls->failureReason());
+}
+
+TEST_F(KernelTlsTest, SessionTicketDropped) {
+  handshake(TLS1_3_VERSION);
+  KernelTlsPtr kernel_tls = enable();
+  ASSERT_NE(nullptr, kernel_tls);
+
+  EXPECT_CALL(os_sys_calls_, setsockopt_(_, _, _, _, _)).Times(0);
+  EXPECT_CALL(os_sys_calls_, recvmsg(Fd, _, _))
+      .WillOnce(Invoke(controlRecord(22, {4, 0, 0, 2, 0xab, 0xcd})));
+  EXPECT_EQ(KernelTls::ControlRecordAction::Continue, kernel_tls->readControlRecord());
+}
+
+// A key update requested by the peer updates the keys of both directions.
+TEST_F(KernelTlsTest, KeyUpdateRequested) {
+  handshake(TLS1_3_VERSION);
+  KernelTlsPtr kernel_tls = enable();
+  ASSERT_NE(nullptr, kernel_tls);
+
+  testing::InSequence s;
+  EXPECT_CALL(os_sys_calls_, recvmsg(Fd, _, _))
+      .WillOnce(Invoke(controlRecord(22, {24, 0, 0, 1, 1})));
+  EXPECT_CALL(os_sys_calls_, setsockopt_(Fd, SOL_TLS, TLS_RX, _, _)).WillOnce(Return(0));
+  EXPECT_CALL(os_sys_calls_, sendmsg(Fd, _, _))
+      .WillOnce(Invoke([](os_fd_t, const msghdr* message, int) {
+        EXPECT_EQ(std::string("\x18\x00\x00\x01\x00", 5),
+                  std::string(static_cast<const char*>(message->msg_iov[0].iov_base),
+                              message->msg_iov[0].iov_len));
+        return Api::SysCallSizeResult{5, 0};
+      }));
+  EXPECT_CALL(os_sys_calls_, setsockopt_(Fd, SOL_TLS, TLS_TX, _, _)).WillOnce(Return(0));
+  EXPECT_EQ(KernelTls::ControlRecordAction::Continue, kernel_tls->readControlRecord());
+  EXPECT_EQ(2, stats_.kernel_tls_key_update_.value());
+}
+
+TEST_F(KernelTlsTest, FragmentedHandshakeMessage) {
+  handshake(TLS1_3_VERSION);
+  KernelTlsPtr kernel_tls = enable();
+  ASSERT_NE(nullptr, kernel_tls);
+
+  EXPECT_CALL(os_sys_calls_, recvmsg(Fd, _, _))
+      .WillOnce(Invoke(controlRecord(22, {4, 0, 1, 0, 0xab})));
+  EXPECT_EQ(KernelTls::ControlRecordAction::Close, kernel_tls->readControlRecord());
+  EXPECT_EQ("kernel_TLS_error:handshake message split across records",
+            kernel_tls->failureReason());
+}
+
+#else
+
+TEST(KernelTlsTest, Unsupported) {
+  EXPECT_EQ(absl::StatusCode::kUnavailable, KernelTls::keys(nullptr, true).status().code());
+}
+
+#endif
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,173 @@
+// Compares the throughput of a TLS connection over loopback TCP when BoringSSL protects the records
+// and when they are offloaded to the kernel. The kernel TLS cases are skipped when the kernel lacks
+// the tls module.
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/common/tls/ktls.h"
+
+#include "test/test_common/environment.h"
+
+#include "benchmark/benchmark.h"
+#include "openssl/err.h"
+#include "openssl/ssl.h"
+#include "tools/cpp/runfiles/runfiles.h"
+
+namespace Envoy {
+namespace Extensions::TransportSockets::Tls {
+
+// Returns a connected pair of non-blocking loopback TCP sockets.
+static std::pair<int, int> tcpSocketPair() {
+  int listener = socket(AF_INET, SOCK_STREAM, 0);
+  RELEASE_ASSERT(listener >= 0, "socket");
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t address_length = sizeof(address);
+  RELEASE_ASSERT(bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0,
+                 "bind");
+  RELEASE_ASSERT(listen(listener, 1) == 0, "listen");
+  RELEASE_ASSERT(
+      getsockname(listener, reinterpret_cast<sockaddr*>(&address), &address_length) == 0,
+      "getsockname");
+  int client = socket(AF_INET, SOCK_STREAM, 0);
+  RELEASE_ASSERT(connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0,
+                 "connect");
+  int server = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK);
+  RELEASE_ASSERT(server >= 0, "accept");
+  ::close(listener);
+  RELEASE_ASSERT(fcntl(client, F_SETFL, O_NONBLOCK) == 0, "fcntl");
+  for (int fd : {client, server}) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  }
+  return {client, server};
+}
+
+static bool handshake(SSL* client, SSL* server) {
+  for (int i = 0; i < 50; i++) {
+    const int client_rc = SSL_do_handshake(client);
+    const int server_rc = SSL_do_handshake(server);
+    if (client_rc == 1 && server_rc == 1) {
+      return true;
+    }
+    for (auto [ssl, rc] : {std::make_pair(client, client_rc), std::make_pair(server, server_rc)}) {
+      const int error = SSL_get_error(ssl, rc);
+      if (error != SSL_ERROR_NONE && error != SSL_ERROR_WANT_READ &&
+          error != SSL_ERROR_WANT_WRITE) {
+        return false;
+      }
+    }
+  }
+  return false;
+}
+
+// state.range(0): 0 for BoringSSL, 1 for kernel TLS.
+// state.range(1): the TLS version.
+// state.range(2): the size of the writes.
+static void testThroughput(benchmark::State& state) {
+  std::string error;
+  std::unique_ptr<bazel::tools::cpp::runfiles::Runfiles> runfiles(
+      bazel::tools::cpp::runfiles::Runfiles::Create("ktls_throughput_benchmark", &error));
+  Envoy::TestEnvironment::setRunfiles(runfiles.get());
+
+  const bool kernel_tls = state.range(0);
+  const uint16_t version = state.range(1);
+  const size_t write_size = state.range(2);
+
+  bssl::UniquePtr<SSL_CTX> server_ctx(SSL_CTX_new(TLS_method()));
+  bssl::UniquePtr<SSL_CTX> client_ctx(SSL_CTX_new(TLS_method()));
+  for (SSL_CTX* ctx : {server_ctx.get(), client_ctx.get()}) {
+    SSL_CTX_set_min_proto_version(ctx, version);
+    SSL_CTX_set_max_proto_version(ctx, version);
+    SSL_CTX_set_strict_cipher_list(ctx, "ECDHE-RSA-AES128-GCM-SHA256");
+  }
+  std::string cert_path =
+      TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/san_dns_cert.pem");
+  std::string key_path =
+      TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/san_dns_key.pem");
+  RELEASE_ASSERT(
+      SSL_CTX_use_certificate_file(server_ctx.get(), cert_path.c_str(), SSL_FILETYPE_PEM) > 0,
+      "SSL_CTX_use_certificate_file");
+  RELEASE_ASSERT(
+      SSL_CTX_use_PrivateKey_file(server_ctx.get(), key_path.c_str(), SSL_FILETYPE_PEM) > 0,
+      "SSL_CTX_use_PrivateKey_file");
+
+  auto [client_fd, server_fd] = tcpSocketPair();
+  bssl::UniquePtr<SSL> server_ssl(SSL_new(server_ctx.get()));
+  SSL_set_fd(server_ssl.get(), server_fd);
+  SSL_set_accept_state(server_ssl.get());
+  bssl::UniquePtr<SSL> client_ssl(SSL_new(client_ctx.get()));
+  SSL_set_fd(client_ssl.get(), client_fd);
+  SSL_set_connect_state(client_ssl.get());
+  RELEASE_ASSERT(handshake(client_ssl.get(), server_ssl.get()), "handshake");
+
+  Stats::IsolatedStoreImpl store;
+  SslStats stats = generateSslStats(*store.rootScope());
+  KernelTlsPtr client_kernel_tls;
+  KernelTlsPtr server_kernel_tls;
+  if (kernel_tls) {
+    auto client_result = KernelTls::enable(client_ssl.get(), client_fd, stats);
+    auto server_result = KernelTls::enable(server_ssl.get(), server_fd, stats);
+    if (!client_result.ok() || !server_result.ok()) {
+      state.SkipWithError("kernel TLS is not available");
+      ::close(client_fd);
+      ::close(server_fd);
+      return;
+    }
+    client_kernel_tls = std::move(client_result.value());
+    server_kernel_tls = std::move(server_result.value());
+  }
+
+  const std::string data(write_size, 'a');
+  static uint8_t read_buf[1024 * 1024];
+  // Sends 16 MiB per iteration, reading whenever the socket buffers fill up.
+  constexpr size_t BytesPerIteration = 16 << 20;
+  uint64_t bytes_transferred = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    size_t written = 0;
+    size_t read = 0;
+    while (read < BytesPerIteration) {
+      while (written < BytesPerIteration) {
+        const int rc = kernel_tls ? ::write(client_fd, data.data(), data.size())
+                                  : SSL_write(client_ssl.get(), data.data(), data.size());
+        if (rc <= 0) {
+          break;
+        }
+        written += rc;
+      }
+      const int rc = kernel_tls ? ::read(server_fd, read_buf, sizeof(read_buf))
+                                : SSL_read(server_ssl.get(), read_buf, sizeof(read_buf));
+      if (rc > 0) {
+        read += rc;
+      }
+    }
+    bytes_transferred += read;
+  }
+  state.counters["throughput"] =
+      benchmark::Counter(bytes_transferred, benchmark::Counter::kIsRate);
+
+  ::close(client_fd);
+  ::close(server_fd);
+}
+
+static void testParams(benchmark::internal::Benchmark* b) {
+  for (int kernel_tls : {0, 1}) {
+    for (int version : {TLS1_2_VERSION, TLS1_3_VERSION}) {
+      for (int write_size : {4096, 16384, 65536}) {
+        b->Args({kernel_tls, version, write_size});
+      }
+    }
+  }
+}
+
+BENCHMARK(testThroughput)->Unit(::benchmark::kMillisecond)->Apply(testParams);
+
+} // namespace Extensions::TransportSockets::Tls
+} // namespace Envoy
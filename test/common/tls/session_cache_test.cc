@@ -0,0 +1,167 @@
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "source/common/common/hash.h"
+#include "source/common/singleton/manager_impl.h"
+#include "source/common/tls/session_cache.h"
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+using Direction = SessionCache::Direction;
+
+class SessionCacheTest : public testing::Test {
+protected:
+  SessionCacheTest() : ssl_ctx_(SSL_CTX_new(TLS_method())) {}
+
+  void initialize(uint32_t max_sessions) {
+    config_.mutable_max_sessions()->set_value(max_sessions);
+    cache_ = std::make_unique<SessionCache>(config_, *store_.rootScope());
+  }
+
+  bssl::UniquePtr<SSL_SESSION> newSession(uint16_t version = TLS1_2_VERSION) {
+    bssl::UniquePtr<SSL_SESSION> session(SSL_SESSION_new(ssl_ctx_.get()));
+    EXPECT_EQ(1, SSL_SESSION_set_protocol_version(session.get(), version));
+    return session;
+  }
+
+  // Inserts a new session and returns it, the cache holding another reference to it.
+  SSL_SESSION* insert(Direction direction, absl::string_view key,
+                      uint32_t max_sessions_per_key = 1) {
+    bssl::UniquePtr<SSL_SESSION> session = newSession();
+    SSL_SESSION* raw = session.get();
+    cache_->insert(direction, key, std::move(session), max_sessions_per_key);
+    return raw;
+  }
+
+  uint64_t counter(const std::string& name) {
+    return store_.counter(absl::StrCat("tls_session_cache.", name)).value();
+  }
+
+  uint64_t sessionsGauge() {
+    return store_.gauge("tls_session_cache.sessions", Stats::Gauge::ImportMode::NeverImport)
+        .value();
+  }
+
+  Stats::TestUtil::TestStore store_;
+  envoy::config::bootstrap::v3::Bootstrap::TlsSessionCache config_;
+  bssl::UniquePtr<SSL_CTX> ssl_ctx_;
+  std::unique_ptr<SessionCache> cache_;
+};
+
+TEST_F(SessionCacheTest, LookupReturnsTheNewestSession) {
+  initialize(100);
+  EXPECT_EQ(nullptr, cache_->lookup(Direction::Upstream, "a"));
+  EXPECT_EQ(1, counter("upstream_miss"));
+
+  insert(Direction::Upstream, "a", 2);
+  SSL_SESSION* newest = insert(Direction::Upstream, "a", 2);
+  EXPECT_EQ(newest, cache_->lookup(Direction::Upstream, "a").get());
+  // Reusable sessions stay in the cache.
+  EXPECT_EQ(newest, cache_->lookup(Direction::Upstream, "a").get());
+  EXPECT_EQ(2, counter("upstream_hit"));
+  EXPECT_EQ(2, cache_->size());
+  EXPECT_EQ(2, sessionsGauge());
+}
+
+TEST_F(SessionCacheTest, DirectionsDoNotShareKeys) {
+  initialize(100);
+  SSL_SESSION* downstream = insert(Direction::Downstream, "a");
+  SSL_SESSION* upstream = insert(Direction::Upstream, "a");
+  EXPECT_EQ(downstream, cache_->lookup(Direction::Downstream, "a").get());
+  EXPECT_EQ(upstream, cache_->lookup(Direction::Upstream, "a").get());
+  EXPECT_EQ(nullptr, cache_->lookup(Direction::Downstream, "b"));
+  EXPECT_EQ(1, counter("downstream_hit"));
+  EXPECT_EQ(1, counter("downstream_miss"));
+  EXPECT_EQ(1, counter("upstream_hit"));
+  EXPECT_EQ(0, counter("upstream_miss"));
+}
+
+TEST_F(SessionCacheTest, BoundsTheSessionsPerKey) {
+  initialize(100);
+  insert(Direction::Upstream, "a", 2);
+  SSL_SESSION* second = insert(Direction::Upstream, "a", 2);
+  SSL_SESSION* third = insert(Direction::Upstream, "a", 2);
+  EXPECT_EQ(2, cache_->size());
+  // Dropping the oldest session of a key is not an eviction.
+  EXPECT_EQ(0, counter("evicted"));
+
+  // A single-use session is removed when looked up, the next one then being returned.
+  SSL_SESSION_set_protocol_version(third, TLS1_3_VERSION);
+  EXPECT_EQ(third, cache_->lookup(Direction::Upstream, "a").get());
+  EXPECT_EQ(second, cache_->lookup(Direction::Upstream, "a").get());
+  EXPECT_EQ(1, cache_->size());
+  EXPECT_EQ(1, sessionsGauge());
+}
+
+TEST_F(SessionCacheTest, EvictsTheLeastRecentlyUsedSessions) {
+  // A single shard, so that all the keys compete for the same room.
+  initialize(1);
+  insert(Direction::Upstream, "a");
+  insert(Direction::Upstream, "b");
+  EXPECT_EQ(nullptr, cache_->lookup(Direction::Upstream, "a"));
+  EXPECT_NE(nullptr, cache_->lookup(Direction::Upstream, "b"));
+  EXPECT_EQ(1, counter("evicted"));
+  EXPECT_EQ(1, sessionsGauge());
+}
+
+TEST_F(SessionCacheTest, LookupRefreshesTheSession) {
+  // 16 shards of 2 sessions.
+  initialize(32);
+  // Three keys of the same shard, as the cache picks it.
+  std::vector<std::string> keys;
+  const uint64_t shard = HashUtil::xxHash64("ukey0") % 16;
+  for (int i = 0; keys.size() < 3; ++i) {
+    const std::string key = absl::StrCat("key", i);
+    if (HashUtil::xxHash64(absl::StrCat("u", key)) % 16 == shard) {
+      keys.push_back(key);
+    }
+  }
+
+  SSL_SESSION* first = insert(Direction::Upstream, keys[0]);
+  insert(Direction::Upstream, keys[1]);
+  EXPECT_EQ(first, cache_->lookup(Direction::Upstream, keys[0]).get());
+  SSL_SESSION* third = insert(Direction::Upstream, keys[2]);
+  EXPECT_EQ(nullptr, cache_->lookup(Direction::Upstream, keys[1]));
+  EXPECT_EQ(first, cache_->lookup(Direction::Upstream, keys[0]).get());
+  EXPECT_EQ(third, cache_->lookup(Direction::Upstream, keys[2]).get());
+  EXPECT_EQ(1, counter("evicted"));
+}
+
+TEST_F(SessionCacheTest, RejectsSessionsThatCannotBeParsed) {
+  config_.set_persist_across_hot_restart(true);
+  initialize(100);
+  EXPECT_TRUE(cache_->persistAcrossHotRestart());
+  EXPECT_FALSE(cache_->importSession("ua", "not a session"));
+  EXPECT_EQ(0, cache_->size());
+  EXPECT_EQ(0, counter("imported"));
+}
+
+TEST_F(SessionCacheTest, IsASingleton) {
+  Singleton::ManagerImpl singleton_manager;
+  EXPECT_EQ(nullptr, SessionCache::get(singleton_manager));
+  SessionCacheSharedPtr cache =
+      SessionCache::create(config_, singleton_manager, *store_.rootScope());
+  EXPECT_EQ(cache, SessionCache::get(singleton_manager));
+  // The cache is pinned, it outlives the contexts that use it.
+  cache.reset();
+  EXPECT_NE(nullptr, SessionCache::get(singleton_manager));
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -14,6 +14,7 @@
 #include "source/common/event/dispatcher_impl.h"
 #include "source/common/json/json_loader.h"
 #include "source/common/network/address_impl.h"
+#include "source/common/network/io_socket_handle_impl.h"
 #include "source/common/network/listen_socket_impl.h"
 #include "source/common/network/tcp_listener_impl.h"
 #include "source/common/network/transport_socket_options_impl.h"
@@ -27,6 +28,7 @@
 #include "source/common/tls/private_key/private_key_manager_impl.h"
 #include "source/common/tls/server_context_config_impl.h"
 #include "source/common/tls/server_ssl_socket.h"
+#include "source/common/tls/session_cache.h"
 
 #include "test/common/tls/cert_validator/timed_cert_validator.h"
 #include "test/common/tls/ssl_certs_test.h"
@@ -48,6 +50,7 @@
 #include "test/common/tls/test_data/selfsigned_cert_info.h"
 #include "test/common/tls/test_data/selfsigned_ecdsa_p256_cert_info.h"
 #include "test/common/tls/test_private_key_method_provider.h"
+#include "test/mocks/api/mocks.h"
 #include "test/mocks/buffer/mocks.h"
 #include "test/mocks/init/mocks.h"
 #include "test/mocks/local_info/mocks.h"
@@ -62,8 +65,10 @@
 #include "test/test_common/network_utility.h"
 #include "test/test_common/registry.h"
 #include "test/test_common/test_runtime.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_replace.h"
@@ -72,6 +77,12 @@
 #include "openssl/crypto.h"
 #include "openssl/ssl.h"
 
+#if defined(__linux__) && !defined(ENVOY_SSL_OPENSSL)
+#include <linux/tls.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#endif
+
 using testing::_;
 using testing::ContainsRegex;
 using testing::DoAll;
@@ -6077,6 +6088,143 @@ TEST_P(SslSocketTest, ClientSessionCacheReusesAcrossSniWhenSniScopeDisabled) {
   testClientSessionResumptionSniSequence(server_ctx_yaml, client_ctx_yaml, {0, 1, 2}, version_);
 }
 
+// Connects twice, with contexts created anew for each connection as on a configuration update, so
+// that only the process-wide session cache can resume the session of the first connection. With
+// hot_restart, the second connection is made by the contexts of another process, whose cache
+// imports the sessions exported by the cache of the first one.
+void testSharedSessionCacheResumption(const std::string& server_ctx_yaml,
+                                      const std::string& client_ctx_yaml, bool hot_restart,
+                                      const Network::Address::IpVersion version) {
+  Event::SimulatedTimeSystem time_system;
+  NiceMock<Server::Configuration::MockServerFactoryContext> server_factory_contexts[2];
+  envoy::config::bootstrap::v3::Bootstrap::TlsSessionCache cache_config;
+  cache_config.set_persist_across_hot_restart(hot_restart);
+  Stats::TestUtil::TestStore cache_stats_store;
+  SessionCacheSharedPtr session_cache = SessionCache::create(
+      cache_config, server_factory_contexts[0].singletonManager(), *cache_stats_store.rootScope());
+
+  Stats::TestUtil::TestStore server_stats_store;
+  Api::ApiPtr server_api = Api::createApiForTest(server_stats_store, time_system);
+  NiceMock<Server::Configuration::MockTransportSocketFactoryContext>
+      transport_socket_factory_context;
+  ON_CALL(transport_socket_factory_context.server_context_, api())
+      .WillByDefault(ReturnRef(*server_api));
+  envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext server_tls_context;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(server_ctx_yaml), server_tls_context);
+
+  Stats::TestUtil::TestStore client_stats_store;
+  Api::ApiPtr client_api = Api::createApiForTest(client_stats_store, time_system);
+  NiceMock<Server::Configuration::MockTransportSocketFactoryContext> client_factory_context;
+  ON_CALL(client_factory_context.server_context_, api()).WillByDefault(ReturnRef(*client_api));
+  envoy::extensions::transport_sockets::tls::v3::UpstreamTlsContext client_tls_context;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(client_ctx_yaml), client_tls_context);
+
+  auto socket = std::make_shared<Network::Test::TcpListenSocketImmediateListen>(
+      Network::Test::getCanonicalLoopbackAddress(version));
+  NiceMock<Network::MockTcpListenerCallbacks> callbacks;
+  Event::DispatcherPtr dispatcher(server_api->allocateDispatcher("test_thread"));
+  NiceMock<Runtime::MockLoader> runtime;
+  NiceMock<Network::MockListenerConfig> listener_config;
+  Server::ThreadLocalOverloadStateOptRef overload_state;
+  Network::ListenerPtr listener =
+      createListener(socket, callbacks, runtime, listener_config, overload_state,
+                     server_api->randomGenerator(), *dispatcher);
+
+  for (int i = 0; i < 2; ++i) {
+    NiceMock<Server::Configuration::MockServerFactoryContext>& server_factory_context =
+        server_factory_contexts[hot_restart ? i : 0];
+    if (hot_restart && i == 1) {
+      SessionCacheSharedPtr child_session_cache =
+          SessionCache::create(cache_config, server_factory_context.singletonManager(),
+                               *cache_stats_store.rootScope());
+      session_cache->exportSessions([&](absl::string_view key, absl::string_view session) {
+        EXPECT_TRUE(child_session_cache->importSession(key, session));
+      });
+      // The session of the server and the one of the client.
+      EXPECT_EQ(2, child_session_cache->size());
+    }
+    ContextManagerImpl manager(server_factory_context);
+    auto server_cfg = *ServerContextConfigImpl::create(server_tls_context,
+                                                       transport_socket_factory_context, {}, false);
+    auto server_ssl_socket_factory = *ServerSslSocketFactory::create(
+        std::move(server_cfg), manager, *server_stats_store.rootScope());
+    auto client_cfg = *ClientContextConfigImpl::create(client_tls_context, client_factory_context);
+    auto client_ssl_socket_factory = *ClientSslSocketFactory::create(
+        std::move(client_cfg), manager, *client_stats_store.rootScope());
+
+    NiceMock<Network::MockConnectionCallbacks> server_connection_callbacks;
+    NiceMock<Network::MockConnectionCallbacks> client_connection_callbacks;
+    StreamInfo::StreamInfoImpl stream_info(time_system, nullptr,
+                                           StreamInfo::FilterState::LifeSpan::Connection);
+    Network::ConnectionPtr server_connection;
+    Network::ClientConnectionPtr client_connection = dispatcher->createClientConnection(
+        socket->connectionInfoProvider().localAddress(),
+        Network::Address::InstanceConstSharedPtr(),
+        client_ssl_socket_factory->createTransportSocket(nullptr, nullptr), nullptr, nullptr);
+    client_connection->addConnectionCallbacks(client_connection_callbacks);
+    client_connection->connect();
+
+    EXPECT_CALL(callbacks, onAccept_(_))
+        .WillOnce(Invoke([&](Network::ConnectionSocketPtr& socket) -> void {
+          server_connection = dispatcher->createServerConnection(
+              std::move(socket), server_ssl_socket_factory->createDownstreamTransportSocket(),
+              stream_info);
+          server_connection->addConnectionCallbacks(server_connection_callbacks);
+        }));
+    size_t connect_count = 0;
+    auto connected = [&](Network::ConnectionEvent) -> void {
+      if (++connect_count == 2) {
+        client_connection->close(Network::ConnectionCloseType::NoFlush);
+        server_connection->close(Network::ConnectionCloseType::NoFlush);
+        dispatcher->exit();
+      }
+    };
+    EXPECT_CALL(server_connection_callbacks, onEvent(Network::ConnectionEvent::Connected))
+        .WillOnce(Invoke(connected));
+    EXPECT_CALL(client_connection_callbacks, onEvent(Network::ConnectionEvent::Connected))
+        .WillOnce(Invoke(connected));
+
+    dispatcher->run(Event::Dispatcher::RunType::Block);
+  }
+
+  EXPECT_EQ(1UL, server_stats_store.counter("ssl.session_reused").value());
+  EXPECT_EQ(1UL, client_stats_store.counter("ssl.session_reused").value());
+  EXPECT_EQ(1UL, cache_stats_store.counter("tls_session_cache.downstream_hit").value());
+  EXPECT_EQ(1UL, cache_stats_store.counter("tls_session_cache.upstream_hit").value());
+  EXPECT_EQ(hot_restart ? 2UL : 0UL,
+            cache_stats_store.counter("tls_session_cache.imported").value());
+}
+
+const std::string SharedSessionCacheServerCtxYaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_maximum_protocol_version: TLSv1_2
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_key.pem"
+  disable_stateless_session_resumption: true
+)EOF";
+
+const std::string SharedSessionCacheClientCtxYaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_maximum_protocol_version: TLSv1_2
+)EOF";
+
+// The sessions of the contexts of a previous configuration are resumed.
+TEST_P(SslSocketTest, SharedSessionCacheResumption) {
+  testSharedSessionCacheResumption(SharedSessionCacheServerCtxYaml,
+                                   SharedSessionCacheClientCtxYaml, false, version_);
+}
+
+// The sessions of the parent process are resumed.
+TEST_P(SslSocketTest, SharedSessionCacheResumptionAcrossHotRestart) {
+  testSharedSessionCacheResumption(SharedSessionCacheServerCtxYaml,
+                                   SharedSessionCacheClientCtxYaml, true, version_);
+}
+
 // Test client session resumption using default settings (should be enabled).
 TEST_P(SslSocketTest, ClientSessionResumptionDefault) {
   const std::string server_ctx_yaml = R"EOF(
@@ -9303,6 +9451,241 @@ TEST_P(SslSocketTest, DrainErrorQueuePrefersOtherTlsErrorOverEconnreset) {
               ContainsRegex("TLS_error:.*NO_SHARED_CIPHER"));
 }
 
+#if defined(__linux__) && !defined(ENVOY_SSL_OPENSSL)
+
+// Runs the handshake of a server SslSocket offloading its records to the kernel, with a BoringSSL
+// client on the other end of a socket pair. The kernel TLS socket options are mocked, so once
+// they are installed the socket carries the plaintext that the kernel would decrypt.
+class SslSocketKernelTlsTest : public SslCertsTest {
+protected:
+  SslSocketKernelTlsTest() {
+    ON_CALL(os_sys_calls_, readv(_, _, _))
+        .WillByDefault(Invoke([this](os_fd_t fd, const iovec* iov, int iovcnt) {
+          return os_sys_calls_actual_.readv(fd, iov, iovcnt);
+        }));
+    ON_CALL(os_sys_calls_, writev(_, _, _))
+        .WillByDefault(Invoke([this](os_fd_t fd, const iovec* iov, int iovcnt) {
+          return os_sys_calls_actual_.writev(fd, iov, iovcnt);
+        }));
+
+    envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext tls_context;
+    TestUtility::loadFromYaml(TestEnvironment::substitute(R"EOF(
+  common_tls_context:
+    kernel_tls_offload: true
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_key.pem"
+)EOF"),
+                              tls_context);
+    auto server_cfg = *ServerContextConfigImpl::create(tls_context, factory_context_, {}, false);
+    server_ssl_socket_factory_ = *ServerSslSocketFactory::create(std::move(server_cfg), manager_,
+                                                                 *server_stats_store_.rootScope());
+
+    int fds[2];
+    RELEASE_ASSERT(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0, "");
+    io_handle_ = std::make_unique<Network::IoSocketHandleImpl>(fds[0]);
+    client_fd_ = fds[1];
+    ON_CALL(callbacks_, ioHandle()).WillByDefault(ReturnRef(*io_handle_));
+    socket_ = server_ssl_socket_factory_->createDownstreamTransportSocket();
+    socket_->setTransportSocketCallbacks(callbacks_);
+
+    client_ctx_.reset(SSL_CTX_new(TLS_method()));
+    client_.reset(SSL_new(client_ctx_.get()));
+    SSL_set_fd(client_.get(), client_fd_);
+    SSL_set_connect_state(client_.get());
+  }
+
+  ~SslSocketKernelTlsTest() override {
+    client_.reset();
+    ::close(client_fd_);
+  }
+
+  // Returns the result of the server read that completes the handshake, and installs the keys.
+  Network::IoResult handshake() {
+    Buffer::OwnedImpl buffer;
+    for (int i = 0; i < 10; ++i) {
+      const int client_rc = SSL_do_handshake(client_.get());
+      Network::IoResult result = socket_->doRead(buffer);
+      if (client_rc == 1 || result.action_ == Network::PostIoAction::Close) {
+        return result;
+      }
+    }
+    ADD_FAILURE() << "handshake did not complete";
+    return {Network::PostIoAction::Close, 0, false};
+  }
+
+  void expectOffload() {
+    const os_fd_t fd = io_handle_->fdDoNotUse();
+    EXPECT_CALL(os_sys_calls_, setsockopt_(fd, IPPROTO_TCP, TCP_ULP, _, 3)).WillOnce(Return(0));
+    EXPECT_CALL(os_sys_calls_, setsockopt_(fd, SOL_TLS, TLS_TX, _, _)).WillOnce(Return(0));
+    EXPECT_CALL(os_sys_calls_, setsockopt_(fd, SOL_TLS, TLS_RX, _, _)).WillOnce(Return(0));
+  }
+
+  // Returns a recvmsg() that reads a record of the given type.
+  static auto controlRecord(uint8_t type, std::vector<uint8_t> payload) {
+    return [type, payload](os_fd_t, msghdr* message, int) {
+      memcpy(message->msg_iov[0].iov_base, payload.data(), payload.size());
+      cmsghdr* cmsg = CMSG_FIRSTHDR(message);
+      cmsg->cmsg_level = SOL_TLS;
+      cmsg->cmsg_type = TLS_GET_RECORD_TYPE;
+      cmsg->cmsg_len = CMSG_LEN(sizeof(uint8_t));
+      *CMSG_DATA(cmsg) = type;
+      return Api::SysCallSizeResult{static_cast<ssize_t>(payload.size()), 0};
+    };
+  }
+
+  // Returns the bytes the client socket has received.
+  std::string clientReceived() {
+    std::string received;
+    char buffer[4096];
+    ssize_t rc;
+    while ((rc = ::read(client_fd_, buffer, sizeof(buffer))) > 0) {
+      received.append(buffer, rc);
+    }
+    return received;
+  }
+
+  uint64_t counter(absl::string_view name) {
+    return server_stats_store_.counter(absl::StrCat("ssl.", name)).value();
+  }
+
+  NiceMock<Api::MockOsSysCalls> os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls_{&os_sys_calls_};
+  Api::OsSysCallsImpl os_sys_calls_actual_;
+  Stats::TestUtil::TestStore server_stats_store_;
+  ContextManagerImpl manager_{factory_context_.serverFactoryContext()};
+  Network::DownstreamTransportSocketFactoryPtr server_ssl_socket_factory_;
+  std::unique_ptr<Network::IoSocketHandleImpl> io_handle_;
+  NiceMock<Network::MockTransportSocketCallbacks> callbacks_;
+  Network::TransportSocketPtr socket_;
+  os_fd_t client_fd_;
+  bssl::UniquePtr<SSL_CTX> client_ctx_;
+  bssl::UniquePtr<SSL> client_;
+};
+
+TEST_F(SslSocketKernelTlsTest, OffloadsTheRecords) {
+  expectOffload();
+  EXPECT_EQ(Network::PostIoAction::KeepOpen, handshake().action_);
+  EXPECT_EQ(1UL, counter("kernel_tls_offload"));
+
+  // The kernel hands the decrypted records to the socket.
+  ASSERT_EQ(5, ::write(client_fd_, "hello", 5));
+  Buffer::OwnedImpl buffer;
+  Network::IoResult result = socket_->doRead(buffer);
+  EXPECT_EQ(Network::PostIoAction::KeepOpen, result.action_);
+  EXPECT_EQ(5UL, result.bytes_processed_);
+  EXPECT_FALSE(result.end_stream_read_);
+  EXPECT_EQ("hello", buffer.toString());
+}
+
+TEST_F(SslSocketKernelTlsTest, FallsBackWhenUnavailable) {
+  EXPECT_CALL(os_sys_calls_, setsockopt_(_, IPPROTO_TCP, TCP_ULP, _, 3)).WillOnce(Return(-1));
+  EXPECT_CALL(os_sys_calls_, setsockopt_(_, SOL_TLS, _, _, _)).Times(0);
+  EXPECT_EQ(Network::PostIoAction::KeepOpen, handshake().action_);
+  EXPECT_EQ(0UL, counter("kernel_tls_offload"));
+  EXPECT_EQ(1UL, counter("kernel_tls_fallback"));
+
+  // BoringSSL still owns the records.
+  ASSERT_EQ(5, SSL_write(client_.get(), "hello", 5));
+  Buffer::OwnedImpl buffer;
+  Network::IoResult result = socket_->doRead(buffer);
+  EXPECT_EQ(Network::PostIoAction::KeepOpen, result.action_);
+  EXPECT_EQ("hello", buffer.toString());
+}
+
+TEST_F(SslSocketKernelTlsTest, ClosesWhenTheKeysCannotBeInstalled) {
+  // The transmit keys are in the kernel, so BoringSSL can no longer be used.
+  EXPECT_CALL(os_sys_calls_, setsockopt_(_, IPPROTO_TCP, TCP_ULP, _, 3)).WillOnce(Return(0));
+  EXPECT_CALL(os_sys_calls_, setsockopt_(_, SOL_TLS, TLS_TX, _, _)).WillOnce(Return(0));
+  EXPECT_CALL(os_sys_calls_, setsockopt_(_, SOL_TLS, TLS_RX, _, _)).WillOnce(Return(-1));
+  EXPECT_EQ(Network::PostIoAction::Close, handshake().action_);
+  EXPECT_THAT(std::string(socket_->failureReason()),
+              testing::StartsWith("kernel_TLS_error:setsockopt(TLS_RX)"));
+  EXPECT_EQ(0UL, counter("kernel_tls_offload"));
+  EXPECT_EQ(0UL, counter("kernel_tls_fallback"));
+  EXPECT_EQ(1UL, counter("connection_error"));
+}
+
+TEST_F(SslSocketKernelTlsTest, ReadsControlRecordsUntilCloseNotify) {
+  expectOffload();
+  EXPECT_EQ(Network::PostIoAction::KeepOpen, handshake().action_);
+
+  // The kernel fails the reads of records that are not application data.
+  const os_fd_t fd = io_handle_->fdDoNotUse();
+  EXPECT_CALL(os_sys_calls_, readv(fd, _, _))
+      .Times(2)
+      .WillRepeatedly(Return(Api::SysCallSizeResult{-1, EIO}));
+  EXPECT_CALL(os_sys_calls_, setsockopt_(fd, SOL_TLS, TLS_RX, _, _)).WillOnce(Return(0));
+  EXPECT_CALL(os_sys_calls_, recvmsg(fd, _, _))
+      // A key update not requesting one in turn, then a close_notify alert.
+      .WillOnce(Invoke(controlRecord(22, {24, 0, 0, 1, 0})))
+      .WillOnce(Invoke(controlRecord(21, {1, 0})));
+  Buffer::OwnedImpl buffer;
+  Network::IoResult result = socket_->doRead(buffer);
+  EXPECT_EQ(Network::PostIoAction::KeepOpen, result.action_);
+  EXPECT_EQ(0UL, result.bytes_processed_);
+  EXPECT_TRUE(result.end_stream_read_);
+  EXPECT_EQ(1UL, counter("kernel_tls_key_update"));
+}
+
+TEST_F(SslSocketKernelTlsTest, ClosesOnAnAlert) {
+  expectOffload();
+  EXPECT_EQ(Network::PostIoAction::KeepOpen, handshake().action_);
+
+  const os_fd_t fd = io_handle_->fdDoNotUse();
+  EXPECT_CALL(os_sys_calls_, readv(fd, _, _))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, EIO}));
+  // A fatal handshake_failure alert.
+  EXPECT_CALL(os_sys_calls_, recvmsg(fd, _, _)).WillOnce(Invoke(controlRecord(21, {2, 40})));
+  Buffer::OwnedImpl buffer;
+  Network::IoResult result = socket_->doRead(buffer);
+  EXPECT_EQ(Network::PostIoAction::Close, result.action_);
+  EXPECT_FALSE(result.end_stream_read_);
+  EXPECT_EQ(1UL, counter("connection_error"));
+}
+
+TEST_F(SslSocketKernelTlsTest, WritesCloseNotifyAtEndStream) {
+  expectOffload();
+  EXPECT_EQ(Network::PostIoAction::KeepOpen, handshake().action_);
+
+  const os_fd_t fd = io_handle_->fdDoNotUse();
+  // The alert is sent once, closing the socket afterwards does not send it again.
+  EXPECT_CALL(os_sys_calls_, sendmsg(fd, _, _))
+      .WillOnce(Invoke([](os_fd_t, const msghdr* message, int) {
+        const cmsghdr* cmsg = CMSG_FIRSTHDR(message);
+        EXPECT_EQ(SOL_TLS, cmsg->cmsg_level);
+        EXPECT_EQ(TLS_SET_RECORD_TYPE, cmsg->cmsg_type);
+        EXPECT_EQ(21, *CMSG_DATA(cmsg));
+        const auto* alert = static_cast<const uint8_t*>(message->msg_iov[0].iov_base);
+        EXPECT_EQ(2UL, message->msg_iov[0].iov_len);
+        EXPECT_EQ(1, alert[0]);
+        EXPECT_EQ(0, alert[1]);
+        return Api::SysCallSizeResult{2, 0};
+      }));
+  Buffer::OwnedImpl buffer("hello");
+  Network::IoResult result = socket_->doWrite(buffer, true);
+  EXPECT_EQ(Network::PostIoAction::KeepOpen, result.action_);
+  EXPECT_EQ(5UL, result.bytes_processed_);
+  EXPECT_EQ(0UL, buffer.length());
+  // The kernel encrypts the plaintext written to the socket.
+  EXPECT_TRUE(absl::EndsWith(clientReceived(), "hello"));
+
+  socket_->closeSocket(Network::ConnectionEvent::LocalClose);
+}
+
+TEST_F(SslSocketKernelTlsTest, CloseSendsCloseNotify) {
+  expectOffload();
+  EXPECT_EQ(Network::PostIoAction::KeepOpen, handshake().action_);
+
+  EXPECT_CALL(os_sys_calls_, sendmsg(io_handle_->fdDoNotUse(), _, _))
+      .WillOnce(Return(Api::SysCallSizeResult{2, 0}));
+  socket_->closeSocket(Network::ConnectionEvent::LocalClose);
+}
+
+#endif
+
 } // namespace Tls
 } // namespace TransportSockets
 } // namespace Extensions
@@ -38,6 +38,45 @@ inline bssl::UniquePtr<STACK_OF(X509)> readCertChainFromFile(const std::string&
   return certChain;
 }
 
+// Returns the session a client establishes in an in-memory TLS 1.2 handshake, which unlike a
+// session from SSL_SESSION_new() can be resumed and serialized.
+inline bssl::UniquePtr<SSL_SESSION> makeResumableSession() {
+  bssl::UniquePtr<SSL_CTX> server_ctx(SSL_CTX_new(TLS_method()));
+  const std::string cert_path =
+      TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/unittest_cert.pem");
+  const std::string key_path =
+      TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/unittest_key.pem");
+  RELEASE_ASSERT(SSL_CTX_use_certificate_chain_file(server_ctx.get(), cert_path.c_str()) == 1,
+                 "SSL_CTX_use_certificate_chain_file");
+  RELEASE_ASSERT(
+      SSL_CTX_use_PrivateKey_file(server_ctx.get(), key_path.c_str(), SSL_FILETYPE_PEM) == 1,
+      "SSL_CTX_use_PrivateKey_file");
+  bssl::UniquePtr<SSL_CTX> client_ctx(SSL_CTX_new(TLS_method()));
+  // A TLS 1.3 client only gets its session in a ticket after the handshake.
+  RELEASE_ASSERT(SSL_CTX_set_max_proto_version(client_ctx.get(), TLS1_2_VERSION) == 1, "");
+
+  bssl::UniquePtr<SSL> client(SSL_new(client_ctx.get()));
+  bssl::UniquePtr<SSL> server(SSL_new(server_ctx.get()));
+  SSL_set_connect_state(client.get());
+  SSL_set_accept_state(server.get());
+  BIO* client_bio = nullptr;
+  BIO* server_bio = nullptr;
+  RELEASE_ASSERT(BIO_new_bio_pair(&client_bio, 0, &server_bio, 0) == 1, "BIO_new_bio_pair");
+  SSL_set_bio(client.get(), client_bio, client_bio);
+  SSL_set_bio(server.get(), server_bio, server_bio);
+
+  for (int i = 0; i < 10; i++) {
+    SSL_do_handshake(client.get());
+    SSL_do_handshake(server.get());
+    if (SSL_is_init_finished(client.get()) && SSL_is_init_finished(server.get())) {
+      break;
+    }
+  }
+  RELEASE_ASSERT(SSL_is_init_finished(client.get()) && SSL_is_init_finished(server.get()),
+                 "handshake did not complete");
+  return bssl::UniquePtr<SSL_SESSION>(SSL_get1_session(client.get()));
+}
+
 // Helper for downcasting a socket to a test socket so we can examine its
 // SSL_CTX.
 SSL_CTX* extractSslCtx(Network::TransportSocket* socket) {
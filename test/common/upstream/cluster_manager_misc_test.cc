@@ -5,6 +5,7 @@
 #include "source/common/upstream/load_balancer_factory_base.h"
 #include "source/extensions/load_balancing_policies/subset/subset_lb.h"
 
+#include "test/common/http/common.h"
 #include "test/common/upstream/cluster_manager_impl_test_common.h"
 #include "test/common/upstream/metadata_writer_lb.pb.h"
 #include "test/mocks/upstream/cluster_update_callbacks.h"
@@ -18,7 +19,9 @@ namespace Upstream {
 namespace {
 
 using ::testing::InSequence;
+using ::testing::Invoke;
 using ::testing::InvokeWithoutArgs;
+using ::testing::Ref;
 using ::testing::Return;
 using ::testing::ReturnNew;
 
@@ -1404,6 +1407,192 @@ TEST_F(PreconnectTest, PreconnectCappedByMaybePreconnect) {
   EXPECT_EQ(1, http_preconnect_calls);
 }
 
+// Runs the thread local cluster manager of a second worker next to that of the test thread, so
+// that the workers can borrow each other's connections.
+class SharedUpstreamConnectionsTest : public ClusterManagerImplTest {
+public:
+  ~SharedUpstreamConnectionsTest() override {
+    // The workers shut down before the cluster manager, as in the server.
+    worker_data_.clear();
+    cluster_manager_.reset();
+  }
+
+  void initialize(uint32_t concurrency) {
+    factory_.server_context_.options_.concurrency_ = concurrency;
+    // Keep the thread local initializers around to run them for the second worker.
+    factory_.tls_.defer_data_ = true;
+    create(defaultConfig());
+    factory_.tls_.defer_data_ = false;
+    initializers_ = std::move(factory_.tls_.deferred_data_);
+    factory_.tls_.deferred_data_.clear();
+    runInitializers(factory_.tls_.dispatcher_, factory_.tls_.data_);
+
+    ON_CALL(factory_.tls_, runOnAllThreads(_))
+        .WillByDefault(Invoke([this](std::function<void()> cb) {
+          cb();
+          if (worker_dispatcher_ != nullptr) {
+            runOnWorker(cb);
+          }
+        }));
+  }
+
+  // Starts the second worker, which registers as a shared connection owner.
+  void addWorker(const std::string& name) {
+    worker_dispatcher_ = std::make_unique<NiceMock<Event::MockDispatcher>>(name);
+    worker_data_.resize(factory_.tls_.data_.size());
+    runInitializers(*worker_dispatcher_, worker_data_);
+  }
+
+  void runInitializers(Event::Dispatcher& dispatcher,
+                       std::vector<ThreadLocal::ThreadLocalObjectSharedPtr>& data) {
+    for (size_t i = 0; i < initializers_.size(); ++i) {
+      if (initializers_[i]) {
+        data[i] = initializers_[i](dispatcher);
+      }
+    }
+  }
+
+  // Runs the callback with the thread local data of the second worker in place.
+  void runOnWorker(const std::function<void()>& cb) {
+    std::swap(factory_.tls_.data_, worker_data_);
+    cb();
+    std::swap(factory_.tls_.data_, worker_data_);
+  }
+
+  void addCluster() {
+    const std::string yaml = R"EOF(
+    name: cluster_1
+    connect_timeout: 0.250s
+    type: STATIC
+    lb_policy: ROUND_ROBIN
+    shared_upstream_connections:
+      owner_workers: 1
+    typed_extension_protocol_options:
+      envoy.extensions.upstreams.http.v3.HttpProtocolOptions:
+        "@type": type.googleapis.com/envoy.extensions.upstreams.http.v3.HttpProtocolOptions
+        explicit_http_config:
+          http2_protocol_options: {}
+    load_assignment:
+      cluster_name: cluster_1
+      endpoints:
+      - lb_endpoints:
+        - endpoint:
+            address:
+              socket_address:
+                address: 127.0.0.1
+                port_value: 11001
+    )EOF";
+    EXPECT_TRUE(*cluster_manager_->addOrUpdateCluster(parseClusterFromV3Yaml(yaml), "v1"));
+  }
+
+  std::optional<HttpPoolData> httpConnPool(ResourcePriority priority = ResourcePriority::Default) {
+    ThreadLocalCluster* cluster = cluster_manager_->getThreadLocalCluster("cluster_1");
+    return cluster->httpConnPool(cluster->chooseHost(nullptr).host, priority,
+                                 Http::Protocol::Http2, nullptr);
+  }
+
+  uint64_t handoffs() {
+    return cluster_manager_->getThreadLocalCluster("cluster_1")
+        ->info()
+        ->trafficStats()
+        ->upstream_rq_shared_handoff_.value();
+  }
+
+  std::vector<ThreadLocal::Slot::InitializeCb> initializers_;
+  std::unique_ptr<NiceMock<Event::MockDispatcher>> worker_dispatcher_;
+  std::vector<ThreadLocal::ThreadLocalObjectSharedPtr> worker_data_;
+  NiceMock<Http::MockResponseDecoder> decoder_;
+  ConnPoolCallbacks callbacks_;
+};
+
+// The owners are picked among all the workers, so the pools stay local until they have all
+// registered.
+TEST_F(SharedUpstreamConnectionsTest, OwnerSelection) {
+  initialize(2);
+  addCluster();
+  EXPECT_CALL(factory_, allocateConnPool_(_, _, _, _, _, _, _))
+      .WillOnce(ReturnNew<NiceMock<Http::ConnectionPool::MockInstance>>());
+  EXPECT_NE(nullptr, HttpPoolDataPeer::getPool(httpConnPool()));
+
+  // The first worker by name owns the connections of the single owner.
+  addWorker("a_worker");
+  EXPECT_CALL(factory_, allocateConnPool_(_, _, _, _, _, _, _)).Times(0);
+  std::optional<HttpPoolData> pool = httpConnPool(ResourcePriority::High);
+  ASSERT_TRUE(pool.has_value());
+  EXPECT_EQ(nullptr, HttpPoolDataPeer::getPool(pool));
+}
+
+// The streams of a worker run on the pool of the owner.
+TEST_F(SharedUpstreamConnectionsTest, Handoff) {
+  initialize(2);
+  addWorker("worker_1");
+  addCluster();
+
+  // The test thread sorts first, so it owns the connections and keeps its streams local.
+  EXPECT_CALL(factory_, allocateConnPool_(_, _, _, _, _, _, _))
+      .WillOnce(ReturnNew<NiceMock<Http::ConnectionPool::MockInstance>>());
+  Http::ConnectionPool::MockInstance* owner_pool = HttpPoolDataPeer::getPool(httpConnPool());
+  ASSERT_NE(nullptr, owner_pool);
+
+  NiceMock<Envoy::ConnectionPool::MockCancellable> owner_handle;
+  Http::ConnectionPool::Callbacks* owner_callbacks = nullptr;
+  EXPECT_CALL(*owner_pool, newStream(_, _, _))
+      .WillOnce(Invoke([&](Http::ResponseDecoder&, Http::ConnectionPool::Callbacks& callbacks,
+                           const Http::ConnectionPool::Instance::StreamOptions&) {
+        owner_callbacks = &callbacks;
+        return &owner_handle;
+      }));
+  runOnWorker([&]() {
+    std::optional<HttpPoolData> pool = httpConnPool();
+    ASSERT_TRUE(pool.has_value());
+    EXPECT_EQ(nullptr, HttpPoolDataPeer::getPool(pool));
+    EXPECT_NE(nullptr, pool->newStream(decoder_, callbacks_, {false, true}));
+  });
+  ASSERT_NE(nullptr, owner_callbacks);
+  EXPECT_EQ(1UL, handoffs());
+
+  NiceMock<Http::MockRequestEncoder> encoder;
+  NiceMock<StreamInfo::MockStreamInfo> info;
+  EXPECT_CALL(callbacks_.pool_ready_, ready());
+  owner_callbacks->onPoolReady(encoder, nullptr, info, Http::Protocol::Http2);
+  ASSERT_NE(nullptr, callbacks_.outer_encoder_);
+  EXPECT_NE(&encoder, callbacks_.outer_encoder_);
+
+  EXPECT_CALL(encoder.stream_, resetStream(Http::StreamResetReason::LocalReset));
+  callbacks_.outer_encoder_->getStream().resetStream(Http::StreamResetReason::LocalReset);
+}
+
+// The streams that the owner has no pool for, as it has yet to receive the cluster, run on a local
+// pool instead.
+TEST_F(SharedUpstreamConnectionsTest, OwnerWithoutCluster) {
+  initialize(2);
+  addCluster();
+  addWorker("a_worker");
+
+  auto* local_pool = new NiceMock<Http::ConnectionPool::MockInstance>();
+  EXPECT_CALL(factory_, allocateConnPool_(_, _, _, _, _, _, _)).WillOnce(Return(local_pool));
+  NiceMock<Envoy::ConnectionPool::MockCancellable> local_handle;
+  Http::ConnectionPool::Callbacks* local_callbacks = nullptr;
+  EXPECT_CALL(*local_pool, newStream(Ref(decoder_), _, _))
+      .WillOnce(Invoke([&](Http::ResponseDecoder&, Http::ConnectionPool::Callbacks& callbacks,
+                           const Http::ConnectionPool::Instance::StreamOptions&) {
+        local_callbacks = &callbacks;
+        return &local_handle;
+      }));
+  std::optional<HttpPoolData> pool = httpConnPool();
+  ASSERT_TRUE(pool.has_value());
+  EXPECT_EQ(nullptr, HttpPoolDataPeer::getPool(pool));
+  EXPECT_NE(nullptr, pool->newStream(decoder_, callbacks_, {false, true}));
+  ASSERT_NE(nullptr, local_callbacks);
+  EXPECT_EQ(1UL, handoffs());
+
+  NiceMock<Http::MockRequestEncoder> encoder;
+  NiceMock<StreamInfo::MockStreamInfo> info;
+  EXPECT_CALL(callbacks_.pool_ready_, ready());
+  local_callbacks->onPoolReady(encoder, nullptr, info, Http::Protocol::Http2);
+  EXPECT_EQ(&encoder, callbacks_.outer_encoder_);
+}
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
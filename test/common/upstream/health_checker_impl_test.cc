@@ -4958,6 +4958,73 @@ TEST_F(TcpHealthCheckerImplTest, SuccessProxyProtocol) {
   read_filter_->onData(response, false);
 }
 
+// Clusters with the same health check configuration share the checks of their common endpoints.
+TEST_F(TcpHealthCheckerImplTest, SharedAcrossClusters) {
+  InSequence s;
+
+  const std::string yaml = R"EOF(
+    timeout: 1s
+    interval: 1s
+    unhealthy_threshold: 2
+    healthy_threshold: 2
+    share_across_clusters: true
+    tcp_health_check: {}
+    )EOF";
+  auto shared_health_checks = std::make_shared<SharedHealthChecks>();
+  allocHealthChecker(yaml);
+  health_checker_->setSharedHealthChecks(shared_health_checks);
+  auto other_cluster = std::make_shared<NiceMock<MockClusterMockPrioritySet>>();
+  auto other_health_checker = std::make_shared<TcpHealthCheckerImpl>(
+      *other_cluster, parseHealthCheckFromV3Yaml(yaml), dispatcher_, runtime_, random_, nullptr);
+  other_health_checker->setSharedHealthChecks(shared_health_checks);
+
+  HostSharedPtr host = makeTestHost(cluster_->info_, "tcp://127.0.0.1:80");
+  host->healthFlagSet(Host::HealthFlag::FAILED_ACTIVE_HC);
+  cluster_->prioritySet().getMockHostSet(0)->hosts_ = {host};
+  HostSharedPtr other_host = makeTestHost(other_cluster->info_, "tcp://127.0.0.1:80");
+  other_host->healthFlagSet(Host::HealthFlag::FAILED_ACTIVE_HC);
+  other_cluster->prioritySet().getMockHostSet(0)->hosts_ = {other_host};
+
+  // The first cluster sends the checks.
+  expectSessionCreate();
+  expectClientCreate();
+  EXPECT_CALL(*timeout_timer_, enableTimer(_, _));
+  health_checker_->start();
+
+  // The other one waits for their results without connecting.
+  Event::MockTimer* other_interval_timer = new Event::MockTimer(&dispatcher_);
+  Event::MockTimer* other_timeout_timer = new Event::MockTimer(&dispatcher_);
+  EXPECT_CALL(*other_interval_timer, enableTimer(std::chrono::milliseconds(0), _));
+  EXPECT_CALL(*other_timeout_timer, enableTimer(_, _)).Times(0);
+  other_health_checker->start();
+  // There is no result to start with yet.
+  other_interval_timer->invokeCallback();
+  EXPECT_TRUE(other_host->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC));
+
+  EXPECT_CALL(*connection_, close(Network::ConnectionCloseType::Abort));
+  EXPECT_CALL(*timeout_timer_, disableTimer());
+  EXPECT_CALL(*interval_timer_, enableTimer(_, _));
+  connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  EXPECT_FALSE(host->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC));
+  EXPECT_FALSE(other_host->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC));
+  EXPECT_EQ(1UL, cluster_->info_->stats_store_.counter("health_check.attempt").value());
+  EXPECT_EQ(0UL, cluster_->info_->stats_store_.counter("health_check.shared_result").value());
+  EXPECT_EQ(0UL, other_cluster->info_->stats_store_.counter("health_check.attempt").value());
+  EXPECT_EQ(1UL, other_cluster->info_->stats_store_.counter("health_check.success").value());
+  EXPECT_EQ(1UL, other_cluster->info_->stats_store_.counter("health_check.shared_result").value());
+
+  // Once the first cluster no longer has the host, the other one sends the checks.
+  EXPECT_CALL(*other_interval_timer, enableTimer(_, _));
+  cluster_->prioritySet().getMockHostSet(0)->hosts_.clear();
+  cluster_->prioritySet().getMockHostSet(0)->runCallbacks({}, {host});
+
+  expectClientCreate();
+  EXPECT_CALL(*other_timeout_timer, enableTimer(_, _));
+  other_interval_timer->invokeCallback();
+  EXPECT_EQ(1UL, other_cluster->info_->stats_store_.counter("health_check.attempt").value());
+}
+
 TEST(Printer, HealthStatePrinter) {
   std::ostringstream healthy;
   healthy << HealthState::Healthy;
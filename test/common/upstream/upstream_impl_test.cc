@@ -6865,6 +6865,42 @@ TEST(HostPartitionTest, PartitionHosts) {
   EXPECT_EQ(hosts[5], update_hosts_params.excluded_hosts_per_locality->get()[1][2]);
 }
 
+// Verifies that repartitionHosts keeps the snapshots of the partitions a health change does not
+// affect.
+TEST(HostPartitionTest, RepartitionHostsKeepsUnchangedPartitions) {
+  std::shared_ptr<MockClusterInfo> info{new NiceMock<MockClusterInfo>()};
+  envoy::config::core::v3::Locality zone_a;
+  zone_a.set_zone("A");
+  envoy::config::core::v3::Locality zone_b;
+  zone_b.set_zone("B");
+  HostVector hosts{makeTestHost(info, "tcp://127.0.0.1:80", zone_a),
+                   makeTestHost(info, "tcp://127.0.0.1:81", zone_a),
+                   makeTestHost(info, "tcp://127.0.0.1:82", zone_b)};
+  hosts[1]->healthFlagSet(Host::HealthFlag::DEGRADED_ACTIVE_HC);
+
+  HostSetImpl host_set(0, std::nullopt, kDefaultOverProvisioningFactor);
+  host_set.updateHosts(
+      HostSetImpl::partitionHosts(std::make_shared<const HostVector>(hosts),
+                                  makeHostsPerLocality({{hosts[0], hosts[1]}, {hosts[2]}})),
+      nullptr, hosts, {});
+
+  hosts[2]->healthFlagSet(Host::HealthFlag::FAILED_ACTIVE_HC);
+  auto update_hosts_params = HostSetImpl::repartitionHosts(host_set);
+
+  EXPECT_EQ(host_set.hostsPtr(), update_hosts_params.hosts);
+  EXPECT_EQ(host_set.hostsPerLocalityPtr(), update_hosts_params.hosts_per_locality);
+  EXPECT_EQ(host_set.degradedHostsPtr(), update_hosts_params.degraded_hosts);
+  EXPECT_EQ(host_set.degradedHostsPerLocalityPtr(),
+            update_hosts_params.degraded_hosts_per_locality);
+
+  EXPECT_NE(host_set.healthyHostsPtr(), update_hosts_params.healthy_hosts);
+  EXPECT_EQ(HostVector{hosts[0]}, update_hosts_params.healthy_hosts->get());
+  EXPECT_NE(host_set.healthyHostsPerLocalityPtr(), update_hosts_params.healthy_hosts_per_locality);
+  EXPECT_EQ(0, update_hosts_params.healthy_hosts_per_locality->get()[1].size());
+  EXPECT_NE(host_set.excludedHostsPtr(), update_hosts_params.excluded_hosts);
+  EXPECT_EQ(HostVector{hosts[2]}, update_hosts_params.excluded_hosts->get());
+}
+
 TEST_F(ClusterInfoImplTest, MaxRequestsPerConnectionValidation) {
   const std::string yaml = R"EOF(
   name: cluster1
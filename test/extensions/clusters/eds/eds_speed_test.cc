@@ -13,10 +13,13 @@
 #include "source/common/config/protobuf_link_hacks.h"
 #include "source/common/config/utility.h"
 #include "source/common/singleton/manager_impl.h"
+#include "source/common/upstream/upstream_impl.h"
 #include "source/extensions/clusters/eds/eds.h"
 #include "source/extensions/config_subscription/grpc/grpc_mux_impl.h"
 #include "source/extensions/config_subscription/grpc/grpc_subscription_impl.h"
+#include "source/extensions/config_subscription/grpc/resource_decode_pool.h"
 #include "source/extensions/config_subscription/grpc/xds_mux/grpc_mux_impl.h"
+#include "source/extensions/load_balancing_policies/round_robin/round_robin_lb.h"
 #include "source/server/transport_socket_config_impl.h"
 
 #include "test/benchmark/main.h"
@@ -28,7 +31,9 @@
 #include "test/mocks/server/options.h"
 #include "test/mocks/server/server_factory_context.h"
 #include "test/mocks/upstream/cluster_manager.h"
+#include "test/mocks/upstream/health_checker.h"
 #include "test/test_common/test_runtime.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
 #include "benchmark/benchmark.h"
@@ -41,8 +46,8 @@ namespace Upstream {
 
 class EdsSpeedTest {
 public:
-  EdsSpeedTest(State& state, bool use_unified_mux)
-      : state_(state), use_unified_mux_(use_unified_mux),
+  EdsSpeedTest(State& state, bool use_unified_mux, bool offload_decoding = false)
+      : state_(state), use_unified_mux_(use_unified_mux), offload_decoding_(offload_decoding),
         type_url_("type.googleapis.com/envoy.config.endpoint.v3.ClusterLoadAssignment"),
         subscription_stats_(Config::Utility::generateStats(scope_)),
         async_client_(new Grpc::MockAsyncClient()),
@@ -66,7 +71,20 @@ public:
         /*backoff_strategy_=*/std::move(backoff_strategy),
         /*target_xds_authority_=*/"",
         /*eds_resources_cache_=*/nullptr,
-        /*skip_subsequent_node_=*/true};
+        /*skip_subsequent_node_=*/true,
+        /*load_stats_reporter_factory_=*/nullptr,
+        /*resource_decode_pool_=*/offload_decoding_
+            ? std::make_shared<Config::ResourceDecodePool>(Thread::threadFactoryForTest(), 1)
+            : nullptr};
+    if (offload_decoding_) {
+      // The pool posts its completions from its own thread, so they are run by
+      // receiveOffloadedResponse() instead.
+      ON_CALL(server_context_.dispatcher_, post(_))
+          .WillByDefault(testing::Invoke([this](Event::PostCb cb) {
+            absl::MutexLock lock(posted_mu_);
+            posted_.push_back(std::move(cb));
+          }));
+    }
     if (use_unified_mux_) {
       grpc_mux_ = std::make_shared<Config::XdsMux::GrpcMuxSotw>(grpc_mux_context);
     } else {
@@ -116,7 +134,17 @@ public:
   void priorityAndLocalityWeightedHelper(bool ignore_unknown_dynamic_fields, size_t num_hosts,
                                          bool healthy) {
     state_.PauseTiming();
+    // this is what we're actually testing:
+    validation_visitor_.setSkipValidation(ignore_unknown_dynamic_fields);
+    auto response = makeResponse(num_hosts, healthy, false);
+    state_.ResumeTiming();
+    receiveResponse(std::move(response));
+    ASSERT(cluster_->prioritySet().hostSetsPerPriority()[1]->hostsPerLocality().get()[0].size() ==
+           num_hosts);
+  }
 
+  std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>
+  makeResponse(size_t num_hosts, bool healthy, bool weighted) {
     envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment;
     cluster_load_assignment.set_cluster_name("fare");
 
@@ -141,17 +169,20 @@ public:
           lb_endpoint->mutable_endpoint()->mutable_address()->mutable_socket_address();
       socket_address->set_address("10.0.1." + std::to_string(i / 60000));
       socket_address->set_port_value((port + i) % 60000);
+      if (weighted) {
+        lb_endpoint->mutable_load_balancing_weight()->set_value(1 + i % 3);
+      }
     }
 
-    // this is what we're actually testing:
-    validation_visitor_.setSkipValidation(ignore_unknown_dynamic_fields);
-
     auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
     response->set_type_url(type_url_);
     response->set_version_info(fmt::format("version-{}", version_++));
     auto* resource = response->mutable_resources()->Add();
     std::ignore = resource->PackFrom(cluster_load_assignment);
-    state_.ResumeTiming();
+    return response;
+  }
+
+  void receiveResponse(std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse> response) {
     if (use_unified_mux_) {
       dynamic_cast<Config::XdsMux::GrpcMuxSotw&>(*grpc_mux_)
           .grpcStreamForTest()
@@ -161,15 +192,76 @@ public:
           .grpcStreamForTest()
           .onReceiveMessage(std::move(response));
     }
+  }
+
+  // Measures the time the main thread is blocked by an update, leaving out the time the resource
+  // decode pool spends parsing it when decoding is offloaded.
+  void mainThreadBlockingHelper(size_t num_hosts) {
+    state_.PauseTiming();
+    auto response = makeResponse(num_hosts, true, false);
+    state_.ResumeTiming();
+    receiveResponse(std::move(response));
+    if (offload_decoding_) {
+      state_.PauseTiming();
+      std::vector<Event::PostCb> completions;
+      {
+        absl::MutexLock lock(posted_mu_);
+        auto has_posted = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(posted_mu_) {
+          return !posted_.empty();
+        };
+        posted_mu_.Await(absl::Condition(&has_posted));
+        completions.swap(posted_);
+      }
+      state_.ResumeTiming();
+      for (Event::PostCb& completion : completions) {
+        completion();
+      }
+    }
     ASSERT(cluster_->prioritySet().hostSetsPerPriority()[1]->hostsPerLocality().get()[0].size() ==
            num_hosts);
   }
 
+  // A worker's copy of the cluster, with a round robin load balancer.
+  struct Worker {
+    PrioritySetImpl priority_set_;
+    std::unique_ptr<RoundRobinLoadBalancer> lb_;
+  };
+
+  // Creates num_workers copies of the cluster's host sets, kept up to date the way the cluster
+  // manager updates the thread local clusters of its workers.
+  void addWorkers(uint32_t num_workers) {
+    const auto& host_sets = cluster_->prioritySet().hostSetsPerPriority();
+    for (uint32_t i = 0; i < num_workers; ++i) {
+      auto& worker = workers_.emplace_back(std::make_unique<Worker>());
+      for (const auto& host_set : host_sets) {
+        worker->priority_set_.updateHosts(host_set->priority(),
+                                          HostSetImpl::updateHostsParams(*host_set),
+                                          host_set->localityWeights(), host_set->hosts(), {});
+      }
+      worker->lb_ = std::make_unique<RoundRobinLoadBalancer>(
+          worker->priority_set_, nullptr, cluster_->info()->lbStats(),
+          server_context_.runtime_loader_, random_, 50, round_robin_config_,
+          server_context_.time_system_);
+    }
+    worker_update_cb_ = cluster_->prioritySet().addPriorityUpdateCb(
+        [this](uint32_t priority, const HostVector& hosts_added, const HostVector& hosts_removed) {
+          const HostSet& host_set = *cluster_->prioritySet().hostSetsPerPriority()[priority];
+          for (auto& worker : workers_) {
+            worker->priority_set_.updateHosts(priority, HostSetImpl::updateHostsParams(host_set),
+                                              host_set.localityWeights(), hosts_added,
+                                              hosts_removed);
+          }
+        });
+  }
+
   NiceMock<Server::Configuration::MockServerFactoryContext> server_context_;
   Stats::TestUtil::TestStore& stats_ = server_context_.store_;
 
   State& state_;
   bool use_unified_mux_;
+  bool offload_decoding_;
+  absl::Mutex posted_mu_;
+  std::vector<Event::PostCb> posted_ ABSL_GUARDED_BY(posted_mu_);
   const std::string type_url_;
   uint64_t version_{};
   bool initialized_{};
@@ -190,6 +282,9 @@ public:
   Config::GrpcMuxSharedPtr grpc_mux_;
   Config::GrpcSubscriptionImplPtr subscription_;
   NiceMock<AccessLog::MockAccessLogManager> access_log_manager_;
+  envoy::extensions::load_balancing_policies::round_robin::v3::RoundRobin round_robin_config_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  Common::CallbackHandlePtr worker_update_cb_;
 };
 
 } // namespace Upstream
@@ -226,6 +321,28 @@ static void duplicateUpdate(State& state) {
   }
 }
 
+// Measures how long a large update blocks the main thread, with and without offloading the
+// decoding of its resources, see ApiConfigSource.offload_resource_decoding.
+static void mainThreadBlocking(State& state) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  const uint32_t endpoints = skipExpensiveBenchmarks() ? 1 : state.range(0);
+  std::unique_ptr<Envoy::Upstream::EdsSpeedTest> speed_test;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    // Destroys the previous iteration's cluster with the timer paused.
+    speed_test = std::make_unique<Envoy::Upstream::EdsSpeedTest>(state, false, state.range(1));
+    state.ResumeTiming();
+
+    speed_test->mainThreadBlockingHelper(endpoints);
+  }
+}
+
+BENCHMARK(mainThreadBlocking)
+    ->Ranges({{1, 100000}, {false, true}})
+    ->Unit(benchmark::kMillisecond);
+
 BENCHMARK(duplicateUpdate)->Ranges({{1, 100000}, {false, true}})->Unit(benchmark::kMillisecond);
 
 static void healthOnlyUpdate(State& state) {
@@ -242,3 +359,43 @@ static void healthOnlyUpdate(State& state) {
 }
 
 BENCHMARK(healthOnlyUpdate)->Ranges({{1, 100000}, {false, true}})->Unit(benchmark::kMillisecond);
+
+// Measures the cost of propagating health check flaps to the workers of a large cluster. Each flap
+// only changes the healthy partitions of the host's priority, so the workers' load balancers only
+// rebuild the schedulers of those partitions.
+static void healthCheckFlap(State& state) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  const uint32_t workers = state.range(0);
+  const uint32_t endpoints = skipExpensiveBenchmarks() ? 1 : state.range(1);
+  std::unique_ptr<Envoy::Upstream::EdsSpeedTest> speed_test;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    // Destroys the previous iteration's cluster with the timer paused.
+    speed_test = std::make_unique<Envoy::Upstream::EdsSpeedTest>(state, false);
+    speed_test->receiveResponse(speed_test->makeResponse(endpoints, true, true));
+    speed_test->addWorkers(workers);
+    auto health_checker = std::make_shared<NiceMock<Envoy::Upstream::MockHealthChecker>>();
+    speed_test->cluster_->setHealthChecker(health_checker);
+    const Envoy::Upstream::HostVector& hosts =
+        speed_test->cluster_->prioritySet().hostSetsPerPriority()[1]->hosts();
+    state.ResumeTiming();
+
+    for (uint32_t i = 0; i < 100; ++i) {
+      const Envoy::Upstream::HostSharedPtr& host = hosts[i % hosts.size()];
+      if (host->healthFlagGet(Envoy::Upstream::Host::HealthFlag::FAILED_ACTIVE_HC)) {
+        host->healthFlagClear(Envoy::Upstream::Host::HealthFlag::FAILED_ACTIVE_HC);
+      } else {
+        host->healthFlagSet(Envoy::Upstream::Host::HealthFlag::FAILED_ACTIVE_HC);
+      }
+      health_checker->runCallbacks(host, Envoy::Upstream::HealthTransition::Changed,
+                                   Envoy::Upstream::HealthState::Unhealthy);
+    }
+  }
+}
+
+BENCHMARK(healthCheckFlap)
+    ->Args({1, 50000})
+    ->Args({64, 50000})
+    ->Unit(benchmark::kMillisecond);
@@ -141,6 +141,63 @@ TEST_F(AsyncFileHandleTest, WriteReadClose) {
   close(handle);
 }
 
+TEST_F(AsyncFileHandleTest, ReadFileBackedReferencesTheFile) {
+  auto handle = createAnonymousFile();
+  absl::StatusOr<size_t> write_status;
+  Buffer::OwnedImpl hello("hello world");
+  ASSERT_OK(handle->write(dispatcher_.get(), hello, 0, [&](absl::StatusOr<size_t> status) {
+    write_status = std::move(status);
+  }));
+  resolveFileActions();
+  EXPECT_THAT(write_status, IsOkAndHolds(11U));
+  absl::StatusOr<Buffer::InstancePtr> read_status, past_end_status;
+  // The range is clamped to the end of the file.
+  ASSERT_OK(handle->readFileBacked(
+      dispatcher_.get(), 6, 100, nullptr,
+      [&](absl::StatusOr<Buffer::InstancePtr> status) { read_status = std::move(status); }));
+  resolveFileActions();
+  ASSERT_OK(read_status);
+  const std::optional<Buffer::FileRange> range = read_status.value()->frontFileRange();
+  ASSERT_TRUE(range.has_value());
+  EXPECT_EQ(6, range->offset_);
+  EXPECT_EQ(5, range->len_);
+  ASSERT_OK(handle->readFileBacked(
+      dispatcher_.get(), 20, 5, nullptr,
+      [&](absl::StatusOr<Buffer::InstancePtr> status) { past_end_status = std::move(status); }));
+  resolveFileActions();
+  ASSERT_OK(past_end_status);
+  EXPECT_EQ(0, past_end_status.value()->length());
+  close(handle);
+  // The buffer holds its own reference to the file, which it reads once its contents are needed.
+  EXPECT_THAT(*read_status.value(), BufferString("world"));
+}
+
+TEST_F(AsyncFileHandleTest, ReadFileBackedReportsATruncatedRange) {
+  auto handle = createAnonymousFile();
+  absl::StatusOr<size_t> write_status;
+  Buffer::OwnedImpl hello("hello world");
+  ASSERT_OK(handle->write(dispatcher_.get(), hello, 0, [&](absl::StatusOr<size_t> status) {
+    write_status = std::move(status);
+  }));
+  resolveFileActions();
+  EXPECT_THAT(write_status, IsOkAndHolds(11U));
+  absl::StatusOr<Buffer::InstancePtr> read_status;
+  int read_failures = 0;
+  ASSERT_OK(handle->readFileBacked(
+      dispatcher_.get(), 6, 5, [&]() { ++read_failures; },
+      [&](absl::StatusOr<Buffer::InstancePtr> status) { read_status = std::move(status); }));
+  resolveFileActions();
+  ASSERT_OK(read_status);
+  absl::Status truncate_status;
+  ASSERT_OK(handle->truncate(dispatcher_.get(), 8,
+                             [&](absl::Status status) { truncate_status = std::move(status); }));
+  resolveFileActions();
+  ASSERT_OK(truncate_status);
+  close(handle);
+  EXPECT_EQ(5, read_status.value()->toString().size());
+  EXPECT_EQ(1, read_failures);
+}
+
 TEST_F(AsyncFileHandleTest, LinkCreatesNamedFile) {
   auto handle = createAnonymousFile();
   absl::StatusOr<size_t> write_status;
@@ -14,6 +14,7 @@
 #include "source/common/protobuf/protobuf.h"
 #include "source/common/stats/isolated_store_impl.h"
 #include "source/extensions/config_subscription/grpc/grpc_mux_impl.h"
+#include "source/extensions/config_subscription/grpc/resource_decode_pool.h"
 
 #include "test/common/stats/stat_test_utility.h"
 #include "test/mocks/common.h"
@@ -30,8 +31,10 @@
 #include "test/test_common/status_utility.h"
 #include "test/test_common/test_runtime.h"
 #include "test/test_common/test_time.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_join.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -95,7 +98,9 @@ public:
             random_),
         /*target_xds_authority_=*/"",
         /*eds_resources_cache_=*/std::unique_ptr<MockEdsResourcesCache>(eds_resources_cache_),
-        /*skip_subsequent_node_=*/true};
+        /*skip_subsequent_node_=*/true,
+        /*load_stats_reporter_factory_=*/nullptr,
+        /*resource_decode_pool_=*/resource_decode_pool_};
     grpc_mux_ = std::make_unique<GrpcMuxImpl>(grpc_mux_context);
   }
 
@@ -148,6 +153,7 @@ public:
   NiceMock<MockXdsResourcesDelegate> resources_delegate_;
   bool use_config_tracker_{false};
   bool use_resources_delegate_{false};
+  ResourceDecodePoolSharedPtr resource_decode_pool_;
 };
 
 class GrpcMuxImplTest : public GrpcMuxImplTestBase {
@@ -683,6 +689,75 @@ TEST_P(GrpcMuxImplTest, WildcardWatch) {
   }
 }
 
+// Validate that the resources parsed by the resource decode pool are applied on the main thread,
+// in the order the responses were received, and acknowledged as usual.
+TEST_P(GrpcMuxImplTest, OffloadedResourceDecoding) {
+  resource_decode_pool_ = std::make_shared<ResourceDecodePool>(Thread::threadFactoryForTest(), 2);
+  setup();
+
+  const std::string& type_url = Config::TestTypeUrl::get().ClusterLoadAssignment;
+  OpaqueResourceDecoderSharedPtr resource_decoder(
+      std::make_shared<TestUtility::TestOpaqueResourceDecoderImpl<
+          envoy::config::endpoint::v3::ClusterLoadAssignment>>("cluster_name"));
+  auto foo_sub = grpc_mux_->addWatch(type_url, {}, callbacks_, resource_decoder, {});
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage(type_url, {}, "", true);
+  grpc_mux_->start();
+
+  // Holds the completions that the pool posts to the main thread, so that the test runs them.
+  absl::Mutex mu;
+  std::vector<Event::PostCb> posted;
+  EXPECT_CALL(dispatcher_, post(_)).WillRepeatedly(Invoke([&mu, &posted](Event::PostCb cb) {
+    absl::MutexLock lock(mu);
+    posted.push_back(std::move(cb));
+  }));
+
+  std::vector<std::string> updates;
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, _))
+      .WillRepeatedly(Invoke([&updates](const std::vector<DecodedResourceRef>& resources,
+                                        const std::string& version) {
+        std::vector<std::string> names;
+        for (const DecodedResourceRef& resource : resources) {
+          names.push_back(resource.get().name());
+        }
+        updates.push_back(absl::StrCat(version, ":", absl::StrJoin(names, ",")));
+        return absl::OkStatus();
+      }));
+
+  {
+    auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+    response->set_type_url(type_url);
+    response->set_version_info("1");
+    for (const char* name : {"x", "y", "z"}) {
+      envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+      load_assignment.set_cluster_name(name);
+      std::ignore = response->add_resources()->PackFrom(load_assignment);
+    }
+    grpc_mux_->grpcStreamForTest().onReceiveMessage(std::move(response));
+  }
+  {
+    // This one has nothing to parse, but still waits for the previous one.
+    auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+    response->set_type_url(type_url);
+    response->set_version_info("2");
+    grpc_mux_->grpcStreamForTest().onReceiveMessage(std::move(response));
+  }
+  EXPECT_TRUE(updates.empty());
+
+  std::vector<Event::PostCb> completions;
+  {
+    absl::MutexLock lock(mu);
+    auto has_posted = [&posted]() { return !posted.empty(); };
+    mu.Await(absl::Condition(&has_posted));
+    completions.swap(posted);
+  }
+  ASSERT_EQ(1, completions.size());
+  expectSendMessage(type_url, {}, "1");
+  expectSendMessage(type_url, {}, "2");
+  completions[0]();
+  EXPECT_THAT(updates, testing::ElementsAre("1:x,y,z", "2:"));
+}
+
 // Validate behavior when watches specify resources (potentially overlapping).
 TEST_P(GrpcMuxImplTest, WatchDemux) {
   setup();
@@ -0,0 +1,91 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Exercises the local rate limiter from many threads at once:
+//   * A shared token bucket, with and without leasing tokens to the threads.
+//   * The cache of dynamic descriptors, with a distinct descriptor per client.
+//
+// The buckets are large enough to never run dry, so every iteration takes the fast path.
+
+#include <optional>
+#include <vector>
+
+#include "source/common/common/utility.h"
+#include "source/extensions/filters/common/local_ratelimit/local_ratelimit_impl.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace LocalRateLimit {
+namespace {
+
+constexpr uint64_t UnlimitedTokens = 1ULL << 40;
+
+RealTimeSource time_source;
+std::optional<RateLimitTokenBucket> shared_bucket;
+
+void sharedBucketInit(const benchmark::State& state) {
+  shared_bucket.emplace(UnlimitedTokens, UnlimitedTokens, std::chrono::seconds(1), time_source,
+                        false, /*lease_tokens=*/state.range(0) != 0);
+}
+void sharedBucketDestroy(const benchmark::State&) { shared_bucket.reset(); }
+
+// All threads consume from the same bucket. Arg: whether the bucket leases tokens.
+void bmSharedTokenBucket(benchmark::State& state) {
+  for (auto _ : state) { // NOLINT
+    const bool allowed = shared_bucket->consume();
+    benchmark::DoNotOptimize(allowed);
+  }
+}
+BENCHMARK(bmSharedTokenBucket)
+    ->Arg(0)
+    ->Arg(1)
+    ->ThreadRange(1, 64)
+    ->UseRealTime()
+    ->Setup(sharedBucketInit)
+    ->Teardown(sharedBucketDestroy);
+
+std::optional<DynamicDescriptor> dynamic_descriptor;
+std::vector<RateLimit::Descriptor> clients;
+
+void dynamicDescriptorInit(const benchmark::State& state) {
+  const auto client_count = static_cast<uint32_t>(state.range(0));
+  dynamic_descriptor.emplace(UnlimitedTokens, UnlimitedTokens, std::chrono::seconds(1),
+                             client_count, time_source, false);
+  for (uint32_t i = 0; i < client_count; ++i) {
+    clients.push_back({{{"client", absl::StrCat("client-", i)}}});
+  }
+}
+void dynamicDescriptorDestroy(const benchmark::State&) {
+  dynamic_descriptor.reset();
+  clients.clear();
+}
+
+// Every thread cycles over the clients, starting at a different one, and consumes from the bucket
+// of each. Arg: the number of clients, which is also the size of the cache.
+void bmDynamicDescriptors(benchmark::State& state) {
+  size_t index = state.thread_index() * clients.size() / state.threads();
+  for (auto _ : state) { // NOLINT
+    const bool allowed = dynamic_descriptor->addOrGetDescriptor(clients[index])->consume();
+    benchmark::DoNotOptimize(allowed);
+    index = index + 1 == clients.size() ? 0 : index + 1;
+  }
+}
+BENCHMARK(bmDynamicDescriptors)
+    ->Arg(20)
+    ->Arg(10000)
+    ->ThreadRange(1, 64)
+    ->UseRealTime()
+    ->Setup(dynamicDescriptorInit)
+    ->Teardown(dynamicDescriptorDestroy);
+
+} // namespace
+} // namespace LocalRateLimit
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
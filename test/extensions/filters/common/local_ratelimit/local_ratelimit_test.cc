@@ -4,6 +4,7 @@
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/upstream/cluster_manager.h"
 #include "test/mocks/upstream/cluster_priority_set.h"
+#include "test/test_common/simulated_time_system.h"
 #include "test/test_common/test_runtime.h"
 #include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
@@ -828,6 +829,95 @@ TEST_F(LocalRateLimiterDescriptorImplTest, IsNegativeRefillsTokens) {
   EXPECT_EQ(result.token_bucket_context->remainingTokens(), 2);
 }
 
+// Verify that a bucket leasing tokens allows max_tokens at once, and only takes the refilled tokens
+// from the shared bucket afterwards.
+TEST(RateLimitTokenBucketTest, LeaseTokens) {
+  Event::SimulatedTimeSystem time_system;
+  // Large enough to lease 8 tokens to each of up to 64 workers.
+  RateLimitTokenBucket bucket(8192, 1024, std::chrono::seconds(1), time_system, false, true);
+  ASSERT_GT(bucket.leaseSize(), 0);
+  EXPECT_EQ(8192, bucket.maxTokens());
+  EXPECT_NEAR(8192, bucket.remainingTokens(), 1);
+
+  uint64_t allowed = 0;
+  while (bucket.consume()) {
+    ++allowed;
+  }
+  EXPECT_NEAR(8192, allowed, 1);
+  EXPECT_EQ(0, bucket.remainingTokens());
+
+  time_system.advanceTimeWait(std::chrono::seconds(1));
+  allowed = 0;
+  while (bucket.consume()) {
+    ++allowed;
+  }
+  EXPECT_NEAR(1024, allowed, 1);
+
+  // Buckets too small to give each worker a few tokens do not lease.
+  RateLimitTokenBucket small_bucket(50, 50, std::chrono::seconds(1), time_system, false, true);
+  EXPECT_EQ(0, small_bucket.leaseSize());
+}
+
+// Verify that the workers take over the leftover tokens of each other, so that they are allowed
+// max_tokens in total.
+TEST(RateLimitTokenBucketTest, LeaseTokensAcrossWorkers) {
+  Event::SimulatedTimeSystem time_system;
+  RateLimitTokenBucket bucket(8192, 1, std::chrono::seconds(60), time_system, false, true);
+  ASSERT_GT(bucket.leaseSize(), 0);
+
+  std::atomic<uint64_t> allowed{0};
+  std::vector<Thread::ThreadPtr> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.push_back(Thread::threadFactoryForTest().createThread([&]() {
+      while (bucket.consume()) {
+        allowed++;
+      }
+    }));
+  }
+  for (auto& thread : threads) {
+    thread->join();
+  }
+  EXPECT_NEAR(8192, allowed.load(), 1);
+  EXPECT_EQ(0, bucket.remainingTokens());
+}
+
+// Verify that the cache of dynamic descriptors gives the descriptors used since the last eviction
+// a second chance.
+TEST(DynamicDescriptorTest, ClockEviction) {
+  Event::SimulatedTimeSystem time_system;
+  DynamicDescriptor cache(1, 1, std::chrono::seconds(1), 2, time_system, false);
+  const RateLimit::Descriptor a{{{"user", "A"}}};
+  const RateLimit::Descriptor b{{{"user", "B"}}};
+  const RateLimit::Descriptor c{{{"user", "C"}}};
+
+  const auto bucket_a = cache.addOrGetDescriptor(a);
+  const auto bucket_b = cache.addOrGetDescriptor(b);
+  EXPECT_EQ(bucket_a, cache.addOrGetDescriptor(a));
+
+  // A was used since B was added, so C evicts B.
+  const auto bucket_c = cache.addOrGetDescriptor(c);
+  EXPECT_EQ(bucket_a, cache.addOrGetDescriptor(a));
+  EXPECT_NE(bucket_b, cache.addOrGetDescriptor(b));
+  // B in turn evicts C, which was not used since.
+  EXPECT_NE(bucket_c, cache.addOrGetDescriptor(c));
+}
+
+// Verify that large caches of dynamic descriptors, which are sharded, keep their descriptors.
+TEST(DynamicDescriptorTest, ShardedCache) {
+  Event::SimulatedTimeSystem time_system;
+  DynamicDescriptor cache(1, 1, std::chrono::seconds(1), 1000, time_system, false);
+
+  std::vector<RateLimit::Descriptor> descriptors;
+  std::vector<RateLimitTokenBucketSharedPtr> buckets;
+  for (int i = 0; i < 100; ++i) {
+    descriptors.push_back({{{"user", absl::StrCat("user-", i)}}});
+    buckets.push_back(cache.addOrGetDescriptor(descriptors.back()));
+  }
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(buckets[i], cache.addOrGetDescriptor(descriptors[i]));
+  }
+}
+
 } // Namespace LocalRateLimit
 } // namespace Common
 } // namespace Filters
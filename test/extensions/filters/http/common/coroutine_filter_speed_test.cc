@@ -0,0 +1,154 @@
+// Compares a decoder filter written as a callback state machine against the same filter written
+// with CoroutineDecoderFilter: both make one asynchronous call per request. Reports the bytes held
+// per in-flight request (including the filter itself) and, for the coroutine filter, how many
+// frames did not fit in the per-filter arena.
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "envoy/common/pure.h"
+
+#include "source/common/coroutine/leaf_awaitable.h"
+#include "source/common/memory/stats.h"
+#include "source/extensions/filters/http/common/coroutine_filter.h"
+#include "source/extensions/filters/http/common/pass_through_filter.h"
+
+#include "test/benchmark/main.h"
+#include "test/mocks/http/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Common {
+namespace {
+
+class FakeCallbacks {
+public:
+  virtual ~FakeCallbacks() = default;
+  virtual void onComplete() PURE;
+};
+
+// Stands in for an asynchronous client; completes all pending calls on demand.
+class FakeClient {
+public:
+  void call(FakeCallbacks& callbacks) { pending_.push_back(&callbacks); }
+  void completeAll() {
+    for (FakeCallbacks* callbacks : pending_) {
+      callbacks->onComplete();
+    }
+    pending_.clear();
+  }
+
+private:
+  std::vector<FakeCallbacks*> pending_;
+};
+
+class CallbackFilter : public Http::PassThroughDecoderFilter, public FakeCallbacks {
+public:
+  explicit CallbackFilter(FakeClient& client) : client_(client) {}
+
+  Http::FilterHeadersStatus decodeHeaders(Http::RequestHeaderMap&, bool) override {
+    state_ = State::Calling;
+    initiating_call_ = true;
+    client_.call(*this);
+    initiating_call_ = false;
+    return state_ == State::Calling ? Http::FilterHeadersStatus::StopIteration
+                                    : Http::FilterHeadersStatus::Continue;
+  }
+
+  void onComplete() override {
+    state_ = State::Complete;
+    if (!initiating_call_) {
+      decoder_callbacks_->continueDecoding();
+    }
+  }
+
+private:
+  enum class State { NotStarted, Calling, Complete };
+
+  FakeClient& client_;
+  State state_{State::NotStarted};
+  bool initiating_call_{};
+};
+
+class CallAwaitable : public Coroutine::LeafAwaitable<absl::Status>, public FakeCallbacks {
+public:
+  explicit CallAwaitable(FakeClient& client) : client_(client) {}
+
+  void onComplete() override { complete(absl::OkStatus()); }
+
+protected:
+  void onStart() override { client_.call(*this); }
+  void onCancel() override {}
+
+private:
+  FakeClient& client_;
+};
+
+class CoroutineFilter : public CoroutineDecoderFilter {
+public:
+  explicit CoroutineFilter(FakeClient& client) : client_(client) {}
+
+protected:
+  Coroutine::Task<absl::Status> decodeRequest(Coroutine::FrameArena& arena,
+                                              Http::RequestHeaderMap&, bool) override {
+    co_return co_await call(arena);
+  }
+
+private:
+  Coroutine::Task<absl::Status> call(Coroutine::FrameArena&) {
+    CallAwaitable awaitable(client_);
+    co_return co_await awaitable;
+  }
+
+  FakeClient& client_;
+};
+
+template <class FilterType> void bmInFlightRequests(benchmark::State& state) {
+  const uint64_t requests = skipExpensiveBenchmarks() ? 1 : state.range(0);
+  testing::NiceMock<Http::MockStreamDecoderFilterCallbacks> callbacks;
+  Http::TestRequestHeaderMapImpl headers{{":path", "/"}};
+  FakeClient client;
+  std::vector<std::unique_ptr<FilterType>> filters;
+  filters.reserve(requests);
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    const size_t start_mem = Memory::Stats::totalCurrentlyAllocated();
+    for (uint64_t i = 0; i < requests; ++i) {
+      filters.push_back(std::make_unique<FilterType>(client));
+      filters.back()->setDecoderFilterCallbacks(callbacks);
+      filters.back()->decodeHeaders(headers, true);
+    }
+    state.PauseTiming();
+    const size_t end_mem = Memory::Stats::totalCurrentlyAllocated();
+    state.counters["bytes_per_request"] = (end_mem - start_mem) / requests;
+    state.ResumeTiming();
+
+    client.completeAll();
+    uint64_t frame_heap_allocations = 0;
+    for (auto& filter : filters) {
+      filter->onDestroy();
+      if constexpr (std::is_same_v<FilterType, CoroutineFilter>) {
+        frame_heap_allocations += filter->frameArena().heapAllocations();
+      }
+    }
+    filters.clear();
+    state.counters["frame_heap_allocations"] = frame_heap_allocations;
+  }
+}
+
+void bmCallbackFilter(benchmark::State& state) { bmInFlightRequests<CallbackFilter>(state); }
+BENCHMARK(bmCallbackFilter)->Arg(1)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+void bmCoroutineFilter(benchmark::State& state) { bmInFlightRequests<CoroutineFilter>(state); }
+BENCHMARK(bmCoroutineFilter)->Arg(1)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace Common
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,251 @@
+#include <memory>
+#include <optional>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/coroutine/leaf_awaitable.h"
+#include "source/extensions/filters/http/common/coroutine_filter.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "absl/functional/any_invocable.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Common {
+namespace {
+
+// Stands in for an asynchronous client call whose completion the test drives.
+struct CallController {
+  bool started = false;
+  bool cancelled = false;
+  // When set, the call completes inside onStart() with this value.
+  std::optional<absl::Status> complete_inline;
+  absl::AnyInvocable<void(absl::Status)> completer;
+
+  void completeWith(absl::Status status) {
+    absl::AnyInvocable<void(absl::Status)> local = std::move(completer);
+    completer = nullptr;
+    local(std::move(status));
+  }
+};
+
+class CallAwaitable : public Coroutine::LeafAwaitable<absl::Status> {
+public:
+  explicit CallAwaitable(CallController& controller) : controller_(controller) {}
+
+protected:
+  void onStart() override {
+    controller_.started = true;
+    if (controller_.complete_inline.has_value()) {
+      complete(*controller_.complete_inline);
+      return;
+    }
+    controller_.completer = [this](absl::Status status) { complete(std::move(status)); };
+  }
+  void onCancel() override {
+    controller_.cancelled = true;
+    controller_.completer = nullptr;
+  }
+
+private:
+  CallController& controller_;
+};
+
+// Optionally waits for the body, then makes a call and denies the request if it fails.
+class TestFilter : public CoroutineDecoderFilter {
+public:
+  explicit TestFilter(CallController& controller) : controller_(controller) {}
+
+  bool await_body_{};
+  uint64_t max_body_bytes_{};
+  std::optional<uint64_t> body_length_;
+
+protected:
+  Coroutine::Task<absl::Status> decodeRequest(Coroutine::FrameArena& arena,
+                                              Http::RequestHeaderMap&, bool) override {
+    if (await_body_) {
+      absl::Status body = co_await requestBody(max_body_bytes_);
+      if (!body.ok()) {
+        co_return body;
+      }
+      const Buffer::Instance* buffered = decoder_callbacks_->decodingBuffer();
+      body_length_ = buffered != nullptr ? buffered->length() : 0;
+    }
+    absl::Status status = co_await call(arena);
+    if (!status.ok() && !absl::IsCancelled(status)) {
+      decoder_callbacks_->sendLocalReply(Http::Code::Forbidden, "denied", nullptr, std::nullopt,
+                                         "test_denied");
+    }
+    co_return status;
+  }
+
+private:
+  Coroutine::Task<absl::Status> call(Coroutine::FrameArena&) {
+    CallAwaitable awaitable(controller_);
+    co_return co_await awaitable;
+  }
+
+  CallController& controller_;
+};
+
+class CoroutineDecoderFilterTest : public testing::Test {
+public:
+  CoroutineDecoderFilterTest() {
+    filter_.setDecoderFilterCallbacks(decoder_callbacks_);
+    ON_CALL(decoder_callbacks_, addDecodedData(_, _))
+        .WillByDefault(Invoke([this](Buffer::Instance& data, bool) { bufferData(data); }));
+  }
+
+  // What the filter manager does with data the filter asked it to buffer.
+  void bufferData(Buffer::Instance& data) {
+    if (decoder_callbacks_.buffer_ == nullptr) {
+      decoder_callbacks_.buffer_ = std::make_unique<Buffer::OwnedImpl>();
+    }
+    decoder_callbacks_.buffer_->move(data);
+  }
+
+  CallController controller_;
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks_;
+  TestFilter filter_{controller_};
+  Http::TestRequestHeaderMapImpl request_headers_{{":path", "/"}};
+  Http::TestRequestTrailerMapImpl request_trailers_;
+};
+
+TEST_F(CoroutineDecoderFilterTest, InlineCompletionContinues) {
+  controller_.complete_inline = absl::OkStatus();
+  EXPECT_CALL(decoder_callbacks_, continueDecoding()).Times(0);
+
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_.decodeHeaders(request_headers_, false));
+  Buffer::OwnedImpl data("body");
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.decodeData(data, false));
+  EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_.decodeTrailers(request_trailers_));
+  filter_.onDestroy();
+
+  EXPECT_EQ(0, filter_.frameArena().heapAllocations());
+}
+
+TEST_F(CoroutineDecoderFilterTest, InlineFailureStops) {
+  controller_.complete_inline = absl::PermissionDeniedError("no");
+  EXPECT_CALL(decoder_callbacks_, sendLocalReply(Http::Code::Forbidden, _, _, _, _));
+
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_.decodeHeaders(request_headers_, true));
+  filter_.onDestroy();
+}
+
+TEST_F(CoroutineDecoderFilterTest, AsyncCompletionContinuesDecoding) {
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_.decodeHeaders(request_headers_, false));
+  EXPECT_TRUE(controller_.started);
+  Buffer::OwnedImpl data("body");
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndWatermark, filter_.decodeData(data, false));
+  EXPECT_EQ(Http::FilterTrailersStatus::StopIteration, filter_.decodeTrailers(request_trailers_));
+
+  EXPECT_CALL(decoder_callbacks_, continueDecoding());
+  controller_.completeWith(absl::OkStatus());
+  filter_.onDestroy();
+
+  EXPECT_FALSE(controller_.cancelled);
+  EXPECT_EQ(0, filter_.frameArena().heapAllocations());
+}
+
+TEST_F(CoroutineDecoderFilterTest, AsyncFailureSendsLocalReply) {
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_.decodeHeaders(request_headers_, true));
+
+  EXPECT_CALL(decoder_callbacks_, continueDecoding()).Times(0);
+  EXPECT_CALL(decoder_callbacks_, sendLocalReply(Http::Code::Forbidden, _, _, _, _));
+  controller_.completeWith(absl::PermissionDeniedError("no"));
+  filter_.onDestroy();
+}
+
+TEST_F(CoroutineDecoderFilterTest, DestroyCancelsPendingCall) {
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_.decodeHeaders(request_headers_, true));
+
+  EXPECT_CALL(decoder_callbacks_, continueDecoding()).Times(0);
+  EXPECT_CALL(decoder_callbacks_, sendLocalReply(_, _, _, _, _)).Times(0);
+  filter_.onDestroy();
+  EXPECT_TRUE(controller_.cancelled);
+  EXPECT_EQ(0, filter_.frameArena().bytesInUse());
+}
+
+TEST_F(CoroutineDecoderFilterTest, WaitsForBody) {
+  filter_.await_body_ = true;
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_.decodeHeaders(request_headers_, false));
+  EXPECT_FALSE(controller_.started);
+
+  Buffer::OwnedImpl first("hello ");
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_.decodeData(first, false));
+  bufferData(first);
+  EXPECT_FALSE(controller_.started);
+
+  Buffer::OwnedImpl last("world");
+  EXPECT_CALL(decoder_callbacks_, addDecodedData(_, true));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndWatermark, filter_.decodeData(last, true));
+  EXPECT_TRUE(controller_.started);
+  EXPECT_EQ(11, filter_.body_length_);
+
+  EXPECT_CALL(decoder_callbacks_, continueDecoding());
+  controller_.completeWith(absl::OkStatus());
+  filter_.onDestroy();
+}
+
+TEST_F(CoroutineDecoderFilterTest, BodyCompleteAtMaxBytes) {
+  filter_.await_body_ = true;
+  filter_.max_body_bytes_ = 4;
+  controller_.complete_inline = absl::OkStatus();
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_.decodeHeaders(request_headers_, false));
+
+  Buffer::OwnedImpl data("hello");
+  EXPECT_CALL(decoder_callbacks_, continueDecoding()).Times(0);
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.decodeData(data, false));
+  EXPECT_EQ(5, filter_.body_length_);
+  filter_.onDestroy();
+}
+
+TEST_F(CoroutineDecoderFilterTest, TrailersCompleteBody) {
+  filter_.await_body_ = true;
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_.decodeHeaders(request_headers_, false));
+  EXPECT_EQ(Http::FilterTrailersStatus::StopIteration, filter_.decodeTrailers(request_trailers_));
+  EXPECT_TRUE(controller_.started);
+  EXPECT_EQ(0, filter_.body_length_);
+
+  EXPECT_CALL(decoder_callbacks_, continueDecoding());
+  controller_.completeWith(absl::OkStatus());
+  filter_.onDestroy();
+}
+
+TEST_F(CoroutineDecoderFilterTest, HeadersOnlyRequestHasEmptyBody) {
+  filter_.await_body_ = true;
+  controller_.complete_inline = absl::OkStatus();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_.decodeHeaders(request_headers_, true));
+  EXPECT_EQ(0, filter_.body_length_);
+  filter_.onDestroy();
+}
+
+TEST_F(CoroutineDecoderFilterTest, DestroyWhileWaitingForBody) {
+  filter_.await_body_ = true;
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_.decodeHeaders(request_headers_, false));
+  filter_.onDestroy();
+  EXPECT_FALSE(controller_.started);
+  EXPECT_EQ(0, filter_.frameArena().bytesInUse());
+}
+
+} // namespace
+} // namespace Common
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -3,6 +3,7 @@
 
 #include "test/extensions/common/async_files/mocks.h"
 #include "test/mocks/http/mocks.h"
+#include "test/mocks/network/mocks.h"
 #include "test/test_common/status_utility.h"
 #include "test/test_common/utility.h"
 
@@ -14,12 +15,15 @@ namespace Extensions {
 namespace HttpFilters {
 namespace FileServer {
 
+using Extensions::Common::AsyncFiles::MockAsyncFileAction;
 using Extensions::Common::AsyncFiles::MockAsyncFileContext;
 using Extensions::Common::AsyncFiles::MockAsyncFileHandle;
 using Extensions::Common::AsyncFiles::MockAsyncFileManager;
+using Extensions::Common::AsyncFiles::TypedMockAsyncFileAction;
 using ::testing::AnyNumber;
 using ::testing::InSequence;
 using ::testing::NiceMock;
+using ::testing::Return;
 using ::testing::ReturnRef;
 using ::testing::StrictMock;
 
@@ -73,6 +77,21 @@ directory_behaviors:
     return mock_file_handle_;
   }
 
+  std::shared_ptr<FileServerFilter> fileBackedFilter(Http::Protocol protocol) {
+    auto filter = std::make_shared<FileServerFilter>(configFromYaml(R"(
+path_mappings:
+  - request_path_prefix: /path1
+    file_path_prefix: fs1
+file_backed_body: true
+)"));
+    initFilter(*filter);
+    decoder_callbacks_.stream_info_.protocol_ = protocol;
+    ON_CALL(connection_, canSendFile()).WillByDefault(Return(true));
+    ON_CALL(decoder_callbacks_, connection())
+        .WillByDefault(Return(OptRef<const Network::Connection>{connection_}));
+    return filter;
+  }
+
   std::string responseCodeDetails() {
     return decoder_callbacks_.stream_info_.response_code_details_.value_or("");
   }
@@ -81,6 +100,7 @@ directory_behaviors:
       std::make_shared<NiceMock<MockAsyncFileManager>>();
   MockAsyncFileHandle mock_file_handle_;
   NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks_;
+  NiceMock<Network::MockConnection> connection_;
   Api::ApiPtr api_ = Api::createApiForTest();
   Event::DispatcherPtr dispatcher_ = api_->allocateDispatcher("test_thread");
 };
@@ -475,6 +495,137 @@ TEST_F(FileServerFilterTest, GetRequestPausesWhenOverBufferLimit) {
   EXPECT_EQ(responseCodeDetails(), "file_server");
 }
 
+TEST_F(FileServerFilterTest, FileBackedBodyReadsLargerFileBackedChunks) {
+  auto filter = fileBackedFilter(Http::Protocol::Http11);
+  Http::TestRequestHeaderMapImpl request_headers{
+      {":path", "/path1/foo/big.bin"},
+      {":method", "GET"},
+      {":host", "test.host"},
+      {":scheme", "https"},
+  };
+  makeMockFile();
+  Http::TestResponseHeaderMapImpl expected_headers{
+      {":status", "200"},
+      {"accept-ranges", "bytes"},
+      {"content-length", "300000"},
+  };
+  // chunk1 is the max file-backed read size.
+  std::string chunk1(256 * 1024, 'A');
+  // chunk2 is the remainder.
+  std::string chunk2(300000 - chunk1.length(), 'B');
+  {
+    InSequence seq;
+    EXPECT_CALL(*mock_async_file_manager_, stat);
+    EXPECT_CALL(*mock_async_file_manager_, openExistingFile(_, "fs1/foo/big.bin", _, _));
+    EXPECT_CALL(*mock_file_handle_, stat);
+    EXPECT_CALL(decoder_callbacks_, encodeHeaders_(HeaderMapEqualRef(&expected_headers), false));
+    EXPECT_CALL(*mock_file_handle_, readFileBacked(_, 0, chunk1.length(), _, _));
+    EXPECT_CALL(decoder_callbacks_, encodeData(BufferString(chunk1), false));
+    EXPECT_CALL(*mock_file_handle_, readFileBacked(_, chunk1.length(), chunk2.length(), _, _));
+    EXPECT_CALL(decoder_callbacks_, encodeData(BufferString(chunk2), true));
+  }
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration, filter->decodeHeaders(request_headers, true));
+  struct stat stat_result = {};
+  stat_result.st_size = chunk1.length() + chunk2.length();
+  mock_async_file_manager_->nextActionCompletes(absl::StatusOr<struct stat>{stat_result});
+  pumpDispatcher();
+  mock_async_file_manager_->nextActionCompletes(absl::StatusOr<AsyncFileHandle>{mock_file_handle_});
+  pumpDispatcher();
+  mock_async_file_manager_->nextActionCompletes(absl::StatusOr<struct stat>{stat_result});
+  pumpDispatcher();
+  mock_async_file_manager_->nextActionCompletes(
+      absl::StatusOr<Buffer::InstancePtr>{std::make_unique<Buffer::OwnedImpl>(chunk1)});
+  pumpDispatcher();
+  mock_async_file_manager_->nextActionCompletes(
+      absl::StatusOr<Buffer::InstancePtr>{std::make_unique<Buffer::OwnedImpl>(chunk2)});
+  pumpDispatcher();
+  EXPECT_EQ(responseCodeDetails(), "file_server");
+}
+
+TEST_F(FileServerFilterTest, FileBackedBodyIsNotUsedForHttp2) {
+  auto filter = fileBackedFilter(Http::Protocol::Http2);
+  Http::TestRequestHeaderMapImpl request_headers{
+      {":path", "/path1/foo/small.bin"},
+      {":method", "GET"},
+      {":host", "test.host"},
+      {":scheme", "https"},
+  };
+  makeMockFile();
+  {
+    InSequence seq;
+    EXPECT_CALL(*mock_async_file_manager_, stat);
+    EXPECT_CALL(*mock_async_file_manager_, openExistingFile(_, "fs1/foo/small.bin", _, _));
+    EXPECT_CALL(*mock_file_handle_, stat);
+    EXPECT_CALL(decoder_callbacks_, encodeHeaders_(_, false));
+    EXPECT_CALL(*mock_file_handle_, read(_, 0, 5, _));
+    EXPECT_CALL(decoder_callbacks_, encodeData(BufferString("hello"), true));
+  }
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration, filter->decodeHeaders(request_headers, true));
+  struct stat stat_result = {};
+  stat_result.st_size = 5;
+  mock_async_file_manager_->nextActionCompletes(absl::StatusOr<struct stat>{stat_result});
+  pumpDispatcher();
+  mock_async_file_manager_->nextActionCompletes(absl::StatusOr<AsyncFileHandle>{mock_file_handle_});
+  pumpDispatcher();
+  mock_async_file_manager_->nextActionCompletes(absl::StatusOr<struct stat>{stat_result});
+  pumpDispatcher();
+  mock_async_file_manager_->nextActionCompletes(
+      absl::StatusOr<Buffer::InstancePtr>{std::make_unique<Buffer::OwnedImpl>("hello")});
+  pumpDispatcher();
+}
+
+TEST_F(FileServerFilterTest, FileBackedBodyReadFailureResetsTheStream) {
+  auto filter = fileBackedFilter(Http::Protocol::Http11);
+  Http::TestRequestHeaderMapImpl request_headers{
+      {":path", "/path1/foo/small.bin"},
+      {":method", "GET"},
+      {":host", "test.host"},
+      {":scheme", "https"},
+  };
+  makeMockFile();
+  absl::AnyInvocable<void()> on_read_failure;
+  {
+    InSequence seq;
+    EXPECT_CALL(*mock_async_file_manager_, stat);
+    EXPECT_CALL(*mock_async_file_manager_, openExistingFile(_, "fs1/foo/small.bin", _, _));
+    EXPECT_CALL(*mock_file_handle_, stat);
+    EXPECT_CALL(decoder_callbacks_, encodeHeaders_(_, false));
+    EXPECT_CALL(*mock_file_handle_, readFileBacked(_, 0, 5, _, _))
+        .WillOnce([&](Event::Dispatcher* dispatcher, off_t, size_t,
+                      absl::AnyInvocable<void()> on_failure,
+                      absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) {
+          on_read_failure = std::move(on_failure);
+          return mock_async_file_manager_->enqueue(
+              dispatcher, std::unique_ptr<MockAsyncFileAction>(
+                              new TypedMockAsyncFileAction(std::move(on_complete))));
+        });
+    EXPECT_CALL(decoder_callbacks_, encodeData(BufferString("hello"), true));
+    EXPECT_CALL(decoder_callbacks_,
+                resetStream(Http::StreamResetReason::LocalReset, "file_server_file_truncated"));
+  }
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration, filter->decodeHeaders(request_headers, true));
+  struct stat stat_result = {};
+  stat_result.st_size = 5;
+  mock_async_file_manager_->nextActionCompletes(absl::StatusOr<struct stat>{stat_result});
+  pumpDispatcher();
+  mock_async_file_manager_->nextActionCompletes(absl::StatusOr<AsyncFileHandle>{mock_file_handle_});
+  pumpDispatcher();
+  mock_async_file_manager_->nextActionCompletes(absl::StatusOr<struct stat>{stat_result});
+  pumpDispatcher();
+  mock_async_file_manager_->nextActionCompletes(
+      absl::StatusOr<Buffer::InstancePtr>{std::make_unique<Buffer::OwnedImpl>("hello")});
+  pumpDispatcher();
+  // The file was truncated before something read the contents of the body.
+  ASSERT_TRUE(on_read_failure);
+  on_read_failure();
+  pumpDispatcher();
+  EXPECT_EQ(responseCodeDetails(), "file_server_file_truncated");
+  // Once the filter is destroyed, read failures are ignored.
+  filter->onDestroy();
+  on_read_failure();
+  pumpDispatcher();
+}
+
 TEST_F(FileServerFilterTest, BufferLimitsDontPauseIfClearedBeforeActionCompletes) {
   auto filter = testFilter();
   Http::TestRequestHeaderMapImpl request_headers{
@@ -20,6 +20,7 @@
 #include "test/mocks/server/server_factory_context.h"
 #include "test/test_common/printers.h"
 #include "test/test_common/status_utility.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -605,6 +606,54 @@ TEST_F(HttpRateLimitFilterTest, ImmediateOkResponse) {
       1U, filter_callbacks_.clusterInfo()->statsScope().counterFromStatName(ratelimit_ok_).value());
 }
 
+TEST_F(HttpRateLimitFilterTest, ImmediateOkResponseWithRequestHeaders) {
+  setUpTest(filter_config_);
+  InSequence s;
+
+  EXPECT_CALL(vh_rate_limit_, populateDescriptors(_, _, _, _))
+      .WillOnce(SetArgReferee<0>(descriptor_));
+
+  Http::HeaderMapPtr request_headers_to_add{
+      new Http::TestRequestHeaderMapImpl{{"x-rls-rate-limited", "false"}}};
+  EXPECT_CALL(*client_, limit(_, "foo", _, _, _, 0))
+      .WillOnce(
+          WithArgs<0>(Invoke([&](Filters::Common::RateLimit::RequestCallbacks& callbacks) -> void {
+            callbacks.complete(
+                Filters::Common::RateLimit::LimitStatus::OK, nullptr, nullptr,
+                Http::RequestHeaderMapPtr{
+                    new Http::TestRequestHeaderMapImpl(*request_headers_to_add)},
+                "", nullptr);
+          })));
+
+  EXPECT_CALL(filter_callbacks_, continueDecoding()).Times(0);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+  EXPECT_THAT(*request_headers_to_add, IsSubsetOfHeaders(request_headers_));
+}
+
+TEST_F(HttpRateLimitFilterTest, ImmediateOkResponseWithRequestHeadersRuntimeDisabled) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues(
+      {{"envoy.reloadable_features.ratelimit_request_headers_on_inline_response", "false"}});
+  setUpTest(filter_config_);
+  InSequence s;
+
+  EXPECT_CALL(vh_rate_limit_, populateDescriptors(_, _, _, _))
+      .WillOnce(SetArgReferee<0>(descriptor_));
+
+  EXPECT_CALL(*client_, limit(_, "foo", _, _, _, 0))
+      .WillOnce(
+          WithArgs<0>(Invoke([&](Filters::Common::RateLimit::RequestCallbacks& callbacks) -> void {
+            callbacks.complete(Filters::Common::RateLimit::LimitStatus::OK, nullptr, nullptr,
+                               Http::RequestHeaderMapPtr{new Http::TestRequestHeaderMapImpl{
+                                   {"x-rls-rate-limited", "false"}}},
+                               "", nullptr);
+          })));
+
+  EXPECT_CALL(filter_callbacks_, continueDecoding()).Times(0);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+  EXPECT_FALSE(request_headers_.has("x-rls-rate-limited"));
+}
+
 TEST_F(HttpRateLimitFilterTest, ImmediateErrorResponse) {
   setUpTest(filter_config_);
   InSequence s;
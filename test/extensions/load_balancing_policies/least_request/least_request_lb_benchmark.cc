@@ -9,9 +9,14 @@ namespace {
 
 class LeastRequestTester : public BaseTester {
 public:
-  LeastRequestTester(uint64_t num_hosts, uint32_t choice_count) : BaseTester(num_hosts) {
+  LeastRequestTester(uint64_t num_hosts, uint32_t choice_count, bool full_scan = false)
+      : BaseTester(num_hosts) {
     envoy::extensions::load_balancing_policies::least_request::v3::LeastRequest lr_lb_config;
     lr_lb_config.mutable_choice_count()->set_value(choice_count);
+    if (full_scan) {
+      lr_lb_config.set_selection_method(
+          envoy::extensions::load_balancing_policies::least_request::v3::LeastRequest::FULL_SCAN);
+    }
     lb_ =
         std::make_unique<LeastRequestLoadBalancer>(priority_set_, &local_priority_set_, stats_,
                                                    runtime_, random_, 50, lr_lb_config, simTime());
@@ -62,6 +67,35 @@ BENCHMARK(benchmarkLeastRequestLoadBalancerChooseHost)
     ->Args({100, 100, 1000000})
     ->Unit(::benchmark::kMillisecond);
 
+// Measures the picks per second of a load balancer that is not being updated, which is the steady
+// state of a worker. Half of the hosts have an outstanding request so that the comparisons of the
+// sampled hosts are not all ties.
+void benchmarkLeastRequestLoadBalancerPick(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t choice_count = state.range(1);
+  const bool full_scan = state.range(2) != 0;
+
+  LeastRequestTester tester(num_hosts, choice_count, full_scan);
+  for (const HostSharedPtr& host : tester.priority_set_.hostSetsPerPriority()[0]->hosts()) {
+    if (tester.random_.random() % 2 == 0) {
+      host->stats().rq_active_.inc();
+    }
+  }
+  TestLoadBalancerContext context;
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    ::benchmark::DoNotOptimize(tester.lb_->chooseHost(&context).host);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(benchmarkLeastRequestLoadBalancerPick)
+    ->Args({1000, 2, 0})
+    ->Args({10000, 2, 0})
+    ->Args({1000, 10, 0})
+    ->Args({10000, 10, 0})
+    ->Args({1000, 2, 1})
+    ->Args({10000, 2, 1});
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
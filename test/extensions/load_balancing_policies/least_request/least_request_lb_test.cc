@@ -86,6 +86,36 @@ TEST_P(LeastRequestLoadBalancerTest, Normal) {
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr).host);
 }
 
+// The active requests compared by the picks follow the hosts of the latest update.
+TEST_P(LeastRequestLoadBalancerTest, PicksFollowHostUpdates) {
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80"),
+                              makeTestHost(info_, "tcp://127.0.0.1:81")};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({}, {});
+
+  hostSet().healthy_hosts_[0]->stats().rq_active_.set(1);
+  hostSet().healthy_hosts_[1]->stats().rq_active_.set(2);
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(2)).WillOnce(Return(3));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr).host);
+
+  // Replace the first host and add a third one.
+  HostVector removed{hostSet().healthy_hosts_[0]};
+  HostVector added{makeTestHost(info_, "tcp://127.0.0.1:82"),
+                   makeTestHost(info_, "tcp://127.0.0.1:83")};
+  added[0]->stats().rq_active_.set(3);
+  hostSet().healthy_hosts_ = {added[0], hostSet().healthy_hosts_[1], added[1]};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks(added, removed);
+
+  // The second host has fewer active requests than the first one.
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr).host);
+
+  // The third host has fewer active requests than the second one.
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(1)).WillOnce(Return(2));
+  EXPECT_EQ(hostSet().healthy_hosts_[2], lb_.chooseHost(nullptr).host);
+}
+
 TEST_P(LeastRequestLoadBalancerTest, PNC) {
   hostSet().healthy_hosts_ = {
       makeTestHost(info_, "tcp://127.0.0.1:80"), makeTestHost(info_, "tcp://127.0.0.1:81"),
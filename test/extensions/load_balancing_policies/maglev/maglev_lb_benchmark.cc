@@ -77,6 +77,30 @@ BENCHMARK(benchmarkMaglevLoadBalancerBuildTable)
     ->Arg(100)
     ->Arg(200)
     ->Arg(500)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(::benchmark::kMillisecond);
+
+// Times the refresh caused by updating another priority, which keeps the table of the priority
+// whose hosts did not change.
+void benchmarkMaglevLoadBalancerUpdateOtherPriority(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  MaglevTester tester(num_hosts);
+  ASSERT_OK(tester.maglev_lb_->initialize());
+  const HostVector failover_hosts{makeTestHost(tester.info_, "tcp://10.255.0.0:6379")};
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    tester.priority_set_.updateHosts(
+        1,
+        HostSetImpl::partitionHosts(std::make_shared<const HostVector>(failover_hosts),
+                                    HostsPerLocalityImpl::empty()),
+        {}, {}, {}, std::nullopt);
+  }
+}
+BENCHMARK(benchmarkMaglevLoadBalancerUpdateOtherPriority)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(10000)
     ->Unit(::benchmark::kMillisecond);
 
 void benchmarkMaglevLoadBalancerHostLoss(::benchmark::State& state) {
@@ -222,6 +222,33 @@ TEST_F(MaglevLoadBalancerTest, WorkerLbCallbackUnregisteredOnDestruction) {
   worker_priority_set_.member_update_cb_helper_.runCallbacks({}, {});
 }
 
+// A refresh that finds the same host set snapshots keeps the table of the priority rather than
+// rebuilding it.
+TEST_F(MaglevLoadBalancerTest, RefreshReusesUnchangedTable) {
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90"),
+                      makeTestHost(info_, "tcp://127.0.0.1:91")};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.hosts_per_locality_ = makeHostsPerLocality({host_set_.hosts_});
+  host_set_.healthy_hosts_per_locality_ = host_set_.hosts_per_locality_;
+  host_set_.locality_weights_ = makeLocalityWeights({1});
+  init(7, true);
+  EXPECT_EQ(4, lb_->stats().max_entries_per_host_.value());
+
+  // Building a table sets the stat again.
+  lb_->stats().max_entries_per_host_.set(0);
+  host_set_.runCallbacks({}, {});
+  EXPECT_EQ(0, lb_->stats().max_entries_per_host_.value());
+
+  host_set_.healthy_hosts_per_locality_ = makeHostsPerLocality({host_set_.hosts_});
+  host_set_.runCallbacks({}, {});
+  EXPECT_EQ(4, lb_->stats().max_entries_per_host_.value());
+
+  lb_->stats().max_entries_per_host_.set(0);
+  host_set_.locality_weights_ = makeLocalityWeights({2});
+  host_set_.runCallbacks({}, {});
+  EXPECT_EQ(4, lb_->stats().max_entries_per_host_.value());
+}
+
 // Throws an exception if table size is not a prime number.
 TEST_F(MaglevLoadBalancerTest, NoPrimeNumber) {
   EXPECT_THROW_WITH_MESSAGE(init(8), EnvoyException,
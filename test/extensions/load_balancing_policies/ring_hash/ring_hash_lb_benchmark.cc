@@ -44,11 +44,36 @@ BENCHMARK(benchmarkRingHashLoadBalancerBuildRing)
     ->Args({100, 65536})
     ->Args({200, 65536})
     ->Args({500, 65536})
+    ->Args({1000, 65536})
+    ->Args({10000, 65536})
     ->Args({100, 256000})
     ->Args({200, 256000})
     ->Args({500, 256000})
     ->Unit(::benchmark::kMillisecond);
 
+// Times the refresh caused by updating another priority, which keeps the ring of the priority
+// whose hosts did not change.
+void benchmarkRingHashLoadBalancerUpdateOtherPriority(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t min_ring_size = state.range(1);
+  RingHashTester tester(num_hosts, min_ring_size);
+  ASSERT_OK(tester.ring_hash_lb_->initialize());
+  const HostVector failover_hosts{makeTestHost(tester.info_, "tcp://10.255.0.0:6379")};
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    tester.priority_set_.updateHosts(
+        1,
+        HostSetImpl::partitionHosts(std::make_shared<const HostVector>(failover_hosts),
+                                    HostsPerLocalityImpl::empty()),
+        {}, {}, {}, std::nullopt);
+  }
+}
+BENCHMARK(benchmarkRingHashLoadBalancerUpdateOtherPriority)
+    ->Args({100, 65536})
+    ->Args({1000, 65536})
+    ->Args({10000, 65536})
+    ->Unit(::benchmark::kMillisecond);
+
 void benchmarkRingHashLoadBalancerChooseHost(::benchmark::State& state) {
   for (auto _ : state) { // NOLINT: Silences warning about dead store
     // Do not time the creation of the ring.
@@ -455,6 +455,66 @@ TEST_P(RoundRobinLoadBalancerTest, WeightedSeed) {
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
 }
 
+// Validate that a host update keeps the schedulers of the host sources whose snapshot did not
+// change.
+TEST_P(RoundRobinLoadBalancerTest, WeightedKeepsUnchangedSchedulers) {
+  HostVector hosts{makeTestHost(info_, "tcp://127.0.0.1:80", 1),
+                   makeTestHost(info_, "tcp://127.0.0.1:81", 2)};
+  PrioritySetImpl priority_set;
+  priority_set.updateHosts(
+      0,
+      updateHostsParams(std::make_shared<const HostVector>(hosts), HostsPerLocalityImpl::empty(),
+                        std::make_shared<const HealthyHostVector>(hosts),
+                        HostsPerLocalityImpl::empty()),
+      {}, hosts, {});
+  RoundRobinLoadBalancer lb(priority_set, nullptr, stats_, runtime_, random_, 50,
+                            round_robin_lb_config_, simTime());
+  EXPECT_EQ(hosts[1], lb.chooseHost(nullptr).host);
+  EXPECT_EQ(hosts[0], lb.chooseHost(nullptr).host);
+
+  // The same snapshots: the healthy hosts scheduler continues where it was.
+  priority_set.updateHosts(
+      0, HostSetImpl::updateHostsParams(*priority_set.hostSetsPerPriority()[0]), {}, {}, {});
+  EXPECT_EQ(hosts[1], lb.chooseHost(nullptr).host);
+  EXPECT_EQ(hosts[1], lb.chooseHost(nullptr).host);
+
+  // A new healthy hosts snapshot rebuilds the scheduler.
+  priority_set.updateHosts(
+      0,
+      updateHostsParams(priority_set.hostSetsPerPriority()[0]->hostsPtr(),
+                        HostsPerLocalityImpl::empty(),
+                        std::make_shared<const HealthyHostVector>(hosts),
+                        HostsPerLocalityImpl::empty()),
+      {}, {}, {});
+  EXPECT_EQ(hosts[1], lb.chooseHost(nullptr).host);
+  EXPECT_EQ(hosts[0], lb.chooseHost(nullptr).host);
+}
+
+// Validate that every host update rebuilds the schedulers with the runtime guard disabled.
+TEST_P(RoundRobinLoadBalancerTest, WeightedRebuildsSchedulersWithoutIncrementalUpdates) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues(
+      {{"envoy.reloadable_features.incremental_host_health_updates", "false"}});
+  HostVector hosts{makeTestHost(info_, "tcp://127.0.0.1:80", 1),
+                   makeTestHost(info_, "tcp://127.0.0.1:81", 2)};
+  PrioritySetImpl priority_set;
+  priority_set.updateHosts(
+      0,
+      updateHostsParams(std::make_shared<const HostVector>(hosts), HostsPerLocalityImpl::empty(),
+                        std::make_shared<const HealthyHostVector>(hosts),
+                        HostsPerLocalityImpl::empty()),
+      {}, hosts, {});
+  RoundRobinLoadBalancer lb(priority_set, nullptr, stats_, runtime_, random_, 50,
+                            round_robin_lb_config_, simTime());
+  EXPECT_EQ(hosts[1], lb.chooseHost(nullptr).host);
+  EXPECT_EQ(hosts[0], lb.chooseHost(nullptr).host);
+
+  priority_set.updateHosts(
+      0, HostSetImpl::updateHostsParams(*priority_set.hostSetsPerPriority()[0]), {}, {}, {});
+  EXPECT_EQ(hosts[1], lb.chooseHost(nullptr).host);
+  EXPECT_EQ(hosts[0], lb.chooseHost(nullptr).host);
+}
+
 // Validate that low weighted hosts will be chosen when the LB is created.
 TEST_P(RoundRobinLoadBalancerTest, WeightedInitializationPicksAllHosts) {
   TestScopedRuntime scoped_runtime;
@@ -0,0 +1,64 @@
+#include "envoy/extensions/resource_monitors/slice_arena/v3/slice_arena.pb.h"
+#include "envoy/extensions/resource_monitors/slice_arena/v3/slice_arena.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "source/common/buffer/slice_arena.h"
+#include "source/extensions/resource_monitors/slice_arena/config.h"
+#include "source/server/resource_monitor_config_impl.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/server/options.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace SliceArenaMonitor {
+namespace {
+
+TEST(SliceArenaMonitorFactoryTest, CreateMonitorEnablesArenas) {
+  auto factory =
+      Registry::FactoryRegistry<Server::Configuration::ResourceMonitorFactory>::getFactory(
+          "envoy.resource_monitors.slice_arena");
+  ASSERT_NE(factory, nullptr);
+
+  envoy::extensions::resource_monitors::slice_arena::v3::SliceArenaConfig config;
+  config.set_max_arena_size_bytes(4 * Buffer::SliceArena::ChunkSize);
+  Event::MockDispatcher dispatcher;
+  Api::ApiPtr api = Api::createApiForTest();
+  Server::MockOptions options;
+  testing::NiceMock<Runtime::MockLoader> runtime;
+  Server::Configuration::ResourceMonitorFactoryContextImpl context(
+      dispatcher, options, *api, ProtobufMessage::getStrictValidationVisitor(), runtime);
+  EXPECT_FALSE(Buffer::SliceArena::enabled());
+  auto monitor = factory->createResourceMonitor(config, context);
+  EXPECT_NE(monitor, nullptr);
+  EXPECT_TRUE(Buffer::SliceArena::enabled());
+  Buffer::SliceArena::configure(0);
+}
+
+TEST(SliceArenaMonitorFactoryTest, RejectTooSmallArena) {
+  auto factory =
+      Registry::FactoryRegistry<Server::Configuration::ResourceMonitorFactory>::getFactory(
+          "envoy.resource_monitors.slice_arena");
+  ASSERT_NE(factory, nullptr);
+
+  envoy::extensions::resource_monitors::slice_arena::v3::SliceArenaConfig config;
+  config.set_max_arena_size_bytes(Buffer::SliceArena::ChunkSize - 1);
+  Event::MockDispatcher dispatcher;
+  Api::ApiPtr api = Api::createApiForTest();
+  Server::MockOptions options;
+  testing::NiceMock<Runtime::MockLoader> runtime;
+  Server::Configuration::ResourceMonitorFactoryContextImpl context(
+      dispatcher, options, *api, ProtobufMessage::getStrictValidationVisitor(), runtime);
+  EXPECT_THROW_WITH_REGEX(factory->createResourceMonitor(config, context), EnvoyException,
+                          "max_arena_size_bytes");
+}
+
+} // namespace
+} // namespace SliceArenaMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,71 @@
+#include <optional>
+
+#include "source/extensions/resource_monitors/slice_arena/slice_arena_monitor.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace SliceArenaMonitor {
+namespace {
+
+using testing::Return;
+
+class MockSliceArenaStatsReader : public SliceArenaStatsReader {
+public:
+  MOCK_METHOD(Buffer::SliceArenaStats, stats, ());
+};
+
+class ResourcePressure : public Server::ResourceUpdateCallbacks {
+public:
+  void onSuccess(const Server::ResourceUsage& usage) override {
+    pressure_ = usage.resource_pressure_;
+  }
+
+  void onFailure(const EnvoyException& error) override { error_ = error; }
+
+  bool hasPressure() const { return pressure_.has_value(); }
+  bool hasError() const { return error_.has_value(); }
+
+  double pressure() const { return *pressure_; }
+
+private:
+  std::optional<double> pressure_;
+  std::optional<EnvoyException> error_;
+};
+
+TEST(SliceArenaMonitorTest, ReportsMaxArenaPressure) {
+  auto stats_reader = std::make_unique<MockSliceArenaStatsReader>();
+  Buffer::SliceArenaStats stats;
+  stats.arenas_ = 4;
+  stats.reserved_bytes_ = 8 * Buffer::SliceArena::ChunkSize;
+  stats.in_use_bytes_ = 5 * Buffer::SliceArena::ChunkSize;
+  stats.max_pressure_ = 0.75;
+  EXPECT_CALL(*stats_reader, stats()).WillOnce(Return(stats));
+  SliceArenaMonitor monitor(std::move(stats_reader));
+
+  ResourcePressure resource;
+  monitor.updateResourceUsage(resource);
+  ASSERT_TRUE(resource.hasPressure());
+  ASSERT_FALSE(resource.hasError());
+  EXPECT_EQ(resource.pressure(), 0.75);
+}
+
+TEST(SliceArenaMonitorTest, NoArenasReportsNoPressure) {
+  auto stats_reader = std::make_unique<MockSliceArenaStatsReader>();
+  EXPECT_CALL(*stats_reader, stats()).WillOnce(Return(Buffer::SliceArenaStats{}));
+  SliceArenaMonitor monitor(std::move(stats_reader));
+
+  ResourcePressure resource;
+  monitor.updateResourceUsage(resource);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_EQ(resource.pressure(), 0);
+}
+
+} // namespace
+} // namespace SliceArenaMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,57 @@
+#include "envoy/extensions/stat_sinks/shared_memory/v3/shared_memory.pb.h"
+#include "envoy/registry/registry.h"
+
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/stat_sinks/shared_memory/config.h"
+#include "source/extensions/stat_sinks/shared_memory/shared_memory_sink.h"
+
+#include "test/mocks/server/server_factory_context.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace SharedMemory {
+namespace {
+
+absl::StatusOr<Stats::SinkPtr> createSink(const std::string& path) {
+  envoy::extensions::stat_sinks::shared_memory::v3::SharedMemoryStatsSink sink_config;
+  sink_config.set_path(path);
+  sink_config.mutable_max_stats()->set_value(16);
+
+  Server::Configuration::StatsSinkFactory* factory =
+      Registry::FactoryRegistry<Server::Configuration::StatsSinkFactory>::getFactory(
+          "envoy.stat_sinks.shared_memory");
+  EXPECT_NE(factory, nullptr);
+  ProtobufTypes::MessagePtr message = factory->createEmptyConfigProto();
+  TestUtility::jsonConvert(sink_config, *message);
+
+  NiceMock<Server::Configuration::MockServerFactoryContext> server;
+  return factory->createStatsSink(*message, server);
+}
+
+TEST(SharedMemoryStatsConfigTest, ValidSink) {
+  absl::StatusOr<Stats::SinkPtr> sink =
+      createSink(TestEnvironment::temporaryPath("shared_memory_config_test"));
+  ASSERT_TRUE(sink.ok());
+  EXPECT_NE(dynamic_cast<SharedMemoryStatsSink*>(sink.value().get()), nullptr);
+}
+
+TEST(SharedMemoryStatsConfigTest, InvalidPath) {
+  absl::StatusOr<Stats::SinkPtr> sink =
+      createSink(TestEnvironment::temporaryPath("missing/shared_memory_config_test"));
+  EXPECT_THAT(sink.status().message(),
+              testing::HasSubstr("cannot create shared memory stats file"));
+}
+
+} // namespace
+} // namespace SharedMemory
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,203 @@
+#include <unistd.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "source/extensions/stat_sinks/shared_memory/segment_reader.h"
+#include "source/extensions/stat_sinks/shared_memory/shared_memory_sink.h"
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/mocks/stats/mocks.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "absl/strings/str_cat.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace SharedMemory {
+namespace {
+
+class SharedMemoryStatsSinkTest : public testing::Test {
+public:
+  SharedMemoryStatsSinkTest() : path_(TestEnvironment::temporaryPath("shared_memory_stats")) {}
+
+  void createSink(uint32_t capacity = 16, uint64_t names_capacity = 1024) {
+    sink_ = SharedMemoryStatsSink::create(path_, capacity, names_capacity, store_.symbolTable())
+                .value();
+  }
+
+  SegmentReaderPtr openReader() { return SegmentReader::open(path_).value(); }
+
+  void addCounter(const std::string& name, uint64_t value) {
+    Stats::Counter& counter = store_.counterFromString(name);
+    counter.add(value);
+    snapshot_.counters_.push_back({value, counter});
+  }
+
+  Stats::Gauge& addGauge(const std::string& name, uint64_t value) {
+    Stats::Gauge& gauge = store_.gaugeFromString(name, Stats::Gauge::ImportMode::Accumulate);
+    gauge.set(value);
+    snapshot_.gauges_.push_back(gauge);
+    return gauge;
+  }
+
+  const std::string path_;
+  Stats::TestUtil::TestStore store_;
+  NiceMock<Stats::MockMetricSnapshot> snapshot_;
+  SharedMemoryStatsSinkPtr sink_;
+};
+
+TEST_F(SharedMemoryStatsSinkTest, PublishesCountersAndGauges) {
+  createSink();
+  addCounter("cluster.foo.upstream_rq", 5);
+  addGauge("cluster.foo.upstream_cx_active", 3);
+  // A counter and a gauge with the same name are published to separate slots.
+  addGauge("cluster.foo.upstream_rq", 7);
+  snapshot_.snapshot_time_ = SystemTime(std::chrono::milliseconds(1234));
+  sink_->flush(snapshot_);
+
+  SegmentReaderPtr reader = openReader();
+  SegmentReader::Snapshot snapshot;
+  ASSERT_TRUE(reader->read(snapshot).ok());
+  EXPECT_EQ(1234, snapshot.flush_time_ms_);
+  EXPECT_EQ(0, snapshot.dropped_);
+  EXPECT_EQ(getpid(), reader->pid());
+  ASSERT_EQ(3, snapshot.entries_.size());
+  EXPECT_EQ("cluster.foo.upstream_rq", snapshot.entries_[0].name_);
+  EXPECT_EQ(EntryType::Counter, snapshot.entries_[0].type_);
+  EXPECT_EQ(5, snapshot.entries_[0].value_);
+  EXPECT_EQ("cluster.foo.upstream_cx_active", snapshot.entries_[1].name_);
+  EXPECT_EQ(EntryType::Gauge, snapshot.entries_[1].type_);
+  EXPECT_EQ(3, snapshot.entries_[1].value_);
+  EXPECT_EQ("cluster.foo.upstream_rq", snapshot.entries_[2].name_);
+  EXPECT_EQ(EntryType::Gauge, snapshot.entries_[2].type_);
+  EXPECT_EQ(7, snapshot.entries_[2].value_);
+  EXPECT_FALSE(snapshot.entries_[0].stale_);
+}
+
+// Slots keep their index across flushes, and a stat missing from a flush is marked stale.
+TEST_F(SharedMemoryStatsSinkTest, SlotsAreStable) {
+  createSink();
+  addCounter("a", 1);
+  addCounter("b", 2);
+  sink_->flush(snapshot_);
+
+  SegmentReaderPtr reader = openReader();
+  SegmentReader::Snapshot snapshot;
+  ASSERT_TRUE(reader->read(snapshot).ok());
+  ASSERT_EQ(2, snapshot.entries_.size());
+
+  snapshot_.counters_.clear();
+  addCounter("c", 3);
+  addCounter("b", 4);
+  sink_->flush(snapshot_);
+
+  ASSERT_TRUE(reader->read(snapshot).ok());
+  ASSERT_EQ(3, snapshot.entries_.size());
+  EXPECT_EQ("a", snapshot.entries_[0].name_);
+  EXPECT_EQ(1, snapshot.entries_[0].value_);
+  EXPECT_TRUE(snapshot.entries_[0].stale_);
+  EXPECT_EQ("b", snapshot.entries_[1].name_);
+  EXPECT_EQ(6, snapshot.entries_[1].value_);
+  EXPECT_FALSE(snapshot.entries_[1].stale_);
+  EXPECT_EQ("c", snapshot.entries_[2].name_);
+  EXPECT_EQ(3, snapshot.entries_[2].value_);
+  EXPECT_FALSE(snapshot.entries_[2].stale_);
+}
+
+TEST_F(SharedMemoryStatsSinkTest, DropsStatsWhenFull) {
+  createSink(2, 8);
+  addCounter("a", 1);
+  // Does not fit in the names region.
+  addCounter("long_name", 2);
+  addCounter("b", 3);
+  // Does not fit in the entries.
+  addCounter("c", 4);
+  sink_->flush(snapshot_);
+
+  SegmentReaderPtr reader = openReader();
+  SegmentReader::Snapshot snapshot;
+  ASSERT_TRUE(reader->read(snapshot).ok());
+  EXPECT_EQ(2, snapshot.dropped_);
+  ASSERT_EQ(2, snapshot.entries_.size());
+  EXPECT_EQ("a", snapshot.entries_[0].name_);
+  EXPECT_EQ("b", snapshot.entries_[1].name_);
+}
+
+// Creating a sink replaces the file, while a reader of the old file keeps its mapping.
+TEST_F(SharedMemoryStatsSinkTest, ReplacesExistingFile) {
+  createSink();
+  addCounter("a", 1);
+  sink_->flush(snapshot_);
+  SegmentReaderPtr old_reader = openReader();
+
+  createSink();
+  SegmentReader::Snapshot snapshot;
+  ASSERT_TRUE(old_reader->read(snapshot).ok());
+  EXPECT_EQ(1, snapshot.entries_.size());
+  ASSERT_TRUE(openReader()->read(snapshot).ok());
+  EXPECT_EQ(0, snapshot.entries_.size());
+}
+
+TEST_F(SharedMemoryStatsSinkTest, CreateFailure) {
+  EXPECT_FALSE(SharedMemoryStatsSink::create(TestEnvironment::temporaryPath("missing/stats"), 16,
+                                             1024, store_.symbolTable())
+                   .ok());
+}
+
+TEST_F(SharedMemoryStatsSinkTest, ReaderRejectsInvalidFile) {
+  EXPECT_EQ(absl::StatusCode::kNotFound, SegmentReader::open(path_ + ".missing").status().code());
+
+  const std::string path = TestEnvironment::writeStringToFileForTest(
+      "not_shared_memory_stats", std::string(sizeof(SegmentHeader), 'x'));
+  EXPECT_EQ(absl::StatusCode::kFailedPrecondition, SegmentReader::open(path).status().code());
+}
+
+// A reader running concurrently with flushes only sees values from a single flush.
+TEST_F(SharedMemoryStatsSinkTest, ConsistentSnapshots) {
+  createSink(64, 4096);
+  std::vector<Stats::Gauge*> gauges;
+  for (int i = 0; i < 64; ++i) {
+    gauges.push_back(&addGauge(absl::StrCat("gauge_", i), 0));
+  }
+  sink_->flush(snapshot_);
+
+  std::atomic<bool> done{false};
+  Thread::ThreadPtr writer = Thread::threadFactoryForTest().createThread([&]() {
+    for (uint64_t value = 1; value <= 2000; ++value) {
+      for (Stats::Gauge* gauge : gauges) {
+        gauge->set(value);
+      }
+      sink_->flush(snapshot_);
+    }
+    done = true;
+  });
+
+  SegmentReaderPtr reader = openReader();
+  SegmentReader::Snapshot snapshot;
+  bool consistent = true;
+  while (!done && consistent) {
+    if (!reader->read(snapshot).ok()) {
+      continue;
+    }
+    for (const SegmentReader::Entry& entry : snapshot.entries_) {
+      consistent &= entry.value_ == snapshot.entries_[0].value_;
+    }
+  }
+  writer->join();
+  EXPECT_TRUE(consistent);
+}
+
+} // namespace
+} // namespace SharedMemory
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
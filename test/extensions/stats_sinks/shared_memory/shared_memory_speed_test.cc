@@ -0,0 +1,132 @@
+// Compares the cost of exporting counters through the shared memory stats sink against rendering
+// them for a /stats/prometheus scrape. The sink's flush runs on Envoy's main thread on every stats
+// flush; the segment read runs in the exporter process, so a scrape costs Envoy nothing.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/stats/custom_stat_namespaces_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/stat_sinks/shared_memory/segment_reader.h"
+#include "source/extensions/stat_sinks/shared_memory/shared_memory_sink.h"
+#include "source/server/admin/prometheus_stats.h"
+
+#include "test/benchmark/main.h"
+#include "test/mocks/upstream/cluster_manager.h"
+#include "test/test_common/environment.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace SharedMemory {
+namespace {
+
+class BenchmarkSnapshot : public Stats::MetricSnapshot {
+public:
+  const std::vector<CounterSnapshot>& counters() override { return counters_; }
+  const std::vector<std::reference_wrapper<const Stats::Gauge>>& gauges() override {
+    return gauges_;
+  }
+  const std::vector<std::reference_wrapper<const Stats::ParentHistogram>>& histograms() override {
+    return histograms_;
+  }
+  const std::vector<std::reference_wrapper<const Stats::TextReadout>>& textReadouts() override {
+    return text_readouts_;
+  }
+  const std::vector<Stats::PrimitiveCounterSnapshot>& hostCounters() override {
+    return host_counters_;
+  }
+  const std::vector<Stats::PrimitiveGaugeSnapshot>& hostGauges() override { return host_gauges_; }
+  SystemTime snapshotTime() const override { return {}; }
+
+  std::vector<CounterSnapshot> counters_;
+  std::vector<std::reference_wrapper<const Stats::Gauge>> gauges_;
+  std::vector<std::reference_wrapper<const Stats::ParentHistogram>> histograms_;
+  std::vector<std::reference_wrapper<const Stats::TextReadout>> text_readouts_;
+  std::vector<Stats::PrimitiveCounterSnapshot> host_counters_;
+  std::vector<Stats::PrimitiveGaugeSnapshot> host_gauges_;
+};
+
+// Creates counters named like cluster stats, 100 per cluster.
+class CounterFixture {
+public:
+  explicit CounterFixture(uint32_t num_counters) {
+    for (uint32_t i = 0; i < num_counters; ++i) {
+      Stats::Counter& counter = store_.rootScope()->counterFromString(
+          absl::StrCat("cluster.cluster_", i / 100, ".upstream_rq_", i % 100));
+      counter.add(i);
+      snapshot_.counters_.push_back({i, counter});
+    }
+  }
+
+  SharedMemoryStatsSinkPtr createSink() {
+    const uint32_t num_counters = snapshot_.counters_.size();
+    return SharedMemoryStatsSink::create(path_, num_counters, num_counters * 64,
+                                         store_.symbolTable())
+        .value();
+  }
+
+  const std::string path_{TestEnvironment::temporaryPath("shared_memory_speed_test")};
+  Stats::IsolatedStoreImpl store_;
+  BenchmarkSnapshot snapshot_;
+};
+
+uint32_t numCounters(benchmark::State& state) {
+  return skipExpensiveBenchmarks() ? 1000 : state.range(0);
+}
+
+void bmSharedMemoryFlush(benchmark::State& state) {
+  CounterFixture fixture(numCounters(state));
+  SharedMemoryStatsSinkPtr sink = fixture.createSink();
+  // The first flush assigns the slots.
+  sink->flush(fixture.snapshot_);
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    sink->flush(fixture.snapshot_);
+  }
+}
+BENCHMARK(bmSharedMemoryFlush)->Arg(10000)->Arg(400000)->Unit(benchmark::kMillisecond);
+
+void bmSharedMemoryRead(benchmark::State& state) {
+  const uint32_t num_counters = numCounters(state);
+  CounterFixture fixture(num_counters);
+  SharedMemoryStatsSinkPtr sink = fixture.createSink();
+  sink->flush(fixture.snapshot_);
+  SegmentReaderPtr reader = SegmentReader::open(fixture.path_).value();
+  SegmentReader::Snapshot snapshot;
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    RELEASE_ASSERT(reader->read(snapshot).ok(), "");
+  }
+  RELEASE_ASSERT(snapshot.entries_.size() == num_counters, "");
+}
+BENCHMARK(bmSharedMemoryRead)->Arg(10000)->Arg(400000)->Unit(benchmark::kMillisecond);
+
+void bmPrometheusText(benchmark::State& state) {
+  CounterFixture fixture(numCounters(state));
+  const std::vector<Stats::CounterSharedPtr> counters = fixture.store_.counters();
+  testing::NiceMock<Upstream::MockClusterManager> cluster_manager;
+  Stats::CustomStatNamespacesImpl custom_namespaces;
+  const Server::StatsParams params;
+
+  uint64_t bytes = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    Buffer::OwnedImpl response;
+    Server::PrometheusStatsFormatter::statsAsPrometheusText(
+        counters, {}, {}, {}, cluster_manager, response, params, custom_namespaces);
+    bytes = response.length();
+  }
+  state.counters["bytes_per_scrape"] = bytes;
+}
+BENCHMARK(bmPrometheusText)->Arg(10000)->Arg(400000)->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace SharedMemory
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
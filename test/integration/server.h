@@ -399,6 +399,7 @@ public:
   void setTagProducer(TagProducerPtr&&) override {}
   void setStatsMatcher(StatsMatcherPtr&&) override {}
   void setHistogramSettings(HistogramSettingsConstPtr&&) override {}
+  void setShardedCounterMatcher(StatsMatcherPtr&&) override {}
   void setUseExplicitTags(bool) override {}
   void initializeThreading(Event::Dispatcher&, ThreadLocal::Instance&) override {}
   void shutdownThreading() override {}
@@ -294,6 +294,48 @@ TEST_P(TcpProxyIntegrationTest, TcpProxyLargeWrite) {
   EXPECT_EQ(downstream_pauses, downstream_resumes);
 }
 
+#if defined(__linux__)
+// Test that the bytes are spliced between the sockets, and that the proxy counts them and hands
+// the half close over to the connections.
+TEST_P(TcpProxyIntegrationTest, TcpProxySpliceSockets) {
+  config_helper_.addConfigModifier([&](envoy::config::bootstrap::v3::Bootstrap& bootstrap) -> void {
+    auto* listener = bootstrap.mutable_static_resources()->mutable_listeners(0);
+    auto* filter_chain = listener->mutable_filter_chains(0);
+    auto* config_blob = filter_chain->mutable_filters(0)->mutable_typed_config();
+    auto tcp_proxy_config =
+        MessageUtil::anyConvert<envoy::extensions::filters::network::tcp_proxy::v3::TcpProxy>(
+            *config_blob);
+    tcp_proxy_config.set_splice_sockets(true);
+    std::ignore = config_blob->PackFrom(tcp_proxy_config);
+  });
+  initialize();
+
+  IntegrationTcpClientPtr tcp_client = makeTcpConnection(lookupPort("tcp_proxy"));
+  FakeRawConnectionPtr fake_upstream_connection;
+  ASSERT_TRUE(fake_upstreams_[0]->waitForRawConnection(fake_upstream_connection));
+  test_server_->waitForCounter("tcp.tcpproxy_stats.downstream_cx_spliced_total", Eq(1));
+
+  // Larger than the pipes, so that the bytes go through them several times.
+  std::string data(1024 * 1024, 'a');
+  ASSERT_TRUE(tcp_client->write(data));
+  ASSERT_TRUE(fake_upstream_connection->waitForData(data.size()));
+  ASSERT_TRUE(fake_upstream_connection->write("hello"));
+  tcp_client->waitForData("hello");
+
+  ASSERT_TRUE(fake_upstream_connection->write("", true));
+  tcp_client->waitForHalfClose();
+  ASSERT_TRUE(tcp_client->write("", true));
+  ASSERT_TRUE(fake_upstream_connection->waitForHalfClose());
+  ASSERT_TRUE(fake_upstream_connection->waitForDisconnect());
+  tcp_client->waitForDisconnect();
+
+  test_server_->waitForCounter("tcp.tcpproxy_stats.downstream_cx_rx_bytes_total",
+                               Eq(data.size()));
+  test_server_->waitForCounter("tcp.tcpproxy_stats.downstream_cx_tx_bytes_total", Eq(5));
+  test_server_->waitForCounter("cluster.cluster_0.upstream_cx_rx_bytes_total", Eq(5));
+}
+#endif
+
 // Test that a downstream flush works correctly (all data is flushed)
 TEST_P(TcpProxyIntegrationTest, TcpProxyDownstreamFlush) {
   // Use a very large size to make sure it is larger than the kernel socket read buffer.
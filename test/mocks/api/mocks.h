@@ -85,6 +85,10 @@ public:
               (os_fd_t fd, const void* buffer, size_t length, off_t offset), (const));
   MOCK_METHOD(SysCallSizeResult, pread, (os_fd_t fd, void* buffer, size_t length, off_t offset),
               (const));
+  MOCK_METHOD(SysCallSizeResult, sendfile,
+              (os_fd_t out_fd, os_fd_t in_fd, off_t offset, size_t count));
+  MOCK_METHOD(SysCallSizeResult, splice, (os_fd_t fd_in, os_fd_t fd_out, size_t length));
+  MOCK_METHOD(SysCallIntResult, pipe, (os_fd_t fds[2]));
   MOCK_METHOD(SysCallSizeResult, send, (os_fd_t socket, void* buffer, size_t length, int flags));
   MOCK_METHOD(SysCallSizeResult, recv, (os_fd_t socket, void* buffer, size_t length, int flags));
   MOCK_METHOD(SysCallSizeResult, recvmsg, (os_fd_t socket, msghdr* msg, int flags));
@@ -15,9 +15,11 @@ public:
     ON_CALL(*this, isMultishotEnabled()).WillByDefault(::testing::Return(false));
     ON_CALL(*this, bufferPool()).WillByDefault(::testing::Return(nullptr));
     ON_CALL(*this, hasReadyCompletions()).WillByDefault(::testing::Return(false));
+    ON_CALL(*this, isSendZeroCopySupported()).WillByDefault(::testing::Return(false));
     EXPECT_CALL(*this, isMultishotEnabled()).Times(::testing::AnyNumber());
     EXPECT_CALL(*this, bufferPool()).Times(::testing::AnyNumber());
     EXPECT_CALL(*this, hasReadyCompletions()).Times(::testing::AnyNumber());
+    EXPECT_CALL(*this, isSendZeroCopySupported()).Times(::testing::AnyNumber());
   }
 
   MOCK_METHOD(os_fd_t, registerEventfd, ());
@@ -37,9 +39,13 @@ public:
   MOCK_METHOD(bool, isMultishotEnabled, (), (const));
   MOCK_METHOD(IoUringBufferPoolSharedPtr, bufferPool, ());
   MOCK_METHOD(IoUringResult, prepareReadMultishot, (os_fd_t fd, Request* user_data));
+  MOCK_METHOD(IoUringResult, prepareReadProvidedBuffer, (os_fd_t fd, Request* user_data));
   MOCK_METHOD(IoUringResult, prepareWritev,
               (os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs, off_t offset,
                Request* user_data));
+  MOCK_METHOD(bool, isSendZeroCopySupported, (), (const));
+  MOCK_METHOD(IoUringResult, prepareSendmsgZeroCopy,
+              (os_fd_t fd, const struct msghdr* msg, Request* user_data));
   MOCK_METHOD(IoUringResult, prepareClose, (os_fd_t fd, Request* user_data));
   MOCK_METHOD(IoUringResult, prepareCancel, (Request * cancelling_user_data, Request* user_data));
   MOCK_METHOD(IoUringResult, prepareShutdown, (os_fd_t fd, int how, Request* user_data));
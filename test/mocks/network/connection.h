@@ -102,6 +102,8 @@ public:
   MOCK_METHOD(void, configureInitialCongestionWindow,                                              \
               (uint64_t bandwidth_bits_per_sec, std::chrono::microseconds rtt), ());               \
   MOCK_METHOD(std::optional<uint64_t>, congestionWindowInBytes, (), (const));                      \
+  MOCK_METHOD(bool, canSpliceSocket, (), (const));                                                 \
+  MOCK_METHOD(bool, canSendFile, (), (const));                                                     \
   MOCK_METHOD(void, dumpState, (std::ostream&, int), (const));                                     \
   MOCK_METHOD(bool, setSocketOption, (Network::SocketOptionName, absl::Span<uint8_t>), ());        \
   MOCK_METHOD(OptRef<const StreamInfo::StreamInfo>, trackedStream, (), (const));
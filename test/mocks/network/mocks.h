@@ -254,6 +254,7 @@ public:
   MOCK_METHOD(void, post, (Network::UdpRecvData && data));
   MOCK_METHOD(size_t, numPacketsExpectedPerEventLoop, (), (const));
   MOCK_METHOD(const IoHandle::UdpSaveCmsgConfig&, udpSaveCmsgConfig, (), (const));
+  MOCK_METHOD(bool, supportsCoalescedDatagrams, (), (const));
 };
 
 class MockDrainDecision : public DrainDecision {
@@ -27,6 +27,7 @@ public:
   MOCK_METHOD(std::optional<AdminShutdownResponse>, sendParentAdminShutdownRequest, ());
   MOCK_METHOD(void, sendParentTerminateRequest, ());
   MOCK_METHOD(ServerStatsFromParent, mergeParentStatsIfAny, (Stats::StoreRoot & stats_store));
+  MOCK_METHOD(void, mergeParentTlsSessionsIfAny, (const TlsSessionCb& cb));
   MOCK_METHOD(void, shutdown, ());
   MOCK_METHOD(uint32_t, baseId, ());
   MOCK_METHOD(std::string, version, ());
@@ -875,6 +875,110 @@ envoy_cluster_test_1_upstream_rq_time_count{key1="value1",key2="value2"} 7
   EXPECT_EQ(expected_output, response.toString());
 }
 
+// The name cache renders the same output as uncached scrapes, including after values change.
+TEST_F(PrometheusStatsFormatterTest, OutputWithNameCache) {
+  Stats::CustomStatNamespacesImpl custom_namespaces;
+  addCounter("cluster.test_1.upstream_cx_total",
+             {{makeStat("a.tag-name"), makeStat("a.tag-value")}});
+  addCounter("cluster.test_2.upstream_cx_total", {});
+  addGauge("cluster.test_3.upstream_cx_active",
+           {{makeStat("another_tag_name"), makeStat("another_tag-value")}});
+
+  HistogramWrapper h1_cumulative;
+  h1_cumulative.setHistogramValues({50, 20, 30, 70, 100, 5000, 200});
+  Stats::HistogramStatisticsImpl h1_cumulative_statistics(h1_cumulative.getHistogram());
+  auto histogram1 =
+      makeHistogram("cluster.test_1.upstream_rq_time", {{makeStat("key1"), makeStat("value1")}});
+  histogram1->unit_ = Stats::Histogram::Unit::Milliseconds;
+  ON_CALL(*histogram1, cumulativeStatistics()).WillByDefault(ReturnRef(h1_cumulative_statistics));
+  addHistogram(histogram1);
+
+  auto render = [&](PrometheusNameCache* name_cache) {
+    Buffer::OwnedImpl response;
+    const uint64_t size = PrometheusStatsFormatter::statsAsPrometheusText(
+        counters_, gauges_, histograms_, textReadouts_, endpoints_helper_->cm_, response,
+        StatsParams(), custom_namespaces, name_cache);
+    EXPECT_EQ(4UL, size);
+    return response.toString();
+  };
+
+  PrometheusNameCache name_cache(*symbol_table_);
+  EXPECT_EQ(render(nullptr), render(&name_cache));
+  EXPECT_EQ(8, name_cache.size());
+
+  counters_[0]->add(5);
+  gauges_[0]->set(7);
+  const std::string output = render(&name_cache);
+  EXPECT_EQ(render(nullptr), output);
+  EXPECT_THAT(output, testing::HasSubstr("envoy_cluster_test_1_upstream_cx_total{a_tag_name="
+                                         "\"a.tag-value\"} 5\n"));
+  EXPECT_THAT(output, testing::HasSubstr("envoy_cluster_test_3_upstream_cx_active{"
+                                         "another_tag_name=\"another_tag-value\"} 7\n"));
+  EXPECT_EQ(8, name_cache.size());
+}
+
+// Entries of deleted stats are evicted once they make up more than half of the cache.
+TEST_F(PrometheusStatsFormatterTest, NameCacheEviction) {
+  Stats::CustomStatNamespacesImpl custom_namespaces;
+  for (int i = 0; i < 4; ++i) {
+    addCounter(absl::StrCat("cluster.test_", i, ".upstream_cx_total"),
+               {{makeStat("tag"), makeStat(absl::StrCat("value", i))}});
+  }
+  PrometheusNameCache name_cache(*symbol_table_);
+  auto render = [&]() {
+    Buffer::OwnedImpl response;
+    PrometheusStatsFormatter::statsAsPrometheusText(counters_, gauges_, histograms_, textReadouts_,
+                                                    endpoints_helper_->cm_, response,
+                                                    StatsParams(), custom_namespaces, &name_cache);
+  };
+  render();
+  EXPECT_EQ(8, name_cache.size());
+
+  // Unused entries are kept while they are at most half of the cache.
+  counters_.pop_back();
+  counters_.pop_back();
+  render();
+  EXPECT_EQ(8, name_cache.size());
+
+  counters_.pop_back();
+  render();
+  EXPECT_EQ(2, name_cache.size());
+}
+
+// A filtered scrape does not evict the entries of the stats it does not render.
+TEST_F(PrometheusStatsFormatterTest, NameCacheFilteredScrapeKeepsEntries) {
+  Stats::CustomStatNamespacesImpl custom_namespaces;
+  for (int i = 0; i < 4; ++i) {
+    addCounter(absl::StrCat("cluster.test_", i, ".upstream_cx_total"),
+               {{makeStat("tag"), makeStat(absl::StrCat("value", i))}});
+  }
+  PrometheusNameCache name_cache(*symbol_table_);
+  auto render = [&](const StatsParams& params) {
+    Buffer::OwnedImpl response;
+    return PrometheusStatsFormatter::statsAsPrometheusText(
+        counters_, gauges_, histograms_, textReadouts_, endpoints_helper_->cm_, response, params,
+        custom_namespaces, &name_cache);
+  };
+  EXPECT_EQ(4UL, render(StatsParams()));
+  EXPECT_EQ(8, name_cache.size());
+
+  Buffer::OwnedImpl parse_response;
+  StatsParams filtered;
+  ASSERT_EQ(Http::Code::OK, filtered.parse("/stats?filter=test_0", parse_response));
+  EXPECT_EQ(1UL, render(filtered));
+  EXPECT_EQ(8, name_cache.size());
+
+  StatsParams used_only;
+  ASSERT_EQ(Http::Code::OK, used_only.parse("/stats?usedonly", parse_response));
+  counters_[1]->inc();
+  EXPECT_EQ(1UL, render(used_only));
+  EXPECT_EQ(8, name_cache.size());
+
+  // The full scrape finds all of its entries.
+  EXPECT_EQ(4UL, render(StatsParams()));
+  EXPECT_EQ(8, name_cache.size());
+}
+
 TEST_F(PrometheusStatsFormatterTest, OutputWithHiddenGauge) {
   Stats::CustomStatNamespacesImpl custom_namespaces;
 
@@ -197,14 +197,15 @@ public:
 
   /**
    * Issues an admin request against the stats saved in store_.
+   * @param name_cache if not nullptr, used to render Prometheus names and labels.
    */
-  uint64_t handlerStats(const StatsParams& params) {
+  uint64_t handlerStats(const StatsParams& params, PrometheusNameCache* name_cache = nullptr) {
     Buffer::OwnedImpl data;
     auto request_headers = Http::RequestHeaderMapImpl::create();
     auto response_headers = Http::ResponseHeaderMapImpl::create();
     if (params.format_ == StatsFormat::Prometheus) {
       StatsHandler::prometheusRender(*store_, custom_namespaces_, cm_, params, *request_headers,
-                                     *response_headers, data);
+                                     *response_headers, data, name_cache);
       return data.length();
     }
     Admin::RequestPtr request = StatsHandler::makeRequest(*store_, params, cm_);
@@ -222,6 +223,7 @@ public:
   std::vector<Stats::ScopeSharedPtr> scopes_;
   Envoy::Stats::CustomStatNamespacesImpl custom_namespaces_;
   FastMockClusterManager cm_;
+  PrometheusNameCache prometheus_name_cache_{store_->symbolTable()};
   bool endpoint_stats_initialized_{false};
 };
 
@@ -390,6 +392,30 @@ BENCHMARK_CAPTURE(BM_AllCountersPrometheus, per_endpoint_stats_disabled, false)
 BENCHMARK_CAPTURE(BM_AllCountersPrometheus, per_endpoint_stats_enabled, true)
     ->Unit(benchmark::kMillisecond);
 
+// As above, but with names and labels cached across scrapes, as done by the admin handler. The
+// first scrape, which fills the cache, is not timed.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_AllCountersPrometheusCached(benchmark::State& state, bool per_endpoint_stats) {
+  Envoy::Server::StatsHandlerTest& test_context = testContext(per_endpoint_stats);
+  Envoy::Server::StatsParams params;
+  Envoy::Buffer::OwnedImpl response;
+  params.parse("?format=prometheus&type=Counters", response);
+  test_context.handlerStats(params, &test_context.prometheus_name_cache_);
+
+  uint64_t count;
+  for (auto _ : state) { // NOLINT
+    count = test_context.handlerStats(params, &test_context.prometheus_name_cache_);
+    RELEASE_ASSERT(count > 250 * 1000 * 1000, "expected count > 250M");
+  }
+
+  auto label = absl::StrCat("output per iteration: ", count);
+  state.SetLabel(label);
+}
+BENCHMARK_CAPTURE(BM_AllCountersPrometheusCached, per_endpoint_stats_disabled, false)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_AllCountersPrometheusCached, per_endpoint_stats_enabled, true)
+    ->Unit(benchmark::kMillisecond);
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 static void BM_UsedCountersPrometheus(benchmark::State& state, bool per_endpoint_stats) {
   Envoy::Server::StatsHandlerTest& test_context = testContext(per_endpoint_stats);
@@ -459,6 +485,31 @@ BENCHMARK_CAPTURE(BM_PrometheusFull, per_endpoint_stats_disabled, false)
 BENCHMARK_CAPTURE(BM_PrometheusFull, per_endpoint_stats_enabled, true)
     ->Unit(benchmark::kMillisecond);
 
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_PrometheusFullCached(benchmark::State& state, bool per_endpoint_stats) {
+  Envoy::Server::StatsHandlerTest& test_context = testContext(per_endpoint_stats);
+  Envoy::Server::StatsParams params;
+  Envoy::Buffer::OwnedImpl response;
+  params.parse("?format=prometheus", response);
+  const uint64_t lower_limit = per_endpoint_stats ? 400 * 1000 * 1000 : 200 * 1000 * 1000;
+  const uint64_t upper_limit = per_endpoint_stats ? 420 * 1000 * 1000 : 300 * 1000 * 1000;
+  test_context.handlerStats(params, &test_context.prometheus_name_cache_);
+
+  uint64_t count;
+  for (auto _ : state) { // NOLINT
+    count = test_context.handlerStats(params, &test_context.prometheus_name_cache_);
+    RELEASE_ASSERT(count > lower_limit, "expected count > lower_limit");
+    RELEASE_ASSERT(count < upper_limit, "expected count < upper_limit");
+  }
+
+  auto label = absl::StrCat("output per iteration: ", count);
+  state.SetLabel(label);
+}
+BENCHMARK_CAPTURE(BM_PrometheusFullCached, per_endpoint_stats_disabled, false)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_PrometheusFullCached, per_endpoint_stats_enabled, true)
+    ->Unit(benchmark::kMillisecond);
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 static void BM_HistogramsJson(benchmark::State& state, bool per_endpoint_stats) {
   Envoy::Server::StatsHandlerTest& test_context = testContext(per_endpoint_stats);
@@ -67,6 +67,29 @@ public:
     });
     udp_forwarding_rpc_stream_.sendHotRestartMessage(child_address_udp_forwarding_, message);
   }
+  // Mocks the syscalls of a request of the child on the main stream, checks that it asks for the
+  // TLS sessions, and answers it with the reply.
+  void replyToTlsSessionsRequest(const envoy::HotRestartMessage& reply) {
+    EXPECT_CALL(os_sys_calls_, sendmsg(_, _, _)).WillOnce([](int, const msghdr* msg, int) {
+      // The serialized request follows its length.
+      envoy::HotRestartMessage request;
+      EXPECT_TRUE(request.ParseFromArray(
+          static_cast<char*>(msg->msg_iov[0].iov_base) + sizeof(uint64_t),
+          msg->msg_iov[0].iov_len - sizeof(uint64_t)));
+      EXPECT_TRUE(request.request().has_tls_sessions());
+      return Api::SysCallSizeResult{static_cast<ssize_t>(msg->msg_iov[0].iov_len), 0};
+    });
+    std::string buffer(sizeof(uint64_t), '\0');
+    *reinterpret_cast<uint64_t*>(buffer.data()) = htobe64(reply.ByteSizeLong());
+    buffer += reply.SerializeAsString();
+    EXPECT_CALL(os_sys_calls_, recvmsg(_, _, _)).WillOnce([buffer](int, msghdr* msg, int) {
+      msg->msg_control = nullptr;
+      msg->msg_controllen = 0;
+      msg->msg_flags = 0;
+      buffer.copy(static_cast<char*>(msg->msg_iov[0].iov_base), buffer.size());
+      return Api::SysCallSizeResult{static_cast<ssize_t>(buffer.size()), 0};
+    });
+  }
   void expectParentTerminateMessages() {
     EXPECT_CALL(os_sys_calls_, sendmsg(_, _, _)).WillOnce([](int, const msghdr* msg, int) {
       return Api::SysCallSizeResult{static_cast<ssize_t>(msg->msg_iov[0].iov_len), 0};
@@ -174,6 +197,31 @@ TEST_F(HotRestartingChildTest, ParentDrainedCallbacksAreCalledImmediatelyWhenAlr
                                                        callback2.AsStdFunction());
 }
 
+TEST_F(HotRestartingChildTest, GetParentTlsSessions) {
+  envoy::HotRestartMessage reply;
+  auto* session = reply.mutable_reply()->mutable_tls_sessions()->add_sessions();
+  session->set_key("ua");
+  session->set_session("session");
+  fake_parent_->replyToTlsSessionsRequest(reply);
+  std::unique_ptr<HotRestartMessage> tls_sessions = hot_restarting_child_->getParentTlsSessions();
+  ASSERT_NE(nullptr, tls_sessions);
+  EXPECT_THAT(*tls_sessions, ProtoEq(reply));
+}
+
+TEST_F(HotRestartingChildTest, GetParentTlsSessionsFromParentWithoutThem) {
+  // A parent built before the sessions were handed over does not recognize the request.
+  envoy::HotRestartMessage reply;
+  reply.set_didnt_recognize_your_last_message(true);
+  fake_parent_->replyToTlsSessionsRequest(reply);
+  EXPECT_EQ(nullptr, hot_restarting_child_->getParentTlsSessions());
+}
+
+TEST_F(HotRestartingChildTest, GetParentTlsSessionsAfterParentTerminated) {
+  fake_parent_->expectParentTerminateMessages();
+  hot_restarting_child_->sendParentTerminateRequest();
+  EXPECT_EQ(nullptr, hot_restarting_child_->getParentTlsSessions());
+}
+
 TEST_F(HotRestartingChildTest, LogsErrorOnReplyMessageInUdpStream) {
   envoy::HotRestartMessage msg;
   msg.mutable_reply();
@@ -1,9 +1,11 @@
 #include <memory>
 
 #include "source/common/network/address_impl.h"
+#include "source/common/tls/session_cache.h"
 #include "source/server/hot_restarting_child.h"
 #include "source/server/hot_restarting_parent.h"
 
+#include "test/common/tls/ssl_test_utility.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/server/instance.h"
 #include "test/mocks/server/listener_manager.h"
@@ -20,6 +22,8 @@ namespace Server {
 namespace {
 
 using HotRestartMessage = envoy::HotRestartMessage;
+using TlsSessionCache = Extensions::TransportSockets::Tls::SessionCache;
+using TlsSessionCacheSharedPtr = Extensions::TransportSockets::Tls::SessionCacheSharedPtr;
 
 class MockHotRestartMessageSender : public HotRestartMessageSender {
 public:
@@ -405,6 +409,43 @@ TEST_F(HotRestartingParentTest, RetainDynamicStats) {
   }
 }
 
+TEST_F(HotRestartingParentTest, ExportTlsSessionsToChildWithoutCache) {
+  HotRestartMessage::Reply::TlsSessions tls_sessions;
+  hot_restarting_parent_.exportTlsSessionsToChild(&tls_sessions);
+  EXPECT_EQ(0, tls_sessions.sessions_size());
+}
+
+TEST_F(HotRestartingParentTest, ExportTlsSessionsToChildNotPersisted) {
+  envoy::config::bootstrap::v3::Bootstrap::TlsSessionCache config;
+  TlsSessionCacheSharedPtr session_cache = TlsSessionCache::create(
+      config, server_.singletonManager(), *server_.stats_store_.rootScope());
+  session_cache->insert(TlsSessionCache::Direction::Upstream, "a",
+                        Extensions::TransportSockets::Tls::makeResumableSession(), 1);
+
+  HotRestartMessage::Reply::TlsSessions tls_sessions;
+  hot_restarting_parent_.exportTlsSessionsToChild(&tls_sessions);
+  EXPECT_EQ(0, tls_sessions.sessions_size());
+}
+
+TEST_F(HotRestartingParentTest, ExportTlsSessionsToChild) {
+  envoy::config::bootstrap::v3::Bootstrap::TlsSessionCache config;
+  config.set_persist_across_hot_restart(true);
+  TlsSessionCacheSharedPtr session_cache = TlsSessionCache::create(
+      config, server_.singletonManager(), *server_.stats_store_.rootScope());
+  session_cache->insert(TlsSessionCache::Direction::Upstream, "a",
+                        Extensions::TransportSockets::Tls::makeResumableSession(), 1);
+
+  HotRestartMessage::Reply::TlsSessions tls_sessions;
+  hot_restarting_parent_.exportTlsSessionsToChild(&tls_sessions);
+  ASSERT_EQ(1, tls_sessions.sessions_size());
+
+  // The child caches the session under the same key, as it does when the server starts.
+  TlsSessionCache child_session_cache(config, *server_.stats_store_.rootScope());
+  EXPECT_TRUE(child_session_cache.importSession(tls_sessions.sessions(0).key(),
+                                                tls_sessions.sessions(0).session()));
+  EXPECT_NE(nullptr, child_session_cache.lookup(TlsSessionCache::Direction::Upstream, "a"));
+}
+
 MATCHER_P(UdpPacketHandlerPtrIs, expected_handler, "") {
   bool matched = arg->non_dispatched_udp_packet_handler_.ptr() == expected_handler;
   if (!matched) {
@@ -19,12 +19,14 @@
 #include "source/common/stats/symbol_table.h"
 #include "source/common/stats/thread_local_store.h"
 #include "source/common/thread_local/thread_local_impl.h"
+#include "source/common/tls/session_cache.h"
 #include "source/common/version/version.h"
 #include "source/server/instance_impl.h"
 #include "source/server/process_context_impl.h"
 
 #include "test/common/config/dummy_config.pb.h"
 #include "test/common/stats/stat_test_utility.h"
+#include "test/common/tls/ssl_test_utility.h"
 #include "test/config/v2_link_hacks.h"
 #include "test/integration/server.h"
 #include "test/mocks/api/mocks.h"
@@ -1185,6 +1187,29 @@ TEST_P(ServerInstanceImplTest, BootstrapNode) {
   expectCorrectBuildVersion(server_->localInfo().node().user_agent_build_version());
 }
 
+// The sessions of the parent are imported into the TLS session cache, except for those that
+// cannot be parsed.
+TEST_P(ServerInstanceImplTest, ImportParentTlsSessions) {
+  bssl::UniquePtr<SSL_SESSION> session = Extensions::TransportSockets::Tls::makeResumableSession();
+  uint8_t* data;
+  size_t length;
+  ASSERT_EQ(1, SSL_SESSION_to_bytes(session.get(), &data, &length));
+  const std::string serialized(reinterpret_cast<const char*>(data), length);
+  OPENSSL_free(data);
+  EXPECT_CALL(restart_, mergeParentTlsSessionsIfAny(_))
+      .WillOnce([&serialized](const HotRestart::TlsSessionCb& cb) {
+        cb("ua", serialized);
+        cb("ub", "not a session");
+      });
+
+  initialize("test/server/test_data/server/tls_session_cache_bootstrap.yaml");
+  Extensions::TransportSockets::Tls::SessionCacheSharedPtr session_cache =
+      Extensions::TransportSockets::Tls::SessionCache::get(server_->singletonManager());
+  ASSERT_NE(nullptr, session_cache);
+  EXPECT_EQ(1, session_cache->size());
+  EXPECT_EQ(1L, TestUtility::findCounter(stats_store_, "tls_session_cache.imported")->value());
+}
+
 // Validate server localInfo().zoneStatName() is set from bootstrap config
 TEST_P(ServerInstanceImplTest, ZoneStatNameFromBootstrap) {
   initialize("test/server/test_data/server/node_bootstrap.yaml");
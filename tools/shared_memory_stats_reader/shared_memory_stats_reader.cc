@@ -0,0 +1,46 @@
+/**
+ * Reference reader for the file published by the envoy.stat_sinks.shared_memory stats sink. Prints
+ * the counters and gauges of the last flush in the same format as the admin /stats endpoint.
+ *
+ * Usage:
+ *
+ * shared_memory_stats_reader <path> [--include_stale]
+ */
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "source/extensions/stat_sinks/shared_memory/segment_reader.h"
+
+// NOLINT(namespace-envoy)
+int main(int argc, char** argv) {
+  using Envoy::Extensions::StatSinks::SharedMemory::SegmentReader;
+
+  const bool include_stale = argc == 3 && strcmp(argv[2], "--include_stale") == 0;
+  if (argc != 2 && !include_stale) {
+    std::cerr << "Usage: " << argv[0] << " <path> [--include_stale]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  auto reader = SegmentReader::open(argv[1]);
+  if (!reader.ok()) {
+    std::cerr << reader.status() << std::endl;
+    return EXIT_FAILURE;
+  }
+  SegmentReader::Snapshot snapshot;
+  const absl::Status status = reader.value()->read(snapshot);
+  if (!status.ok()) {
+    std::cerr << status << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "# pid: " << reader.value()->pid() << " flush_time_ms: " << snapshot.flush_time_ms_
+            << " dropped: " << snapshot.dropped_ << "\n";
+  for (const SegmentReader::Entry& entry : snapshot.entries_) {
+    if (entry.stale_ && !include_stale) {
+      continue;
+    }
+    std::cout << entry.name_ << ": " << entry.value_ << "\n";
+  }
+  return EXIT_SUCCESS;
+}